@@ -0,0 +1,132 @@
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2018 Western Digital Corporation or its affiliates.
+//
+// This program is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <bitset>
+#include <unordered_map>
+
+
+namespace WdRiscv
+{
+
+  /// Set of byte addresses used for breakpoints and watchpoints. Each
+  /// member address is kept in a hash map (with a reference count so
+  /// that overlapping insertions can be undone independently) and in
+  /// a per-page bitmap with one bit per byte. Membership queries go
+  /// through the bitmap of the page of the queried address. The
+  /// bitmap of the last queried page is cached so that consecutive
+  /// queries in the same page (the common case for instruction
+  /// fetches) cost a compare and a bit test, and queries in pages
+  /// without members cost the compare alone.
+  template <typename URV>
+  class AddressSet
+  {
+  public:
+
+    /// Add the count bytes starting at the given address to this set.
+    void insert(URV address, URV count = 1)
+    {
+      for (URV i = 0; i < count; ++i)
+	{
+	  URV addr = address + i;
+	  if (counts_[addr]++ == 0)
+	    pages_[addr >> pageShift_].set(addr & pageMask_);
+	}
+      cacheValid_ = false;
+    }
+
+    /// Remove the count bytes starting at the given address from this
+    /// set. Return false if any of these bytes is not in the set.
+    bool erase(URV address, URV count = 1)
+    {
+      bool ok = true;
+      for (URV i = 0; i < count; ++i)
+	{
+	  URV addr = address + i;
+	  auto iter = counts_.find(addr);
+	  if (iter == counts_.end())
+	    {
+	      ok = false;
+	      continue;
+	    }
+	  if (--iter->second != 0)
+	    continue;
+	  counts_.erase(iter);
+
+	  auto pageIter = pages_.find(addr >> pageShift_);
+	  pageIter->second.reset(addr & pageMask_);
+	  if (pageIter->second.none())
+	    pages_.erase(pageIter);
+	}
+      cacheValid_ = false;
+      return ok;
+    }
+
+    /// Remove all addresses from this set.
+    void clear()
+    {
+      counts_.clear();
+      pages_.clear();
+      cacheValid_ = false;
+    }
+
+    /// Return true if this set is empty.
+    bool empty() const
+    { return counts_.empty(); }
+
+    /// Return true if the given address is in this set.
+    bool contains(URV address) const
+    {
+      URV page = address >> pageShift_;
+      if (page != cachedPage_ or not cacheValid_)
+	{
+	  auto iter = pages_.find(page);
+	  cachedBits_ = iter == pages_.end()? nullptr : &iter->second;
+	  cachedPage_ = page;
+	  cacheValid_ = true;
+	}
+      return cachedBits_ and cachedBits_->test(address & pageMask_);
+    }
+
+    /// Return true if any of the count bytes starting at the given
+    /// address is in this set.
+    bool intersects(URV address, unsigned count) const
+    {
+      for (unsigned i = 0; i < count; ++i)
+	if (contains(address + i))
+	  return true;
+      return false;
+    }
+
+  private:
+
+    static constexpr unsigned pageShift_ = 12;
+    static constexpr URV pageMask_ = (URV(1) << pageShift_) - 1;
+
+    typedef std::bitset<size_t(1) << pageShift_> PageBits;
+
+    std::unordered_map<URV, unsigned> counts_;  // Address to ref count.
+    std::unordered_map<URV, PageBits> pages_;   // Page number to bitmap.
+
+    mutable URV cachedPage_ = 0;
+    mutable const PageBits* cachedBits_ = nullptr;
+    mutable bool cacheValid_ = false;
+  };
+}
@@ -0,0 +1,147 @@
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2018 Western Digital Corporation or its affiliates.
+//
+// This program is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <unordered_map>
+#include <vector>
+
+
+namespace WdRiscv
+{
+
+  /// Collect SimPoint basic block vectors: For each interval of N
+  /// retired instructions, the count of instructions executed in each
+  /// basic block (identified by its start address). A basic block ends
+  /// at a branch or at any change of control flow (jump, trap,
+  /// interrupt). Each interval is written as a line of the SimPoint .bb
+  /// format:
+  ///    T:id1:count1 :id2:count2 ...
+  /// where id is a 1-based block number assigned in order of first
+  /// execution.
+  template <typename URV>
+  class BasicBlockVectors
+  {
+  public:
+
+    /// Start collecting vectors writing them to the given file every
+    /// interval instructions. A null file or a zero interval disables
+    /// collection.
+    void enable(FILE* file, uint64_t interval)
+    {
+      file_ = interval ? file : nullptr;
+      interval_ = interval;
+    }
+
+    /// Return true if collection is enabled.
+    bool enabled() const
+    { return file_ != nullptr; }
+
+    /// Account for the retired instruction at pc. The nextPc is the
+    /// address of the next instruction to execute. The isBranch flag is
+    /// true for a conditional branch (taken or not).
+    void retire(URV pc, URV nextPc, unsigned size, bool isBranch)
+    {
+      if (pc != nextPc_)
+	{
+	  // Control reached pc by a discontinuity (e.g. a trap).
+	  endBlock();
+	  blockStart_ = pc;
+	}
+
+      ++blockLength_;
+      nextPc_ = nextPc;
+
+      if (isBranch or nextPc != pc + size)
+	{
+	  endBlock();
+	  blockStart_ = nextPc;
+	}
+
+      // At the end of an interval, the instructions of the current
+      // block are credited to the interval. The block continues in the
+      // next interval.
+      if (++intervalCount_ >= interval_)
+	{
+	  endBlock();
+	  writeInterval();
+	}
+    }
+
+    /// Write the last (partial) interval if any.
+    void finish()
+    {
+      if (not file_)
+	return;
+      endBlock();
+      if (intervalCount_)
+	writeInterval();
+      fflush(file_);
+    }
+
+  protected:
+
+    struct Block
+    {
+      uint64_t id_ = 0;      // Block number (1-based).
+      uint64_t count_ = 0;   // Instructions executed in current interval.
+    };
+
+    /// Credit the instructions of the current block to its entry.
+    void endBlock()
+    {
+      if (blockLength_ == 0)
+	return;
+      Block& block = blocks_[blockStart_];
+      if (block.id_ == 0)
+	block.id_ = blocks_.size();
+      if (block.count_ == 0)
+	touched_.push_back(&block);
+      block.count_ += blockLength_;
+      blockLength_ = 0;
+    }
+
+    /// Write the counts of the current interval and reset them.
+    void writeInterval()
+    {
+      fputc('T', file_);
+      for (Block* block : touched_)
+	{
+	  fprintf(file_, ":%lu:%lu ", (unsigned long) block->id_,
+		  (unsigned long) block->count_);
+	  block->count_ = 0;
+	}
+      fputc('\n', file_);
+      touched_.clear();
+      intervalCount_ = 0;
+    }
+
+  private:
+
+    FILE* file_ = nullptr;
+    uint64_t interval_ = 0;          // Instructions per interval.
+    uint64_t intervalCount_ = 0;     // Instructions in current interval.
+    URV blockStart_ = 0;             // Address of current block.
+    URV nextPc_ = 0;                 // Expected address of next instruction.
+    uint64_t blockLength_ = 0;       // Instructions in current block.
+    std::unordered_map<URV, Block> blocks_;
+    std::vector<Block*> touched_;    // Blocks executed in current interval.
+  };
+}
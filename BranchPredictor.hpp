@@ -0,0 +1,338 @@
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2018 Western Digital Corporation or its affiliates.
+//
+// This program is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <functional>
+
+
+namespace WdRiscv
+{
+
+  /// Kind and sizes of a branch predictor model.
+  struct PredictorParams
+  {
+    enum class Type
+      {
+	Static,    // Backward taken, forward not taken.
+	Bimodal,   // 2-bit counters indexed by pc.
+	Gshare,    // 2-bit counters indexed by pc xor global history.
+	Btb        // SweRV-like: Branch target buffer plus gshare table.
+      };
+
+    Type type_ = Type::Static;
+    unsigned bhtEntries_ = 256;   // Counters in history table (power of 2).
+    unsigned historyBits_ = 8;    // Global history length (gshare, btb).
+    unsigned btbEntries_ = 256;   // Target buffer entries (power of 2).
+    unsigned rasSize_ = 4;        // Return address stack entries.
+  };
+
+
+  /// Branch predictor model. The predictor is presented with the
+  /// retired control transfer instructions (conditional branches,
+  /// jal and jalr) and their actual outcome. It determines if the
+  /// instruction would have been correctly predicted, updates its
+  /// state and collects misprediction statistics per branch site.
+  ///
+  /// For all types, jal/jalr instructions with a link destination
+  /// register (x1 or x5) push the return address on a return address
+  /// stack (RAS) and jalr instructions with a link source register are
+  /// returns predicted by the RAS. For the Static, Bimodal and Gshare
+  /// types, only the direction of a conditional branch is predicted:
+  /// the targets of conditional branches and of jal are known at
+  /// decode and jalr instructions other than returns are always
+  /// mispredicted. For the Btb type, control transfers are predicted at
+  /// fetch: an instruction is predicted taken only if it hits in the
+  /// branch target buffer (and, for a conditional branch, if the
+  /// gshare table predicts taken) and a taken prediction goes to the
+  /// target recorded in the buffer.
+  template <typename URV>
+  class BranchPredictor
+  {
+  public:
+
+    enum class Kind { Conditional, Jal, Jalr };
+
+    /// Per branch site statistics.
+    struct Site
+    {
+      uint64_t executed_ = 0;
+      uint64_t taken_ = 0;
+      uint64_t mispredicts_ = 0;
+    };
+
+    /// Turn the model on/off.
+    void enable(bool flag)
+    { enabled_ = flag; }
+
+    /// Return true if the model is on.
+    bool enabled() const
+    { return enabled_; }
+
+    /// Define the kind and sizes of the predictor and reset it. Table
+    /// sizes are rounded down to a power of 2 (minimum 1).
+    void setParams(const PredictorParams& params)
+    {
+      auto floorPow2 = [] (unsigned x) -> unsigned {
+	return x ? 1u << (31 - __builtin_clz(x)) : 1u;
+      };
+      params_ = params;
+      params_.bhtEntries_ = floorPow2(params.bhtEntries_);
+      params_.btbEntries_ = floorPow2(params.btbEntries_);
+      params_.historyBits_ = std::min(params.historyBits_, 31u);
+      reset();
+    }
+
+    /// Return the kind and sizes of the predictor.
+    const PredictorParams& params() const
+    { return params_; }
+
+    /// Bring the predictor to its initial state (weakly not-taken
+    /// counters, empty target buffer and return stack) and clear the
+    /// statistics.
+    void reset()
+    {
+      bht_.assign(params_.bhtEntries_, 1);
+      btb_.assign(params_.btbEntries_, BtbEntry());
+      history_ = 0;
+      ras_.clear();
+      sites_.clear();
+      siteCache_.assign(siteCacheSize, SiteRef());
+      branches_ = mispredicts_ = 0;
+    }
+
+    /// Account for the retired control transfer of the given kind at
+    /// pc going to nextPc. The target is the address reached when the
+    /// transfer is taken (only used for a conditional branch). The rd
+    /// and rs1 are the destination and source registers of a jal/jalr
+    /// (ignored for a conditional branch). Return true if the transfer
+    /// would have been mispredicted.
+    bool retire(URV pc, URV nextPc, URV target, unsigned size, Kind kind,
+		unsigned rd, unsigned rs1)
+    {
+      bool taken = nextPc != pc + size;
+      bool isCall = kind != Kind::Conditional and isLink(rd);
+      bool isReturn = (kind == Kind::Jalr and isLink(rs1) and
+		       not (isCall and rd == rs1));
+
+      bool correct;
+      if (params_.type_ == PredictorParams::Type::Btb)
+	correct = predictBtb(pc, nextPc, size, kind, taken, isReturn);
+      else if (kind == Kind::Conditional)
+	correct = predictDirection(pc, target < pc) == taken;
+      else if (kind == Kind::Jal)
+	correct = true;
+      else
+	correct = isReturn and popReturn() == nextPc;
+
+      if (kind == Kind::Conditional)
+	{
+	  updateDirection(pc, taken);
+	  history_ = ((history_ << 1) | taken) & ((1u << params_.historyBits_) - 1);
+	}
+      if (isCall)
+	pushReturn(pc + size);
+
+      Site& site = findSite(pc);
+      site.executed_++;
+      site.taken_ += taken;
+      site.mispredicts_ += not correct;
+      branches_++;
+      mispredicts_ += not correct;
+
+      return not correct;
+    }
+
+    /// Return the count of control transfer instructions.
+    uint64_t branches() const
+    { return branches_; }
+
+    /// Return the count of mispredicted control transfers.
+    uint64_t mispredicts() const
+    { return mispredicts_; }
+
+    /// Return the statistics of the branch sites indexed by address.
+    const std::unordered_map<URV, Site>& sites() const
+    { return sites_; }
+
+    /// Write to the given file one line per branch site (most
+    /// mispredicted first): address, execution count, taken count,
+    /// misprediction count, misprediction rate and symbolic location
+    /// as returned by the given symbolize function.
+    void report(FILE* file, const std::function<std::string(URV)>& symbolize) const
+    {
+      std::vector<std::pair<URV, Site>> sorted(sites_.begin(), sites_.end());
+      std::sort(sorted.begin(), sorted.end(),
+		[] (const auto& a, const auto& b) {
+		  if (a.second.mispredicts_ != b.second.mispredicts_)
+		    return a.second.mispredicts_ > b.second.mispredicts_;
+		  return a.first < b.first;
+		});
+
+      fprintf(file, "# Branches: %lu  mispredicts: %lu  rate: %.2f%%\n",
+	      (unsigned long) branches_, (unsigned long) mispredicts_,
+	      branches_ ? 100.0*mispredicts_/branches_ : 0.0);
+      fprintf(file, "# %-16s %12s %12s %12s %8s  %s\n", "address", "executed",
+	      "taken", "mispredicts", "rate", "location");
+      for (const auto& entry : sorted)
+	{
+	  const Site& site = entry.second;
+	  fprintf(file, "  0x%-14lx %12lu %12lu %12lu %7.2f%%  %s\n",
+		  (unsigned long) entry.first, (unsigned long) site.executed_,
+		  (unsigned long) site.taken_, (unsigned long) site.mispredicts_,
+		  100.0*site.mispredicts_/site.executed_,
+		  symbolize(entry.first).c_str());
+	}
+    }
+
+  protected:
+
+    struct BtbEntry
+    {
+      URV tag_ = 0;       // Branch address.
+      URV target_ = 0;
+      bool valid_ = false;
+    };
+
+    /// Return the statistics entry of the branch site at pc. Recently
+    /// used entries are found in a direct-mapped cache of pointers
+    /// (entries of sites_ do not move).
+    Site& findSite(URV pc)
+    {
+      SiteRef& ref = siteCache_[(pc >> 1) & (siteCacheSize - 1)];
+      if (ref.site_ and ref.pc_ == pc)
+	return *ref.site_;
+      ref.pc_ = pc;
+      ref.site_ = &sites_[pc];
+      return *ref.site_;
+    }
+
+    static bool isLink(unsigned reg)
+    { return reg == 1 or reg == 5; }
+
+    /// Return the index of the history table counter of the branch at
+    /// pc.
+    size_t bhtIndex(URV pc) const
+    {
+      size_t ix = pc >> 1;
+      if (params_.type_ != PredictorParams::Type::Bimodal)
+	ix ^= history_;
+      return ix & (bht_.size() - 1);
+    }
+
+    /// Return the predicted direction of a conditional branch at pc:
+    /// Static backward-taken/forward-not-taken or history table.
+    bool predictDirection(URV pc, bool backward) const
+    {
+      if (params_.type_ == PredictorParams::Type::Static)
+	return backward;
+      return bht_[bhtIndex(pc)] >= 2;
+    }
+
+    /// Update the history table counter of the branch at pc.
+    void updateDirection(URV pc, bool taken)
+    {
+      if (params_.type_ == PredictorParams::Type::Static)
+	return;
+      uint8_t& counter = bht_[bhtIndex(pc)];
+      if (taken)
+	counter += counter < 3;
+      else
+	counter -= counter > 0;
+    }
+
+    /// Fetch-time prediction using the branch target buffer. Return
+    /// true if prediction is correct and update the buffer.
+    bool predictBtb(URV pc, URV nextPc, unsigned size, Kind kind,
+		    bool taken, bool isReturn)
+    {
+      BtbEntry& entry = btb_[(pc >> 1) & (btb_.size() - 1)];
+      bool hit = entry.valid_ and entry.tag_ == pc;
+
+      URV predicted = pc + size;
+      if (hit)
+	{
+	  if (isReturn)
+	    predicted = popReturn();
+	  else if (kind != Kind::Conditional or bht_[bhtIndex(pc)] >= 2)
+	    predicted = entry.target_;
+	}
+      else if (isReturn)
+	popReturn();
+
+      if (taken)
+	{
+	  entry.tag_ = pc;
+	  entry.target_ = nextPc;
+	  entry.valid_ = true;
+	}
+
+      return predicted == nextPc;
+    }
+
+    /// Push a return address dropping the oldest entry if the stack
+    /// is full.
+    void pushReturn(URV addr)
+    {
+      if (params_.rasSize_ == 0)
+	return;
+      if (ras_.size() == params_.rasSize_)
+	ras_.erase(ras_.begin());
+      ras_.push_back(addr);
+    }
+
+    /// Pop and return the top of the return address stack. Return an
+    /// invalid (odd) address if the stack is empty.
+    URV popReturn()
+    {
+      if (ras_.empty())
+	return 1;
+      URV addr = ras_.back();
+      ras_.pop_back();
+      return addr;
+    }
+
+  private:
+
+    bool enabled_ = false;
+    PredictorParams params_;
+    std::vector<uint8_t> bht_ = std::vector<uint8_t>(256, 1);
+    std::vector<BtbEntry> btb_ = std::vector<BtbEntry>(256);
+    unsigned history_ = 0;            // Global branch history.
+    std::vector<URV> ras_;            // Return address stack.
+
+    struct SiteRef
+    {
+      URV pc_ = 0;
+      Site* site_ = nullptr;
+    };
+
+    static constexpr size_t siteCacheSize = 1024;
+
+    std::unordered_map<URV, Site> sites_;
+    std::vector<SiteRef> siteCache_ = std::vector<SiteRef>(siteCacheSize);
+    uint64_t branches_ = 0;
+    uint64_t mispredicts_ = 0;
+  };
+}
@@ -0,0 +1,245 @@
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2018 Western Digital Corporation or its affiliates.
+//
+// This program is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+
+namespace WdRiscv
+{
+
+  /// Geometry and policies of a cache model.
+  struct CacheParams
+  {
+    enum class Replacement { Lru, Fifo, Random };
+
+    uint64_t size_ = 32*1024;     // Capacity in bytes.
+    unsigned ways_ = 4;           // Associativity.
+    unsigned lineSize_ = 64;      // Bytes per line (power of 2).
+    Replacement replacement_ = Replacement::Lru;
+    bool writeBack_ = true;       // Write-back/allocate or write-through/no-allocate.
+    unsigned missPenalty_ = 0;    // Stall cycles per miss.
+  };
+
+
+  /// Model of a set-associative cache: Only the tags are kept (data is
+  /// always in the simulated memory). The tags of a set are contiguous
+  /// in a single array. Under LRU replacement, the ways of a set are
+  /// kept in most-recently-used order so that a hit in the first way
+  /// (the common case) does not move anything. Under FIFO they are
+  /// kept in insertion order. Accesses to the most recently used line
+  /// are detected before the set is searched.
+  class CacheModel
+  {
+  public:
+
+    /// Define the geometry and policies of the cache and invalidate
+    /// it. Return false leaving the cache unchanged if the line size
+    /// or the number of sets is not a power of 2 or if the size is not
+    /// a multiple of the line size times the number of ways.
+    bool configure(const CacheParams& params)
+    {
+      auto isPowerOf2 = [] (uint64_t x) { return x and (x & (x - 1)) == 0; };
+
+      if (not isPowerOf2(params.lineSize_) or params.ways_ == 0)
+	return false;
+      uint64_t setBytes = uint64_t(params.lineSize_) * params.ways_;
+      if (params.size_ % setBytes != 0 or not isPowerOf2(params.size_ / setBytes))
+	return false;
+
+      params_ = params;
+      lineShift_ = __builtin_ctzll(params.lineSize_);
+      setMask_ = params.size_ / setBytes - 1;
+      tags_.assign((setMask_ + 1) * params.ways_, 0);
+      reset();
+      return true;
+    }
+
+    /// Return the geometry and policies of the cache.
+    const CacheParams& params() const
+    { return params_; }
+
+    /// Turn the model on/off.
+    void enable(bool flag)
+    { enabled_ = flag and not tags_.empty(); }
+
+    /// Return true if the model is on.
+    bool enabled() const
+    { return enabled_; }
+
+    /// Invalidate all lines and clear the statistics.
+    void reset()
+    {
+      invalidate();
+      reads_ = writes_ = readMisses_ = writeMisses_ = writebacks_ = 0;
+    }
+
+    /// Invalidate all lines (dirty lines are written back).
+    void invalidate()
+    {
+      for (auto& tag : tags_)
+	{
+	  if ((tag & validBit) and (tag & dirtyBit))
+	    writebacks_++;
+	  tag = 0;
+	}
+      lastSlot_ = nullptr;
+    }
+
+    /// Account for a read (write if write is true) of size bytes at
+    /// the given address. Return true if all the lines covered by the
+    /// access are in the cache (hit).
+    bool access(uint64_t addr, unsigned size, bool write)
+    {
+      uint64_t line = addr >> lineShift_;
+      uint64_t last = (addr + size - 1) >> lineShift_;
+
+      if (write)
+	writes_++;
+      else
+	reads_++;
+
+      bool hit = true;
+      for ( ; line <= last; ++line)
+	hit = accessLine(line, write) and hit;
+
+      if (not hit)
+	{
+	  if (write)
+	    writeMisses_++;
+	  else
+	    readMisses_++;
+	}
+      return hit;
+    }
+
+    /// Return the count of accesses.
+    uint64_t accesses() const
+    { return reads_ + writes_; }
+
+    /// Return the count of accesses that missed.
+    uint64_t misses() const
+    { return readMisses_ + writeMisses_; }
+
+    /// Return the count of read accesses.
+    uint64_t reads() const
+    { return reads_; }
+
+    /// Return the count of write accesses.
+    uint64_t writes() const
+    { return writes_; }
+
+    /// Return the count of read accesses that missed.
+    uint64_t readMisses() const
+    { return readMisses_; }
+
+    /// Return the count of write accesses that missed.
+    uint64_t writeMisses() const
+    { return writeMisses_; }
+
+    /// Return the count of dirty lines written back (evicted or
+    /// invalidated).
+    uint64_t writebacks() const
+    { return writebacks_; }
+
+  protected:
+
+    // A tag array entry is the line number shifted left by 2 with a
+    // valid bit and a dirty bit. Zero is an invalid entry.
+    static constexpr uint64_t validBit = 2;
+    static constexpr uint64_t dirtyBit = 1;
+
+    /// Look up the given line number updating the replacement state.
+    /// Allocate the line on a miss (unless write-through write).
+    /// Return true on a hit.
+    bool accessLine(uint64_t line, bool write)
+    {
+      uint64_t key = (line << 2) | validBit;
+      uint64_t dirty = (write and params_.writeBack_) ? dirtyBit : 0;
+
+      if (lastSlot_ and (*lastSlot_ & ~dirtyBit) == key)
+	{
+	  *lastSlot_ |= dirty;
+	  return true;
+	}
+
+      unsigned ways = params_.ways_;
+      uint64_t* set = &tags_[(line & setMask_) * ways];
+
+      for (unsigned i = 0; i < ways; ++i)
+	if ((set[i] & ~dirtyBit) == key)
+	  {
+	    uint64_t entry = set[i] | dirty;
+	    unsigned slot = i;
+	    if (params_.replacement_ == CacheParams::Replacement::Lru)
+	      {
+		// Move to front.
+		for ( ; slot > 0; --slot)
+		  set[slot] = set[slot - 1];
+	      }
+	    set[slot] = entry;
+	    lastSlot_ = &set[slot];
+	    return true;
+	  }
+
+      if (write and not params_.writeBack_)
+	return false;   // No write allocate.
+
+      // Miss: Replace last way (least recently used or oldest) or a
+      // random way.
+      unsigned slot = ways - 1;
+      if (params_.replacement_ == CacheParams::Replacement::Random)
+	{
+	  random_ ^= random_ << 13;
+	  random_ ^= random_ >> 7;
+	  random_ ^= random_ << 17;
+	  slot = random_ % ways;
+	}
+
+      uint64_t victim = set[slot];
+      if ((victim & validBit) and (victim & dirtyBit))
+	writebacks_++;
+
+      if (params_.replacement_ != CacheParams::Replacement::Random)
+	for ( ; slot > 0; --slot)
+	  set[slot] = set[slot - 1];
+
+      set[slot] = key | dirty;
+      lastSlot_ = &set[slot];
+      return false;
+    }
+
+  private:
+
+    bool enabled_ = false;
+    CacheParams params_;
+    std::vector<uint64_t> tags_;     // Ways of set n at n*ways_.
+    unsigned lineShift_ = 6;
+    uint64_t setMask_ = 0;
+    uint64_t* lastSlot_ = nullptr;   // Entry of most recently used line.
+    uint64_t random_ = 0x2545f4914f6cdd1d;  // Random replacement state.
+
+    uint64_t reads_ = 0;
+    uint64_t writes_ = 0;
+    uint64_t readMisses_ = 0;
+    uint64_t writeMisses_ = 0;
+    uint64_t writebacks_ = 0;
+  };
+}
@@ -0,0 +1,117 @@
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2018 Western Digital Corporation or its affiliates.
+//
+// This program is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <array>
+#include <unistd.h>
+
+
+namespace WdRiscv
+{
+
+  /// Console device of the simulated system. Bytes written by the
+  /// target program are accumulated in a buffer which is handed to
+  /// the output file when full, at end of line if the output is a
+  /// terminal, or when explicitly flushed (the core flushes it when a
+  /// run stops). Bytes read by the target program come from a buffer
+  /// refilled in chunks from the standard input.
+  class Console
+  {
+  public:
+
+    /// Direct output to the given file (nullptr to discard output)
+    /// after flushing pending output to the previous file.
+    void setOutput(FILE* out)
+    {
+      flush();
+      out_ = out;
+      lineMode_ = out and isatty(fileno(out));
+    }
+
+    /// Write given byte to the console.
+    void putChar(uint8_t byte)
+    {
+      outBuf_[outCount_++] = byte;
+      if (outCount_ == outBuf_.size() or (byte == '\n' and lineMode_))
+	flush();
+    }
+
+    /// Write the given number of bytes to the console.
+    void write(const uint8_t* data, size_t size)
+    {
+      if (size > outBuf_.size() - outCount_)
+	{
+	  flush();
+	  if (size >= outBuf_.size())
+	    {
+	      if (out_)
+		{
+		  fwrite(data, 1, size, out_);
+		  fflush(out_);
+		}
+	      return;
+	    }
+	}
+      memcpy(outBuf_.data() + outCount_, data, size);
+      outCount_ += size;
+      if (lineMode_ and memchr(data, '\n', size))
+	flush();
+    }
+
+    /// Hand pending output to the output file.
+    void flush()
+    {
+      if (outCount_ and out_)
+	{
+	  fwrite(outBuf_.data(), 1, outCount_, out_);
+	  fflush(out_);
+	}
+      outCount_ = 0;
+    }
+
+    /// Return next byte from the standard input or -1 if no more
+    /// input. Pending output is flushed first (it may be a prompt).
+    int getChar()
+    {
+      if (inPos_ == inCount_)
+	{
+	  flush();
+	  ssize_t count = read(fileno(stdin), inBuf_.data(), inBuf_.size());
+	  if (count <= 0)
+	    return -1;
+	  inPos_ = 0;
+	  inCount_ = count;
+	}
+      return inBuf_[inPos_++];
+    }
+
+  private:
+
+    FILE* out_ = nullptr;
+    bool lineMode_ = false;                // Flush at end of line.
+    std::array<uint8_t, 64*1024> outBuf_;  // Pending output.
+    size_t outCount_ = 0;                  // Count of pending output bytes.
+    std::array<uint8_t, 4*1024> inBuf_;    // Input not yet consumed.
+    size_t inPos_ = 0;                     // Next input byte.
+    size_t inCount_ = 0;                   // Count of bytes in inBuf_.
+  };
+}
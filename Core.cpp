@@ -25,15 +25,12 @@
 #include <boost/format.hpp>
 #include <string.h>
 #include <time.h>
-#include <fcntl.h>
 #include <sys/time.h>
-#include <sys/stat.h>
-#include <sys/uio.h>
-#include <sys/utsname.h>
 #include <assert.h>
 #include <signal.h>
 #include "Core.hpp"
 #include "instforms.hpp"
+#include "SoftFloat.hpp"
 
 using namespace WdRiscv;
 
@@ -66,7 +63,8 @@ parseNumber(const std::string& numberStr, TYPE& number)
 
 template <typename URV>
 Core<URV>::Core(unsigned hartId, size_t memorySize, unsigned intRegCount)
-  : hartId_(hartId), memory_(memorySize), intRegs_(intRegCount), fpRegs_(32)
+  : hartId_(hartId), memory_(memorySize), intRegs_(intRegCount), fpRegs_(32),
+    syscall_(intRegs_, memory_)
 {
   regionHasLocalMem_.resize(16);
 
@@ -97,6 +95,17 @@ Core<URV>::Core(unsigned hartId, size_t memorySize, unsigned intRegCount)
       csRegs_.regs_.at(size_t(CsrNumber::MINSTRET)).tie(&retiredInsts_);
       csRegs_.regs_.at(size_t(CsrNumber::MCYCLE)).tie(&cycleCount_);
     }
+
+  csRegs_.tieInterruptEvent(&pendingEvent_);
+
+  // Vector configuration CSRs live in the core: They are consulted by
+  // every vector instruction.
+  csRegs_.regs_.at(size_t(CsrNumber::VSTART)).tie(&vstart_);
+  csRegs_.regs_.at(size_t(CsrNumber::VL)).tie(&vl_);
+  csRegs_.regs_.at(size_t(CsrNumber::VTYPE)).tie(&vtype_);
+
+  decodeCache_.resize(size_t(1) << 12);
+  buildDecodeTables();
 }
 
 
@@ -136,10 +145,16 @@ Core<URV>::reset()
 
   clearTraceData();
   clearPendingNmi();
+  timing_.reset();
+  predictor_.reset();
+  icache_.reset();
+  dcache_.reset();
 
   storeQueue_.clear();
   loadQueue_.clear();
 
+  syscall_.reset();
+
   pc_ = resetPc_;
   currPc_ = resetPc_;
 
@@ -149,6 +164,8 @@ Core<URV>::reset()
   // MISA CSR.  D requires F and is enabled only if F is enabled.
   rvm_ = false;
   rvc_ = false;
+  rvb_ = false;
+  rvv_ = false;
 
   URV value = 0;
   if (peekCsr(CsrNumber::MISA, value))
@@ -159,6 +176,9 @@ Core<URV>::reset()
       if (value & (URV(1) << ('c' - 'a')))  // Compress option.
 	rvc_ = true;
 
+      if (value & (URV(1) << ('b' - 'a')))  // Bit manipulation option.
+	rvb_ = true;  // Zba, Zbb, and Zbs.
+
       if (value & (URV(1) << ('f' - 'a')))  // Single precision FP
 	{
 	  rvf_ = true;
@@ -196,8 +216,33 @@ Core<URV>::reset()
       if (value & (URV(1) << ('s' - 'a')))  // Supervisor-mode option.
 	rvs_ = true;
 
-      for (auto ec : { 'b', 'e', 'g', 'h', 'j', 'k', 'l', 'n', 'o', 'p',
-	    'q', 'r', 't', 'v', 'w', 'x', 'y', 'z' } )
+      if (value & (URV(1) << ('v' - 'a')))  // Vector option.
+	{
+	  rvv_ = true;
+
+	  bool isDebug = false;
+	  URV wam = ~URV(0);  // Write all mask.
+	  URV vill = URV(1) << (8*sizeof(URV) - 1);
+
+	  // Make sure the vector CSRs are enabled if V extension is on.
+	  if (not csRegs_.getImplementedCsr(CsrNumber::VSTART))
+	    csRegs_.configCsr("vstart", true, 0, wam, wam, isDebug);
+	  if (not csRegs_.getImplementedCsr(CsrNumber::VXSAT))
+	    csRegs_.configCsr("vxsat", true, 0, 1, 1, isDebug);
+	  if (not csRegs_.getImplementedCsr(CsrNumber::VXRM))
+	    csRegs_.configCsr("vxrm", true, 0, 3, 3, isDebug);
+	  if (not csRegs_.getImplementedCsr(CsrNumber::VCSR))
+	    csRegs_.configCsr("vcsr", true, 0, 7, 7, isDebug);
+	  if (not csRegs_.getImplementedCsr(CsrNumber::VL))
+	    csRegs_.configCsr("vl", true, 0, wam, wam, isDebug);
+	  if (not csRegs_.getImplementedCsr(CsrNumber::VTYPE))
+	    csRegs_.configCsr("vtype", true, vill, wam, wam, isDebug);
+	  csRegs_.configCsr("vlenb", true, vecRegs_.bytesPerReg(), 0, 0,
+			    isDebug);
+	}
+
+      for (auto ec : { 'e', 'g', 'h', 'j', 'k', 'l', 'n', 'o', 'p',
+	    'q', 'r', 't', 'w', 'x', 'y', 'z' } )
 	{
 	  unsigned bit = ec - 'a';
 	  if (value & (URV(1) << bit))
@@ -206,6 +251,8 @@ Core<URV>::reset()
 		      << "-- ignored\n";
 	}
     }
+
+  buildDecodeTables();
   
   prevCountersCsrOn_ = true;
   countersCsrOn_ = true;
@@ -217,6 +264,7 @@ Core<URV>::reset()
 
   debugMode_ = false;
   debugStepMode_ = false;
+  pendingEvent_ = true;
 
   dcsrStepIe_ = false;
   dcsrStep_ = false;
@@ -343,6 +391,7 @@ void
 Core<URV>::setPendingNmi(NmiCause cause)
 {
   nmiPending_ = true;
+  pendingEvent_ = true;
 
   if (nmiCause_ == NmiCause::STORE_EXCEPTION or
       nmiCause_ == NmiCause::LOAD_EXCEPTION)
@@ -1037,6 +1086,70 @@ Core<URV>::misalignedAccessCausesException(URV addr, unsigned accessSize) const
 }
 
 
+template <typename URV>
+bool
+Core<URV>::loadTriggerTripped(URV addr, unsigned size)
+{
+  typedef TriggerTiming Timing;
+
+  bool isLoad = true;
+  if (ldStAddrTriggerHit(addr, Timing::Before, isLoad, isInterruptEnabled()))
+    triggerTripped_ = true;
+  if (not triggerTripped_)
+    return false;
+
+  // We get a load finished for loads with exception. Compensate.
+  if (loadQueueEnabled_ and not forceAccessFail_)
+    putInLoadQueue(size, addr, 0, 0);
+  return true;
+}
+
+
+template <typename URV>
+template <typename LOAD_TYPE>
+bool
+Core<URV>::readLoadData(URV addr, LOAD_TYPE& value)
+{
+  // Misaligned load from io section triggers an exception. Crossing
+  // dccm to non-dccm causes an exception.
+  constexpr unsigned alignMask = sizeof(LOAD_TYPE) - 1;
+  bool misaligned = addr & alignMask;
+  misalignedLdSt_ = misaligned;
+  if (misaligned and misalignedAccessCausesException(addr, sizeof(LOAD_TYPE)))
+    {
+      // We get a load finished for loads with exception. Compensate.
+      if (loadQueueEnabled_ and not forceAccessFail_)
+	putInLoadQueue(sizeof(LOAD_TYPE), addr, 0, 0);
+      forceAccessFail_ = false;
+      ldStException_ = true;
+      initiateException(ExceptionCause::LOAD_ADDR_MISAL, currPc_, addr);
+      return false;
+    }
+
+  if (forceAccessFail_ or not memory_.read(addr, value))
+    {
+      // We get a load finished for loads with exception. Compensate.
+      if (loadQueueEnabled_ and not forceAccessFail_)
+	putInLoadQueue(sizeof(LOAD_TYPE), addr, 0, 0);
+      forceAccessFail_ = false;
+      ldStException_ = true;
+      initiateException(ExceptionCause::LOAD_ACC_FAULT, currPc_, addr);
+      return false;
+    }
+
+  if (dcache_.enabled())
+    accessDataCache(addr, sizeof(LOAD_TYPE), false);
+  if (memTrace_.enabled())
+    traceDataAccess(addr, sizeof(LOAD_TYPE), false);
+  if (pageProfile_.enabled())
+    pageProfile_.access(PageProfile::Access::Read, addr, retiredInsts_);
+
+  if (watchCheck_)
+    checkWatchpoint(addr, sizeof(LOAD_TYPE), true);
+  return true;
+}
+
+
 template <typename URV>
 template <typename LOAD_TYPE>
 void
@@ -1050,21 +1163,8 @@ Core<URV>::load(uint32_t rd, uint32_t rs1, int32_t imm)
   if (loadQueueEnabled_)
     removeFromLoadQueue(rs1);
 
-  if (hasActiveTrigger())
-    {
-      typedef TriggerTiming Timing;
-
-      bool isLoad = true;
-      if (ldStAddrTriggerHit(addr, Timing::Before, isLoad, isInterruptEnabled()))
-	triggerTripped_ = true;
-      if (triggerTripped_)
-	{
-	  // We get a load finished for loads with exception. Compensate.
-	  if (loadQueueEnabled_ and not forceAccessFail_)
-	    putInLoadQueue(sizeof(LOAD_TYPE), addr, 0, 0);
-	  return;
-	}
-    }
+  if (hasActiveTrigger() and loadTriggerTripped(addr, sizeof(LOAD_TYPE)))
+    return;
 
   // Unsigned version of LOAD_TYPE
   typedef typename std::make_unsigned<LOAD_TYPE>::type ULT;
@@ -1075,56 +1175,31 @@ Core<URV>::load(uint32_t rd, uint32_t rs1, int32_t imm)
       // from standard input.
       if (conIoValid_ and addr == conIo_)
 	{
-	  int c = fgetc(stdin);
+	  int c = console_.getChar();
 	  SRV val = c;
 	  intRegs_.write(rd, val);
 	  return;
 	}
     }
 
-  // Misaligned load from io section triggers an exception. Crossing
-  // dccm to non-dccm causes an exception.
-  constexpr unsigned alignMask = sizeof(LOAD_TYPE) - 1;
-  bool misaligned = addr & alignMask;
-  misalignedLdSt_ = misaligned;
-  if (misaligned and misalignedAccessCausesException(addr, sizeof(LOAD_TYPE)))
-    {
-      // We get a load finished for loads with exception. Compensate.
-      if (loadQueueEnabled_ and not forceAccessFail_)
-	putInLoadQueue(sizeof(LOAD_TYPE), addr, 0, 0);
-      forceAccessFail_ = false;
-      ldStException_ = true;
-      initiateException(ExceptionCause::LOAD_ADDR_MISAL, currPc_, addr);
-      return;
-    }
-
   ULT uval = 0;
-  if (not forceAccessFail_ and memory_.read(addr, uval))
-    {
-      URV value;
-      if constexpr (std::is_same<ULT, LOAD_TYPE>::value)
-        value = uval;
-      else
-        value = SRV(LOAD_TYPE(uval)); // Sign extend.
-
-      if (loadQueueEnabled_)
-	{
-	  URV prev = 0;
-	  peekIntReg(rd, prev);
-	  putInLoadQueue(sizeof(LOAD_TYPE), addr, rd, prev);
-	}
+  if (not readLoadData(addr, uval))
+    return;
 
-      intRegs_.write(rd, value);
-    }
+  URV value;
+  if constexpr (std::is_same<ULT, LOAD_TYPE>::value)
+    value = uval;
   else
+    value = SRV(LOAD_TYPE(uval)); // Sign extend.
+
+  if (loadQueueEnabled_)
     {
-      // We get a load finished for loads with exception. Compensate.
-      if (loadQueueEnabled_ and not forceAccessFail_)
-	putInLoadQueue(sizeof(LOAD_TYPE), addr, 0, 0);
-      forceAccessFail_ = false;
-      ldStException_ = true;
-      initiateException(ExceptionCause::LOAD_ACC_FAULT, currPc_, addr);
+      URV prev = 0;
+      peekIntReg(rd, prev);
+      putInLoadQueue(sizeof(LOAD_TYPE), addr, rd, prev);
     }
+
+  intRegs_.write(rd, value);
 }
 
 
@@ -1242,7 +1317,15 @@ Core<URV>::fetchInst(size_t addr, uint32_t& inst)
     }
 
   if (memory_.readInstWord(addr, inst))
-    return true;
+    {
+      if (icache_.enabled())
+	accessInstCache(addr, inst);
+      if (memTrace_.fetchesEnabled())
+	traceFetch(addr, inst);
+      if (pageProfile_.enabled())
+	pageProfile_.access(PageProfile::Access::Fetch, addr, retiredInsts_);
+      return true;
+    }
 
   uint16_t half;
   if (not memory_.readInstHalfWord(addr, half))
@@ -1253,7 +1336,15 @@ Core<URV>::fetchInst(size_t addr, uint32_t& inst)
 
   inst = half;
   if (isCompressedInst(inst))
-    return true;
+    {
+      if (icache_.enabled())
+	accessInstCache(addr, inst);
+      if (memTrace_.fetchesEnabled())
+	traceFetch(addr, inst);
+      if (pageProfile_.enabled())
+	pageProfile_.access(PageProfile::Access::Fetch, addr, retiredInsts_);
+      return true;
+    }
 
 #if 1
   // 4-byte instruction but 4-byte fetch failed.
@@ -1376,6 +1467,9 @@ template <typename URV>
 void
 Core<URV>::initiateTrap(bool interrupt, URV cause, URV pcToSave, URV info)
 {
+  // FCSR must be up to date for the trap handler (or a debugger).
+  syncFpFlags();
+
   PrivilegeMode origMode = privMode_;
 
   // Exceptions are taken in machine mode.
@@ -1583,6 +1677,47 @@ Core<URV>::pokeFpReg(unsigned ix, uint64_t val)
 }
 
 
+template <typename URV>
+bool
+Core<URV>::peekVecReg(unsigned ix, std::vector<uint8_t>& bytes) const
+{
+  if (not isRvv())
+    return false;
+
+  return vecRegs_.peek(ix, bytes);
+}
+
+
+template <typename URV>
+bool
+Core<URV>::pokeVecReg(unsigned ix, const std::vector<uint8_t>& bytes)
+{
+  if (not isRvv())
+    return false;
+
+  return vecRegs_.poke(ix, bytes);
+}
+
+
+template <typename URV>
+bool
+Core<URV>::configVectorLength(unsigned bits)
+{
+  if (bits < 64 or bits > 65536 or (bits & (bits - 1)) != 0)
+    {
+      std::cerr << "Invalid vector register length: " << bits
+		<< " (expecting a power of 2 between 64 and 65536)\n";
+      return false;
+    }
+
+  vecRegs_.config(bits / 8);
+
+  if (csRegs_.getImplementedCsr(CsrNumber::VLENB))
+    csRegs_.configCsr("vlenb", true, bits / 8, 0, 0, false);
+  return true;
+}
+
+
 template <typename URV>
 bool
 Core<URV>::pokeIntReg(unsigned ix, URV val)
@@ -1600,7 +1735,10 @@ template <typename URV>
 bool
 Core<URV>::peekCsr(CsrNumber csrn, URV& val) const
 { 
-  return csRegs_.peek(csrn, val);
+  if (not csRegs_.peek(csrn, val))
+    return false;
+  addPendingFpFlags(csrn, val);
+  return true;
 }
 
 
@@ -1615,6 +1753,7 @@ Core<URV>::peekCsr(CsrNumber csrn, URV& val, URV& reset, URV& writeMask,
 
   if (not csRegs_.peek(csrn, val))
     return false;
+  addPendingFpFlags(csrn, val);
 
   reset = csr->getResetValue();
   writeMask = csr->getWriteMask();
@@ -1633,6 +1772,7 @@ Core<URV>::peekCsr(CsrNumber csrn, URV& val, std::string& name) const
 
   if (not csRegs_.peek(csrn, val))
     return false;
+  addPendingFpFlags(csrn, val);
 
   name = csr->getName();
   return true;
@@ -1643,6 +1783,9 @@ template <typename URV>
 bool
 Core<URV>::pokeCsr(CsrNumber csr, URV val)
 { 
+  if (csr <= CsrNumber::FCSR)
+    syncFpFlags();  // Pending flags precede the poke.
+
   // Direct write to MEIHAP will not affect claimid field. Poking
   // MEIHAP will only affect the claimid field.
   if (csr == CsrNumber::MEIHAP)
@@ -1831,6 +1974,26 @@ formatFpInstTrace(FILE* out, uint64_t tag, unsigned hartId, URV currPc,
 }
 
 
+template <typename URV>
+void
+formatVecInstTrace(FILE* out, uint64_t tag, unsigned hartId, URV currPc,
+		   const char* opcode, unsigned vecReg, const uint8_t* data,
+		   unsigned byteCount, const char* assembly)
+{
+  if constexpr (sizeof(URV) == 4)
+    fprintf(out, "#%ld %d %08x %8s v %02x ",
+	    tag, hartId, currPc, opcode, vecReg);
+  else
+    fprintf(out, "#%ld %d %016lx %8s v %016lx ",
+	    tag, hartId, currPc, opcode, uint64_t(vecReg));
+
+  // Most significant byte first.
+  for (unsigned i = byteCount; i > 0; --i)
+    fprintf(out, "%02x", data[i-1]);
+  fprintf(out, "  %s", assembly);
+}
+
+
 template <typename URV>
 void
 Core<URV>::printInstTrace(uint32_t inst, uint64_t tag, std::string& tmp,
@@ -1882,6 +2045,19 @@ Core<URV>::printInstTrace(uint32_t inst, uint64_t tag, std::string& tmp,
       pending = true;
     }
 
+  // Process vector register diff: One line per register of the
+  // written group.
+  int vecReg = vecRegs_.getLastWrittenReg();
+  unsigned vecCount = vecReg >= 0? vecRegs_.getLastWrittenCount() : 0;
+  for (unsigned i = 0; i < vecCount; ++i)
+    {
+      if (pending) fprintf(out, "  +\n");
+      formatVecInstTrace<URV>(out, tag, hartId_, currPc_, instBuff,
+			      vecReg + i, vecRegs_.elems<uint8_t>(vecReg + i),
+			      vecRegs_.bytesPerReg(), tmp.c_str());
+      pending = true;
+    }
+
   // Process CSR diffs.
   std::vector<CsrNumber> csrs;
   std::vector<unsigned> triggers;
@@ -2023,110 +2199,303 @@ addToUnsignedHistogram(std::vector<uint64_t>& histo, uint64_t val)
 
 template <typename URV>
 void
-Core<URV>::accumulateInstructionStats(uint32_t inst)
+Core<URV>::accumulateBasicBlockVectors(uint32_t inst)
 {
-  uint32_t op0 = 0, op1 = 0; int32_t op2 = 0;
-  const InstInfo& info = decode(inst, op0, op1, op2);
-  InstId id = info.instId();
+  // Conditional branch: beq/bne/... or c.beqz/c.bnez.
+  bool full = isFullSizeInst(inst);
+  bool isBranch = (full? (inst & 0x7f) == 0x63 :
+		   (inst & 3) == 1 and ((inst >> 13) & 7) >= 6);
+  bbv_.retire(currPc_, pc_, full? 4 : 2, isBranch);
+}
+
 
-  if (enableCounters_ and prevCountersCsrOn_)
+template <typename URV>
+void
+Core<URV>::accumulateTiming(uint32_t inst)
+{
+  // Use the decoded forms kept by execute32/execute16.
+  uint32_t op0 = 0, op1 = 0; int32_t op2 = 0;
+  InstId id;
+  if (isFullSizeInst(inst))
     {
-      PerfRegs& pregs = csRegs_.mPerfRegs_;
-      pregs.updateCounters(EventNumber::InstCommited);
+      const Decoded32& entry = decode32(inst);
+      id = InstId(entry.id);
+      op0 = entry.op0; op1 = entry.op1; op2 = entry.op2;
+    }
+  else
+    {
+      const Compressed16& entry = compressedTable_[inst & 0xffff];
+      id = InstId(entry.id);
+      op0 = entry.op0; op1 = entry.op1; op2 = entry.op2;
+    }
+  const auto& it = timing_.instTiming(id, instTable_);
 
-      if (isCompressedInst(inst))
-	pregs.updateCounters(EventNumber::Inst16Commited);
+  // A cache hit is as fast as a closely coupled memory access.
+  bool iccm = ((icache_.enabled() and icacheHit_) or
+	       memory_.getAttrib(currPc_).isIccm());
+  bool dccm = true;
+  if (it.unit_ == TimingModel<URV>::Unit::Mem)
+    {
+      if (dcache_.enabled() and dcacheHit_)
+	dccm = true;
+      else if (it.isLoad_)
+	dccm = memory_.getAttrib(loadAddr_).isDccm();
       else
-	pregs.updateCounters(EventNumber::Inst32Commited);
+	dccm = memory_.isLastWriteToDccm();
+    }
 
-      if ((currPc_ & 3) == 0)
-	pregs.updateCounters(EventNumber::InstAligned);
+  unsigned size = instructionSize(inst);
+  bool mispredict = it.branch_ and predictBranch(id, op0, op1, op2, size);
 
-      if (info.type() == InstType::Int)
-	{
-	  if (id == InstId::ebreak or id == InstId::c_ebreak)
-	    pregs.updateCounters(EventNumber::Ebreak);
-	  else if (id == InstId::ecall)
-	    pregs.updateCounters(EventNumber::Ecall);
-	  else if (id == InstId::fence)
-	    pregs.updateCounters(EventNumber::Fence);
-	  else if (id == InstId::fencei)
-	    pregs.updateCounters(EventNumber::Fencei);
-	  else if (id == InstId::mret)
-	    pregs.updateCounters(EventNumber::Mret);
-	  else if (id != InstId::illegal)
-	    pregs.updateCounters(EventNumber::Alu);
-	}
-      else if (info.isMultiply())
-	pregs.updateCounters(EventNumber::Mult);
-      else if (info.isDivide())
-	pregs.updateCounters(EventNumber::Div);
-      else if (info.isLoad())
-	{
-	  pregs.updateCounters(EventNumber::Load);
-	  if (misalignedLdSt_)
-	    pregs.updateCounters(EventNumber::MisalignLoad);
-	}
-      else if (info.isStore())
-	{
-	  pregs.updateCounters(EventNumber::Store);
-	  if (misalignedLdSt_)
-	    pregs.updateCounters(EventNumber::MisalignStore);
-	}
-      else if (info.isCsr() and not csrException_)
-	{
-	  if ((id == InstId::csrrw or id == InstId::csrrwi))
-	    {
-	      if (op0 == 0)
-		pregs.updateCounters(EventNumber::CsrWrite);
-	      else
-		pregs.updateCounters(EventNumber::CsrReadWrite);
-	    }
-	  else
-	    {
-	      if (op1 == 0)
-		pregs.updateCounters(EventNumber::CsrRead);
-	      else
-		pregs.updateCounters(EventNumber::CsrReadWrite);
-	    }
+  uint64_t elapsed = timing_.retire(currPc_, pc_, size, it, op0, op1, op2,
+				    iccm, dccm, mispredict);
 
-	  // Counter modified by csr instruction is not updated.
-	  std::vector<CsrNumber> csrs;
-	  std::vector<unsigned> triggers;
-	  csRegs_.getLastWrittenRegs(csrs, triggers);
-	  for (auto& csr : csrs)
-	    if (pregs.isModified(unsigned(csr) - unsigned(CsrNumber::MHPMCOUNTER3)))
-	      {
-		URV val;
-		peekCsr(csr, val);
-		pokeCsr(csr, val - 1);
-	      }
-	    else if (csr >= CsrNumber::MHPMEVENT3 and csr <= CsrNumber::MHPMEVENT31)
-	      {
-		unsigned id = unsigned(csr) - unsigned(CsrNumber::MHPMEVENT3);
-		if (pregs.isModified(id))
-		  {
-		    URV val;
-		    CsrNumber csr2 = CsrNumber(id + unsigned(CsrNumber::MHPMCOUNTER3));
-		    if (pregs.isModified(unsigned(csr2) - unsigned(CsrNumber::MHPMCOUNTER3)))
-		      {
-			peekCsr(csr2, val);
-			pokeCsr(csr2, val - 1);
-		      }
-		  }
-	      }
-	}
-      else if (info.isBranch())
-	{
-	  pregs.updateCounters(EventNumber::Branch);
-	  if (lastBranchTaken_)
-	    pregs.updateCounters(EventNumber::BranchTaken);
-	}
+  // Run loop already counted one cycle for this instruction.
+  cycleCount_ = cycleCount_ + elapsed - 1;
 
-      pregs.clearModified();
-    }
+  PerfRegs& pregs = csRegs_.mPerfRegs_;
+  if (not enableCounters_ or not countersCsrOn_ or
+      not pregs.hasAssignedEvents())
+    return;
 
-  prevCountersCsrOn_ = countersCsrOn_;
+  const TimingEvents& events = timing_.lastEvents();
+  pregs.updateCounters(EventNumber::ClockActive, elapsed);
+  pregs.updateCounters(EventNumber::FetchStall, events.fetchStall_);
+  pregs.updateCounters(EventNumber::DecodeStall, events.dependStall_);
+  pregs.updateCounters(EventNumber::PreSynchStall, events.syncStall_);
+  pregs.updateCounters(EventNumber::BusFetch, events.busFetches_);
+  if (events.busLoadStore_)
+    pregs.updateCounters(EventNumber::BustLdSt);
+}
+
+
+template <typename URV>
+void
+Core<URV>::accumulateBranchPrediction(uint32_t inst)
+{
+  // Filter on opcode: Branch, jal, jalr, c.j, c.jal (rv32), c.beqz,
+  // c.bnez, c.jr and c.jalr.
+  uint32_t op0 = 0, op1 = 0; int32_t op2 = 0;
+  InstId id;
+  if (isFullSizeInst(inst))
+    {
+      unsigned opcode = inst & 0x7f;
+      if (opcode != 0x63 and opcode != 0x6f and opcode != 0x67)
+	return;
+      const Decoded32& entry = decode32(inst);
+      id = InstId(entry.id);
+      op0 = entry.op0; op1 = entry.op1; op2 = entry.op2;
+    }
+  else
+    {
+      unsigned quadrant = inst & 3, funct3 = (inst >> 13) & 7;
+      bool cti = false;
+      if (quadrant == 1)
+	cti = funct3 >= 5 or (funct3 == 1 and sizeof(URV) == 4);
+      else if (quadrant == 2)
+	cti = (funct3 == 4 and ((inst >> 2) & 0x1f) == 0 and
+	       ((inst >> 7) & 0x1f) != 0);
+      if (not cti)
+	return;
+      const Compressed16& entry = compressedTable_[inst & 0xffff];
+      id = InstId(entry.id);
+      op0 = entry.op0; op1 = entry.op1; op2 = entry.op2;
+    }
+
+  if (id != InstId::illegal)
+    predictBranch(id, op0, op1, op2, instructionSize(inst));
+}
+
+
+template <typename URV>
+bool
+Core<URV>::predictBranch(InstId id, uint32_t op0, uint32_t op1, int32_t op2,
+			 unsigned size)
+{
+  typedef typename BranchPredictor<URV>::Kind Kind;
+
+  Kind kind = Kind::Conditional;
+  if (id == InstId::jal or id == InstId::c_jal or id == InstId::c_j)
+    kind = Kind::Jal;
+  else if (id == InstId::jalr or id == InstId::c_jr or id == InstId::c_jalr)
+    kind = Kind::Jalr;
+
+  URV target = currPc_ + SRV(op2);
+  bool mispredict = predictor_.retire(currPc_, pc_, target, size, kind,
+				      op0, op1);
+
+  if (mispredict and enableCounters_ and countersCsrOn_)
+    {
+      PerfRegs& pregs = csRegs_.mPerfRegs_;
+      pregs.updateCounters(EventNumber::BranchMiss, 1);
+    }
+  return mispredict;
+}
+
+
+template <typename URV>
+void
+Core<URV>::accessInstCache(URV addr, uint32_t inst)
+{
+  PageAttribs attrib = memory_.getAttrib(addr);
+  if (attrib.isIccm() or attrib.isMemMappedReg())
+    {
+      icacheHit_ = false;
+      return;  // Not cached.
+    }
+
+  icacheHit_ = icache_.access(addr, instructionSize(inst), false);
+  if (not icacheHit_ and not timing_.enabled())
+    cycleCount_ += icache_.params().missPenalty_;
+
+  if (enableCounters_ and countersCsrOn_)
+    {
+      PerfRegs& pregs = csRegs_.mPerfRegs_;
+      pregs.updateCounters(icacheHit_? EventNumber::ICacheHits :
+			   EventNumber::ICacheMisses, 1);
+    }
+}
+
+
+template <typename URV>
+void
+Core<URV>::accessDataCache(URV addr, unsigned size, bool write)
+{
+  PageAttribs attrib = memory_.getAttrib(addr);
+  if (attrib.isDccm() or attrib.isMemMappedReg())
+    {
+      dcacheHit_ = false;
+      return;  // Not cached.
+    }
+
+  dcacheHit_ = dcache_.access(addr, size, write);
+  if (not dcacheHit_ and not timing_.enabled())
+    cycleCount_ += dcache_.params().missPenalty_;
+
+  if (enableCounters_ and countersCsrOn_)
+    {
+      PerfRegs& pregs = csRegs_.mPerfRegs_;
+      pregs.updateCounters(dcacheHit_? EventNumber::DCacheHits :
+			   EventNumber::DCacheMisses, 1);
+    }
+}
+
+
+template <typename URV>
+void
+Core<URV>::accumulateInstructionStats(uint32_t inst)
+{
+  PerfRegs& pregs = csRegs_.mPerfRegs_;
+  bool doCounters = (enableCounters_ and prevCountersCsrOn_ and
+		     pregs.hasAssignedEvents());
+
+  if (not doCounters and not instMix_ and not instFreq_)
+    {
+      // Nothing to count (common case with counters enabled but
+      // no event assigned to a counter): Skip decode. Modified marks
+      // left by this instruction must not leak into the next one.
+      pregs.clearModified();
+      prevCountersCsrOn_ = countersCsrOn_;
+      misalignedLdSt_ = false;
+      lastBranchTaken_ = false;
+      return;
+    }
+
+  uint32_t op0 = 0, op1 = 0; int32_t op2 = 0;
+  const InstInfo& info = decode(inst, op0, op1, op2);
+  InstId id = info.instId();
+
+  if (instMix_ and id != InstId::illegal)
+    instTypeCounts_.at(size_t(info.type()))++;
+
+  if (doCounters)
+    {
+      pregs.updateCounters(EventNumber::InstCommited);
+
+      if (isCompressedInst(inst))
+	pregs.updateCounters(EventNumber::Inst16Commited);
+      else
+	pregs.updateCounters(EventNumber::Inst32Commited);
+
+      if ((currPc_ & 3) == 0)
+	pregs.updateCounters(EventNumber::InstAligned);
+
+      if (info.type() == InstType::Int)
+	{
+	  if (id == InstId::ebreak or id == InstId::c_ebreak)
+	    pregs.updateCounters(EventNumber::Ebreak);
+	  else if (id == InstId::ecall)
+	    pregs.updateCounters(EventNumber::Ecall);
+	  else if (id == InstId::fence)
+	    pregs.updateCounters(EventNumber::Fence);
+	  else if (id == InstId::fencei)
+	    pregs.updateCounters(EventNumber::Fencei);
+	  else if (id == InstId::mret)
+	    pregs.updateCounters(EventNumber::Mret);
+	  else if (id != InstId::illegal)
+	    pregs.updateCounters(EventNumber::Alu);
+	}
+      else if (info.isMultiply())
+	pregs.updateCounters(EventNumber::Mult);
+      else if (info.isDivide())
+	pregs.updateCounters(EventNumber::Div);
+      else if (info.isLoad())
+	{
+	  pregs.updateCounters(EventNumber::Load);
+	  if (misalignedLdSt_)
+	    pregs.updateCounters(EventNumber::MisalignLoad);
+	}
+      else if (info.isStore())
+	{
+	  pregs.updateCounters(EventNumber::Store);
+	  if (misalignedLdSt_)
+	    pregs.updateCounters(EventNumber::MisalignStore);
+	}
+      else if (info.isCsr() and not csrException_)
+	{
+	  bool written = true;  // True if instruction wrote the CSR.
+	  if ((id == InstId::csrrw or id == InstId::csrrwi))
+	    {
+	      if (op0 == 0)
+		pregs.updateCounters(EventNumber::CsrWrite);
+	      else
+		pregs.updateCounters(EventNumber::CsrReadWrite);
+	    }
+	  else
+	    {
+	      written = op1 != 0;
+	      if (op1 == 0)
+		pregs.updateCounters(EventNumber::CsrRead);
+	      else
+		pregs.updateCounters(EventNumber::CsrReadWrite);
+	    }
+
+	  // Counter modified by csr instruction is not updated. The
+	  // written CSR is the one in the instruction: This does not
+	  // depend on CSR change records (which may be disabled).
+	  CsrNumber csr = CsrNumber(op2);
+	  unsigned counterIx = unsigned(csr) - unsigned(CsrNumber::MHPMCOUNTER3);
+	  if (csr >= CsrNumber::MHPMEVENT3 and csr <= CsrNumber::MHPMEVENT31)
+	    counterIx = unsigned(csr) - unsigned(CsrNumber::MHPMEVENT3);
+	  if (written and pregs.isModified(counterIx))
+	    {
+	      URV val;
+	      CsrNumber counterCsr = CsrNumber(counterIx + unsigned(CsrNumber::MHPMCOUNTER3));
+	      peekCsr(counterCsr, val);
+	      pokeCsr(counterCsr, val - 1);
+	    }
+	}
+      else if (info.isBranch())
+	{
+	  pregs.updateCounters(EventNumber::Branch);
+	  if (lastBranchTaken_)
+	    pregs.updateCounters(EventNumber::BranchTaken);
+	}
+
+      pregs.clearModified();
+    }
+
+  prevCountersCsrOn_ = countersCsrOn_;
 
   misalignedLdSt_ = false;
   lastBranchTaken_ = false;
@@ -2159,9 +2528,13 @@ Core<URV>::accumulateInstructionStats(uint32_t inst)
   bool hasImm = false;  // True if instruction has an immediate operand.
   int32_t imm = 0;     // Value of immediate operand.
 
+  // Integer operands of vector instructions (except vsetvl) are in
+  // the rs1 field.
+  bool vecOp0 = info.ithOperandType(0) == OperandType::VecReg;
+
   if (info.ithOperandType(1) == OperandType::IntReg)
     {
-      if (hasRd)
+      if (hasRd or vecOp0)
 	{
 	  rs1 = op1;
 	  entry.rs1_.at(rs1)++;
@@ -2188,6 +2561,12 @@ Core<URV>::accumulateInstructionStats(uint32_t inst)
 	  entry.rs2_.at(rs2)++;
 	  hasRs2 = true;
 	}
+      else if (vecOp0)
+	{
+	  rs1 = op2;
+	  entry.rs1_.at(rs1)++;
+	  hasRs1 = true;
+	}
       else
 	assert(0);
     }
@@ -2248,6 +2627,7 @@ Core<URV>::clearTraceData()
 {
   intRegs_.clearLastWrittenReg();
   fpRegs_.clearLastWrittenReg();
+  vecRegs_.clearLastWrittenReg();
   csRegs_.clearLastWrittenRegs();
   memory_.clearLastWriteInfo();
 }
@@ -2258,11 +2638,7 @@ inline
 void
 Core<URV>::setTargetProgramBreak(URV addr)
 {
-  progBreak_ = addr;
-
-  size_t pageAddr = memory_.getPageStartAddr(addr);
-  if (pageAddr != addr)
-    progBreak_ = pageAddr + memory_.pageSize();
+  syscall_.setProgramBreak(addr);
 }
 
 
@@ -2348,6 +2724,15 @@ Core<URV>::lastFpReg() const
 }
 
 
+template <typename URV>
+int
+Core<URV>::lastVecReg(unsigned& count) const
+{
+  count = vecRegs_.getLastWrittenCount();
+  return vecRegs_.getLastWrittenReg();
+}
+
+
 template <typename URV>
 void
 Core<URV>::lastCsr(std::vector<CsrNumber>& csrs,
@@ -2389,6 +2774,10 @@ template <typename URV>
 void
 handleExceptionForGdb(WdRiscv::Core<URV>& core);
 
+template <typename URV>
+bool
+serviceGdbRequest(WdRiscv::Core<URV>& core);
+
 
 // Return true if debug mode is entered and false otherwise.
 template <typename URV>
@@ -2426,6 +2815,36 @@ Core<URV>::takeTriggerAction(FILE* traceFile, URV pc, URV info,
 }
 
 
+template <typename URV>
+bool
+Core<URV>::stopAtBreakpoint(bool resuming)
+{
+  bool stopRequest = (gdbStopRequest_.exchange(false) and
+		      serviceGdbRequest(*this));
+  updateBreakCheck();
+  if (not stopRequest and not watchHit_ and
+      (resuming or not breakpoints_.contains(pc_)))
+    return false;
+
+  if (enableGdb_)
+    {
+      syncFpFlags();  // Gdb may access FCSR.
+      handleExceptionForGdb(*this);  // Returns when gdb continues.
+      return false;
+    }
+
+  URV addr = 0;
+  bool isLoad = false;
+  if (getWatchpointHit(addr, isLoad))
+    std::cerr << "Stopped -- " << (isLoad? "Load from" : "Store to")
+	      << " watched address 0x" << std::hex << addr << std::dec << '\n';
+  else
+    std::cerr << "Stopped -- Reached breakpoint at 0x" << std::hex << pc_
+	      << std::dec << '\n';
+  return true;
+}
+
+
 // This is set to false when user hits control-c to interrupt a long
 // run.
 volatile static bool userOk = true;
@@ -2452,17 +2871,30 @@ Core<URV>::untilAddress(URV address, FILE* traceFile)
   uint64_t counter = counter_;
   uint64_t limit = instCountLim_;
   bool success = true;
-  bool doStats = instFreq_ or enableCounters_;
+  bool doStats = instFreq_ or instMix_ or enableCounters_;
+  bool doBbv = bbv_.enabled();
+  bool doTiming = timing_.enabled();
+  bool doPredict = predictor_.enabled() and not doTiming;
 
   if (enableGdb_)
     handleExceptionForGdb(*this);
 
   uint32_t inst = 0;
+  bool resuming = true;  // Do not stop at a breakpoint at the start pc.
 
   while (pc_ != address and counter < limit and userOk)
     {
       inst = 0;
 
+      if (breakCheck_)
+	{
+	  counter_ = counter;
+	  if (stopAtBreakpoint(resuming))
+	    break;
+	  counter = counter_;
+	}
+      resuming = false;
+
       try
 	{
 	  currPc_ = pc_;
@@ -2474,6 +2906,21 @@ Core<URV>::untilAddress(URV address, FILE* traceFile)
 
 	  ++counter;
 
+	  // Take pending interrupt (if any) as singleStep does. Checked
+	  // only when the interrupt state may have changed.
+	  if (pendingEvent_)
+	    {
+	      pendingEvent_ = false;
+	      counter_ = counter;
+	      if (processExternalInterrupt(traceFile, instStr))
+		{
+		  cycleCount_++;
+		  if (trace)
+		    clearTraceData();
+		  continue;  // Next instruction in interrupt handler.
+		}
+	    }
+
 	  // Process pre-execute address trigger and fetch instruction.
 	  bool hasTrig = hasActiveInstTrigger();
 	  if (hasTrig and instAddrTriggerHit(currPc_, TriggerTiming::Before,
@@ -2535,6 +2982,12 @@ Core<URV>::untilAddress(URV address, FILE* traceFile)
 	  ++retiredInsts_;
 	  if (doStats)
 	    accumulateInstructionStats(inst);
+	  if (doBbv)
+	    accumulateBasicBlockVectors(inst);
+	  if (doTiming)
+	    accumulateTiming(inst);
+	  else if (doPredict)
+	    accumulateBranchPrediction(inst);
 
 	  bool icountHit = (enableTriggers_ and isInterruptEnabled() and
 			    icountTriggerHit());
@@ -2552,6 +3005,7 @@ Core<URV>::untilAddress(URV address, FILE* traceFile)
 	}
       catch (const CoreException& ce)
 	{
+	  console_.flush();  // Program output precedes stop message.
 	  if (ce.type() == CoreException::Stop)
 	    {
 	      if (trace)
@@ -2603,8 +3057,19 @@ Core<URV>::runUntilAddress(URV address, FILE* traceFile)
   userOk = true;
   sigaction(SIGINT, &newAction, &oldAction);
 
+  // CSR change records are only needed for tracing and triggers.
+  // Without those, floating point flags can be transferred lazily
+  // unless gdb may inspect FCSR at any instruction.
+  bool needChanges = traceFile or enableTriggers_;
+  bool prevRecord = csRegs_.isRecordWritesEnabled();
+  csRegs_.enableRecordWrites(needChanges);
+  enableLazyFpEnv(not needChanges and not enableGdb_);
+
   bool success = untilAddress(address, traceFile);
 
+  enableLazyFpEnv(false);
+  csRegs_.enableRecordWrites(prevRecord);
+
   sigaction(SIGINT, &oldAction, nullptr);
 
   if (counter_ == limit)
@@ -2619,6 +3084,7 @@ Core<URV>::runUntilAddress(URV address, FILE* traceFile)
 
   uint64_t numInsts = counter_ - counter0;
 
+  console_.flush();
   std::cout.flush();
   if (not userOk)
     std::cerr << "Keyboard interrupt\n";
@@ -2638,13 +3104,44 @@ bool
 Core<URV>::simpleRun()
 {
   bool success = true;
+  std::string instStr;
+  bool doStats = enableCounters_;
+  bool doBbv = bbv_.enabled();
+  bool doTiming = timing_.enabled();
+  bool doPredict = predictor_.enabled() and not doTiming;
+
+  uint64_t counter = counter_;
+  uint64_t limit = instCountLim_;
+
+  bool resuming = true;  // Do not stop at a breakpoint at the start pc.
 
   try
     {
-      while (userOk) 
+      while (userOk and counter < limit)
 	{
-	  // Fetch instruction
+	  if (breakCheck_)
+	    {
+	      counter_ = counter;
+	      if (stopAtBreakpoint(resuming))
+		break;
+	    }
+	  resuming = false;
+
 	  currPc_ = pc_;
+	  ++counter;
+
+	  // Take pending interrupt (if any).
+	  if (pendingEvent_)
+	    {
+	      pendingEvent_ = false;
+	      if (processExternalInterrupt(nullptr, instStr))
+		{
+		  ++cycleCount_;
+		  continue;  // Next instruction in interrupt handler.
+		}
+	    }
+
+	  // Fetch instruction
 	  ++cycleCount_;
 	  ldStException_ = false;
 
@@ -2665,11 +3162,22 @@ Core<URV>::simpleRun()
 	    }
 
 	  if (not ldStException_)
-	    ++retiredInsts_;
+	    {
+	      ++retiredInsts_;
+	      if (doStats)
+		accumulateInstructionStats(inst);
+	      if (doBbv)
+		accumulateBasicBlockVectors(inst);
+	      if (doTiming)
+		accumulateTiming(inst);
+	      else if (doPredict)
+		accumulateBranchPrediction(inst);
+	    }
 	}
     }
   catch (const CoreException& ce)
     {
+      console_.flush();  // Program output precedes stop message.
       if (ce.type() == CoreException::Stop)
 	{
 	  success = ce.value() == 1; // Anything besides 1 is a fail.
@@ -2690,6 +3198,8 @@ Core<URV>::simpleRun()
 	}
     }
 
+  counter_ = counter;
+
   return success;
 }
 
@@ -2700,6 +3210,9 @@ template <typename URV>
 bool
 Core<URV>::run(FILE* file)
 {
+  if (hasWindow_)
+    return runTraceWindow(file);
+
   // If test has toHost defined then use that as the stopping criteria
   // and ignore the stop address. Not having to check for the stop
   // address gives us about an 10 percent boost in speed.
@@ -2709,8 +3222,8 @@ Core<URV>::run(FILE* file)
   // To run fast, this method does not do much besides straight-forward
   // execution. If any option is turned on, we switch to
   // runUntilAdress which runs slower but is full-featured.
-  if (file or instCountLim_ < ~uint64_t(0) or instFreq_ or enableTriggers_ or
-      enableCounters_ or enableGdb_)
+  if (file or instCountLim_ < ~uint64_t(0) or instFreq_ or instMix_ or
+      enableTriggers_)
     {
       URV address = ~URV(0);  // Invalid stop PC.
       return runUntilAddress(address, file);
@@ -2727,8 +3240,21 @@ Core<URV>::run(FILE* file)
   userOk = true;
   sigaction(SIGINT, &newAction, &oldAction);
 
+  // No tracing or triggers: CSR change records not needed and
+  // floating point flags can be transferred lazily (but not in gdb
+  // mode where the debugger may inspect FCSR at any instruction).
+  bool prevRecord = csRegs_.isRecordWritesEnabled();
+  csRegs_.enableRecordWrites(false);
+  enableLazyFpEnv(not enableGdb_);
+
+  if (enableGdb_)
+    handleExceptionForGdb(*this);
+
   bool success = simpleRun();
 
+  enableLazyFpEnv(false);
+  csRegs_.enableRecordWrites(prevRecord);
+
   sigaction(SIGINT, &oldAction, nullptr);
 
   // Simulator stats.
@@ -2736,6 +3262,7 @@ Core<URV>::run(FILE* file)
   gettimeofday(&t1, nullptr);
   double elapsed = (t1.tv_sec - t0.tv_sec) + (t1.tv_usec - t0.tv_usec)*1e-6;
 
+  console_.flush();
   std::cout.flush();
   if (not userOk)
     std::cerr << "Keyboard interrupt\n";
@@ -2752,30 +3279,165 @@ Core<URV>::run(FILE* file)
 
 template <typename URV>
 bool
-Core<URV>::isInterruptPossible(InterruptCause& cause)
+Core<URV>::fastForward(uint64_t limit)
+{
+  bool triggers = enableTriggers_, counters = enableCounters_;
+  bool freq = instFreq_, mix = instMix_, timing = timing_.enabled();
+  bool icache = icache_.enabled(), dcache = dcache_.enabled();
+  bool predictor = predictor_.enabled(), memTrace = memTrace_.enabled();
+  bool pageProfile = pageProfile_.enabled();
+  enableTriggers_ = enableCounters_ = instFreq_ = instMix_ = false;
+  timing_.enable(false);
+  predictor_.enable(false);
+  memTrace_.enable(false);
+  pageProfile_.enable(false);
+  icache_.enable(false);
+  dcache_.enable(false);
+
+  uint64_t prevLimit = instCountLim_;
+  instCountLim_ = limit;
+
+  // No tracing or triggers: CSR change records not needed and
+  // floating point flags can be transferred lazily (but not in gdb
+  // mode where the debugger may inspect FCSR at any instruction).
+  bool prevRecord = csRegs_.isRecordWritesEnabled();
+  csRegs_.enableRecordWrites(false);
+  enableLazyFpEnv(not enableGdb_);
+
+  bool success = true;
+  if (stopAddrValid_ and not toHostValid_)
+    success = untilAddress(stopAddr_, nullptr);
+  else
+    success = simpleRun();
+
+  enableLazyFpEnv(false);
+  csRegs_.enableRecordWrites(prevRecord);
+
+  instCountLim_ = prevLimit;
+  enableTriggers_ = triggers;
+  enableCounters_ = counters;
+  instFreq_ = freq;
+  instMix_ = mix;
+  timing_.enable(timing);
+  icache_.enable(icache);
+  dcache_.enable(dcache);
+  predictor_.enable(predictor);
+  memTrace_.enable(memTrace);
+  pageProfile_.enable(pageProfile);
+
+  return success;
+}
+
+
+template <typename URV>
+bool
+Core<URV>::runTraceWindow(FILE* traceFile)
 {
-  if (debugMode_ and not debugStepMode_)
-    return false;
+  struct timeval t0;
+  gettimeofday(&t0, nullptr);
 
-  URV mstatus;
-  if (not csRegs_.read(CsrNumber::MSTATUS, PrivilegeMode::Machine,
-		       debugMode_, mstatus))
-    return false;
+  uint64_t limit = instCountLim_;
+  uint64_t counter0 = counter_;
 
-  MstatusFields<URV> fields(mstatus);
-  if (not fields.bits_.MIE)
-    return false;
+  // As in run: The tohost address has precedence over the stop address.
+  URV address = ~URV(0);  // Invalid stop PC.
+  if (stopAddrValid_ and not toHostValid_)
+    address = stopAddr_;
 
-  URV mip, mie;
-  if (csRegs_.read(CsrNumber::MIP, PrivilegeMode::Machine, debugMode_, mip)
-      and
-      csRegs_.read(CsrNumber::MIE, PrivilegeMode::Machine, debugMode_, mie))
-    {
-      if ((mie & mip) == 0)
-	return false;  // Nothing enabled is pending.
+  struct sigaction oldAction;
+  struct sigaction newAction;
+  memset(&newAction, 0, sizeof(newAction));
+  newAction.sa_handler = keyboardInterruptHandler;
 
-      // Order of priority: machine, supervisor, user and then
-      // external, software, timer and internal timers.
+  userOk = true;
+  sigaction(SIGINT, &newAction, &oldAction);
+
+  // Each phase proceeds only if the previous one ran to its end.
+  bool success = true;
+  bool proceed = true;
+
+  uint64_t begin = std::min(windowBegin_, limit);
+  if (counter_ < begin)
+    {
+      success = fastForward(begin);
+      proceed = counter_ == begin and not hasTargetProgramFinished();
+    }
+
+  uint64_t end = std::min(windowEnd_, limit);
+  if (proceed and counter_ < end)
+    {
+      bool needChanges = traceFile or enableTriggers_;
+      bool prevRecord = csRegs_.isRecordWritesEnabled();
+      csRegs_.enableRecordWrites(needChanges);
+      enableLazyFpEnv(not needChanges and not enableGdb_);
+
+      instCountLim_ = end;
+      success = untilAddress(address, traceFile);
+      instCountLim_ = limit;
+
+      enableLazyFpEnv(false);
+      csRegs_.enableRecordWrites(prevRecord);
+      proceed = counter_ == end and not hasTargetProgramFinished();
+    }
+
+  if (proceed and counter_ < limit)
+    success = fastForward(limit);
+
+  sigaction(SIGINT, &oldAction, nullptr);
+
+  if (counter_ == limit)
+    std::cerr << "Stopped -- Reached instruction limit\n";
+  else if (pc_ == address)
+    std::cerr << "Stopped -- Reached end address\n";
+
+  // Simulator stats.
+  struct timeval t1;
+  gettimeofday(&t1, nullptr);
+  double elapsed = (t1.tv_sec - t0.tv_sec) + (t1.tv_usec - t0.tv_usec)*1e-6;
+
+  uint64_t numInsts = counter_ - counter0;
+
+  console_.flush();
+  std::cout.flush();
+  if (not userOk)
+    std::cerr << "Keyboard interrupt\n";
+  std::cerr << "Retired " << numInsts << " instruction"
+	    << (numInsts > 1? "s" : "") << " in "
+	    << (boost::format("%.2fs") % elapsed);
+  if (elapsed > 0)
+    std::cerr << "  " << size_t(numInsts/elapsed) << " inst/s";
+  std::cerr << '\n';
+
+  return success;
+}
+
+
+template <typename URV>
+bool
+Core<URV>::isInterruptPossible(InterruptCause& cause)
+{
+  if (debugMode_ and not debugStepMode_)
+    return false;
+
+  URV mstatus;
+  if (not csRegs_.read(CsrNumber::MSTATUS, PrivilegeMode::Machine,
+		       debugMode_, mstatus))
+    return false;
+
+  MstatusFields<URV> fields(mstatus);
+  if (not fields.bits_.MIE)
+    return false;
+
+  URV mip, mie;
+  if (csRegs_.read(CsrNumber::MIP, PrivilegeMode::Machine, debugMode_, mip)
+      and
+      csRegs_.read(CsrNumber::MIE, PrivilegeMode::Machine, debugMode_, mie))
+    {
+      if ((mie & mip) == 0)
+	return false;  // Nothing enabled is pending.
+
+      // Order of priority: machine, supervisor, user and then
+      // external, software, timer and internal timers.
       if (mie & (1 << unsigned(InterruptCause::M_EXTERNAL)) & mip)
 	{
 	  cause = InterruptCause::M_EXTERNAL;
@@ -2876,7 +3538,10 @@ Core<URV>::singleStep(FILE* traceFile)
 
   // Single step is mostly used for follow-me mode where we want to
   // know the changes after the execution of each instruction.
-  bool doStats = instFreq_ or enableCounters_;
+  bool doStats = instFreq_ or instMix_ or enableCounters_;
+  bool doBbv = bbv_.enabled();
+  bool doTiming = timing_.enabled();
+  bool doPredict = predictor_.enabled() and not doTiming;
 
   try
     {
@@ -2967,6 +3632,12 @@ Core<URV>::singleStep(FILE* traceFile)
 
       if (doStats)
 	accumulateInstructionStats(inst);
+      if (doBbv)
+	accumulateBasicBlockVectors(inst);
+      if (doTiming)
+	accumulateTiming(inst);
+      else if (doPredict)
+	accumulateBranchPrediction(inst);
 
       if (traceFile)
 	printInstTrace(inst, counter_, instStr, traceFile);
@@ -3008,6 +3679,7 @@ Core<URV>::singleStep(FILE* traceFile)
     }
   catch (const CoreException& ce)
     {
+      console_.flush();  // Program output precedes stop message.
       uint32_t inst = 0;
       readInst(currPc_, inst);
       if (ce.type() == CoreException::Stop)
@@ -3169,706 +3841,168 @@ Core<URV>::collectAndUndoWhatIfChanges(URV prevPc, ChangeRecord& record)
 
 template <typename URV>
 void
-Core<URV>::executeFp(uint32_t inst)
+Core<URV>::execute32(uint32_t inst)
 {
-  RFormInst rform(inst);
-  unsigned rd = rform.bits.rd, rs1 = rform.bits.rs1, rs2 = rform.bits.rs2;
-  unsigned f7 = rform.bits.funct7, f3 = rform.bits.funct3;
-  instRoundingMode_ = RoundingMode(f3);
+  const Decoded32& entry = decode32(inst);
 
-  if (f7 & 1)
+  // Fields that are not operands: rounding mode and third source of
+  // floating point instructions, ordering bits of atomics, mask bit
+  // of vector instructions.
+  if (entry.hasFields)
     {
-      if      (f7 == 1)                   execFadd_d(rd, rs1, rs2);
-      else if (f7 == 5)                   execFsub_d(rd, rs1, rs2);
-      else if (f7 == 9)                   execFmul_d(rd, rs1, rs2);
-      else if (f7 == 0xd)                 execFdiv_d(rd, rs1, rs2);
-      else if (f7 == 0x11)
-	{
-	  if      (f3 == 0)               execFsgnj_d(rd, rs1, rs2);
-	  else if (f3 == 1)               execFsgnjn_d(rd, rs1, rs2);
-	  else if (f3 == 2)               execFsgnjx_d(rd, rs1, rs2);
-	  else                            illegalInst();
-	}
-      else if (f7 == 0x15)
-	{
-	  if      (f3 == 0)               execFmin_d(rd, rs1, rs2);
-	  else if (f3 == 1)               execFmax_d(rd, rs1, rs2);
-	  else                            illegalInst();
-	}
-      else if (f7 == 0x21 and rs2 == 0)   execFcvt_d_s(rd, rs1, rs2);
-      else if (f7 == 0x2d)                execFsqrt_d(rd, rs1, rs2);
-      else if (f7 == 0x51)
-	{
-	  if      (f3 == 0)               execFle_d(rd, rs1, rs2);
-	  else if (f3 == 1)               execFlt_d(rd, rs1, rs2);
-	  else if (f3 == 2)               execFeq_d(rd, rs1, rs2);
-	  else                            illegalInst();
-	}
-      else if (f7 == 0x61)
-	{
-	  if      (rs2 == 0)              execFcvt_w_d(rd, rs1, rs2);
-	  else if (rs2 == 1)              execFcvt_wu_d(rd, rs1, rs2);
-	  else                            illegalInst();
-	}
-      else if (f7 == 0x69)
-	{
-	  if      (rs2 == 0)              execFcvt_d_w(rd, rs1, rs2);
-	  else if (rs2 == 1)              execFcvt_d_wu(rd, rs1, rs2);
-	  else                            illegalInst();
-	}
-      else if (f7 == 0x71)
-	{
-	  if (rs2 == 0 and f3 == 0)       execFmv_x_d(rd, rs1, rs2);
-	  if (rs2 == 0 and f3 == 1)       execFclass_d(rd, rs1, rs2);
-	  else                            illegalInst();
-	}
-      else
-	illegalInst();
-      return;
+      instRoundingMode_ = RoundingMode((inst >> 12) & 7);
+      instRs3_ = inst >> 27;
+      amoAq_ = (inst >> 26) & 1;
+      amoRl_ = (inst >> 25) & 1;
+      vecMasked_ = not ((inst >> 25) & 1);
     }
 
-  if (f7 == 0)                        execFadd_s(rd, rs1, rs2);
-  else if (f7 == 4)                   execFsub_s(rd, rs1, rs2);
-  else if (f7 == 8)                   execFmul_s(rd, rs1, rs2);
-  else if (f7 == 0xc)                 execFdiv_s(rd, rs1, rs2);
-  else if (f7 == 0x10)
-    {
-      if      (f3 == 0)               execFsgnj_s(rd, rs1, rs2);
-      else if (f3 == 1)               execFsgnjn_s(rd, rs1, rs2);
-      else if (f3 == 2)               execFsgnjx_s(rd, rs1, rs2);
-      else                            illegalInst();
-    }
-  else if (f7 == 0x14)
-    {
-      if      (f3 == 0)               execFmin_s(rd, rs1, rs2);
-      else if (f3 == 1)               execFmax_s(rd, rs1, rs2);
-      else                            illegalInst();
-    }
-  else if (f7 == 0x20 and rs2 == 1)   execFcvt_s_d(rd, rs1, rs2);
-  else if (f7 == 0x2c)                execFsqrt_s(rd, rs1, rs2);
-  else if (f7 == 0x50)
-    {
-      if      (f3 == 0)               execFle_s(rd, rs1, rs2);
-      else if (f3 == 1)               execFlt_s(rd, rs1, rs2);
-      else if (f3 == 2)               execFeq_s(rd, rs1, rs2);
-      else                            illegalInst();
-    }
-  else if (f7 == 0x60)
-    {
-      if      (rs2 == 0)              execFcvt_w_s(rd, rs1, rs2);
-      else if (rs2 == 1)              execFcvt_wu_s(rd, rs1, rs2);
-      else if (rs2 == 2)              execFcvt_l_s(rd, rs1, rs2);
-      else if (rs2 == 3)              execFcvt_lu_s(rd, rs1, rs2);      
-      else                            illegalInst();
-    }
-  else if (f7 == 0x68)
-    {
-      if      (rs2 == 0)              execFcvt_s_w(rd, rs1, rs2);
-      else if (rs2 == 1)              execFcvt_s_wu(rd, rs1, rs2);
-      else if (rs2 == 2)              execFcvt_s_l(rd, rs1, rs2);
-      else if (rs2 == 3)              execFcvt_s_lu(rd, rs1, rs2);      
-      else                            illegalInst();
-    }
-  else if (f7 == 0x70)
-    {
-      if      (rs2 == 0 and f3 == 0)  execFmv_x_w(rd, rs1, rs2);
-      else if (rs2 == 0 and f3 == 1)  execFclass_s(rd, rs1, rs2);
-      else                            illegalInst();
-    }
-  else if (f7 == 0x78)
-    {
-      if (rs2 == 0 and f3 == 0)       execFmv_w_x(rd, rs1, rs2);
-      else                            illegalInst();
-    }
-  else
-    illegalInst();
+  ExecFunc func = execTable_[entry.id];
+  (this->*func)(entry.op0, entry.op1, entry.op2);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execute32(uint32_t inst)
+Core<URV>::fillDecodeCache(Decoded32& entry, uint32_t inst)
 {
-#pragma GCC diagnostic ignored "-Wpedantic"
-  
-  static void *opcodeLabels[] = { &&l0, &&l1, &&l2, &&l3, &&l4, &&l5,
-				  &&l6, &&l7, &&l8, &&l9, &&l10, &&l11,
-				  &&l12, &&l13, &&l14, &&l15, &&l16, &&l17,
-				  &&l18, &&l19, &&l20, &&l21, &&l22, &&l23,
-				  &&l24, &&l25, &&l26, &&l27, &&l28, &&l29,
-				  &&l30, &&l31 };
-
-  // Decode and execute.
-  unsigned opcode = (inst & 0x7f) >> 2;  // Upper 5 bits of opcode.
-  goto *opcodeLabels[opcode];
+  uint32_t op0 = 0, op1 = 0;
+  int32_t op2 = 0;
+  const InstInfo& info = instTable_.decode(inst, op0, op1, op2);
 
- l0:  // 00000   I-form
-  {
-    IFormInst iform(inst);
-    unsigned rd = iform.fields.rd, rs1 = iform.fields.rs1;
-    int32_t imm = iform.immed();
-    uint32_t f3 = iform.fields.funct3;
-    if      (f3 == 0) execLb(rd, rs1, imm);
-    else if (f3 == 1) execLh(rd, rs1, imm);
-    else if (f3 == 2) execLw(rd, rs1, imm);
-    else if (f3 == 3) execLd(rd, rs1, imm);
-    else if (f3 == 4) execLbu(rd, rs1, imm);
-    else if (f3 == 5) execLhu(rd, rs1, imm);
-    else if (f3 == 6) execLwu(rd, rs1, imm);
-    else              illegalInst();
-  }
-  return;
+  entry.code = inst;
+  entry.id = uint16_t(info.instId());
+  entry.op0 = uint8_t(op0);
+  entry.op1 = op1;
+  entry.op2 = op2;
+  entry.hasFields = (info.type() == InstType::Fp or info.isVector() or
+		     (inst & 0x7f) == 0x2f);
 
- l1:
-  {
-    IFormInst iform(inst);
-    unsigned rd = iform.fields.rd, rs1 = iform.fields.rs1;
-    int32_t imm = iform.immed();
-    uint32_t f3 = iform.fields.funct3;
-    if      (f3 == 2)   { execFlw(rd, rs1, imm); }
-    else if (f3 == 3)   { execFld(rd, rs1, imm); }
-    else                { illegalInst(); }
-  }
-  return;
+  // Shift amounts of 32 and larger are reserved in rv32.
+  InstId id = info.instId();
+  if (not rv64_ and (op2 & 0x20) and
+      (id == InstId::slli or id == InstId::srli or id == InstId::srai))
+    entry.id = uint16_t(InstId::illegal);
+}
 
- l2:
- l7:
-  illegalInst();
-  return;
 
- l9:
-  {
-    SFormInst sform(inst);
-    unsigned rs1 = sform.bits.rs1, rs2 = sform.bits.rs2;
-    unsigned funct3 = sform.bits.funct3;
-    int32_t imm = sform.immed();
-    if      (funct3 == 2)  execFsw(rs1, rs2, imm);
-    else if (funct3 == 3)  execFsd(rs1, rs2, imm);
-    else                   illegalInst();
-  }
-  return;
 
- l10:
- l15:
-  illegalInst();
-  return;
+template <typename URV>
+void
+Core<URV>::execute16(uint16_t inst)
+{
+  const Compressed16& entry = compressedTable_[inst];
+  ExecFunc func = execTable_[entry.id];
+  (this->*func)(entry.op0, entry.op1, entry.op2);
+}
 
- l16:
-  {
-    RFormInst rform(inst);
-    unsigned rd = rform.bits.rd, rs1 = rform.bits.rs1, rs2 = rform.bits.rs2;
-    unsigned funct7 = rform.bits.funct7, funct3 = rform.bits.funct3;
-    instRoundingMode_ = RoundingMode(funct3);
-    if ((funct7 & 3) == 0)
-      {
-	instRs3_ = funct7 >> 2;
-	execFmadd_s(rd, rs1, rs2);
-      }
-    else if ((funct7 & 3) == 1)
-      {
-	instRs3_ = funct7 >> 2;
-	execFmadd_d(rd, rs1, rs2);
-      }
-    else
-      illegalInst();
-  }
-  return;
 
- l17:
-  {
-    RFormInst rform(inst);
-    unsigned rd = rform.bits.rd, rs1 = rform.bits.rs1, rs2 = rform.bits.rs2;
-    unsigned funct7 = rform.bits.funct7, funct3 = rform.bits.funct3;
-    instRoundingMode_ = RoundingMode(funct3);
-    if ((funct7 & 3) == 0)
-      {
-	instRs3_ = funct7 >> 2;
-	execFmsub_s(rd, rs1, rs2);
-      }
-    else if ((funct7 & 3) == 0)
-      {
-	instRs3_ = funct7 >> 2;
-	execFmsub_d(rd, rs1, rs2);
-      }
-    else
-      illegalInst();
-  }
-  return;
+template <typename URV>
+void
+Core<URV>::disassembleInst(uint32_t inst, std::ostream& stream)
+{
+  // Decode and disassemble
+  if ((inst & 0x3) == 0x3) 
+    disassembleInst32(inst, stream);
+  else
+    disassembleInst16(inst, stream);
+}
 
- l18:
-  {
-    RFormInst rform(inst);
-    unsigned rd = rform.bits.rd, rs1 = rform.bits.rs1, rs2 = rform.bits.rs2;
-    unsigned funct7 = rform.bits.funct7, funct3 = rform.bits.funct3;
-    instRoundingMode_ = RoundingMode(funct3);
-    if ((funct7 & 3) == 0)
-      {
-	instRs3_ = funct7 >> 2;
-	execFnmsub_s(rd, rs1, rs2);
-      }
-    else if ((funct7 & 3) == 1)
-      {
-	instRs3_ = funct7 >> 2;
-	execFnmsub_d(rd, rs1, rs2);
-      }
-    else
-      illegalInst();
-  }
-  return;
 
- l19:
-  {
-    RFormInst rform(inst);
-    unsigned rd = rform.bits.rd, rs1 = rform.bits.rs1, rs2 = rform.bits.rs2;
-    unsigned funct7 = rform.bits.funct7, funct3 = rform.bits.funct3;
-    instRoundingMode_ = RoundingMode(funct3);
-    if ((funct7 & 3) == 0)
-      {
-	instRs3_ = funct7 >> 2;
-	execFnmadd_s(rd, rs1, rs2);
-      }
-    else if ((funct7 & 3) == 1)
-      {
-	instRs3_ = funct7 >> 2;
-	execFnmadd_d(rd, rs1, rs2);
-      }
-    else
-      illegalInst();
-  }
-  return;
-
- l20:
-  executeFp(inst);
-  return;
-
- l21:
- l22:
- l23:
- l26:
- l29:
- l30:
- l31:
-  illegalInst();
-  return;
+template <typename URV>
+void
+Core<URV>::disassembleInst(uint32_t inst, std::string& str)
+{
+  str.clear();
 
- l3: // 00011  I-form
-  {
-    IFormInst iform(inst);
-    unsigned rd = iform.fields.rd, rs1 = iform.fields.rs1;
-    unsigned funct3 = iform.fields.funct3;
-    if (rd != 0 or rs1 != 0)
-      illegalInst();
-    else if (funct3 == 0)
-      {
-	if (iform.top4() != 0)
-	  illegalInst();
-	else
-	  execFence(iform.pred(), iform.succ());
-      }
-    else if (funct3 == 1)
-      {
-	if (iform.uimmed() != 0)
-	  illegalInst();
-	else
-	  execFencei();
-      }
-    else
-      illegalInst();
-  }
-  return;
+  std::ostringstream oss;
+  disassembleInst(inst, oss);
+  str = oss.str();
+}
 
- l4:  // 00100  I-form
-  {
-    IFormInst iform(inst);
-    unsigned rd = iform.fields.rd, rs1 = iform.fields.rs1;
-    int32_t imm = iform.immed();
-    unsigned funct3 = iform.fields.funct3;
 
-    if      (funct3 == 0)  execAddi(rd, rs1, imm);
-    else if (funct3 == 1)
-      {
-	unsigned topBits = 0, shamt = 0;
-	iform.getShiftFields(isRv64(), topBits, shamt);
-	if (topBits == 0)
-	  execSlli(rd, rs1, shamt);
-	else
-	  illegalInst();
-      }
-    else if (funct3 == 2)  execSlti(rd, rs1, imm);
-    else if (funct3 == 3)  execSltiu(rd, rs1, imm);
-    else if (funct3 == 4)  execXori(rd, rs1, imm);
-    else if (funct3 == 5)
-      {
-	unsigned topBits = 0, shamt = 0;
-	iform.getShiftFields(isRv64(), topBits, shamt);
-	if (topBits == 0)
-	  execSrli(rd, rs1, shamt);
-	else
-	  {
-	    if (isRv64())
-	      topBits <<= 1;
-	    if (topBits == 0x20)
-	      execSrai(rd, rs1, shamt);
-	    else
-	      illegalInst();
-	  }
-      }
-    else if (funct3 == 6)  execOri(rd, rs1, imm);
-    else if (funct3 == 7)  execAndi(rd, rs1, imm);
-    else                   illegalInst();
-  }
-  return;
+template <typename URV>
+bool
+Core<URV>::expandCompressed(uint16_t inst, uint32_t& code32) const
+{
+  code32 = 0; // Start with an illegal instruction.
 
- l5:  // 00101   U-form
-  {
-    UFormInst uform(inst);
-    execAuipc(uform.bits.rd, uform.immed());
-  }
-  return;
+  uint16_t quadrant = inst & 0x3;
+  uint16_t funct3 =  inst >> 13;    // Bits 15 14 and 13
 
- l6:  // 00110  I-form
-  {
-    IFormInst iform(inst);
-    unsigned rd = iform.fields.rd, rs1 = iform.fields.rs1;
-    int32_t imm = iform.immed();
-    unsigned funct3 = iform.fields.funct3;
-    if (funct3 == 0)
-      execAddiw(rd, rs1, imm);
-    else if (funct3 == 1)
-      {
-	if (iform.top7() != 0)
-	  illegalInst();
-	else
-	  execSlliw(rd, rs1, iform.fields2.shamt);
-      }
-    else if (funct3 == 5)
-      {
-	if (iform.top7() == 0)
-	  execSrliw(rd, rs1, iform.fields2.shamt);
-	else if (iform.top7() == 0x20)
-	  execSraiw(rd, rs1, iform.fields2.shamt);
-	else
-	  illegalInst();
-      }
-    else
-      illegalInst();
-  }
-  return;
+  if (quadrant == 0)
+    {
+      if (funct3 == 0)    // illegal, c.addi4spn
+	{
+	  if (inst == 0)
+	    return false;
+	  CiwFormInst ciwf(inst);
+	  unsigned immed = ciwf.immed();
+	  if (immed == 0)
+	    return false;
+	  return encodeAddi(8+ciwf.bits.rdp, RegSp, immed, code32);
+	}
 
- l8:  // 01000  S-form
-  {
-    SFormInst sform(inst);
-    unsigned rs1 = sform.bits.rs1, rs2 = sform.bits.rs2;
-    unsigned funct3 = sform.bits.funct3;
-    int32_t imm = sform.immed();
-    if      (funct3 == 2)  execSw(rs1, rs2, imm);
-    else if (funct3 == 0)  execSb(rs1, rs2, imm);
-    else if (funct3 == 1)  execSh(rs1, rs2, imm);
-    else if (funct3 == 3)  execSd(rs1, rs2, imm);
-    else                   illegalInst();
-  }
-  return;
+      if (funct3 == 1) // c.fld c.lq
+	{
+	  if (not isRvd())
+	    return false;
+	  ClFormInst clf(inst);
+	  return encodeFld(8+clf.bits.rdp, 8+clf.bits.rs1p, clf.ldImmed(),
+			  code32);
+	}
 
- l11:  // 01011  R-form atomics
-  {
-    if (not isRva())
-      {
-	illegalInst();
-	return;
-      }
+      if (funct3 == 2) // c.lw
+	{
+	  ClFormInst clf(inst);
+	  return encodeLw(8+clf.bits.rdp, 8+clf.bits.rs1p, clf.lwImmed(),
+			  code32);
+	}
 
-    RFormInst rf(inst);
-    uint32_t top5 = rf.top5(), f3 = rf.bits.funct3;
-    uint32_t rd = rf.bits.rd, rs1 = rf.bits.rs1, rs2 = rf.bits.rs2;
-    amoRl_ = rf.rl(); amoAq_ = rf.aq();
-    if (f3 == 2)
-      {
-	if      (top5 == 0)     execAmoadd_w(rd, rs1, rs2);
-	else if (top5 == 1)     execAmoswap_w(rd, rs1, rs2);
-	else if (top5 == 2)     execLr_w(rd, rs1, rs2);
-	else if (top5 == 3)     execSc_w(rd, rs1, rs2);
-	else if (top5 == 4)     execAmoxor_w(rd, rs1, rs2);
-	else if (top5 == 8)     execAmoor_w(rd, rs1, rs2);
-	else if (top5 == 0x10)  execAmomin_w(rd, rs1, rs2);
-	else if (top5 == 0x14)  execAmomax_w(rd, rs1, rs2);
-	else if (top5 == 0x18)  execAmominu_w(rd, rs1, rs2);
-	else if (top5 == 0x1c)  execAmomaxu_w(rd, rs1, rs2);
-	else                    illegalInst();
-      }
-    else if (f3 == 3)
-      {
-	if      (not isRv64())  illegalInst();
-	else if (top5 == 0)     execAmoadd_d(rd, rs1, rs2);
-	else if (top5 == 1)     execAmoswap_d(rd, rs1, rs2);
-	else if (top5 == 2)     execLr_d(rd, rs1, rs2);
-	else if (top5 == 3)     execSc_d(rd, rs1, rs2);
-	else if (top5 == 4)     execAmoxor_d(rd, rs1, rs2);
-	else if (top5 == 8)     execAmoor_d(rd, rs1, rs2);
-	else if (top5 == 0x10)  execAmomin_d(rd, rs1, rs2);
-	else if (top5 == 0x14)  execAmomax_d(rd, rs1, rs2);
-	else if (top5 == 0x18)  execAmominu_d(rd, rs1, rs2);
-	else if (top5 == 0x1c)  execAmomaxu_d(rd, rs1, rs2);
-	else                    illegalInst();
-      }
-    else illegalInst();
-  }
-  return;
-
- l12:  // 01100  R-form
-  {
-    RFormInst rform(inst);
-    unsigned rd = rform.bits.rd, rs1 = rform.bits.rs1, rs2 = rform.bits.rs2;
-    unsigned funct7 = rform.bits.funct7, funct3 = rform.bits.funct3;
-    if (funct7 == 0)
-      {
-	if      (funct3 == 0) execAdd(rd, rs1, rs2);
-	else if (funct3 == 1) execSll(rd, rs1, rs2);
-	else if (funct3 == 2) execSlt(rd, rs1, rs2);
-	else if (funct3 == 3) execSltu(rd, rs1, rs2);
-	else if (funct3 == 4) execXor(rd, rs1, rs2);
-	else if (funct3 == 5) execSrl(rd, rs1, rs2);
-	else if (funct3 == 6) execOr(rd, rs1, rs2);
-	else if (funct3 == 7) execAnd(rd, rs1, rs2);
-      }
-    else if (funct7 == 1)
-      {
-	if      (not isRvm()) illegalInst();
-	else if (funct3 == 0) execMul(rd, rs1, rs2);
-	else if (funct3 == 1) execMulh(rd, rs1, rs2);
-	else if (funct3 == 2) execMulhsu(rd, rs1, rs2);
-	else if (funct3 == 3) execMulhu(rd, rs1, rs2);
-	else if (funct3 == 4) execDiv(rd, rs1, rs2);
-	else if (funct3 == 5) execDivu(rd, rs1, rs2);
-	else if (funct3 == 6) execRem(rd, rs1, rs2);
-	else if (funct3 == 7) execRemu(rd, rs1, rs2);
-      }
-    else if (funct7 == 0x20)
-      {
-	if      (funct3 == 0) execSub(rd, rs1, rs2);
-	else if (funct3 == 5) execSra(rd, rs1, rs2);
-	else                  illegalInst();
-      }
-    else
-      illegalInst();
-  }
-  return;
-
- l13:  // 01101  U-form
-  {
-    UFormInst uform(inst);
-    execLui(uform.bits.rd, uform.immed());
-  }
-  return;
-
- l14: // 01110  R-Form
-  {
-    const RFormInst rform(inst);
-    unsigned rd = rform.bits.rd, rs1 = rform.bits.rs1, rs2 = rform.bits.rs2;
-    unsigned funct7 = rform.bits.funct7, funct3 = rform.bits.funct3;
-    if (funct7 == 0)
-      {
-	if      (funct3 == 0)  execAddw(rd, rs1, rs2);
-	else if (funct3 == 1)  execSllw(rd, rs1, rs2);
-	else if (funct3 == 5)  execSrlw(rd, rs1, rs2);
-	else                   illegalInst();
-      }
-    else if (funct7 == 1)
-      {
-	if      (funct3 == 0)  execMulw(rd, rs1, rs2);
-	else if (funct3 == 4)  execDivw(rd, rs1, rs2);
-	else if (funct3 == 5)  execDivuw(rd, rs1, rs2);
-	else if (funct3 == 6)  execRemw(rd, rs1, rs2);
-	else if (funct3 == 7)  execRemuw(rd, rs1, rs2);
-	else                   illegalInst();
-      }
-    else if (funct7 == 0x20)
-      {
-	if      (funct3 == 0)  execSubw(rd, rs1, rs2);
-	else if (funct3 == 5)  execSraw(rd, rs1, rs2);
-	else                   illegalInst();
-      }
-    else
-      illegalInst();
-  }
-  return;
-
- l24: // 11000   B-form
-  {
-    BFormInst bform(inst);
-    unsigned rs1 = bform.bits.rs1, rs2 = bform.bits.rs2;
-    unsigned funct3 = bform.bits.funct3;
-    int32_t imm = bform.immed();
-    if      (funct3 == 0)  execBeq(rs1, rs2, imm);
-    else if (funct3 == 1)  execBne(rs1, rs2, imm);
-    else if (funct3 == 4)  execBlt(rs1, rs2, imm);
-    else if (funct3 == 5)  execBge(rs1, rs2, imm);
-    else if (funct3 == 6)  execBltu(rs1, rs2, imm);
-    else if (funct3 == 7)  execBgeu(rs1, rs2, imm);
-    else                   illegalInst();
-  }
-  return;
-
- l25:  // 11001  I-form
-  {
-    IFormInst iform(inst);
-    if (iform.fields.funct3 == 0)
-      execJalr(iform.fields.rd, iform.fields.rs1, iform.immed());
-    else
-      illegalInst();
-  }
-  return;
-
- l27:  // 11011  J-form
-  {
-    JFormInst jform(inst);
-    execJal(jform.bits.rd, jform.immed());
-  }
-  return;
-
- l28:  // 11100  I-form
-  {
-    IFormInst iform(inst);
-    unsigned rd = iform.fields.rd, rs1 = iform.fields.rs1;
-    uint32_t csr = iform.uimmed();
-    switch (iform.fields.funct3)
-      {
-      case 0:
-	{
-	  uint32_t funct7 = csr >> 5;
-	  if (funct7 == 0) // ecall ebreak uret
-	    {
-	      if (rs1 != 0 or rd != 0) illegalInst();
-	      else if (csr == 0)     execEcall();
-	      else if (csr == 1)     execEbreak();
-	      else if (csr == 2)     execUret();
-	      else                   illegalInst();
-	    }
-	  else if (funct7 == 9)
-	    {
-	      if (rd != 0) illegalInst();
-	      else         unimplemented();  // sfence.vma
-	    }
-	  else if (csr == 0x102) execSret();
-	  else if (csr == 0x302) execMret();
-	  else if (csr == 0x105) execWfi();
-	  else                   illegalInst();
-	}
-	break;
-      case 1: execCsrrw(rd, rs1, csr); break;
-      case 2: execCsrrs(rd, rs1, csr); break;
-      case 3: execCsrrc(rd, rs1, csr); break;
-      case 5: execCsrrwi(rd, rs1, csr); break;
-      case 6: execCsrrsi(rd, rs1, csr); break;
-      case 7: execCsrrci(rd, rs1, csr); break;
-      default: illegalInst(); break;
-      }
-  }
-}
-
-
-
-template <typename URV>
-void
-Core<URV>::execute16(uint16_t inst)
-{
-  if (not isRvc())
-    {
-      illegalInst();
-      return;
-    }
-
-  uint16_t quadrant = inst & 0x3;
-  uint16_t funct3 =  inst >> 13;    // Bits 15 14 and 13
-
-  if (quadrant == 0)
-    {
-      if (funct3 == 0)   // illegal, c.addi4spn
-	{
-	  if (inst == 0)
-	    illegalInst();
-	  else
-	    {
-	      CiwFormInst ciwf(inst);
-	      unsigned immed = ciwf.immed();
-	      if (immed == 0)
-		illegalInst();  // As of v2.3 of User-Level ISA (Dec 2107).
-	      else
-		execAddi(8+ciwf.bits.rdp, RegSp, immed);  // c.addi4spn
-	    }
-	  return;
-	}
-
-      if (funct3 == 1) // c.fld c.lq
-	{
-	  if (not isRvd())
-	    illegalInst();
-	  else
-	    {
-	      ClFormInst clf(inst);
-	      execFld(8+clf.bits.rdp, 8+clf.bits.rs1p, clf.ldImmed());
-	    }
-	  return;
-	}
-
-      if (funct3 == 2) // c.lw
-	{
-	  ClFormInst clf(inst);
-	  execLw(8+clf.bits.rdp, 8+clf.bits.rs1p, clf.lwImmed());
-	  return;
-	}
-
-      if (funct3 == 3)  // c.flw, c.ld
+      if (funct3 == 3) // c.flw, c.ld
 	{
 	  ClFormInst clf(inst);
 	  if (isRv64())
-	    execLd(8+clf.bits.rdp, 8+clf.bits.rs1p, clf.ldImmed());
-	  else
-	    {  // c.flw
-	      if (isRvf())
-		execFlw(8+clf.bits.rdp, 8+clf.bits.rs1p, clf.lwImmed());
-	      else
-		illegalInst();
-	    }
-	  return;
+	    return encodeLd(8+clf.bits.rdp, 8+clf.bits.rs1p, clf.ldImmed(),
+			    code32);
+	  // c.flw
+	  if (not isRvf())
+	    return false;
+	  return encodeFlw(8+clf.bits.rdp, 8+clf.bits.rs1p, clf.lwImmed(),
+			   code32);
 	}
 
-      if (funct3 == 5)  // c.fsd
+      if (funct3 == 5)  // c.fsd, c.sq
 	{
-	  if (isRvd())
-	    {
-	      ClFormInst clf(inst);
-	      execFsd(8+clf.bits.rdp, 8+clf.bits.rs1p, clf.ldImmed());
-	    }
-	  else
-	    illegalInst();
-	  return;
+	  if (not isRvd())
+	    return false;
+	  CsFormInst cs(inst);
+	  return encodeFsd(8+cs.bits.rs1p, 8+cs.bits.rs2p, cs.sdImmed(),
+			   code32);
 	}
 
       if (funct3 == 6)  // c.sw
 	{
 	  CsFormInst cs(inst);
-	  execSw(8+cs.bits.rs1p, 8+cs.bits.rs2p, cs.swImmed());
-	  return;
+	  return encodeSw(8+cs.bits.rs1p, 8+cs.bits.rs2p, cs.swImmed(),
+			  code32);
 	}
 
       if (funct3 == 7) // c.fsw, c.sd
 	{
 	  CsFormInst cs(inst);
-	  if (isRv64())
-	    execSd(8+cs.bits.rs1p, 8+cs.bits.rs2p, cs.sdImmed());
-	  else
+	  if (not isRv64())
 	    {
-	      if (isRvf())
-		execFsw(8+cs.bits.rs1p, 8+cs.bits.rs2p, cs.swImmed());
-	      else
-		illegalInst(); // c.fsw
+	      if (not isRvf())
+		return false;
+	      return encodeFsw(8+cs.bits.rs1p, 8+cs.bits.rs2p, cs.swImmed(),
+			       code32);
 	    }
-	  return;
+	  return encodeSd(8+cs.bits.rs1p, 8+cs.bits.rs2p, cs.sdImmed(), code32);
 	}
 
-      // funct3 is 4 (reserved).
-      illegalInst();
-      return;
+      // funct3 is 4 (reserved)
+      return false;
     }
 
   if (quadrant == 1)
@@ -3876,8 +4010,7 @@ Core<URV>::execute16(uint16_t inst)
       if (funct3 == 0)  // c.nop, c.addi
 	{
 	  CiFormInst cif(inst);
-	  execAddi(cif.bits.rd, cif.bits.rd, cif.addiImmed());
-	  return;
+	  return encodeAddi(cif.bits.rd, cif.bits.rd, cif.addiImmed(), code32);
 	}
 	  
       if (funct3 == 1)  // c.jal, in rv64 and rv128 this is c.addiw
@@ -3886,23 +4019,20 @@ Core<URV>::execute16(uint16_t inst)
 	    {
 	      CiFormInst cif(inst);
 	      if (cif.bits.rd == 0)
-		illegalInst();
-	      else
-		execAddiw(cif.bits.rd, cif.bits.rd, cif.addiImmed());
+		return false;
+	      return encodeAddiw(cif.bits.rd, cif.bits.rd, cif.addiImmed(), code32);
 	    }
 	  else
 	    {
 	      CjFormInst cjf(inst);
-	      execJal(RegRa, cjf.immed());
+	      return encodeJal(RegRa, cjf.immed(), 0, code32);
 	    }
-	  return;
 	}
 
       if (funct3 == 2)  // c.li
 	{
 	  CiFormInst cif(inst);
-	  execAddi(cif.bits.rd, RegX0, cif.addiImmed());
-	  return;
+	  return encodeAddi(cif.bits.rd, RegX0, cif.addiImmed(), code32);
 	}
 
       if (funct3 == 3)  // c.addi16sp, c.lui
@@ -3910,16 +4040,14 @@ Core<URV>::execute16(uint16_t inst)
 	  CiFormInst cif(inst);
 	  int immed16 = cif.addi16spImmed();
 	  if (immed16 == 0)
-	    illegalInst();
-	  else if (cif.bits.rd == RegSp)  // c.addi16sp
-	    execAddi(cif.bits.rd, cif.bits.rd, immed16);
-	  else
-	    execLui(cif.bits.rd, cif.luiImmed());
-	  return;
+	    return false;
+	  if (cif.bits.rd == RegSp)  // c.addi16sp
+	    return encodeAddi(cif.bits.rd, cif.bits.rd, immed16, code32);
+	  return encodeLui(cif.bits.rd, cif.luiImmed(), 0, code32);
 	}
 
-      // c.srli c.srli64 c.srai c.srai64 c.andi c.sub c.xor c.and
-      // c.subw c.addw
+	// c.srli c.srli64 c.srai c.srai64 c.andi c.sub c.xor c.and
+	// c.subw c.addw
       if (funct3 == 4)
 	{
 	  CaiFormInst caf(inst);  // compressed and immediate form
@@ -3929,60 +4057,53 @@ Core<URV>::execute16(uint16_t inst)
 	  if (f2 == 0) // srli64, srli
 	    {
 	      if (caf.bits.ic5 != 0 and not isRv64())
-		illegalInst(); // As of v2.3 of User-Level ISA (Dec 2107).
-	      else
-		execSrli(rd, rd, caf.shiftImmed());
+		return false;  // As of v2.3 of User-Level ISA (Dec 2107).
+	      return encodeSrli(rd, rd, caf.shiftImmed(), code32);
 	    }
-	  else if (f2 == 1) // srai64, srai
+	  if (f2 == 1)  // srai64, srai
 	    {
 	      if (caf.bits.ic5 != 0 and not isRv64())
-		illegalInst(); // As of v2.3 of User-Level ISA (Dec 2107).
-	      else
-		execSrai(rd, rd, caf.shiftImmed());
+		return false; // As of v2.3 of User-Level ISA (Dec 2107).
+	      return encodeSrai(rd, rd, caf.shiftImmed(), code32);
 	    }
-	  else if (f2 == 2)  // c.andi
-	    execAndi(rd, rd, immed);
-	  else  // f2 == 3: c.sub c.xor c.or c.subw c.addw
+	  if (f2 == 2)  // c.andi
+	    return encodeAndi(rd, rd, immed, code32);
+
+	  // f2 == 3: c.sub c.xor c.or c.subw c.addw
+	  unsigned rs2p = (immed & 0x7); // Lowest 3 bits of immed
+	  unsigned rs2 = 8 + rs2p;
+	  unsigned imm34 = (immed >> 3) & 3; // Bits 3 and 4 of immed
+	  if ((immed & 0x20) == 0)  // Bit 5 of immed
 	    {
-	      unsigned rs2p = (immed & 0x7); // Lowest 3 bits of immed
-	      unsigned rs2 = 8 + rs2p;
-	      unsigned imm34 = (immed >> 3) & 3; // Bits 3 and 4 of immed
-	      if ((immed & 0x20) == 0)  // Bit 5 of immed
-		{
-		  if      (imm34 == 0) execSub(rd, rd, rs2);
-		  else if (imm34 == 1) execXor(rd, rd, rs2);
-		  else if (imm34 == 2) execOr(rd, rd, rs2);
-		  else                 execAnd(rd, rd, rs2);
-		}
-	      else
-		{
-		  if      (imm34 == 0) execSubw(rd, rd, rs2);
-		  else if (imm34 == 1) execAddw(rd, rd, rs2);
-		  else if (imm34 == 2) illegalInst(); // reserved
-		  else                 illegalInst(); // reserved
-		}
+	      if (imm34 == 0) return encodeSub(rd, rd, rs2, code32);
+	      if (imm34 == 1) return encodeXor(rd, rd, rs2, code32);
+	      if (imm34 == 2) return encodeOr(rd, rd, rs2, code32);
+	      return encodeAnd(rd, rd, rs2,  code32);
 	    }
-	  return;
+	  // Bit 5 of immed is 1
+	  if (not isRv64())
+	    return false;
+	  if (imm34 == 0) return encodeSubw(rd, rd, rs2, code32);
+	  if (imm34 == 1) return encodeAddw(rd, rd, rs2, code32);
+	  if (imm34 == 2) return false; // reserved
+	  return false; // reserved
 	}
 
       if (funct3 == 5)  // c.j
 	{
 	  CjFormInst cjf(inst);
-	  execJal(RegX0, cjf.immed());
-	  return;
+	  return encodeJal(RegX0, cjf.immed(), 0, code32);
 	}
 	  
-      if (funct3 == 6)  // c.beqz
+      if (funct3 == 6) // c.beqz
 	{
 	  CbFormInst cbf(inst);
-	  execBeq(8+cbf.bits.rs1p, RegX0, cbf.immed());
-	  return;
+	  return encodeBeq(8+cbf.bits.rs1p, RegX0, cbf.immed(), code32);
 	}
 
-      // (funct3 == 7)  // c.bnez
+      // funct3 == 7: c.bnez
       CbFormInst cbf(inst);
-      execBne(8+cbf.bits.rs1p, RegX0, cbf.immed());
-      return;
+      return encodeBne(8+cbf.bits.rs1p, RegX0, cbf.immed(), code32);
     }
 
   if (quadrant == 2)
@@ -3992,30 +4113,26 @@ Core<URV>::execute16(uint16_t inst)
 	  CiFormInst cif(inst);
 	  unsigned immed = unsigned(cif.slliImmed());
 	  if (cif.bits.ic5 != 0 and not isRv64())
-	    illegalInst();
-	  else
-	    execSlli(cif.bits.rd, cif.bits.rd, immed);
-	  return;
+	    return false;
+	  return encodeSlli(cif.bits.rd, cif.bits.rd, immed, code32);
 	}
 
-      if (funct3 == 1)  // c.fldsp c.lqsp
+      if (funct3 == 1) // c.fldsp c.lqsp
 	{
 	  if (isRvd())
 	    {
 	      CiFormInst cif(inst);
-	      execFld(cif.bits.rd, RegSp, cif.ldspImmed());
+	      return encodeFld(cif.bits.rd, RegSp, cif.ldspImmed(), code32);
 	    }
-	  else
-	    illegalInst();
-	  return;
+	  return false;
 	}
 
-      if (funct3 == 2)  // c.lwsp
+      if (funct3 == 2) // c.lwsp
 	{
 	  CiFormInst cif(inst);
 	  unsigned rd = cif.bits.rd;
-	  execLw(rd, RegSp, cif.lwspImmed());
-	  return;
+	  // rd == 0 is legal per Andrew Watterman
+	  return encodeLw(rd, RegSp, cif.lwspImmed(), code32);
 	}
 
       if (funct3 == 3)  // c.ldsp  c.flwsp
@@ -4023,15 +4140,13 @@ Core<URV>::execute16(uint16_t inst)
 	  CiFormInst cif(inst);
 	  unsigned rd = cif.bits.rd;
 	  if (isRv64())  // c.ldsp
-	    execLd(rd, RegSp, cif.ldspImmed());
-	  else if (isRvf())  // c.flwsp
-	    execFlw(rd, RegSp, cif.lwspImmed());
-	  else
-	    illegalInst();
-	  return;
+	    return encodeLd(rd, RegSp, cif.ldspImmed(), code32);
+	  if (isRvf())  // c.flwsp
+	    return encodeFlw(rd, RegSp, cif.lwspImmed(), code32);
+	  return false;
 	}
 
-      if (funct3 == 4)   // c.jr c.mv c.ebreak c.jalr c.add
+      if (funct3 == 4) // c.jr c.mv c.ebreak c.jalr c.add
 	{
 	  CiFormInst cif(inst);
 	  unsigned immed = cif.addiImmed();
@@ -4042,26 +4157,21 @@ Core<URV>::execute16(uint16_t inst)
 	      if (rs2 == RegX0)
 		{
 		  if (rd == RegX0)
-		    illegalInst();
-		  else
-		    execJalr(RegX0, rd, 0);
+		    return false;
+		  return encodeJalr(RegX0, rd, 0, code32);
 		}
-	      else
-		execAdd(rd, RegX0, rs2);
+	      return encodeAdd(rd, RegX0, rs2, code32);
 	    }
 	  else  // c.ebreak, c.jalr or c.add 
 	    {
 	      if (rs2 == RegX0)
 		{
 		  if (rd == RegX0)
-		    execEbreak();
-		  else
-		    execJalr(RegRa, rd, 0);
+		    return encodeEbreak(0, 0, 0, code32);
+		  return encodeJalr(RegRa, rd, 0, code32);
 		}
-	      else
-		execAdd(rd, rd, rs2);
+	      return encodeAdd(rd, rd, rs2, code32);
 	    }
-	  return;
 	}
 
       if (funct3 == 5)  // c.fsdsp c.sqsp
@@ -4069,18 +4179,15 @@ Core<URV>::execute16(uint16_t inst)
 	  if (isRvd())
 	    {
 	      CswspFormInst csw(inst);
-	      execFsd(RegSp, csw.bits.rs2, csw.sdImmed());
+	      return encodeFsd(RegSp, csw.bits.rs2, csw.sdImmed(), code32);
 	    }
-	  else
-	    illegalInst();
-	  return;
+	  return false;
 	}
 
-      if (funct3 == 6)  // c.swsp
+      if (funct3 == 6) // c.swsp
 	{
 	  CswspFormInst csw(inst);
-	  execSw(RegSp, csw.bits.rs2, csw.swImmed());  // imm(sp) <- rs2
-	  return;
+	  return encodeSw(RegSp, csw.bits.rs2, csw.swImmed(), code32);
 	}
 
       if (funct3 == 7)  // c.sdsp  c.fswsp
@@ -4088,130 +4195,127 @@ Core<URV>::execute16(uint16_t inst)
 	  if (isRv64())  // c.sdsp
 	    {
 	      CswspFormInst csw(inst);
-	      execSd(RegSp, csw.bits.rs2, csw.sdImmed());
+	      return encodeSd(RegSp, csw.bits.rs2, csw.sdImmed(), code32);
 	    }
-	  else if (isRvf())   // c.fswsp
+	  if (isRvf())   // c.fswsp
 	    {
 	      CswspFormInst csw(inst);
-	      execFsw(RegSp, csw.bits.rs2, csw.swImmed());  // imm(sp) <- rs2
+	      return encodeFsw(RegSp, csw.bits.rs2, csw.swImmed(), code32);
 	    }
-	  else
-	    illegalInst();
-	  return;
+	  return false;
 	}
+
+      return false;
     }
 
-  // quadrant 3
-  illegalInst();
+  return false; // quadrant 3
 }
 
 
 template <typename URV>
-void
-Core<URV>::disassembleInst(uint32_t inst, std::ostream& stream)
+bool
+Core<URV>::expandInst(uint16_t inst, uint32_t& code32) const
 {
-  // Decode and disassemble
-  if ((inst & 0x3) == 0x3) 
-    disassembleInst32(inst, stream);
-  else
-    disassembleInst16(inst, stream);
+  code32 = compressedTable_[inst].code32;
+  return code32 != 0;
 }
 
 
 template <typename URV>
-void
-Core<URV>::disassembleInst(uint32_t inst, std::string& str)
+const InstInfo&
+Core<URV>::decodeCompressed(uint32_t inst, uint32_t& op0, uint32_t& op1,
+			    int32_t& op2)
 {
-  str.clear();
-
-  std::ostringstream oss;
-  disassembleInst(inst, oss);
-  str = oss.str();
-}
-
-
-template <typename URV>
-bool
-Core<URV>::expandInst(uint16_t inst, uint32_t& code32) const
-{
-  code32 = 0; // Start with an illegal instruction.
+  inst = (inst << 16) >> 16;  // Clear top 16 bits.
 
   uint16_t quadrant = inst & 0x3;
   uint16_t funct3 =  inst >> 13;    // Bits 15 14 and 13
 
+  op0 = 0; op1 = 0; op2 = 0;
+
   if (quadrant == 0)
     {
       if (funct3 == 0)    // illegal, c.addi4spn
 	{
 	  if (inst == 0)
-	    return false;
+	    return instTable_.getInstInfo(InstId::illegal);
 	  CiwFormInst ciwf(inst);
 	  unsigned immed = ciwf.immed();
 	  if (immed == 0)
-	    return false;
-	  return encodeAddi(8+ciwf.bits.rdp, RegSp, immed, code32);
+	    return instTable_.getInstInfo(InstId::illegal);
+	  op0 = 8 + ciwf.bits.rdp; op1 = RegSp; op2 = immed;
+	  return instTable_.getInstInfo(InstId::c_addi4spn);
 	}
 
       if (funct3 == 1) // c.fld c.lq
 	{
 	  if (not isRvd())
-	    return false;
+	    return instTable_.getInstInfo(InstId::illegal);
 	  ClFormInst clf(inst);
-	  return encodeFld(8+clf.bits.rdp, 8+clf.bits.rs1p, clf.ldImmed(),
-			  code32);
+	  op0 = 8+clf.bits.rdp; op1 = 8+clf.bits.rs1p; op2 = clf.ldImmed();
+	  return instTable_.getInstInfo(InstId::c_fld);
 	}
 
       if (funct3 == 2) // c.lw
 	{
 	  ClFormInst clf(inst);
-	  return encodeLw(8+clf.bits.rdp, 8+clf.bits.rs1p, clf.lwImmed(),
-			  code32);
+	  op0 = 8+clf.bits.rdp; op1 = 8+clf.bits.rs1p; op2 = clf.lwImmed();
+	  return instTable_.getInstInfo(InstId::c_lw);
 	}
 
       if (funct3 == 3) // c.flw, c.ld
 	{
 	  ClFormInst clf(inst);
 	  if (isRv64())
-	    return encodeLd(8+clf.bits.rdp, 8+clf.bits.rs1p, clf.ldImmed(),
-			    code32);
-	  // c.flw
-	  if (not isRvf())
-	    return false;
-	  return encodeFlw(8+clf.bits.rdp, 8+clf.bits.rs1p, clf.lwImmed(),
-			   code32);
-	}
+	    {
+	      op0 = 8+clf.bits.rdp; op1 = 8+clf.bits.rs1p; op2 = clf.ldImmed();
+	      return instTable_.getInstInfo(InstId::c_ld);
+	    }
 
-      if (funct3 == 5)  // c.fsd, c.sq
-	{
-	  if (not isRvd())
-	    return false;
-	  CsFormInst cs(inst);
-	  return encodeFsd(8+cs.bits.rs1p, 8+cs.bits.rs2p, cs.sdImmed(),
-			   code32);
+	  // c.flw
+	  if (isRvf())
+	    {
+	      op0 = 8+clf.bits.rdp; op1 = 8+clf.bits.rs1p;
+	      op2 = clf.lwImmed();
+	      return instTable_.getInstInfo(InstId::c_flw);
+	    }
+	  return instTable_.getInstInfo(InstId::illegal);
 	}
 
       if (funct3 == 6)  // c.sw
 	{
 	  CsFormInst cs(inst);
-	  return encodeSw(8+cs.bits.rs1p, 8+cs.bits.rs2p, cs.swImmed(),
-			  code32);
+	  op0 = 8+cs.bits.rs1p; op1 = 8+cs.bits.rs2p; op2 = cs.swImmed();
+	  return instTable_.getInstInfo(InstId::c_sw);
 	}
 
       if (funct3 == 7) // c.fsw, c.sd
 	{
-	  CsFormInst cs(inst);
+	  CsFormInst cs(inst);  // Double check this
 	  if (not isRv64())
 	    {
-	      if (not isRvf())
-		return false;
-	      return encodeFsw(8+cs.bits.rs1p, 8+cs.bits.rs2p, cs.swImmed(),
-			       code32);
+	      if (isRvf())
+		{
+		  op0=8+cs.bits.rs1p; op1=8+cs.bits.rs2p; op2 = cs.swImmed();
+		  return instTable_.getInstInfo(InstId::c_fsw);
+		}
+	      return instTable_.getInstInfo(InstId::illegal);
 	    }
-	  return encodeSd(8+cs.bits.rs1p, 8+cs.bits.rs2p, cs.sdImmed(), code32);
+	  op0=8+cs.bits.rs1p; op1=8+cs.bits.rs2p; op2 = cs.sdImmed();
+	  return instTable_.getInstInfo(InstId::c_sd);
+	}
+
+      if (funct3 == 5)  // c.fsd c.sq
+	{
+	  if (not isRvd())
+	    return instTable_.getInstInfo(InstId::illegal);
+	  CsFormInst cs(inst);
+	  op0 = 8+cs.bits.rs1p; op1 = 8+cs.bits.rs2p; op2 = cs.sdImmed();
+	  return instTable_.getInstInfo(InstId::c_fsd);
 	}
 
       // funct3 is 4 (reserved)
-      return false;
+      return instTable_.getInstInfo(InstId::illegal);
     }
 
   if (quadrant == 1)
@@ -4219,29 +4323,33 @@ Core<URV>::expandInst(uint16_t inst, uint32_t& code32) const
       if (funct3 == 0)  // c.nop, c.addi
 	{
 	  CiFormInst cif(inst);
-	  return encodeAddi(cif.bits.rd, cif.bits.rd, cif.addiImmed(), code32);
+	  op0 = cif.bits.rd; op1 = cif.bits.rd; op2 = cif.addiImmed();
+	  return instTable_.getInstInfo(InstId::c_addi);
 	}
 	  
-      if (funct3 == 1)  // c.jal, in rv64 and rv128 this is c.addiw
+      if (funct3 == 1)  // c.jal,  in rv64 and rv128 this is c.addiw
 	{
 	  if (isRv64())
 	    {
 	      CiFormInst cif(inst);
 	      if (cif.bits.rd == 0)
-		return false;
-	      return encodeAddiw(cif.bits.rd, cif.bits.rd, cif.addiImmed(), code32);
+		return instTable_.getInstInfo(InstId::illegal);
+	      op0 = cif.bits.rd; op1 = cif.bits.rd; op2 = cif.addiImmed();
+	      return instTable_.getInstInfo(InstId::c_addiw);
 	    }
 	  else
 	    {
 	      CjFormInst cjf(inst);
-	      return encodeJal(RegRa, cjf.immed(), 0, code32);
+	      op0 = RegRa; op1 = cjf.immed(); op2 = 0;
+	      return instTable_.getInstInfo(InstId::c_jal);
 	    }
 	}
 
       if (funct3 == 2)  // c.li
 	{
 	  CiFormInst cif(inst);
-	  return encodeAddi(cif.bits.rd, RegX0, cif.addiImmed(), code32);
+	  op0 = cif.bits.rd; op1 = RegX0; op2 = cif.addiImmed();
+	  return instTable_.getInstInfo(InstId::c_li);
 	}
 
       if (funct3 == 3)  // c.addi16sp, c.lui
@@ -4249,14 +4357,18 @@ Core<URV>::expandInst(uint16_t inst, uint32_t& code32) const
 	  CiFormInst cif(inst);
 	  int immed16 = cif.addi16spImmed();
 	  if (immed16 == 0)
-	    return false;
+	    return instTable_.getInstInfo(InstId::illegal);
 	  if (cif.bits.rd == RegSp)  // c.addi16sp
-	    return encodeAddi(cif.bits.rd, cif.bits.rd, immed16, code32);
-	  return encodeLui(cif.bits.rd, cif.luiImmed(), 0, code32);
+	    {
+	      op0 = cif.bits.rd; op1 = cif.bits.rd; op2 = immed16;
+	      return instTable_.getInstInfo(InstId::c_addi16sp);
+	    }
+	  op0 = cif.bits.rd; op1 = cif.luiImmed(); op2 = 0;
+	  return instTable_.getInstInfo(InstId::c_lui);
 	}
 
-	// c.srli c.srli64 c.srai c.srai64 c.andi c.sub c.xor c.and
-	// c.subw c.addw
+      // c.srli c.srli64 c.srai c.srai64 c.andi c.sub c.xor c.and
+      // c.subw c.addw
       if (funct3 == 4)
 	{
 	  CaiFormInst caf(inst);  // compressed and immediate form
@@ -4266,53 +4378,62 @@ Core<URV>::expandInst(uint16_t inst, uint32_t& code32) const
 	  if (f2 == 0) // srli64, srli
 	    {
 	      if (caf.bits.ic5 != 0 and not isRv64())
-		return false;  // As of v2.3 of User-Level ISA (Dec 2107).
-	      return encodeSrli(rd, rd, caf.shiftImmed(), code32);
+		return instTable_.getInstInfo(InstId::illegal);
+	      op0 = rd; op1 = rd; op2 = caf.shiftImmed();
+	      return instTable_.getInstInfo(InstId::c_srli);
 	    }
 	  if (f2 == 1)  // srai64, srai
 	    {
 	      if (caf.bits.ic5 != 0 and not isRv64())
-		return false; // As of v2.3 of User-Level ISA (Dec 2107).
-	      return encodeSrai(rd, rd, caf.shiftImmed(), code32);
+		return instTable_.getInstInfo(InstId::illegal);
+	      op0 = rd; op1 = rd; op2 = caf.shiftImmed();
+	      return instTable_.getInstInfo(InstId::c_srai);
 	    }
 	  if (f2 == 2)  // c.andi
-	    return encodeAndi(rd, rd, immed, code32);
+	    {
+	      op0 = rd; op1 = rd; op2 = immed;
+	      return instTable_.getInstInfo(InstId::c_andi);
+	    }
 
 	  // f2 == 3: c.sub c.xor c.or c.subw c.addw
 	  unsigned rs2p = (immed & 0x7); // Lowest 3 bits of immed
 	  unsigned rs2 = 8 + rs2p;
 	  unsigned imm34 = (immed >> 3) & 3; // Bits 3 and 4 of immed
+	  op0 = rd; op1 = rd; op2 = rs2;
 	  if ((immed & 0x20) == 0)  // Bit 5 of immed
 	    {
-	      if (imm34 == 0) return encodeSub(rd, rd, rs2, code32);
-	      if (imm34 == 1) return encodeXor(rd, rd, rs2, code32);
-	      if (imm34 == 2) return encodeOr(rd, rd, rs2, code32);
-	      return encodeAnd(rd, rd, rs2,  code32);
+	      if (imm34 == 0) return instTable_.getInstInfo(InstId::c_sub);
+	      if (imm34 == 1) return instTable_.getInstInfo(InstId::c_xor);
+	      if (imm34 == 2) return instTable_.getInstInfo(InstId::c_or);
+	      return instTable_.getInstInfo(InstId::c_and);
 	    }
 	  // Bit 5 of immed is 1
 	  if (not isRv64())
-	    return false;
-	  if (imm34 == 0) return encodeSubw(rd, rd, rs2, code32);
-	  if (imm34 == 1) return encodeAddw(rd, rd, rs2, code32);
-	  if (imm34 == 2) return false; // reserved
-	  return false; // reserved
+	    return instTable_.getInstInfo(InstId::illegal);
+	  if (imm34 == 0) return instTable_.getInstInfo(InstId::c_subw);
+	  if (imm34 == 1) return instTable_.getInstInfo(InstId::c_addw);
+	  if (imm34 == 2) return instTable_.getInstInfo(InstId::illegal);
+	  return instTable_.getInstInfo(InstId::illegal);
 	}
 
       if (funct3 == 5)  // c.j
 	{
 	  CjFormInst cjf(inst);
-	  return encodeJal(RegX0, cjf.immed(), 0, code32);
+	  op0 = RegX0; op1 = cjf.immed(); op2 = 0;
+	  return instTable_.getInstInfo(InstId::c_j);
 	}
 	  
       if (funct3 == 6) // c.beqz
 	{
 	  CbFormInst cbf(inst);
-	  return encodeBeq(8+cbf.bits.rs1p, RegX0, cbf.immed(), code32);
+	  op0=8+cbf.bits.rs1p; op1=RegX0; op2=cbf.immed();
+	  return instTable_.getInstInfo(InstId::c_beqz);
 	}
-
+      
       // funct3 == 7: c.bnez
       CbFormInst cbf(inst);
-      return encodeBne(8+cbf.bits.rs1p, RegX0, cbf.immed(), code32);
+      op0 = 8+cbf.bits.rs1p; op1=RegX0; op2=cbf.immed();
+      return instTable_.getInstInfo(InstId::c_bnez);
     }
 
   if (quadrant == 2)
@@ -4322,18 +4443,20 @@ Core<URV>::expandInst(uint16_t inst, uint32_t& code32) const
 	  CiFormInst cif(inst);
 	  unsigned immed = unsigned(cif.slliImmed());
 	  if (cif.bits.ic5 != 0 and not isRv64())
-	    return false;
-	  return encodeSlli(cif.bits.rd, cif.bits.rd, immed, code32);
+	    return instTable_.getInstInfo(InstId::illegal);
+	  op0 = cif.bits.rd; op1 = cif.bits.rd; op2 = immed;
+	  return instTable_.getInstInfo(InstId::c_slli);
 	}
 
-      if (funct3 == 1) // c.fldsp c.lqsp
+      if (funct3 == 1)  // c.fldsp c.lqsp
 	{
 	  if (isRvd())
 	    {
 	      CiFormInst cif(inst);
-	      return encodeFld(cif.bits.rd, RegSp, cif.ldspImmed(), code32);
+	      op0 = cif.bits.rd; op1 = RegSp, op2 = cif.ldspImmed();
+	      return instTable_.getInstInfo(InstId::c_fldsp);
 	    }
-	  return false;
+	  return instTable_.getInstInfo(InstId::illegal);
 	}
 
       if (funct3 == 2) // c.lwsp
@@ -4341,18 +4464,25 @@ Core<URV>::expandInst(uint16_t inst, uint32_t& code32) const
 	  CiFormInst cif(inst);
 	  unsigned rd = cif.bits.rd;
 	  // rd == 0 is legal per Andrew Watterman
-	  return encodeLw(rd, RegSp, cif.lwspImmed(), code32);
+	  op0 = rd; op1 = RegSp; op2 = cif.lwspImmed();
+	  return instTable_.getInstInfo(InstId::c_lwsp);
 	}
 
-      if (funct3 == 3)  // c.ldsp  c.flwsp
+      else  if (funct3 == 3)  // c.ldsp  c.flwsp
 	{
 	  CiFormInst cif(inst);
 	  unsigned rd = cif.bits.rd;
-	  if (isRv64())  // c.ldsp
-	    return encodeLd(rd, RegSp, cif.ldspImmed(), code32);
-	  if (isRvf())  // c.flwsp
-	    return encodeLw(rd, RegSp, cif.lwspImmed(), code32);
-	  return false;
+	  if (isRv64())
+	    {
+	      op0 = rd; op1 = RegSp; op2 = cif.ldspImmed();
+	      return instTable_.getInstInfo(InstId::c_ldsp);
+	    }
+	  if (isRvf())
+	    {
+	      op0 = rd; op1 = RegSp; op2 = cif.lwspImmed();
+	      return instTable_.getInstInfo(InstId::c_flwsp);
+	    }
+	  return instTable_.getInstInfo(InstId::illegal);
 	}
 
       if (funct3 == 4) // c.jr c.mv c.ebreak c.jalr c.add
@@ -4366,20 +4496,24 @@ Core<URV>::expandInst(uint16_t inst, uint32_t& code32) const
 	      if (rs2 == RegX0)
 		{
 		  if (rd == RegX0)
-		    return false;
-		  return encodeJalr(RegX0, rd, 0, code32);
+		    return instTable_.getInstInfo(InstId::illegal);
+		  op0 = RegX0; op1 = rd; op2 = 0;
+		  return instTable_.getInstInfo(InstId::c_jr);
 		}
-	      return encodeAdd(rd, RegX0, rs2, code32);
+	      op0 = rd; op1 = RegX0; op2 = rs2;
+	      return instTable_.getInstInfo(InstId::c_mv);
 	    }
 	  else  // c.ebreak, c.jalr or c.add 
 	    {
 	      if (rs2 == RegX0)
 		{
 		  if (rd == RegX0)
-		    return encodeEbreak(0, 0, 0, code32);
-		  return encodeJalr(RegRa, rd, 0, code32);
+		    return instTable_.getInstInfo(InstId::c_ebreak);
+		  op0 = RegRa; op1 = rd; op2 = 0;
+		  return instTable_.getInstInfo(InstId::c_jalr);
 		}
-	      return encodeAdd(rd, rd, rs2, code32);
+	      op0 = rd; op1 = rd; op2 = rs2;
+	      return instTable_.getInstInfo(InstId::c_add);
 	    }
 	}
 
@@ -4388,15 +4522,17 @@ Core<URV>::expandInst(uint16_t inst, uint32_t& code32) const
 	  if (isRvd())
 	    {
 	      CswspFormInst csw(inst);
-	      return encodeFsd(RegSp, csw.bits.rs2, csw.sdImmed(), code32);
+	      op0 = RegSp; op1 = csw.bits.rs2; op2 = csw.sdImmed();
+	      return instTable_.getInstInfo(InstId::c_fsdsp);
 	    }
-	  return false;
+	  return instTable_.getInstInfo(InstId::illegal);
 	}
 
       if (funct3 == 6) // c.swsp
 	{
 	  CswspFormInst csw(inst);
-	  return encodeSw(RegSp, csw.bits.rs2, csw.swImmed(), code32);
+	  op0 = RegSp; op1 = csw.bits.rs2; op2 = csw.swImmed();
+	  return instTable_.getInstInfo(InstId::c_swsp);
 	}
 
       if (funct3 == 7)  // c.sdsp  c.fswsp
@@ -4404,4211 +4540,5526 @@ Core<URV>::expandInst(uint16_t inst, uint32_t& code32) const
 	  if (isRv64())  // c.sdsp
 	    {
 	      CswspFormInst csw(inst);
-	      return encodeSd(RegSp, csw.bits.rs2, csw.sdImmed(), code32);
+	      op0 = RegSp; op1 = csw.bits.rs2; op2 = csw.sdImmed();
+	      return instTable_.getInstInfo(InstId::c_sdsp);
 	    }
 	  if (isRvf())   // c.fswsp
 	    {
 	      CswspFormInst csw(inst);
-	      return encodeSw(RegSp, csw.bits.rs2, csw.swImmed(), code32);
+	      op0 = RegSp; op1 = csw.bits.rs2; op2 = csw.swImmed();
+	      return instTable_.getInstInfo(InstId::c_fswsp);
 	    }
-	  return false;
+	  return instTable_.getInstInfo(InstId::illegal);
 	}
 
-      return false;
+      return instTable_.getInstInfo(InstId::illegal);
     }
 
-  return false; // quadrant 3
+  return instTable_.getInstInfo(InstId::illegal); // quadrant 3
 }
 
 
 template <typename URV>
 const InstInfo&
-Core<URV>::decodeFp(uint32_t inst, uint32_t& op0, uint32_t& op1, int32_t& op2)
+Core<URV>::decode16(uint32_t inst, uint32_t& op0, uint32_t& op1, int32_t& op2)
 {
-  if (not isRvf())
-    return instTable_.getInstInfo(InstId::illegal);  
+  const Compressed16& entry = compressedTable_[inst & 0xffff];
+  op0 = entry.op0; op1 = entry.op1; op2 = entry.op2;
+  return instTable_.getInstInfo(InstId(entry.id));
+}
 
-  RFormInst rform(inst);
-  op0 = rform.bits.rd, op1 = rform.bits.rs1, op2 = rform.bits.rs2;
-  unsigned f7 = rform.bits.funct7, f3 = rform.bits.funct3;
-  instRoundingMode_ = RoundingMode(f3);
-  if (f7 & 1)
-    {
-      if (not isRvd())
-	return instTable_.getInstInfo(InstId::illegal);  
 
-      if (f7 == 1)              return instTable_.getInstInfo(InstId::fadd_d);
-      if (f7 == 5)              return instTable_.getInstInfo(InstId::fsub_d);
-      if (f7 == 9)              return instTable_.getInstInfo(InstId::fmul_d);
-      if (f7 == 0xd)            return instTable_.getInstInfo(InstId::fdiv_d);
-      if (f7 == 0x11)
-	{
-	  if (f3 == 0)          return instTable_.getInstInfo(InstId::fsgnj_d);
-	  if (f3 == 1)          return instTable_.getInstInfo(InstId::fsgnjn_d);
-	  if (f3 == 2)          return instTable_.getInstInfo(InstId::fsgnjx_d);
-	}
-      if (f7 == 0x15)
-	{
-	  if (f3 == 0)          return instTable_.getInstInfo(InstId::fmin_d);
-	  if (f3 == 1)          return instTable_.getInstInfo(InstId::fmax_d);
-	}
-      if (f7==0x21 and op2==0)  return instTable_.getInstInfo(InstId::fcvt_d_s);
-      if (f7 == 0x2d)           return instTable_.getInstInfo(InstId::fsqrt_d);
-      if (f7 == 0x51)
-	{
-	  if (f3 == 0)          return instTable_.getInstInfo(InstId::fle_d);
-	  if (f3 == 1)          return instTable_.getInstInfo(InstId::flt_d);
-	  if (f3 == 2)          return instTable_.getInstInfo(InstId::feq_d);
-	}
-      if (f7 == 0x61)
-	{
-	  if (op2 == 0)         return instTable_.getInstInfo(InstId::fcvt_w_d);
-	  if (op2 == 1)         return instTable_.getInstInfo(InstId::fcvt_wu_d);
-	  if (op2 == 2)         return instTable_.getInstInfo(InstId::fcvt_l_d);
-	  if (op2 == 3)         return instTable_.getInstInfo(InstId::fcvt_lu_d);
-	}
-      if (f7 == 0x69)
-	{
-	  if (op2 == 0)         return instTable_.getInstInfo(InstId::fcvt_d_w);
-	  if (op2 == 1)         return instTable_.getInstInfo(InstId::fcvt_d_wu);
-	  if (op2 == 2)         return instTable_.getInstInfo(InstId::fcvt_d_l);
-	  if (op2 == 3)         return instTable_.getInstInfo(InstId::fcvt_d_lu);
-	}
-      if (f7 == 0x71)
-	{
-	  if (op2==0 and f3==0) return instTable_.getInstInfo(InstId::fmv_x_d);
-	  if (op2==0 and f3==1) return instTable_.getInstInfo(InstId::fclass_d);
-	}
-      if (f7 == 0x74)
-	if (op2==0 and f3==0)   return instTable_.getInstInfo(InstId::fmv_w_x);
-      if (f7 == 0x79)
-	if (op2==0 and f3==0)   return instTable_.getInstInfo(InstId::fmv_d_x);
+template <typename URV>
+void
+Core<URV>::buildDecodeTables()
+{
+  unsigned key = ((rvc_? 1 : 0) | (rvf_? 2 : 0) | (rvd_? 4 : 0) |
+		  (rv64_? 8 : 0) | (rvm_? 0x10 : 0) | (rva_? 0x20 : 0) |
+		  (rvv_? 0x40 : 0) | (rvb_? 0x80 : 0));
+  if (key == decodeTableKey_)
+    return;
+  decodeTableKey_ = key;
 
-      return instTable_.getInstInfo(InstId::illegal);
-    }
+  // Execute method of each instruction id. Instructions of disabled
+  // extensions execute as illegal.
+  execTable_.assign(size_t(InstId::maxId) + 1, &Core<URV>::execIllegal);
 
-  if (f7 == 0)      return instTable_.getInstInfo(InstId::fadd_s);
-  if (f7 == 4)      return instTable_.getInstInfo(InstId::fsub_s);
-  if (f7 == 8)      return instTable_.getInstInfo(InstId::fmul_s);
-  if (f7 == 0xc)    return instTable_.getInstInfo(InstId::fdiv_s);
-  if (f7 == 0x2c)   return instTable_.getInstInfo(InstId::fsqrt_s);
-  if (f7 == 0x10)
-    {
-      if (f3 == 0)  return instTable_.getInstInfo(InstId::fsgnj_s);
-      if (f3 == 1)  return instTable_.getInstInfo(InstId::fsgnjn_s);
-      if (f3 == 2)  return instTable_.getInstInfo(InstId::fsgnjx_s);
-    }
-  if (f7 == 0x14)
-    {
-      if (f3 == 0)  return instTable_.getInstInfo(InstId::fmin_s);
-      if (f3 == 1)  return instTable_.getInstInfo(InstId::fmax_s);
+  auto setExec = [this](InstId id, ExecFunc func, bool enabled = true) {
+    execTable_.at(size_t(id)) = enabled? func : &Core<URV>::execIllegal;
+  };
+
+  // Base
+  setExec(InstId::lui, &Core<URV>::execLui);
+  setExec(InstId::auipc, &Core<URV>::execAuipc);
+  setExec(InstId::jal, &Core<URV>::execJal);
+  setExec(InstId::jalr, &Core<URV>::execJalr);
+  setExec(InstId::beq, &Core<URV>::execBeq);
+  setExec(InstId::bne, &Core<URV>::execBne);
+  setExec(InstId::blt, &Core<URV>::execBlt);
+  setExec(InstId::bge, &Core<URV>::execBge);
+  setExec(InstId::bltu, &Core<URV>::execBltu);
+  setExec(InstId::bgeu, &Core<URV>::execBgeu);
+  setExec(InstId::lb, &Core<URV>::execLb);
+  setExec(InstId::lh, &Core<URV>::execLh);
+  setExec(InstId::lw, &Core<URV>::execLw);
+  setExec(InstId::lbu, &Core<URV>::execLbu);
+  setExec(InstId::lhu, &Core<URV>::execLhu);
+  setExec(InstId::sb, &Core<URV>::execSb);
+  setExec(InstId::sh, &Core<URV>::execSh);
+  setExec(InstId::sw, &Core<URV>::execSw);
+  setExec(InstId::addi, &Core<URV>::execAddi);
+  setExec(InstId::slti, &Core<URV>::execSlti);
+  setExec(InstId::sltiu, &Core<URV>::execSltiu);
+  setExec(InstId::xori, &Core<URV>::execXori);
+  setExec(InstId::ori, &Core<URV>::execOri);
+  setExec(InstId::andi, &Core<URV>::execAndi);
+  setExec(InstId::slli, &Core<URV>::execSlli);
+  setExec(InstId::srli, &Core<URV>::execSrli);
+  setExec(InstId::srai, &Core<URV>::execSrai);
+  setExec(InstId::add, &Core<URV>::execAdd);
+  setExec(InstId::sub, &Core<URV>::execSub);
+  setExec(InstId::sll, &Core<URV>::execSll);
+  setExec(InstId::slt, &Core<URV>::execSlt);
+  setExec(InstId::sltu, &Core<URV>::execSltu);
+  setExec(InstId::xor_, &Core<URV>::execXor);
+  setExec(InstId::srl, &Core<URV>::execSrl);
+  setExec(InstId::sra, &Core<URV>::execSra);
+  setExec(InstId::or_, &Core<URV>::execOr);
+  setExec(InstId::and_, &Core<URV>::execAnd);
+  setExec(InstId::fence, &Core<URV>::execFence);
+  setExec(InstId::fencei, &Core<URV>::execFencei);
+  setExec(InstId::ecall, &Core<URV>::execEcall);
+  setExec(InstId::ebreak, &Core<URV>::execEbreak);
+  setExec(InstId::csrrw, &Core<URV>::execCsrrw);
+  setExec(InstId::csrrs, &Core<URV>::execCsrrs);
+  setExec(InstId::csrrc, &Core<URV>::execCsrrc);
+  setExec(InstId::csrrwi, &Core<URV>::execCsrrwi);
+  setExec(InstId::csrrsi, &Core<URV>::execCsrrsi);
+  setExec(InstId::csrrci, &Core<URV>::execCsrrci);
+  setExec(InstId::mret, &Core<URV>::execMret);
+  setExec(InstId::uret, &Core<URV>::execUret);
+  setExec(InstId::sret, &Core<URV>::execSret);
+  setExec(InstId::wfi, &Core<URV>::execWfi);
+
+  // rv64i
+  setExec(InstId::lwu, &Core<URV>::execLwu, rv64_);
+  setExec(InstId::ld, &Core<URV>::execLd, rv64_);
+  setExec(InstId::sd, &Core<URV>::execSd, rv64_);
+  setExec(InstId::addiw, &Core<URV>::execAddiw, rv64_);
+  setExec(InstId::slliw, &Core<URV>::execSlliw, rv64_);
+  setExec(InstId::srliw, &Core<URV>::execSrliw, rv64_);
+  setExec(InstId::sraiw, &Core<URV>::execSraiw, rv64_);
+  setExec(InstId::addw, &Core<URV>::execAddw, rv64_);
+  setExec(InstId::subw, &Core<URV>::execSubw, rv64_);
+  setExec(InstId::sllw, &Core<URV>::execSllw, rv64_);
+  setExec(InstId::srlw, &Core<URV>::execSrlw, rv64_);
+  setExec(InstId::sraw, &Core<URV>::execSraw, rv64_);
+
+  // Mul/div
+  setExec(InstId::mul, &Core<URV>::execMul, rvm_);
+  setExec(InstId::mulh, &Core<URV>::execMulh, rvm_);
+  setExec(InstId::mulhsu, &Core<URV>::execMulhsu, rvm_);
+  setExec(InstId::mulhu, &Core<URV>::execMulhu, rvm_);
+  setExec(InstId::div, &Core<URV>::execDiv, rvm_);
+  setExec(InstId::divu, &Core<URV>::execDivu, rvm_);
+  setExec(InstId::rem, &Core<URV>::execRem, rvm_);
+  setExec(InstId::remu, &Core<URV>::execRemu, rvm_);
+
+  // 64-bit mul/div
+  setExec(InstId::mulw, &Core<URV>::execMulw, rvm_ and rv64_);
+  setExec(InstId::divw, &Core<URV>::execDivw, rvm_ and rv64_);
+  setExec(InstId::divuw, &Core<URV>::execDivuw, rvm_ and rv64_);
+  setExec(InstId::remw, &Core<URV>::execRemw, rvm_ and rv64_);
+  setExec(InstId::remuw, &Core<URV>::execRemuw, rvm_ and rv64_);
+
+  // Atomic: amoand is not implemented
+  setExec(InstId::lr_w, &Core<URV>::execLr_w, rva_);
+  setExec(InstId::sc_w, &Core<URV>::execSc_w, rva_);
+  setExec(InstId::amoswap_w, &Core<URV>::execAmoswap_w, rva_);
+  setExec(InstId::amoadd_w, &Core<URV>::execAmoadd_w, rva_);
+  setExec(InstId::amoxor_w, &Core<URV>::execAmoxor_w, rva_);
+  setExec(InstId::amoand_w, &Core<URV>::execAmoand_w, rva_);
+  setExec(InstId::amoor_w, &Core<URV>::execAmoor_w, rva_);
+  setExec(InstId::amomin_w, &Core<URV>::execAmomin_w, rva_);
+  setExec(InstId::amomax_w, &Core<URV>::execAmomax_w, rva_);
+  setExec(InstId::amominu_w, &Core<URV>::execAmominu_w, rva_);
+  setExec(InstId::amomaxu_w, &Core<URV>::execAmomaxu_w, rva_);
+
+  // 64-bit atomic
+  setExec(InstId::lr_d, &Core<URV>::execLr_d, rva_ and rv64_);
+  setExec(InstId::sc_d, &Core<URV>::execSc_d, rva_ and rv64_);
+  setExec(InstId::amoswap_d, &Core<URV>::execAmoswap_d, rva_ and rv64_);
+  setExec(InstId::amoadd_d, &Core<URV>::execAmoadd_d, rva_ and rv64_);
+  setExec(InstId::amoxor_d, &Core<URV>::execAmoxor_d, rva_ and rv64_);
+  setExec(InstId::amoand_d, &Core<URV>::execAmoand_d, rva_ and rv64_);
+  setExec(InstId::amoor_d, &Core<URV>::execAmoor_d, rva_ and rv64_);
+  setExec(InstId::amomin_d, &Core<URV>::execAmomin_d, rva_ and rv64_);
+  setExec(InstId::amomax_d, &Core<URV>::execAmomax_d, rva_ and rv64_);
+  setExec(InstId::amominu_d, &Core<URV>::execAmominu_d, rva_ and rv64_);
+  setExec(InstId::amomaxu_d, &Core<URV>::execAmomaxu_d, rva_ and rv64_);
+
+  // rv32f
+  setExec(InstId::flw, &Core<URV>::execFlw, rvf_);
+  setExec(InstId::fsw, &Core<URV>::execFsw, rvf_);
+  setExec(InstId::fmadd_s, &Core<URV>::execFmadd_s, rvf_);
+  setExec(InstId::fmsub_s, &Core<URV>::execFmsub_s, rvf_);
+  setExec(InstId::fnmsub_s, &Core<URV>::execFnmsub_s, rvf_);
+  setExec(InstId::fnmadd_s, &Core<URV>::execFnmadd_s, rvf_);
+  setExec(InstId::fadd_s, &Core<URV>::execFadd_s, rvf_);
+  setExec(InstId::fsub_s, &Core<URV>::execFsub_s, rvf_);
+  setExec(InstId::fmul_s, &Core<URV>::execFmul_s, rvf_);
+  setExec(InstId::fdiv_s, &Core<URV>::execFdiv_s, rvf_);
+  setExec(InstId::fsqrt_s, &Core<URV>::execFsqrt_s, rvf_);
+  setExec(InstId::fsgnj_s, &Core<URV>::execFsgnj_s, rvf_);
+  setExec(InstId::fsgnjn_s, &Core<URV>::execFsgnjn_s, rvf_);
+  setExec(InstId::fsgnjx_s, &Core<URV>::execFsgnjx_s, rvf_);
+  setExec(InstId::fmin_s, &Core<URV>::execFmin_s, rvf_);
+  setExec(InstId::fmax_s, &Core<URV>::execFmax_s, rvf_);
+  setExec(InstId::fcvt_w_s, &Core<URV>::execFcvt_w_s, rvf_);
+  setExec(InstId::fcvt_wu_s, &Core<URV>::execFcvt_wu_s, rvf_);
+  setExec(InstId::fmv_x_w, &Core<URV>::execFmv_x_w, rvf_);
+  setExec(InstId::feq_s, &Core<URV>::execFeq_s, rvf_);
+  setExec(InstId::flt_s, &Core<URV>::execFlt_s, rvf_);
+  setExec(InstId::fle_s, &Core<URV>::execFle_s, rvf_);
+  setExec(InstId::fclass_s, &Core<URV>::execFclass_s, rvf_);
+  setExec(InstId::fcvt_s_w, &Core<URV>::execFcvt_s_w, rvf_);
+  setExec(InstId::fcvt_s_wu, &Core<URV>::execFcvt_s_wu, rvf_);
+  setExec(InstId::fmv_w_x, &Core<URV>::execFmv_w_x, rvf_);
+
+  // rv64f
+  setExec(InstId::fcvt_l_s, &Core<URV>::execFcvt_l_s, rvf_ and rv64_);
+  setExec(InstId::fcvt_lu_s, &Core<URV>::execFcvt_lu_s, rvf_ and rv64_);
+  setExec(InstId::fcvt_s_l, &Core<URV>::execFcvt_s_l, rvf_ and rv64_);
+  setExec(InstId::fcvt_s_lu, &Core<URV>::execFcvt_s_lu, rvf_ and rv64_);
+
+  // rv32d
+  setExec(InstId::fld, &Core<URV>::execFld, rvd_);
+  setExec(InstId::fsd, &Core<URV>::execFsd, rvd_);
+  setExec(InstId::fmadd_d, &Core<URV>::execFmadd_d, rvd_);
+  setExec(InstId::fmsub_d, &Core<URV>::execFmsub_d, rvd_);
+  setExec(InstId::fnmsub_d, &Core<URV>::execFnmsub_d, rvd_);
+  setExec(InstId::fnmadd_d, &Core<URV>::execFnmadd_d, rvd_);
+  setExec(InstId::fadd_d, &Core<URV>::execFadd_d, rvd_);
+  setExec(InstId::fsub_d, &Core<URV>::execFsub_d, rvd_);
+  setExec(InstId::fmul_d, &Core<URV>::execFmul_d, rvd_);
+  setExec(InstId::fdiv_d, &Core<URV>::execFdiv_d, rvd_);
+  setExec(InstId::fsqrt_d, &Core<URV>::execFsqrt_d, rvd_);
+  setExec(InstId::fsgnj_d, &Core<URV>::execFsgnj_d, rvd_);
+  setExec(InstId::fsgnjn_d, &Core<URV>::execFsgnjn_d, rvd_);
+  setExec(InstId::fsgnjx_d, &Core<URV>::execFsgnjx_d, rvd_);
+  setExec(InstId::fmin_d, &Core<URV>::execFmin_d, rvd_);
+  setExec(InstId::fmax_d, &Core<URV>::execFmax_d, rvd_);
+  setExec(InstId::fcvt_s_d, &Core<URV>::execFcvt_s_d, rvd_);
+  setExec(InstId::fcvt_d_s, &Core<URV>::execFcvt_d_s, rvd_);
+  setExec(InstId::feq_d, &Core<URV>::execFeq_d, rvd_);
+  setExec(InstId::flt_d, &Core<URV>::execFlt_d, rvd_);
+  setExec(InstId::fle_d, &Core<URV>::execFle_d, rvd_);
+  setExec(InstId::fclass_d, &Core<URV>::execFclass_d, rvd_);
+  setExec(InstId::fcvt_w_d, &Core<URV>::execFcvt_w_d, rvd_);
+  setExec(InstId::fcvt_wu_d, &Core<URV>::execFcvt_wu_d, rvd_);
+  setExec(InstId::fcvt_d_w, &Core<URV>::execFcvt_d_w, rvd_);
+  setExec(InstId::fcvt_d_wu, &Core<URV>::execFcvt_d_wu, rvd_);
+
+  // rv64d
+  setExec(InstId::fcvt_l_d, &Core<URV>::execFcvt_l_d, rvd_ and rv64_);
+  setExec(InstId::fcvt_lu_d, &Core<URV>::execFcvt_lu_d, rvd_ and rv64_);
+  setExec(InstId::fmv_x_d, &Core<URV>::execFmv_x_d, rvd_ and rv64_);
+  setExec(InstId::fcvt_d_l, &Core<URV>::execFcvt_d_l, rvd_ and rv64_);
+  setExec(InstId::fcvt_d_lu, &Core<URV>::execFcvt_d_lu, rvd_ and rv64_);
+  setExec(InstId::fmv_d_x, &Core<URV>::execFmv_d_x, rvd_ and rv64_);
+
+  // Vector
+  setExec(InstId::vsetvli, &Core<URV>::execVsetvli, rvv_);
+  setExec(InstId::vsetivli, &Core<URV>::execVsetivli, rvv_);
+  setExec(InstId::vsetvl, &Core<URV>::execVsetvl, rvv_);
+  setExec(InstId::vle8_v, &Core<URV>::execVle8_v, rvv_);
+  setExec(InstId::vle16_v, &Core<URV>::execVle16_v, rvv_);
+  setExec(InstId::vle32_v, &Core<URV>::execVle32_v, rvv_);
+  setExec(InstId::vle64_v, &Core<URV>::execVle64_v, rvv_);
+  setExec(InstId::vse8_v, &Core<URV>::execVse8_v, rvv_);
+  setExec(InstId::vse16_v, &Core<URV>::execVse16_v, rvv_);
+  setExec(InstId::vse32_v, &Core<URV>::execVse32_v, rvv_);
+  setExec(InstId::vse64_v, &Core<URV>::execVse64_v, rvv_);
+  setExec(InstId::vadd_vv, &Core<URV>::execVadd_vv, rvv_);
+  setExec(InstId::vadd_vx, &Core<URV>::execVadd_vx, rvv_);
+  setExec(InstId::vadd_vi, &Core<URV>::execVadd_vi, rvv_);
+  setExec(InstId::vsub_vv, &Core<URV>::execVsub_vv, rvv_);
+  setExec(InstId::vsub_vx, &Core<URV>::execVsub_vx, rvv_);
+  setExec(InstId::vrsub_vx, &Core<URV>::execVrsub_vx, rvv_);
+  setExec(InstId::vrsub_vi, &Core<URV>::execVrsub_vi, rvv_);
+  setExec(InstId::vminu_vv, &Core<URV>::execVminu_vv, rvv_);
+  setExec(InstId::vminu_vx, &Core<URV>::execVminu_vx, rvv_);
+  setExec(InstId::vmin_vv, &Core<URV>::execVmin_vv, rvv_);
+  setExec(InstId::vmin_vx, &Core<URV>::execVmin_vx, rvv_);
+  setExec(InstId::vmaxu_vv, &Core<URV>::execVmaxu_vv, rvv_);
+  setExec(InstId::vmaxu_vx, &Core<URV>::execVmaxu_vx, rvv_);
+  setExec(InstId::vmax_vv, &Core<URV>::execVmax_vv, rvv_);
+  setExec(InstId::vmax_vx, &Core<URV>::execVmax_vx, rvv_);
+  setExec(InstId::vand_vv, &Core<URV>::execVand_vv, rvv_);
+  setExec(InstId::vand_vx, &Core<URV>::execVand_vx, rvv_);
+  setExec(InstId::vand_vi, &Core<URV>::execVand_vi, rvv_);
+  setExec(InstId::vor_vv, &Core<URV>::execVor_vv, rvv_);
+  setExec(InstId::vor_vx, &Core<URV>::execVor_vx, rvv_);
+  setExec(InstId::vor_vi, &Core<URV>::execVor_vi, rvv_);
+  setExec(InstId::vxor_vv, &Core<URV>::execVxor_vv, rvv_);
+  setExec(InstId::vxor_vx, &Core<URV>::execVxor_vx, rvv_);
+  setExec(InstId::vxor_vi, &Core<URV>::execVxor_vi, rvv_);
+  setExec(InstId::vsll_vv, &Core<URV>::execVsll_vv, rvv_);
+  setExec(InstId::vsll_vx, &Core<URV>::execVsll_vx, rvv_);
+  setExec(InstId::vsll_vi, &Core<URV>::execVsll_vi, rvv_);
+  setExec(InstId::vsrl_vv, &Core<URV>::execVsrl_vv, rvv_);
+  setExec(InstId::vsrl_vx, &Core<URV>::execVsrl_vx, rvv_);
+  setExec(InstId::vsrl_vi, &Core<URV>::execVsrl_vi, rvv_);
+  setExec(InstId::vsra_vv, &Core<URV>::execVsra_vv, rvv_);
+  setExec(InstId::vsra_vx, &Core<URV>::execVsra_vx, rvv_);
+  setExec(InstId::vsra_vi, &Core<URV>::execVsra_vi, rvv_);
+  setExec(InstId::vmul_vv, &Core<URV>::execVmul_vv, rvv_);
+  setExec(InstId::vmul_vx, &Core<URV>::execVmul_vx, rvv_);
+  setExec(InstId::vmv_v_v, &Core<URV>::execVmv_v_v, rvv_);
+  setExec(InstId::vmv_v_x, &Core<URV>::execVmv_v_x, rvv_);
+  setExec(InstId::vmv_v_i, &Core<URV>::execVmv_v_i, rvv_);
+  setExec(InstId::vmv_x_s, &Core<URV>::execVmv_x_s, rvv_);
+  setExec(InstId::vmv_s_x, &Core<URV>::execVmv_s_x, rvv_);
+  setExec(InstId::vredsum_vs, &Core<URV>::execVredsum_vs, rvv_);
+  setExec(InstId::vredand_vs, &Core<URV>::execVredand_vs, rvv_);
+  setExec(InstId::vredor_vs, &Core<URV>::execVredor_vs, rvv_);
+  setExec(InstId::vredxor_vs, &Core<URV>::execVredxor_vs, rvv_);
+  setExec(InstId::vredminu_vs, &Core<URV>::execVredminu_vs, rvv_);
+  setExec(InstId::vredmin_vs, &Core<URV>::execVredmin_vs, rvv_);
+  setExec(InstId::vredmaxu_vs, &Core<URV>::execVredmaxu_vs, rvv_);
+  setExec(InstId::vredmax_vs, &Core<URV>::execVredmax_vs, rvv_);
+  setExec(InstId::vfadd_vv, &Core<URV>::execVfadd_vv, rvv_);
+  setExec(InstId::vfadd_vf, &Core<URV>::execVfadd_vf, rvv_);
+  setExec(InstId::vfsub_vv, &Core<URV>::execVfsub_vv, rvv_);
+  setExec(InstId::vfsub_vf, &Core<URV>::execVfsub_vf, rvv_);
+  setExec(InstId::vfrsub_vf, &Core<URV>::execVfrsub_vf, rvv_);
+  setExec(InstId::vfmul_vv, &Core<URV>::execVfmul_vv, rvv_);
+  setExec(InstId::vfmul_vf, &Core<URV>::execVfmul_vf, rvv_);
+  setExec(InstId::vfdiv_vv, &Core<URV>::execVfdiv_vv, rvv_);
+  setExec(InstId::vfdiv_vf, &Core<URV>::execVfdiv_vf, rvv_);
+  setExec(InstId::vfrdiv_vf, &Core<URV>::execVfrdiv_vf, rvv_);
+  setExec(InstId::vfmacc_vv, &Core<URV>::execVfmacc_vv, rvv_);
+  setExec(InstId::vfmacc_vf, &Core<URV>::execVfmacc_vf, rvv_);
+  setExec(InstId::vfredusum_vs, &Core<URV>::execVfredusum_vs, rvv_);
+  setExec(InstId::vfredosum_vs, &Core<URV>::execVfredosum_vs, rvv_);
+  setExec(InstId::vfmv_f_s, &Core<URV>::execVfmv_f_s, rvv_);
+  setExec(InstId::vfmv_s_f, &Core<URV>::execVfmv_s_f, rvv_);
+  setExec(InstId::vfmv_v_f, &Core<URV>::execVfmv_v_f, rvv_);
+
+  // Bit manipulation. Instructions of the word (w/uw) forms and the
+  // rv64 encodings of zext.h and rev8 exist only in rv64.
+  setExec(InstId::sh1add, &Core<URV>::execSh1add, rvb_);
+  setExec(InstId::sh2add, &Core<URV>::execSh2add, rvb_);
+  setExec(InstId::sh3add, &Core<URV>::execSh3add, rvb_);
+  setExec(InstId::add_uw, &Core<URV>::execAdd_uw, rvb_ and rv64_);
+  setExec(InstId::sh1add_uw, &Core<URV>::execSh1add_uw, rvb_ and rv64_);
+  setExec(InstId::sh2add_uw, &Core<URV>::execSh2add_uw, rvb_ and rv64_);
+  setExec(InstId::sh3add_uw, &Core<URV>::execSh3add_uw, rvb_ and rv64_);
+  setExec(InstId::slli_uw, &Core<URV>::execSlli_uw, rvb_ and rv64_);
+  setExec(InstId::andn, &Core<URV>::execAndn, rvb_);
+  setExec(InstId::orn, &Core<URV>::execOrn, rvb_);
+  setExec(InstId::xnor, &Core<URV>::execXnor, rvb_);
+  setExec(InstId::clz, &Core<URV>::execClz, rvb_);
+  setExec(InstId::ctz, &Core<URV>::execCtz, rvb_);
+  setExec(InstId::cpop, &Core<URV>::execCpop, rvb_);
+  setExec(InstId::clzw, &Core<URV>::execClzw, rvb_ and rv64_);
+  setExec(InstId::ctzw, &Core<URV>::execCtzw, rvb_ and rv64_);
+  setExec(InstId::cpopw, &Core<URV>::execCpopw, rvb_ and rv64_);
+  setExec(InstId::max, &Core<URV>::execMax, rvb_);
+  setExec(InstId::maxu, &Core<URV>::execMaxu, rvb_);
+  setExec(InstId::min, &Core<URV>::execMin, rvb_);
+  setExec(InstId::minu, &Core<URV>::execMinu, rvb_);
+  setExec(InstId::sext_b, &Core<URV>::execSext_b, rvb_);
+  setExec(InstId::sext_h, &Core<URV>::execSext_h, rvb_);
+  setExec(InstId::zext_h, &Core<URV>::execZext_h, rvb_ and not rv64_);
+  setExec(InstId::zext_h_64, &Core<URV>::execZext_h_64, rvb_ and rv64_);
+  setExec(InstId::rol, &Core<URV>::execRol, rvb_);
+  setExec(InstId::ror, &Core<URV>::execRor, rvb_);
+  setExec(InstId::rori, &Core<URV>::execRori, rvb_);
+  setExec(InstId::rolw, &Core<URV>::execRolw, rvb_ and rv64_);
+  setExec(InstId::rorw, &Core<URV>::execRorw, rvb_ and rv64_);
+  setExec(InstId::roriw, &Core<URV>::execRoriw, rvb_ and rv64_);
+  setExec(InstId::orc_b, &Core<URV>::execOrc_b, rvb_);
+  setExec(InstId::rev8, &Core<URV>::execRev8, rvb_ and not rv64_);
+  setExec(InstId::rev8_64, &Core<URV>::execRev8_64, rvb_ and rv64_);
+  setExec(InstId::bclr, &Core<URV>::execBclr, rvb_);
+  setExec(InstId::bclri, &Core<URV>::execBclri, rvb_);
+  setExec(InstId::bext, &Core<URV>::execBext, rvb_);
+  setExec(InstId::bexti, &Core<URV>::execBexti, rvb_);
+  setExec(InstId::binv, &Core<URV>::execBinv, rvb_);
+  setExec(InstId::binvi, &Core<URV>::execBinvi, rvb_);
+  setExec(InstId::bset, &Core<URV>::execBset, rvb_);
+  setExec(InstId::bseti, &Core<URV>::execBseti, rvb_);
+
+  // Compressed. Ids c.jal and c.addiw share a value and so do c.fswsp
+  // and c.sdsp: resolve those using the base (rv32 or rv64).
+  setExec(InstId::c_addi4spn, &Core<URV>::execAddi);
+  setExec(InstId::c_fld,      &Core<URV>::execFld);
+  setExec(InstId::c_lw,       &Core<URV>::execLw);
+  setExec(InstId::c_flw,      &Core<URV>::execFlw);
+  setExec(InstId::c_ld,       &Core<URV>::execLd);
+  setExec(InstId::c_fsd,      &Core<URV>::execFsd);
+  setExec(InstId::c_sw,       &Core<URV>::execSw);
+  setExec(InstId::c_fsw,      &Core<URV>::execFsw);
+  setExec(InstId::c_sd,       &Core<URV>::execSd);
+  setExec(InstId::c_addi,     &Core<URV>::execAddi);
+  setExec(InstId::c_jal,      rv64_? &Core<URV>::execAddiw : &Core<URV>::execJal);
+  setExec(InstId::c_li,       &Core<URV>::execAddi);
+  setExec(InstId::c_addi16sp, &Core<URV>::execAddi);
+  setExec(InstId::c_lui,      &Core<URV>::execLui);
+  setExec(InstId::c_srli,     &Core<URV>::execSrli);
+  setExec(InstId::c_srai,     &Core<URV>::execSrai);
+  setExec(InstId::c_andi,     &Core<URV>::execAndi);
+  setExec(InstId::c_sub,      &Core<URV>::execSub);
+  setExec(InstId::c_xor,      &Core<URV>::execXor);
+  setExec(InstId::c_or,       &Core<URV>::execOr);
+  setExec(InstId::c_and,      &Core<URV>::execAnd);
+  setExec(InstId::c_subw,     &Core<URV>::execSubw);
+  setExec(InstId::c_addw,     &Core<URV>::execAddw);
+  setExec(InstId::c_j,        &Core<URV>::execJal);
+  setExec(InstId::c_beqz,     &Core<URV>::execBeq);
+  setExec(InstId::c_bnez,     &Core<URV>::execBne);
+  setExec(InstId::c_slli,     &Core<URV>::execSlli);
+  setExec(InstId::c_fldsp,    &Core<URV>::execFld);
+  setExec(InstId::c_lwsp,     &Core<URV>::execLw);
+  setExec(InstId::c_flwsp,    &Core<URV>::execFlw);
+  setExec(InstId::c_ldsp,     &Core<URV>::execLd);
+  setExec(InstId::c_jr,       &Core<URV>::execJalr);
+  setExec(InstId::c_mv,       &Core<URV>::execAdd);
+  setExec(InstId::c_ebreak,   &Core<URV>::execEbreak);
+  setExec(InstId::c_jalr,     &Core<URV>::execJalr);
+  setExec(InstId::c_add,      &Core<URV>::execAdd);
+  setExec(InstId::c_fsdsp,    &Core<URV>::execFsd);
+  setExec(InstId::c_swsp,     &Core<URV>::execSw);
+  setExec(InstId::c_fswsp,    &Core<URV>::execFsw);
+  setExec(InstId::c_sdsp,     &Core<URV>::execSd);
+
+  compressedTable_.resize(size_t(1) << 16);
+
+  for (size_t code = 0; code < compressedTable_.size(); ++code)
+    {
+      Compressed16& entry = compressedTable_.at(code);
+      entry = Compressed16();
+
+      uint32_t code32 = 0;
+      if (expandCompressed(uint16_t(code), code32))
+	entry.code32 = code32;
+
+      // With the c extension disabled, every 16-bit code is illegal.
+      if (not rvc_)
+	continue;
+
+      uint32_t op0 = 0, op1 = 0;
+      int32_t op2 = 0;
+      const InstInfo& info = decodeCompressed(code, op0, op1, op2);
+      entry.id = uint16_t(info.instId());
+      entry.op0 = uint8_t(op0);
+      entry.op1 = op1;
+      entry.op2 = op2;
     }
-  if (f7 == 0x50)
-    {
-      if (f3 == 0)  return instTable_.getInstInfo(InstId::fle_s);
-      if (f3 == 1)  return instTable_.getInstInfo(InstId::flt_s);
-      if (f3 == 2)  return instTable_.getInstInfo(InstId::feq_s);
-      return instTable_.getInstInfo(InstId::illegal);
-    }
-  if (f7 == 0x60)
-    {
-      if (op2 == 0) return instTable_.getInstInfo(InstId::fcvt_w_s);
-      if (op2 == 1) return instTable_.getInstInfo(InstId::fcvt_wu_s);
-      if (op2 == 2) return instTable_.getInstInfo(InstId::fcvt_l_s);
-      if (op2 == 3) return instTable_.getInstInfo(InstId::fcvt_lu_s);
-      return instTable_.getInstInfo(InstId::illegal);
-    }
-  if (f7 == 0x68)
-    {
-      if (op2 == 0) return instTable_.getInstInfo(InstId::fcvt_s_w);
-      if (op2 == 1) return instTable_.getInstInfo(InstId::fcvt_s_wu);
-      if (op2 == 2) return instTable_.getInstInfo(InstId::fcvt_s_l);
-      if (op2 == 3) return instTable_.getInstInfo(InstId::fcvt_s_lu);
-      return instTable_.getInstInfo(InstId::illegal);
-    }
-  if (f7 == 0x70)
+}
+
+
+template <typename URV>
+const InstInfo&
+Core<URV>::decode(uint32_t inst, uint32_t& op0, uint32_t& op1, int32_t& op2)
+{
+  if (isCompressedInst(inst))
     {
-      if (op2 == 0)
-	{
-	  if (f3 == 0) return instTable_.getInstInfo(InstId::fmv_x_w);
-	  if (f3 == 1) return instTable_.getInstInfo(InstId::fclass_s);
-	}
+      if (not isRvc())
+	inst = 0; // All zeros: illegal 16-bit instruction.
+      return decode16(inst, op0, op1, op2);
     }
-  if (f7 == 0x74)
+
+  const Decoded32& entry = decode32(inst);
+  op0 = entry.op0; op1 = entry.op1; op2 = entry.op2;
+
+  // Instructions of disabled extensions are illegal.
+  if (execTable_[entry.id] == &Core<URV>::execIllegal)
+    return instTable_.getInstInfo(InstId::illegal);
+
+  return instTable_.getInstInfo(InstId(entry.id));
+}
+
+
+std::string
+roundingModeString(RoundingMode mode)
+{
+  switch (mode)
     {
-      if (op2 == 0)
-	if (f3 == 0) return instTable_.getInstInfo(InstId::fmv_w_x);
+    case RoundingMode::NearestEven: return "rne";
+    case RoundingMode::Zero:        return "rtz";
+    case RoundingMode::Down:        return "rdn";
+    case RoundingMode::Up:          return "rup";
+    case RoundingMode::NearestMax:  return "rmm";
+    case RoundingMode::Invalid1:    return "inv1";
+    case RoundingMode::Invalid2:    return "inv2";
+    case RoundingMode::Dynamic:     return "dyn";
+    default:                        return "inv";
     }
-  return instTable_.getInstInfo(InstId::illegal);
+  return "inv";
 }
 
 
 template <typename URV>
-const InstInfo&
-Core<URV>::decode16(uint32_t inst, uint32_t& op0, uint32_t& op1, int32_t& op2)
+void
+Core<URV>::printInstRdRs1Rs2(std::ostream& stream, const char* inst,
+			     unsigned rd, unsigned rs1, unsigned rs2)
 {
-  inst = (inst << 16) >> 16;  // Clear top 16 bits.
+  // Print instruction in a 9 character field.
+  stream << std::left << std::setw(9) << inst;
 
-  uint16_t quadrant = inst & 0x3;
-  uint16_t funct3 =  inst >> 13;    // Bits 15 14 and 13
+  stream << intRegs_.regName(rd, abiNames_) << ", "
+	 << intRegs_.regName(rs1, abiNames_) << ", "
+	 << intRegs_.regName(rs2, abiNames_);
+}
 
-  op0 = 0; op1 = 0; op2 = 0;
 
-  if (quadrant == 0)
-    {
-      if (funct3 == 0)    // illegal, c.addi4spn
-	{
-	  if (inst == 0)
-	    return instTable_.getInstInfo(InstId::illegal);
-	  CiwFormInst ciwf(inst);
-	  unsigned immed = ciwf.immed();
-	  if (immed == 0)
-	    return instTable_.getInstInfo(InstId::illegal);
-	  op0 = 8 + ciwf.bits.rdp; op1 = RegSp; op2 = immed;
-	  return instTable_.getInstInfo(InstId::c_addi4spn);
-	}
+template <typename URV>
+void
+Core<URV>::printInstLdSt(std::ostream& stream, const char* inst,
+			 unsigned rd, unsigned rs1, int32_t imm)
+{
+  // Print instruction in a 8 character field.
+  stream << std::left << std::setw(8) << inst << ' ';
 
-      if (funct3 == 1) // c.fld c.lq
-	{
-	  if (not isRvd())
-	    return instTable_.getInstInfo(InstId::illegal);
-	  ClFormInst clf(inst);
-	  op0 = 8+clf.bits.rdp; op1 = 8+clf.bits.rs1p; op2 = clf.ldImmed();
-	  return instTable_.getInstInfo(InstId::c_fld);
-	}
+  const char* sign = imm < 0? "-" : "";
+  if (imm < 0)
+    imm = -imm;
 
-      if (funct3 == 2) // c.lw
-	{
-	  ClFormInst clf(inst);
-	  op0 = 8+clf.bits.rdp; op1 = 8+clf.bits.rs1p; op2 = clf.lwImmed();
-	  return instTable_.getInstInfo(InstId::c_lw);
-	}
+  // Keep least sig 12 bits.
+  imm = imm & 0xfff;
 
-      if (funct3 == 3) // c.flw, c.ld
-	{
-	  ClFormInst clf(inst);
-	  if (isRv64())
-	    {
-	      op0 = 8+clf.bits.rdp; op1 = 8+clf.bits.rs1p; op2 = clf.ldImmed();
-	      return instTable_.getInstInfo(InstId::c_ld);
-	    }
+  stream << intRegs_.regName(rd, abiNames_) << ", " << sign << "0x"
+	 << std::hex << imm << "(" << intRegs_.regName(rs1, abiNames_) << ")";
+}
 
-	  // c.flw
-	  if (isRvf())
-	    {
-	      op0 = 8+clf.bits.rdp; op1 = 8+clf.bits.rs1p;
-	      op2 = clf.lwImmed();
-	      return instTable_.getInstInfo(InstId::c_flw);
-	    }
-	  return instTable_.getInstInfo(InstId::illegal);
-	}
 
-      if (funct3 == 6)  // c.sw
-	{
-	  CsFormInst cs(inst);
-	  op0 = 8+cs.bits.rs1p; op1 = 8+cs.bits.rs2p; op2 = cs.swImmed();
-	  return instTable_.getInstInfo(InstId::c_sw);
-	}
+template <typename URV>
+void
+Core<URV>::printInstFpLdSt(std::ostream& stream, const char* inst,
+			   unsigned rd, unsigned rs1, int32_t imm)
+{
+  // Print instruction in a 8 character field.
+  stream << std::left << std::setw(8) << inst << ' ';
 
-      if (funct3 == 7) // c.fsw, c.sd
-	{
-	  CsFormInst cs(inst);  // Double check this
-	  if (not isRv64())
-	    {
-	      if (isRvf())
-		{
-		  op0=8+cs.bits.rs1p; op1=8+cs.bits.rs2p; op2 = cs.swImmed();
-		  return instTable_.getInstInfo(InstId::c_fsw);
-		}
-	      return instTable_.getInstInfo(InstId::illegal);
-	    }
-	  op0=8+cs.bits.rs1p; op1=8+cs.bits.rs2p; op2 = cs.sdImmed();
-	  return instTable_.getInstInfo(InstId::c_sd);
-	}
+  const char* sign = imm < 0? "-" : "";
+  if (imm < 0)
+    imm = -imm;
 
-      // funct3 is 1 (c.fld c.lq), or 4 (reserved), or 5 (c.fsd c.sq)
-      return instTable_.getInstInfo(InstId::illegal);
-    }
+  // Keep least sig 12 bits.
+  imm = imm & 0xfff;
 
-  if (quadrant == 1)
-    {
-      if (funct3 == 0)  // c.nop, c.addi
-	{
-	  CiFormInst cif(inst);
-	  op0 = cif.bits.rd; op1 = cif.bits.rd; op2 = cif.addiImmed();
-	  return instTable_.getInstInfo(InstId::c_addi);
-	}
-	  
-      if (funct3 == 1)  // c.jal,  in rv64 and rv128 this is c.addiw
-	{
-	  if (isRv64())
-	    {
-	      CiFormInst cif(inst);
-	      if (cif.bits.rd == 0)
-		return instTable_.getInstInfo(InstId::illegal);
-	      else
-		return instTable_.getInstInfo(InstId::c_addiw);
-	    }
-	  else
-	    {
-	      CjFormInst cjf(inst);
-	      op0 = RegRa; op1 = cjf.immed(); op2 = 0;
-	      return instTable_.getInstInfo(InstId::c_jal);
-	    }
-	}
+  stream << "f" << rd << ", " << sign << "0x" << std::hex << imm
+	 << "(" << intRegs_.regName(rs1, abiNames_) << ")";
+}
 
-      if (funct3 == 2)  // c.li
-	{
-	  CiFormInst cif(inst);
-	  op0 = cif.bits.rd; op1 = RegX0; op2 = cif.addiImmed();
-	  return instTable_.getInstInfo(InstId::c_li);
-	}
 
-      if (funct3 == 3)  // c.addi16sp, c.lui
-	{
-	  CiFormInst cif(inst);
-	  int immed16 = cif.addi16spImmed();
-	  if (immed16 == 0)
-	    return instTable_.getInstInfo(InstId::illegal);
-	  if (cif.bits.rd == RegSp)  // c.addi16sp
-	    {
-	      op0 = cif.bits.rd; op1 = cif.bits.rd; op2 = immed16;
-	      return instTable_.getInstInfo(InstId::c_addi16sp);
-	    }
-	  op0 = cif.bits.rd; op1 = cif.luiImmed(); op2 = 0;
-	  return instTable_.getInstInfo(InstId::c_lui);
-	}
+template <typename URV>
+void
+Core<URV>::printInstShiftImm(std::ostream& stream, const char* inst,
+			     unsigned rs1, unsigned rs2, uint32_t imm)
+{
+  // Print instruction in a 8 character field.
+  stream << std::left << std::setw(8) << inst << ' ';
 
-      // c.srli c.srli64 c.srai c.srai64 c.andi c.sub c.xor c.and
-      // c.subw c.addw
-      if (funct3 == 4)
-	{
-	  CaiFormInst caf(inst);  // compressed and immediate form
-	  int immed = caf.andiImmed();
-	  unsigned rd = 8 + caf.bits.rdp;
-	  unsigned f2 = caf.bits.funct2;
-	  if (f2 == 0) // srli64, srli
-	    {
-	      if (caf.bits.ic5 != 0 and not isRv64())
-		return instTable_.getInstInfo(InstId::illegal);
-	      op0 = rd; op1 = rd; op2 = caf.shiftImmed();
-	      return instTable_.getInstInfo(InstId::c_srli);
-	    }
-	  if (f2 == 1)  // srai64, srai
-	    {
-	      if (caf.bits.ic5 != 0 and not isRv64())
-		return instTable_.getInstInfo(InstId::illegal);
-	      op0 = rd; op1 = rd; op2 = caf.shiftImmed();
-	      return instTable_.getInstInfo(InstId::c_srai);
-	    }
-	  if (f2 == 2)  // c.andi
-	    {
-	      op0 = rd; op1 = rd; op2 = immed;
-	      return instTable_.getInstInfo(InstId::c_andi);
-	    }
+  if constexpr (sizeof(URV) == 4)
+    imm = imm & 0x1f;
+  else
+    imm = imm & 0x3f;
 
-	  // f2 == 3: c.sub c.xor c.or c.subw c.addw
-	  unsigned rs2p = (immed & 0x7); // Lowest 3 bits of immed
-	  unsigned rs2 = 8 + rs2p;
-	  unsigned imm34 = (immed >> 3) & 3; // Bits 3 and 4 of immed
-	  op0 = rd; op1 = rd; op2 = rs2;
-	  if ((immed & 0x20) == 0)  // Bit 5 of immed
-	    {
-	      if (imm34 == 0) return instTable_.getInstInfo(InstId::c_sub);
-	      if (imm34 == 1) return instTable_.getInstInfo(InstId::c_xor);
-	      if (imm34 == 2) return instTable_.getInstInfo(InstId::c_or);
-	      return instTable_.getInstInfo(InstId::c_and);
-	    }
-	  // Bit 5 of immed is 1
-	  if (not isRv64())
-	    return instTable_.getInstInfo(InstId::illegal);
-	  if (imm34 == 0) return instTable_.getInstInfo(InstId::c_subw);
-	  if (imm34 == 1) return instTable_.getInstInfo(InstId::c_addw);
-	  if (imm34 == 2) return instTable_.getInstInfo(InstId::illegal);
-	  return instTable_.getInstInfo(InstId::illegal);
-	}
+  stream << intRegs_.regName(rs1, abiNames_) << ", "
+	 << intRegs_.regName(rs2, abiNames_) << ", 0x"
+	 << std::hex << imm;
+}
 
-      if (funct3 == 5)  // c.j
-	{
-	  CjFormInst cjf(inst);
-	  op0 = RegX0; op1 = cjf.immed(); op2 = 0;
-	  return instTable_.getInstInfo(InstId::c_j);
-	}
-	  
-      if (funct3 == 6) // c.beqz
-	{
-	  CbFormInst cbf(inst);
-	  op0=8+cbf.bits.rs1p; op1=RegX0; op2=cbf.immed();
-	  return instTable_.getInstInfo(InstId::c_beqz);
-	}
-      
-      // funct3 == 7: c.bnez
-      CbFormInst cbf(inst);
-      op0 = 8+cbf.bits.rs1p; op1=RegX0; op2=cbf.immed();
-      return instTable_.getInstInfo(InstId::c_bnez);
-    }
 
-  if (quadrant == 2)
-    {
-      if (funct3 == 0)  // c.slli, c.slli64
-	{
-	  CiFormInst cif(inst);
-	  unsigned immed = unsigned(cif.slliImmed());
-	  if (cif.bits.ic5 != 0 and not isRv64())
-	    return instTable_.getInstInfo(InstId::illegal);
-	  op0 = cif.bits.rd; op1 = cif.bits.rd; op2 = immed;
-	  return instTable_.getInstInfo(InstId::c_slli);
-	}
+template <typename URV>
+void
+Core<URV>::printInstRegRegImm12(std::ostream& stream, const char* inst,
+				unsigned rs1, unsigned rs2, int32_t imm)
+{
+  // Print instruction in a 8 character field.
+  stream << std::left << std::setw(8) << inst << ' ';
 
-      if (funct3 == 1)  // c.fldsp c.lqsp
-	{
-	  if (isRvd())
-	    {
-	      CiFormInst cif(inst);
-	      op0 = cif.bits.rd; op1 = RegSp, op2 = cif.ldspImmed();
-	      return instTable_.getInstInfo(InstId::c_fldsp);
-	    }
-	  return instTable_.getInstInfo(InstId::illegal);
-	}
+  stream << intRegs_.regName(rs1, abiNames_) << ", "
+	 << intRegs_.regName(rs2, abiNames_) << ", ";
 
-      if (funct3 == 2) // c.lwsp
-	{
-	  CiFormInst cif(inst);
-	  unsigned rd = cif.bits.rd;
-	  // rd == 0 is legal per Andrew Watterman
-	  op0 = rd; op1 = RegSp; op2 = cif.lwspImmed();
-	  return instTable_.getInstInfo(InstId::c_lwsp);
-	}
+  if (imm < 0)
+    stream << "-0x" << std::hex << ((-imm) & 0xfff);
+  else
+    stream << "0x" << std::hex << (imm & 0xfff);
+}
 
-      else  if (funct3 == 3)  // c.ldsp  c.flwsp
-	{
-	  CiFormInst cif(inst);
-	  unsigned rd = cif.bits.rd;
-	  if (isRv64())
-	    {
-	      op0 = rd; op1 = RegSp; op2 = cif.ldspImmed();
-	      return instTable_.getInstInfo(InstId::c_ldsp);
-	    }
-	  if (isRvf())
-	    {
-	      op0 = rd; op1 = RegSp; op2 = cif.lwspImmed();
-	      return instTable_.getInstInfo(InstId::c_lwsp);
-	    }
-	  return instTable_.getInstInfo(InstId::illegal);
-	}
 
-      if (funct3 == 4) // c.jr c.mv c.ebreak c.jalr c.add
-	{
-	  CiFormInst cif(inst);
-	  unsigned immed = cif.addiImmed();
-	  unsigned rd = cif.bits.rd;
-	  unsigned rs2 = immed & 0x1f;
-	  if ((immed & 0x20) == 0)  // c.jr or c.mv
-	    {
-	      if (rs2 == RegX0)
-		{
-		  if (rd == RegX0)
-		    return instTable_.getInstInfo(InstId::illegal);
-		  op0 = RegX0; op1 = rd; op2 = 0;
-		  return instTable_.getInstInfo(InstId::c_jr);
-		}
-	      op0 = rd; op1 = RegX0; op2 = rs2;
-	      return instTable_.getInstInfo(InstId::c_mv);
-	    }
-	  else  // c.ebreak, c.jalr or c.add 
-	    {
-	      if (rs2 == RegX0)
-		{
-		  if (rd == RegX0)
-		    return instTable_.getInstInfo(InstId::c_ebreak);
-		  op0 = RegRa; op1 = rd; op2 = 0;
-		  return instTable_.getInstInfo(InstId::c_jalr);
-		}
-	      op0 = rd; op1 = rd; op2 = rs2;
-	      return instTable_.getInstInfo(InstId::c_add);
-	    }
-	}
+template <typename URV>
+void
+Core<URV>::printInstRegImm(std::ostream& stream, const char* inst,
+			   unsigned rs1, int32_t imm)
+{
+  // Print instruction in a 8 character field.
+  stream << std::left << std::setw(8) << inst << ' ';
 
-      if (funct3 == 5)  // c.fsdsp c.sqsp
-	{
-	  if (isRvd())
-	    {
-	      CswspFormInst csw(inst);
-	      op0 = RegSp; op1 = csw.bits.rs2; op2 = csw.sdImmed();
-	      return instTable_.getInstInfo(InstId::c_fsdsp);
-	    }
-	  return instTable_.getInstInfo(InstId::illegal);
-	}
+  stream << intRegs_.regName(rs1, abiNames_) << ", ";
 
-      if (funct3 == 6) // c.swsp
-	{
-	  CswspFormInst csw(inst);
-	  op0 = RegSp; op1 = csw.bits.rs2; op2 = csw.swImmed();
-	  return instTable_.getInstInfo(InstId::c_swsp);
-	}
+  if (imm < 0)
+    stream << "-0x" << std::hex << (-imm);
+  else
+    stream << "0x" << std::hex << imm;
+}
 
-      if (funct3 == 7)  // c.sdsp  c.fswsp
-	{
-	  if (isRv64())  // c.sdsp
-	    {
-	      CswspFormInst csw(inst);
-	      op0 = RegSp; op1 = csw.bits.rs2; op2 = csw.sdImmed();
-	      return instTable_.getInstInfo(InstId::c_sdsp);
-	    }
-	  if (isRvf())   // c.fswsp
-	    {
-	      CswspFormInst csw(inst);
-	      op0 = RegSp; op1 = csw.bits.rs2; op2 = csw.swImmed();
-	      return instTable_.getInstInfo(InstId::c_fswsp);
-	    }
-	  return instTable_.getInstInfo(InstId::illegal);
-	}
 
-      return instTable_.getInstInfo(InstId::illegal);
+template <typename URV>
+void
+Core<URV>::printFp32f(std::ostream& stream, const char* inst,
+		      unsigned rd, unsigned rs1, unsigned rs2,
+		      unsigned rs3, RoundingMode mode)
+{
+  if (not isRvf())
+    {
+      stream << "illegal";
+      return;
     }
 
-  return instTable_.getInstInfo(InstId::illegal); // quadrant 3
+  // Print instruction in a 8 character field.
+  stream << std::left << std::setw(8) << inst << ' ';
+
+  stream << "f" << rd << ", f" << rs1 << ", f" << rs2 << ", f" << rs3
+	 << ", " << roundingModeString(mode);
 }
 
 
 template <typename URV>
-const InstInfo&
-Core<URV>::decode(uint32_t inst, uint32_t& op0, uint32_t& op1, int32_t& op2)
+void
+Core<URV>::printFp32d(std::ostream& stream, const char* inst,
+		      unsigned rd, unsigned rs1, unsigned rs2,
+		      unsigned rs3, RoundingMode mode)
 {
-  static void *opcodeLabels[] = { &&l0, &&l1, &&l2, &&l3, &&l4, &&l5,
-				  &&l6, &&l7, &&l8, &&l9, &&l10, &&l11,
-				  &&l12, &&l13, &&l14, &&l15, &&l16, &&l17,
-				  &&l18, &&l19, &&l20, &&l21, &&l22, &&l23,
-				  &&l24, &&l25, &&l26, &&l27, &&l28, &&l29,
-				  &&l30, &&l31 };
-
-  if (isCompressedInst(inst))
+  if (not isRvd())
     {
-      // return decode16(inst, op0, op1, op2);
-      if (not isRvc())
-	inst = 0; // All zeros: illegal 16-bit instruction.
-      return decode16(inst, op0, op1, op2);
+      stream << "illegal";
+      return;
     }
 
-  op0 = 0; op1 = 0; op2 = 0;
+  // Print instruction in a 8 character field.
+  stream << std::left << std::setw(8) << inst << ' ';
 
-  bool quad3 = (inst & 0x3) == 0x3;
-  if (quad3)
-    {
-      unsigned opcode = (inst & 0x7f) >> 2;  // Upper 5 bits of opcode.
+  stream << "f" << rd << ", f" << rs1 << ", f" << rs2 << ", f" << rs3
+	 << ", " << roundingModeString(mode);
+}
 
-      goto *opcodeLabels[opcode];
 
+template <typename URV>
+void
+Core<URV>::printFp32f(std::ostream& stream, const char* inst,
+		      unsigned rd, unsigned rs1, unsigned rs2,
+		      RoundingMode mode)
+{
+  if (not isRvf())
+    {
+      stream << "illegal";
+      return;
+    }
 
-    l0:  // 00000   I-form
-      {
-	IFormInst iform(inst);
-	op0 = iform.fields.rd;
-	op1 = iform.fields.rs1;
-	op2 = iform.immed(); 
-	switch (iform.fields.funct3)
-	  {
-	  case 0:  return instTable_.getInstInfo(InstId::lb);
-	  case 1:  return instTable_.getInstInfo(InstId::lh);
-	  case 2:  return instTable_.getInstInfo(InstId::lw);
-	  case 3:  return instTable_.getInstInfo(InstId::ld);
-	  case 4:  return instTable_.getInstInfo(InstId::lbu);
-	  case 5:  return instTable_.getInstInfo(InstId::lhu);
-	  case 6:  return instTable_.getInstInfo(InstId::lwu);
-	  default: return instTable_.getInstInfo(InstId::illegal);
-	  }
-      }
-      return instTable_.getInstInfo(InstId::illegal);
+  // Print instruction in a 8 character field.
+  stream << std::left << std::setw(8) << inst << ' ';
 
-    l1:
-      {
-	IFormInst iform(inst);
-	op0 = iform.fields.rd;
-	op1 = iform.fields.rs1;
-	op2 = iform.immed();
-	uint32_t f3 = iform.fields.funct3;
-	if      (f3 == 2)  return instTable_.getInstInfo(InstId::flw);
-	else if (f3 == 3)  return instTable_.getInstInfo(InstId::fld);
-      }
-      return instTable_.getInstInfo(InstId::illegal);
+  stream << "f" << rd << ", f" << rs1 << ", f" << rs2
+	   << ", " << roundingModeString(mode);
+}
 
-    l2:
-    l7:
-      return instTable_.getInstInfo(InstId::illegal);
 
-    l9:
-      {
-	SFormInst sform(inst);
-	op0 = sform.bits.rs1;
-	op1 = sform.bits.rs2;
-	op2 = sform.immed();
-	unsigned funct3 = sform.bits.funct3;
-	if      (funct3 == 2)  return instTable_.getInstInfo(InstId::fsw);
-	else if (funct3 == 3)  return instTable_.getInstInfo(InstId::fsd);
-      }
-      return instTable_.getInstInfo(InstId::illegal);
+template <typename URV>
+void
+Core<URV>::printFp32d(std::ostream& stream, const char* inst,
+		      unsigned rd, unsigned rs1, unsigned rs2,
+		      RoundingMode mode)
+{
+  if (not isRvd())
+    {
+      stream << "illegal";
+      return;
+    }
 
-    l10:
-    l15:
-      return instTable_.getInstInfo(InstId::illegal);
+  // Print instruction in a 8 character field.
+  stream << std::left << std::setw(8) << inst << ' ';
 
-    l16:
-      {
-	RFormInst rform(inst);
-	op0 = rform.bits.rd, op1 = rform.bits.rs1, op2 = rform.bits.rs2;
-	unsigned funct7 = rform.bits.funct7, funct3 = rform.bits.funct3;
-	instRoundingMode_ = RoundingMode(funct3);
-	if ((funct7 & 3) == 0)
-	  {
-	    instRs3_ = funct7 >> 2;
-	    return instTable_.getInstInfo(InstId::fmadd_s);
-	  }
-      }
-      return instTable_.getInstInfo(InstId::illegal);
+  stream << "f" << rd << ", f" << rs1 << ", f" << rs2
+	   << ", " << roundingModeString(mode);
+}
 
-    l17:
-      {
-	RFormInst rform(inst);
-	op0 = rform.bits.rd, op1 = rform.bits.rs1, op2 = rform.bits.rs2;
-	unsigned funct7 = rform.bits.funct7, funct3 = rform.bits.funct3;
-	instRoundingMode_ = RoundingMode(funct3);
-	if ((funct7 & 3) == 0)
-	  {
-	    instRs3_ = funct7 >> 2;
-	    return instTable_.getInstInfo(InstId::fmsub_s);
-	  }
-      }
-      return instTable_.getInstInfo(InstId::illegal);
 
-    l18:
-      {
-	RFormInst rform(inst);
-	op0 = rform.bits.rd, op1 = rform.bits.rs1, op2 = rform.bits.rs2;
-	unsigned funct7 = rform.bits.funct7, funct3 = rform.bits.funct3;
-	instRoundingMode_ = RoundingMode(funct3);
-	if ((funct7 & 3) == 0)
-	  {
-	    instRs3_ = funct7 >> 2;
-	    return instTable_.getInstInfo(InstId::fnmsub_s);
-	  }
-      }
-      return instTable_.getInstInfo(InstId::illegal);
+template <typename URV>
+void
+Core<URV>::disassembleFp(uint32_t inst, std::ostream& os)
+{
+  if (not isRvf())
+    {
+      os << "illegal";
+      return;
+    }
 
-    l19:
-      {
-	RFormInst rform(inst);
-	op0 = rform.bits.rd, op1 = rform.bits.rs1, op2 = rform.bits.rs2;
-	unsigned funct7 = rform.bits.funct7, funct3 = rform.bits.funct3;
-	instRoundingMode_ = RoundingMode(funct3);
-	if ((funct7 & 3) == 0)
-	  {
-	    instRs3_ = funct7 >> 2;
-	    return instTable_.getInstInfo(InstId::fnmadd_s);
-	  }
-      }
-      return instTable_.getInstInfo(InstId::illegal);
+  RFormInst rform(inst);
+  unsigned rd = rform.bits.rd, rs1 = rform.bits.rs1, rs2 = rform.bits.rs2;
+  unsigned f7 = rform.bits.funct7, f3 = rform.bits.funct3;
+  RoundingMode mode = RoundingMode(f3);
+  std::string rms = roundingModeString(mode);
 
-    l20:
-      return decodeFp(inst, op0, op1, op2);
+  if (f7 & 1)
+    {
+      if (not isRvd())
+	{
+	  os << "illegal";
+	  return;
+	}
 
-    l21:
-    l22:
-    l23:
-    l26:
-    l29:
-    l30:
-    l31:
-      return instTable_.getInstInfo(InstId::illegal);
+      if (f7 == 1)        printFp32d(os, "fadd.d", rd, rs1, rs2, mode);
+      else if (f7 == 5)   printFp32d(os, "fsub.d", rd, rs1, rs2, mode);
+      else if (f7 == 9)   printFp32d(os, "fmul.d", rd, rs1, rs2, mode);
+      else if (f7 == 0xd) printFp32d(os, "fdiv.d", rd, rs1, rs2, mode);
+      else if (f7 == 0x11)
+	{
+	  if      (f3 == 0) os << "fsgnj.d  f" << rd << ", f" << rs1;
+	  else if (f3 == 1) os << "fsgnjn.d f" << rd << ", f" << rs1;
+	  else if (f3 == 2) os << "fsgnjx.d f" << rd << ", f" << rs1;
+	  else              os << "illegal";
+	}
+      else if (f7 == 0x15)
+	{
+	  if      (f3==0) os<< "fmin.d   f" << rd << ", f" << rs1 << ", f" << rs2;
+	  else if (f3==1) os<< "fmax.d   f" << rd << ", f" << rs1 << ", f" << rs2;
+	  else            os<< "illegal";
+	}
+      else if (f7 == 0x21 and rs2 == 0)
+	os << "fcvt.d.s f" << rd << ", f" << rs1 << ", " << rms;
+      else if (f7 == 0x2d)
+	os << "fsqrt.d  f" << rd << ", f" << rs1 << ", " << rms;
+      else if (f7 == 0x51)
+	{
+	  std::string rdn = intRegs_.regName(rd, abiNames_);
+	  if      (f3==0)  os<< "fle.d    " << rdn << ", f" << rs1 << ", f" << rs2;
+	  else if (f3==1)  os<< "flt.d    " << rdn << ", f" << rs1 << ", f" << rs2;
+	  else if (f3==2)  os<< "feq.d    " << rdn << ", f" << rs1 << ", f" << rs2;
+	  else             os<< "illegal";
+	}
+      else if (f7 == 0x61)
+	{
+	  std::string rdn = intRegs_.regName(rd, abiNames_);
+	  if (rs2==0)
+	    os << "fcvt.w.d "  << rdn << ", f" << rs1 << ", " << rms;
+	  else if (rs2==1)
+	    os << "fcvt.wu.d " << rdn << ", f" << rs1 << ", " << rms;
+	  else
+	    os << "illegal";
+	}
+      else if (f7 == 0x69)
+	{
+	  std::string rs1n = intRegs_.regName(rs1, abiNames_);
+	  if (rs2==0)
+	    os << "fcvt.d.w f"  << rd << ", " << rs1n << ", " << rms;
+	  else if (rs2==1)
+	    os << "fcvt.d.wu f" << rd << ", " << rs1n << ", " << rms;
+	  else
+	    os << "illegal";
+	}
+      else if (f7 == 0x71)
+	{
+	  std::string rdn = intRegs_.regName(rd, abiNames_);
+	  if (rs2==0 and f3==0)  os << "fmv.x.d " << rdn << ", f" << rs1;
+	  if (rs2==0 and f3==1)  os << "fclass.d " << rdn << ", f" << rs1;
+	  else                   os << "illegal";
+	}
+      else if (f7 == 0x79)
+	{
+	  std::string rs1n = intRegs_.regName(rs1, abiNames_);
+	  if (rs2 == 0 and f3 == 0)  os << "fmv.d.x  f" << rd << ", " << rs1n;
+	  else                       os << "illegal";
+	}
+      else
+	os << "illegal";
+      return;
+    }
 
-    l3: // 00011  I-form
-      {
-	IFormInst iform(inst);
-	unsigned funct3 = iform.fields.funct3;
-	if (iform.fields.rd == 0 and iform.fields.rs1 == 0)
-	  {
-	    if (funct3 == 0)
-	      {
-		if (iform.top4() == 0)
-		  {
-		    op0 = iform.pred();
-		    op1 = iform.succ();
-		    return instTable_.getInstInfo(InstId::fence);
-		  }
-	      }
-	    else if (funct3 == 1)
-	      {
-		if (iform.uimmed() == 0)
-		  return instTable_.getInstInfo(InstId::fencei);
-	      }
-	  }
-      }
-      return instTable_.getInstInfo(InstId::illegal);
+  if (f7 == 0)          printFp32f(os, "fadd.s", rd, rs1, rs2, mode);
+  else if (f7 == 4)     printFp32f(os, "fsub.s", rd, rs1, rs2, mode);
+  else if (f7 == 8)     printFp32f(os, "fmul.s", rd, rs1, rs2, mode);
+  else if (f7 == 0xc)   printFp32f(os, "div.s", rd, rs1, rs2, mode);
+  else if (f7 == 0x10)
+    {
+      if      (f3 == 0) os << "fsgnj.s  f" << rd << ", f" << rs1;
+      else if (f3 == 1) os << "fsgnjn.s f" << rd << ", f" << rs1;
+      else if (f3 == 2) os << "fsgnjx.s f" << rd << ", f" << rs1;
+      else              os << "illegal";
+    }
+  else if (f7 == 0x14)
+    {
+      if      (f3 == 0) os << "fmin.s  f" << rd << ", f" << rs1 << ", f" << rs2;
+      else if (f3 == 1)	os << "fmax.s  f" << rd << ", f" << rs1 << ", f" << rs2;
+      else              os << "illegal";
+    }
+  
+  else if (f7 == 0x20 and rs2 == 1)
+    os << "fcvt.s.d f" << rd << ", f" << rs1 << ", " << rms;
+  else if (f7 == 0x2c)
+    os << "fsqrt.s  f" << rd << ", f" << rs1 << ", " << rms;
+  else if (f7 == 0x50)
+    {
+      std::string rdn = intRegs_.regName(rd, abiNames_);
+      if      (f3 == 0) os << "fle.s    " << rdn << ", f" << rs1 << ", f" << rs2;
+      else if (f3 == 1) os << "flt.s    " << rdn << ", f" << rs1 << ", f" << rs2;
+      else if (f3 == 2) os << "feq.s    " << rdn << ", f" << rs1 << ", f" << rs2;
+      else              os << "illegal";
+    }
+  else if (f7 == 0x60)
+    {
+      std::string rdn = intRegs_.regName(rd, abiNames_);
+      if      (rs2==0) os << "fcvt.w.s "  << rdn << ", f" << rs1 << ", " << rms;
+      else if (rs2==1) os << "fcvt.wu.s " << rdn << ", f" << rs1 << ", " << rms;
+      else if (rs2==2) os << "fcvt.l.s "  << rdn << ", f" << rs1 << ", " << rms;
+      else if (rs2==3) os << "fcvt.lu.s " << rdn << ", f" << rs1 << ", " << rms;
+      else             os << "illegal";
+    }
+  else if (f7 == 0x68)
+    {
+      std::string rs1n = intRegs_.regName(rs1, abiNames_);
 
-    l4:  // 00100  I-form
-      {
-	IFormInst iform(inst);
-	op0 = iform.fields.rd;
-	op1 = iform.fields.rs1;
-	op2 = iform.immed();
-	unsigned funct3 = iform.fields.funct3;
+      if      (rs2==0) os << "fcvt.s.w f"  << rd << ", " << rs1n << ", " << rms;
+      else if (rs2==1) os << "fcvt.s.wu f" << rd << ", " << rs1n << ", " << rms;
+      else if (rs2==2) os << "fcvt.s.l f"  << rd << ", " << rs1n << ", " << rms;
+      else if (rs2==3) os << "fcvt.s.lu f" << rd << ", " << rs1n << ", " << rms;
+      else             os << "illegal";
+    }
+  else if (f7 == 0x70)
+    {
+      std::string rdn = intRegs_.regName(rd, abiNames_);
+      if      (rs2 == 0 and f3 == 0)  os << "fmv.x.w  " << rdn << ", f" << rs1;
+      else if (rs2 == 0 and f3 == 1)  os << "fclass.s " << rdn << ", f" << rs1;
+      else                            os << "illegal";
+    }
+  else if (f7 == 0x74)
+    {
+      std::string rs1n = intRegs_.regName(rs1, abiNames_);
+      if (rs2 == 0 and f3 == 0)  os << "fmv.w.x  f" << rd << ", " << rs1n;
+      else                       os << "illegal";
+    }
+  else
+    os << "illegal";
+}
 
-	if      (funct3 == 0)  return instTable_.getInstInfo(InstId::addi);
-	else if (funct3 == 1)
-	  {
-	    unsigned topBits = 0, shamt = 0;
-	    iform.getShiftFields(isRv64(), topBits, shamt);
-	    if (topBits == 0)
-	      {
-		op2 = shamt;
-		return instTable_.getInstInfo(InstId::slli);
-	      }
-	  }
-	else if (funct3 == 2)  return instTable_.getInstInfo(InstId::slti);
-	else if (funct3 == 3)  return instTable_.getInstInfo(InstId::sltiu);
-	else if (funct3 == 4)  return instTable_.getInstInfo(InstId::xori);
-	else if (funct3 == 5)
-	  {
-	    unsigned topBits = 0, shamt = 0;
-	    iform.getShiftFields(isRv64(), topBits, shamt);
-	    op2 = shamt;
-	    if (topBits == 0)
-	      return instTable_.getInstInfo(InstId::srli);
-	    if (isRv64())
-	      topBits <<= 1;
-	    if (topBits == 0x20)
-	      return instTable_.getInstInfo(InstId::srai);
-	  }
-	else if (funct3 == 6)  return instTable_.getInstInfo(InstId::ori);
-	else if (funct3 == 7)  return instTable_.getInstInfo(InstId::andi);
-      }
-      return instTable_.getInstInfo(InstId::illegal);
 
-    l5:  // 00101   U-form
+template <typename URV>
+void
+Core<URV>::printVecInst(std::ostream& os, uint32_t inst)
+{
+  uint32_t op0 = 0, op1 = 0;
+  int32_t op2 = 0;
+  const InstInfo& info = instTable_.decode(inst, op0, op1, op2);
+  if (not isRvv() or not info.isVector())
+    {
+      os << "illegal";
+      return;
+    }
+
+  std::string name = info.name();
+  for (auto& c : name)
+    if (c == '_')
+      c = '.';
+
+  // Print instruction in a 9 character field.
+  os << std::left << std::setw(9) << name << ' ';
+
+  InstId id = info.instId();
+  if (id == InstId::vsetvli or id == InstId::vsetivli)
+    {
+      static const char* lmuls[] = { "m1", "m2", "m4", "m8",
+				     "m?", "mf8", "mf4", "mf2" };
+      unsigned vtype = op2;
+      os << intRegs_.regName(op0, abiNames_) << ", ";
+      if (id == InstId::vsetvli)
+	os << intRegs_.regName(op1, abiNames_);
+      else
+	os << op1;
+      os << ", e" << (8 << ((vtype >> 3) & 7)) << ", " << lmuls[vtype & 7]
+	 << ", " << ((vtype & 0x40)? "ta" : "tu")
+	 << ", " << ((vtype & 0x80)? "ma" : "mu");
+      return;
+    }
+
+  bool shift = (id == InstId::vsll_vi or id == InstId::vsrl_vi or
+		id == InstId::vsra_vi);
+
+  auto printOperand = [this, &os, &info, shift] (unsigned i, uint32_t val) {
+    switch (info.ithOperandType(i))
       {
-	UFormInst uform(inst);
-	op0 = uform.bits.rd;
-	op1 = uform.immed();
-	return instTable_.getInstInfo(InstId::auipc);
+      case OperandType::VecReg: os << "v" << val;                          break;
+      case OperandType::IntReg: os << intRegs_.regName(val, abiNames_);    break;
+      case OperandType::FpReg:  os << "f" << val;                          break;
+      case OperandType::Imm:
+	os << std::dec << (shift? int32_t(val) : int32_t(val << 27) >> 27);
+	break;
+      default:                                                             break;
       }
-      return instTable_.getInstInfo(InstId::illegal);
+  };
 
-    l6:  // 00110  I-form
-      {
-	IFormInst iform(inst);
-	op0 = iform.fields.rd;
-	op1 = iform.fields.rs1;
-	op2 = iform.immed();
-	unsigned funct3 = iform.fields.funct3;
-	if (funct3 == 0)
-	  return instTable_.getInstInfo(InstId::addiw);
-	else if (funct3 == 1)
-	  {
-	    if (iform.top7() == 0)
+  if (id >= InstId::vle8_v and id <= InstId::vse64_v)
+    {
+      os << "v" << op0 << ", (" << intRegs_.regName(op1, abiNames_) << ")";
+    }
+  else
+    {
+      // Assembly order is: vd, vs2, vs1/rs1/imm except for the
+      // multiply-add (vd, vs1/rs1, vs2) and for the moves from a
+      // scalar/immediate (vd, rs1/imm).
+      printOperand(0, op0);
+      if (id == InstId::vfmacc_vv or id == InstId::vfmacc_vf)
+	{
+	  os << ", ";  printOperand(2, op2);
+	  os << ", ";  printOperand(1, op1);
+	}
+      else
+	{
+	  for (unsigned i = 1; i < 3; ++i)
+	    if (info.ithOperandType(i) != OperandType::None)
 	      {
-		op2 = iform.fields2.shamt;
-		return instTable_.getInstInfo(InstId::slliw);
+		os << ", ";
+		printOperand(i, i == 1? op1 : uint32_t(op2));
 	      }
-	  }
-	else if (funct3 == 5)
-	  {
-	    op2 = iform.fields2.shamt;
-	    if (iform.top7() == 0)
-	      return instTable_.getInstInfo(InstId::srliw);
-	    else if (iform.top7() == 0x20)
-	      return instTable_.getInstInfo(InstId::sraiw);
-	  }
-      }
-      return instTable_.getInstInfo(InstId::illegal);
+	}
+    }
 
-    l8:  // 01000  S-form
-      {
-	SFormInst sform(inst);
-	op0 = sform.bits.rs1;
-	op1 = sform.bits.rs2;
-	op2 = sform.immed();
-	uint32_t funct3 = sform.bits.funct3;
-
-	if (funct3 == 0) return instTable_.getInstInfo(InstId::sb);
-	if (funct3 == 1) return instTable_.getInstInfo(InstId::sh);
-	if (funct3 == 2) return instTable_.getInstInfo(InstId::sw);
-	if (funct3 == 3 and isRv64()) return instTable_.getInstInfo(InstId::sd);
-      }
-      return instTable_.getInstInfo(InstId::illegal);
+  // Bit 25 (vm) clear in a masked instruction: Print the mask operand.
+  if ((info.codeMask() & (1 << 25)) == 0 and ((inst >> 25) & 1) == 0)
+    os << ", v0.t";
+}
 
-    l11:  // 01011  R-form atomics
-      if (not isRva())
-	return instTable_.getInstInfo(InstId::illegal);
 
-      if (false)  // Not implemented
-      {
-	if (not isRva())
-	  return instTable_.getInstInfo(InstId::illegal);
-	RFormInst rf(inst);
-	uint32_t top5 = rf.top5(), f3 = rf.bits.funct3;
-	op0 = rf.bits.rd; op1 = rf.bits.rs1; op2 = rf.bits.rs2;
+template <typename URV>
+bool
+Core<URV>::printBitManipInst(std::ostream& os, uint32_t inst)
+{
+  uint32_t op0 = 0, op1 = 0;
+  int32_t op2 = 0;
+  const InstInfo& info = instTable_.decode(inst, op0, op1, op2);
+  InstId id = info.instId();
+  if (id < InstId::sh1add or id > InstId::bseti)
+    return false;
+  if (execTable_.at(size_t(id)) == &Core<URV>::execIllegal)
+    return false;  // Encoding of the other base (rv32/rv64).
 
-	if (f3 == 2)
-	  {
-	    if (top5 == 0)    return instTable_.getInstInfo(InstId::amoadd_w);
-	    if (top5 == 1)    return instTable_.getInstInfo(InstId::amoswap_w);
-	    if (top5 == 2)    return instTable_.getInstInfo(InstId::lr_w);
-	    if (top5 == 3)    return instTable_.getInstInfo(InstId::sc_w);
-	    if (top5 == 4)    return instTable_.getInstInfo(InstId::amoxor_w);
-	    if (top5 == 8)    return instTable_.getInstInfo(InstId::amoor_w);
-	    if (top5 == 0x0c) return instTable_.getInstInfo(InstId::amoand_w);
-	    if (top5 == 0x10) return instTable_.getInstInfo(InstId::amomin_w);
-	    if (top5 == 0x14) return instTable_.getInstInfo(InstId::amomax_w);
-	    if (top5 == 0x18) return instTable_.getInstInfo(InstId::amominu_w);
-	    if (top5 == 0x1c) return instTable_.getInstInfo(InstId::amomaxu_w);
-	  }
-	else if (f3 == 3)
-	  {
-	    if (not isRv64()) return instTable_.getInstInfo(InstId::illegal);
-	    if (top5 == 0)    return instTable_.getInstInfo(InstId::amoadd_d);
-	    if (top5 == 1)    return instTable_.getInstInfo(InstId::amoswap_d);
-	    if (top5 == 2)    return instTable_.getInstInfo(InstId::lr_d);
-	    if (top5 == 3)    return instTable_.getInstInfo(InstId::sc_d);
-	    if (top5 == 4)    return instTable_.getInstInfo(InstId::amoxor_d);
-	    if (top5 == 8)    return instTable_.getInstInfo(InstId::amoor_d);
-	    if (top5 == 0xc)  return instTable_.getInstInfo(InstId::amoand_d);
-	    if (top5 == 0x10) return instTable_.getInstInfo(InstId::amomin_d);
-	    if (top5 == 0x14) return instTable_.getInstInfo(InstId::amomax_d);
-	    if (top5 == 0x18) return instTable_.getInstInfo(InstId::amominu_d);
-	    if (top5 == 0x1c) return instTable_.getInstInfo(InstId::amomaxu_d);
-	  }
-      }
-      return instTable_.getInstInfo(InstId::illegal);
-
-    l12:  // 01100  R-form
-      {
-	RFormInst rform(inst);
-	op0 = rform.bits.rd;
-	op1 = rform.bits.rs1;
-	op2 = rform.bits.rs2;
-	unsigned funct7 = rform.bits.funct7, funct3 = rform.bits.funct3;
-	if (funct7 == 0)
-	  {
-	    if      (funct3 == 0) return instTable_.getInstInfo(InstId::add);
-	    else if (funct3 == 1) return instTable_.getInstInfo(InstId::sll);
-	    else if (funct3 == 2) return instTable_.getInstInfo(InstId::slt);
-	    else if (funct3 == 3) return instTable_.getInstInfo(InstId::sltu);
-	    else if (funct3 == 4) return instTable_.getInstInfo(InstId::xor_);
-	    else if (funct3 == 5) return instTable_.getInstInfo(InstId::srl);
-	    else if (funct3 == 6) return instTable_.getInstInfo(InstId::or_);
-	    else if (funct3 == 7) return instTable_.getInstInfo(InstId::and_);
-	  }
-	else if (funct7 == 1)
-	  {
-	    if      (not isRvm()) return instTable_.getInstInfo(InstId::illegal);
-	    else if (funct3 == 0) return instTable_.getInstInfo(InstId::mul);
-	    else if (funct3 == 1) return instTable_.getInstInfo(InstId::mulh);
-	    else if (funct3 == 2) return instTable_.getInstInfo(InstId::mulhsu);
-	    else if (funct3 == 3) return instTable_.getInstInfo(InstId::mulhu);
-	    else if (funct3 == 4) return instTable_.getInstInfo(InstId::div);
-	    else if (funct3 == 5) return instTable_.getInstInfo(InstId::divu);
-	    else if (funct3 == 6) return instTable_.getInstInfo(InstId::rem);
-	    else if (funct3 == 7) return instTable_.getInstInfo(InstId::remu);
-	  }
-	else if (funct7 == 0x20)
-	  {
-	    if      (funct3 == 0) return instTable_.getInstInfo(InstId::sub);
-	    else if (funct3 == 5) return instTable_.getInstInfo(InstId::sra);
-	  }
-      }
-      return instTable_.getInstInfo(InstId::illegal);
-
-    l13:  // 01101  U-form
-      {
-	UFormInst uform(inst);
-	op0 = uform.bits.rd;
-	op1 = uform.immed();
-	return instTable_.getInstInfo(InstId::lui);
-      }
-
-    l14: // 01110  R-Form
-      {
-	const RFormInst rform(inst);
-	op0 = rform.bits.rd;
-	op1 = rform.bits.rs1;
-	op2 = rform.bits.rs2;
-	unsigned funct7 = rform.bits.funct7, funct3 = rform.bits.funct3;
-	if (funct7 == 0)
-	  {
-	    if      (funct3 == 0) return instTable_.getInstInfo(InstId::addw);
-	    else if (funct3 == 1) return instTable_.getInstInfo(InstId::sllw);
-	    else if (funct3 == 5) return instTable_.getInstInfo(InstId::srlw);
-	  }
-	else if (funct7 == 1)
-	  {
-	    if      (funct3 == 0) return instTable_.getInstInfo(InstId::mulw);
-	    else if (funct3 == 4) return instTable_.getInstInfo(InstId::divw);
-	    else if (funct3 == 5) return instTable_.getInstInfo(InstId::divuw);
-	    else if (funct3 == 6) return instTable_.getInstInfo(InstId::remw);
-	    else if (funct3 == 7) return instTable_.getInstInfo(InstId::remuw);
-	  }
-	else if (funct7 == 0x20)
-	  {
-	    if      (funct3 == 0)  return instTable_.getInstInfo(InstId::subw);
-	    else if (funct3 == 5)  return instTable_.getInstInfo(InstId::sraw);
-	  }
-      }
-      return instTable_.getInstInfo(InstId::illegal);
-
-    l24: // 11000   B-form
-      {
-	BFormInst bform(inst);
-	op0 = bform.bits.rs1;
-	op1 = bform.bits.rs2;
-	op2 = bform.immed();
-	uint32_t funct3 = bform.bits.funct3;
-	if      (funct3 == 0)  return instTable_.getInstInfo(InstId::beq);
-	else if (funct3 == 1)  return instTable_.getInstInfo(InstId::bne);
-	else if (funct3 == 4)  return instTable_.getInstInfo(InstId::blt);
-	else if (funct3 == 5)  return instTable_.getInstInfo(InstId::bge);
-	else if (funct3 == 6)  return instTable_.getInstInfo(InstId::bltu);
-	else if (funct3 == 7)  return instTable_.getInstInfo(InstId::bgeu);
-      }
-      return instTable_.getInstInfo(InstId::illegal);
-
-    l25:  // 11001  I-form
-      {
-	IFormInst iform(inst);
-	op0 = iform.fields.rd;
-	op1 = iform.fields.rs1;
-	op2 = iform.immed();
-	if (iform.fields.funct3 == 0)
-	  return instTable_.getInstInfo(InstId::jalr);
-      }
-      return instTable_.getInstInfo(InstId::illegal);
-
-    l27:  // 11011  J-form
-      {
-	JFormInst jform(inst);
-	op0 = jform.bits.rd;
-	op1 = jform.immed();
-	return instTable_.getInstInfo(InstId::jal);
-      }
-
-    l28:  // 11100  I-form
-      {
-	IFormInst iform(inst);
-	op0 = iform.fields.rd;
-	op1 = iform.fields.rs1;
-	op2 = iform.uimmed(); // csr
-	switch (iform.fields.funct3)
-	  {
-	  case 0:
-	    {
-	      uint32_t funct7 = op2 >> 5;
-	      if (funct7 == 0) // ecall ebreak uret
-		{
-		  if (op1 != 0 or op0 != 0)
-		    return instTable_.getInstInfo(InstId::illegal);
-		  else if (op2 == 0)
-		    return instTable_.getInstInfo(InstId::ecall);
-		  else if (op2 == 1)
-		    return instTable_.getInstInfo(InstId::ebreak);
-		  else if (op2 == 2)
-		    return instTable_.getInstInfo(InstId::uret);
-		}
-	      else if (funct7 == 9)
-		{
-		  if (op0 != 0)
-		    return instTable_.getInstInfo(InstId::illegal);
-		  else // sfence.vma
-		    return instTable_.getInstInfo(InstId::illegal);
-		}
-	      else if (op2 == 0x102)
-		return instTable_.getInstInfo(InstId::sret);
-	      else if (op2 == 0x302)
-		return instTable_.getInstInfo(InstId::mret);
-	      else if (op2 == 0x105)
-		return instTable_.getInstInfo(InstId::wfi);
-	    }
-	    break;
-	  case 1:  return instTable_.getInstInfo(InstId::csrrw);
-	  case 2:  return instTable_.getInstInfo(InstId::csrrs);
-	  case 3:  return instTable_.getInstInfo(InstId::csrrc);
-	  case 5:  return instTable_.getInstInfo(InstId::csrrwi);
-	  case 6:  return instTable_.getInstInfo(InstId::csrrsi);
-	  case 7:  return instTable_.getInstInfo(InstId::csrrci);
-	  default: return instTable_.getInstInfo(InstId::illegal);
-	  }
-	return instTable_.getInstInfo(InstId::illegal);
-      }
-    }
-  else
-    return instTable_.getInstInfo(InstId::illegal);
-}
+  const std::string& name = info.name();
 
-
-std::string
-roundingModeString(RoundingMode mode)
-{
-  switch (mode)
+  if (info.ithOperandType(2) == OperandType::Imm)
     {
-    case RoundingMode::NearestEven: return "rne";
-    case RoundingMode::Zero:        return "rtz";
-    case RoundingMode::Down:        return "rdn";
-    case RoundingMode::Up:          return "rup";
-    case RoundingMode::NearestMax:  return "rmm";
-    case RoundingMode::Invalid1:    return "inv1";
-    case RoundingMode::Invalid2:    return "inv2";
-    case RoundingMode::Dynamic:     return "dyn";
-    default:                        return "inv";
+      printInstShiftImm(os, name.c_str(), op0, op1, op2);
+      return true;
     }
-  return "inv";
-}
-
-
-template <typename URV>
-void
-Core<URV>::printInstRdRs1Rs2(std::ostream& stream, const char* inst,
-			     unsigned rd, unsigned rs1, unsigned rs2)
-{
-  // Print instruction in a 9 character field.
-  stream << std::left << std::setw(9) << inst;
 
-  stream << intRegs_.regName(rd, abiNames_) << ", "
-	 << intRegs_.regName(rs1, abiNames_) << ", "
-	 << intRegs_.regName(rs2, abiNames_);
+  // Names (e.g. sh1add.uw) may not fit the 9 character field of
+  // printInstRdRs1Rs2: Keep a separating space.
+  os << std::left << std::setw(8) << name << ' '
+     << intRegs_.regName(op0, abiNames_) << ", "
+     << intRegs_.regName(op1, abiNames_);
+  if (info.ithOperandType(2) == OperandType::IntReg)
+    os << ", " << intRegs_.regName(op2, abiNames_);
+  return true;
 }
 
 
 template <typename URV>
 void
-Core<URV>::printInstLdSt(std::ostream& stream, const char* inst,
-			 unsigned rd, unsigned rs1, int32_t imm)
+Core<URV>::printAmoInst(std::ostream& stream, const char* inst, bool aq,
+			bool rl, unsigned rd, unsigned rs1, unsigned rs2)
 {
-  // Print instruction in a 8 character field.
-  stream << std::left << std::setw(8) << inst << ' ';
+  stream << inst;
 
-  const char* sign = imm < 0? "-" : "";
-  if (imm < 0)
-    imm = -imm;
+  if (aq)
+    stream << ".aq";
 
-  // Keep least sig 12 bits.
-  imm = imm & 0xfff;
+  if (rl)
+    stream << ".rl";
 
-  stream << intRegs_.regName(rd, abiNames_) << ", " << sign << "0x"
-	 << std::hex << imm << "(" << intRegs_.regName(rs1, abiNames_) << ")";
+  stream << ' ';
+  stream << intRegs_.regName(rd,  abiNames_) << ", "
+	 << intRegs_.regName(rs1, abiNames_) << ", "
+    	 << intRegs_.regName(rs2, abiNames_);
 }
 
 
 template <typename URV>
 void
-Core<URV>::printInstFpLdSt(std::ostream& stream, const char* inst,
-			   unsigned rd, unsigned rs1, int32_t imm)
+Core<URV>::printLrInst(std::ostream& stream, const char* inst, bool aq,
+		       bool rl, unsigned rd, unsigned rs1)
 {
-  // Print instruction in a 8 character field.
-  stream << std::left << std::setw(8) << inst << ' ';
-
-  const char* sign = imm < 0? "-" : "";
-  if (imm < 0)
-    imm = -imm;
-
-  // Keep least sig 12 bits.
-  imm = imm & 0xfff;
-
-  stream << "f" << rd << ", " << sign << "0x" << std::hex << imm
-	 << "(" << intRegs_.regName(rs1, abiNames_) << ")";
-}
-
+  stream << inst;
 
-template <typename URV>
-void
-Core<URV>::printInstShiftImm(std::ostream& stream, const char* inst,
-			     unsigned rs1, unsigned rs2, uint32_t imm)
-{
-  // Print instruction in a 8 character field.
-  stream << std::left << std::setw(8) << inst << ' ';
+  if (aq)
+    stream << ".aq";
 
-  if constexpr (sizeof(URV) == 4)
-    imm = imm & 0x1f;
-  else
-    imm = imm & 0x3f;
+  if (rl)
+    stream << ".rl";
 
-  stream << intRegs_.regName(rs1, abiNames_) << ", "
-	 << intRegs_.regName(rs2, abiNames_) << ", 0x"
-	 << std::hex << imm;
+  stream << ' ';
+  stream << intRegs_.regName(rd, abiNames_)
+	 << ", (" << intRegs_.regName(rs1, abiNames_) << ")";
 }
 
 
 template <typename URV>
 void
-Core<URV>::printInstRegRegImm12(std::ostream& stream, const char* inst,
-				unsigned rs1, unsigned rs2, int32_t imm)
+Core<URV>::printScInst(std::ostream& stream, const char* inst, bool aq,
+		       bool rl, unsigned rd, unsigned rs1, unsigned rs2)
 {
-  // Print instruction in a 8 character field.
-  stream << std::left << std::setw(8) << inst << ' ';
-
-  stream << intRegs_.regName(rs1, abiNames_) << ", "
-	 << intRegs_.regName(rs2, abiNames_) << ", ";
-
-  if (imm < 0)
-    stream << "-0x" << std::hex << ((-imm) & 0xfff);
-  else
-    stream << "0x" << std::hex << (imm & 0xfff);
-}
+  stream << inst;
 
+  if (aq)
+    stream << ".aq";
 
-template <typename URV>
-void
-Core<URV>::printInstRegImm(std::ostream& stream, const char* inst,
-			   unsigned rs1, int32_t imm)
-{
-  // Print instruction in a 8 character field.
-  stream << std::left << std::setw(8) << inst << ' ';
+  if (rl)
+    stream << ".rl";
 
-  stream << intRegs_.regName(rs1, abiNames_) << ", ";
+  stream << ' ';
 
-  if (imm < 0)
-    stream << "-0x" << std::hex << (-imm);
-  else
-    stream << "0x" << std::hex << imm;
+  stream << intRegs_.regName(rd, abiNames_)
+	 << ", " << intRegs_.regName(rs2, abiNames_)
+	 << ", (" << intRegs_.regName(rs1) << ")";
 }
 
 
 template <typename URV>
 void
-Core<URV>::printFp32f(std::ostream& stream, const char* inst,
-		      unsigned rd, unsigned rs1, unsigned rs2,
-		      unsigned rs3, RoundingMode mode)
+Core<URV>::disassembleInst32(uint32_t inst, std::ostream& stream)
 {
-  if (not isRvf())
+  if (not isFullSizeInst(inst))
     {
-      stream << "illegal";
+      stream << "illegal";  // Not a compressed instruction.
       return;
     }
 
-  // Print instruction in a 8 character field.
-  stream << std::left << std::setw(8) << inst << ' ';
-
-  stream << "f" << rd << ", f" << rs1 << ", f" << rs2 << ", f" << rs3
-	 << ", " << roundingModeString(mode);
-}
+  unsigned opcode = (inst & 0x7f) >> 2;  // Upper 5 bits of opcode.
 
+  // Bit manipulation instructions share the opcodes of the integer
+  // instructions (00100, 00110, 01100, 01110).
+  if (isRvb() and (opcode & 0x15) == 4 and printBitManipInst(stream, inst))
+    return;
 
-template <typename URV>
-void
-Core<URV>::printFp32d(std::ostream& stream, const char* inst,
-		      unsigned rd, unsigned rs1, unsigned rs2,
-		      unsigned rs3, RoundingMode mode)
-{
-  if (not isRvd())
+  switch (opcode)
     {
-      stream << "illegal";
-      return;
-    }
-
-  // Print instruction in a 8 character field.
-  stream << std::left << std::setw(8) << inst << ' ';
-
-  stream << "f" << rd << ", f" << rs1 << ", f" << rs2 << ", f" << rs3
-	 << ", " << roundingModeString(mode);
-}
-
-
-template <typename URV>
-void
-Core<URV>::printFp32f(std::ostream& stream, const char* inst,
-		      unsigned rd, unsigned rs1, unsigned rs2,
-		      RoundingMode mode)
-{
-  if (not isRvf())
-    {
-      stream << "illegal";
-      return;
-    }
-
-  // Print instruction in a 8 character field.
-  stream << std::left << std::setw(8) << inst << ' ';
-
-  stream << "f" << rd << ", f" << rs1 << ", f" << rs2
-	   << ", " << roundingModeString(mode);
-}
+    case 0:  // 00000   I-form
+      {
+	IFormInst iform(inst);
+	unsigned rd = iform.fields.rd, rs1 = iform.fields.rs1;
+	int32_t imm = iform.immed();
+	switch (iform.fields.funct3)
+	  {
+	  case 0:  printInstLdSt(stream, "lb",  rd, rs1, imm); break;
+	  case 1:  printInstLdSt(stream, "lh",  rd, rs1, imm); break;
+	  case 2:  printInstLdSt(stream, "lw",  rd, rs1, imm); break;
+	  case 3:  printInstLdSt(stream, "ld",  rd, rs1, imm); break;
+	  case 4:  printInstLdSt(stream, "lbu", rd, rs1, imm); break;
+	  case 5:  printInstLdSt(stream, "lhu", rd, rs1, imm); break;
+	  case 6:  printInstLdSt(stream, "lwu", rd, rs1, imm); break;
+	  default: stream << "illegal";                        break;
+	  }
+      }
+      break;
 
+    case 1:   // 0001 I-Form
+      {
+	IFormInst iform(inst);
+	unsigned rd = iform.fields.rd, rs1 = iform.fields.rs1;
+	int32_t imm = iform.immed();
+	uint32_t f3 = iform.fields.funct3;
+	if (f3 == 2)
+	  {
+	    if (isRvf())
+	      printInstFpLdSt(stream, "flw", rd, rs1, imm);
+	    else
+	      stream << "illegal";
+	  }
+	else if (f3 == 3)
+	  {
+	    if (isRvd())
+	      printInstFpLdSt(stream, "fld", rd, rs1, imm);
+	    else
+	      stream << "illegal";
+	  }
+	else if (f3 == 0 or f3 >= 5)
+	  printVecInst(stream, inst);
+	else
+	  stream << "illegal";
+      }
+      break;
 
-template <typename URV>
-void
-Core<URV>::printFp32d(std::ostream& stream, const char* inst,
-		      unsigned rd, unsigned rs1, unsigned rs2,
-		      RoundingMode mode)
-{
-  if (not isRvd())
-    {
-      stream << "illegal";
-      return;
-    }
+    case 3:  // 00011  I-form
+      {
+	IFormInst iform(inst);
+	unsigned rd = iform.fields.rd, rs1 = iform.fields.rs1;
+	unsigned funct3 = iform.fields.funct3;
+	if (rd != 0 or rs1 != 0)
+	  stream << "illegal";
+	else if (funct3 == 0)
+	  {
+	    if (iform.top4() != 0)
+	      stream << "illegal";
+	    else
+	      stream << "fence  " << iform.pred() << ", " << iform.succ();
+	  }
+	else if (funct3 == 1)
+	  {
+	    if (iform.uimmed() != 0)
+	      stream << "illegal";
+	    else
+	      stream << "fence.i ";
+	  }
+	else
+	  stream << "illegal";
+      }
+      break;
 
-  // Print instruction in a 8 character field.
-  stream << std::left << std::setw(8) << inst << ' ';
+    case 4:  // 00100  I-form
+      {
+	IFormInst iform(inst);
+	unsigned rd = iform.fields.rd, rs1 = iform.fields.rs1;
+	int32_t imm = iform.immed();
+	switch (iform.fields.funct3)
+	  {
+	  case 0: 
+	    printInstRegRegImm12(stream, "addi", rd, rs1, imm);
+	    break;
+	  case 1: 
+	    {
+	      unsigned topBits = 0, shamt = 0;
+	      iform.getShiftFields(isRv64(), topBits, shamt);
+	      if (topBits == 0)
+		printInstShiftImm(stream, "slli", rd, rs1, shamt);
+	      else
+		stream << "illegal";
+	    }
+	    break;
+	  case 2:
+	    printInstRegRegImm12(stream, "slti", rd, rs1, imm);
+	    break;
+	  case 3:
+	    printInstRegRegImm12(stream, "sltiu", rd, rs1, imm);
+	    break;
+	  case 4:
+	    printInstRegRegImm12(stream, "xori", rd, rs1, imm);
+	    break;
+	  case 5:
+	    {
+	      unsigned topBits = 0, shamt = 0;
+	      iform.getShiftFields(isRv64(), topBits, shamt);
+	      if (topBits == 0)
+		printInstShiftImm(stream, "srli", rd, rs1, shamt);
+	      else
+		{
+		  if (isRv64())
+		    topBits <<= 1;
+		  if (topBits == 0x20)
+		    printInstShiftImm(stream, "srai", rd, rs1, shamt);
+		  else
+		    stream << "illegal";
+		}
+	    }
+	    break;
+	  case 6:
+	    printInstRegRegImm12(stream, "ori", rd, rs1, imm);
+	    break;
+	  case 7:
+	    printInstRegRegImm12(stream, "andi", rd, rs1, imm);
+	    break;
+	  default:
+	    stream << "illegal";
+	    break;
+	  }
+      }
+      break;
 
-  stream << "f" << rd << ", f" << rs1 << ", f" << rs2
-	   << ", " << roundingModeString(mode);
-}
+    case 5:  // 00101   U-form
+      {
+	UFormInst uform(inst);
+	stream << "auipc    " << intRegs_.regName(uform.bits.rd, abiNames_)
+	       << ", 0x" << std::hex << ((uform.immed() >> 12) & 0xfffff);
+      }
+      break;
 
+    case 6:  // 00110  I-form
+      {
+	IFormInst iform(inst);
+	unsigned rd = iform.fields.rd, rs1 = iform.fields.rs1;
+	int32_t imm = iform.immed();
+	unsigned funct3 = iform.fields.funct3;
+	if (funct3 == 0)
+	  {
+	    if (isRv64())
+	      printInstRegRegImm12(stream, "addi", rd, rs1, imm);
+	    else
+	      stream << "illegal";
+	  }
+	else if (funct3 == 1)
+	  {
+	    if (iform.top7() != 0)
+	      stream << "illegal";
+	    else if (isRv64())
+	      printInstShiftImm(stream, "slliw", rd, rs1, iform.fields2.shamt);
+	    else
+	      stream << "illegal";
+	  }
+	else if (funct3 == 5)
+	  {
+	    if (iform.top7() == 0)
+	      printInstShiftImm(stream, "srliw", rd, rs1, iform.fields2.shamt);
+	    else if (iform.top7() == 0x20)
+	      printInstShiftImm(stream, "sraiw", rd, rs1, iform.fields2.shamt);
+	    else
+	      stream << "illegal";
+	  }
+	else
+	  stream << "illegal";
+      }
+      break;
 
-template <typename URV>
-void
-Core<URV>::disassembleFp(uint32_t inst, std::ostream& os)
-{
-  if (not isRvf())
-    {
-      os << "illegal";
-      return;
-    }
+    case 8:  // 01000  S-form
+      {
+	SFormInst sform(inst);
+	unsigned rs1 = sform.bits.rs1, rs2 = sform.bits.rs2;
+	int32_t imm = sform.immed();
+	switch (sform.bits.funct3)
+	  {
+	  case 0:  printInstLdSt(stream, "sb", rs2, rs1, imm); break;
+	  case 1:  printInstLdSt(stream, "sh", rs2, rs1, imm); break;
+	  case 2:  printInstLdSt(stream, "sw", rs2, rs1, imm); break;
+	  default:
+	    if (not isRv64())
+	      stream << "illegal";
+	    else
+	      printInstLdSt(stream, "sd", rs2, rs1, imm);
+	    break;
+	  }
+      }
+      break;
 
-  RFormInst rform(inst);
-  unsigned rd = rform.bits.rd, rs1 = rform.bits.rs1, rs2 = rform.bits.rs2;
-  unsigned f7 = rform.bits.funct7, f3 = rform.bits.funct3;
-  RoundingMode mode = RoundingMode(f3);
-  std::string rms = roundingModeString(mode);
+    case 9:   // 01001  S-form
+      {
+	SFormInst sf(inst);
+	unsigned rs1 = sf.bits.rs1, rs2 = sf.bits.rs2, f3 = sf.bits.funct3;
+	int32_t imm = sf.immed();
+	if (f3 == 2)
+	  {
+	    if (isRvf())
+	      printInstFpLdSt(stream, "fsw", rs2, rs1, imm);
+	    else
+	      stream << "illegal";
+	  }
+	else if (f3 == 3)
+	  {
+	    if (isRvd())
+	      printInstFpLdSt(stream, "fsd", rs2, rs1, imm);
+	    else
+	      stream << "illegal";
+	  }
+	else if (f3 == 0 or f3 >= 5)
+	  printVecInst(stream, inst);
+	else
+	  stream << "illegal";
+      }
+      break;
 
-  if (f7 & 1)
-    {
-      if (not isRvd())
-	{
-	  os << "illegal";
-	  return;
-	}
+    case 11:  // 01011  R-form  atomics
+      {
+	if (not isRva())
+	  {
+	    stream << "illegal";
+	    break;
+	  }
 
-      if (f7 == 1)        printFp32d(os, "fadd.d", rd, rs1, rs2, mode);
-      else if (f7 == 5)   printFp32d(os, "fsub.d", rd, rs1, rs2, mode);
-      else if (f7 == 9)   printFp32d(os, "fmul.d", rd, rs1, rs2, mode);
-      else if (f7 == 0xd) printFp32d(os, "fdiv.d", rd, rs1, rs2, mode);
-      else if (f7 == 0x11)
-	{
-	  if      (f3 == 0) os << "fsgnj.d  f" << rd << ", f" << rs1;
-	  else if (f3 == 1) os << "fsgnjn.d f" << rd << ", f" << rs1;
-	  else if (f3 == 2) os << "fsgnjx.d f" << rd << ", f" << rs1;
-	  else              os << "illegal";
-	}
-      else if (f7 == 0x15)
-	{
-	  if      (f3==0) os<< "fmin.d   f" << rd << ", f" << rs1 << ", f" << rs2;
-	  else if (f3==1) os<< "fmax.d   f" << rd << ", f" << rs1 << ", f" << rs2;
-	  else            os<< "illegal";
-	}
-      else if (f7 == 0x21 and rs2 == 0)
-	os << "fcvt.d.s f" << rd << ", f" << rs1 << ", " << rms;
-      else if (f7 == 0x2d)
-	os << "fsqrt.d  f" << rd << ", f" << rs1 << ", " << rms;
-      else if (f7 == 0x51)
+	RFormInst rf(inst);
+	uint32_t top5 = rf.top5(), f3 = rf.bits.funct3;
+	uint32_t rd = rf.bits.rd, rs1 = rf.bits.rs1, rs2 = rf.bits.rs2;
+	bool rl = rf.rl(), aq = rf.aq();
+	if (f3 == 2)
+	  {
+	    if (top5 == 0)
+	      printAmoInst(stream, "amoadd.w", aq, rl, rd, rs1, rs2);
+	    else if (top5 == 1)
+	      printAmoInst(stream, "amoswap.w", aq, rl, rd, rs1, rs2);
+	    else if (top5 == 2)
+	      printLrInst(stream, "lr.w", aq, rl, rd, rs1);
+	    else if (top5 == 3)
+	      printScInst(stream, "sc.w", aq, rl, rd, rs1, rs2);
+	    else if (top5 == 4)
+	      printAmoInst(stream, "amoxor.w", aq, rl, rd, rs1, rs2);
+	    else if (top5 == 8)
+	      printAmoInst(stream, "amoor.w", aq, rl, rd, rs1, rs2);
+	    else if (top5 == 0x0c)
+	      printAmoInst(stream, "amoand.w", aq, rl, rd, rs1, rs2);
+	    else if (top5 == 0x10)
+	      printAmoInst(stream, "ammin.w", aq, rl, rd, rs1, rs2);
+	    else if (top5 == 0x14)
+	      printAmoInst(stream, "amomax.w", aq, rl, rd, rs1, rs2);
+	    else if (top5 == 0x18)
+	      printAmoInst(stream, "amominu.w", aq, rl, rd, rs1, rs2);
+	    else if (top5 == 0x1c)
+	      printAmoInst(stream, "amomaxu.w", aq, rl, rd, rs1, rs2);
+	    else
+	      stream << "illegal";
+	  }
+	else if (f3 == 3)
+	  {
+	    if (top5 == 0)
+	      printAmoInst(stream, "amoadd.d", aq, rl, rd, rs1, rs2);
+	    else if (top5 == 1)
+	      printAmoInst(stream, "amoswap.d", aq, rl, rd, rs1, rs2);
+	    else if (top5 == 2)
+	      printLrInst(stream, "lr.d", aq, rl, rd, rs1);
+	    else if (top5 == 3)
+	      printScInst(stream, "sc.d", aq, rl, rd, rs1, rs2);
+	    else if (top5 == 4)
+	      printAmoInst(stream, "amoxor.d", aq, rl, rd, rs1, rs2);
+	    else if (top5 == 8)
+	      printAmoInst(stream, "amoor.d", aq, rl, rd, rs1, rs2);
+	    else if (top5 == 0x0c)
+	      printAmoInst(stream, "amoand.d", aq, rl, rd, rs1, rs2);
+	    else if (top5 == 0x10)
+	      printAmoInst(stream, "ammin.d", aq, rl, rd, rs1, rs2);
+	    else if (top5 == 0x14)
+	      printAmoInst(stream, "amomax.d", aq, rl, rd, rs1, rs2);
+	    else if (top5 == 0x18)
+	      printAmoInst(stream, "amominu.d", aq, rl, rd, rs1, rs2);
+	    else if (top5 == 0x1c)
+	      printAmoInst(stream, "amomaxu.d", aq, rl, rd, rs1, rs2);
+	    else
+	      stream << "illegal";
+	  }
+	else stream << "illegal";
+      }
+      break;
+
+    case 12:  // 01100  R-form
+      {
+	RFormInst rform(inst);
+	unsigned rd = rform.bits.rd, rs1 = rform.bits.rs1, rs2 = rform.bits.rs2;
+	unsigned f7 = rform.bits.funct7, f3 = rform.bits.funct3;
+	if (f7 == 0)
+	  {
+	    if      (f3 == 0)  printInstRdRs1Rs2(stream, "add",  rd, rs1, rs2);
+	    else if (f3 == 1)  printInstRdRs1Rs2(stream, "sll",  rd, rs1, rs2);
+	    else if (f3 == 2)  printInstRdRs1Rs2(stream, "slt",  rd, rs1, rs2);
+	    else if (f3 == 3)  printInstRdRs1Rs2(stream, "sltu", rd, rs1, rs2);
+	    else if (f3 == 4)  printInstRdRs1Rs2(stream, "xor",  rd, rs1, rs2);
+	    else if (f3 == 5)  printInstRdRs1Rs2(stream, "srl",  rd, rs1, rs2);
+	    else if (f3 == 6)  printInstRdRs1Rs2(stream, "or",   rd, rs1, rs2);
+	    else if (f3 == 7)  printInstRdRs1Rs2(stream, "and",  rd, rs1, rs2);
+	  }
+	else if (f7 == 1)
+	  {
+	    if      (not isRvm())  stream << "illegal";
+	    else if (f3 == 0) printInstRdRs1Rs2(stream, "mul",    rd, rs1, rs2);
+	    else if (f3 == 1) printInstRdRs1Rs2(stream, "mulh",   rd, rs1, rs2);
+	    else if (f3 == 2) printInstRdRs1Rs2(stream, "mulhsu", rd, rs1, rs2);
+	    else if (f3 == 3) printInstRdRs1Rs2(stream, "mulhu",  rd, rs1, rs2);
+	    else if (f3 == 4) printInstRdRs1Rs2(stream, "div",    rd, rs1, rs2);
+	    else if (f3 == 5) printInstRdRs1Rs2(stream, "divu",   rd, rs1, rs2);
+	    else if (f3 == 6) printInstRdRs1Rs2(stream, "rem",    rd, rs1, rs2);
+	    else if (f3 == 7) printInstRdRs1Rs2(stream, "remu",   rd, rs1, rs2);
+	  }
+	else if (f7 == 0x20)
+	  {
+	    if      (f3 == 0)  printInstRdRs1Rs2(stream, "sub", rd, rs1, rs2);
+	    else if (f3 == 5)  printInstRdRs1Rs2(stream, "sra", rd, rs1, rs2);
+	    else               stream << "illegal";
+	  }
+	else
+	  stream << "illegal";
+      }
+      break;
+
+    case 13:  // 01101  U-form
+      {
+	UFormInst uform(inst);
+	uint32_t imm = uform.immed();
+	stream << "lui      x" << uform.bits.rd << ", ";
+	if (imm < 0) { stream << "-"; imm = -imm; }
+	stream << "0x" << std::hex << ((imm >> 12) & 0xfffff);
+      }
+      break;
+
+    case 14:  // 01110  R-Form
+      {
+	const RFormInst rform(inst);
+	unsigned rd = rform.bits.rd, rs1 = rform.bits.rs1, rs2 = rform.bits.rs2;
+	unsigned f7 = rform.bits.funct7, f3 = rform.bits.funct3;
+	if (f7 == 0)
+	  {
+	    if      (f3 == 0)  printInstRdRs1Rs2(stream, "addw", rd, rs1, rs2);
+	    else if (f3 == 1)  printInstRdRs1Rs2(stream, "sllw", rd, rs1, rs2);
+	    else if (f3 == 5)  printInstRdRs1Rs2(stream, "srlw", rd, rs1, rs2);
+	    else               stream << "illegal";
+	  }
+	else if (f7 == 1)
+	  {
+	    if      (f3 == 0)  printInstRdRs1Rs2(stream, "mulw",  rd, rs1, rs2);
+	    else if (f3 == 4)  printInstRdRs1Rs2(stream, "divw",  rd, rs1, rs2);
+	    else if (f3 == 5)  printInstRdRs1Rs2(stream, "divuw", rd, rs1, rs2);
+	    else if (f3 == 6)  printInstRdRs1Rs2(stream, "remw",  rd, rs1, rs2);
+	    else if (f3 == 7)  printInstRdRs1Rs2(stream, "remuw", rd, rs1, rs2);
+	    else               stream << "illegal";
+	  }
+	else if (f7 == 0x20)
+	  {
+	    if      (f3 == 0)  printInstRdRs1Rs2(stream, "subw", rd, rs1, rs2);
+	    else if (f3 == 5)  printInstRdRs1Rs2(stream, "sraw", rd, rs1, rs2);
+	    else               stream << "illegal";
+	  }
+	else
+	  stream << "illegal";
+      }
+      break;
+
+    case 16:  // 10000   rform
+      {
+	RFormInst rform(inst);
+	unsigned rd = rform.bits.rd, rs1 = rform.bits.rs1, rs2 = rform.bits.rs2;
+	unsigned f7 = rform.bits.funct7, f3 = rform.bits.funct3;
+	unsigned rs3 = f7 >> 2;
+	RoundingMode mode = RoundingMode(f3);
+	if ((f7 & 3) == 0)
+	  printFp32f(stream, "fmadd_s", rd, rs1, rs2, rs3, mode);
+	else if ((f7 & 3) == 1)
+	  printFp32d(stream, "fmadd_d", rd, rs1, rs2, rs3, mode);
+	else
+	  stream << "illegal";
+      }
+      break;
+
+    case 17:  // 10001   rform
+      {
+	RFormInst rform(inst);
+	unsigned rd = rform.bits.rd, rs1 = rform.bits.rs1, rs2 = rform.bits.rs2;
+	unsigned f7 = rform.bits.funct7, f3 = rform.bits.funct3;
+	unsigned rs3 = f7 >> 2;
+	RoundingMode mode = RoundingMode(f3);
+	if ((f7 & 3) == 0)
+	  printFp32f(stream, "fmsub_s", rd, rs1, rs2, rs3, mode);
+	else if ((f7 & 3) == 1)
+	  printFp32d(stream, "fmsub_d", rd, rs1, rs2, rs3, mode);
+	else
+	  stream << "illegal";
+      }
+      break;
+
+    case 18:  // 10010   rform
+      {
+	RFormInst rform(inst);
+	unsigned rd = rform.bits.rd, rs1 = rform.bits.rs1, rs2 = rform.bits.rs2;
+	unsigned f7 = rform.bits.funct7, f3 = rform.bits.funct3;
+	unsigned rs3 = f7 >> 2;
+	RoundingMode mode = RoundingMode(f3);
+	if ((f7 & 3) == 0)
+	  printFp32f(stream, "fnmsub_s", rd, rs1, rs2, rs3, mode);
+	else if ((f7 & 3) == 1)
+	  printFp32d(stream, "fnmsub_d", rd, rs1, rs2, rs3, mode);
+	else
+	  stream << "illegal";
+      }
+      break;
+
+    case 19:  // 10011   rform
+      {
+	RFormInst rform(inst);
+	unsigned rd = rform.bits.rd, rs1 = rform.bits.rs1, rs2 = rform.bits.rs2;
+	unsigned f7 = rform.bits.funct7, f3 = rform.bits.funct3;
+	unsigned rs3 = f7 >> 2;
+	RoundingMode mode = RoundingMode(f3);
+	if ((f7 & 3) == 0)
+	  printFp32f(stream, "fnmadd_s", rd, rs1, rs2, rs3, mode);
+	else if ((f7 & 3) == 1)
+	  printFp32d(stream, "fnmadd_d", rd, rs1, rs2, rs3, mode);
+	else
+	  stream << "illegal";
+      }
+      break;
+
+    case 20:  // 10100   rform
+      disassembleFp(inst, stream);
+      break;
+
+    case 21:  // 10101   vector
+      printVecInst(stream, inst);
+      break;
+
+    case 24:  // 11000   B-form
+      {
+	BFormInst bform(inst);
+	unsigned rs1 = bform.bits.rs1, rs2 = bform.bits.rs2;
+	int32_t imm = bform.immed();
+	switch (bform.bits.funct3)
+	  {
+	  case 0:  printInstRegRegImm12(stream, "beq",  rs1, rs2, imm); break;
+	  case 1:  printInstRegRegImm12(stream, "bne",  rs1, rs2, imm); break;
+	  case 4:  printInstRegRegImm12(stream, "blt",  rs1, rs2, imm); break;
+	  case 5:  printInstRegRegImm12(stream, "bge",  rs1, rs2, imm); break;
+	  case 6:  printInstRegRegImm12(stream, "bltu", rs1, rs2, imm); break;
+	  case 7:  printInstRegRegImm12(stream, "bgeu", rs1, rs2, imm); break;
+	  default: stream << "illegal";                                 break;
+	  }
+      }
+      break;
+
+    case 25:  // 11001  I-form
+      {
+	IFormInst iform(inst);
+	unsigned rd = iform.fields.rd, rs1 = iform.fields.rs1;
+	if (iform.fields.funct3 == 0)
+	  printInstLdSt(stream, "jalr", rd, rs1, iform.immed());
+	else
+	  stream << "illegal";
+      }
+      break;
+
+    case 27:  // 11011  J-form
+      {
+	JFormInst jform(inst);
+	int32_t imm = jform.immed();
+	stream << "jal      " << intRegs_.regName(jform.bits.rd, abiNames_)
+	       << ", ";
+	if (imm < 0)
+	  {
+	    stream << "-";
+	    imm = -imm;
+	  }
+	stream << "0x" << std::hex << (imm & 0xfffff);
+      }
+      break;
+
+    case 28:  // 11100  I-form
+      {
+	IFormInst iform(inst);
+	unsigned rd = iform.fields.rd, rs1 = iform.fields.rs1;
+	unsigned csrNum = iform.uimmed();
+	std::string rdn = intRegs_.regName(rd, abiNames_);   // rd name
+	std::string rs1n = intRegs_.regName(rs1, abiNames_); // rs1 name
+	std::string csrn;  // csr name
+	auto csr = csRegs_.findCsr(CsrNumber(csrNum));
+	if (csr)
+	  csrn = csr->getName();
+	else
+	  csrn = "illegal";
+	switch (iform.fields.funct3)
+	  {
+	  case 0:
+	    {
+	      uint32_t func7 = iform.top7();
+	      if (func7 == 0)
+		{
+		  if (rs1 != 0 or rd != 0)  stream << "illegal";
+		  else if (csrNum == 0)     stream << "ecall";
+		  else if (csrNum == 1)     stream << "ebreak";
+		  else if (csrNum == 2)     stream << "uret";
+		  else                      stream << "illegal";
+		}
+	      else if (func7 == 9)
+		{
+		  uint32_t rs2 = iform.rs2();
+		  if (rd != 0) stream << "illegal";
+		  else         stream << "SFENCE.VMA " << rs1 << ", " << rs2;
+		}
+	      else if (csrNum == 0x102) stream << "sret";
+	      else if (csrNum == 0x302) stream << "mret";
+	      else if (csrNum == 0x105) stream << "wfi";
+	      else                      stream << "illegal";
+	    }
+	    break;
+	  case 1:
+	    stream << "csrrw    " << rdn << ", " << csrn << ", " << rs1n;
+	    break;
+	  case 2:
+	    stream << "csrrs    " << rdn << ", " << csrn << ", " << rs1n;
+	    break;
+	  case 3:
+	    stream << "csrrc    " << rdn << ", " << csrn << ", " << rs1n;
+	    break;
+	  case 5:
+	    stream << "csrrwi   " << rdn << ", " << csrn << ", " << rs1n;
+	    break;
+	  case 6:
+	    stream << "csrrsi   " << rdn << ", " << csrn << ", " << rs1n;
+	    break;
+	  case 7:
+	    stream << "csrrci   " << rdn << ", " << csrn << ", " << rs1n;
+	    break;
+	  default: 
+	    stream << "illegal";
+	    break;
+	  }
+      }
+      break;
+
+    default:
+      stream << "illegal";
+      break;
+    }
+}
+
+
+template <typename URV>
+void
+Core<URV>::disassembleInst16(uint16_t inst, std::ostream& stream)
+{
+  if (not isRvc())
+    {
+      stream << "illegal";
+      return;
+    }
+
+  uint16_t quadrant = inst & 0x3;
+  uint16_t funct3 =  inst >> 13;    // Bits 15 14 and 13
+
+  switch (quadrant)
+    {
+    case 0:    // quadrant 0
+      switch (funct3) 
 	{
-	  std::string rdn = intRegs_.regName(rd, abiNames_);
-	  if      (f3==0)  os<< "fle.d    " << rdn << ", f" << rs1 << ", f" << rs2;
-	  else if (f3==1)  os<< "flt.d    " << rdn << ", f" << rs1 << ", f" << rs2;
-	  else if (f3==2)  os<< "feq.d    " << rdn << ", f" << rs1 << ", f" << rs2;
-	  else             os<< "illegal";
+	case 0:   // illegal, c.addi4spn
+	  {
+	    if (inst == 0)
+	      stream << "illegal";
+	    else
+	      {
+		CiwFormInst ciwf(inst);
+		unsigned immed = ciwf.immed();
+		if (immed == 0)
+		  stream << "illegal";
+		else
+		  printInstRegImm(stream, "c.addi4spn", 8+ciwf.bits.rdp,
+				  immed >> 2);
+	      }
+	  }
+	  break;
+	case 1: // c_fld, c_lq  
+	  stream << "illegal";
+	  break;
+	case 2: // c.lw
+	  {
+	    ClFormInst clf(inst);
+	    unsigned rd = 8+clf.bits.rdp, rs1 = (8+clf.bits.rs1p);
+	    printInstLdSt(stream, "c.lw", rd, rs1, clf.lwImmed());
+	  }
+	  break;
+	case 3:  // c.flw, c.ld
+	  {
+	    ClFormInst clf(inst);
+	    unsigned rd = 8+clf.bits.rdp, rs1 = (8+clf.bits.rs1p);
+	    if (isRv64())
+	      printInstLdSt(stream, "c.ld", rd, rs1, clf.ldImmed()); 
+	    else
+	      {
+		if (isRvf())
+		  printInstFpLdSt(stream, "c.flw", rd, rs1, clf.lwImmed());
+		else
+		  stream << "illegal";
+	      }
+	  }
+	  break;
+	case 4:  // reserved
+	  stream << "illegal";
+	  break;
+	case 5:  // c.fsd, c.sq
+	  if (isRvd())
+	    {
+	      ClFormInst clf(inst);
+	      unsigned rd = 8+clf.bits.rdp, rs1 = (8+clf.bits.rs1p);
+	      printInstFpLdSt(stream, "c.fsd", rd, rs1, clf.ldImmed());
+	    }
+	  else
+	    stream << "illegal";
+	  break;
+	case 6:  // c.sw
+	  {
+	    CsFormInst cs(inst);
+	    unsigned rd = (8+cs.bits.rs2p), rs1 = 8+cs.bits.rs1p;
+	    printInstLdSt(stream, "c.sw", rd, rs1, cs.swImmed());
+	  }
+	  break;
+	case 7:  // c.fsw, c.sd
+	  {
+	    CsFormInst cs(inst);
+	    unsigned rd = (8+cs.bits.rs2p), rs1 = (8+cs.bits.rs1p);
+	    if (isRv64())
+	      printInstLdSt(stream, "c.sd", rd, rs1, cs.sdImmed());
+	    else
+	      {
+		if (isRvf())
+		  printInstFpLdSt(stream, "c.fsw", rd, rs1, cs.swImmed());
+		else
+		  stream << "illegal"; // c.fsw
+	      }
+	  }
+	  break;
 	}
-      else if (f7 == 0x61)
+      break;
+
+    case 1:    // quadrant 1
+      switch (funct3)
 	{
-	  std::string rdn = intRegs_.regName(rd, abiNames_);
-	  if (rs2==0)
-	    os << "fcvt.w.d "  << rdn << ", f" << rs1 << ", " << rms;
-	  else if (rs2==1)
-	    os << "fcvt.wu.d " << rdn << ", f" << rs1 << ", " << rms;
+	case 0:  // c.nop, c.addi
+	  {
+	    CiFormInst cif(inst);
+	    if (cif.bits.rd == 0)
+	      stream << "c.nop";
+	    else
+	      printInstRegImm(stream, "c.addi", cif.bits.rd, cif.addiImmed());
+	  }
+	  break;
+	  
+	case 1:  // c.jal, in rv64 and rv128 this is c.addiw
+	  if (isRv64())
+	    {
+	      CiFormInst cif(inst);
+	      if (cif.bits.rd == 0)
+		stream << "illegal";
+	      else
+		printInstRegImm(stream, "c.addiw", cif.bits.rd, cif.addiImmed());
+	    }
 	  else
-	    os << "illegal";
+	    {
+	      CjFormInst cjf(inst);
+	      int32_t imm = cjf.immed();
+	      stream << "c.jal    ";
+	      if (imm < 0) { stream << "-"; imm = -imm; }
+	      stream << "0x" << std::hex << imm;
+	    }
+	  break;
+
+	case 2:  // c.li
+	  {
+	    CiFormInst cif(inst);
+	    printInstRegImm(stream, "c.li", cif.bits.rd, cif.addiImmed());
+	  }
+	  break;
+
+	case 3:  // c.addi16sp, c.lui
+	  {
+	    CiFormInst cif(inst);
+	    int immed16 = cif.addi16spImmed();
+	    if (immed16 == 0)
+	      stream << "illegal";
+	    else if (cif.bits.rd == RegSp)
+	      {
+		stream << "c.addi16sp ";
+		if (immed16 < 0) { stream << "-"; immed16 = -immed16; }
+		stream << "0x" << std::hex << (immed16 >> 4);
+	      }
+	    else
+	      printInstRegImm(stream, "c.lui", cif.bits.rd, cif.luiImmed()>>12);
+	  }
+	  break;
+
+	// c.srli c.srli64 c.srai c.srai64 c.andi c.sub c.xor c.and
+	// c.subw c.addw
+	case 4:
+	  {
+	    CaiFormInst caf(inst);  // compressed and immediate form
+	    unsigned rd = 8 + caf.bits.rdp;
+	    std::string rdName = intRegs_.regName(rd, abiNames_);
+	    int immed = caf.andiImmed();
+	    switch (caf.bits.funct2)
+	      {
+	      case 0:
+		if (caf.bits.ic5 != 0 and not isRv64())
+		  stream << "illegal";
+		else
+		  printInstRegImm(stream, "c.srli", rd, caf.shiftImmed());
+		break;
+	      case 1:
+		if (caf.bits.ic5 != 0 and not isRv64())
+		  stream << "illegal";
+		else
+		  printInstRegImm(stream, "c.srai", rd, caf.shiftImmed());
+		break;
+	      case 2:
+		printInstRegImm(stream, "c.andi", rd, immed);
+		break;
+	      case 3:
+		{
+		  unsigned rs2 = 8+(immed & 0x7); // Lowest 3 bits of immed
+		  std::string rs2n = intRegs_.regName(rs2, abiNames_);
+		  if ((immed & 0x20) == 0)  // Bit 5 of immed
+		    {
+		      switch ((immed >> 3) & 3) // Bits 3 and 4 of immed
+			{
+			case 0:
+			  stream << "c.sub    " << rdName << ", " << rs2n; break;
+			case 1:
+			  stream << "c.xor    " << rdName << ", " << rs2n; break;
+			case 2:
+			  stream << "c.or     " << rdName << ", " << rs2n; break;
+			case 3:
+			  stream << "c.and    " << rdName << ", " << rs2n; break;
+			}
+		    }
+		  else
+		    {
+		      if (not isRv64())
+			stream << "illegal";
+		      else
+			switch ((immed >> 3) & 3)
+			  {
+			  case 0: stream << "c.subw " << rdName << ", " << rs2n;
+			    break;
+			  case 1: stream << "c.addw " << rdName << ", " << rs2n;
+			    break;
+			  case 3: stream << "illegal";
+			    break; // reserved
+			  case 4: stream << "illegal";
+			    break; // reserved
+			}
+		    }
+		}
+		break;
+	      }
+	  }
+	  break;
+
+	case 5:  // c.j
+	  {
+	    CjFormInst cjf(inst);
+	    int32_t imm = cjf.immed();
+	    stream << "c.j      ";
+	    if (imm < 0) { stream << "-"; imm = -imm; }
+	    stream << "0x" << std::hex << imm;
+	  }
+	  break;
+	  
+	case 6:  // c.beqz
+	  {
+	    CbFormInst cbf(inst);
+	    printInstRegImm(stream, "c.beqz", 8+cbf.bits.rs1p, cbf.immed());
+	  }
+	  break;
+
+	case 7:  // c.bnez
+	  {
+	    CbFormInst cbf(inst);
+	    printInstRegImm(stream, "c.bnez", 8+cbf.bits.rs1p, cbf.immed());
+	  }
+	  break;
 	}
-      else if (f7 == 0x69)
+      break;
+
+    case 2:    // quadrant 2
+      switch (funct3)
 	{
-	  std::string rs1n = intRegs_.regName(rs1, abiNames_);
-	  if (rs2==0)
-	    os << "fcvt.d.w f"  << rd << ", " << rs1n << ", " << rms;
-	  else if (rs2==1)
-	    os << "fcvt.d.wu f" << rd << ", " << rs1n << ", " << rms;
+	case 0:  // c.slli c.slli64
+	  {
+	    CiFormInst cif(inst);
+	    unsigned immed = unsigned(cif.slliImmed()), rd = cif.bits.rd;
+	    if (cif.bits.ic5 != 0 and not isRv64())
+	      stream << "illegal";
+	    else
+	      stream << "c.slli   " << intRegs_.regName(rd, abiNames_) << ", "
+		     << immed;
+	  }
+	  break;
+
+	case 1:   // c.fldsp, c.lqsp
+	  stream << "illegal";
+	  break;
+
+	case 2:  // c.lwsp
+	  {
+	    CiFormInst cif(inst);
+	    unsigned rd = cif.bits.rd;
+	    // rd == 0 is legal per Andrew Watterman
+	    stream << "c.lwsp   " << intRegs_.regName(rd, abiNames_) << ", 0x"
+		   << std::hex << cif.lwspImmed();
+	  }
+	break;
+
+	case 3:  // c.flwsp c.ldsp
+	  if (isRv64())
+	    {
+	      CiFormInst cif(inst);
+	      unsigned rd = cif.bits.rd;
+	      stream << "c.ldsp   " << intRegs_.regName(rd, abiNames_) << ", 0x"
+		     << std::hex << cif.ldspImmed();
+	    }
+	  else
+	    {
+	      stream << "illegal";  // c.flwsp
+	    }
+	  break;
+
+	case 4:  // c.jr c.mv c.ebreak c.jalr c.add
+	  {
+	    CiFormInst cif(inst);
+	    unsigned immed = cif.addiImmed();
+	    unsigned rd = cif.bits.rd;
+	    unsigned rs2 = immed & 0x1f;
+	    std::string rdName = intRegs_.regName(rd, abiNames_);
+	    std::string rs2Name = intRegs_.regName(rs2, abiNames_);
+	    if ((immed & 0x20) == 0)
+	      {
+		if (rs2 == 0)
+		  {
+		    if (rd == 0)
+		      stream << "illegal";
+		    else
+		      stream << "c.jr     " << rdName;
+		  }
+		else
+		  {
+		    if (rd == 0)
+		      stream << "illegal";
+		    else
+		      stream << "c.mv     " << rdName << ", " << rs2Name;
+		  }
+	      }
+	    else
+	      {
+		if (rs2 == 0)
+		  {
+		    if (rd == 0)
+		      stream << "c.ebreak";
+		    else
+		      stream << "c.jalr   " << rdName;
+		  }
+		else
+		  {
+		    if (rd == 0)
+		      stream << "illegal";
+		    else
+		      stream << "c.add    " << rdName << ", " << rs2Name;
+		  }
+	      }
+	  }
+	  break;
+
+	case 5:  // c.fsdsp  c.sqsp
+	  stream << "illegal";
+	  break;
+
+	case 6:  // c.swsp
+	  {
+	    CswspFormInst csw(inst);
+	    stream << "c.swsp   " << intRegs_.regName(csw.bits.rs2, abiNames_)
+		   << ", 0x" << std::hex << csw.swImmed();
+	  }
+	  break;
+
+	case 7:  // c.fswsp c.sdsp
+	  {
+	    if (isRv64())  // c.sdsp
+	      {
+		CswspFormInst csw(inst);
+		stream << "c.sdsp   " << intRegs_.regName(csw.bits.rs2, abiNames_)
+		       << ", 0x" << std::hex << csw.sdImmed();
+	      }
 	  else
-	    os << "illegal";
+	    {
+	      stream << "illegal";    // c.fwsp
+	    }
+	  }
+	  break;
 	}
-      else if (f7 == 0x71)
+      break;
+
+    case 3:  // quadrant 3
+      stream << "illegal";
+      break;
+
+    default:
+      stream << "illegal";
+      break;
+    }
+}
+
+
+template <typename URV>
+void
+Core<URV>::disassembleInst32(uint32_t inst, std::string& str)
+{
+  str.clear();
+
+  std::ostringstream oss;
+  disassembleInst32(inst, oss);
+  str = oss.str();
+}
+
+
+template <typename URV>
+void
+Core<URV>::disassembleInst16(uint16_t inst, std::string& str)
+{
+  str.clear();
+
+  std::ostringstream oss;
+  disassembleInst16(inst, oss);
+  str = oss.str();
+}
+
+
+template <typename URV>
+void
+Core<URV>::enableInstructionFrequency(bool b)
+{
+  instFreq_ = b;
+  if (b)
+    {
+      instProfileVec_.resize(size_t(InstId::maxId) + 1);
+
+      unsigned regCount = intRegCount();
+      for (auto& inst : instProfileVec_)
 	{
-	  std::string rdn = intRegs_.regName(rd, abiNames_);
-	  if (rs2==0 and f3==0)  os << "fmv.x.d " << rdn << ", f" << rs1;
-	  if (rs2==0 and f3==1)  os << "fclass.d " << rdn << ", f" << rs1;
-	  else                   os << "illegal";
+	  inst.rd_.resize(regCount);
+	  inst.rs1_.resize(regCount);
+	  inst.rs2_.resize(regCount);
+	  inst.rs1Histo_.resize(13);  // FIX: avoid magic 13
+	  inst.rs2Histo_.resize(13);  // FIX: avoid magic 13
+	  inst.immHisto_.resize(13);  // FIX: avoid magic 13
 	}
-      else if (f7 == 0x79)
+    }
+}
+
+
+template <typename URV>
+void
+Core<URV>::enableInstructionMix(bool flag)
+{
+  instMix_ = flag;
+  if (flag)
+    instTypeCounts_.resize(size_t(InstType::Vector) + 1);
+}
+
+
+template <typename URV>
+void
+Core<URV>::enterDebugMode(DebugModeCause cause, URV pc)
+{
+  if (debugMode_)
+    {
+      if (debugStepMode_)
+	debugStepMode_ = false;
+      else
+	std::cerr << "Error: Entering debug-halt while in debug-halt\n";
+    }
+  else
+    {
+      debugMode_ = true;
+      if (debugStepMode_)
+	std::cerr << "Error: Entering debug-halt with debug-step true\n";
+      debugStepMode_ = false;
+    }
+
+  URV value = 0;
+  if (csRegs_.read(CsrNumber::DCSR, PrivilegeMode::Machine, debugMode_, value))
+    {
+      value &= ~(URV(7) << 6);   // Clear cause field (starts at bit 6).
+      value |= URV(cause) << 6;  // Set cause field
+      if (nmiPending_)
+	value |= URV(1) << 3;    // Set nmip bit.
+      csRegs_.poke(CsrNumber::DCSR, value);
+
+      csRegs_.poke(CsrNumber::DPC, pc);
+    }
+}
+
+
+template <typename URV>
+void
+Core<URV>::enterDebugMode(URV pc)
+{
+  // This method is used by the test-bench to make the simulator
+  // follow it into debug-halt or debug-stop mode. Do nothing if the
+  // simulator got into debug mode on its own.
+  if (debugMode_)
+    return;   // Already in debug mode.
+
+  if (debugStepMode_)
+    std::cerr << "Error: Enter-debug command finds core in debug-step mode.\n";
+
+  debugStepMode_ = false;
+  debugMode_ = false;
+
+  enterDebugMode(DebugModeCause::DEBUGGER, pc);
+}
+
+
+template <typename URV>
+void
+Core<URV>::exitDebugMode()
+{
+  if (not debugMode_)
+    {
+      std::cerr << "Error: Bench sent exit debug while not in debug mode.\n";
+      return;
+    }
+
+  csRegs_.peek(CsrNumber::DPC, pc_);
+
+  // If in debug-step go to debug-halt. If in debug-halt go to normal
+  // or debug-step based on step-bit in DCSR.
+  if (debugStepMode_)
+    debugStepMode_ = false;
+  else
+    {
+      if (dcsrStep_)
+	debugStepMode_ = true;
+      else
+	debugMode_ = false;
+    }
+  pendingEvent_ = true;  // Interrupts are not taken in debug mode.
+
+  // If pending nmi bit is set in dcsr, set pending nmi in core
+  URV dcsrVal = 0;
+  if (not peekCsr(CsrNumber::DCSR, dcsrVal))
+    std::cerr << "Error: Failed to read DCSR in exit debug.\n";
+
+  if ((dcsrVal >> 3) & 1)
+    setPendingNmi(nmiCause_);
+}
+
+
+template <typename URV>
+void
+Core<URV>::execBlt(uint32_t rs1, uint32_t rs2, int32_t offset)
+{
+  SRV v1 = intRegs_.read(rs1),  v2 = intRegs_.read(rs2);
+  if (v1 < v2)
+    {
+      pc_ = currPc_ + SRV(offset);
+      pc_ = (pc_ >> 1) << 1;  // Clear least sig bit.
+      lastBranchTaken_ = true;
+    }
+}
+
+
+template <typename URV>
+void
+Core<URV>::execBltu(uint32_t rs1, uint32_t rs2, int32_t offset)
+{
+  URV v1 = intRegs_.read(rs1),  v2 = intRegs_.read(rs2);
+  if (v1 < v2)
+    {
+      pc_ = currPc_ + SRV(offset);
+      pc_ = (pc_ >> 1) << 1;  // Clear least sig bit.
+      lastBranchTaken_ = true;
+    }
+}
+
+
+template <typename URV>
+void
+Core<URV>::execBge(uint32_t rs1, uint32_t rs2, int32_t offset)
+{
+  SRV v1 = intRegs_.read(rs1),  v2 = intRegs_.read(rs2);
+  if (v1 >= v2)
+    {
+      pc_ = currPc_ + SRV(offset);
+      pc_ = (pc_ >> 1) << 1;  // Clear least sig bit.
+      lastBranchTaken_ = true;
+    }
+}
+
+
+template <typename URV>
+void
+Core<URV>::execBgeu(uint32_t rs1, uint32_t rs2, int32_t offset)
+{
+  URV v1 = intRegs_.read(rs1),  v2 = intRegs_.read(rs2);
+  if (v1 >= v2)
+    {
+      pc_ = currPc_ + SRV(offset);
+      pc_ = (pc_ >> 1) << 1;  // Clear least sig bit.
+      lastBranchTaken_ = true;
+    }
+}
+
+
+template <typename URV>
+void
+Core<URV>::execJalr(uint32_t rd, uint32_t rs1, int32_t offset)
+{
+  URV temp = pc_;  // pc has the address of the instruction after jalr
+  pc_ = (intRegs_.read(rs1) + SRV(offset));
+  pc_ = (pc_ >> 1) << 1;  // Clear least sig bit.
+  intRegs_.write(rd, temp);
+  lastBranchTaken_ = true;
+}
+
+
+template <typename URV>
+void
+Core<URV>::execJal(uint32_t rd, uint32_t offset, int32_t)
+{
+  intRegs_.write(rd, pc_);
+  pc_ = currPc_ + SRV(int32_t(offset));
+  pc_ = (pc_ >> 1) << 1;  // Clear least sig bit.
+  lastBranchTaken_ = true;
+}
+
+
+template <typename URV>
+void
+Core<URV>::execLui(uint32_t rd, uint32_t imm, int32_t)
+{
+  intRegs_.write(rd, SRV(int32_t(imm)));
+}
+
+
+template <typename URV>
+void
+Core<URV>::execAuipc(uint32_t rd, uint32_t imm, int32_t)
+{
+  intRegs_.write(rd, currPc_ + SRV(int32_t(imm)));
+}
+
+
+template <typename URV>
+void
+Core<URV>::execSlli(uint32_t rd, uint32_t rs1, int32_t amount)
+{
+  if ((amount & 0x20) and not rv64_)
+    {
+      illegalInst();  // Bit 5 of shift amount cannot be zero in 32-bit.
+      return;
+    }
+
+  URV v = intRegs_.read(rs1) << amount;
+  intRegs_.write(rd, v);
+}
+
+
+template <typename URV>
+void
+Core<URV>::execSlti(uint32_t rd, uint32_t rs1, int32_t imm)
+{
+  URV v = SRV(intRegs_.read(rs1)) < imm ? 1 : 0;
+  intRegs_.write(rd, v);
+}
+
+
+template <typename URV>
+void
+Core<URV>::execSltiu(uint32_t rd, uint32_t rs1, int32_t imm)
+{
+  URV v = intRegs_.read(rs1) < URV(SRV(imm)) ? 1 : 0;
+  intRegs_.write(rd, v);
+}
+
+
+template <typename URV>
+void
+Core<URV>::execXori(uint32_t rd, uint32_t rs1, int32_t imm)
+{
+  URV v = intRegs_.read(rs1) ^ SRV(imm);
+  intRegs_.write(rd, v);
+}
+
+
+template <typename URV>
+void
+Core<URV>::execSrli(uint32_t rd, uint32_t rs1, int32_t amount)
+{
+  uint32_t uamount(amount);
+
+  if ((uamount > 31) and not isRv64())
+    {
+      illegalInst();
+      return;
+    }
+
+  URV v = intRegs_.read(rs1) >> uamount;
+  intRegs_.write(rd, v);
+}
+
+
+template <typename URV>
+void
+Core<URV>::execSrai(uint32_t rd, uint32_t rs1, int32_t amount)
+{
+  uint32_t uamount(amount);
+
+  if ((uamount > 31) and not isRv64())
+    {
+      illegalInst();
+      return;
+    }
+
+  URV v = SRV(intRegs_.read(rs1)) >> uamount;
+  intRegs_.write(rd, v);
+}
+
+
+template <typename URV>
+void
+Core<URV>::execOri(uint32_t rd, uint32_t rs1, int32_t imm)
+{
+  URV v = intRegs_.read(rs1) | SRV(imm);
+  intRegs_.write(rd, v);
+}
+
+
+template <typename URV>
+void
+Core<URV>::execSub(uint32_t rd, uint32_t rs1, int32_t rs2)
+{
+  URV v = intRegs_.read(rs1) - intRegs_.read(rs2);
+  intRegs_.write(rd, v);
+}
+
+
+template <typename URV>
+void
+Core<URV>::execSll(uint32_t rd, uint32_t rs1, int32_t rs2)
+{
+  URV mask = intRegs_.shiftMask();
+  URV v = intRegs_.read(rs1) << (intRegs_.read(rs2) & mask);
+  intRegs_.write(rd, v);
+}
+
+
+template <typename URV>
+void
+Core<URV>::execSlt(uint32_t rd, uint32_t rs1, int32_t rs2)
+{
+  SRV v1 = intRegs_.read(rs1);
+  SRV v2 = intRegs_.read(rs2);
+  URV v = v1 < v2 ? 1 : 0;
+  intRegs_.write(rd, v);
+}
+
+
+template <typename URV>
+void
+Core<URV>::execSltu(uint32_t rd, uint32_t rs1, int32_t rs2)
+{
+  URV v1 = intRegs_.read(rs1);
+  URV v2 = intRegs_.read(rs2);
+  URV v = v1 < v2 ? 1 : 0;
+  intRegs_.write(rd, v);
+}
+
+
+template <typename URV>
+void
+Core<URV>::execXor(uint32_t rd, uint32_t rs1, int32_t rs2)
+{
+  URV v = intRegs_.read(rs1) ^ intRegs_.read(rs2);
+  intRegs_.write(rd, v);
+}
+
+
+template <typename URV>
+void
+Core<URV>::execSrl(uint32_t rd, uint32_t rs1, int32_t rs2)
+{
+  URV mask = intRegs_.shiftMask();
+  URV v = intRegs_.read(rs1) >> (intRegs_.read(rs2) & mask);
+  intRegs_.write(rd, v);
+}
+
+
+template <typename URV>
+void
+Core<URV>::execSra(uint32_t rd, uint32_t rs1, int32_t rs2)
+{
+  URV mask = intRegs_.shiftMask();
+  URV v = SRV(intRegs_.read(rs1)) >> (intRegs_.read(rs2) & mask);
+  intRegs_.write(rd, v);
+}
+
+
+template <typename URV>
+void
+Core<URV>::execOr(uint32_t rd, uint32_t rs1, int32_t rs2)
+{
+  URV v = intRegs_.read(rs1) | intRegs_.read(rs2);
+  intRegs_.write(rd, v);
+}
+
+
+template <typename URV>
+void
+Core<URV>::execAnd(uint32_t rd, uint32_t rs1, int32_t rs2)
+{
+  URV v = intRegs_.read(rs1) & intRegs_.read(rs2);
+  intRegs_.write(rd, v);
+}
+
+
+template <typename URV>
+void
+Core<URV>::execFence(uint32_t pred, uint32_t succ, int32_t)
+{
+  storeQueue_.clear();
+  loadQueue_.clear();
+}
+
+
+template <typename URV>
+void
+Core<URV>::execFencei(uint32_t, uint32_t, int32_t)
+{
+  // Instruction cache (if modeled) is flushed. Memory is otherwise
+  // coherent.
+  if (icache_.enabled())
+    icache_.invalidate();
+}
+
+
+template <typename URV>
+void
+Core<URV>::execEcall(uint32_t, uint32_t, int32_t)
+{
+  if (triggerTripped_)
+    return;
+
+  if (newlib_)
+    {
+      URV a0 = syscall_.emulate(retiredInsts_);
+      intRegs_.write(RegA0, a0);
+      return;
+    }
+
+  if (privMode_ == PrivilegeMode::Machine)
+    initiateException(ExceptionCause::M_ENV_CALL, currPc_, 0);
+  else if (privMode_ == PrivilegeMode::Supervisor)
+    initiateException(ExceptionCause::S_ENV_CALL, currPc_, 0);
+  else if (privMode_ == PrivilegeMode::User)
+    initiateException(ExceptionCause::U_ENV_CALL, currPc_, 0);
+  else
+    assert(0 and "Invalid privilege mode in execEcall");
+}
+
+
+template <typename URV>
+bool
+Core<URV>::isSemihostingRequest()
+{
+  uint32_t prev = 0, inst = 0, next = 0;
+  return (readInst(currPc_, inst) and inst == 0x00100073 and  // ebreak
+	  readInst(currPc_ - 4, prev) and prev == 0x01f01013 and  // slli
+	  readInst(currPc_ + 4, next) and next == 0x40705013);    // srai
+}
+
+
+template <typename URV>
+void
+Core<URV>::execEbreak(uint32_t, uint32_t, int32_t)
+{
+  if (triggerTripped_)
+    return;
+
+  if (semihosting_ and isSemihostingRequest())
+    {
+      console_.flush();
+      URV a0 = syscall_.semihost(retiredInsts_);
+      intRegs_.write(RegA0, a0);
+      return;
+    }
+
+  // If in machine mode and DCSR bit ebreakm is set, then enter debug mode.
+  if (privMode_ == PrivilegeMode::Machine)
+    {
+      URV dcsrVal = 0;
+      if (peekCsr(CsrNumber::DCSR, dcsrVal))
 	{
-	  std::string rs1n = intRegs_.regName(rs1, abiNames_);
-	  if (rs2 == 0 and f3 == 0)  os << "fmv.d.x  f" << rd << ", " << rs1n;
-	  else                       os << "illegal";
+	  if (dcsrVal & (URV(1) << 15))   // Bit ebreakm is on?
+	    {
+	      // The documentation (RISCV external debug support) does
+	      // not say whether or not we set EPC and MTVAL.
+	      enterDebugMode(DebugModeCause::EBREAK, currPc_);
+	      ebreakInst_ = true;
+	      recordCsrWrite(CsrNumber::DCSR);
+	      return;
+	    }
 	}
-      else
-	os << "illegal";
+    }
+
+  URV savedPc = currPc_;  // Goes into MEPC.
+  URV trapInfo = currPc_;  // Goes into MTVAL.
+
+  initiateException(ExceptionCause::BREAKP, savedPc, trapInfo);
+
+  if (enableGdb_)
+    {
+      pc_ = currPc_;
+      handleExceptionForGdb(*this);
+      return;
+    }
+}
+
+
+template <typename URV>
+void
+Core<URV>::execMret(uint32_t, uint32_t, int32_t)
+{
+  if (privMode_ < PrivilegeMode::Machine)
+    {
+      illegalInst();
+      return;
+    }
+
+  if (triggerTripped_)
+    return;
+
+  // Restore privilege mode and interrupt enable by getting
+  // current value of MSTATUS, ...
+  URV value = 0;
+  if (not csRegs_.read(CsrNumber::MSTATUS, privMode_, debugMode_, value))
+    {
+      illegalInst();
+      return;
+    }
+
+  // ... updating/unpacking its fields,
+  MstatusFields<URV> fields(value);
+  PrivilegeMode savedMode = PrivilegeMode(fields.bits_.MPP);
+  fields.bits_.MIE = fields.bits_.MPIE;
+  fields.bits_.MPP = 0;
+  fields.bits_.MPIE = 1;
+
+  // ... and putting it back
+  if (not csRegs_.write(CsrNumber::MSTATUS, privMode_, debugMode_,
+			fields.value_))
+    assert(0 and "Failed to write MSTATUS register\n");
+
+  // TBD: Handle MPV.
+
+  // Restore program counter from MEPC.
+  URV epc;
+  if (not csRegs_.read(CsrNumber::MEPC, privMode_, debugMode_, epc))
+    illegalInst();
+  pc_ = (epc >> 1) << 1;  // Restore pc clearing least sig bit.
+      
+  // Update privilege mode.
+  privMode_ = savedMode;
+}
+
+
+template <typename URV>
+void
+Core<URV>::execSret(uint32_t, uint32_t, int32_t)
+{
+  if (not isRvs())
+    {
+      illegalInst();
+      return;
+    }
+
+  if (privMode_ < PrivilegeMode::Supervisor)
+    {
+      illegalInst();
+      return;
+    }
+
+  if (triggerTripped_)
+    return;
+
+  // Restore privilege mode and interrupt enable by getting
+  // current value of MSTATUS, ...
+  URV value = 0;
+  if (not csRegs_.read(CsrNumber::SSTATUS, privMode_, debugMode_, value))
+    {
+      illegalInst();
+      return;
+    }
+
+  // ... updating/unpacking its fields,
+  MstatusFields<URV> fields(value);
+  
+  PrivilegeMode savedMode = fields.bits_.SPP? PrivilegeMode::Supervisor :
+    PrivilegeMode::User;
+  fields.bits_.SIE = fields.bits_.SPIE;
+  fields.bits_.SPP = 0;
+  fields.bits_.SPIE = 1;
+
+  // ... and putting it back
+  if (not csRegs_.write(CsrNumber::SSTATUS, privMode_, debugMode_,
+			fields.value_))
+    {
+      illegalInst();
+      return;
+    }
+
+  // Restore program counter from UEPC.
+  URV epc;
+  if (not csRegs_.read(CsrNumber::SEPC, privMode_, debugMode_, epc))
+    {
+      illegalInst();
+      return;
+    }
+  pc_ = (epc >> 1) << 1;  // Restore pc clearing least sig bit.
+
+  // Update privilege mode.
+  privMode_ = savedMode;
+}
+
+
+template <typename URV>
+void
+Core<URV>::execUret(uint32_t, uint32_t, int32_t)
+{
+  if (not isRvu())
+    {
+      illegalInst();
+      return;
+    }
+
+  if (privMode_ != PrivilegeMode::User)
+    {
+      illegalInst();
+      return;
+    }
+
+  if (triggerTripped_)
+    return;
+
+  // Restore privilege mode and interrupt enable by getting
+  // current value of MSTATUS, ...
+  URV value = 0;
+  if (not csRegs_.read(CsrNumber::USTATUS, privMode_, debugMode_, value))
+    {
+      illegalInst();
+      return;
+    }
+
+  // ... updating/unpacking its fields,
+  MstatusFields<URV> fields(value);
+  fields.bits_.UIE = fields.bits_.UPIE;
+  fields.bits_.UPIE = 1;
+
+  // ... and putting it back
+  if (not csRegs_.write(CsrNumber::USTATUS, privMode_, debugMode_,
+			fields.value_))
+    {
+      illegalInst();
+      return;
+    }
+
+  // Restore program counter from UEPC.
+  URV epc;
+  if (not csRegs_.read(CsrNumber::UEPC, privMode_, debugMode_, epc))
+    {
+      illegalInst();
+      return;
+    }
+  pc_ = (epc >> 1) << 1;  // Restore pc clearing least sig bit.
+}
+
+
+template <typename URV>
+void
+Core<URV>::execWfi(uint32_t, uint32_t, int32_t)
+{
+  return;   // Currently implemented as a no-op.
+}
+
+
+template <typename URV>
+void
+Core<URV>::commitCsrWrite(CsrNumber csr, URV csrVal, unsigned intReg,
+			  URV intRegVal)
+{
+  // Most CSRs are plain values: Write those without going through
+  // the special cases below.
+  if (csRegs_.writePlain(csr, privMode_, debugMode_, csrVal))
+    {
+      intRegs_.write(intReg, intRegVal);
+      return;
+    }
+
+  // Make auto-increment happen before write for minstret and cycle.
+  if (csr == CsrNumber::MINSTRET or csr == CsrNumber::MINSTRETH)
+    retiredInsts_++;
+  if (csr == CsrNumber::MCYCLE or csr == CsrNumber::MCYCLEH)
+    cycleCount_++;
+
+  // Update CSR and integer register.
+  csRegs_.write(csr, privMode_, debugMode_, csrVal);
+  intRegs_.write(intReg, intRegVal);
+
+  if (csr == CsrNumber::DCSR)
+    {
+      dcsrStep_ = (csrVal >> 2) & 1;
+      dcsrStepIe_ = (csrVal >> 11) & 1;
+    }
+  else if (csr == CsrNumber::MGPMC)
+    {
+      prevCountersCsrOn_ = countersCsrOn_;
+      countersCsrOn_ = (csrVal & 1) == 1;
+    }
+
+  // Csr was written. If it was minstret, compensate for
+  // auto-increment that will be done by run, runUntilAddress or
+  // singleStep method.
+  if (csr == CsrNumber::MINSTRET or csr == CsrNumber::MINSTRETH)
+    retiredInsts_--;
+
+  // Same for mcycle.
+  if (csr == CsrNumber::MCYCLE or csr == CsrNumber::MCYCLEH)
+    cycleCount_--;
+}
+
+
+// Set control and status register csr to value of register rs1 and
+// save its original value in register rd.
+template <typename URV>
+void
+Core<URV>::execCsrrw(uint32_t rd, uint32_t rs1, int32_t c)
+{
+  if (triggerTripped_)
+    return;
+
+  CsrNumber csr = CsrNumber(c);
+  if (csr <= CsrNumber::FCSR)
+    syncFpFlags();  // FCSR must be up to date.
+
+  URV prev = 0;
+  if (not csRegs_.readFast(csr, privMode_, debugMode_, prev))
+    {
+      illegalInst();
+      csrException_ = true;
       return;
     }
 
-  if (f7 == 0)          printFp32f(os, "fadd.s", rd, rs1, rs2, mode);
-  else if (f7 == 4)     printFp32f(os, "fsub.s", rd, rs1, rs2, mode);
-  else if (f7 == 8)     printFp32f(os, "fmul.s", rd, rs1, rs2, mode);
-  else if (f7 == 0xc)   printFp32f(os, "div.s", rd, rs1, rs2, mode);
-  else if (f7 == 0x10)
+  URV next = intRegs_.read(rs1);
+
+  if (not csRegs_.isWriteable(csr, privMode_, debugMode_))
     {
-      if      (f3 == 0) os << "fsgnj.s  f" << rd << ", f" << rs1;
-      else if (f3 == 1) os << "fsgnjn.s f" << rd << ", f" << rs1;
-      else if (f3 == 2) os << "fsgnjx.s f" << rd << ", f" << rs1;
-      else              os << "illegal";
+      illegalInst();
+      csrException_ = true;
+      return;
     }
-  else if (f7 == 0x14)
+
+  commitCsrWrite(csr, next, rd, prev);
+}
+
+
+template <typename URV>
+void
+Core<URV>::execCsrrs(uint32_t rd, uint32_t rs1, int32_t c)
+{
+  if (triggerTripped_)
+    return;
+
+  CsrNumber csr = CsrNumber(c);
+  if (csr <= CsrNumber::FCSR)
+    syncFpFlags();  // FCSR must be up to date.
+
+  URV prev = 0;
+  if (not csRegs_.readFast(csr, privMode_, debugMode_, prev))
     {
-      if      (f3 == 0) os << "fmin.s  f" << rd << ", f" << rs1 << ", f" << rs2;
-      else if (f3 == 1)	os << "fmax.s  f" << rd << ", f" << rs1 << ", f" << rs2;
-      else              os << "illegal";
+      illegalInst();
+      csrException_ = true;
+      return;
     }
-  
-  else if (f7 == 0x20 and rs2 == 1)
-    os << "fcvt.s.d f" << rd << ", f" << rs1 << ", " << rms;
-  else if (f7 == 0x2c)
-    os << "fsqrt.s  f" << rd << ", f" << rs1 << ", " << rms;
-  else if (f7 == 0x50)
+
+  URV next = prev | intRegs_.read(rs1);
+  if (rs1 == 0)
     {
-      std::string rdn = intRegs_.regName(rd, abiNames_);
-      if      (f3 == 0) os << "fle.s    " << rdn << ", f" << rs1 << ", f" << rs2;
-      else if (f3 == 1) os << "flt.s    " << rdn << ", f" << rs1 << ", f" << rs2;
-      else if (f3 == 2) os << "feq.s    " << rdn << ", f" << rs1 << ", f" << rs2;
-      else              os << "illegal";
+      intRegs_.write(rd, prev);
+      return;
     }
-  else if (f7 == 0x60)
+
+  if (not csRegs_.isWriteable(csr, privMode_, debugMode_))
     {
-      std::string rdn = intRegs_.regName(rd, abiNames_);
-      if      (rs2==0) os << "fcvt.w.s "  << rdn << ", f" << rs1 << ", " << rms;
-      else if (rs2==1) os << "fcvt.wu.s " << rdn << ", f" << rs1 << ", " << rms;
-      else if (rs2==2) os << "fcvt.l.s "  << rdn << ", f" << rs1 << ", " << rms;
-      else if (rs2==3) os << "fcvt.lu.s " << rdn << ", f" << rs1 << ", " << rms;
-      else             os << "illegal";
+      illegalInst();
+      csrException_ = true;
+      return;
     }
-  else if (f7 == 0x68)
+
+  commitCsrWrite(csr, next, rd, prev);
+}
+
+
+template <typename URV>
+void
+Core<URV>::execCsrrc(uint32_t rd, uint32_t rs1, int32_t c)
+{
+  if (triggerTripped_)
+    return;
+
+  CsrNumber csr = CsrNumber(c);
+  if (csr <= CsrNumber::FCSR)
+    syncFpFlags();  // FCSR must be up to date.
+
+  URV prev = 0;
+  if (not csRegs_.readFast(csr, privMode_, debugMode_, prev))
     {
-      std::string rs1n = intRegs_.regName(rs1, abiNames_);
+      illegalInst();
+      csrException_ = true;
+      return;
+    }
 
-      if      (rs2==0) os << "fcvt.s.w f"  << rd << ", " << rs1n << ", " << rms;
-      else if (rs2==1) os << "fcvt.s.wu f" << rd << ", " << rs1n << ", " << rms;
-      else if (rs2==2) os << "fcvt.s.l f"  << rd << ", " << rs1n << ", " << rms;
-      else if (rs2==3) os << "fcvt.s.lu f" << rd << ", " << rs1n << ", " << rms;
-      else             os << "illegal";
+  URV next = prev & (~ intRegs_.read(rs1));
+  if (rs1 == 0)
+    {
+      intRegs_.write(rd, prev);
+      return;
     }
-  else if (f7 == 0x70)
+
+  if (not csRegs_.isWriteable(csr, privMode_, debugMode_))
     {
-      std::string rdn = intRegs_.regName(rd, abiNames_);
-      if      (rs2 == 0 and f3 == 0)  os << "fmv.x.w  " << rdn << ", f" << rs1;
-      else if (rs2 == 0 and f3 == 1)  os << "fclass.s " << rdn << ", f" << rs1;
-      else                            os << "illegal";
+      illegalInst();
+      csrException_ = true;
+      return;
     }
-  else if (f7 == 0x74)
+
+  commitCsrWrite(csr, next, rd, prev);
+}
+
+
+template <typename URV>
+void
+Core<URV>::execCsrrwi(uint32_t rd, uint32_t imm, int32_t c)
+{
+  if (triggerTripped_)
+    return;
+
+  CsrNumber csr = CsrNumber(c);
+  if (csr <= CsrNumber::FCSR)
+    syncFpFlags();  // FCSR must be up to date.
+
+  URV prev = 0;
+  if (rd != 0 and not csRegs_.readFast(csr, privMode_, debugMode_, prev))
     {
-      std::string rs1n = intRegs_.regName(rs1, abiNames_);
-      if (rs2 == 0 and f3 == 0)  os << "fmv.w.x  f" << rd << ", " << rs1n;
-      else                       os << "illegal";
+      illegalInst();
+      csrException_ = true;
+      return;
     }
-  else
-    os << "illegal";
+
+  if (not csRegs_.isWriteable(csr, privMode_, debugMode_))
+    {
+      illegalInst();
+      csrException_ = true;
+      return;
+    }
+
+  commitCsrWrite(csr, imm, rd, prev);
 }
 
 
 template <typename URV>
 void
-Core<URV>::printAmoInst(std::ostream& stream, const char* inst, bool aq,
-			bool rl, unsigned rd, unsigned rs1, unsigned rs2)
+Core<URV>::execCsrrsi(uint32_t rd, uint32_t imm, int32_t c)
 {
-  stream << inst;
+  if (triggerTripped_)
+    return;
 
-  if (aq)
-    stream << ".aq";
+  CsrNumber csr = CsrNumber(c);
+  if (csr <= CsrNumber::FCSR)
+    syncFpFlags();  // FCSR must be up to date.
 
-  if (rl)
-    stream << ".rl";
+  URV prev = 0;
+  if (not csRegs_.readFast(csr, privMode_, debugMode_, prev))
+    {
+      illegalInst();
+      csrException_ = true;
+      return;
+    }
 
-  stream << ' ';
-  stream << intRegs_.regName(rd,  abiNames_) << ", "
-	 << intRegs_.regName(rs1, abiNames_) << ", "
-    	 << intRegs_.regName(rs2, abiNames_);
+  URV next = prev | imm;
+  if (imm == 0)
+    {
+      intRegs_.write(rd, prev);
+      return;
+    }
+
+  if (not csRegs_.isWriteable(csr, privMode_, debugMode_))
+    {
+      illegalInst();
+      csrException_ = true;
+      return;
+    }
+
+  commitCsrWrite(csr, next, rd, prev);
+}
+
+
+template <typename URV>
+void
+Core<URV>::execCsrrci(uint32_t rd, uint32_t imm, int32_t c)
+{
+  if (triggerTripped_)
+    return;
+
+  CsrNumber csr = CsrNumber(c);
+  if (csr <= CsrNumber::FCSR)
+    syncFpFlags();  // FCSR must be up to date.
+
+  URV prev = 0;
+  if (not csRegs_.readFast(csr, privMode_, debugMode_, prev))
+    {
+      illegalInst();
+      csrException_ = true;
+      return;
+    }
+
+  URV next = prev & (~ imm);
+  if (imm == 0)
+    {
+      intRegs_.write(rd, prev);
+      return;
+    }
+
+  if (not csRegs_.isWriteable(csr, privMode_, debugMode_))
+    {
+      illegalInst();
+      csrException_ = true;
+      return;
+    }
+
+  commitCsrWrite(csr, next, rd, prev);
+}
+
+
+template <typename URV>
+void
+Core<URV>::execLb(uint32_t rd, uint32_t rs1, int32_t imm)
+{
+  load<int8_t>(rd, rs1, imm);
 }
 
 
 template <typename URV>
 void
-Core<URV>::printLrInst(std::ostream& stream, const char* inst, bool aq,
-		       bool rl, unsigned rd, unsigned rs1)
+Core<URV>::execLbu(uint32_t rd, uint32_t rs1, int32_t imm)
 {
-  stream << inst;
-
-  if (aq)
-    stream << ".aq";
-
-  if (rl)
-    stream << ".rl";
-
-  stream << ' ';
-  stream << intRegs_.regName(rd, abiNames_)
-	 << ", (" << intRegs_.regName(rs1, abiNames_) << ")";
+  load<uint8_t>(rd, rs1, imm);
 }
 
 
 template <typename URV>
 void
-Core<URV>::printScInst(std::ostream& stream, const char* inst, bool aq,
-		       bool rl, unsigned rd, unsigned rs1, unsigned rs2)
+Core<URV>::execLhu(uint32_t rd, uint32_t rs1, int32_t imm)
 {
-  stream << inst;
+  load<uint16_t>(rd, rs1, imm);
+}
 
-  if (aq)
-    stream << ".aq";
 
-  if (rl)
-    stream << ".rl";
+template <typename URV>
+void
+Core<URV>::writeConsoleBuffer(URV descAddr)
+{
+  URV addr = 0, size = 0;
+  if (not memory_.read(descAddr, addr) or
+      not memory_.read(descAddr + sizeof(URV), size))
+    return;
 
-  stream << ' ';
+  size_t simAddr = 0;
+  if (size == 0 or addr > memory_.size() or size > memory_.size() - addr or
+      not memory_.getSimMemAddr(addr, simAddr))
+    return;
 
-  stream << intRegs_.regName(rd, abiNames_)
-	 << ", " << intRegs_.regName(rs2, abiNames_)
-	 << ", (" << intRegs_.regName(rs1) << ")";
+  console_.write(reinterpret_cast<const uint8_t*>(simAddr), size);
 }
 
 
 template <typename URV>
+template <typename STORE_TYPE>
 void
-Core<URV>::disassembleInst32(uint32_t inst, std::ostream& stream)
+Core<URV>::store(URV addr, STORE_TYPE storeVal)
 {
-  if (not isFullSizeInst(inst))
+  // ld/st-address or instruction-address triggers have priority over
+  // ld/st access or misaligned exceptions.
+  bool hasTrig = hasActiveTrigger();
+  TriggerTiming timing = TriggerTiming::Before;
+  bool isLoad = false;
+  if (hasTrig)
+    if (ldStAddrTriggerHit(addr, timing, isLoad, isInterruptEnabled()))
+      triggerTripped_ = true;
+
+  // Misaligned store to io section causes an exception. Crossing dccm
+  // to non-dccm causes an exception.
+  constexpr unsigned alignMask = sizeof(STORE_TYPE) - 1;
+  bool misaligned = addr & alignMask;
+  misalignedLdSt_ = misaligned;
+  if (misaligned and misalignedAccessCausesException(addr, sizeof(STORE_TYPE)))
     {
-      stream << "illegal";  // Not a compressed instruction.
+      if (triggerTripped_)
+	return;  // No exception if earlier trig. Suppress store data trig.
+      forceAccessFail_ = false;
+      ldStException_ = true;
+      initiateException(ExceptionCause::STORE_ADDR_MISAL, currPc_, addr);
       return;
     }
 
-  unsigned opcode = (inst & 0x7f) >> 2;  // Upper 5 bits of opcode.
+  STORE_TYPE maskedVal = storeVal;
+  if (hasTrig and not forceAccessFail_ and memory_.checkWrite(addr, maskedVal))
+    {
+      // No exception: consider store-data  trigger
+      if (ldStDataTriggerHit(maskedVal, timing, isLoad, isInterruptEnabled()))
+	triggerTripped_ = true;
+    }
+  if (triggerTripped_)
+    return;
 
-  switch (opcode)
+  if (not forceAccessFail_ and memory_.write(addr, storeVal))
     {
-    case 0:  // 00000   I-form
-      {
-	IFormInst iform(inst);
-	unsigned rd = iform.fields.rd, rs1 = iform.fields.rs1;
-	int32_t imm = iform.immed();
-	switch (iform.fields.funct3)
-	  {
-	  case 0:  printInstLdSt(stream, "lb",  rd, rs1, imm); break;
-	  case 1:  printInstLdSt(stream, "lh",  rd, rs1, imm); break;
-	  case 2:  printInstLdSt(stream, "lw",  rd, rs1, imm); break;
-	  case 3:  printInstLdSt(stream, "ld",  rd, rs1, imm); break;
-	  case 4:  printInstLdSt(stream, "lbu", rd, rs1, imm); break;
-	  case 5:  printInstLdSt(stream, "lhu", rd, rs1, imm); break;
-	  case 6:  printInstLdSt(stream, "lwu", rd, rs1, imm); break;
-	  default: stream << "illegal";                        break;
-	  }
-      }
-      break;
+      if (hasLr_ and lrAddr_ == addr)
+	hasLr_ = false;
 
-    case 1:   // 0001 I-Form
-      {
-	IFormInst iform(inst);
-	unsigned rd = iform.fields.rd, rs1 = iform.fields.rs1;
-	int32_t imm = iform.immed();
-	uint32_t f3 = iform.fields.funct3;
-	if (f3 == 2)
-	  {
-	    if (isRvf())
-	      printInstFpLdSt(stream, "flw", rd, rs1, imm);
-	    else
-	      stream << "illegal";
-	  }
-	else if (f3 == 3)
-	  {
-	    if (isRvd())
-	      printInstFpLdSt(stream, "fld", rd, rs1, imm);
-	    else
-	      stream << "illegal";
-	  }
-	else
-	  stream << "illegal";
-      }
-      break;
+      if (dcache_.enabled())
+	accessDataCache(addr, sizeof(STORE_TYPE), true);
+      if (memTrace_.enabled())
+	traceDataAccess(addr, sizeof(STORE_TYPE), true);
+      if (pageProfile_.enabled())
+	pageProfile_.access(PageProfile::Access::Write, addr, retiredInsts_);
 
-    case 3:  // 00011  I-form
-      {
-	IFormInst iform(inst);
-	unsigned rd = iform.fields.rd, rs1 = iform.fields.rs1;
-	unsigned funct3 = iform.fields.funct3;
-	if (rd != 0 or rs1 != 0)
-	  stream << "illegal";
-	else if (funct3 == 0)
-	  {
-	    if (iform.top4() != 0)
-	      stream << "illegal";
-	    else
-	      stream << "fence  " << iform.pred() << ", " << iform.succ();
-	  }
-	else if (funct3 == 1)
-	  {
-	    if (iform.uimmed() != 0)
-	      stream << "illegal";
-	    else
-	      stream << "fence.i ";
-	  }
-	else
-	  stream << "illegal";
-      }
-      break;
+      if (watchCheck_)
+	checkWatchpoint(addr, sizeof(STORE_TYPE), false);
 
-    case 4:  // 00100  I-form
-      {
-	IFormInst iform(inst);
-	unsigned rd = iform.fields.rd, rs1 = iform.fields.rs1;
-	int32_t imm = iform.immed();
-	switch (iform.fields.funct3)
-	  {
-	  case 0: 
-	    printInstRegRegImm12(stream, "addi", rd, rs1, imm);
-	    break;
-	  case 1: 
+      // If we write to special location, end the simulation.
+      if (toHostValid_ and addr == toHost_ and storeVal != 0)
+	{
+	  throw CoreException(CoreException::Stop, "write to to-host",
+			      toHost_, storeVal);
+	}
+
+      // If addr is special location, then write to console.
+      if constexpr (sizeof(STORE_TYPE) == 1)
+        {
+	  if (conIoValid_ and addr == conIo_)
 	    {
-	      unsigned topBits = 0, shamt = 0;
-	      iform.getShiftFields(isRv64(), topBits, shamt);
-	      if (topBits == 0)
-		printInstShiftImm(stream, "slli", rd, rs1, shamt);
-	      else
-		stream << "illegal";
+	      console_.putChar(storeVal);
+	      return;
 	    }
-	    break;
-	  case 2:
-	    printInstRegRegImm12(stream, "slti", rd, rs1, imm);
-	    break;
-	  case 3:
-	    printInstRegRegImm12(stream, "sltiu", rd, rs1, imm);
-	    break;
-	  case 4:
-	    printInstRegRegImm12(stream, "xori", rd, rs1, imm);
-	    break;
-	  case 5:
+	}
+      if constexpr (sizeof(STORE_TYPE) == sizeof(URV))
+        {
+	  if (conIoValid_ and addr == conIo_)
 	    {
-	      unsigned topBits = 0, shamt = 0;
-	      iform.getShiftFields(isRv64(), topBits, shamt);
-	      if (topBits == 0)
-		printInstShiftImm(stream, "srli", rd, rs1, shamt);
-	      else
-		{
-		  if (isRv64())
-		    topBits <<= 1;
-		  if (topBits == 0x20)
-		    printInstShiftImm(stream, "srai", rd, rs1, shamt);
-		  else
-		    stream << "illegal";
-		}
+	      writeConsoleBuffer(storeVal);
+	      return;
 	    }
-	    break;
-	  case 6:
-	    printInstRegRegImm12(stream, "ori", rd, rs1, imm);
-	    break;
-	  case 7:
-	    printInstRegRegImm12(stream, "andi", rd, rs1, imm);
-	    break;
-	  default:
-	    stream << "illegal";
-	    break;
-	  }
-      }
-      break;
+	}
+      if (maxStoreQueueSize_)
+	{
+	  uint64_t prevVal = 0;
+	  memory_.getLastWriteOldValue(prevVal);
+	  putInStoreQueue(sizeof(STORE_TYPE), addr, storeVal, prevVal);
+	}
+    }
+  else
+    {
+      forceAccessFail_ = false;
+      ldStException_ = true;
+      initiateException(ExceptionCause::STORE_ACC_FAULT, currPc_, addr);
+    }
+}
+
+
+template <typename URV>
+void
+Core<URV>::execSb(uint32_t rs1, uint32_t rs2, int32_t imm)
+{
+  URV addr = intRegs_.read(rs1) + SRV(imm);
+  URV value = intRegs_.read(rs2);
+
+  store<uint8_t>(addr, value);
+}
+
+
+template <typename URV>
+void
+Core<URV>::execSh(uint32_t rs1, uint32_t rs2, int32_t imm)
+{
+  URV addr = intRegs_.read(rs1) + SRV(imm);
+  URV value = intRegs_.read(rs2);
+
+  store<uint16_t>(addr, value);
+}
+
+
+namespace WdRiscv
+{
+
+  template<>
+  void
+  Core<uint32_t>::execMul(uint32_t rd, uint32_t rs1, int32_t rs2)
+  {
+    int32_t a = intRegs_.read(rs1);
+    int32_t b = intRegs_.read(rs2);
 
-    case 5:  // 00101   U-form
-      {
-	UFormInst uform(inst);
-	stream << "auipc    " << intRegs_.regName(uform.bits.rd, abiNames_)
-	       << ", 0x" << std::hex << ((uform.immed() >> 12) & 0xfffff);
-      }
-      break;
+    int32_t c = a * b;
+    intRegs_.write(rd, c);
+  }
 
-    case 6:  // 00110  I-form
-      {
-	IFormInst iform(inst);
-	unsigned rd = iform.fields.rd, rs1 = iform.fields.rs1;
-	int32_t imm = iform.immed();
-	unsigned funct3 = iform.fields.funct3;
-	if (funct3 == 0)
-	  {
-	    if (isRv64())
-	      printInstRegRegImm12(stream, "addi", rd, rs1, imm);
-	    else
-	      stream << "illegal";
-	  }
-	else if (funct3 == 1)
-	  {
-	    if (iform.top7() != 0)
-	      stream << "illegal";
-	    else if (isRv64())
-	      printInstShiftImm(stream, "slliw", rd, rs1, iform.fields2.shamt);
-	    else
-	      stream << "illegal";
-	  }
-	else if (funct3 == 5)
-	  {
-	    if (iform.top7() == 0)
-	      printInstShiftImm(stream, "srliw", rd, rs1, iform.fields2.shamt);
-	    else if (iform.top7() == 0x20)
-	      printInstShiftImm(stream, "sraiw", rd, rs1, iform.fields2.shamt);
-	    else
-	      stream << "illegal";
-	  }
-	else
-	  stream << "illegal";
-      }
-      break;
 
-    case 8:  // 01000  S-form
-      {
-	SFormInst sform(inst);
-	unsigned rs1 = sform.bits.rs1, rs2 = sform.bits.rs2;
-	int32_t imm = sform.immed();
-	switch (sform.bits.funct3)
-	  {
-	  case 0:  printInstLdSt(stream, "sb", rs2, rs1, imm); break;
-	  case 1:  printInstLdSt(stream, "sh", rs2, rs1, imm); break;
-	  case 2:  printInstLdSt(stream, "sw", rs2, rs1, imm); break;
-	  default:
-	    if (not isRv64())
-	      stream << "illegal";
-	    else
-	      printInstLdSt(stream, "sd", rs2, rs1, imm);
-	    break;
-	  }
-      }
-      break;
+  template<>
+  void
+  Core<uint32_t>::execMulh(uint32_t rd, uint32_t rs1, int32_t rs2)
+  {
+    int64_t a = int32_t(intRegs_.read(rs1));  // sign extend.
+    int64_t b = int32_t(intRegs_.read(rs2));
+    int64_t c = a * b;
+    int32_t high = c >> 32;
 
-    case 9:   // 01001  S-form
-      {
-	SFormInst sf(inst);
-	unsigned rs1 = sf.bits.rs1, rs2 = sf.bits.rs2, f3 = sf.bits.funct3;
-	int32_t imm = sf.immed();
-	if (f3 == 2)
-	  {
-	    if (isRvf())
-	      printInstFpLdSt(stream, "fsw", rs2, rs1, imm);
-	    else
-	      stream << "illegal";
-	  }
-	else if (f3 == 3)
-	  {
-	    if (isRvd())
-	      printInstFpLdSt(stream, "fsd", rs2, rs1, imm);
-	    else
-	      stream << "illegal";
-	  }
-	else
-	  stream << "illegal";
-      }
-      break;
+    intRegs_.write(rd, high);
+  }
 
-    case 11:  // 01011  R-form  atomics
-      {
-	if (not isRva())
-	  {
-	    stream << "illegal";
-	    break;
-	  }
 
-	RFormInst rf(inst);
-	uint32_t top5 = rf.top5(), f3 = rf.bits.funct3;
-	uint32_t rd = rf.bits.rd, rs1 = rf.bits.rs1, rs2 = rf.bits.rs2;
-	bool rl = rf.rl(), aq = rf.aq();
-	if (f3 == 2)
-	  {
-	    if (top5 == 0)
-	      printAmoInst(stream, "amoadd.w", aq, rl, rd, rs1, rs2);
-	    else if (top5 == 1)
-	      printAmoInst(stream, "amoswap.w", aq, rl, rd, rs1, rs2);
-	    else if (top5 == 2)
-	      printLrInst(stream, "lr.w", aq, rl, rd, rs1);
-	    else if (top5 == 3)
-	      printScInst(stream, "sc.w", aq, rl, rd, rs1, rs2);
-	    else if (top5 == 4)
-	      printAmoInst(stream, "amoxor.w", aq, rl, rd, rs1, rs2);
-	    else if (top5 == 8)
-	      printAmoInst(stream, "amoor.w", aq, rl, rd, rs1, rs2);
-	    else if (top5 == 0x0c)
-	      printAmoInst(stream, "amoand.w", aq, rl, rd, rs1, rs2);
-	    else if (top5 == 0x10)
-	      printAmoInst(stream, "ammin.w", aq, rl, rd, rs1, rs2);
-	    else if (top5 == 0x14)
-	      printAmoInst(stream, "amomax.w", aq, rl, rd, rs1, rs2);
-	    else if (top5 == 0x18)
-	      printAmoInst(stream, "amominu.w", aq, rl, rd, rs1, rs2);
-	    else if (top5 == 0x1c)
-	      printAmoInst(stream, "amomaxu.w", aq, rl, rd, rs1, rs2);
-	    else
-	      stream << "illegal";
-	  }
-	else if (f3 == 3)
-	  {
-	    if (top5 == 0)
-	      printAmoInst(stream, "amoadd.d", aq, rl, rd, rs1, rs2);
-	    else if (top5 == 1)
-	      printAmoInst(stream, "amoswap.d", aq, rl, rd, rs1, rs2);
-	    else if (top5 == 2)
-	      printLrInst(stream, "lr.d", aq, rl, rd, rs1);
-	    else if (top5 == 3)
-	      printScInst(stream, "sc.d", aq, rl, rd, rs1, rs2);
-	    else if (top5 == 4)
-	      printAmoInst(stream, "amoxor.d", aq, rl, rd, rs1, rs2);
-	    else if (top5 == 8)
-	      printAmoInst(stream, "amoor.d", aq, rl, rd, rs1, rs2);
-	    else if (top5 == 0x0c)
-	      printAmoInst(stream, "amoand.d", aq, rl, rd, rs1, rs2);
-	    else if (top5 == 0x10)
-	      printAmoInst(stream, "ammin.d", aq, rl, rd, rs1, rs2);
-	    else if (top5 == 0x14)
-	      printAmoInst(stream, "amomax.d", aq, rl, rd, rs1, rs2);
-	    else if (top5 == 0x18)
-	      printAmoInst(stream, "amominu.d", aq, rl, rd, rs1, rs2);
-	    else if (top5 == 0x1c)
-	      printAmoInst(stream, "amomaxu.d", aq, rl, rd, rs1, rs2);
-	    else
-	      stream << "illegal";
-	  }
-	else stream << "illegal";
-      }
-      break;
+  template <>
+  void
+  Core<uint32_t>::execMulhsu(uint32_t rd, uint32_t rs1, int32_t rs2)
+  {
+    int64_t a = int32_t(intRegs_.read(rs1));
+    uint64_t b = intRegs_.read(rs2);
+    int64_t c = a * b;
+    int32_t high = c >> 32;
 
-    case 12:  // 01100  R-form
-      {
-	RFormInst rform(inst);
-	unsigned rd = rform.bits.rd, rs1 = rform.bits.rs1, rs2 = rform.bits.rs2;
-	unsigned f7 = rform.bits.funct7, f3 = rform.bits.funct3;
-	if (f7 == 0)
-	  {
-	    if      (f3 == 0)  printInstRdRs1Rs2(stream, "add",  rd, rs1, rs2);
-	    else if (f3 == 1)  printInstRdRs1Rs2(stream, "sll",  rd, rs1, rs2);
-	    else if (f3 == 2)  printInstRdRs1Rs2(stream, "slt",  rd, rs1, rs2);
-	    else if (f3 == 3)  printInstRdRs1Rs2(stream, "sltu", rd, rs1, rs2);
-	    else if (f3 == 4)  printInstRdRs1Rs2(stream, "xor",  rd, rs1, rs2);
-	    else if (f3 == 5)  printInstRdRs1Rs2(stream, "srl",  rd, rs1, rs2);
-	    else if (f3 == 6)  printInstRdRs1Rs2(stream, "or",   rd, rs1, rs2);
-	    else if (f3 == 7)  printInstRdRs1Rs2(stream, "and",  rd, rs1, rs2);
-	  }
-	else if (f7 == 1)
-	  {
-	    if      (not isRvm())  stream << "illegal";
-	    else if (f3 == 0) printInstRdRs1Rs2(stream, "mul",    rd, rs1, rs2);
-	    else if (f3 == 1) printInstRdRs1Rs2(stream, "mulh",   rd, rs1, rs2);
-	    else if (f3 == 2) printInstRdRs1Rs2(stream, "mulhsu", rd, rs1, rs2);
-	    else if (f3 == 3) printInstRdRs1Rs2(stream, "mulhu",  rd, rs1, rs2);
-	    else if (f3 == 4) printInstRdRs1Rs2(stream, "div",    rd, rs1, rs2);
-	    else if (f3 == 5) printInstRdRs1Rs2(stream, "divu",   rd, rs1, rs2);
-	    else if (f3 == 6) printInstRdRs1Rs2(stream, "rem",    rd, rs1, rs2);
-	    else if (f3 == 7) printInstRdRs1Rs2(stream, "remu",   rd, rs1, rs2);
-	  }
-	else if (f7 == 0x20)
-	  {
-	    if      (f3 == 0)  printInstRdRs1Rs2(stream, "sub", rd, rs1, rs2);
-	    else if (f3 == 5)  printInstRdRs1Rs2(stream, "sra", rd, rs1, rs2);
-	    else               stream << "illegal";
-	  }
-	else
-	  stream << "illegal";
-      }
-      break;
+    intRegs_.write(rd, high);
+  }
+
+
+  template <>
+  void
+  Core<uint32_t>::execMulhu(uint32_t rd, uint32_t rs1, int32_t rs2)
+  {
+    uint64_t a = intRegs_.read(rs1);
+    uint64_t b = intRegs_.read(rs2);
+    uint64_t c = a * b;
+    uint32_t high = c >> 32;
+
+    intRegs_.write(rd, high);
+  }
+
+
+  template<>
+  void
+  Core<uint64_t>::execMul(uint32_t rd, uint32_t rs1, int32_t rs2)
+  {
+    __int128_t a = int64_t(intRegs_.read(rs1));  // sign extend to 64-bit
+    __int128_t b = int64_t(intRegs_.read(rs2));
+
+    int64_t c = a * b;
+    intRegs_.write(rd, c);
+  }
+
+
+  template<>
+  void
+  Core<uint64_t>::execMulh(uint32_t rd, uint32_t rs1, int32_t rs2)
+  {
+    __int128_t a = int64_t(intRegs_.read(rs1));  // sign extend.
+    __int128_t b = int64_t(intRegs_.read(rs2));
+    __int128_t c = a * b;
+    int64_t high = c >> 64;
+
+    intRegs_.write(rd, high);
+  }
 
-    case 13:  // 01101  U-form
-      {
-	UFormInst uform(inst);
-	uint32_t imm = uform.immed();
-	stream << "lui      x" << uform.bits.rd << ", ";
-	if (imm < 0) { stream << "-"; imm = -imm; }
-	stream << "0x" << std::hex << ((imm >> 12) & 0xfffff);
-      }
-      break;
 
-    case 14:  // 01110  R-Form
-      {
-	const RFormInst rform(inst);
-	unsigned rd = rform.bits.rd, rs1 = rform.bits.rs1, rs2 = rform.bits.rs2;
-	unsigned f7 = rform.bits.funct7, f3 = rform.bits.funct3;
-	if (f7 == 0)
-	  {
-	    if      (f3 == 0)  printInstRdRs1Rs2(stream, "addw", rd, rs1, rs2);
-	    else if (f3 == 1)  printInstRdRs1Rs2(stream, "sllw", rd, rs1, rs2);
-	    else if (f3 == 5)  printInstRdRs1Rs2(stream, "srlw", rd, rs1, rs2);
-	    else               stream << "illegal";
-	  }
-	else if (f7 == 1)
-	  {
-	    if      (f3 == 0)  printInstRdRs1Rs2(stream, "mulw",  rd, rs1, rs2);
-	    else if (f3 == 4)  printInstRdRs1Rs2(stream, "divw",  rd, rs1, rs2);
-	    else if (f3 == 5)  printInstRdRs1Rs2(stream, "divuw", rd, rs1, rs2);
-	    else if (f3 == 6)  printInstRdRs1Rs2(stream, "remw",  rd, rs1, rs2);
-	    else if (f3 == 7)  printInstRdRs1Rs2(stream, "remuw", rd, rs1, rs2);
-	    else               stream << "illegal";
-	  }
-	else if (f7 == 0x20)
-	  {
-	    if      (f3 == 0)  printInstRdRs1Rs2(stream, "subw", rd, rs1, rs2);
-	    else if (f3 == 5)  printInstRdRs1Rs2(stream, "sraw", rd, rs1, rs2);
-	    else               stream << "illegal";
-	  }
-	else
-	  stream << "illegal";
-      }
-      break;
+  template <>
+  void
+  Core<uint64_t>::execMulhsu(uint32_t rd, uint32_t rs1, int32_t rs2)
+  {
+    __int128_t a = int64_t(intRegs_.read(rs1));
+    __uint128_t b = intRegs_.read(rs2);
+    __int128_t c = a * b;
+    int64_t high = c >> 64;
 
-    case 16:  // 10000   rform
-      {
-	RFormInst rform(inst);
-	unsigned rd = rform.bits.rd, rs1 = rform.bits.rs1, rs2 = rform.bits.rs2;
-	unsigned f7 = rform.bits.funct7, f3 = rform.bits.funct3;
-	unsigned rs3 = f7 >> 2;
-	RoundingMode mode = RoundingMode(f3);
-	if ((f7 & 3) == 0)
-	  printFp32f(stream, "fmadd_s", rd, rs1, rs2, rs3, mode);
-	else if ((f7 & 3) == 1)
-	  printFp32d(stream, "fmadd_d", rd, rs1, rs2, rs3, mode);
-	else
-	  stream << "illegal";
-      }
-      break;
+    intRegs_.write(rd, high);
+  }
 
-    case 17:  // 10001   rform
-      {
-	RFormInst rform(inst);
-	unsigned rd = rform.bits.rd, rs1 = rform.bits.rs1, rs2 = rform.bits.rs2;
-	unsigned f7 = rform.bits.funct7, f3 = rform.bits.funct3;
-	unsigned rs3 = f7 >> 2;
-	RoundingMode mode = RoundingMode(f3);
-	if ((f7 & 3) == 0)
-	  printFp32f(stream, "fmsub_s", rd, rs1, rs2, rs3, mode);
-	else if ((f7 & 3) == 1)
-	  printFp32d(stream, "fmsub_d", rd, rs1, rs2, rs3, mode);
-	else
-	  stream << "illegal";
-      }
-      break;
 
-    case 18:  // 10010   rform
-      {
-	RFormInst rform(inst);
-	unsigned rd = rform.bits.rd, rs1 = rform.bits.rs1, rs2 = rform.bits.rs2;
-	unsigned f7 = rform.bits.funct7, f3 = rform.bits.funct3;
-	unsigned rs3 = f7 >> 2;
-	RoundingMode mode = RoundingMode(f3);
-	if ((f7 & 3) == 0)
-	  printFp32f(stream, "fnmsub_s", rd, rs1, rs2, rs3, mode);
-	else if ((f7 & 3) == 1)
-	  printFp32d(stream, "fnmsub_d", rd, rs1, rs2, rs3, mode);
-	else
-	  stream << "illegal";
-      }
-      break;
+  template <>
+  void
+  Core<uint64_t>::execMulhu(uint32_t rd, uint32_t rs1, int32_t rs2)
+  {
+    __uint128_t a = intRegs_.read(rs1);
+    __uint128_t b = intRegs_.read(rs2);
+    __uint128_t c = a * b;
+    uint64_t high = c >> 64;
 
-    case 19:  // 10011   rform
-      {
-	RFormInst rform(inst);
-	unsigned rd = rform.bits.rd, rs1 = rform.bits.rs1, rs2 = rform.bits.rs2;
-	unsigned f7 = rform.bits.funct7, f3 = rform.bits.funct3;
-	unsigned rs3 = f7 >> 2;
-	RoundingMode mode = RoundingMode(f3);
-	if ((f7 & 3) == 0)
-	  printFp32f(stream, "fnmadd_s", rd, rs1, rs2, rs3, mode);
-	else if ((f7 & 3) == 1)
-	  printFp32d(stream, "fnmadd_d", rd, rs1, rs2, rs3, mode);
-	else
-	  stream << "illegal";
-      }
-      break;
+    intRegs_.write(rd, high);
+  }
 
-    case 20:  // 10100   rform
-      disassembleFp(inst, stream);
-      break;
+}
 
-    case 24:  // 11000   B-form
-      {
-	BFormInst bform(inst);
-	unsigned rs1 = bform.bits.rs1, rs2 = bform.bits.rs2;
-	int32_t imm = bform.immed();
-	switch (bform.bits.funct3)
-	  {
-	  case 0:  printInstRegRegImm12(stream, "beq",  rs1, rs2, imm); break;
-	  case 1:  printInstRegRegImm12(stream, "bne",  rs1, rs2, imm); break;
-	  case 4:  printInstRegRegImm12(stream, "blt",  rs1, rs2, imm); break;
-	  case 5:  printInstRegRegImm12(stream, "bge",  rs1, rs2, imm); break;
-	  case 6:  printInstRegRegImm12(stream, "bltu", rs1, rs2, imm); break;
-	  case 7:  printInstRegRegImm12(stream, "bgeu", rs1, rs2, imm); break;
-	  default: stream << "illegal";                                 break;
-	  }
-      }
-      break;
 
-    case 25:  // 11001  I-form
-      {
-	IFormInst iform(inst);
-	unsigned rd = iform.fields.rd, rs1 = iform.fields.rs1;
-	if (iform.fields.funct3 == 0)
-	  printInstLdSt(stream, "jalr", rd, rs1, iform.immed());
-	else
-	  stream << "illegal";
-      }
-      break;
+template <typename URV>
+void
+Core<URV>::execDiv(uint32_t rd, uint32_t rs1, int32_t rs2)
+{
+  SRV a = intRegs_.read(rs1);
+  SRV b = intRegs_.read(rs2);
+  SRV c = -1;   // Divide by zero result
+  if (b != 0)
+    {
+      SRV minInt = SRV(1) << (intRegs_.regWidth() - 1);
+      if (a == minInt and b == -1)
+	c = a;
+      else
+	c = a / b;  // Per spec: User-Level ISA, Version 2.3, Section 6.2
+    }
+  intRegs_.write(rd, c);
+}
 
-    case 27:  // 11011  J-form
-      {
-	JFormInst jform(inst);
-	int32_t imm = jform.immed();
-	stream << "jal      " << intRegs_.regName(jform.bits.rd, abiNames_)
-	       << ", ";
-	if (imm < 0)
-	  {
-	    stream << "-";
-	    imm = -imm;
-	  }
-	stream << "0x" << std::hex << (imm & 0xfffff);
-      }
-      break;
 
-    case 28:  // 11100  I-form
-      {
-	IFormInst iform(inst);
-	unsigned rd = iform.fields.rd, rs1 = iform.fields.rs1;
-	unsigned csrNum = iform.uimmed();
-	std::string rdn = intRegs_.regName(rd, abiNames_);   // rd name
-	std::string rs1n = intRegs_.regName(rs1, abiNames_); // rs1 name
-	std::string csrn;  // csr name
-	auto csr = csRegs_.findCsr(CsrNumber(csrNum));
-	if (csr)
-	  csrn = csr->getName();
-	else
-	  csrn = "illegal";
-	switch (iform.fields.funct3)
-	  {
-	  case 0:
-	    {
-	      uint32_t func7 = iform.top7();
-	      if (func7 == 0)
-		{
-		  if (rs1 != 0 or rd != 0)  stream << "illegal";
-		  else if (csrNum == 0)     stream << "ecall";
-		  else if (csrNum == 1)     stream << "ebreak";
-		  else if (csrNum == 2)     stream << "uret";
-		  else                      stream << "illegal";
-		}
-	      else if (func7 == 9)
-		{
-		  uint32_t rs2 = iform.rs2();
-		  if (rd != 0) stream << "illegal";
-		  else         stream << "SFENCE.VMA " << rs1 << ", " << rs2;
-		}
-	      else if (csrNum == 0x102) stream << "sret";
-	      else if (csrNum == 0x302) stream << "mret";
-	      else if (csrNum == 0x105) stream << "wfi";
-	      else                      stream << "illegal";
-	    }
-	    break;
-	  case 1:
-	    stream << "csrrw    " << rdn << ", " << csrn << ", " << rs1n;
-	    break;
-	  case 2:
-	    stream << "csrrs    " << rdn << ", " << csrn << ", " << rs1n;
-	    break;
-	  case 3:
-	    stream << "csrrc    " << rdn << ", " << csrn << ", " << rs1n;
-	    break;
-	  case 5:
-	    stream << "csrrwi   " << rdn << ", " << csrn << ", " << rs1n;
-	    break;
-	  case 6:
-	    stream << "csrrsi   " << rdn << ", " << csrn << ", " << rs1n;
-	    break;
-	  case 7:
-	    stream << "csrrci   " << rdn << ", " << csrn << ", " << rs1n;
-	    break;
-	  default: 
-	    stream << "illegal";
-	    break;
-	  }
-      }
-      break;
+template <typename URV>
+void
+Core<URV>::execDivu(uint32_t rd, uint32_t rs1, int32_t rs2)
+{
+  URV a = intRegs_.read(rs1);
+  URV b = intRegs_.read(rs2);
+  URV c = ~ URV(0);  // Divide by zero result.
+  if (b != 0)
+    c = a / b;
+  intRegs_.write(rd, c);
+}
+
 
-    default:
-      stream << "illegal";
-      break;
+// Remainder instruction.
+template <typename URV>
+void
+Core<URV>::execRem(uint32_t rd, uint32_t rs1, int32_t rs2)
+{
+  SRV a = intRegs_.read(rs1);
+  SRV b = intRegs_.read(rs2);
+  SRV c = a;  // Divide by zero remainder.
+  if (b != 0)
+    {
+      SRV minInt = SRV(1) << (intRegs_.regWidth() - 1);
+      if (a == minInt and b == -1)
+	c = 0;   // Per spec: User-Level ISA, Version 2.3, Section 6.2
+      else
+	c = a % b;
     }
+  intRegs_.write(rd, c);
 }
 
 
+// Unsigned remainder instruction.
 template <typename URV>
 void
-Core<URV>::disassembleInst16(uint16_t inst, std::ostream& stream)
+Core<URV>::execRemu(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  if (not isRvc())
+  URV a = intRegs_.read(rs1);
+  URV b = intRegs_.read(rs2);
+  URV c = a;  // Divide by zero remainder.
+  if (b != 0)
+    c = a % b;
+  intRegs_.write(rd, c);
+}
+
+
+template <typename URV>
+void
+Core<URV>::execLwu(uint32_t rd, uint32_t rs1, int32_t imm)
+{
+  if (not isRv64())
     {
-      stream << "illegal";
+      illegalInst();
       return;
     }
+  load<uint32_t>(rd, rs1, imm);
+}
 
-  uint16_t quadrant = inst & 0x3;
-  uint16_t funct3 =  inst >> 13;    // Bits 15 14 and 13
 
-  switch (quadrant)
+template <typename URV>
+void
+Core<URV>::execLd(uint32_t rd, uint32_t rs1, int32_t imm)
+{
+  if (not isRv64())
     {
-    case 0:    // quadrant 0
-      switch (funct3) 
-	{
-	case 0:   // illegal, c.addi4spn
-	  {
-	    if (inst == 0)
-	      stream << "illegal";
-	    else
-	      {
-		CiwFormInst ciwf(inst);
-		unsigned immed = ciwf.immed();
-		if (immed == 0)
-		  stream << "illegal";
-		else
-		  printInstRegImm(stream, "c.addi4spn", 8+ciwf.bits.rdp,
-				  immed >> 2);
-	      }
-	  }
-	  break;
-	case 1: // c_fld, c_lq  
-	  stream << "illegal";
-	  break;
-	case 2: // c.lw
-	  {
-	    ClFormInst clf(inst);
-	    unsigned rd = 8+clf.bits.rdp, rs1 = (8+clf.bits.rs1p);
-	    printInstLdSt(stream, "c.lw", rd, rs1, clf.lwImmed());
-	  }
-	  break;
-	case 3:  // c.flw, c.ld
-	  {
-	    ClFormInst clf(inst);
-	    unsigned rd = 8+clf.bits.rdp, rs1 = (8+clf.bits.rs1p);
-	    if (isRv64())
-	      printInstLdSt(stream, "c.ld", rd, rs1, clf.ldImmed()); 
-	    else
-	      {
-		if (isRvf())
-		  printInstFpLdSt(stream, "c.flw", rd, rs1, clf.lwImmed());
-		else
-		  stream << "illegal";
-	      }
-	  }
-	  break;
-	case 4:  // reserved
-	  stream << "illegal";
-	  break;
-	case 5:  // c.fsd, c.sq
-	  if (isRvd())
-	    {
-	      ClFormInst clf(inst);
-	      unsigned rd = 8+clf.bits.rdp, rs1 = (8+clf.bits.rs1p);
-	      printInstFpLdSt(stream, "c.fsd", rd, rs1, clf.ldImmed());
-	    }
-	  else
-	    stream << "illegal";
-	  break;
-	case 6:  // c.sw
-	  {
-	    CsFormInst cs(inst);
-	    unsigned rd = (8+cs.bits.rs2p), rs1 = 8+cs.bits.rs1p;
-	    printInstLdSt(stream, "c.sw", rd, rs1, cs.swImmed());
-	  }
-	  break;
-	case 7:  // c.fsw, c.sd
-	  {
-	    CsFormInst cs(inst);
-	    unsigned rd = (8+cs.bits.rs2p), rs1 = (8+cs.bits.rs1p);
-	    if (isRv64())
-	      printInstLdSt(stream, "c.sd", rd, rs1, cs.sdImmed());
-	    else
-	      {
-		if (isRvf())
-		  printInstFpLdSt(stream, "c.fsw", rd, rs1, cs.swImmed());
-		else
-		  stream << "illegal"; // c.fsw
-	      }
-	  }
-	  break;
-	}
-      break;
-
-    case 1:    // quadrant 1
-      switch (funct3)
-	{
-	case 0:  // c.nop, c.addi
-	  {
-	    CiFormInst cif(inst);
-	    if (cif.bits.rd == 0)
-	      stream << "c.nop";
-	    else
-	      printInstRegImm(stream, "c.addi", cif.bits.rd, cif.addiImmed());
-	  }
-	  break;
-	  
-	case 1:  // c.jal, in rv64 and rv128 this is c.addiw
-	  if (isRv64())
-	    {
-	      CiFormInst cif(inst);
-	      if (cif.bits.rd == 0)
-		stream << "illegal";
-	      else
-		printInstRegImm(stream, "c.addiw", cif.bits.rd, cif.addiImmed());
-	    }
-	  else
-	    {
-	      CjFormInst cjf(inst);
-	      int32_t imm = cjf.immed();
-	      stream << "c.jal    ";
-	      if (imm < 0) { stream << "-"; imm = -imm; }
-	      stream << "0x" << std::hex << imm;
-	    }
-	  break;
-
-	case 2:  // c.li
-	  {
-	    CiFormInst cif(inst);
-	    printInstRegImm(stream, "c.li", cif.bits.rd, cif.addiImmed());
-	  }
-	  break;
+      illegalInst();
+      return;
+    }
+  load<uint64_t>(rd, rs1, imm);
+}
 
-	case 3:  // c.addi16sp, c.lui
-	  {
-	    CiFormInst cif(inst);
-	    int immed16 = cif.addi16spImmed();
-	    if (immed16 == 0)
-	      stream << "illegal";
-	    else if (cif.bits.rd == RegSp)
-	      {
-		stream << "c.addi16sp ";
-		if (immed16 < 0) { stream << "-"; immed16 = -immed16; }
-		stream << "0x" << std::hex << (immed16 >> 4);
-	      }
-	    else
-	      printInstRegImm(stream, "c.lui", cif.bits.rd, cif.luiImmed()>>12);
-	  }
-	  break;
 
-	// c.srli c.srli64 c.srai c.srai64 c.andi c.sub c.xor c.and
-	// c.subw c.addw
-	case 4:
-	  {
-	    CaiFormInst caf(inst);  // compressed and immediate form
-	    unsigned rd = 8 + caf.bits.rdp;
-	    std::string rdName = intRegs_.regName(rd, abiNames_);
-	    int immed = caf.andiImmed();
-	    switch (caf.bits.funct2)
-	      {
-	      case 0:
-		if (caf.bits.ic5 != 0 and not isRv64())
-		  stream << "illegal";
-		else
-		  printInstRegImm(stream, "c.srli", rd, caf.shiftImmed());
-		break;
-	      case 1:
-		if (caf.bits.ic5 != 0 and not isRv64())
-		  stream << "illegal";
-		else
-		  printInstRegImm(stream, "c.srai", rd, caf.shiftImmed());
-		break;
-	      case 2:
-		printInstRegImm(stream, "c.andi", rd, immed);
-		break;
-	      case 3:
-		{
-		  unsigned rs2 = 8+(immed & 0x7); // Lowest 3 bits of immed
-		  std::string rs2n = intRegs_.regName(rs2, abiNames_);
-		  if ((immed & 0x20) == 0)  // Bit 5 of immed
-		    {
-		      switch ((immed >> 3) & 3) // Bits 3 and 4 of immed
-			{
-			case 0:
-			  stream << "c.sub    " << rdName << ", " << rs2n; break;
-			case 1:
-			  stream << "c.xor    " << rdName << ", " << rs2n; break;
-			case 2:
-			  stream << "c.or     " << rdName << ", " << rs2n; break;
-			case 3:
-			  stream << "c.and    " << rdName << ", " << rs2n; break;
-			}
-		    }
-		  else
-		    {
-		      if (not isRv64())
-			stream << "illegal";
-		      else
-			switch ((immed >> 3) & 3)
-			  {
-			  case 0: stream << "c.subw " << rdName << ", " << rs2n;
-			    break;
-			  case 1: stream << "c.addw " << rdName << ", " << rs2n;
-			    break;
-			  case 3: stream << "illegal";
-			    break; // reserved
-			  case 4: stream << "illegal";
-			    break; // reserved
-			}
-		    }
-		}
-		break;
-	      }
-	  }
-	  break;
+template <typename URV>
+void
+Core<URV>::execSd(uint32_t rs1, uint32_t rs2, int32_t imm)
+{
+  if (not isRv64())
+    {
+      illegalInst();
+      return;
+    }
 
-	case 5:  // c.j
-	  {
-	    CjFormInst cjf(inst);
-	    int32_t imm = cjf.immed();
-	    stream << "c.j      ";
-	    if (imm < 0) { stream << "-"; imm = -imm; }
-	    stream << "0x" << std::hex << imm;
-	  }
-	  break;
-	  
-	case 6:  // c.beqz
-	  {
-	    CbFormInst cbf(inst);
-	    printInstRegImm(stream, "c.beqz", 8+cbf.bits.rs1p, cbf.immed());
-	  }
-	  break;
+  URV addr = intRegs_.read(rs1) + SRV(imm);
+  URV value = intRegs_.read(rs2);
 
-	case 7:  // c.bnez
-	  {
-	    CbFormInst cbf(inst);
-	    printInstRegImm(stream, "c.bnez", 8+cbf.bits.rs1p, cbf.immed());
-	  }
-	  break;
-	}
-      break;
+  store<uint64_t>(addr, value);
+}
 
-    case 2:    // quadrant 2
-      switch (funct3)
-	{
-	case 0:  // c.slli c.slli64
-	  {
-	    CiFormInst cif(inst);
-	    unsigned immed = unsigned(cif.slliImmed()), rd = cif.bits.rd;
-	    if (cif.bits.ic5 != 0 and not isRv64())
-	      stream << "illegal";
-	    else
-	      stream << "c.slli   " << intRegs_.regName(rd, abiNames_) << ", "
-		     << immed;
-	  }
-	  break;
 
-	case 1:   // c.fldsp, c.lqsp
-	  stream << "illegal";
-	  break;
+template <typename URV>
+void
+Core<URV>::execSlliw(uint32_t rd, uint32_t rs1, int32_t amount)
+{
+  if (not isRv64())
+    {
+      illegalInst();
+      return;
+    }
 
-	case 2:  // c.lwsp
-	  {
-	    CiFormInst cif(inst);
-	    unsigned rd = cif.bits.rd;
-	    // rd == 0 is legal per Andrew Watterman
-	    stream << "c.lwsp   " << intRegs_.regName(rd, abiNames_) << ", 0x"
-		   << std::hex << cif.lwspImmed();
-	  }
-	break;
+  if (amount > 0x1f)
+    {
+      illegalInst();   // Bit 5 is 1 or higher values.
+      return;
+    }
 
-	case 3:  // c.flwsp c.ldsp
-	  if (isRv64())
-	    {
-	      CiFormInst cif(inst);
-	      unsigned rd = cif.bits.rd;
-	      stream << "c.ldsp   " << intRegs_.regName(rd, abiNames_) << ", 0x"
-		     << std::hex << cif.ldspImmed();
-	    }
-	  else
-	    {
-	      stream << "illegal";  // c.flwsp
-	    }
-	  break;
+  int32_t word = intRegs_.read(rs1);
+  word <<= amount;
 
-	case 4:  // c.jr c.mv c.ebreak c.jalr c.add
-	  {
-	    CiFormInst cif(inst);
-	    unsigned immed = cif.addiImmed();
-	    unsigned rd = cif.bits.rd;
-	    unsigned rs2 = immed & 0x1f;
-	    std::string rdName = intRegs_.regName(rd, abiNames_);
-	    std::string rs2Name = intRegs_.regName(rs2, abiNames_);
-	    if ((immed & 0x20) == 0)
-	      {
-		if (rs2 == 0)
-		  {
-		    if (rd == 0)
-		      stream << "illegal";
-		    else
-		      stream << "c.jr     " << rdName;
-		  }
-		else
-		  {
-		    if (rd == 0)
-		      stream << "illegal";
-		    else
-		      stream << "c.mv     " << rdName << ", " << rs2Name;
-		  }
-	      }
-	    else
-	      {
-		if (rs2 == 0)
-		  {
-		    if (rd == 0)
-		      stream << "c.ebreak";
-		    else
-		      stream << "c.jalr   " << rdName;
-		  }
-		else
-		  {
-		    if (rd == 0)
-		      stream << "illegal";
-		    else
-		      stream << "c.add    " << rdName << ", " << rs2Name;
-		  }
-	      }
-	  }
-	  break;
+  SRV value = word; // Sign extend to 64-bit.
+  intRegs_.write(rd, value);
+}
 
-	case 5:  // c.fsdsp  c.sqsp
-	  stream << "illegal";
-	  break;
 
-	case 6:  // c.swsp
-	  {
-	    CswspFormInst csw(inst);
-	    stream << "c.swsp   " << intRegs_.regName(csw.bits.rs2, abiNames_)
-		   << ", 0x" << std::hex << csw.swImmed();
-	  }
-	  break;
+template <typename URV>
+void
+Core<URV>::execSrliw(uint32_t rd, uint32_t rs1, int32_t amount)
+{
+  if (not isRv64())
+    {
+      illegalInst();
+      return;
+    }
 
-	case 7:  // c.fswsp c.sdsp
-	  {
-	    if (isRv64())  // c.sdsp
-	      {
-		CswspFormInst csw(inst);
-		stream << "c.sdsp   " << intRegs_.regName(csw.bits.rs2, abiNames_)
-		       << ", 0x" << std::hex << csw.sdImmed();
-	      }
-	  else
-	    {
-	      stream << "illegal";    // c.fwsp
-	    }
-	  }
-	  break;
-	}
-      break;
+  if (amount > 0x1f)
+    {
+      illegalInst();   // Bit 5 is 1 or higher values.
+      return;
+    }
 
-    case 3:  // quadrant 3
-      stream << "illegal";
-      break;
+  uint32_t word = intRegs_.read(rs1);
+  word >>= amount;
 
-    default:
-      stream << "illegal";
-      break;
+  SRV value = int32_t(word); // Sign extend to 64-bit.
+  intRegs_.write(rd, value);
+}
+
+
+template <typename URV>
+void
+Core<URV>::execSraiw(uint32_t rd, uint32_t rs1, int32_t amount)
+{
+  if (not isRv64())
+    {
+      illegalInst();
+      return;
+    }
+
+  if (amount > 0x1f)
+    {
+      illegalInst();   // Bit 5 is 1 or higher values.
+      return;
+    }
+
+  int32_t word = intRegs_.read(rs1);
+  word >>= amount;
+
+  SRV value = word; // Sign extend to 64-bit.
+  intRegs_.write(rd, value);
+}
+
+
+template <typename URV>
+void
+Core<URV>::execAddiw(uint32_t rd, uint32_t rs1, int32_t imm)
+{
+  if (not isRv64())
+    {
+      illegalInst();
+      return;
+    }
+
+  int32_t word = intRegs_.read(rs1);
+  word += imm;
+  SRV value = word;  // sign extend to 64-bits
+  intRegs_.write(rd, value);
+}
+
+
+template <typename URV>
+void
+Core<URV>::execAddw(uint32_t rd, uint32_t rs1, int32_t rs2)
+{
+  if (not isRv64())
+    {
+      illegalInst();
+      return;
+    }
+
+  int32_t word = intRegs_.read(rs1) + intRegs_.read(rs2);
+  SRV value = word;  // sign extend to 64-bits
+  intRegs_.write(rd, value);
+}
+
+
+template <typename URV>
+void
+Core<URV>::execSubw(uint32_t rd, uint32_t rs1, int32_t rs2)
+{
+  if (not isRv64())
+    {
+      illegalInst();
+      return;
     }
+
+  int32_t word = intRegs_.read(rs1) - intRegs_.read(rs2);
+  SRV value = word;  // sign extend to 64-bits
+  intRegs_.write(rd, value);
 }
 
 
+
 template <typename URV>
 void
-Core<URV>::disassembleInst32(uint32_t inst, std::string& str)
+Core<URV>::execSllw(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  str.clear();
+  if (not isRv64())
+    {
+      illegalInst();
+      return;
+    }
 
-  std::ostringstream oss;
-  disassembleInst32(inst, oss);
-  str = oss.str();
+  uint32_t shift = intRegs_.read(rs2) & 0x1f;
+  int32_t word = intRegs_.read(rs1) << shift;
+  SRV value = word;  // sign extend to 64-bits
+  intRegs_.write(rd, value);
 }
 
 
 template <typename URV>
 void
-Core<URV>::disassembleInst16(uint16_t inst, std::string& str)
+Core<URV>::execSrlw(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  str.clear();
+  if (not isRv64())
+    {
+      illegalInst();
+      return;
+    }
 
-  std::ostringstream oss;
-  disassembleInst16(inst, oss);
-  str = oss.str();
+  uint32_t word = intRegs_.read(rs1);
+  uint32_t shift = intRegs_.read(rs2) & 0x1f;
+  word >>= shift;
+  SRV value = int32_t(word);  // sign extend to 64-bits
+  intRegs_.write(rd, value);
 }
 
-
 template <typename URV>
 void
-Core<URV>::enableInstructionFrequency(bool b)
+Core<URV>::execSraw(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  instFreq_ = b;
-  if (b)
+  if (not isRv64())
     {
-      instProfileVec_.resize(size_t(InstId::maxId) + 1);
-
-      unsigned regCount = intRegCount();
-      for (auto& inst : instProfileVec_)
-	{
-	  inst.rd_.resize(regCount);
-	  inst.rs1_.resize(regCount);
-	  inst.rs2_.resize(regCount);
-	  inst.rs1Histo_.resize(13);  // FIX: avoid magic 13
-	  inst.rs2Histo_.resize(13);  // FIX: avoid magic 13
-	  inst.immHisto_.resize(13);  // FIX: avoid magic 13
-	}
+      illegalInst();
+      return;
     }
+
+  int32_t word = intRegs_.read(rs1);
+  uint32_t shift = intRegs_.read(rs2) & 0x1f;
+  word >>= shift;
+  SRV value = word;  // sign extend to 64-bits
+  intRegs_.write(rd, value);
 }
 
 
 template <typename URV>
 void
-Core<URV>::enterDebugMode(DebugModeCause cause, URV pc)
+Core<URV>::execMulw(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  if (debugMode_)
-    {
-      if (debugStepMode_)
-	debugStepMode_ = false;
-      else
-	std::cerr << "Error: Entering debug-halt while in debug-halt\n";
-    }
-  else
+  if (not isRv64())
     {
-      debugMode_ = true;
-      if (debugStepMode_)
-	std::cerr << "Error: Entering debug-halt with debug-step true\n";
-      debugStepMode_ = false;
+      illegalInst();
+      return;
     }
 
-  URV value = 0;
-  if (csRegs_.read(CsrNumber::DCSR, PrivilegeMode::Machine, debugMode_, value))
-    {
-      value &= ~(URV(7) << 6);   // Clear cause field (starts at bit 6).
-      value |= URV(cause) << 6;  // Set cause field
-      if (nmiPending_)
-	value |= URV(1) << 3;    // Set nmip bit.
-      csRegs_.poke(CsrNumber::DCSR, value);
-
-      csRegs_.poke(CsrNumber::DPC, pc);
-    }
+  int32_t word1 = intRegs_.read(rs1);
+  int32_t word2 = intRegs_.read(rs2);
+  int32_t word = word1 * word2;
+  SRV value = word;  // sign extend to 64-bits
+  intRegs_.write(rd, value);
 }
 
 
 template <typename URV>
 void
-Core<URV>::enterDebugMode(URV pc)
+Core<URV>::execDivw(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  // This method is used by the test-bench to make the simulator
-  // follow it into debug-halt or debug-stop mode. Do nothing if the
-  // simulator got into debug mode on its own.
-  if (debugMode_)
-    return;   // Already in debug mode.
+  if (not isRv64())
+    {
+      illegalInst();
+      return;
+    }
 
-  if (debugStepMode_)
-    std::cerr << "Error: Enter-debug command finds core in debug-step mode.\n";
+  int32_t word1 = intRegs_.read(rs1);
+  int32_t word2 = intRegs_.read(rs2);
 
-  debugStepMode_ = false;
-  debugMode_ = false;
+  int32_t word = -1;  // Divide by zero result
+  if (word2 != 0)
+    word = word1 / word2;
 
-  enterDebugMode(DebugModeCause::DEBUGGER, pc);
+  SRV value = word;  // sign extend to 64-bits
+  intRegs_.write(rd, value);
 }
 
 
 template <typename URV>
 void
-Core<URV>::exitDebugMode()
+Core<URV>::execDivuw(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  if (not debugMode_)
+  if (not isRv64())
     {
-      std::cerr << "Error: Bench sent exit debug while not in debug mode.\n";
+      illegalInst();
       return;
     }
 
-  csRegs_.peek(CsrNumber::DPC, pc_);
-
-  // If in debug-step go to debug-halt. If in debug-halt go to normal
-  // or debug-step based on step-bit in DCSR.
-  if (debugStepMode_)
-    debugStepMode_ = false;
-  else
-    {
-      if (dcsrStep_)
-	debugStepMode_ = true;
-      else
-	debugMode_ = false;
-    }
+  uint32_t word1 = intRegs_.read(rs1);
+  uint32_t word2 = intRegs_.read(rs2);
 
-  // If pending nmi bit is set in dcsr, set pending nmi in core
-  URV dcsrVal = 0;
-  if (not peekCsr(CsrNumber::DCSR, dcsrVal))
-    std::cerr << "Error: Failed to read DCSR in exit debug.\n";
+  uint32_t word = ~uint32_t(0);  // Divide by zero result.
+  if (word2 != 0)
+    word = word1 / word2;
 
-  if ((dcsrVal >> 3) & 1)
-    setPendingNmi(nmiCause_);
+  URV value = word;  // zero extend to 64-bits
+  intRegs_.write(rd, value);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execBlt(uint32_t rs1, uint32_t rs2, int32_t offset)
+Core<URV>::execRemw(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  SRV v1 = intRegs_.read(rs1),  v2 = intRegs_.read(rs2);
-  if (v1 < v2)
+  if (not isRv64())
     {
-      pc_ = currPc_ + SRV(offset);
-      pc_ = (pc_ >> 1) << 1;  // Clear least sig bit.
-      lastBranchTaken_ = true;
+      illegalInst();
+      return;
     }
+
+  int32_t word1 = intRegs_.read(rs1);
+  int32_t word2 = intRegs_.read(rs2);
+
+  int32_t word = word1;  // Divide by zero remainder
+  if (word2 != 0)
+    word = word1 % word2;
+
+  SRV value = word;  // sign extend to 64-bits
+  intRegs_.write(rd, value);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execBltu(uint32_t rs1, uint32_t rs2, int32_t offset)
+Core<URV>::execRemuw(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  URV v1 = intRegs_.read(rs1),  v2 = intRegs_.read(rs2);
-  if (v1 < v2)
+  if (not isRv64())
     {
-      pc_ = currPc_ + SRV(offset);
-      pc_ = (pc_ >> 1) << 1;  // Clear least sig bit.
-      lastBranchTaken_ = true;
+      illegalInst();
+      return;
     }
+
+  uint32_t word1 = intRegs_.read(rs1);
+  uint32_t word2 = intRegs_.read(rs1);
+
+  uint32_t word = word1;  // Divide by zero remainder
+  if (word1 != 0)
+    word = word1 % word2;
+
+  URV value = word;  // zero extend to 64-bits
+  intRegs_.write(rd, value);
 }
 
 
 template <typename URV>
-void
-Core<URV>::execBge(uint32_t rs1, uint32_t rs2, int32_t offset)
+RoundingMode
+Core<URV>::effectiveRoundingMode()
 {
-  SRV v1 = intRegs_.read(rs1),  v2 = intRegs_.read(rs2);
-  if (v1 >= v2)
+  if (instRoundingMode_ != RoundingMode::Dynamic)
+    return instRoundingMode_;
+
+  const Csr<URV>* fcsr = csRegs_.getImplementedCsr(CsrNumber::FCSR);
+  if (fcsr)
     {
-      pc_ = currPc_ + SRV(offset);
-      pc_ = (pc_ >> 1) << 1;  // Clear least sig bit.
-      lastBranchTaken_ = true;
+      RoundingMode mode = RoundingMode((fcsr->read() >> 5) & 0x7);
+      return mode;
     }
+
+  return instRoundingMode_;
 }
 
 
 template <typename URV>
 void
-Core<URV>::execBgeu(uint32_t rs1, uint32_t rs2, int32_t offset)
+Core<URV>::accrueHostFpFlags()
 {
-  URV v1 = intRegs_.read(rs1),  v2 = intRegs_.read(rs2);
-  if (v1 >= v2)
-    {
-      pc_ = currPc_ + SRV(offset);
-      pc_ = (pc_ >> 1) << 1;  // Clear least sig bit.
-      lastBranchTaken_ = true;
-    }
+  orFcsrFlags(hostFpFlags());
 }
 
 
 template <typename URV>
-void
-Core<URV>::execJalr(uint32_t rd, uint32_t rs1, int32_t offset)
+unsigned
+Core<URV>::hostFpFlags() const
 {
-  URV temp = pc_;  // pc has the address of the instruction after jalr
-  pc_ = (intRegs_.read(rs1) + SRV(offset));
-  pc_ = (pc_ >> 1) << 1;  // Clear least sig bit.
-  intRegs_.write(rd, temp);
-  lastBranchTaken_ = true;
+  int flags = fetestexcept(FE_ALL_EXCEPT);
+  unsigned val = 0;
+
+  if (flags & FE_INEXACT)
+    val |= unsigned(FpFlags::Inexact);
+
+  if (flags & FE_UNDERFLOW)
+    val |= unsigned(FpFlags::Underflow);
+
+  if (flags & FE_OVERFLOW)
+    val |= unsigned(FpFlags::Overflow);
+
+  if (flags & FE_DIVBYZERO)
+    val |= unsigned(FpFlags::DivByZero);
+
+  if (flags & FE_INVALID)
+    val |= unsigned(FpFlags::Invalid);
+
+  return val;
 }
 
 
 template <typename URV>
 void
-Core<URV>::execJal(uint32_t rd, uint32_t offset, int32_t)
+Core<URV>::orFcsrFlags(unsigned flags)
 {
-  intRegs_.write(rd, pc_);
-  pc_ = currPc_ + SRV(int32_t(offset));
-  pc_ = (pc_ >> 1) << 1;  // Clear least sig bit.
-  lastBranchTaken_ = true;
+  URV val = 0;
+  if (csRegs_.read(CsrNumber::FCSR, PrivilegeMode::Machine, debugMode_, val))
+    {
+      URV prev = val;
+      val |= flags;
+      if (val != prev)
+	csRegs_.write(CsrNumber::FCSR, PrivilegeMode::Machine, debugMode_, val);
+    }
+}
+
+
+int
+setSimulatorRoundingMode(RoundingMode mode)
+{
+  int previous = std::fegetround();
+  switch(mode)
+    {
+    case RoundingMode::NearestEven: std::fesetround(FE_TONEAREST);  break;
+    case RoundingMode::Zero:        std::fesetround(FE_TOWARDZERO); break;
+    case RoundingMode::Down:        std::fesetround(FE_DOWNWARD);   break;
+    case RoundingMode::Up:          std::fesetround(FE_UPWARD);     break;
+    case RoundingMode::NearestMax:  std::fesetround(FE_TONEAREST);  break; //FIX
+    default: break;
+    }
+  return previous;
 }
 
 
 template <typename URV>
-void
-Core<URV>::execLui(uint32_t rd, uint32_t imm, int32_t)
+int
+Core<URV>::setFpRoundingMode(RoundingMode mode)
 {
-  intRegs_.write(rd, SRV(int32_t(imm)));
+  if (not lazyFpEnv_)
+    return setSimulatorRoundingMode(mode);
+
+  if (mode != hostRoundingMode_)
+    {
+      setSimulatorRoundingMode(mode);
+      hostRoundingMode_ = mode;
+    }
+  return prevHostRoundingMode_;
 }
 
 
 template <typename URV>
 void
-Core<URV>::execAuipc(uint32_t rd, uint32_t imm, int32_t)
+Core<URV>::enableLazyFpEnv(bool flag)
 {
-  intRegs_.write(rd, currPc_ + SRV(int32_t(imm)));
+  if (flag == lazyFpEnv_)
+    return;
+
+  if (flag)
+    {
+      // Start with clean flags. Host rounding mode is unknown until
+      // first floating point instruction.
+      prevHostRoundingMode_ = std::fegetround();
+      hostRoundingMode_ = RoundingMode::Invalid1;
+      std::feclearexcept(FE_ALL_EXCEPT);
+      lazyFpEnv_ = true;
+    }
+  else
+    {
+      syncFpFlags();
+      std::fesetround(prevHostRoundingMode_);
+      lazyFpEnv_ = false;
+    }
 }
 
 
 template <typename URV>
 void
-Core<URV>::execSlli(uint32_t rd, uint32_t rs1, int32_t amount)
+Core<URV>::execFlw(uint32_t rd, uint32_t rs1, int32_t imm)
 {
-  if ((amount & 0x20) and not rv64_)
+  if (not isRvf())
     {
-      illegalInst();  // Bit 5 of shift amount cannot be zero in 32-bit.
+      illegalInst();
       return;
     }
 
-  URV v = intRegs_.read(rs1) << amount;
-  intRegs_.write(rd, v);
-}
+  URV addr = intRegs_.read(rs1) + SRV(imm);
 
+  loadAddr_ = addr;    // For reporting load addr in trace-mode.
+  loadAddrValid_ = true;  // For reporting load addr in trace-mode.
 
-template <typename URV>
-void
-Core<URV>::execSlti(uint32_t rd, uint32_t rs1, int32_t imm)
-{
-  URV v = SRV(intRegs_.read(rs1)) < imm ? 1 : 0;
-  intRegs_.write(rd, v);
-}
+  if (hasActiveTrigger())
+    {
+      typedef TriggerTiming Timing;
 
+      bool isLoad = true;
+      if (ldStAddrTriggerHit(addr, Timing::Before, isLoad, isInterruptEnabled()))
+	triggerTripped_ = true;
+      if (triggerTripped_)
+	return;
+    }
 
-template <typename URV>
-void
-Core<URV>::execSltiu(uint32_t rd, uint32_t rs1, int32_t imm)
-{
-  URV v = intRegs_.read(rs1) < URV(SRV(imm)) ? 1 : 0;
-  intRegs_.write(rd, v);
-}
+  // Misaligned load from io section triggers an exception. Crossing
+  // dccm to non-dccm causes an exception.
+  bool misaligned = addr & 0x3;
+  misalignedLdSt_ = misaligned;
+  if (misaligned and misalignedAccessCausesException(addr, 4))
+    {
+      forceAccessFail_ = false;
+      ldStException_ = true;
+      initiateException(ExceptionCause::LOAD_ADDR_MISAL, currPc_, addr);
+      return;
+    }
+
+  union UFU  // Unsigned float union: reinterpret bits as unsigned or float
+  {
+    uint32_t u;
+    float f;
+  };
 
+  uint32_t word = 0;
+  if (not forceAccessFail_ and memory_.read(addr, word))
+    {
+      UFU ufu;
+      ufu.u = word;
+      fpRegs_.writeSingle(rd, ufu.f);
+      if (dcache_.enabled())
+	accessDataCache(addr, sizeof(word), false);
+      if (memTrace_.enabled())
+	traceDataAccess(addr, sizeof(word), false);
+      if (pageProfile_.enabled())
+	pageProfile_.access(PageProfile::Access::Read, addr, retiredInsts_);
 
-template <typename URV>
-void
-Core<URV>::execXori(uint32_t rd, uint32_t rs1, int32_t imm)
-{
-  URV v = intRegs_.read(rs1) ^ SRV(imm);
-  intRegs_.write(rd, v);
+      if (watchCheck_)
+	checkWatchpoint(addr, sizeof(word), true);
+    }
+  else
+    {
+      forceAccessFail_ = false;
+      initiateException(ExceptionCause::LOAD_ACC_FAULT, currPc_, addr);
+      ldStException_ = true;
+    }
 }
 
 
 template <typename URV>
 void
-Core<URV>::execSrli(uint32_t rd, uint32_t rs1, int32_t amount)
+Core<URV>::execFsw(uint32_t rs1, uint32_t rs2, int32_t imm)
 {
-  uint32_t uamount(amount);
-
-  if ((uamount > 31) and not isRv64())
+  if (not isRvf())
     {
       illegalInst();
       return;
     }
 
-  URV v = intRegs_.read(rs1) >> uamount;
-  intRegs_.write(rd, v);
+  URV addr = intRegs_.read(rs1) + SRV(imm);
+  float val = fpRegs_.readSingle(rs2);
+
+  union UFU  // Unsigned float union: reinterpret bits as unsigned or float
+  {
+    uint32_t u;
+    float f;
+  };
+
+  UFU ufu;
+  ufu.f = val;
+
+  store<uint32_t>(addr, ufu.u);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execSrai(uint32_t rd, uint32_t rs1, int32_t amount)
+Core<URV>::execFmadd_s(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  uint32_t uamount(amount);
+  if (not isRvf())
+    {
+      illegalInst();
+      return;
+    }
 
-  if ((uamount > 31) and not isRv64())
+  RoundingMode riscvMode = effectiveRoundingMode();
+  if (riscvMode >= RoundingMode::Invalid1)
     {
       illegalInst();
       return;
     }
 
-  URV v = SRV(intRegs_.read(rs1)) >> uamount;
-  intRegs_.write(rd, v);
-}
+  if (softFloat_)
+    {
+      unsigned flags = 0;
+      uint32_t res = SoftFloat::fma(fpRegs_.readSingleBits(rs1),
+				    fpRegs_.readSingleBits(rs2),
+				    fpRegs_.readSingleBits(instRs3_),
+				    riscvMode, flags);
+      fpRegs_.writeSingleBits(rd, res);
+      orFcsrFlags(flags);
+      return;
+    }
 
+  clearFpFlags();
+  int prevMode = setFpRoundingMode(riscvMode);
 
-template <typename URV>
-void
-Core<URV>::execOri(uint32_t rd, uint32_t rs1, int32_t imm)
-{
-  URV v = intRegs_.read(rs1) | SRV(imm);
-  intRegs_.write(rd, v);
+  float f1 = fpRegs_.readSingle(rs1);
+  float f2 = fpRegs_.readSingle(rs2);
+  float f3 = fpRegs_.readSingle(instRs3_);
+  float res = std::fma(f1, f2, f3);
+  fpRegs_.writeSingle(rd, res);
+
+  updateAccruedFpBits();
+  restoreFpRoundingMode(prevMode);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execSub(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execFmsub_s(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  URV v = intRegs_.read(rs1) - intRegs_.read(rs2);
-  intRegs_.write(rd, v);
-}
+  if (not isRvf())
+    {
+      illegalInst();
+      return;
+    }
 
+  RoundingMode riscvMode = effectiveRoundingMode();
+  if (riscvMode >= RoundingMode::Invalid1)
+    {
+      illegalInst();
+      return;
+    }
 
-template <typename URV>
-void
-Core<URV>::execSll(uint32_t rd, uint32_t rs1, int32_t rs2)
-{
-  URV mask = intRegs_.shiftMask();
-  URV v = intRegs_.read(rs1) << (intRegs_.read(rs2) & mask);
-  intRegs_.write(rd, v);
-}
+  if (softFloat_)
+    {
+      const uint32_t signBit = uint32_t(1) << 31;
+      unsigned flags = 0;
+      uint32_t res = SoftFloat::fma(fpRegs_.readSingleBits(rs1),
+				    fpRegs_.readSingleBits(rs2),
+				    fpRegs_.readSingleBits(instRs3_) ^ signBit,
+				    riscvMode, flags);
+      fpRegs_.writeSingleBits(rd, res);
+      orFcsrFlags(flags);
+      return;
+    }
 
+  clearFpFlags();
+  int prevMode = setFpRoundingMode(riscvMode);
 
-template <typename URV>
-void
-Core<URV>::execSlt(uint32_t rd, uint32_t rs1, int32_t rs2)
-{
-  SRV v1 = intRegs_.read(rs1);
-  SRV v2 = intRegs_.read(rs2);
-  URV v = v1 < v2 ? 1 : 0;
-  intRegs_.write(rd, v);
+  float f1 = fpRegs_.readSingle(rs1);
+  float f2 = fpRegs_.readSingle(rs2);
+  float f3 = fpRegs_.readSingle(instRs3_);
+  float res = std::fma(f1, f2, -f3);
+  fpRegs_.writeSingle(rd, res);
+
+  updateAccruedFpBits();
+  restoreFpRoundingMode(prevMode);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execSltu(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execFnmsub_s(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  URV v1 = intRegs_.read(rs1);
-  URV v2 = intRegs_.read(rs2);
-  URV v = v1 < v2 ? 1 : 0;
-  intRegs_.write(rd, v);
-}
+  if (not isRvf())
+    {
+      illegalInst();
+      return;
+    }
 
+  RoundingMode riscvMode = effectiveRoundingMode();
+  if (riscvMode >= RoundingMode::Invalid1)
+    {
+      illegalInst();
+      return;
+    }
 
-template <typename URV>
-void
-Core<URV>::execXor(uint32_t rd, uint32_t rs1, int32_t rs2)
-{
-  URV v = intRegs_.read(rs1) ^ intRegs_.read(rs2);
-  intRegs_.write(rd, v);
-}
+  if (softFloat_)
+    {
+      const uint32_t signBit = uint32_t(1) << 31;
+      unsigned flags = 0;
+      uint32_t res = SoftFloat::fma(fpRegs_.readSingleBits(rs1) ^ signBit,
+				    fpRegs_.readSingleBits(rs2),
+				    fpRegs_.readSingleBits(instRs3_),
+				    riscvMode, flags);
+      fpRegs_.writeSingleBits(rd, res);
+      orFcsrFlags(flags);
+      return;
+    }
 
+  clearFpFlags();
+  int prevMode = setFpRoundingMode(riscvMode);
 
-template <typename URV>
-void
-Core<URV>::execSrl(uint32_t rd, uint32_t rs1, int32_t rs2)
-{
-  URV mask = intRegs_.shiftMask();
-  URV v = intRegs_.read(rs1) >> (intRegs_.read(rs2) & mask);
-  intRegs_.write(rd, v);
+  float f1 = fpRegs_.readSingle(rs1);
+  float f2 = fpRegs_.readSingle(rs2);
+  float f3 = fpRegs_.readSingle(instRs3_);
+  float res = std::fma(f1, f2, -f3);
+  fpRegs_.writeSingle(rd, -res);
+
+  updateAccruedFpBits();
+  restoreFpRoundingMode(prevMode);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execSra(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execFnmadd_s(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  URV mask = intRegs_.shiftMask();
-  URV v = SRV(intRegs_.read(rs1)) >> (intRegs_.read(rs2) & mask);
-  intRegs_.write(rd, v);
-}
+  if (not isRvf())
+    {
+      illegalInst();
+      return;
+    }
 
+  RoundingMode riscvMode = effectiveRoundingMode();
+  if (riscvMode >= RoundingMode::Invalid1)
+    {
+      illegalInst();
+      return;
+    }
 
-template <typename URV>
-void
-Core<URV>::execOr(uint32_t rd, uint32_t rs1, int32_t rs2)
-{
-  URV v = intRegs_.read(rs1) | intRegs_.read(rs2);
-  intRegs_.write(rd, v);
+  if (softFloat_)
+    {
+      const uint32_t signBit = uint32_t(1) << 31;
+      unsigned flags = 0;
+      uint32_t res = SoftFloat::fma(fpRegs_.readSingleBits(rs1) ^ signBit,
+				    fpRegs_.readSingleBits(rs2),
+				    fpRegs_.readSingleBits(instRs3_) ^ signBit,
+				    riscvMode, flags);
+      fpRegs_.writeSingleBits(rd, res);
+      orFcsrFlags(flags);
+      return;
+    }
+
+  clearFpFlags();
+  int prevMode = setFpRoundingMode(riscvMode);
+
+  float f1 = fpRegs_.readSingle(rs1);
+  float f2 = fpRegs_.readSingle(rs2);
+  float f3 = fpRegs_.readSingle(instRs3_);
+  float res = std::fma(f1, f2, f3);
+  fpRegs_.writeSingle(rd, -res);
+
+  updateAccruedFpBits();
+  restoreFpRoundingMode(prevMode);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execAnd(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execFadd_s(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  URV v = intRegs_.read(rs1) & intRegs_.read(rs2);
-  intRegs_.write(rd, v);
-}
+  if (not isRvf())
+    {
+      illegalInst();
+      return;
+    }
+
+  RoundingMode riscvMode = effectiveRoundingMode();
+  if (riscvMode >= RoundingMode::Invalid1)
+    {
+      illegalInst();
+      return;
+    }
 
+  if (softFloat_)
+    {
+      unsigned flags = 0;
+      uint32_t res = SoftFloat::add(fpRegs_.readSingleBits(rs1),
+				    fpRegs_.readSingleBits(rs2),
+				    riscvMode, flags);
+      fpRegs_.writeSingleBits(rd, res);
+      orFcsrFlags(flags);
+      return;
+    }
 
-template <typename URV>
-void
-Core<URV>::execFence(uint32_t pred, uint32_t succ, int32_t)
-{
-  storeQueue_.clear();
-  loadQueue_.clear();
+  clearFpFlags();
+  int prevMode = setFpRoundingMode(riscvMode);
+
+  float f1 = fpRegs_.readSingle(rs1);
+  float f2 = fpRegs_.readSingle(rs2);
+  float res = f1 + f2;
+  fpRegs_.writeSingle(rd, res);
+
+  updateAccruedFpBits();
+  restoreFpRoundingMode(prevMode);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execFencei(uint32_t, uint32_t, int32_t)
+Core<URV>::execFsub_s(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  return;  // Currently a no-op.
+  if (not isRvf())
+    {
+      illegalInst();
+      return;
+    }
+
+  RoundingMode riscvMode = effectiveRoundingMode();
+  if (riscvMode >= RoundingMode::Invalid1)
+    {
+      illegalInst();
+      return;
+    }
+
+  if (softFloat_)
+    {
+      unsigned flags = 0;
+      uint32_t res = SoftFloat::sub(fpRegs_.readSingleBits(rs1),
+				    fpRegs_.readSingleBits(rs2),
+				    riscvMode, flags);
+      fpRegs_.writeSingleBits(rd, res);
+      orFcsrFlags(flags);
+      return;
+    }
+
+  clearFpFlags();
+  int prevMode = setFpRoundingMode(riscvMode);
+
+  float f1 = fpRegs_.readSingle(rs1);
+  float f2 = fpRegs_.readSingle(rs2);
+  float res = f1 - f2;
+  fpRegs_.writeSingle(rd, res);
+
+  updateAccruedFpBits();
+  restoreFpRoundingMode(prevMode);
 }
 
 
 template <typename URV>
-URV
-Core<URV>::emulateNewlib()
+void
+Core<URV>::execFmul_s(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  // Preliminary. Need to avoid using syscall numbers.
-
-  URV a0 = intRegs_.read(RegA0);
-  URV a1 = intRegs_.read(RegA1);
-  URV a2 = intRegs_.read(RegA2);
-  URV a3 = intRegs_.read(RegA2);
-  URV num = intRegs_.read(RegA7);
+  if (not isRvf())
+    {
+      illegalInst();
+      return;
+    }
 
-  switch (num)
+  RoundingMode riscvMode = effectiveRoundingMode();
+  if (riscvMode >= RoundingMode::Invalid1)
     {
-    case 56:       // openat
-      {
-	int dirfd = a0;
+      illegalInst();
+      return;
+    }
 
-	size_t pathAddr = 0;
-	if (not memory_.getSimMemAddr(a1, pathAddr))
-	  return SRV(-1);
-	const char* path = (const char*) pathAddr;
+  if (softFloat_)
+    {
+      unsigned flags = 0;
+      uint32_t res = SoftFloat::mul(fpRegs_.readSingleBits(rs1),
+				    fpRegs_.readSingleBits(rs2),
+				    riscvMode, flags);
+      fpRegs_.writeSingleBits(rd, res);
+      orFcsrFlags(flags);
+      return;
+    }
 
-	int flags = a2;
-	int x86Flags = 0;
-	if (flags & 1) x86Flags |= O_WRONLY;
-	if (flags & 0x200) x86Flags |= O_CREAT;
+  clearFpFlags();
+  int prevMode = setFpRoundingMode(riscvMode);
 
-	mode_t mode = a3;
-	int rc = openat(dirfd, path, x86Flags, mode);
-	return SRV(rc);
-      }
+  float f1 = fpRegs_.readSingle(rs1);
+  float f2 = fpRegs_.readSingle(rs2);
+  float res = f1 * f2;
+  fpRegs_.writeSingle(rd, res);
 
-    case 66:       // writev
-      {
-	int fd = a0;
+  updateAccruedFpBits();
+  restoreFpRoundingMode(prevMode);
+}
 
-	size_t iovAddr = 0;
-	if (not memory_.getSimMemAddr(a1, iovAddr))
-	  return SRV(-1);
 
-	int count = a2;
+template <typename URV>
+void
+Core<URV>::execFdiv_s(uint32_t rd, uint32_t rs1, int32_t rs2)
+{
+  if (not isRvf())
+    {
+      illegalInst();
+      return;
+    }
 
-	unsigned errors = 0;
-	struct iovec* iov = new struct iovec [count];
-	for (int i = 0; i < count; ++i)
-	  {
-	    URV* vec = (URV*) iovAddr;
-	    URV base = vec[i*2];
-	    URV len = vec[i*2+1];
-	    size_t addr = 0;
-	    if (not memory_.getSimMemAddr(base, addr))
-	      {
-		errors++;
-		break;
-	      }
-	    iov[i].iov_base = (void*) addr;
-	    iov[i].iov_len = len;
-	  }
-	int rc = -1;
-	if (not errors)
-	  rc = writev(fd, iov, count);
-	delete [] iov;
-	return SRV(rc);
-      }
+  RoundingMode riscvMode = effectiveRoundingMode();
+  if (riscvMode >= RoundingMode::Invalid1)
+    {
+      illegalInst();
+      return;
+    }
 
-    case 78:       // readlinat
-      {
-	int dirfd = a0;
-	URV path = a1;
-	URV buf = a2;
-	URV bufSize = a3;
-
-	size_t pathAddr = 0;
-	if (not memory_.getSimMemAddr(path, pathAddr))
-	  return SRV(-1);
-
-	size_t bufAddr = 0;
-	if (not memory_.getSimMemAddr(buf, bufAddr))
-	  return SRV(-1);
-	int rc = readlinkat(dirfd, (const char*) pathAddr,
-			    (char*) bufAddr, bufSize);
-	return SRV(rc);
-      }
+  if (softFloat_)
+    {
+      unsigned flags = 0;
+      uint32_t res = SoftFloat::div(fpRegs_.readSingleBits(rs1),
+				    fpRegs_.readSingleBits(rs2),
+				    riscvMode, flags);
+      fpRegs_.writeSingleBits(rd, res);
+      orFcsrFlags(flags);
+      return;
+    }
 
-    case 80:       // fstat
-      {
-	int fd = a0;
-	size_t rvBuff = 0;
-	if (not memory_.getSimMemAddr(a1, rvBuff))
-	  return SRV(-1);
-	struct stat buff;
-	SRV rv = fstat(fd, &buff);
-	if (rv < 0)
-	  return rv;
-	if (sizeof(URV) == 4)
-	  {
-	    // Copy x86 stat buffer to riscv stat buffer.
-	    char* ptr = (char*) rvBuff;
-	    *((uint16_t*) ptr) = buff.st_dev;             ptr += 2;
-	    *((uint16_t*) ptr) = buff.st_ino;             ptr += 2;
-	    *((uint32_t*) ptr) = buff.st_mode;            ptr += 4;
-	    *((uint16_t*) ptr) = buff.st_nlink;           ptr += 2;
-	    *((uint16_t*) ptr) = buff.st_uid;             ptr += 2;
-	    *((uint16_t*) ptr) = buff.st_gid;             ptr += 2;
-	    *((uint16_t*) ptr) = buff.st_rdev;            ptr += 2;
-	    *((uint32_t*) ptr) = buff.st_size;            ptr += 4;
-	    /* st_spare1 */                               ptr += 4;
-	    *((uint32_t*) ptr) = buff.st_mtim.tv_sec;     ptr += 4;
-	    /* st_spare2 */                               ptr += 4;
-	    *((uint32_t*) ptr) = buff.st_ctim.tv_sec;     ptr += 4;
-	    /* st_spare3 */                               ptr += 4;
-	    *((uint32_t*) ptr) = buff.st_blksize;         ptr += 4;
-	    /* st_spare4 */                               ptr += 8;
-	    return rv;
-	  }
+  clearFpFlags();
+  int prevMode = setFpRoundingMode(riscvMode);
 
-	// Copy x86 stat buffer to riscv stat buffer.
-	*((struct stat*) rvBuff) = buff;
-	return rv;
-      }
+  float f1 = fpRegs_.readSingle(rs1);
+  float f2 = fpRegs_.readSingle(rs2);
+  float res = f1 / f2;
+  fpRegs_.writeSingle(rd, res);
 
-    case 214: // brk
-      {
-	if (a0 < progBreak_)
-	  return progBreak_;
-	progBreak_ = a0;
-	return a0;
-      }
+  updateAccruedFpBits();
+  restoreFpRoundingMode(prevMode);
+}
 
-    case 57: // close
-      {
-	int fd = a0;
-	SRV rv = 0;
-	if (fd > 2)
-	  rv = close(fd);
-	return rv;
-      }
 
-    case 63: // read
-      {
-	int fd = a0;
-	size_t buffAddr = 0;
-	if (not memory_.getSimMemAddr(a1, buffAddr))
-	  return SRV(-1);
-	size_t count = a2;
-	SRV rv = read(fd, (void*) buffAddr, count);
-	return rv;
-      }
+template <typename URV>
+void
+Core<URV>::execFsqrt_s(uint32_t rd, uint32_t rs1, int32_t rs2)
+{
+  if (not isRvf())
+    {
+      illegalInst();
+      return;
+    }
 
-    case 64: // write
-      {
-	int fd = a0;
-	size_t buffAddr = 0;
-	if (not memory_.getSimMemAddr(a1, buffAddr))
-	  return SRV(-1);
-	size_t count = a2;
-	SRV rv = write(fd, (void*) buffAddr, count);
-	return rv;
-      }
+  RoundingMode riscvMode = effectiveRoundingMode();
+  if (riscvMode >= RoundingMode::Invalid1)
+    {
+      illegalInst();
+      return;
+    }
 
-    case 93:  // exit
-      {
-	throw CoreException(CoreException::Exit, "", 0, a0);
-	return 0;
-      }
+  if (softFloat_)
+    {
+      unsigned flags = 0;
+      uint32_t res = SoftFloat::sqrt(fpRegs_.readSingleBits(rs1), riscvMode, flags);
+      fpRegs_.writeSingleBits(rd, res);
+      orFcsrFlags(flags);
+      return;
+    }
 
-    case 94:  // exit_group
-      {
-	throw CoreException(CoreException::Exit, "", 0, a0);
-	return 0;
-      }
+  clearFpFlags();
+  int prevMode = setFpRoundingMode(riscvMode);
 
-    case 160: // uname
-      {
-	// Assumes that x86 and rv Linux have same layout for struct utsname.
-	size_t buffAddr = 0;
-	if (not memory_.getSimMemAddr(a0, buffAddr))
-	  return SRV(-1);
-	struct utsname* uts = (struct utsname*) buffAddr;
-	int rc = uname(uts);
-	strcpy(uts->release, "4.14.0");
-	return SRV(rc);
-      }
+  float f1 = fpRegs_.readSingle(rs1);
+  float res = std::sqrt(f1);
+  fpRegs_.writeSingle(rd, res);
 
-    case 174: // getuid
-      {
-	SRV rv = getuid();
-	return rv;
-      }
+  updateAccruedFpBits();
+  restoreFpRoundingMode(prevMode);
+}
 
-    case 175: // geteuid
-      {
-	SRV rv = geteuid();
-	return rv;
-      }
 
-    case 176: // getgid
-      {
-	SRV rv = getgid();
-	return rv;
-      }
+template <typename URV>
+void
+Core<URV>::execFsgnj_s(uint32_t rd, uint32_t rs1, int32_t rs2)
+{
+  if (not isRvf())
+    {
+      illegalInst();
+      return;
+    }
 
-    case 177: // getegid
-      {
-	SRV rv = getegid();
-	return rv;
-      }
+  float f1 = fpRegs_.readSingle(rs1);
+  float f2 = fpRegs_.readSingle(rs2);
+  float res = copysign(f1, f2);  // Magnitude of rs1 and sign of rs2
+  fpRegs_.writeSingle(rd, res);
+}
 
-    case 1024: // open
-      {
-	size_t pathAddr = 0;
-	if (not memory_.getSimMemAddr(a0, pathAddr))
-	  return SRV(-1);
-	int flags = a1;
-	int x86Flags = 0;
-	if (flags & 1) x86Flags |= O_WRONLY;
-	if (flags & 0x200) x86Flags |= O_CREAT;
-	int mode = a2;
-	SRV fd = open((const char*) pathAddr, x86Flags, mode);
-	return fd;
-      }
 
-    default:
-      break;
+template <typename URV>
+void
+Core<URV>::execFsgnjn_s(uint32_t rd, uint32_t rs1, int32_t rs2)
+{
+  if (not isRvf())   {
+      illegalInst();
+      return;
     }
 
-  std::cerr << "Unimplemented syscall number " << num << "\n";
-  return -1;
+  float f1 = fpRegs_.readSingle(rs1);
+  float f2 = fpRegs_.readSingle(rs2);
+  float res = copysign(f1, f2);  // Magnitude of rs1 and sign of rs2
+  res = -res;  // Magnitude of rs1 and negative the sign of rs2
+  fpRegs_.writeSingle(rd, res);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execEcall(uint32_t, uint32_t, int32_t)
+Core<URV>::execFsgnjx_s(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  if (triggerTripped_)
-    return;
-
-  if (newlib_)
+  if (not isRvf())
     {
-      URV a0 = emulateNewlib();
-      intRegs_.write(RegA0, a0);
+      illegalInst();
       return;
     }
 
-  if (privMode_ == PrivilegeMode::Machine)
-    initiateException(ExceptionCause::M_ENV_CALL, currPc_, 0);
-  else if (privMode_ == PrivilegeMode::Supervisor)
-    initiateException(ExceptionCause::S_ENV_CALL, currPc_, 0);
-  else if (privMode_ == PrivilegeMode::User)
-    initiateException(ExceptionCause::U_ENV_CALL, currPc_, 0);
-  else
-    assert(0 and "Invalid privilege mode in execEcall");
+  float f1 = fpRegs_.readSingle(rs1);
+  float f2 = fpRegs_.readSingle(rs2);
+
+  int sign1 = (std::signbit(f1) == 0) ? 0 : 1;
+  int sign2 = (std::signbit(f2) == 0) ? 0 : 1;
+  int sign = sign1 ^ sign2;
+
+  float x = sign? -1 : 1;
+
+  float res = copysign(f1, x);  // Magnitude of rs1 and sign of x
+  fpRegs_.writeSingle(rd, res);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execEbreak(uint32_t, uint32_t, int32_t)
+Core<URV>::execFmin_s(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  if (triggerTripped_)
-    return;
-
-  // If in machine mode and DCSR bit ebreakm is set, then enter debug mode.
-  if (privMode_ == PrivilegeMode::Machine)
+  if (not isRvf())
     {
-      URV dcsrVal = 0;
-      if (peekCsr(CsrNumber::DCSR, dcsrVal))
-	{
-	  if (dcsrVal & (URV(1) << 15))   // Bit ebreakm is on?
-	    {
-	      // The documentation (RISCV external debug support) does
-	      // not say whether or not we set EPC and MTVAL.
-	      enterDebugMode(DebugModeCause::EBREAK, currPc_);
-	      ebreakInst_ = true;
-	      recordCsrWrite(CsrNumber::DCSR);
-	      return;
-	    }
-	}
+      illegalInst();
+      return;
     }
 
-  URV savedPc = currPc_;  // Goes into MEPC.
-  URV trapInfo = currPc_;  // Goes into MTVAL.
+  float in1 = fpRegs_.readSingle(rs1);
+  float in2 = fpRegs_.readSingle(rs2);
+  float res = fmin(in1, in2);
+  fpRegs_.writeSingle(rd, res);
+}
 
-  initiateException(ExceptionCause::BREAKP, savedPc, trapInfo);
 
-  if (enableGdb_)
+template <typename URV>
+void
+Core<URV>::execFmax_s(uint32_t rd, uint32_t rs1, int32_t rs2)
+{
+  if (not isRvf())
     {
-      pc_ = currPc_;
-      handleExceptionForGdb(*this);
+      illegalInst();
       return;
     }
+
+  float in1 = fpRegs_.readSingle(rs1);
+  float in2 = fpRegs_.readSingle(rs2);
+  float res = fmax(in1, in2);
+  fpRegs_.writeSingle(rd, res);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execMret(uint32_t, uint32_t, int32_t)
+Core<URV>::execFcvt_w_s(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  if (privMode_ < PrivilegeMode::Machine)
+  if (not isRvf())
     {
       illegalInst();
       return;
     }
 
-  if (triggerTripped_)
-    return;
-
-  // Restore privilege mode and interrupt enable by getting
-  // current value of MSTATUS, ...
-  URV value = 0;
-  if (not csRegs_.read(CsrNumber::MSTATUS, privMode_, debugMode_, value))
+  RoundingMode riscvMode = effectiveRoundingMode();
+  if (riscvMode >= RoundingMode::Invalid1)
     {
       illegalInst();
       return;
     }
 
-  // ... updating/unpacking its fields,
-  MstatusFields<URV> fields(value);
-  PrivilegeMode savedMode = PrivilegeMode(fields.bits_.MPP);
-  fields.bits_.MIE = fields.bits_.MPIE;
-  fields.bits_.MPP = 0;
-  fields.bits_.MPIE = 1;
-
-  // ... and putting it back
-  if (not csRegs_.write(CsrNumber::MSTATUS, privMode_, debugMode_,
-			fields.value_))
-    assert(0 and "Failed to write MSTATUS register\n");
+  clearFpFlags();
+  int prevMode = setFpRoundingMode(riscvMode);
 
-  // TBD: Handle MPV.
+  float f1 = fpRegs_.readSingle(rs1);
+  SRV result = int32_t(f1);
+  intRegs_.write(rd, result);
 
-  // Restore program counter from MEPC.
-  URV epc;
-  if (not csRegs_.read(CsrNumber::MEPC, privMode_, debugMode_, epc))
-    illegalInst();
-  pc_ = (epc >> 1) << 1;  // Restore pc clearing least sig bit.
-      
-  // Update privilege mode.
-  privMode_ = savedMode;
+  updateAccruedFpBits();
+  restoreFpRoundingMode(prevMode);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execSret(uint32_t, uint32_t, int32_t)
+Core<URV>::execFcvt_wu_s(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  if (not isRvs())
+  if (not isRvf())
     {
       illegalInst();
       return;
     }
 
-  if (privMode_ < PrivilegeMode::Supervisor)
+  RoundingMode riscvMode = effectiveRoundingMode();
+  if (riscvMode >= RoundingMode::Invalid1)
     {
       illegalInst();
       return;
     }
 
-  if (triggerTripped_)
-    return;
+  clearFpFlags();
+  int prevMode = setFpRoundingMode(riscvMode);
 
-  // Restore privilege mode and interrupt enable by getting
-  // current value of MSTATUS, ...
-  URV value = 0;
-  if (not csRegs_.read(CsrNumber::SSTATUS, privMode_, debugMode_, value))
-    {
-      illegalInst();
-      return;
-    }
+  float f1 = fpRegs_.readSingle(rs1);
+  URV result = uint32_t(f1);
+  intRegs_.write(rd, result);
 
-  // ... updating/unpacking its fields,
-  MstatusFields<URV> fields(value);
-  
-  PrivilegeMode savedMode = fields.bits_.SPP? PrivilegeMode::Supervisor :
-    PrivilegeMode::User;
-  fields.bits_.SIE = fields.bits_.SPIE;
-  fields.bits_.SPP = 0;
-  fields.bits_.SPIE = 1;
+  updateAccruedFpBits();
+  restoreFpRoundingMode(prevMode);
+}
 
-  // ... and putting it back
-  if (not csRegs_.write(CsrNumber::SSTATUS, privMode_, debugMode_,
-			fields.value_))
-    {
-      illegalInst();
-      return;
-    }
 
-  // Restore program counter from UEPC.
-  URV epc;
-  if (not csRegs_.read(CsrNumber::SEPC, privMode_, debugMode_, epc))
+template <typename URV>
+void
+Core<URV>::execFmv_x_w(uint32_t rd, uint32_t rs1, int32_t rs2)
+{
+  if (not isRvf())
     {
       illegalInst();
       return;
     }
-  pc_ = (epc >> 1) << 1;  // Restore pc clearing least sig bit.
 
-  // Update privilege mode.
-  privMode_ = savedMode;
-}
+  float f1 = fpRegs_.readSingle(rs1);
+
+  union IFU  // Int float union: reinterpret bits as int or float
+  {
+    int32_t i;
+    float f;
+  };
+
+  IFU ifu;
+  ifu.f = f1;
+
+  SRV value = SRV(ifu.i); // Sign extend.
 
+  intRegs_.write(rd, value);
+}
 
+ 
 template <typename URV>
 void
-Core<URV>::execUret(uint32_t, uint32_t, int32_t)
+Core<URV>::execFeq_s(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  if (not isRvu())
+  if (not isRvf())
     {
       illegalInst();
       return;
     }
 
-  if (privMode_ != PrivilegeMode::User)
-    {
-      illegalInst();
-      return;
-    }
+  clearFpFlags();
 
-  if (triggerTripped_)
-    return;
+  float f1 = fpRegs_.readSingle(rs1);
+  float f2 = fpRegs_.readSingle(rs2);
 
-  // Restore privilege mode and interrupt enable by getting
-  // current value of MSTATUS, ...
-  URV value = 0;
-  if (not csRegs_.read(CsrNumber::USTATUS, privMode_, debugMode_, value))
-    {
-      illegalInst();
-      return;
-    }
+  URV res = (f1 == f2)? 1 : 0;
+  intRegs_.write(rd, res);
 
-  // ... updating/unpacking its fields,
-  MstatusFields<URV> fields(value);
-  fields.bits_.UIE = fields.bits_.UPIE;
-  fields.bits_.UPIE = 1;
+  updateAccruedFpBits();
+}
 
-  // ... and putting it back
-  if (not csRegs_.write(CsrNumber::USTATUS, privMode_, debugMode_,
-			fields.value_))
-    {
-      illegalInst();
-      return;
-    }
 
-  // Restore program counter from UEPC.
-  URV epc;
-  if (not csRegs_.read(CsrNumber::UEPC, privMode_, debugMode_, epc))
+template <typename URV>
+void
+Core<URV>::execFlt_s(uint32_t rd, uint32_t rs1, int32_t rs2)
+{
+  if (not isRvf())
     {
       illegalInst();
       return;
     }
-  pc_ = (epc >> 1) << 1;  // Restore pc clearing least sig bit.
-}
 
+  clearFpFlags();
 
-template <typename URV>
-void
-Core<URV>::execWfi(uint32_t, uint32_t, int32_t)
-{
-  return;   // Currently implemented as a no-op.
+  float f1 = fpRegs_.readSingle(rs1);
+  float f2 = fpRegs_.readSingle(rs2);
+
+  URV res = (f1 < f2)? 1 : 0;
+  intRegs_.write(rd, res);
+
+  updateAccruedFpBits();
 }
 
 
 template <typename URV>
 void
-Core<URV>::commitCsrWrite(CsrNumber csr, URV csrVal, unsigned intReg,
-			  URV intRegVal)
+Core<URV>::execFle_s(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  // Make auto-increment happen before write for minstret and cycle.
-  if (csr == CsrNumber::MINSTRET or csr == CsrNumber::MINSTRETH)
-    retiredInsts_++;
-  if (csr == CsrNumber::MCYCLE or csr == CsrNumber::MCYCLEH)
-    cycleCount_++;
-
-  // Update CSR and integer register.
-  csRegs_.write(csr, privMode_, debugMode_, csrVal);
-  intRegs_.write(intReg, intRegVal);
-
-  if (csr == CsrNumber::DCSR)
-    {
-      dcsrStep_ = (csrVal >> 2) & 1;
-      dcsrStepIe_ = (csrVal >> 11) & 1;
-    }
-  else if (csr == CsrNumber::MGPMC)
+  if (not isRvf())
     {
-      prevCountersCsrOn_ = countersCsrOn_;
-      countersCsrOn_ = (csrVal & 1) == 1;
+      illegalInst();
+      return;
     }
 
-  // Csr was written. If it was minstret, compensate for
-  // auto-increment that will be done by run, runUntilAddress or
-  // singleStep method.
-  if (csr == CsrNumber::MINSTRET or csr == CsrNumber::MINSTRETH)
-    retiredInsts_--;
+  clearFpFlags();
 
-  // Same for mcycle.
-  if (csr == CsrNumber::MCYCLE or csr == CsrNumber::MCYCLEH)
-    cycleCount_--;
+  float f1 = fpRegs_.readSingle(rs1);
+  float f2 = fpRegs_.readSingle(rs2);
+
+  URV res = (f1 <= f2)? 1 : 0;
+  intRegs_.write(rd, res);
+
+  updateAccruedFpBits();
 }
 
 
-// Set control and status register csr to value of register rs1 and
-// save its original value in register rd.
-template <typename URV>
-void
-Core<URV>::execCsrrw(uint32_t rd, uint32_t rs1, int32_t c)
+bool
+mostSignificantFractionBit(float x)
 {
-  if (triggerTripped_)
-    return;
+  union UFU
+  {
+    uint32_t u;
+    float f;
+  };
 
-  CsrNumber csr = CsrNumber(c);
+  UFU ufu;
+  ufu.f = x;
 
-  URV prev = 0;
-  if (not csRegs_.read(csr, privMode_, debugMode_, prev))
-    {
-      illegalInst();
-      csrException_ = true;
-      return;
-    }
+  return (ufu.u >> 22) & 1;
+}
 
-  URV next = intRegs_.read(rs1);
 
-  if (not csRegs_.isWriteable(csr, privMode_, debugMode_))
-    {
-      illegalInst();
-      csrException_ = true;
-      return;
-    }
+bool
+mostSignificantFractionBit(double x)
+{
+  union UDU
+  {
+    uint64_t u;
+    double d;
+  };
 
-  commitCsrWrite(csr, next, rd, prev);
+  UDU udu;
+  udu.d = x;
+
+  return (udu.u >> 51) & 1;
 }
 
 
+
 template <typename URV>
 void
-Core<URV>::execCsrrs(uint32_t rd, uint32_t rs1, int32_t c)
+Core<URV>::execFclass_s(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  if (triggerTripped_)
-    return;
-
-  CsrNumber csr = CsrNumber(c);
-
-  URV prev = 0;
-  if (not csRegs_.read(csr, privMode_, debugMode_, prev))
+  if (not isRvf())
     {
       illegalInst();
-      csrException_ = true;
       return;
     }
 
-  URV next = prev | intRegs_.read(rs1);
-  if (rs1 == 0)
+  float f1 = fpRegs_.readSingle(rs1);
+  URV result = 0;
+
+  bool pos = not std::signbit(f1);
+  int type = std::fpclassify(f1);
+
+  if (type == FP_INFINITE)
     {
-      intRegs_.write(rd, prev);
-      return;
+      if (pos)
+	result |= URV(FpClassifyMasks::PosInfinity);
+      else
+	result |= URV(FpClassifyMasks::NegInfinity);
     }
-
-  if (not csRegs_.isWriteable(csr, privMode_, debugMode_))
+  else if (type == FP_NORMAL)
     {
-      illegalInst();
-      csrException_ = true;
-      return;
+      if (pos)
+	result |= URV(FpClassifyMasks::PosNormal);
+      else
+	result |= URV(FpClassifyMasks::NegNormal);
+    }
+  else if (type == FP_SUBNORMAL)
+    {
+      if (pos)
+	result |= URV(FpClassifyMasks::PosSubnormal);
+      else
+	result |= URV(FpClassifyMasks::NegSubnormal);
+    }
+  else if (type == FP_ZERO)
+    {
+      if (pos)
+	result |= URV(FpClassifyMasks::PosZero);
+      else
+	result |= URV(FpClassifyMasks::NegZero);
+    }
+  else if(type == FP_NAN)
+    {
+      bool quiet = mostSignificantFractionBit(f1);
+      if (quiet)
+	result |= URV(FpClassifyMasks::QuietNan);
+      else
+	result |= URV(FpClassifyMasks::SignalingNan);
     }
 
-  commitCsrWrite(csr, next, rd, prev);
+  intRegs_.write(rd, result);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execCsrrc(uint32_t rd, uint32_t rs1, int32_t c)
+Core<URV>::execFcvt_s_w(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  if (triggerTripped_)
-    return;
-
-  CsrNumber csr = CsrNumber(c);
-
-  URV prev = 0;
-  if (not csRegs_.read(csr, privMode_, debugMode_, prev))
+  if (not isRvf())
     {
       illegalInst();
-      csrException_ = true;
-      return;
-    }
-
-  URV next = prev & (~ intRegs_.read(rs1));
-  if (rs1 == 0)
-    {
-      intRegs_.write(rd, prev);
       return;
     }
 
-  if (not csRegs_.isWriteable(csr, privMode_, debugMode_))
+  RoundingMode riscvMode = effectiveRoundingMode();
+  if (riscvMode >= RoundingMode::Invalid1)
     {
       illegalInst();
-      csrException_ = true;
       return;
     }
 
-  commitCsrWrite(csr, next, rd, prev);
+  clearFpFlags();
+  int prevMode = setFpRoundingMode(riscvMode);
+
+  int32_t i1 = intRegs_.read(rs1);
+  float result = i1;
+  fpRegs_.writeSingle(rd, result);
+
+  updateAccruedFpBits();
+  restoreFpRoundingMode(prevMode);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execCsrrwi(uint32_t rd, uint32_t imm, int32_t c)
+Core<URV>::execFcvt_s_wu(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  if (triggerTripped_)
-    return;
-
-  CsrNumber csr = CsrNumber(c);
-
-  URV prev = 0;
-  if (rd != 0 and not csRegs_.read(csr, privMode_, debugMode_, prev))
+  if (not isRvf())
     {
       illegalInst();
-      csrException_ = true;
       return;
     }
 
-  if (not csRegs_.isWriteable(csr, privMode_, debugMode_))
+  RoundingMode riscvMode = effectiveRoundingMode();
+  if (riscvMode >= RoundingMode::Invalid1)
     {
       illegalInst();
-      csrException_ = true;
       return;
     }
 
-  commitCsrWrite(csr, imm, rd, prev);
+  clearFpFlags();
+  int prevMode = setFpRoundingMode(riscvMode);
+
+  uint32_t u1 = intRegs_.read(rs1);
+  float result = u1;
+  fpRegs_.writeSingle(rd, result);
+
+  updateAccruedFpBits();
+  restoreFpRoundingMode(prevMode);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execCsrrsi(uint32_t rd, uint32_t imm, int32_t c)
+Core<URV>::execFmv_w_x(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  if (triggerTripped_)
-    return;
-
-  CsrNumber csr = CsrNumber(c);
-
-  URV prev = 0;
-  if (not csRegs_.read(csr, privMode_, debugMode_, prev))
+  if (not isRvf())
     {
       illegalInst();
-      csrException_ = true;
       return;
     }
 
-  URV next = prev | imm;
-  if (imm == 0)
-    {
-      intRegs_.write(rd, prev);
-      return;
-    }
+  uint32_t u1 = intRegs_.read(rs1);
 
-  if (not csRegs_.isWriteable(csr, privMode_, debugMode_))
-    {
-      illegalInst();
-      csrException_ = true;
-      return;
-    }
+  union UFU  // Unsigned float union: reinterpret bits as unsigned or float
+  {
+    uint32_t u;
+    float f;
+  };
 
-  commitCsrWrite(csr, next, rd, prev);
+  UFU ufu;
+  ufu.u = u1;
+
+  fpRegs_.writeSingle(rd, ufu.f);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execCsrrci(uint32_t rd, uint32_t imm, int32_t c)
+Core<URV>::execFcvt_l_s(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  if (triggerTripped_)
-    return;
-
-  CsrNumber csr = CsrNumber(c);
-
-  URV prev = 0;
-  if (not csRegs_.read(csr, privMode_, debugMode_, prev))
+  if (not isRv64() or not isRvf())
     {
       illegalInst();
-      csrException_ = true;
-      return;
-    }
-
-  URV next = prev & (~ imm);
-  if (imm == 0)
-    {
-      intRegs_.write(rd, prev);
       return;
     }
 
-  if (not csRegs_.isWriteable(csr, privMode_, debugMode_))
+  RoundingMode riscvMode = effectiveRoundingMode();
+  if (riscvMode >= RoundingMode::Invalid1)
     {
       illegalInst();
-      csrException_ = true;
       return;
     }
 
-  commitCsrWrite(csr, next, rd, prev);
-}
-
-
-template <typename URV>
-void
-Core<URV>::execLb(uint32_t rd, uint32_t rs1, int32_t imm)
-{
-  load<int8_t>(rd, rs1, imm);
-}
-
-
-template <typename URV>
-void
-Core<URV>::execLbu(uint32_t rd, uint32_t rs1, int32_t imm)
-{
-  load<uint8_t>(rd, rs1, imm);
-}
+  clearFpFlags();
+  int prevMode = setFpRoundingMode(riscvMode);
 
+  float f1 = fpRegs_.readSingle(rs1);
+  SRV result = int64_t(f1);
+  intRegs_.write(rd, result);
 
-template <typename URV>
-void
-Core<URV>::execLhu(uint32_t rd, uint32_t rs1, int32_t imm)
-{
-  load<uint16_t>(rd, rs1, imm);
+  updateAccruedFpBits();
+  restoreFpRoundingMode(prevMode);
 }
 
 
 template <typename URV>
-template <typename STORE_TYPE>
 void
-Core<URV>::store(URV addr, STORE_TYPE storeVal)
+Core<URV>::execFcvt_lu_s(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  // ld/st-address or instruction-address triggers have priority over
-  // ld/st access or misaligned exceptions.
-  bool hasTrig = hasActiveTrigger();
-  TriggerTiming timing = TriggerTiming::Before;
-  bool isLoad = false;
-  if (hasTrig)
-    if (ldStAddrTriggerHit(addr, timing, isLoad, isInterruptEnabled()))
-      triggerTripped_ = true;
-
-  // Misaligned store to io section causes an exception. Crossing dccm
-  // to non-dccm causes an exception.
-  constexpr unsigned alignMask = sizeof(STORE_TYPE) - 1;
-  bool misaligned = addr & alignMask;
-  misalignedLdSt_ = misaligned;
-  if (misaligned and misalignedAccessCausesException(addr, sizeof(STORE_TYPE)))
+  if (not isRv64() or not isRvf())
     {
-      if (triggerTripped_)
-	return;  // No exception if earlier trig. Suppress store data trig.
-      forceAccessFail_ = false;
-      ldStException_ = true;
-      initiateException(ExceptionCause::STORE_ADDR_MISAL, currPc_, addr);
+      illegalInst();
       return;
     }
 
-  STORE_TYPE maskedVal = storeVal;
-  if (hasTrig and not forceAccessFail_ and memory_.checkWrite(addr, maskedVal))
-    {
-      // No exception: consider store-data  trigger
-      if (ldStDataTriggerHit(maskedVal, timing, isLoad, isInterruptEnabled()))
-	triggerTripped_ = true;
-    }
-  if (triggerTripped_)
-    return;
-
-  if (not forceAccessFail_ and memory_.write(addr, storeVal))
-    {
-      if (hasLr_ and lrAddr_ == addr)
-	hasLr_ = false;
-
-      // If we write to special location, end the simulation.
-      if (toHostValid_ and addr == toHost_ and storeVal != 0)
-	{
-	  throw CoreException(CoreException::Stop, "write to to-host",
-			      toHost_, storeVal);
-	}
-
-      // If addr is special location, then write to console.
-      if constexpr (sizeof(STORE_TYPE) == 1)
-        {
-	  if (conIoValid_ and addr == conIo_)
-	    {
-	      if (consoleOut_)
-		fputc(storeVal, consoleOut_);
-	      return;
-	    }
-	}
-      if (maxStoreQueueSize_)
-	{
-	  uint64_t prevVal = 0;
-	  memory_.getLastWriteOldValue(prevVal);
-	  putInStoreQueue(sizeof(STORE_TYPE), addr, storeVal, prevVal);
-	}
-    }
-  else
+  RoundingMode riscvMode = effectiveRoundingMode();
+  if (riscvMode >= RoundingMode::Invalid1)
     {
-      forceAccessFail_ = false;
-      ldStException_ = true;
-      initiateException(ExceptionCause::STORE_ACC_FAULT, currPc_, addr);
+      illegalInst();
+      return;
     }
+
+  clearFpFlags();
+  int prevMode = setFpRoundingMode(riscvMode);
+
+  float f1 = fpRegs_.readSingle(rs1);
+  URV result = uint64_t(f1);
+  intRegs_.write(rd, result);
+
+  updateAccruedFpBits();
+  restoreFpRoundingMode(prevMode);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execSb(uint32_t rs1, uint32_t rs2, int32_t imm)
+Core<URV>::execFcvt_s_l(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  URV addr = intRegs_.read(rs1) + SRV(imm);
-  URV value = intRegs_.read(rs2);
+  if (not isRv64() or not isRvf())
+    {
+      illegalInst();
+      return;
+    }
 
-  store<uint8_t>(addr, value);
+  RoundingMode riscvMode = effectiveRoundingMode();
+  if (riscvMode >= RoundingMode::Invalid1)
+    {
+      illegalInst();
+      return;
+    }
+
+  clearFpFlags();
+  int prevMode = setFpRoundingMode(riscvMode);
+
+  int64_t i1 = intRegs_.read(rs1);
+  float result = i1;
+  fpRegs_.writeSingle(rd, result);
+
+  updateAccruedFpBits();
+  restoreFpRoundingMode(prevMode);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execSh(uint32_t rs1, uint32_t rs2, int32_t imm)
+Core<URV>::execFcvt_s_lu(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  URV addr = intRegs_.read(rs1) + SRV(imm);
-  URV value = intRegs_.read(rs2);
-
-  store<uint16_t>(addr, value);
-}
+  if (not isRv64() or not isRvf())
+    {
+      illegalInst();
+      return;
+    }
 
+  RoundingMode riscvMode = effectiveRoundingMode();
+  if (riscvMode >= RoundingMode::Invalid1)
+    {
+      illegalInst();
+      return;
+    }
 
-namespace WdRiscv
-{
+  clearFpFlags();
+  int prevMode = setFpRoundingMode(riscvMode);
 
-  template<>
-  void
-  Core<uint32_t>::execMul(uint32_t rd, uint32_t rs1, int32_t rs2)
-  {
-    int32_t a = intRegs_.read(rs1);
-    int32_t b = intRegs_.read(rs2);
+  uint64_t i1 = intRegs_.read(rs1);
+  float result = i1;
+  fpRegs_.writeSingle(rd, result);
 
-    int32_t c = a * b;
-    intRegs_.write(rd, c);
-  }
+  updateAccruedFpBits();
+  restoreFpRoundingMode(prevMode);
+}
 
 
-  template<>
-  void
-  Core<uint32_t>::execMulh(uint32_t rd, uint32_t rs1, int32_t rs2)
-  {
-    int64_t a = int32_t(intRegs_.read(rs1));  // sign extend.
-    int64_t b = int32_t(intRegs_.read(rs2));
-    int64_t c = a * b;
-    int32_t high = c >> 32;
+template <typename URV>
+void
+Core<URV>::execFld(uint32_t rd, uint32_t rs1, int32_t imm)
+{
+  if (not isRvd())
+    {
+      illegalInst();
+      return;
+    }
 
-    intRegs_.write(rd, high);
-  }
+  URV addr = intRegs_.read(rs1) + SRV(imm);
 
+  loadAddr_ = addr;    // For reporting load addr in trace-mode.
+  loadAddrValid_ = true;  // For reporting load addr in trace-mode.
 
-  template <>
-  void
-  Core<uint32_t>::execMulhsu(uint32_t rd, uint32_t rs1, int32_t rs2)
-  {
-    int64_t a = int32_t(intRegs_.read(rs1));
-    uint64_t b = intRegs_.read(rs2);
-    int64_t c = a * b;
-    int32_t high = c >> 32;
+  if (hasActiveTrigger())
+    {
+      typedef TriggerTiming Timing;
 
-    intRegs_.write(rd, high);
-  }
+      bool isLoad = true;
+      if (ldStAddrTriggerHit(addr, Timing::Before, isLoad, isInterruptEnabled()))
+	triggerTripped_ = true;
+      if (triggerTripped_)
+	return;
+    }
 
+  // Misaligned load from io section triggers an exception. Crossing
+  // dccm to non-dccm causes an exception.
+  bool misaligned = addr & 0xf;
+  misalignedLdSt_ = misaligned;
+  if (misaligned and misalignedAccessCausesException(addr, 8))
+    {
+      forceAccessFail_ = false;
+      ldStException_ = true;
+      initiateException(ExceptionCause::LOAD_ADDR_MISAL, currPc_, addr);
+      return;
+    }
 
-  template <>
-  void
-  Core<uint32_t>::execMulhu(uint32_t rd, uint32_t rs1, int32_t rs2)
+  union UDU  // Unsigned double union: reinterpret bits as unsigned or double
   {
-    uint64_t a = intRegs_.read(rs1);
-    uint64_t b = intRegs_.read(rs2);
-    uint64_t c = a * b;
-    uint32_t high = c >> 32;
+    uint64_t u;
+    double d;
+  };
 
-    intRegs_.write(rd, high);
-  }
+  uint64_t val64 = 0;
+  if (not forceAccessFail_ and memory_.read(addr, val64))
+    {
+      UDU udu;
+      udu.u = val64;
+      fpRegs_.write(rd, udu.d);
+      if (dcache_.enabled())
+	accessDataCache(addr, sizeof(val64), false);
+      if (memTrace_.enabled())
+	traceDataAccess(addr, sizeof(val64), false);
+      if (pageProfile_.enabled())
+	pageProfile_.access(PageProfile::Access::Read, addr, retiredInsts_);
 
+      if (watchCheck_)
+	checkWatchpoint(addr, sizeof(val64), true);
+    }
+  else
+    {
+      forceAccessFail_ = false;
+      initiateException(ExceptionCause::LOAD_ACC_FAULT, currPc_, addr);
+      ldStException_ = true;
+    }
+}
 
-  template<>
-  void
-  Core<uint64_t>::execMul(uint32_t rd, uint32_t rs1, int32_t rs2)
-  {
-    __int128_t a = int64_t(intRegs_.read(rs1));  // sign extend to 64-bit
-    __int128_t b = int64_t(intRegs_.read(rs2));
 
-    int64_t c = a * b;
-    intRegs_.write(rd, c);
-  }
+template <typename URV>
+void
+Core<URV>::execFsd(uint32_t rs1, uint32_t rs2, int32_t imm)
+{
+  if (not isRvd())
+    {
+      illegalInst();
+      return;
+    }
 
+  URV addr = intRegs_.read(rs1) + SRV(imm);
+  double val = fpRegs_.read(rs2);
 
-  template<>
-  void
-  Core<uint64_t>::execMulh(uint32_t rd, uint32_t rs1, int32_t rs2)
+  union UDU  // Unsigned double union: reinterpret bits as unsigned or double
   {
-    __int128_t a = int64_t(intRegs_.read(rs1));  // sign extend.
-    __int128_t b = int64_t(intRegs_.read(rs2));
-    __int128_t c = a * b;
-    int64_t high = c >> 64;
+    uint64_t u;
+    double d;
+  };
 
-    intRegs_.write(rd, high);
-  }
+  UDU udu;
+  udu.d = val;
 
+  store<uint64_t>(addr, udu.u);
+}
 
-  template <>
-  void
-  Core<uint64_t>::execMulhsu(uint32_t rd, uint32_t rs1, int32_t rs2)
-  {
-    __int128_t a = int64_t(intRegs_.read(rs1));
-    __uint128_t b = intRegs_.read(rs2);
-    __int128_t c = a * b;
-    int64_t high = c >> 64;
 
-    intRegs_.write(rd, high);
-  }
+template <typename URV>
+void
+Core<URV>::execFmadd_d(uint32_t rd, uint32_t rs1, int32_t rs2)
+{
+  if (not isRvd())
+    {
+      illegalInst();
+      return;
+    }
+
+  RoundingMode riscvMode = effectiveRoundingMode();
+  if (riscvMode >= RoundingMode::Invalid1)
+    {
+      illegalInst();
+      return;
+    }
 
+  if (softFloat_)
+    {
+      unsigned flags = 0;
+      uint64_t res = SoftFloat::fma(fpRegs_.readDoubleBits(rs1),
+				    fpRegs_.readDoubleBits(rs2),
+				    fpRegs_.readDoubleBits(instRs3_),
+				    riscvMode, flags);
+      fpRegs_.writeDoubleBits(rd, res);
+      orFcsrFlags(flags);
+      return;
+    }
 
-  template <>
-  void
-  Core<uint64_t>::execMulhu(uint32_t rd, uint32_t rs1, int32_t rs2)
-  {
-    __uint128_t a = intRegs_.read(rs1);
-    __uint128_t b = intRegs_.read(rs2);
-    __uint128_t c = a * b;
-    uint64_t high = c >> 64;
+  clearFpFlags();
+  int prevMode = setFpRoundingMode(riscvMode);
 
-    intRegs_.write(rd, high);
-  }
+  double f1 = fpRegs_.read(rs1);
+  double f2 = fpRegs_.read(rs2);
+  double f3 = fpRegs_.read(instRs3_);
+  double res = std::fma(f1, f2, f3);
+  fpRegs_.write(rd, res);
 
+  updateAccruedFpBits();
+  restoreFpRoundingMode(prevMode);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execDiv(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execFmsub_d(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  SRV a = intRegs_.read(rs1);
-  SRV b = intRegs_.read(rs2);
-  SRV c = -1;   // Divide by zero result
-  if (b != 0)
+  if (not isRvd())
     {
-      SRV minInt = SRV(1) << (intRegs_.regWidth() - 1);
-      if (a == minInt and b == -1)
-	c = a;
-      else
-	c = a / b;  // Per spec: User-Level ISA, Version 2.3, Section 6.2
+      illegalInst();
+      return;
+    }
+
+  RoundingMode riscvMode = effectiveRoundingMode();
+  if (riscvMode >= RoundingMode::Invalid1)
+    {
+      illegalInst();
+      return;
+    }
+
+  if (softFloat_)
+    {
+      const uint64_t signBit = uint64_t(1) << 63;
+      unsigned flags = 0;
+      uint64_t res = SoftFloat::fma(fpRegs_.readDoubleBits(rs1),
+				    fpRegs_.readDoubleBits(rs2),
+				    fpRegs_.readDoubleBits(instRs3_) ^ signBit,
+				    riscvMode, flags);
+      fpRegs_.writeDoubleBits(rd, res);
+      orFcsrFlags(flags);
+      return;
     }
-  intRegs_.write(rd, c);
-}
 
+  clearFpFlags();
+  int prevMode = setFpRoundingMode(riscvMode);
 
-template <typename URV>
-void
-Core<URV>::execDivu(uint32_t rd, uint32_t rs1, int32_t rs2)
-{
-  URV a = intRegs_.read(rs1);
-  URV b = intRegs_.read(rs2);
-  URV c = ~ URV(0);  // Divide by zero result.
-  if (b != 0)
-    c = a / b;
-  intRegs_.write(rd, c);
+  double f1 = fpRegs_.read(rs1);
+  double f2 = fpRegs_.read(rs2);
+  double f3 = fpRegs_.read(instRs3_);
+  double res = std::fma(f1, f2, -f3);
+  fpRegs_.write(rd, res);
+
+  updateAccruedFpBits();
+  restoreFpRoundingMode(prevMode);
 }
 
 
-// Remainder instruction.
 template <typename URV>
 void
-Core<URV>::execRem(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execFnmsub_d(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  SRV a = intRegs_.read(rs1);
-  SRV b = intRegs_.read(rs2);
-  SRV c = a;  // Divide by zero remainder.
-  if (b != 0)
+  if (not isRvd())
     {
-      SRV minInt = SRV(1) << (intRegs_.regWidth() - 1);
-      if (a == minInt and b == -1)
-	c = 0;   // Per spec: User-Level ISA, Version 2.3, Section 6.2
-      else
-	c = a % b;
+      illegalInst();
+      return;
     }
-  intRegs_.write(rd, c);
-}
 
+  RoundingMode riscvMode = effectiveRoundingMode();
+  if (riscvMode >= RoundingMode::Invalid1)
+    {
+      illegalInst();
+      return;
+    }
 
-// Unsigned remainder instruction.
-template <typename URV>
-void
-Core<URV>::execRemu(uint32_t rd, uint32_t rs1, int32_t rs2)
-{
-  URV a = intRegs_.read(rs1);
-  URV b = intRegs_.read(rs2);
-  URV c = a;  // Divide by zero remainder.
-  if (b != 0)
-    c = a % b;
-  intRegs_.write(rd, c);
+  if (softFloat_)
+    {
+      const uint64_t signBit = uint64_t(1) << 63;
+      unsigned flags = 0;
+      uint64_t res = SoftFloat::fma(fpRegs_.readDoubleBits(rs1) ^ signBit,
+				    fpRegs_.readDoubleBits(rs2),
+				    fpRegs_.readDoubleBits(instRs3_),
+				    riscvMode, flags);
+      fpRegs_.writeDoubleBits(rd, res);
+      orFcsrFlags(flags);
+      return;
+    }
+
+  clearFpFlags();
+  int prevMode = setFpRoundingMode(riscvMode);
+
+  double f1 = fpRegs_.read(rs1);
+  double f2 = fpRegs_.read(rs2);
+  double f3 = fpRegs_.read(instRs3_);
+  double res = std::fma(f1, f2, -f3);
+  fpRegs_.write(rd, -res);
+
+  updateAccruedFpBits();
+  restoreFpRoundingMode(prevMode);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execLwu(uint32_t rd, uint32_t rs1, int32_t imm)
+Core<URV>::execFnmadd_d(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  if (not isRv64())
+  if (not isRvd())
     {
       illegalInst();
       return;
     }
-  load<uint32_t>(rd, rs1, imm);
-}
 
-
-template <typename URV>
-void
-Core<URV>::execLd(uint32_t rd, uint32_t rs1, int32_t imm)
-{
-  if (not isRv64())
+  RoundingMode riscvMode = effectiveRoundingMode();
+  if (riscvMode >= RoundingMode::Invalid1)
     {
       illegalInst();
       return;
     }
-  load<uint64_t>(rd, rs1, imm);
+
+  if (softFloat_)
+    {
+      const uint64_t signBit = uint64_t(1) << 63;
+      unsigned flags = 0;
+      uint64_t res = SoftFloat::fma(fpRegs_.readDoubleBits(rs1) ^ signBit,
+				    fpRegs_.readDoubleBits(rs2),
+				    fpRegs_.readDoubleBits(instRs3_) ^ signBit,
+				    riscvMode, flags);
+      fpRegs_.writeDoubleBits(rd, res);
+      orFcsrFlags(flags);
+      return;
+    }
+
+  clearFpFlags();
+  int prevMode = setFpRoundingMode(riscvMode);
+
+  double f1 = fpRegs_.read(rs1);
+  double f2 = fpRegs_.read(rs2);
+  double f3 = fpRegs_.read(instRs3_);
+  double res = std::fma(f1, f2, f3);
+  fpRegs_.write(rd, -res);
+
+  updateAccruedFpBits();
+  restoreFpRoundingMode(prevMode);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execSd(uint32_t rs1, uint32_t rs2, int32_t imm)
+Core<URV>::execFadd_d(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  if (not isRv64())
+  if (not isRvd())
     {
       illegalInst();
       return;
     }
 
-  URV addr = intRegs_.read(rs1) + SRV(imm);
-  URV value = intRegs_.read(rs2);
+  RoundingMode riscvMode = effectiveRoundingMode();
+  if (riscvMode >= RoundingMode::Invalid1)
+    {
+      illegalInst();
+      return;
+    }
 
-  store<uint64_t>(addr, value);
+  if (softFloat_)
+    {
+      unsigned flags = 0;
+      uint64_t res = SoftFloat::add(fpRegs_.readDoubleBits(rs1),
+				    fpRegs_.readDoubleBits(rs2),
+				    riscvMode, flags);
+      fpRegs_.writeDoubleBits(rd, res);
+      orFcsrFlags(flags);
+      return;
+    }
+
+  clearFpFlags();
+  int prevMode = setFpRoundingMode(riscvMode);
+
+  double d1 = fpRegs_.read(rs1);
+  double d2 = fpRegs_.read(rs2);
+  double res = d1 + d2;
+  fpRegs_.write(rd, res);
+
+  updateAccruedFpBits();
+  restoreFpRoundingMode(prevMode);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execSlliw(uint32_t rd, uint32_t rs1, int32_t amount)
+Core<URV>::execFsub_d(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  if (not isRv64())
+  if (not isRvd())
     {
       illegalInst();
       return;
     }
 
-  if (amount > 0x1f)
+  RoundingMode riscvMode = effectiveRoundingMode();
+  if (riscvMode >= RoundingMode::Invalid1)
     {
-      illegalInst();   // Bit 5 is 1 or higher values.
+      illegalInst();
       return;
     }
 
-  int32_t word = intRegs_.read(rs1);
-  word <<= amount;
+  if (softFloat_)
+    {
+      unsigned flags = 0;
+      uint64_t res = SoftFloat::sub(fpRegs_.readDoubleBits(rs1),
+				    fpRegs_.readDoubleBits(rs2),
+				    riscvMode, flags);
+      fpRegs_.writeDoubleBits(rd, res);
+      orFcsrFlags(flags);
+      return;
+    }
 
-  SRV value = word; // Sign extend to 64-bit.
-  intRegs_.write(rd, value);
+  clearFpFlags();
+  int prevMode = setFpRoundingMode(riscvMode);
+
+  double d1 = fpRegs_.read(rs1);
+  double d2 = fpRegs_.read(rs2);
+  double res = d1 - d2;
+  fpRegs_.write(rd, res);
+
+  updateAccruedFpBits();
+  restoreFpRoundingMode(prevMode);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execSrliw(uint32_t rd, uint32_t rs1, int32_t amount)
+Core<URV>::execFmul_d(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  if (not isRv64())
+  if (not isRvd())
     {
       illegalInst();
       return;
     }
 
-  if (amount > 0x1f)
+  RoundingMode riscvMode = effectiveRoundingMode();
+  if (riscvMode >= RoundingMode::Invalid1)
     {
-      illegalInst();   // Bit 5 is 1 or higher values.
+      illegalInst();
       return;
     }
 
-  uint32_t word = intRegs_.read(rs1);
-  word >>= amount;
+  if (softFloat_)
+    {
+      unsigned flags = 0;
+      uint64_t res = SoftFloat::mul(fpRegs_.readDoubleBits(rs1),
+				    fpRegs_.readDoubleBits(rs2),
+				    riscvMode, flags);
+      fpRegs_.writeDoubleBits(rd, res);
+      orFcsrFlags(flags);
+      return;
+    }
 
-  SRV value = int32_t(word); // Sign extend to 64-bit.
-  intRegs_.write(rd, value);
+  clearFpFlags();
+  int prevMode = setFpRoundingMode(riscvMode);
+
+  double d1 = fpRegs_.read(rs1);
+  double d2 = fpRegs_.read(rs2);
+  double res = d1 * d2;
+  fpRegs_.write(rd, res);
+
+  updateAccruedFpBits();
+  restoreFpRoundingMode(prevMode);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execSraiw(uint32_t rd, uint32_t rs1, int32_t amount)
+Core<URV>::execFdiv_d(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  if (not isRv64())
+  if (not isRvd())
     {
       illegalInst();
       return;
     }
 
-  if (amount > 0x1f)
+
+  RoundingMode riscvMode = effectiveRoundingMode();
+  if (riscvMode >= RoundingMode::Invalid1)
     {
-      illegalInst();   // Bit 5 is 1 or higher values.
+      illegalInst();
       return;
     }
 
-  int32_t word = intRegs_.read(rs1);
-  word >>= amount;
+  if (softFloat_)
+    {
+      unsigned flags = 0;
+      uint64_t res = SoftFloat::div(fpRegs_.readDoubleBits(rs1),
+				    fpRegs_.readDoubleBits(rs2),
+				    riscvMode, flags);
+      fpRegs_.writeDoubleBits(rd, res);
+      orFcsrFlags(flags);
+      return;
+    }
 
-  SRV value = word; // Sign extend to 64-bit.
-  intRegs_.write(rd, value);
+  clearFpFlags();
+  int prevMode = setFpRoundingMode(riscvMode);
+
+  double d1 = fpRegs_.read(rs1);
+  double d2 = fpRegs_.read(rs2);
+  double res = d1 / d2;
+  fpRegs_.write(rd, res);
+
+  updateAccruedFpBits();
+  restoreFpRoundingMode(prevMode);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execAddiw(uint32_t rd, uint32_t rs1, int32_t imm)
+Core<URV>::execFsgnj_d(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  if (not isRv64())
+  if (not isRvd())
     {
       illegalInst();
       return;
     }
 
-  int32_t word = intRegs_.read(rs1);
-  word += imm;
-  SRV value = word;  // sign extend to 64-bits
-  intRegs_.write(rd, value);
+  double d1 = fpRegs_.read(rs1);
+  double d2 = fpRegs_.read(rs2);
+  double res = copysign(d1, d2);  // Magnitude of rs1 and sign of rs2
+  fpRegs_.write(rd, res);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execAddw(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execFsgnjn_d(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  if (not isRv64())
+  if (not isRvd())
     {
       illegalInst();
       return;
     }
 
-  int32_t word = intRegs_.read(rs1) + intRegs_.read(rs2);
-  SRV value = word;  // sign extend to 64-bits
-  intRegs_.write(rd, value);
+  double d1 = fpRegs_.read(rs1);
+  double d2 = fpRegs_.read(rs2);
+  double res = copysign(d1, d2);  // Magnitude of rs1 and sign of rs2
+  res = -res;  // Magnitude of rs1 and negative the sign of rs2
+  fpRegs_.write(rd, res);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execSubw(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execFsgnjx_d(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  if (not isRv64())
+  if (not isRvd())
     {
       illegalInst();
       return;
     }
 
-  int32_t word = intRegs_.read(rs1) - intRegs_.read(rs2);
-  SRV value = word;  // sign extend to 64-bits
-  intRegs_.write(rd, value);
+  double d1 = fpRegs_.read(rs1);
+  double d2 = fpRegs_.read(rs2);
+
+  int sign1 = (std::signbit(d1) == 0) ? 0 : 1;
+  int sign2 = (std::signbit(d2) == 0) ? 0 : 1;
+  int sign = sign1 ^ sign2;
+
+  double x = sign? -1 : 1;
+
+  double res = copysign(d1, x);  // Magnitude of rs1 and sign of x
+  fpRegs_.write(rd, res);
 }
 
 
+template <typename URV>
+void
+Core<URV>::execFmin_d(uint32_t rd, uint32_t rs1, int32_t rs2)
+{
+  if (not isRvd())
+    {
+      illegalInst();
+      return;
+    }
+
+  double in1 = fpRegs_.read(rs1);
+  double in2 = fpRegs_.read(rs2);
+  double res = fmin(in1, in2);
+  fpRegs_.write(rd, res);
+}
+
 
 template <typename URV>
 void
-Core<URV>::execSllw(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execFmax_d(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  if (not isRv64())
+  if (not isRvd())
     {
       illegalInst();
       return;
     }
 
-  uint32_t shift = intRegs_.read(rs2) & 0x1f;
-  int32_t word = intRegs_.read(rs1) << shift;
-  SRV value = word;  // sign extend to 64-bits
-  intRegs_.write(rd, value);
+  double in1 = fpRegs_.read(rs1);
+  double in2 = fpRegs_.read(rs2);
+  double res = fmax(in1, in2);
+  fpRegs_.write(rd, res);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execSrlw(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execFcvt_d_s(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  if (not isRv64())
+  if (not isRvd())
     {
       illegalInst();
       return;
     }
 
-  uint32_t word = intRegs_.read(rs1);
-  uint32_t shift = intRegs_.read(rs2) & 0x1f;
-  word >>= shift;
-  SRV value = int32_t(word);  // sign extend to 64-bits
-  intRegs_.write(rd, value);
-}
-
-template <typename URV>
-void
-Core<URV>::execSraw(uint32_t rd, uint32_t rs1, int32_t rs2)
-{
-  if (not isRv64())
+  RoundingMode riscvMode = effectiveRoundingMode();
+  if (riscvMode >= RoundingMode::Invalid1)
     {
       illegalInst();
       return;
     }
 
-  int32_t word = intRegs_.read(rs1);
-  uint32_t shift = intRegs_.read(rs2) & 0x1f;
-  word >>= shift;
-  SRV value = word;  // sign extend to 64-bits
-  intRegs_.write(rd, value);
+  clearFpFlags();
+  int prevMode = setFpRoundingMode(riscvMode);
+
+  float f1 = fpRegs_.readSingle(rs1);
+  double result = f1;
+  fpRegs_.write(rd, result);
+
+  updateAccruedFpBits();
+  restoreFpRoundingMode(prevMode);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execMulw(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execFcvt_s_d(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  if (not isRv64())
+  if (not isRvd())
     {
       illegalInst();
       return;
     }
 
-  int32_t word1 = intRegs_.read(rs1);
-  int32_t word2 = intRegs_.read(rs2);
-  int32_t word = word1 * word2;
-  SRV value = word;  // sign extend to 64-bits
-  intRegs_.write(rd, value);
+  RoundingMode riscvMode = effectiveRoundingMode();
+  if (riscvMode >= RoundingMode::Invalid1)
+    {
+      illegalInst();
+      return;
+    }
+
+  clearFpFlags();
+  int prevMode = setFpRoundingMode(riscvMode);
+
+  double d1 = fpRegs_.read(rs1);
+  float result = d1;
+  fpRegs_.writeSingle(rd, result);
+
+  updateAccruedFpBits();
+  restoreFpRoundingMode(prevMode);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execDivw(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execFsqrt_d(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  if (not isRv64())
+  if (not isRvd())
     {
       illegalInst();
       return;
     }
 
-  int32_t word1 = intRegs_.read(rs1);
-  int32_t word2 = intRegs_.read(rs2);
+  RoundingMode riscvMode = effectiveRoundingMode();
+  if (riscvMode >= RoundingMode::Invalid1)
+    {
+      illegalInst();
+      return;
+    }
 
-  int32_t word = -1;  // Divide by zero result
-  if (word2 != 0)
-    word = word1 / word2;
+  if (softFloat_)
+    {
+      unsigned flags = 0;
+      uint64_t res = SoftFloat::sqrt(fpRegs_.readDoubleBits(rs1), riscvMode, flags);
+      fpRegs_.writeDoubleBits(rd, res);
+      orFcsrFlags(flags);
+      return;
+    }
 
-  SRV value = word;  // sign extend to 64-bits
-  intRegs_.write(rd, value);
+  clearFpFlags();
+  int prevMode = setFpRoundingMode(riscvMode);
+
+  double d1 = fpRegs_.read(rs1);
+  double res = std::sqrt(d1);
+  fpRegs_.write(rd, res);
+
+  updateAccruedFpBits();
+  restoreFpRoundingMode(prevMode);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execDivuw(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execFle_d(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  if (not isRv64())
+  if (not isRvd())
     {
       illegalInst();
       return;
     }
 
-  uint32_t word1 = intRegs_.read(rs1);
-  uint32_t word2 = intRegs_.read(rs2);
+  double d1 = fpRegs_.read(rs1);
+  double d2 = fpRegs_.read(rs2);
 
-  uint32_t word = ~uint32_t(0);  // Divide by zero result.
-  if (word2 != 0)
-    word = word1 / word2;
+  URV res = (d1 <= d2)? 1 : 0;
+  intRegs_.write(rd, res);
 
-  URV value = word;  // zero extend to 64-bits
-  intRegs_.write(rd, value);
+  updateAccruedFpBits();
 }
 
 
 template <typename URV>
 void
-Core<URV>::execRemw(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execFlt_d(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  if (not isRv64())
+  if (not isRvd())
     {
       illegalInst();
       return;
     }
 
-  int32_t word1 = intRegs_.read(rs1);
-  int32_t word2 = intRegs_.read(rs2);
+  double d1 = fpRegs_.read(rs1);
+  double d2 = fpRegs_.read(rs2);
 
-  int32_t word = word1;  // Divide by zero remainder
-  if (word2 != 0)
-    word = word1 % word2;
+  URV res = (d1 < d2)? 1 : 0;
+  intRegs_.write(rd, res);
 
-  SRV value = word;  // sign extend to 64-bits
-  intRegs_.write(rd, value);
+  updateAccruedFpBits();
 }
 
 
 template <typename URV>
 void
-Core<URV>::execRemuw(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execFeq_d(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  if (not isRv64())
+  if (not isRvd())
     {
       illegalInst();
       return;
     }
 
-  uint32_t word1 = intRegs_.read(rs1);
-  uint32_t word2 = intRegs_.read(rs1);
+  double d1 = fpRegs_.read(rs1);
+  double d2 = fpRegs_.read(rs2);
 
-  uint32_t word = word1;  // Divide by zero remainder
-  if (word1 != 0)
-    word = word1 % word2;
+  URV res = (d1 == d2)? 1 : 0;
+  intRegs_.write(rd, res);
 
-  URV value = word;  // zero extend to 64-bits
-  intRegs_.write(rd, value);
+  updateAccruedFpBits();
 }
 
 
 template <typename URV>
-RoundingMode
-Core<URV>::effectiveRoundingMode()
+void
+Core<URV>::execFcvt_w_d(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  if (instRoundingMode_ != RoundingMode::Dynamic)
-    return instRoundingMode_;
+  if (not isRvd())
+    {
+      illegalInst();
+      return;
+    }
 
-  URV fcsrVal = 0;
-  if (csRegs_.read(CsrNumber::FCSR, PrivilegeMode::Machine, debugMode_,
-		   fcsrVal))
+  RoundingMode riscvMode = effectiveRoundingMode();
+  if (riscvMode >= RoundingMode::Invalid1)
     {
-      RoundingMode mode = RoundingMode((fcsrVal >> 5) & 0x7);
-      return mode;
+      illegalInst();
+      return;
     }
 
-  return instRoundingMode_;
+  clearFpFlags();
+  int prevMode = setFpRoundingMode(riscvMode);
+
+  double d1 = fpRegs_.read(rs1);
+  SRV result = int32_t(d1);
+  intRegs_.write(rd, result);
+
+  updateAccruedFpBits();
+  restoreFpRoundingMode(prevMode);
 }
 
 
 template <typename URV>
 void
-Core<URV>::updateAccruedFpBits()
+Core<URV>::execFcvt_wu_d(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  URV val = 0;
-  if (csRegs_.read(CsrNumber::FCSR, PrivilegeMode::Machine, debugMode_, val))
+  if (not isRvd())
     {
-      URV prev = val;
-
-      int flags = fetestexcept(FE_ALL_EXCEPT);
-      
-      if (flags & FE_INEXACT)
-	val |= URV(FpFlags::Inexact);
+      illegalInst();
+      return;
+    }
 
-      if (flags & FE_UNDERFLOW)
-	val |= URV(FpFlags::Underflow);
+  RoundingMode riscvMode = effectiveRoundingMode();
+  if (riscvMode >= RoundingMode::Invalid1)
+    {
+      illegalInst();
+      return;
+    }
 
-      if (flags & FE_OVERFLOW)
-	val |= URV(FpFlags::Overflow);
-      
-      if (flags & FE_DIVBYZERO)
-	val |= URV(FpFlags::DivByZero);
+  clearFpFlags();
+  int prevMode = setFpRoundingMode(riscvMode);
 
-      if (flags & FE_INVALID)
-	val |= URV(FpFlags::Invalid);
+  double d1 = fpRegs_.read(rs1);
+  URV result = uint32_t(d1);
+  intRegs_.write(rd, result);
 
-      if (val != prev)
-	csRegs_.write(CsrNumber::FCSR, PrivilegeMode::Machine, debugMode_, val);
-    }
+  updateAccruedFpBits();
+  restoreFpRoundingMode(prevMode);
 }
 
 
-int
-setSimulatorRoundingMode(RoundingMode mode)
+template <typename URV>
+void
+Core<URV>::execFcvt_d_w(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  int previous = std::fegetround();
-  switch(mode)
+  if (not isRvd())
     {
-    case RoundingMode::NearestEven: std::fesetround(FE_TONEAREST);  break;
-    case RoundingMode::Zero:        std::fesetround(FE_TOWARDZERO); break;
-    case RoundingMode::Down:        std::fesetround(FE_DOWNWARD);   break;
-    case RoundingMode::Up:          std::fesetround(FE_UPWARD);     break;
-    case RoundingMode::NearestMax:  std::fesetround(FE_TONEAREST);  break; //FIX
-    default: break;
+      illegalInst();
+      return;
     }
-  return previous;
-}
 
-
-template <typename URV>
-void
-Core<URV>::execFlw(uint32_t rd, uint32_t rs1, int32_t imm)
-{
-  if (not isRvf())
+  RoundingMode riscvMode = effectiveRoundingMode();
+  if (riscvMode >= RoundingMode::Invalid1)
     {
       illegalInst();
       return;
     }
 
-  URV addr = intRegs_.read(rs1) + SRV(imm);
+  clearFpFlags();
+  int prevMode = setFpRoundingMode(riscvMode);
 
-  loadAddr_ = addr;    // For reporting load addr in trace-mode.
-  loadAddrValid_ = true;  // For reporting load addr in trace-mode.
+  int32_t i1 = intRegs_.read(rs1);
+  double result = i1;
+  fpRegs_.write(rd, result);
 
-  if (hasActiveTrigger())
-    {
-      typedef TriggerTiming Timing;
+  updateAccruedFpBits();
+  restoreFpRoundingMode(prevMode);
+}
 
-      bool isLoad = true;
-      if (ldStAddrTriggerHit(addr, Timing::Before, isLoad, isInterruptEnabled()))
-	triggerTripped_ = true;
-      if (triggerTripped_)
-	return;
-    }
 
-  // Misaligned load from io section triggers an exception. Crossing
-  // dccm to non-dccm causes an exception.
-  bool misaligned = addr & 0x3;
-  misalignedLdSt_ = misaligned;
-  if (misaligned and misalignedAccessCausesException(addr, 4))
+template <typename URV>
+void
+Core<URV>::execFcvt_d_wu(uint32_t rd, uint32_t rs1, int32_t rs2)
+{
+  if (not isRvd())
     {
-      forceAccessFail_ = false;
-      ldStException_ = true;
-      initiateException(ExceptionCause::LOAD_ADDR_MISAL, currPc_, addr);
+      illegalInst();
       return;
     }
 
-  union UFU  // Unsigned float union: reinterpret bits as unsigned or float
-  {
-    uint32_t u;
-    float f;
-  };
-
-  uint32_t word = 0;
-  if (not forceAccessFail_ and memory_.read(addr, word))
-    {
-      UFU ufu;
-      ufu.u = word;
-      fpRegs_.writeSingle(rd, ufu.f);
-    }
-  else
+  RoundingMode riscvMode = effectiveRoundingMode();
+  if (riscvMode >= RoundingMode::Invalid1)
     {
-      forceAccessFail_ = false;
-      initiateException(ExceptionCause::LOAD_ACC_FAULT, currPc_, addr);
-      ldStException_ = true;
+      illegalInst();
+      return;
     }
+
+  clearFpFlags();
+  int prevMode = setFpRoundingMode(riscvMode);
+
+  uint32_t i1 = intRegs_.read(rs1);
+  double result = i1;
+  fpRegs_.write(rd, result);
+
+  updateAccruedFpBits();
+  restoreFpRoundingMode(prevMode);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execFsw(uint32_t rs1, uint32_t rs2, int32_t imm)
+Core<URV>::execFclass_d(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  if (not isRvf())
+  if (not isRvd())
     {
       illegalInst();
       return;
     }
 
-  URV addr = intRegs_.read(rs1) + SRV(imm);
-  float val = fpRegs_.readSingle(rs2);
-
-  union UFU  // Unsigned float union: reinterpret bits as unsigned or float
-  {
-    uint32_t u;
-    float f;
-  };
-
-  UFU ufu;
-  ufu.f = val;
+  double d1 = fpRegs_.read(rs1);
+  URV result = 0;
 
-  store<uint32_t>(addr, ufu.u);
-}
+  bool pos = not std::signbit(d1);
+  int type = std::fpclassify(d1);
 
+  if (type == FP_INFINITE)
+    {
+      if (pos)
+	result |= URV(FpClassifyMasks::PosInfinity);
+      else
+	result |= URV(FpClassifyMasks::NegInfinity);
+    }
+  else if (type == FP_NORMAL)
+    {
+      if (pos)
+	result |= URV(FpClassifyMasks::PosNormal);
+      else
+	result |= URV(FpClassifyMasks::NegNormal);
+    }
+  else if (type == FP_SUBNORMAL)
+    {
+      if (pos)
+	result |= URV(FpClassifyMasks::PosSubnormal);
+      else
+	result |= URV(FpClassifyMasks::NegSubnormal);
+    }
+  else if (type == FP_ZERO)
+    {
+      if (pos)
+	result |= URV(FpClassifyMasks::PosZero);
+      else
+	result |= URV(FpClassifyMasks::NegZero);
+    }
+  else if(type == FP_NAN)
+    {
+      bool quiet = mostSignificantFractionBit(d1);
+      if (quiet)
+	result |= URV(FpClassifyMasks::QuietNan);
+      else
+	result |= URV(FpClassifyMasks::SignalingNan);
+    }
 
-inline
-void
-feClearAllExceptions()
-{
-  asm("fnclex");  // std::feclearexcept(FE_ALL_EXCEPT);
+  intRegs_.write(rd, result);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execFmadd_s(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execFcvt_l_d(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  if (not isRvf())
+  if (not isRv64() or not isRvd())
     {
       illegalInst();
       return;
@@ -8621,25 +10072,23 @@ Core<URV>::execFmadd_s(uint32_t rd, uint32_t rs1, int32_t rs2)
       return;
     }
 
-  feClearAllExceptions();
-  int prevMode = setSimulatorRoundingMode(riscvMode);
+  clearFpFlags();
+  int prevMode = setFpRoundingMode(riscvMode);
 
-  float f1 = fpRegs_.readSingle(rs1);
-  float f2 = fpRegs_.readSingle(rs2);
-  float f3 = fpRegs_.readSingle(instRs3_);
-  float res = std::fma(f1, f2, f3);
-  fpRegs_.writeSingle(rd, res);
+  double f1 = fpRegs_.read(rs1);
+  SRV result = int64_t(f1);
+  intRegs_.write(rd, result);
 
   updateAccruedFpBits();
-  std::fesetround(prevMode);
+  restoreFpRoundingMode(prevMode);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execFmsub_s(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execFcvt_lu_d(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  if (not isRvf())
+  if (not isRv64() or not isRvd())
     {
       illegalInst();
       return;
@@ -8652,25 +10101,23 @@ Core<URV>::execFmsub_s(uint32_t rd, uint32_t rs1, int32_t rs2)
       return;
     }
 
-  feClearAllExceptions();
-  int prevMode = setSimulatorRoundingMode(riscvMode);
+  clearFpFlags();
+  int prevMode = setFpRoundingMode(riscvMode);
 
-  float f1 = fpRegs_.readSingle(rs1);
-  float f2 = fpRegs_.readSingle(rs2);
-  float f3 = fpRegs_.readSingle(instRs3_);
-  float res = std::fma(f1, f2, -f3);
-  fpRegs_.writeSingle(rd, res);
+  double f1 = fpRegs_.read(rs1);
+  URV result = uint64_t(f1);
+  intRegs_.write(rd, result);
 
   updateAccruedFpBits();
-  std::fesetround(prevMode);
+  restoreFpRoundingMode(prevMode);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execFnmsub_s(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execFcvt_d_l(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  if (not isRvf())
+  if (not isRv64() or not isRvd())
     {
       illegalInst();
       return;
@@ -8683,25 +10130,23 @@ Core<URV>::execFnmsub_s(uint32_t rd, uint32_t rs1, int32_t rs2)
       return;
     }
 
-  feClearAllExceptions();
-  int prevMode = setSimulatorRoundingMode(riscvMode);
+  clearFpFlags();
+  int prevMode = setFpRoundingMode(riscvMode);
 
-  float f1 = fpRegs_.readSingle(rs1);
-  float f2 = fpRegs_.readSingle(rs2);
-  float f3 = fpRegs_.readSingle(instRs3_);
-  float res = std::fma(f1, f2, -f3);
-  fpRegs_.writeSingle(rd, -res);
+  int64_t i1 = intRegs_.read(rs1);
+  double result = i1;
+  fpRegs_.write(rd, result);
 
   updateAccruedFpBits();
-  std::fesetround(prevMode);
+  restoreFpRoundingMode(prevMode);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execFnmadd_s(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execFcvt_d_lu(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  if (not isRvf())
+  if (not isRv64() or not isRvd())
     {
       illegalInst();
       return;
@@ -8714,2194 +10159,2589 @@ Core<URV>::execFnmadd_s(uint32_t rd, uint32_t rs1, int32_t rs2)
       return;
     }
 
-  feClearAllExceptions();
-  int prevMode = setSimulatorRoundingMode(riscvMode);
+  clearFpFlags();
+  int prevMode = setFpRoundingMode(riscvMode);
 
-  float f1 = fpRegs_.readSingle(rs1);
-  float f2 = fpRegs_.readSingle(rs2);
-  float f3 = fpRegs_.readSingle(instRs3_);
-  float res = std::fma(f1, f2, f3);
-  fpRegs_.writeSingle(rd, -res);
+  uint64_t i1 = intRegs_.read(rs1);
+  double result = i1;
+  fpRegs_.write(rd, result);
 
   updateAccruedFpBits();
-  std::fesetround(prevMode);
+  restoreFpRoundingMode(prevMode);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execFadd_s(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execFmv_d_x(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  if (not isRvf())
+  if (not isRv64() or not isRvd())
     {
       illegalInst();
       return;
     }
 
-  RoundingMode riscvMode = effectiveRoundingMode();
-  if (riscvMode >= RoundingMode::Invalid1)
+  uint64_t u1 = intRegs_.read(rs1);
+
+  union UDU  // Unsigned double union: reinterpret bits as unsigned or double
+  {
+    uint64_t u;
+    double d;
+  };
+
+  UDU udu;
+  udu.u = u1;
+
+  fpRegs_.write(rd, udu.d);
+}
+
+
+template <typename URV>
+void
+Core<URV>::execFmv_x_d(uint32_t rd, uint32_t rs1, int32_t rs2)
+{
+  if (not isRv64() or not isRvd())
     {
       illegalInst();
       return;
     }
 
-  feClearAllExceptions();
-  int prevMode = setSimulatorRoundingMode(riscvMode);
+  double d1 = fpRegs_.read(rs1);
 
-  float f1 = fpRegs_.readSingle(rs1);
-  float f2 = fpRegs_.readSingle(rs2);
-  float res = f1 + f2;
-  fpRegs_.writeSingle(rd, res);
+  union UDU  // Unsigned double union: reinterpret bits as unsigned or double
+  {
+    uint64_t u;
+    double d;
+  };
 
-  updateAccruedFpBits();
-  std::fesetround(prevMode);
+  UDU udu;
+  udu.d = d1;
+
+  intRegs_.write(rd, udu.u);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execFsub_s(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execAmoadd_w(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  if (not isRvf())
+  URV rs2Val = intRegs_.read(rs2);
+
+  execLw(rd, rs1, 0);
+  if (ldStException_)
+    return;
+
+  // Sign extend loaded word.
+  URV rdVal = intRegs_.read(rd);
+  int32_t x = rdVal;
+  rdVal = SRV(x);
+
+  URV addr = intRegs_.read(rs1);
+
+  URV result = rs2Val + rdVal;
+  store<uint32_t>(addr, result);
+
+  if (not ldStException_)
+    intRegs_.write(rd, rdVal);
+}
+
+
+template <typename URV>
+void
+Core<URV>::execAmoswap_w(uint32_t rd, uint32_t rs1, int32_t rs2)
+{
+  URV rs2Val = intRegs_.read(rs2);
+
+  execLw(rd, rs1, 0);
+  if (ldStException_)
+    return;
+
+  // Sign extend loaded word.
+  URV rdVal = intRegs_.read(rd);
+  int32_t x = rdVal;
+  rdVal = SRV(x);
+
+  URV addr = intRegs_.read(rs1);
+
+  URV result = rs2Val;
+  store<uint32_t>(addr, result);
+
+  if (not ldStException_)
+    intRegs_.write(rd, rdVal);
+}
+
+
+template <typename URV>
+template <typename LOAD_TYPE>
+void
+Core<URV>::loadReserve(uint32_t rd, uint32_t rs1)
+{
+  URV addr = intRegs_.read(rs1);
+
+  loadAddr_ = addr;    // For reporting load addr in trace-mode.
+  loadAddrValid_ = true;  // For reporting load addr in trace-mode.
+
+  if (loadQueueEnabled_)
+    removeFromLoadQueue(rs1);
+
+  if (hasActiveTrigger())
     {
-      illegalInst();
-      return;
+      typedef TriggerTiming Timing;
+
+      bool isLoad = true;
+      if (ldStAddrTriggerHit(addr, Timing::Before, isLoad, isInterruptEnabled()))
+	triggerTripped_ = true;
+      if (triggerTripped_)
+	return;
     }
 
-  RoundingMode riscvMode = effectiveRoundingMode();
-  if (riscvMode >= RoundingMode::Invalid1)
+  // Unsigned version of LOAD_TYPE
+  typedef typename std::make_unsigned<LOAD_TYPE>::type ULT;
+
+  // Misaligned load triggers an exception.
+  constexpr unsigned alignMask = sizeof(LOAD_TYPE) - 1;
+  bool misaligned = addr & alignMask;
+  misalignedLdSt_ = misaligned;
+  if (misaligned)
     {
-      illegalInst();
+      // We get a load finished for loads with exception. Compensate.
+      if (loadQueueEnabled_ and not forceAccessFail_)
+	putInLoadQueue(sizeof(LOAD_TYPE), addr, 0, 0);
+      forceAccessFail_ = false;
+      ldStException_ = true;
+      initiateException(ExceptionCause::LOAD_ADDR_MISAL, currPc_, addr);
       return;
     }
 
-  feClearAllExceptions();
-  int prevMode = setSimulatorRoundingMode(riscvMode);
+  ULT uval = 0;
+  if (not forceAccessFail_ and memory_.read(addr, uval))
+    {
+      URV value;
+      if constexpr (std::is_same<ULT, LOAD_TYPE>::value)
+        value = uval;
+      else
+        value = SRV(LOAD_TYPE(uval)); // Sign extend.
+
+      if (loadQueueEnabled_)
+	{
+	  URV prev = 0;
+	  peekIntReg(rd, prev);
+	  putInLoadQueue(sizeof(LOAD_TYPE), addr, rd, prev);
+	}
+
+      intRegs_.write(rd, value);
 
-  float f1 = fpRegs_.readSingle(rs1);
-  float f2 = fpRegs_.readSingle(rs2);
-  float res = f1 - f2;
-  fpRegs_.writeSingle(rd, res);
+      if (dcache_.enabled())
+	accessDataCache(addr, sizeof(LOAD_TYPE), false);
+      if (memTrace_.enabled())
+	traceDataAccess(addr, sizeof(LOAD_TYPE), false);
+      if (pageProfile_.enabled())
+	pageProfile_.access(PageProfile::Access::Read, addr, retiredInsts_);
 
-  updateAccruedFpBits();
-  std::fesetround(prevMode);
+      if (watchCheck_)
+	checkWatchpoint(addr, sizeof(LOAD_TYPE), true);
+    }
+  else
+    {
+      // We get a load finished for loads with exception. Compensate.
+      if (loadQueueEnabled_ and not forceAccessFail_)
+	putInLoadQueue(sizeof(LOAD_TYPE), addr, 0, 0);
+      forceAccessFail_ = false;
+      ldStException_ = true;
+      initiateException(ExceptionCause::LOAD_ACC_FAULT, currPc_, addr);
+    }
 }
 
 
 template <typename URV>
 void
-Core<URV>::execFmul_s(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execLr_w(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  if (not isRvf())
-    {
-      illegalInst();
-      return;
-    }
-
-  RoundingMode riscvMode = effectiveRoundingMode();
-  if (riscvMode >= RoundingMode::Invalid1)
-    {
-      illegalInst();
-      return;
-    }
-
-  std::feclearexcept(FE_ALL_EXCEPT);
-  int prevMode = setSimulatorRoundingMode(riscvMode);
-
-  float f1 = fpRegs_.readSingle(rs1);
-  float f2 = fpRegs_.readSingle(rs2);
-  float res = f1 * f2;
-  fpRegs_.writeSingle(rd, res);
+  loadReserve<int32_t>(rd, rs1);
+  if (ldStException_ or triggerTripped_)
+    return;
 
-  updateAccruedFpBits();
-  std::fesetround(prevMode);
+  hasLr_ = true;
+  lrAddr_ = loadAddr_;
 }
 
 
+/// STORE_TYPE is either uint32_t or uint64_t.
 template <typename URV>
-void
-Core<URV>::execFdiv_s(uint32_t rd, uint32_t rs1, int32_t rs2)
+template <typename STORE_TYPE>
+bool
+Core<URV>::storeConditional(URV addr, STORE_TYPE storeVal)
 {
-  if (not isRvf())
+  // ld/st-address or instruction-address triggers have priority over
+  // ld/st access or misaligned exceptions.
+  bool hasTrig = hasActiveTrigger();
+  TriggerTiming timing = TriggerTiming::Before;
+  bool isLoad = false;
+  if (hasTrig)
+    if (ldStAddrTriggerHit(addr, timing, isLoad, isInterruptEnabled()))
+      triggerTripped_ = true;
+
+  // Misaligned store causes an exception.
+  constexpr unsigned alignMask = sizeof(STORE_TYPE) - 1;
+  bool misaligned = addr & alignMask;
+  misalignedLdSt_ = misaligned;
+  if (misaligned)
     {
-      illegalInst();
-      return;
+      if (triggerTripped_)
+	return false; // No exception if earlier trig. Suppress store data trig.
+      forceAccessFail_ = false;
+      ldStException_ = true;
+      initiateException(ExceptionCause::STORE_ADDR_MISAL, currPc_, addr);
+      return false;
     }
 
-  RoundingMode riscvMode = effectiveRoundingMode();
-  if (riscvMode >= RoundingMode::Invalid1)
+  if (hasTrig and not forceAccessFail_ and memory_.checkWrite(addr, storeVal))
     {
-      illegalInst();
-      return;
+      // No exception: consider store-data  trigger
+      if (ldStDataTriggerHit(storeVal, timing, isLoad, isInterruptEnabled()))
+	triggerTripped_ = true;
     }
+  if (triggerTripped_)
+    return false;
 
-  feClearAllExceptions();
-  int prevMode = setSimulatorRoundingMode(riscvMode);
+  if (not hasLr_ or addr != lrAddr_)
+    return false;
 
-  float f1 = fpRegs_.readSingle(rs1);
-  float f2 = fpRegs_.readSingle(rs2);
-  float res = f1 / f2;
-  fpRegs_.writeSingle(rd, res);
+  if (not forceAccessFail_ and memory_.write(addr, storeVal))
+    {
+      if (dcache_.enabled())
+	accessDataCache(addr, sizeof(STORE_TYPE), true);
+      if (memTrace_.enabled())
+	traceDataAccess(addr, sizeof(STORE_TYPE), true);
+      if (pageProfile_.enabled())
+	pageProfile_.access(PageProfile::Access::Write, addr, retiredInsts_);
 
-  updateAccruedFpBits();
-  std::fesetround(prevMode);
-}
+      if (watchCheck_)
+	checkWatchpoint(addr, sizeof(STORE_TYPE), false);
 
+      // If we write to special location, end the simulation.
+      if (toHostValid_ and addr == toHost_ and storeVal != 0)
+	{
+	  throw CoreException(CoreException::Stop, "write to to-host",
+			      toHost_, storeVal);
+	}
 
-template <typename URV>
-void
-Core<URV>::execFsqrt_s(uint32_t rd, uint32_t rs1, int32_t rs2)
-{
-  if (not isRvf())
-    {
-      illegalInst();
-      return;
+      if (maxStoreQueueSize_)
+	{
+	  uint64_t prevVal = 0;
+	  memory_.getLastWriteOldValue(prevVal);
+	  putInStoreQueue(sizeof(STORE_TYPE), addr, storeVal, prevVal);
+	}
+      return true;
     }
-
-  RoundingMode riscvMode = effectiveRoundingMode();
-  if (riscvMode >= RoundingMode::Invalid1)
+  else
     {
-      illegalInst();
-      return;
+      forceAccessFail_ = false;
+      ldStException_ = true;
+      initiateException(ExceptionCause::STORE_ACC_FAULT, currPc_, addr);
     }
 
-  std::feclearexcept(FE_ALL_EXCEPT);
-  int prevMode = setSimulatorRoundingMode(riscvMode);
-
-  float f1 = fpRegs_.readSingle(rs1);
-  float res = std::sqrt(f1);
-  fpRegs_.writeSingle(rd, res);
-
-  updateAccruedFpBits();
-  std::fesetround(prevMode);
+  return false;
 }
 
 
 template <typename URV>
 void
-Core<URV>::execFsgnj_s(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execSc_w(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  if (not isRvf())
+  URV value = intRegs_.read(rs2);
+  URV addr = intRegs_.read(rs1);
+
+  if (storeConditional(addr, uint32_t(value)))
     {
-      illegalInst();
+      intRegs_.write(rd, 0); // success
       return;
     }
 
-  float f1 = fpRegs_.readSingle(rs1);
-  float f2 = fpRegs_.readSingle(rs2);
-  float res = copysign(f1, f2);  // Magnitude of rs1 and sign of rs2
-  fpRegs_.writeSingle(rd, res);
+  if (ldStException_ or triggerTripped_)
+    return;
+
+  intRegs_.write(rd, 1);  // fail
 }
 
 
 template <typename URV>
 void
-Core<URV>::execFsgnjn_s(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execAmoxor_w(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  if (not isRvf())   {
-      illegalInst();
-      return;
-    }
+  URV rs2Val = intRegs_.read(rs2);
 
-  float f1 = fpRegs_.readSingle(rs1);
-  float f2 = fpRegs_.readSingle(rs2);
-  float res = copysign(f1, f2);  // Magnitude of rs1 and sign of rs2
-  res = -res;  // Magnitude of rs1 and negative the sign of rs2
-  fpRegs_.writeSingle(rd, res);
+  execLw(rd, rs1, 0);
+  if (ldStException_)
+    return;
+
+  // Sign extend loaded word.
+  URV rdVal = intRegs_.read(rd);
+  int32_t x = rdVal;
+  rdVal = SRV(x);
+
+  URV addr = intRegs_.read(rs1);
+
+  URV result = rs2Val ^ rdVal;
+  store<uint32_t>(addr, result);
+
+  if (not ldStException_)
+    intRegs_.write(rd, rdVal);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execFsgnjx_s(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execAmoor_w(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  if (not isRvf())
-    {
-      illegalInst();
-      return;
-    }
+  URV rs2Val = intRegs_.read(rs2);
 
-  float f1 = fpRegs_.readSingle(rs1);
-  float f2 = fpRegs_.readSingle(rs2);
+  execLw(rd, rs1, 0);
+  if (ldStException_)
+    return;
 
-  int sign1 = (std::signbit(f1) == 0) ? 0 : 1;
-  int sign2 = (std::signbit(f2) == 0) ? 0 : 1;
-  int sign = sign1 ^ sign2;
+  // Sign extend loaded word.
+  URV rdVal = intRegs_.read(rd);
+  int32_t x = rdVal;
+  rdVal = SRV(x);
 
-  float x = sign? -1 : 1;
+  URV addr = intRegs_.read(rs1);
 
-  float res = copysign(f1, x);  // Magnitude of rs1 and sign of x
-  fpRegs_.writeSingle(rd, res);
+  URV result = rs2Val | rdVal;
+  store<uint32_t>(addr, result);
+
+  if (not ldStException_)
+    intRegs_.write(rd, rdVal);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execFmin_s(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execAmoand_w(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  if (not isRvf())
-    {
-      illegalInst();
-      return;
-    }
+  URV rs2Val = intRegs_.read(rs2);
 
-  float in1 = fpRegs_.readSingle(rs1);
-  float in2 = fpRegs_.readSingle(rs2);
-  float res = fmin(in1, in2);
-  fpRegs_.writeSingle(rd, res);
-}
+  execLw(rd, rs1, 0);
+  if (ldStException_)
+    return;
 
+  // Sign extend loaded word.
+  URV rdVal = intRegs_.read(rd);
+  int32_t x = rdVal;
+  rdVal = SRV(x);
 
-template <typename URV>
-void
-Core<URV>::execFmax_s(uint32_t rd, uint32_t rs1, int32_t rs2)
-{
-  if (not isRvf())
-    {
-      illegalInst();
-      return;
-    }
+  URV addr = intRegs_.read(rs1);
 
-  float in1 = fpRegs_.readSingle(rs1);
-  float in2 = fpRegs_.readSingle(rs2);
-  float res = fmax(in1, in2);
-  fpRegs_.writeSingle(rd, res);
+  URV result = rs2Val & rdVal;
+  store<uint32_t>(addr, result);
+
+  if (not ldStException_)
+    intRegs_.write(rd, rdVal);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execFcvt_w_s(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execAmomin_w(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  if (not isRvf())
-    {
-      illegalInst();
-      return;
-    }
+  URV rs2Val = intRegs_.read(rs2);
 
-  RoundingMode riscvMode = effectiveRoundingMode();
-  if (riscvMode >= RoundingMode::Invalid1)
-    {
-      illegalInst();
-      return;
-    }
+  execLw(rd, rs1, 0);
+  if (ldStException_)
+    return;
 
-  feClearAllExceptions();
-  int prevMode = setSimulatorRoundingMode(riscvMode);
+  // Sign extend loaded word.
+  URV rdVal = intRegs_.read(rd);
+  int32_t x = rdVal;
+  rdVal = SRV(x);
 
-  float f1 = fpRegs_.readSingle(rs1);
-  SRV result = int32_t(f1);
-  intRegs_.write(rd, result);
+  URV addr = intRegs_.read(rs1);
 
-  updateAccruedFpBits();
-  std::fesetround(prevMode);
+  URV result = (SRV(rs2Val) < SRV(rdVal))? rs2Val : rdVal;
+  store<uint32_t>(addr, result);
+
+  if (not ldStException_)
+    intRegs_.write(rd, rdVal);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execFcvt_wu_s(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execAmominu_w(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  if (not isRvf())
-    {
-      illegalInst();
-      return;
-    }
+  URV rs2Val = intRegs_.read(rs2);
 
-  RoundingMode riscvMode = effectiveRoundingMode();
-  if (riscvMode >= RoundingMode::Invalid1)
-    {
-      illegalInst();
-      return;
-    }
+  execLw(rd, rs1, 0);
+  if (ldStException_)
+    return;
+
+  // Sign extend loaded word.
+  URV rdVal = intRegs_.read(rd);
+  int32_t x = rdVal;
+  rdVal = SRV(x);
 
-  feClearAllExceptions();
-  int prevMode = setSimulatorRoundingMode(riscvMode);
+  URV addr = intRegs_.read(rs1);
 
-  float f1 = fpRegs_.readSingle(rs1);
-  URV result = uint32_t(f1);
-  intRegs_.write(rd, result);
+  URV result = (rs2Val < rdVal)? rs2Val : rdVal;
+  store<uint32_t>(addr, result);
 
-  updateAccruedFpBits();
-  std::fesetround(prevMode);
+  if (not ldStException_)
+    intRegs_.write(rd, rdVal);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execFmv_x_w(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execAmomax_w(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  if (not isRvf())
-    {
-      illegalInst();
-      return;
-    }
+  URV rs2Val = intRegs_.read(rs2);
 
-  float f1 = fpRegs_.readSingle(rs1);
+  execLw(rd, rs1, 0);
+  if (ldStException_)
+    return;
 
-  union IFU  // Int float union: reinterpret bits as int or float
-  {
-    int32_t i;
-    float f;
-  };
+  // Sign extend loaded word.
+  URV rdVal = intRegs_.read(rd);
+  int32_t x = rdVal;
+  rdVal = SRV(x);
 
-  IFU ifu;
-  ifu.f = f1;
+  URV addr = intRegs_.read(rs1);
 
-  SRV value = SRV(ifu.i); // Sign extend.
+  URV result = (SRV(rs2Val) > SRV(rdVal))? rs2Val : rdVal;
+  store<uint32_t>(addr, result);
 
-  intRegs_.write(rd, value);
+  if (not ldStException_)
+    intRegs_.write(rd, rdVal);
 }
 
- 
+
 template <typename URV>
 void
-Core<URV>::execFeq_s(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execAmomaxu_w(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  if (not isRvf())
-    {
-      illegalInst();
-      return;
-    }
+  URV rs2Val = intRegs_.read(rs2);
 
-  feClearAllExceptions();
+  execLw(rd, rs1, 0);
+  if (ldStException_)
+    return;
 
-  float f1 = fpRegs_.readSingle(rs1);
-  float f2 = fpRegs_.readSingle(rs2);
+  // Sign extend loaded word.
+  URV rdVal = intRegs_.read(rd);
+  int32_t x = rdVal;
+  rdVal = SRV(x);
 
-  URV res = (f1 == f2)? 1 : 0;
-  intRegs_.write(rd, res);
+  URV addr = intRegs_.read(rs1);
 
-  updateAccruedFpBits();
+  URV result = (rs2Val > rdVal)? rs2Val : rdVal;
+  store<uint32_t>(addr, result);
+
+  if (not ldStException_)
+    intRegs_.write(rd, rdVal);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execFlt_s(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execAmoadd_d(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  if (not isRvf())
-    {
-      illegalInst();
-      return;
-    }
+  URV rs2Val = intRegs_.read(rs2);
+
+  execLw(rd, rs1, 0);
+  if (ldStException_)
+    return;
 
-  feClearAllExceptions();
+  URV rdVal = intRegs_.read(rd);
 
-  float f1 = fpRegs_.readSingle(rs1);
-  float f2 = fpRegs_.readSingle(rs2);
+  URV addr = intRegs_.read(rs1);
 
-  URV res = (f1 < f2)? 1 : 0;
-  intRegs_.write(rd, res);
+  URV result = rs2Val + rdVal;
+  store<URV>(addr, result);
 
-  updateAccruedFpBits();
+  if (not ldStException_)
+    intRegs_.write(rd, rdVal);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execFle_s(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execAmoswap_d(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  if (not isRvf())
-    {
-      illegalInst();
-      return;
-    }
-
-  feClearAllExceptions();
-
-  float f1 = fpRegs_.readSingle(rs1);
-  float f2 = fpRegs_.readSingle(rs2);
-
-  URV res = (f1 <= f2)? 1 : 0;
-  intRegs_.write(rd, res);
+  URV rs2Val = intRegs_.read(rs2);
 
-  updateAccruedFpBits();
-}
+  execLd(rd, rs1, 0);
+  if (ldStException_)
+    return;
 
+  URV rdVal = intRegs_.read(rd);
 
-bool
-mostSignificantFractionBit(float x)
-{
-  union UFU
-  {
-    uint32_t u;
-    float f;
-  };
+  URV addr = intRegs_.read(rs1);
 
-  UFU ufu;
-  ufu.f = x;
+  URV result = rs2Val;
+  store<URV>(addr, result);
 
-  return (ufu.u >> 22) & 1;
+  if (not ldStException_)
+    intRegs_.write(rd, rdVal);
 }
 
 
-bool
-mostSignificantFractionBit(double x)
+template <typename URV>
+void
+Core<URV>::execLr_d(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  union UDU
-  {
-    uint64_t u;
-    double d;
-  };
-
-  UDU udu;
-  udu.d = x;
+  loadReserve<int64_t>(rd, rs1);
+  if (ldStException_ or triggerTripped_)
+    return;
 
-  return (udu.u >> 51) & 1;
+  hasLr_ = true;
+  lrAddr_ = loadAddr_;
 }
 
 
-
 template <typename URV>
 void
-Core<URV>::execFclass_s(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execSc_d(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  if (not isRvf())
+  URV value = intRegs_.read(rs2);
+  URV addr = intRegs_.read(rs1);
+
+  if (storeConditional(addr, uint64_t(value)))
     {
-      illegalInst();
+      intRegs_.write(rd, 0); // success
       return;
     }
 
-  float f1 = fpRegs_.readSingle(rs1);
-  URV result = 0;
-
-  bool pos = not std::signbit(f1);
-  int type = std::fpclassify(f1);
-
-  if (type == FP_INFINITE)
-    {
-      if (pos)
-	result |= URV(FpClassifyMasks::PosInfinity);
-      else
-	result |= URV(FpClassifyMasks::NegInfinity);
-    }
-  else if (type == FP_NORMAL)
-    {
-      if (pos)
-	result |= URV(FpClassifyMasks::PosNormal);
-      else
-	result |= URV(FpClassifyMasks::NegNormal);
-    }
-  else if (type == FP_SUBNORMAL)
-    {
-      if (pos)
-	result |= URV(FpClassifyMasks::PosSubnormal);
-      else
-	result |= URV(FpClassifyMasks::NegSubnormal);
-    }
-  else if (type == FP_ZERO)
-    {
-      if (pos)
-	result |= URV(FpClassifyMasks::PosZero);
-      else
-	result |= URV(FpClassifyMasks::NegZero);
-    }
-  else if(type == FP_NAN)
-    {
-      bool quiet = mostSignificantFractionBit(f1);
-      if (quiet)
-	result |= URV(FpClassifyMasks::QuietNan);
-      else
-	result |= URV(FpClassifyMasks::SignalingNan);
-    }
+  if (ldStException_ or triggerTripped_)
+    return;
 
-  intRegs_.write(rd, result);
+  intRegs_.write(rd, 1);  // fail
 }
 
 
 template <typename URV>
 void
-Core<URV>::execFcvt_s_w(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execAmoxor_d(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  if (not isRvf())
-    {
-      illegalInst();
-      return;
-    }
+  URV rs2Val = intRegs_.read(rs2);
 
-  RoundingMode riscvMode = effectiveRoundingMode();
-  if (riscvMode >= RoundingMode::Invalid1)
-    {
-      illegalInst();
-      return;
-    }
+  execLd(rd, rs1, 0);
+  if (ldStException_)
+    return;
+
+  URV rdVal = intRegs_.read(rd);
 
-  feClearAllExceptions();
-  int prevMode = setSimulatorRoundingMode(riscvMode);
+  URV addr = intRegs_.read(rs1);
 
-  int32_t i1 = intRegs_.read(rs1);
-  float result = i1;
-  fpRegs_.writeSingle(rd, result);
+  URV result = rs2Val ^ rdVal;
+  store<URV>(addr, result);
 
-  updateAccruedFpBits();
-  std::fesetround(prevMode);
+  if (not ldStException_)
+    intRegs_.write(rd, rdVal);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execFcvt_s_wu(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execAmoor_d(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  if (not isRvf())
-    {
-      illegalInst();
-      return;
-    }
+  URV rs2Val = intRegs_.read(rs2);
 
-  RoundingMode riscvMode = effectiveRoundingMode();
-  if (riscvMode >= RoundingMode::Invalid1)
-    {
-      illegalInst();
-      return;
-    }
+  execLd(rd, rs1, 0);
+  if (ldStException_)
+    return;
 
-  feClearAllExceptions();
-  int prevMode = setSimulatorRoundingMode(riscvMode);
+  URV rdVal = intRegs_.read(rd);
 
-  uint32_t u1 = intRegs_.read(rs1);
-  float result = u1;
-  fpRegs_.writeSingle(rd, result);
+  URV addr = intRegs_.read(rs1);
 
-  updateAccruedFpBits();
-  std::fesetround(prevMode);
+  URV result = rs2Val | rdVal;
+  store<URV>(addr, result);
+
+  if (not ldStException_)
+    intRegs_.write(rd, rdVal);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execFmv_w_x(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execAmoand_d(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  if (not isRvf())
-    {
-      illegalInst();
-      return;
-    }
+  URV rs2Val = intRegs_.read(rs2);
 
-  uint32_t u1 = intRegs_.read(rs1);
+  execLd(rd, rs1, 0);
+  if (ldStException_)
+    return;
 
-  union UFU  // Unsigned float union: reinterpret bits as unsigned or float
-  {
-    uint32_t u;
-    float f;
-  };
+  URV rdVal = intRegs_.read(rd);
 
-  UFU ufu;
-  ufu.u = u1;
+  URV addr = intRegs_.read(rs1);
 
-  fpRegs_.writeSingle(rd, ufu.f);
+  URV result = rs2Val & rdVal;
+  store<URV>(addr, result);
+
+  if (not ldStException_)
+    intRegs_.write(rd, rdVal);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execFcvt_l_s(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execAmomin_d(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  if (not isRv64() or not isRvf())
-    {
-      illegalInst();
-      return;
-    }
+  URV rs2Val = intRegs_.read(rs2);
 
-  RoundingMode riscvMode = effectiveRoundingMode();
-  if (riscvMode >= RoundingMode::Invalid1)
-    {
-      illegalInst();
-      return;
-    }
+  execLd(rd, rs1, 0);
+  if (ldStException_)
+    return;
 
-  feClearAllExceptions();
-  int prevMode = setSimulatorRoundingMode(riscvMode);
+  URV rdVal = intRegs_.read(rd);
 
-  float f1 = fpRegs_.readSingle(rs1);
-  SRV result = int64_t(f1);
-  intRegs_.write(rd, result);
+  URV addr = intRegs_.read(rs1);
 
-  updateAccruedFpBits();
-  std::fesetround(prevMode);
+  URV result = (SRV(rs2Val) < SRV(rdVal))? rs2Val : rdVal;
+  store<URV>(addr, result);
+
+  if (not ldStException_)
+    intRegs_.write(rd, rdVal);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execFcvt_lu_s(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execAmominu_d(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  if (not isRv64() or not isRvf())
-    {
-      illegalInst();
-      return;
-    }
+  URV rs2Val = intRegs_.read(rs2);
 
-  RoundingMode riscvMode = effectiveRoundingMode();
-  if (riscvMode >= RoundingMode::Invalid1)
-    {
-      illegalInst();
-      return;
-    }
+  execLd(rd, rs1, 0);
+  if (ldStException_)
+    return;
 
-  feClearAllExceptions();
-  int prevMode = setSimulatorRoundingMode(riscvMode);
+  // Sign extend loaded word.
+  URV rdVal = intRegs_.read(rd);
 
-  float f1 = fpRegs_.readSingle(rs1);
-  URV result = uint64_t(f1);
-  intRegs_.write(rd, result);
+  URV addr = intRegs_.read(rs1);
 
-  updateAccruedFpBits();
-  std::fesetround(prevMode);
+  URV result = (rs2Val < rdVal)? rs2Val : rdVal;
+  store<URV>(addr, result);
+
+  if (not ldStException_)
+    intRegs_.write(rd, rdVal);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execFcvt_s_l(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execAmomax_d(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  if (not isRv64() or not isRvf())
-    {
-      illegalInst();
-      return;
-    }
+  URV rs2Val = intRegs_.read(rs2);
 
-  RoundingMode riscvMode = effectiveRoundingMode();
-  if (riscvMode >= RoundingMode::Invalid1)
-    {
-      illegalInst();
-      return;
-    }
+  execLd(rd, rs1, 0);
+  if (ldStException_)
+    return;
 
-  feClearAllExceptions();
-  int prevMode = setSimulatorRoundingMode(riscvMode);
+  // Sign extend loaded word.
+  URV rdVal = intRegs_.read(rd);
 
-  int64_t i1 = intRegs_.read(rs1);
-  float result = i1;
-  fpRegs_.writeSingle(rd, result);
+  URV addr = intRegs_.read(rs1);
 
-  updateAccruedFpBits();
-  std::fesetround(prevMode);
+  URV result = (SRV(rs2Val) > SRV(rdVal))? rs2Val : rdVal;
+  store<URV>(addr, result);
+
+  if (not ldStException_)
+    intRegs_.write(rd, rdVal);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execFcvt_s_lu(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execAmomaxu_d(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  if (not isRv64() or not isRvf())
-    {
-      illegalInst();
-      return;
-    }
+  URV rs2Val = intRegs_.read(rs2);
 
-  RoundingMode riscvMode = effectiveRoundingMode();
-  if (riscvMode >= RoundingMode::Invalid1)
-    {
-      illegalInst();
-      return;
-    }
+  execLd(rd, rs1, 0);
+  if (ldStException_)
+    return;
+
+  // Sign extend loaded word.
+  URV rdVal = intRegs_.read(rd);
 
-  feClearAllExceptions();
-  int prevMode = setSimulatorRoundingMode(riscvMode);
+  URV addr = intRegs_.read(rs1);
 
-  uint64_t i1 = intRegs_.read(rs1);
-  float result = i1;
-  fpRegs_.writeSingle(rd, result);
+  URV result = (rs2Val > rdVal)? rs2Val : rdVal;
+  store<URV>(addr, result);
 
-  updateAccruedFpBits();
-  std::fesetround(prevMode);
+  if (not ldStException_)
+    intRegs_.write(rd, rdVal);
 }
 
 
-template <typename URV>
+/// Return true if element i of a masked vector instruction is active:
+/// Bit i of the given mask register (v0) is set.
+static inline
+bool
+vecElemActive(const uint8_t* mask, unsigned i)
+{
+  return (mask[i >> 3] >> (i & 7)) & 1;
+}
+
+
+/// Element kernel of the vector arithmetic instructions: Set
+/// dest[i] to op(dest[i], a[i], b[i]) for i in [start, end), using
+/// scalar in place of b[i] if b is null. Only active elements are
+/// processed if masked is true; the other elements are left
+/// undisturbed. Unmasked loops are free of branches so that the
+/// compiler turns them into host SIMD code.
+template <typename T, typename OP>
+static inline
 void
-Core<URV>::execFld(uint32_t rd, uint32_t rs1, int32_t imm)
+vecKernel(T* dest, const T* a, const T* b, T scalar, unsigned start,
+	  unsigned end, const uint8_t* mask, bool masked, OP op)
 {
-  if (not isRvd())
+  if (masked)
     {
-      illegalInst();
-      return;
+      for (unsigned i = start; i < end; ++i)
+	if (vecElemActive(mask, i))
+	  dest[i] = op(dest[i], a[i], b? b[i] : scalar);
     }
-
-  URV addr = intRegs_.read(rs1) + SRV(imm);
-
-  loadAddr_ = addr;    // For reporting load addr in trace-mode.
-  loadAddrValid_ = true;  // For reporting load addr in trace-mode.
-
-  if (hasActiveTrigger())
+  else if (b)
     {
-      typedef TriggerTiming Timing;
-
-      bool isLoad = true;
-      if (ldStAddrTriggerHit(addr, Timing::Before, isLoad, isInterruptEnabled()))
-	triggerTripped_ = true;
-      if (triggerTripped_)
-	return;
+      for (unsigned i = start; i < end; ++i)
+	dest[i] = op(dest[i], a[i], b[i]);
     }
-
-  // Misaligned load from io section triggers an exception. Crossing
-  // dccm to non-dccm causes an exception.
-  bool misaligned = addr & 0xf;
-  misalignedLdSt_ = misaligned;
-  if (misaligned and misalignedAccessCausesException(addr, 8))
+  else
     {
-      forceAccessFail_ = false;
-      ldStException_ = true;
-      initiateException(ExceptionCause::LOAD_ADDR_MISAL, currPc_, addr);
-      return;
+      for (unsigned i = start; i < end; ++i)
+	dest[i] = op(dest[i], a[i], scalar);
     }
+}
 
-  union UDU  // Unsigned double union: reinterpret bits as unsigned or double
-  {
-    uint64_t u;
-    double d;
-  };
 
-  uint64_t val64 = 0;
-  if (not forceAccessFail_ and memory_.read(addr, val64))
+/// Element kernel of the vector reductions: Return op applied to
+/// init and the active elements of a in [0, end).
+template <typename T, typename OP>
+static inline
+T
+vecReduceKernel(const T* a, T init, unsigned end, const uint8_t* mask,
+		bool masked, OP op)
+{
+  T acc = init;
+  if (masked)
     {
-      UDU udu;
-      udu.u = val64;
-      fpRegs_.write(rd, udu.d);
+      for (unsigned i = 0; i < end; ++i)
+	if (vecElemActive(mask, i))
+	  acc = op(acc, a[i]);
     }
   else
     {
-      forceAccessFail_ = false;
-      initiateException(ExceptionCause::LOAD_ACC_FAULT, currPc_, addr);
-      ldStException_ = true;
+      for (unsigned i = 0; i < end; ++i)
+	acc = op(acc, a[i]);
     }
+  return acc;
 }
 
 
+/// Return the maximum number of elements (VLMAX) of a vector register
+/// group for the given vtype value and register size in bytes. Return
+/// 0 if vtype is not supported: vill or reserved bits set, reserved
+/// SEW or LMUL, or fractional LMUL too small for SEW (ELEN is 64).
 template <typename URV>
-void
-Core<URV>::execFsd(uint32_t rs1, uint32_t rs2, int32_t imm)
+static
+uint64_t
+vecVlmax(URV vtype, unsigned bytesPerReg)
 {
-  if (not isRvd())
-    {
-      illegalInst();
-      return;
-    }
+  unsigned vsew = (vtype >> 3) & 7, vlmul = vtype & 7;
+  if ((vtype >> 8) != 0 or vsew > 3 or vlmul == 4)
+    return 0;
 
-  URV addr = intRegs_.read(rs1) + SRV(imm);
-  double val = fpRegs_.read(rs2);
+  unsigned sew = 8 << vsew;
+  uint64_t bits = uint64_t(bytesPerReg) * 8;
+  if (vlmul < 4)
+    return (bits << vlmul) / sew;
 
-  union UDU  // Unsigned double union: reinterpret bits as unsigned or double
-  {
-    uint64_t u;
-    double d;
-  };
+  unsigned shift = 8 - vlmul;  // LMUL is 1/2^shift
+  if (sew > (64u >> shift))
+    return 0;
+  return (bits >> shift) / sew;
+}
 
-  UDU udu;
-  udu.d = val;
 
-  store<uint64_t>(addr, udu.u);
+template <typename URV>
+bool
+Core<URV>::vecConfig(unsigned& sew, unsigned& group) const
+{
+  uint64_t vlmax = vecVlmax(vtype_, vecRegs_.bytesPerReg());
+  if (vlmax == 0 or vl_ > vlmax)
+    return false;
+
+  unsigned vlmul = vtype_ & 7;
+  sew = 8 << ((vtype_ >> 3) & 7);
+  group = vlmul < 4? 1 << vlmul : 1;
+  return true;
 }
 
 
 template <typename URV>
-void
-Core<URV>::execFmadd_d(uint32_t rd, uint32_t rs1, int32_t rs2)
+bool
+Core<URV>::checkVecOperands(unsigned vd, unsigned vs1, unsigned vs2,
+			    unsigned& sew, bool vdMayBeMask)
 {
-  if (not isRvd())
+  unsigned group = 1;
+  if (not isRvv() or not vecConfig(sew, group))
     {
       illegalInst();
-      return;
+      return false;
     }
 
-  RoundingMode riscvMode = effectiveRoundingMode();
-  if (riscvMode >= RoundingMode::Invalid1)
+  if (((vd | vs1 | vs2) & (group - 1)) != 0)
     {
       illegalInst();
-      return;
+      return false;
     }
 
-  feClearAllExceptions();
-  int prevMode = setSimulatorRoundingMode(riscvMode);
+  if (vecMasked_ and vd == 0 and not vdMayBeMask)
+    {
+      illegalInst();
+      return false;
+    }
 
-  double f1 = fpRegs_.read(rs1);
-  double f2 = fpRegs_.read(rs2);
-  double f3 = fpRegs_.read(instRs3_);
-  double res = std::fma(f1, f2, f3);
-  fpRegs_.write(rd, res);
+  return true;
+}
 
-  updateAccruedFpBits();
-  std::fesetround(prevMode);
+
+template <typename URV>
+void
+Core<URV>::vecCommit(unsigned vd)
+{
+  unsigned sew = 0, group = 1;
+  vecConfig(sew, group);
+  vecRegs_.setLastWrittenReg(vd, group);
+  vstart_ = 0;
 }
 
 
 template <typename URV>
 void
-Core<URV>::execFmsub_d(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::vecSetConfig(uint32_t rd, URV avl, URV vtype, bool useVlmax,
+			bool keepVl)
 {
-  if (not isRvd())
+  uint64_t vlmax = vecVlmax(vtype, vecRegs_.bytesPerReg());
+
+  // Keeping vl is reserved if it does not fit the new VLMAX.
+  if (keepVl and vl_ > vlmax)
+    vlmax = 0;
+
+  if (vlmax == 0)
     {
-      illegalInst();
-      return;
+      vtype_ = URV(1) << (8*sizeof(URV) - 1);  // vill
+      vl_ = 0;
     }
-
-  RoundingMode riscvMode = effectiveRoundingMode();
-  if (riscvMode >= RoundingMode::Invalid1)
+  else
     {
-      illegalInst();
-      return;
+      vtype_ = vtype;
+      if (useVlmax)
+	vl_ = vlmax;
+      else if (not keepVl)
+	vl_ = avl < vlmax? avl : vlmax;
     }
 
-  feClearAllExceptions();
-  int prevMode = setSimulatorRoundingMode(riscvMode);
+  vstart_ = 0;
+  intRegs_.write(rd, vl_);
+  csRegs_.recordWrite(CsrNumber::VL);
+  csRegs_.recordWrite(CsrNumber::VTYPE);
+}
 
-  double f1 = fpRegs_.read(rs1);
-  double f2 = fpRegs_.read(rs2);
-  double f3 = fpRegs_.read(instRs3_);
-  double res = std::fma(f1, f2, -f3);
-  fpRegs_.write(rd, res);
 
-  updateAccruedFpBits();
-  std::fesetround(prevMode);
+template <typename URV>
+template <typename T, typename OP>
+void
+Core<URV>::vecIntOpSew(uint32_t vd, uint32_t vs2, uint32_t src, VecSrc kind,
+		       OP op)
+{
+  const T* b = nullptr;
+  T scalar = 0;
+  if (kind == VecSrc::Vector)
+    b = vecRegs_.elems<T>(src);
+  else if (kind == VecSrc::Int)
+    scalar = T(SRV(intRegs_.read(src)));  // Sign extend if SEW > XLEN.
+  else if (kind == VecSrc::Imm)
+    scalar = T(int32_t(src << 27) >> 27);
+  else
+    scalar = T(src & 0x1f);
+
+  vecKernel(vecRegs_.elems<T>(vd), vecRegs_.elems<T>(vs2), b, scalar,
+	    vstart_, vl_, vecRegs_.maskBits(), vecMasked_,
+	    [op] (T, T x, T y) { return T(op(x, y)); });
 }
 
 
 template <typename URV>
+template <typename OP>
 void
-Core<URV>::execFnmsub_d(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::vecIntOp(uint32_t vd, uint32_t vs2, uint32_t src, VecSrc kind,
+		    OP op)
 {
-  if (not isRvd())
+  unsigned sew = 0;
+  unsigned vs1 = kind == VecSrc::Vector? src : 0;
+  if (not checkVecOperands(vd, vs1, vs2, sew))
+    return;
+
+  switch (sew)
     {
-      illegalInst();
-      return;
+    case 8:  vecIntOpSew<uint8_t>(vd, vs2, src, kind, op);  break;
+    case 16: vecIntOpSew<uint16_t>(vd, vs2, src, kind, op); break;
+    case 32: vecIntOpSew<uint32_t>(vd, vs2, src, kind, op); break;
+    default: vecIntOpSew<uint64_t>(vd, vs2, src, kind, op); break;
     }
 
-  RoundingMode riscvMode = effectiveRoundingMode();
-  if (riscvMode >= RoundingMode::Invalid1)
+  vecCommit(vd);
+}
+
+
+template <typename URV>
+template <typename OP>
+void
+Core<URV>::vecIntReduce(uint32_t vd, uint32_t vs2, uint32_t vs1, OP op)
+{
+  // Destination and first source are single registers: Only vs2 is a
+  // register group.
+  unsigned sew = 0;
+  bool vdMayBeMask = true;
+  if (not checkVecOperands(0, 0, vs2, sew, vdMayBeMask))
+    return;
+
+  if (vstart_ != 0)
     {
       illegalInst();
       return;
     }
 
-  feClearAllExceptions();
-  int prevMode = setSimulatorRoundingMode(riscvMode);
+  const uint8_t* mask = vecRegs_.maskBits();
+  unsigned vl = vl_;
+  bool masked = vecMasked_;
 
-  double f1 = fpRegs_.read(rs1);
-  double f2 = fpRegs_.read(rs2);
-  double f3 = fpRegs_.read(instRs3_);
-  double res = std::fma(f1, f2, -f3);
-  fpRegs_.write(rd, -res);
+  auto reduce = [this, vd, vs2, vs1, vl, mask, masked, op] (auto zero) {
+    typedef decltype(zero) T;
+    const T* a = vecRegs_.elems<T>(vs2);
+    T init = vecRegs_.elems<T>(vs1)[0];
+    T res = vecReduceKernel(a, init, vl, mask, masked,
+			    [op] (T x, T y) { return T(op(x, y)); });
+    if (vl)
+      vecRegs_.elems<T>(vd)[0] = res;
+  };
 
-  updateAccruedFpBits();
-  std::fesetround(prevMode);
+  switch (sew)
+    {
+    case 8:  reduce(uint8_t(0));  break;
+    case 16: reduce(uint16_t(0)); break;
+    case 32: reduce(uint32_t(0)); break;
+    default: reduce(uint64_t(0)); break;
+    }
+
+  vecRegs_.setLastWrittenReg(vd, 1);
+  vstart_ = 0;
 }
 
 
 template <typename URV>
+template <typename FT, typename UT>
 void
-Core<URV>::execFnmadd_d(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::vecFpOpSew(uint32_t vd, uint32_t vs2, uint32_t src, VecSrc kind,
+		      VecFpOp op, RoundingMode mode)
 {
-  if (not isRvd())
+  static_assert(sizeof(FT) == sizeof(UT));
+
+  UT scalar = 0;
+  if (kind == VecSrc::Fp)
     {
-      illegalInst();
-      return;
+      if constexpr (sizeof(UT) == 4)
+	scalar = fpRegs_.readSingleBits(src);
+      else
+	scalar = fpRegs_.readDoubleBits(src);
     }
 
-  RoundingMode riscvMode = effectiveRoundingMode();
-  if (riscvMode >= RoundingMode::Invalid1)
+  unsigned start = vstart_, end = vl_;
+  const uint8_t* mask = vecRegs_.maskBits();
+  bool masked = vecMasked_;
+
+  if (softFloat_)
     {
-      illegalInst();
+      UT* dest = vecRegs_.elems<UT>(vd);
+      const UT* a = vecRegs_.elems<UT>(vs2);
+      const UT* b = kind == VecSrc::Vector? vecRegs_.elems<UT>(src) : nullptr;
+      unsigned flags = 0;
+      for (unsigned i = start; i < end; ++i)
+	{
+	  if (masked and not vecElemActive(mask, i))
+	    continue;
+	  UT x = a[i], y = b? b[i] : scalar;
+	  switch (op)
+	    {
+	    case VecFpOp::Add:  dest[i] = SoftFloat::add(x, y, mode, flags); break;
+	    case VecFpOp::Sub:  dest[i] = SoftFloat::sub(x, y, mode, flags); break;
+	    case VecFpOp::Rsub: dest[i] = SoftFloat::sub(y, x, mode, flags); break;
+	    case VecFpOp::Mul:  dest[i] = SoftFloat::mul(x, y, mode, flags); break;
+	    case VecFpOp::Div:  dest[i] = SoftFloat::div(x, y, mode, flags); break;
+	    case VecFpOp::Rdiv: dest[i] = SoftFloat::div(y, x, mode, flags); break;
+	    case VecFpOp::Macc:
+	      dest[i] = SoftFloat::fma(y, x, dest[i], mode, flags);
+	      break;
+	    }
+	}
+      orFcsrFlags(flags);
       return;
     }
 
-  feClearAllExceptions();
-  int prevMode = setSimulatorRoundingMode(riscvMode);
+  FT* dest = vecRegs_.elems<FT>(vd);
+  const FT* a = vecRegs_.elems<FT>(vs2);
+  const FT* b = kind == VecSrc::Vector? vecRegs_.elems<FT>(src) : nullptr;
+  FT fs = 0;
+  memcpy(&fs, &scalar, sizeof(fs));
 
-  double f1 = fpRegs_.read(rs1);
-  double f2 = fpRegs_.read(rs2);
-  double f3 = fpRegs_.read(instRs3_);
-  double res = std::fma(f1, f2, f3);
-  fpRegs_.write(rd, -res);
+  clearFpFlags();
+  int prevMode = setFpRoundingMode(mode);
+
+  switch (op)
+    {
+    case VecFpOp::Add:
+      vecKernel(dest, a, b, fs, start, end, mask, masked,
+		[] (FT, FT x, FT y) { return x + y; });
+      break;
+    case VecFpOp::Sub:
+      vecKernel(dest, a, b, fs, start, end, mask, masked,
+		[] (FT, FT x, FT y) { return x - y; });
+      break;
+    case VecFpOp::Rsub:
+      vecKernel(dest, a, b, fs, start, end, mask, masked,
+		[] (FT, FT x, FT y) { return y - x; });
+      break;
+    case VecFpOp::Mul:
+      vecKernel(dest, a, b, fs, start, end, mask, masked,
+		[] (FT, FT x, FT y) { return x * y; });
+      break;
+    case VecFpOp::Div:
+      vecKernel(dest, a, b, fs, start, end, mask, masked,
+		[] (FT, FT x, FT y) { return x / y; });
+      break;
+    case VecFpOp::Rdiv:
+      vecKernel(dest, a, b, fs, start, end, mask, masked,
+		[] (FT, FT x, FT y) { return y / x; });
+      break;
+    case VecFpOp::Macc:
+      vecKernel(dest, a, b, fs, start, end, mask, masked,
+		[] (FT d, FT x, FT y) { return std::fma(y, x, d); });
+      break;
+    }
 
   updateAccruedFpBits();
-  std::fesetround(prevMode);
+  restoreFpRoundingMode(prevMode);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execFadd_d(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::vecFpOp(uint32_t vd, uint32_t vs2, uint32_t src, VecSrc kind,
+		   VecFpOp op)
 {
-  if (not isRvd())
+  unsigned sew = 0;
+  unsigned vs1 = kind == VecSrc::Vector? src : 0;
+  if (not checkVecOperands(vd, vs1, vs2, sew))
+    return;
+
+  if (not (sew == 32 and isRvf()) and not (sew == 64 and isRvd()))
     {
       illegalInst();
       return;
     }
 
-  RoundingMode riscvMode = effectiveRoundingMode();
-  if (riscvMode >= RoundingMode::Invalid1)
+  // Vector instructions have no rounding mode field: Use frm.
+  instRoundingMode_ = RoundingMode::Dynamic;
+  RoundingMode mode = effectiveRoundingMode();
+  if (mode >= RoundingMode::Invalid1)
     {
       illegalInst();
       return;
     }
 
-  feClearAllExceptions();
-  int prevMode = setSimulatorRoundingMode(riscvMode);
-
-  double d1 = fpRegs_.read(rs1);
-  double d2 = fpRegs_.read(rs2);
-  double res = d1 + d2;
-  fpRegs_.write(rd, res);
+  if (sew == 32)
+    vecFpOpSew<float, uint32_t>(vd, vs2, src, kind, op, mode);
+  else
+    vecFpOpSew<double, uint64_t>(vd, vs2, src, kind, op, mode);
 
-  updateAccruedFpBits();
-  std::fesetround(prevMode);
+  vecCommit(vd);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execFsub_d(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::vecFpReduceSum(uint32_t vd, uint32_t vs2, uint32_t vs1)
 {
-  if (not isRvd())
+  unsigned sew = 0;
+  bool vdMayBeMask = true;
+  if (not checkVecOperands(0, 0, vs2, sew, vdMayBeMask))
+    return;
+
+  if (vstart_ != 0 or
+      (not (sew == 32 and isRvf()) and not (sew == 64 and isRvd())))
     {
       illegalInst();
       return;
     }
 
-  RoundingMode riscvMode = effectiveRoundingMode();
-  if (riscvMode >= RoundingMode::Invalid1)
+  instRoundingMode_ = RoundingMode::Dynamic;
+  RoundingMode mode = effectiveRoundingMode();
+  if (mode >= RoundingMode::Invalid1)
     {
       illegalInst();
       return;
     }
 
-  feClearAllExceptions();
-  int prevMode = setSimulatorRoundingMode(riscvMode);
+  const uint8_t* mask = vecRegs_.maskBits();
+  unsigned vl = vl_;
+  bool masked = vecMasked_;
 
-  double d1 = fpRegs_.read(rs1);
-  double d2 = fpRegs_.read(rs2);
-  double res = d1 - d2;
-  fpRegs_.write(rd, res);
+  // Elements are summed in order: This is valid for the unordered
+  // sum as well.
+  auto reduce = [this, vd, vs2, vs1, vl, mask, masked, mode] (auto fz, auto uz) {
+    typedef decltype(fz) FT;
+    typedef decltype(uz) UT;
+    if (softFloat_)
+      {
+	const UT* a = vecRegs_.elems<UT>(vs2);
+	unsigned flags = 0;
+	UT acc = vecRegs_.elems<UT>(vs1)[0];
+	for (unsigned i = 0; i < vl; ++i)
+	  if (not masked or vecElemActive(mask, i))
+	    acc = SoftFloat::add(acc, a[i], mode, flags);
+	if (vl)
+	  vecRegs_.elems<UT>(vd)[0] = acc;
+	orFcsrFlags(flags);
+	return;
+      }
 
-  updateAccruedFpBits();
-  std::fesetround(prevMode);
+    clearFpFlags();
+    int prevMode = setFpRoundingMode(mode);
+    const FT* a = vecRegs_.elems<FT>(vs2);
+    FT acc = vecRegs_.elems<FT>(vs1)[0];
+    acc = vecReduceKernel(a, acc, vl, mask, masked,
+			  [] (FT x, FT y) { return x + y; });
+    if (vl)
+      vecRegs_.elems<FT>(vd)[0] = acc;
+    updateAccruedFpBits();
+    restoreFpRoundingMode(prevMode);
+  };
+
+  if (sew == 32)
+    reduce(float(0), uint32_t(0));
+  else
+    reduce(double(0), uint64_t(0));
+
+  vecRegs_.setLastWrittenReg(vd, 1);
+  vstart_ = 0;
 }
 
 
 template <typename URV>
+template <typename ELEM_TYPE>
 void
-Core<URV>::execFmul_d(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::vecLoad(uint32_t vd, uint32_t rs1)
 {
-  if (not isRvd())
+  // Effective group size: EMUL = (EEW/SEW)*LMUL.
+  unsigned sew = 0, group = 1;
+  if (not isRvv() or not vecConfig(sew, group))
     {
       illegalInst();
       return;
     }
 
-  RoundingMode riscvMode = effectiveRoundingMode();
-  if (riscvMode >= RoundingMode::Invalid1)
+  unsigned vlmul = vtype_ & 7;
+  int lmulLog = vlmul < 4? int(vlmul) : int(vlmul) - 8;
+  int emulLog = (lmulLog + __builtin_ctz(sizeof(ELEM_TYPE)*8) -
+		 __builtin_ctz(sew));
+  unsigned emul = emulLog > 0? 1 << emulLog : 1;
+  if (emulLog < -3 or emulLog > 3 or (vd & (emul - 1)) != 0 or
+      (vecMasked_ and vd == 0))
     {
       illegalInst();
       return;
     }
 
-  feClearAllExceptions();
-  int prevMode = setSimulatorRoundingMode(riscvMode);
+  URV addr0 = intRegs_.read(rs1);
+  loadAddr_ = addr0;    // For reporting load addr in trace-mode.
+  loadAddrValid_ = true;  // For reporting load addr in trace-mode.
 
-  double d1 = fpRegs_.read(rs1);
-  double d2 = fpRegs_.read(rs2);
-  double res = d1 * d2;
-  fpRegs_.write(rd, res);
+  ELEM_TYPE* dest = vecRegs_.elems<ELEM_TYPE>(vd);
+  const uint8_t* mask = vecRegs_.maskBits();
+  if (vstart_ < vl_)
+    vecRegs_.setLastWrittenReg(vd, emul);
 
-  updateAccruedFpBits();
-  std::fesetround(prevMode);
+  if (loadQueueEnabled_)
+    removeFromLoadQueue(rs1);
+
+  bool hasTrig = hasActiveTrigger();
+
+  for (unsigned i = vstart_; i < vl_; ++i)
+    {
+      if (vecMasked_ and not vecElemActive(mask, i))
+	continue;
+
+      // On a trigger or an exception, resume at this element.
+      URV addr = addr0 + URV(i) * sizeof(ELEM_TYPE);
+      if (hasTrig and loadTriggerTripped(addr, sizeof(ELEM_TYPE)))
+	{
+	  vstart_ = i;
+	  return;
+	}
+
+      ELEM_TYPE val = 0;
+      if (not readLoadData(addr, val))
+	{
+	  vstart_ = i;
+	  return;
+	}
+      dest[i] = val;
+
+      // Vector destinations are not reverted by a load error: queue
+      // the access without a target register.
+      if (loadQueueEnabled_)
+	putInLoadQueue(sizeof(ELEM_TYPE), addr, RegX0, 0);
+    }
+
+  vstart_ = 0;
 }
 
 
 template <typename URV>
+template <typename ELEM_TYPE>
 void
-Core<URV>::execFdiv_d(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::vecStore(uint32_t vs3, uint32_t rs1)
 {
-  if (not isRvd())
+  unsigned sew = 0, group = 1;
+  if (not isRvv() or not vecConfig(sew, group))
     {
       illegalInst();
       return;
     }
 
-
-  RoundingMode riscvMode = effectiveRoundingMode();
-  if (riscvMode >= RoundingMode::Invalid1)
+  unsigned vlmul = vtype_ & 7;
+  int lmulLog = vlmul < 4? int(vlmul) : int(vlmul) - 8;
+  int emulLog = (lmulLog + __builtin_ctz(sizeof(ELEM_TYPE)*8) -
+		 __builtin_ctz(sew));
+  unsigned emul = emulLog > 0? 1 << emulLog : 1;
+  if (emulLog < -3 or emulLog > 3 or (vs3 & (emul - 1)) != 0)
     {
       illegalInst();
       return;
     }
 
-  feClearAllExceptions();
-  int prevMode = setSimulatorRoundingMode(riscvMode);
-
-  double d1 = fpRegs_.read(rs1);
-  double d2 = fpRegs_.read(rs2);
-  double res = d1 / d2;
-  fpRegs_.write(rd, res);
+  URV addr0 = intRegs_.read(rs1);
+  const ELEM_TYPE* data = vecRegs_.elems<ELEM_TYPE>(vs3);
+  const uint8_t* mask = vecRegs_.maskBits();
 
-  updateAccruedFpBits();
-  std::fesetround(prevMode);
-}
+  // Imprecise store exceptions (store queue) are not modeled for
+  // vector stores.
+  unsigned maxStoreQueueSize = maxStoreQueueSize_;
+  maxStoreQueueSize_ = 0;
 
+  ldStException_ = false;
+  try
+    {
+      for (unsigned i = vstart_; i < vl_; ++i)
+	{
+	  if (vecMasked_ and not vecElemActive(mask, i))
+	    continue;
 
-template <typename URV>
-void
-Core<URV>::execFsgnj_d(uint32_t rd, uint32_t rs1, int32_t rs2)
-{
-  if (not isRvd())
+	  URV addr = addr0 + URV(i) * sizeof(ELEM_TYPE);
+	  store<ELEM_TYPE>(addr, data[i]);
+	  if (ldStException_ or triggerTripped_)
+	    {
+	      vstart_ = i;  // Resume at faulting element.
+	      break;
+	    }
+	}
+    }
+  catch (...)
     {
-      illegalInst();
-      return;
+      maxStoreQueueSize_ = maxStoreQueueSize;  // Write to tohost.
+      throw;
     }
 
-  double d1 = fpRegs_.read(rs1);
-  double d2 = fpRegs_.read(rs2);
-  double res = copysign(d1, d2);  // Magnitude of rs1 and sign of rs2
-  fpRegs_.write(rd, res);
+  maxStoreQueueSize_ = maxStoreQueueSize;
+  if (not ldStException_ and not triggerTripped_)
+    vstart_ = 0;
 }
 
-
 template <typename URV>
 void
-Core<URV>::execFsgnjn_d(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execVsetvli(uint32_t rd, uint32_t rs1, int32_t vtypei)
 {
-  if (not isRvd())
+  if (not isRvv())
     {
       illegalInst();
       return;
     }
 
-  double d1 = fpRegs_.read(rs1);
-  double d2 = fpRegs_.read(rs2);
-  double res = copysign(d1, d2);  // Magnitude of rs1 and sign of rs2
-  res = -res;  // Magnitude of rs1 and negative the sign of rs2
-  fpRegs_.write(rd, res);
+  // If rs1 is x0: Use VLMAX for a non-x0 rd, otherwise keep vl.
+  bool useVlmax = rs1 == 0 and rd != 0;
+  bool keepVl = rs1 == 0 and rd == 0;
+  vecSetConfig(rd, intRegs_.read(rs1), vtypei & 0x7ff, useVlmax, keepVl);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execFsgnjx_d(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execVsetivli(uint32_t rd, uint32_t uimm, int32_t vtypei)
 {
-  if (not isRvd())
+  if (not isRvv())
     {
       illegalInst();
       return;
     }
 
-  double d1 = fpRegs_.read(rs1);
-  double d2 = fpRegs_.read(rs2);
-
-  int sign1 = (std::signbit(d1) == 0) ? 0 : 1;
-  int sign2 = (std::signbit(d2) == 0) ? 0 : 1;
-  int sign = sign1 ^ sign2;
-
-  double x = sign? -1 : 1;
-
-  double res = copysign(d1, x);  // Magnitude of rs1 and sign of x
-  fpRegs_.write(rd, res);
+  vecSetConfig(rd, uimm, vtypei & 0x3ff, false, false);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execFmin_d(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execVsetvl(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  if (not isRvd())
+  if (not isRvv())
     {
       illegalInst();
       return;
     }
 
-  double in1 = fpRegs_.read(rs1);
-  double in2 = fpRegs_.read(rs2);
-  double res = fmin(in1, in2);
-  fpRegs_.write(rd, res);
+  bool useVlmax = rs1 == 0 and rd != 0;
+  bool keepVl = rs1 == 0 and rd == 0;
+  vecSetConfig(rd, intRegs_.read(rs1), intRegs_.read(rs2), useVlmax, keepVl);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execFmax_d(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execVle8_v(uint32_t vd, uint32_t rs1, int32_t)
 {
-  if (not isRvd())
-    {
-      illegalInst();
-      return;
-    }
-
-  double in1 = fpRegs_.read(rs1);
-  double in2 = fpRegs_.read(rs2);
-  double res = fmax(in1, in2);
-  fpRegs_.write(rd, res);
+  vecLoad<uint8_t>(vd, rs1);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execFcvt_d_s(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execVle16_v(uint32_t vd, uint32_t rs1, int32_t)
 {
-  if (not isRvd())
-    {
-      illegalInst();
-      return;
-    }
+  vecLoad<uint16_t>(vd, rs1);
+}
 
-  RoundingMode riscvMode = effectiveRoundingMode();
-  if (riscvMode >= RoundingMode::Invalid1)
-    {
-      illegalInst();
-      return;
-    }
 
-  feClearAllExceptions();
-  int prevMode = setSimulatorRoundingMode(riscvMode);
+template <typename URV>
+void
+Core<URV>::execVle32_v(uint32_t vd, uint32_t rs1, int32_t)
+{
+  vecLoad<uint32_t>(vd, rs1);
+}
 
-  float f1 = fpRegs_.readSingle(rs1);
-  double result = f1;
-  fpRegs_.write(rd, result);
 
-  updateAccruedFpBits();
-  std::fesetround(prevMode);
+template <typename URV>
+void
+Core<URV>::execVle64_v(uint32_t vd, uint32_t rs1, int32_t)
+{
+  vecLoad<uint64_t>(vd, rs1);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execFcvt_s_d(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execVse8_v(uint32_t vs3, uint32_t rs1, int32_t)
 {
-  if (not isRvd())
-    {
-      illegalInst();
-      return;
-    }
+  vecStore<uint8_t>(vs3, rs1);
+}
 
-  RoundingMode riscvMode = effectiveRoundingMode();
-  if (riscvMode >= RoundingMode::Invalid1)
-    {
-      illegalInst();
-      return;
-    }
 
-  feClearAllExceptions();
-  int prevMode = setSimulatorRoundingMode(riscvMode);
+template <typename URV>
+void
+Core<URV>::execVse16_v(uint32_t vs3, uint32_t rs1, int32_t)
+{
+  vecStore<uint16_t>(vs3, rs1);
+}
 
-  double d1 = fpRegs_.read(rs1);
-  float result = d1;
-  fpRegs_.writeSingle(rd, result);
 
-  updateAccruedFpBits();
-  std::fesetround(prevMode);
+template <typename URV>
+void
+Core<URV>::execVse32_v(uint32_t vs3, uint32_t rs1, int32_t)
+{
+  vecStore<uint32_t>(vs3, rs1);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execFsqrt_d(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execVse64_v(uint32_t vs3, uint32_t rs1, int32_t)
 {
-  if (not isRvd())
-    {
-      illegalInst();
-      return;
-    }
+  vecStore<uint64_t>(vs3, rs1);
+}
 
-  RoundingMode riscvMode = effectiveRoundingMode();
-  if (riscvMode >= RoundingMode::Invalid1)
-    {
-      illegalInst();
-      return;
-    }
 
-  feClearAllExceptions();
-  int prevMode = setSimulatorRoundingMode(riscvMode);
+template <typename URV>
+void
+Core<URV>::execVadd_vv(uint32_t vd, uint32_t vs2, int32_t vs1)
+{
+  vecIntOp(vd, vs2, vs1, VecSrc::Vector,
+	   [] (auto x, auto y) { return x + y; });
+}
 
-  double d1 = fpRegs_.read(rs1);
-  double res = std::sqrt(d1);
-  fpRegs_.write(rd, res);
 
-  updateAccruedFpBits();
-  std::fesetround(prevMode);
+template <typename URV>
+void
+Core<URV>::execVadd_vx(uint32_t vd, uint32_t vs2, int32_t rs1)
+{
+  vecIntOp(vd, vs2, rs1, VecSrc::Int,
+	   [] (auto x, auto y) { return x + y; });
 }
 
 
 template <typename URV>
 void
-Core<URV>::execFle_d(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execVadd_vi(uint32_t vd, uint32_t vs2, int32_t imm)
 {
-  if (not isRvd())
-    {
-      illegalInst();
-      return;
-    }
-
-  double d1 = fpRegs_.read(rs1);
-  double d2 = fpRegs_.read(rs2);
+  vecIntOp(vd, vs2, imm, VecSrc::Imm,
+	   [] (auto x, auto y) { return x + y; });
+}
 
-  URV res = (d1 <= d2)? 1 : 0;
-  intRegs_.write(rd, res);
 
-  updateAccruedFpBits();
+template <typename URV>
+void
+Core<URV>::execVsub_vv(uint32_t vd, uint32_t vs2, int32_t vs1)
+{
+  vecIntOp(vd, vs2, vs1, VecSrc::Vector,
+	   [] (auto x, auto y) { return x - y; });
 }
 
 
 template <typename URV>
 void
-Core<URV>::execFlt_d(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execVsub_vx(uint32_t vd, uint32_t vs2, int32_t rs1)
 {
-  if (not isRvd())
-    {
-      illegalInst();
-      return;
-    }
+  vecIntOp(vd, vs2, rs1, VecSrc::Int,
+	   [] (auto x, auto y) { return x - y; });
+}
 
-  double d1 = fpRegs_.read(rs1);
-  double d2 = fpRegs_.read(rs2);
 
-  URV res = (d1 < d2)? 1 : 0;
-  intRegs_.write(rd, res);
+template <typename URV>
+void
+Core<URV>::execVrsub_vx(uint32_t vd, uint32_t vs2, int32_t rs1)
+{
+  vecIntOp(vd, vs2, rs1, VecSrc::Int,
+	   [] (auto x, auto y) { return y - x; });
+}
 
-  updateAccruedFpBits();
+
+template <typename URV>
+void
+Core<URV>::execVrsub_vi(uint32_t vd, uint32_t vs2, int32_t imm)
+{
+  vecIntOp(vd, vs2, imm, VecSrc::Imm,
+	   [] (auto x, auto y) { return y - x; });
 }
 
 
 template <typename URV>
 void
-Core<URV>::execFeq_d(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execVminu_vv(uint32_t vd, uint32_t vs2, int32_t vs1)
 {
-  if (not isRvd())
-    {
-      illegalInst();
-      return;
-    }
+  vecIntOp(vd, vs2, vs1, VecSrc::Vector,
+	   [] (auto x, auto y) { return x < y? x : y; });
+}
 
-  double d1 = fpRegs_.read(rs1);
-  double d2 = fpRegs_.read(rs2);
 
-  URV res = (d1 == d2)? 1 : 0;
-  intRegs_.write(rd, res);
+template <typename URV>
+void
+Core<URV>::execVminu_vx(uint32_t vd, uint32_t vs2, int32_t rs1)
+{
+  vecIntOp(vd, vs2, rs1, VecSrc::Int,
+	   [] (auto x, auto y) { return x < y? x : y; });
+}
 
-  updateAccruedFpBits();
+
+template <typename URV>
+void
+Core<URV>::execVmin_vv(uint32_t vd, uint32_t vs2, int32_t vs1)
+{
+  vecIntOp(vd, vs2, vs1, VecSrc::Vector,
+	   [] (auto x, auto y) {
+    typedef std::make_signed_t<decltype(x)> ST;
+    return ST(x) < ST(y)? x : y; });
 }
 
 
 template <typename URV>
 void
-Core<URV>::execFcvt_w_d(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execVmin_vx(uint32_t vd, uint32_t vs2, int32_t rs1)
 {
-  if (not isRvd())
-    {
-      illegalInst();
-      return;
-    }
+  vecIntOp(vd, vs2, rs1, VecSrc::Int,
+	   [] (auto x, auto y) {
+    typedef std::make_signed_t<decltype(x)> ST;
+    return ST(x) < ST(y)? x : y; });
+}
 
-  RoundingMode riscvMode = effectiveRoundingMode();
-  if (riscvMode >= RoundingMode::Invalid1)
-    {
-      illegalInst();
-      return;
-    }
 
-  feClearAllExceptions();
-  int prevMode = setSimulatorRoundingMode(riscvMode);
+template <typename URV>
+void
+Core<URV>::execVmaxu_vv(uint32_t vd, uint32_t vs2, int32_t vs1)
+{
+  vecIntOp(vd, vs2, vs1, VecSrc::Vector,
+	   [] (auto x, auto y) { return x > y? x : y; });
+}
 
-  double d1 = fpRegs_.read(rs1);
-  SRV result = int32_t(d1);
-  intRegs_.write(rd, result);
 
-  updateAccruedFpBits();
-  std::fesetround(prevMode);
+template <typename URV>
+void
+Core<URV>::execVmaxu_vx(uint32_t vd, uint32_t vs2, int32_t rs1)
+{
+  vecIntOp(vd, vs2, rs1, VecSrc::Int,
+	   [] (auto x, auto y) { return x > y? x : y; });
 }
 
 
 template <typename URV>
 void
-Core<URV>::execFcvt_wu_d(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execVmax_vv(uint32_t vd, uint32_t vs2, int32_t vs1)
 {
-  if (not isRvd())
-    {
-      illegalInst();
-      return;
-    }
+  vecIntOp(vd, vs2, vs1, VecSrc::Vector,
+	   [] (auto x, auto y) {
+    typedef std::make_signed_t<decltype(x)> ST;
+    return ST(x) > ST(y)? x : y; });
+}
 
-  RoundingMode riscvMode = effectiveRoundingMode();
-  if (riscvMode >= RoundingMode::Invalid1)
-    {
-      illegalInst();
-      return;
-    }
 
-  feClearAllExceptions();
-  int prevMode = setSimulatorRoundingMode(riscvMode);
+template <typename URV>
+void
+Core<URV>::execVmax_vx(uint32_t vd, uint32_t vs2, int32_t rs1)
+{
+  vecIntOp(vd, vs2, rs1, VecSrc::Int,
+	   [] (auto x, auto y) {
+    typedef std::make_signed_t<decltype(x)> ST;
+    return ST(x) > ST(y)? x : y; });
+}
 
-  double d1 = fpRegs_.read(rs1);
-  URV result = uint32_t(d1);
-  intRegs_.write(rd, result);
 
-  updateAccruedFpBits();
-  std::fesetround(prevMode);
+template <typename URV>
+void
+Core<URV>::execVand_vv(uint32_t vd, uint32_t vs2, int32_t vs1)
+{
+  vecIntOp(vd, vs2, vs1, VecSrc::Vector,
+	   [] (auto x, auto y) { return x & y; });
 }
 
 
 template <typename URV>
 void
-Core<URV>::execFcvt_d_w(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execVand_vx(uint32_t vd, uint32_t vs2, int32_t rs1)
 {
-  if (not isRvd())
-    {
-      illegalInst();
-      return;
-    }
+  vecIntOp(vd, vs2, rs1, VecSrc::Int,
+	   [] (auto x, auto y) { return x & y; });
+}
 
-  RoundingMode riscvMode = effectiveRoundingMode();
-  if (riscvMode >= RoundingMode::Invalid1)
-    {
-      illegalInst();
-      return;
-    }
 
-  feClearAllExceptions();
-  int prevMode = setSimulatorRoundingMode(riscvMode);
+template <typename URV>
+void
+Core<URV>::execVand_vi(uint32_t vd, uint32_t vs2, int32_t imm)
+{
+  vecIntOp(vd, vs2, imm, VecSrc::Imm,
+	   [] (auto x, auto y) { return x & y; });
+}
 
-  int32_t i1 = intRegs_.read(rs1);
-  double result = i1;
-  fpRegs_.write(rd, result);
 
-  updateAccruedFpBits();
-  std::fesetround(prevMode);
+template <typename URV>
+void
+Core<URV>::execVor_vv(uint32_t vd, uint32_t vs2, int32_t vs1)
+{
+  vecIntOp(vd, vs2, vs1, VecSrc::Vector,
+	   [] (auto x, auto y) { return x | y; });
 }
 
 
 template <typename URV>
 void
-Core<URV>::execFcvt_d_wu(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execVor_vx(uint32_t vd, uint32_t vs2, int32_t rs1)
 {
-  if (not isRvd())
-    {
-      illegalInst();
-      return;
-    }
+  vecIntOp(vd, vs2, rs1, VecSrc::Int,
+	   [] (auto x, auto y) { return x | y; });
+}
 
-  RoundingMode riscvMode = effectiveRoundingMode();
-  if (riscvMode >= RoundingMode::Invalid1)
-    {
-      illegalInst();
-      return;
-    }
 
-  feClearAllExceptions();
-  int prevMode = setSimulatorRoundingMode(riscvMode);
+template <typename URV>
+void
+Core<URV>::execVor_vi(uint32_t vd, uint32_t vs2, int32_t imm)
+{
+  vecIntOp(vd, vs2, imm, VecSrc::Imm,
+	   [] (auto x, auto y) { return x | y; });
+}
 
-  uint32_t i1 = intRegs_.read(rs1);
-  double result = i1;
-  fpRegs_.write(rd, result);
 
-  updateAccruedFpBits();
-  std::fesetround(prevMode);
+template <typename URV>
+void
+Core<URV>::execVxor_vv(uint32_t vd, uint32_t vs2, int32_t vs1)
+{
+  vecIntOp(vd, vs2, vs1, VecSrc::Vector,
+	   [] (auto x, auto y) { return x ^ y; });
 }
 
 
 template <typename URV>
 void
-Core<URV>::execFclass_d(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execVxor_vx(uint32_t vd, uint32_t vs2, int32_t rs1)
 {
-  if (not isRvd())
-    {
-      illegalInst();
-      return;
-    }
+  vecIntOp(vd, vs2, rs1, VecSrc::Int,
+	   [] (auto x, auto y) { return x ^ y; });
+}
 
-  double d1 = fpRegs_.read(rs1);
-  URV result = 0;
 
-  bool pos = not std::signbit(d1);
-  int type = std::fpclassify(d1);
+template <typename URV>
+void
+Core<URV>::execVxor_vi(uint32_t vd, uint32_t vs2, int32_t imm)
+{
+  vecIntOp(vd, vs2, imm, VecSrc::Imm,
+	   [] (auto x, auto y) { return x ^ y; });
+}
 
-  if (type == FP_INFINITE)
-    {
-      if (pos)
-	result |= URV(FpClassifyMasks::PosInfinity);
-      else
-	result |= URV(FpClassifyMasks::NegInfinity);
-    }
-  else if (type == FP_NORMAL)
-    {
-      if (pos)
-	result |= URV(FpClassifyMasks::PosNormal);
-      else
-	result |= URV(FpClassifyMasks::NegNormal);
-    }
-  else if (type == FP_SUBNORMAL)
-    {
-      if (pos)
-	result |= URV(FpClassifyMasks::PosSubnormal);
-      else
-	result |= URV(FpClassifyMasks::NegSubnormal);
-    }
-  else if (type == FP_ZERO)
-    {
-      if (pos)
-	result |= URV(FpClassifyMasks::PosZero);
-      else
-	result |= URV(FpClassifyMasks::NegZero);
-    }
-  else if(type == FP_NAN)
-    {
-      bool quiet = mostSignificantFractionBit(d1);
-      if (quiet)
-	result |= URV(FpClassifyMasks::QuietNan);
-      else
-	result |= URV(FpClassifyMasks::SignalingNan);
-    }
 
-  intRegs_.write(rd, result);
+template <typename URV>
+void
+Core<URV>::execVsll_vv(uint32_t vd, uint32_t vs2, int32_t vs1)
+{
+  vecIntOp(vd, vs2, vs1, VecSrc::Vector,
+	   [] (auto x, auto y) {
+    typedef decltype(x + 0u) WT;  // Avoid signed overflow of short types.
+    return WT(x) << (y & (8*sizeof(x) - 1)); });
+}
+
+
+template <typename URV>
+void
+Core<URV>::execVsll_vx(uint32_t vd, uint32_t vs2, int32_t rs1)
+{
+  vecIntOp(vd, vs2, rs1, VecSrc::Int,
+	   [] (auto x, auto y) {
+    typedef decltype(x + 0u) WT;  // Avoid signed overflow of short types.
+    return WT(x) << (y & (8*sizeof(x) - 1)); });
 }
 
 
 template <typename URV>
 void
-Core<URV>::execFcvt_l_d(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execVsll_vi(uint32_t vd, uint32_t vs2, int32_t imm)
 {
-  if (not isRv64() or not isRvd())
-    {
-      illegalInst();
-      return;
-    }
+  vecIntOp(vd, vs2, imm, VecSrc::Uimm,
+	   [] (auto x, auto y) {
+    typedef decltype(x + 0u) WT;  // Avoid signed overflow of short types.
+    return WT(x) << (y & (8*sizeof(x) - 1)); });
+}
 
-  RoundingMode riscvMode = effectiveRoundingMode();
-  if (riscvMode >= RoundingMode::Invalid1)
-    {
-      illegalInst();
-      return;
-    }
 
-  feClearAllExceptions();
-  int prevMode = setSimulatorRoundingMode(riscvMode);
+template <typename URV>
+void
+Core<URV>::execVsrl_vv(uint32_t vd, uint32_t vs2, int32_t vs1)
+{
+  vecIntOp(vd, vs2, vs1, VecSrc::Vector,
+	   [] (auto x, auto y) {
+    return x >> (y & (8*sizeof(x) - 1)); });
+}
 
-  double f1 = fpRegs_.read(rs1);
-  SRV result = int64_t(f1);
-  intRegs_.write(rd, result);
 
-  updateAccruedFpBits();
-  std::fesetround(prevMode);
+template <typename URV>
+void
+Core<URV>::execVsrl_vx(uint32_t vd, uint32_t vs2, int32_t rs1)
+{
+  vecIntOp(vd, vs2, rs1, VecSrc::Int,
+	   [] (auto x, auto y) {
+    return x >> (y & (8*sizeof(x) - 1)); });
 }
 
 
 template <typename URV>
 void
-Core<URV>::execFcvt_lu_d(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execVsrl_vi(uint32_t vd, uint32_t vs2, int32_t imm)
 {
-  if (not isRv64() or not isRvd())
-    {
-      illegalInst();
-      return;
-    }
+  vecIntOp(vd, vs2, imm, VecSrc::Uimm,
+	   [] (auto x, auto y) {
+    return x >> (y & (8*sizeof(x) - 1)); });
+}
 
-  RoundingMode riscvMode = effectiveRoundingMode();
-  if (riscvMode >= RoundingMode::Invalid1)
-    {
-      illegalInst();
-      return;
-    }
 
-  feClearAllExceptions();
-  int prevMode = setSimulatorRoundingMode(riscvMode);
+template <typename URV>
+void
+Core<URV>::execVsra_vv(uint32_t vd, uint32_t vs2, int32_t vs1)
+{
+  vecIntOp(vd, vs2, vs1, VecSrc::Vector,
+	   [] (auto x, auto y) {
+    typedef std::make_signed_t<decltype(x)> ST;
+    return ST(x) >> (y & (8*sizeof(x) - 1)); });
+}
 
-  double f1 = fpRegs_.read(rs1);
-  URV result = uint64_t(f1);
-  intRegs_.write(rd, result);
 
-  updateAccruedFpBits();
-  std::fesetround(prevMode);
+template <typename URV>
+void
+Core<URV>::execVsra_vx(uint32_t vd, uint32_t vs2, int32_t rs1)
+{
+  vecIntOp(vd, vs2, rs1, VecSrc::Int,
+	   [] (auto x, auto y) {
+    typedef std::make_signed_t<decltype(x)> ST;
+    return ST(x) >> (y & (8*sizeof(x) - 1)); });
 }
 
 
 template <typename URV>
 void
-Core<URV>::execFcvt_d_l(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execVsra_vi(uint32_t vd, uint32_t vs2, int32_t imm)
 {
-  if (not isRv64() or not isRvd())
-    {
-      illegalInst();
-      return;
-    }
+  vecIntOp(vd, vs2, imm, VecSrc::Uimm,
+	   [] (auto x, auto y) {
+    typedef std::make_signed_t<decltype(x)> ST;
+    return ST(x) >> (y & (8*sizeof(x) - 1)); });
+}
 
-  RoundingMode riscvMode = effectiveRoundingMode();
-  if (riscvMode >= RoundingMode::Invalid1)
-    {
-      illegalInst();
-      return;
-    }
 
-  feClearAllExceptions();
-  int prevMode = setSimulatorRoundingMode(riscvMode);
+template <typename URV>
+void
+Core<URV>::execVmul_vv(uint32_t vd, uint32_t vs2, int32_t vs1)
+{
+  vecIntOp(vd, vs2, vs1, VecSrc::Vector,
+	   [] (auto x, auto y) {
+    // Promote to unsigned to avoid signed overflow of short types.
+    typedef decltype(x + 0u) WT;
+    return WT(x) * WT(y); });
+}
 
-  int64_t i1 = intRegs_.read(rs1);
-  double result = i1;
-  fpRegs_.write(rd, result);
 
-  updateAccruedFpBits();
-  std::fesetround(prevMode);
+template <typename URV>
+void
+Core<URV>::execVmul_vx(uint32_t vd, uint32_t vs2, int32_t rs1)
+{
+  vecIntOp(vd, vs2, rs1, VecSrc::Int,
+	   [] (auto x, auto y) {
+    // Promote to unsigned to avoid signed overflow of short types.
+    typedef decltype(x + 0u) WT;
+    return WT(x) * WT(y); });
 }
 
 
 template <typename URV>
 void
-Core<URV>::execFcvt_d_lu(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execVmv_v_v(uint32_t vd, uint32_t vs1, int32_t)
 {
-  if (not isRv64() or not isRvd())
+  vecIntOp(vd, 0, vs1, VecSrc::Vector, [] (auto, auto y) { return y; });
+}
+
+
+template <typename URV>
+void
+Core<URV>::execVmv_v_x(uint32_t vd, uint32_t rs1, int32_t)
+{
+  vecIntOp(vd, 0, rs1, VecSrc::Int, [] (auto, auto y) { return y; });
+}
+
+
+template <typename URV>
+void
+Core<URV>::execVmv_v_i(uint32_t vd, uint32_t imm, int32_t)
+{
+  vecIntOp(vd, 0, imm, VecSrc::Imm, [] (auto, auto y) { return y; });
+}
+
+
+template <typename URV>
+void
+Core<URV>::execVmv_x_s(uint32_t rd, uint32_t vs2, int32_t)
+{
+  unsigned sew = 0, group = 1;
+  if (not isRvv() or not vecConfig(sew, group))
     {
       illegalInst();
       return;
     }
 
-  RoundingMode riscvMode = effectiveRoundingMode();
-  if (riscvMode >= RoundingMode::Invalid1)
+  // Element 0 sign extended (or truncated) to XLEN.
+  SRV val = 0;
+  switch (sew)
     {
-      illegalInst();
-      return;
+    case 8:  val = int8_t(vecRegs_.elems<uint8_t>(vs2)[0]);   break;
+    case 16: val = int16_t(vecRegs_.elems<uint16_t>(vs2)[0]); break;
+    case 32: val = int32_t(vecRegs_.elems<uint32_t>(vs2)[0]); break;
+    default: val = SRV(vecRegs_.elems<uint64_t>(vs2)[0]);     break;
     }
 
-  feClearAllExceptions();
-  int prevMode = setSimulatorRoundingMode(riscvMode);
-
-  uint64_t i1 = intRegs_.read(rs1);
-  double result = i1;
-  fpRegs_.write(rd, result);
-
-  updateAccruedFpBits();
-  std::fesetround(prevMode);
+  intRegs_.write(rd, val);
+  vstart_ = 0;
 }
 
 
 template <typename URV>
 void
-Core<URV>::execFmv_d_x(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execVmv_s_x(uint32_t vd, uint32_t rs1, int32_t)
 {
-  if (not isRv64() or not isRvd())
+  unsigned sew = 0, group = 1;
+  if (not isRvv() or not vecConfig(sew, group))
     {
       illegalInst();
       return;
     }
 
-  uint64_t u1 = intRegs_.read(rs1);
+  if (vstart_ < vl_)
+    {
+      URV val = intRegs_.read(rs1);
+      switch (sew)
+	{
+	case 8:  vecRegs_.elems<uint8_t>(vd)[0] = val;  break;
+	case 16: vecRegs_.elems<uint16_t>(vd)[0] = val; break;
+	case 32: vecRegs_.elems<uint32_t>(vd)[0] = val; break;
+	default: vecRegs_.elems<uint64_t>(vd)[0] = SRV(val); break;
+	}
+      vecRegs_.setLastWrittenReg(vd, 1);
+    }
+  vstart_ = 0;
+}
 
-  union UDU  // Unsigned double union: reinterpret bits as unsigned or double
-  {
-    uint64_t u;
-    double d;
-  };
 
-  UDU udu;
-  udu.u = u1;
+template <typename URV>
+void
+Core<URV>::execVredsum_vs(uint32_t vd, uint32_t vs2, int32_t vs1)
+{
+  vecIntReduce(vd, vs2, vs1,
+	       [] (auto x, auto y) { return x + y; });
+}
 
-  fpRegs_.write(rd, udu.d);
+
+template <typename URV>
+void
+Core<URV>::execVredand_vs(uint32_t vd, uint32_t vs2, int32_t vs1)
+{
+  vecIntReduce(vd, vs2, vs1,
+	       [] (auto x, auto y) { return x & y; });
 }
 
 
 template <typename URV>
 void
-Core<URV>::execFmv_x_d(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execVredor_vs(uint32_t vd, uint32_t vs2, int32_t vs1)
 {
-  if (not isRv64() or not isRvd())
-    {
-      illegalInst();
-      return;
-    }
+  vecIntReduce(vd, vs2, vs1,
+	       [] (auto x, auto y) { return x | y; });
+}
 
-  double d1 = fpRegs_.read(rs1);
 
-  union UDU  // Unsigned double union: reinterpret bits as unsigned or double
-  {
-    uint64_t u;
-    double d;
-  };
+template <typename URV>
+void
+Core<URV>::execVredxor_vs(uint32_t vd, uint32_t vs2, int32_t vs1)
+{
+  vecIntReduce(vd, vs2, vs1,
+	       [] (auto x, auto y) { return x ^ y; });
+}
 
-  UDU udu;
-  udu.d = d1;
 
-  intRegs_.write(rd, udu.u);
+template <typename URV>
+void
+Core<URV>::execVredminu_vs(uint32_t vd, uint32_t vs2, int32_t vs1)
+{
+  vecIntReduce(vd, vs2, vs1,
+	       [] (auto x, auto y) { return x < y? x : y; });
 }
 
 
 template <typename URV>
 void
-Core<URV>::execAmoadd_w(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execVredmin_vs(uint32_t vd, uint32_t vs2, int32_t vs1)
 {
-  URV rs2Val = intRegs_.read(rs2);
+  vecIntReduce(vd, vs2, vs1,
+	       [] (auto x, auto y) {
+    typedef std::make_signed_t<decltype(x)> ST;
+    return ST(x) < ST(y)? x : y; });
+}
 
-  execLw(rd, rs1, 0);
-  if (ldStException_)
-    return;
 
-  // Sign extend loaded word.
-  URV rdVal = intRegs_.read(rd);
-  int32_t x = rdVal;
-  rdVal = SRV(x);
+template <typename URV>
+void
+Core<URV>::execVredmaxu_vs(uint32_t vd, uint32_t vs2, int32_t vs1)
+{
+  vecIntReduce(vd, vs2, vs1,
+	       [] (auto x, auto y) { return x > y? x : y; });
+}
 
-  URV addr = intRegs_.read(rs1);
 
-  URV result = rs2Val + rdVal;
-  store<uint32_t>(addr, result);
+template <typename URV>
+void
+Core<URV>::execVredmax_vs(uint32_t vd, uint32_t vs2, int32_t vs1)
+{
+  vecIntReduce(vd, vs2, vs1,
+	       [] (auto x, auto y) {
+    typedef std::make_signed_t<decltype(x)> ST;
+    return ST(x) > ST(y)? x : y; });
+}
 
-  if (not ldStException_)
-    intRegs_.write(rd, rdVal);
+
+template <typename URV>
+void
+Core<URV>::execVfadd_vv(uint32_t vd, uint32_t vs2, int32_t vs1)
+{
+  vecFpOp(vd, vs2, vs1, VecSrc::Vector, VecFpOp::Add);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execAmoswap_w(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execVfadd_vf(uint32_t vd, uint32_t vs2, int32_t rs1)
 {
-  URV rs2Val = intRegs_.read(rs2);
+  vecFpOp(vd, vs2, rs1, VecSrc::Fp, VecFpOp::Add);
+}
 
-  execLw(rd, rs1, 0);
-  if (ldStException_)
-    return;
 
-  // Sign extend loaded word.
-  URV rdVal = intRegs_.read(rd);
-  int32_t x = rdVal;
-  rdVal = SRV(x);
+template <typename URV>
+void
+Core<URV>::execVfsub_vv(uint32_t vd, uint32_t vs2, int32_t vs1)
+{
+  vecFpOp(vd, vs2, vs1, VecSrc::Vector, VecFpOp::Sub);
+}
 
-  URV addr = intRegs_.read(rs1);
 
-  URV result = rs2Val;
-  store<uint32_t>(addr, result);
+template <typename URV>
+void
+Core<URV>::execVfsub_vf(uint32_t vd, uint32_t vs2, int32_t rs1)
+{
+  vecFpOp(vd, vs2, rs1, VecSrc::Fp, VecFpOp::Sub);
+}
 
-  if (not ldStException_)
-    intRegs_.write(rd, rdVal);
+
+template <typename URV>
+void
+Core<URV>::execVfrsub_vf(uint32_t vd, uint32_t vs2, int32_t rs1)
+{
+  vecFpOp(vd, vs2, rs1, VecSrc::Fp, VecFpOp::Rsub);
 }
 
 
 template <typename URV>
-template <typename LOAD_TYPE>
 void
-Core<URV>::loadReserve(uint32_t rd, uint32_t rs1)
+Core<URV>::execVfmul_vv(uint32_t vd, uint32_t vs2, int32_t vs1)
 {
-  URV addr = intRegs_.read(rs1);
+  vecFpOp(vd, vs2, vs1, VecSrc::Vector, VecFpOp::Mul);
+}
 
-  loadAddr_ = addr;    // For reporting load addr in trace-mode.
-  loadAddrValid_ = true;  // For reporting load addr in trace-mode.
 
-  if (loadQueueEnabled_)
-    removeFromLoadQueue(rs1);
+template <typename URV>
+void
+Core<URV>::execVfmul_vf(uint32_t vd, uint32_t vs2, int32_t rs1)
+{
+  vecFpOp(vd, vs2, rs1, VecSrc::Fp, VecFpOp::Mul);
+}
 
-  if (hasActiveTrigger())
-    {
-      typedef TriggerTiming Timing;
 
-      bool isLoad = true;
-      if (ldStAddrTriggerHit(addr, Timing::Before, isLoad, isInterruptEnabled()))
-	triggerTripped_ = true;
-      if (triggerTripped_)
-	return;
-    }
+template <typename URV>
+void
+Core<URV>::execVfdiv_vv(uint32_t vd, uint32_t vs2, int32_t vs1)
+{
+  vecFpOp(vd, vs2, vs1, VecSrc::Vector, VecFpOp::Div);
+}
 
-  // Unsigned version of LOAD_TYPE
-  typedef typename std::make_unsigned<LOAD_TYPE>::type ULT;
 
-  // Misaligned load triggers an exception.
-  constexpr unsigned alignMask = sizeof(LOAD_TYPE) - 1;
-  bool misaligned = addr & alignMask;
-  misalignedLdSt_ = misaligned;
-  if (misaligned)
-    {
-      // We get a load finished for loads with exception. Compensate.
-      if (loadQueueEnabled_ and not forceAccessFail_)
-	putInLoadQueue(sizeof(LOAD_TYPE), addr, 0, 0);
-      forceAccessFail_ = false;
-      ldStException_ = true;
-      initiateException(ExceptionCause::LOAD_ADDR_MISAL, currPc_, addr);
-      return;
-    }
+template <typename URV>
+void
+Core<URV>::execVfdiv_vf(uint32_t vd, uint32_t vs2, int32_t rs1)
+{
+  vecFpOp(vd, vs2, rs1, VecSrc::Fp, VecFpOp::Div);
+}
+
 
-  ULT uval = 0;
-  if (not forceAccessFail_ and memory_.read(addr, uval))
-    {
-      URV value;
-      if constexpr (std::is_same<ULT, LOAD_TYPE>::value)
-        value = uval;
-      else
-        value = SRV(LOAD_TYPE(uval)); // Sign extend.
+template <typename URV>
+void
+Core<URV>::execVfrdiv_vf(uint32_t vd, uint32_t vs2, int32_t rs1)
+{
+  vecFpOp(vd, vs2, rs1, VecSrc::Fp, VecFpOp::Rdiv);
+}
 
-      if (loadQueueEnabled_)
-	{
-	  URV prev = 0;
-	  peekIntReg(rd, prev);
-	  putInLoadQueue(sizeof(LOAD_TYPE), addr, rd, prev);
-	}
 
-      intRegs_.write(rd, value);
-    }
-  else
-    {
-      // We get a load finished for loads with exception. Compensate.
-      if (loadQueueEnabled_ and not forceAccessFail_)
-	putInLoadQueue(sizeof(LOAD_TYPE), addr, 0, 0);
-      forceAccessFail_ = false;
-      ldStException_ = true;
-      initiateException(ExceptionCause::LOAD_ACC_FAULT, currPc_, addr);
-    }
+template <typename URV>
+void
+Core<URV>::execVfmacc_vv(uint32_t vd, uint32_t vs2, int32_t vs1)
+{
+  vecFpOp(vd, vs2, vs1, VecSrc::Vector, VecFpOp::Macc);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execLr_w(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execVfmacc_vf(uint32_t vd, uint32_t vs2, int32_t rs1)
 {
-  loadReserve<int32_t>(rd, rs1);
-  if (ldStException_ or triggerTripped_)
-    return;
+  vecFpOp(vd, vs2, rs1, VecSrc::Fp, VecFpOp::Macc);
+}
 
-  hasLr_ = true;
-  lrAddr_ = loadAddr_;
+
+template <typename URV>
+void
+Core<URV>::execVfredusum_vs(uint32_t vd, uint32_t vs2, int32_t vs1)
+{
+  vecFpReduceSum(vd, vs2, vs1);
 }
 
 
-/// STORE_TYPE is either uint32_t or uint64_t.
 template <typename URV>
-template <typename STORE_TYPE>
-bool
-Core<URV>::storeConditional(URV addr, STORE_TYPE storeVal)
+void
+Core<URV>::execVfredosum_vs(uint32_t vd, uint32_t vs2, int32_t vs1)
 {
-  // ld/st-address or instruction-address triggers have priority over
-  // ld/st access or misaligned exceptions.
-  bool hasTrig = hasActiveTrigger();
-  TriggerTiming timing = TriggerTiming::Before;
-  bool isLoad = false;
-  if (hasTrig)
-    if (ldStAddrTriggerHit(addr, timing, isLoad, isInterruptEnabled()))
-      triggerTripped_ = true;
+  vecFpReduceSum(vd, vs2, vs1);
+}
 
-  // Misaligned store causes an exception.
-  constexpr unsigned alignMask = sizeof(STORE_TYPE) - 1;
-  bool misaligned = addr & alignMask;
-  misalignedLdSt_ = misaligned;
-  if (misaligned)
-    {
-      if (triggerTripped_)
-	return false; // No exception if earlier trig. Suppress store data trig.
-      forceAccessFail_ = false;
-      ldStException_ = true;
-      initiateException(ExceptionCause::STORE_ADDR_MISAL, currPc_, addr);
-      return false;
-    }
 
-  if (hasTrig and not forceAccessFail_ and memory_.checkWrite(addr, storeVal))
+template <typename URV>
+void
+Core<URV>::execVfmv_f_s(uint32_t rd, uint32_t vs2, int32_t)
+{
+  unsigned sew = 0, group = 1;
+  if (not isRvv() or not vecConfig(sew, group) or
+      (not (sew == 32 and isRvf()) and not (sew == 64 and isRvd())))
     {
-      // No exception: consider store-data  trigger
-      if (ldStDataTriggerHit(storeVal, timing, isLoad, isInterruptEnabled()))
-	triggerTripped_ = true;
+      illegalInst();
+      return;
     }
-  if (triggerTripped_)
-    return false;
 
-  if (not hasLr_ or addr != lrAddr_)
-    return false;
+  if (sew == 32)
+    fpRegs_.writeSingleBits(rd, vecRegs_.elems<uint32_t>(vs2)[0]);
+  else
+    fpRegs_.writeDoubleBits(rd, vecRegs_.elems<uint64_t>(vs2)[0]);
+  vstart_ = 0;
+}
 
-  if (not forceAccessFail_ and memory_.write(addr, storeVal))
-    {
-      // If we write to special location, end the simulation.
-      if (toHostValid_ and addr == toHost_ and storeVal != 0)
-	{
-	  throw CoreException(CoreException::Stop, "write to to-host",
-			      toHost_, storeVal);
-	}
 
-      if (maxStoreQueueSize_)
-	{
-	  uint64_t prevVal = 0;
-	  memory_.getLastWriteOldValue(prevVal);
-	  putInStoreQueue(sizeof(STORE_TYPE), addr, storeVal, prevVal);
-	}
-      return true;
-    }
-  else
+template <typename URV>
+void
+Core<URV>::execVfmv_s_f(uint32_t vd, uint32_t rs1, int32_t)
+{
+  unsigned sew = 0, group = 1;
+  if (not isRvv() or not vecConfig(sew, group) or
+      (not (sew == 32 and isRvf()) and not (sew == 64 and isRvd())))
     {
-      forceAccessFail_ = false;
-      ldStException_ = true;
-      initiateException(ExceptionCause::STORE_ACC_FAULT, currPc_, addr);
+      illegalInst();
+      return;
     }
 
-  return false;
+  if (vstart_ < vl_)
+    {
+      if (sew == 32)
+	vecRegs_.elems<uint32_t>(vd)[0] = fpRegs_.readSingleBits(rs1);
+      else
+	vecRegs_.elems<uint64_t>(vd)[0] = fpRegs_.readDoubleBits(rs1);
+      vecRegs_.setLastWrittenReg(vd, 1);
+    }
+  vstart_ = 0;
 }
 
 
 template <typename URV>
 void
-Core<URV>::execSc_w(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execVfmv_v_f(uint32_t vd, uint32_t rs1, int32_t)
 {
-  URV value = intRegs_.read(rs2);
-  URV addr = intRegs_.read(rs1);
+  unsigned sew = 0;
+  if (not checkVecOperands(vd, 0, 0, sew))
+    return;
 
-  if (storeConditional(addr, uint32_t(value)))
+  if (not (sew == 32 and isRvf()) and not (sew == 64 and isRvd()))
     {
-      intRegs_.write(rd, 0); // success
+      illegalInst();
       return;
     }
 
-  if (ldStException_ or triggerTripped_)
-    return;
+  auto splat = [] (auto, auto, auto y) { return y; };
+  const uint8_t* mask = vecRegs_.maskBits();
+  if (sew == 32)
+    vecKernel(vecRegs_.elems<uint32_t>(vd), vecRegs_.elems<uint32_t>(vd),
+	      (const uint32_t*) nullptr, fpRegs_.readSingleBits(rs1),
+	      vstart_, vl_, mask, false, splat);
+  else
+    vecKernel(vecRegs_.elems<uint64_t>(vd), vecRegs_.elems<uint64_t>(vd),
+	      (const uint64_t*) nullptr, fpRegs_.readDoubleBits(rs1),
+	      vstart_, vl_, mask, false, splat);
 
-  intRegs_.write(rd, 1);  // fail
+  vecCommit(vd);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execAmoxor_w(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execSh1add(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  URV rs2Val = intRegs_.read(rs2);
+  URV v = (intRegs_.read(rs1) << 1) + intRegs_.read(rs2);
+  intRegs_.write(rd, v);
+}
 
-  execLw(rd, rs1, 0);
-  if (ldStException_)
-    return;
 
-  // Sign extend loaded word.
-  URV rdVal = intRegs_.read(rd);
-  int32_t x = rdVal;
-  rdVal = SRV(x);
+template <typename URV>
+void
+Core<URV>::execSh2add(uint32_t rd, uint32_t rs1, int32_t rs2)
+{
+  URV v = (intRegs_.read(rs1) << 2) + intRegs_.read(rs2);
+  intRegs_.write(rd, v);
+}
 
-  URV addr = intRegs_.read(rs1);
 
-  URV result = rs2Val ^ rdVal;
-  store<uint32_t>(addr, result);
+template <typename URV>
+void
+Core<URV>::execSh3add(uint32_t rd, uint32_t rs1, int32_t rs2)
+{
+  URV v = (intRegs_.read(rs1) << 3) + intRegs_.read(rs2);
+  intRegs_.write(rd, v);
+}
 
-  if (not ldStException_)
-    intRegs_.write(rd, rdVal);
+
+template <typename URV>
+void
+Core<URV>::execAdd_uw(uint32_t rd, uint32_t rs1, int32_t rs2)
+{
+  URV v = URV(uint32_t(intRegs_.read(rs1))) + intRegs_.read(rs2);
+  intRegs_.write(rd, v);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execAmoor_w(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execSh1add_uw(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  URV rs2Val = intRegs_.read(rs2);
+  URV v = (URV(uint32_t(intRegs_.read(rs1))) << 1) + intRegs_.read(rs2);
+  intRegs_.write(rd, v);
+}
 
-  execLw(rd, rs1, 0);
-  if (ldStException_)
-    return;
 
-  // Sign extend loaded word.
-  URV rdVal = intRegs_.read(rd);
-  int32_t x = rdVal;
-  rdVal = SRV(x);
+template <typename URV>
+void
+Core<URV>::execSh2add_uw(uint32_t rd, uint32_t rs1, int32_t rs2)
+{
+  URV v = (URV(uint32_t(intRegs_.read(rs1))) << 2) + intRegs_.read(rs2);
+  intRegs_.write(rd, v);
+}
 
-  URV addr = intRegs_.read(rs1);
 
-  URV result = rs2Val | rdVal;
-  store<uint32_t>(addr, result);
+template <typename URV>
+void
+Core<URV>::execSh3add_uw(uint32_t rd, uint32_t rs1, int32_t rs2)
+{
+  URV v = (URV(uint32_t(intRegs_.read(rs1))) << 3) + intRegs_.read(rs2);
+  intRegs_.write(rd, v);
+}
 
-  if (not ldStException_)
-    intRegs_.write(rd, rdVal);
+
+template <typename URV>
+void
+Core<URV>::execSlli_uw(uint32_t rd, uint32_t rs1, int32_t amount)
+{
+  URV v = URV(uint32_t(intRegs_.read(rs1))) << amount;
+  intRegs_.write(rd, v);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execAmomin_w(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execAndn(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  URV rs2Val = intRegs_.read(rs2);
+  URV v = intRegs_.read(rs1) & ~intRegs_.read(rs2);
+  intRegs_.write(rd, v);
+}
 
-  execLw(rd, rs1, 0);
-  if (ldStException_)
-    return;
 
-  // Sign extend loaded word.
-  URV rdVal = intRegs_.read(rd);
-  int32_t x = rdVal;
-  rdVal = SRV(x);
+template <typename URV>
+void
+Core<URV>::execOrn(uint32_t rd, uint32_t rs1, int32_t rs2)
+{
+  URV v = intRegs_.read(rs1) | ~intRegs_.read(rs2);
+  intRegs_.write(rd, v);
+}
 
-  URV addr = intRegs_.read(rs1);
 
-  URV result = (SRV(rs2Val) < SRV(rdVal))? rs2Val : rdVal;
-  store<uint32_t>(addr, result);
+template <typename URV>
+void
+Core<URV>::execXnor(uint32_t rd, uint32_t rs1, int32_t rs2)
+{
+  URV v = ~(intRegs_.read(rs1) ^ intRegs_.read(rs2));
+  intRegs_.write(rd, v);
+}
 
-  if (not ldStException_)
-    intRegs_.write(rd, rdVal);
+
+/// Return the number of leading zero bits in x: Host instruction
+/// (lzcnt/bsr) through the compiler builtin. The builtin is undefined
+/// for zero.
+template <typename T>
+static inline
+unsigned
+countLeadingZeros(T x)
+{
+  if (x == 0)
+    return 8*sizeof(T);
+  if constexpr (sizeof(T) == 4)
+    return __builtin_clz(x);
+  else
+    return __builtin_clzll(x);
+}
+
+
+/// Return the number of trailing zero bits in x.
+template <typename T>
+static inline
+unsigned
+countTrailingZeros(T x)
+{
+  if (x == 0)
+    return 8*sizeof(T);
+  if constexpr (sizeof(T) == 4)
+    return __builtin_ctz(x);
+  else
+    return __builtin_ctzll(x);
+}
+
+
+/// Return the number of set bits in x.
+template <typename T>
+static inline
+unsigned
+countOnes(T x)
+{
+  if constexpr (sizeof(T) == 4)
+    return __builtin_popcount(x);
+  else
+    return __builtin_popcountll(x);
+}
+
+
+/// Rotate x left by the given amount (modulo the width of T). The
+/// compiler turns this into a host rotate instruction.
+template <typename T>
+static inline
+T
+rotateLeft(T x, unsigned amount)
+{
+  constexpr unsigned mask = 8*sizeof(T) - 1;
+  amount &= mask;
+  return (x << amount) | (x >> ((-amount) & mask));
 }
 
 
 template <typename URV>
 void
-Core<URV>::execAmominu_w(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execClz(uint32_t rd, uint32_t rs1, int32_t)
 {
-  URV rs2Val = intRegs_.read(rs2);
-
-  execLw(rd, rs1, 0);
-  if (ldStException_)
-    return;
+  URV v = countLeadingZeros(intRegs_.read(rs1));
+  intRegs_.write(rd, v);
+}
 
-  // Sign extend loaded word.
-  URV rdVal = intRegs_.read(rd);
-  int32_t x = rdVal;
-  rdVal = SRV(x);
 
-  URV addr = intRegs_.read(rs1);
+template <typename URV>
+void
+Core<URV>::execCtz(uint32_t rd, uint32_t rs1, int32_t)
+{
+  URV v = countTrailingZeros(intRegs_.read(rs1));
+  intRegs_.write(rd, v);
+}
 
-  URV result = (rs2Val < rdVal)? rs2Val : rdVal;
-  store<uint32_t>(addr, result);
 
-  if (not ldStException_)
-    intRegs_.write(rd, rdVal);
+template <typename URV>
+void
+Core<URV>::execCpop(uint32_t rd, uint32_t rs1, int32_t)
+{
+  URV v = countOnes(intRegs_.read(rs1));
+  intRegs_.write(rd, v);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execAmomax_w(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execClzw(uint32_t rd, uint32_t rs1, int32_t)
 {
-  URV rs2Val = intRegs_.read(rs2);
-
-  execLw(rd, rs1, 0);
-  if (ldStException_)
-    return;
+  URV v = countLeadingZeros(uint32_t(intRegs_.read(rs1)));
+  intRegs_.write(rd, v);
+}
 
-  // Sign extend loaded word.
-  URV rdVal = intRegs_.read(rd);
-  int32_t x = rdVal;
-  rdVal = SRV(x);
 
-  URV addr = intRegs_.read(rs1);
+template <typename URV>
+void
+Core<URV>::execCtzw(uint32_t rd, uint32_t rs1, int32_t)
+{
+  URV v = countTrailingZeros(uint32_t(intRegs_.read(rs1)));
+  intRegs_.write(rd, v);
+}
 
-  URV result = (SRV(rs2Val) > SRV(rdVal))? rs2Val : rdVal;
-  store<uint32_t>(addr, result);
 
-  if (not ldStException_)
-    intRegs_.write(rd, rdVal);
+template <typename URV>
+void
+Core<URV>::execCpopw(uint32_t rd, uint32_t rs1, int32_t)
+{
+  URV v = countOnes(uint32_t(intRegs_.read(rs1)));
+  intRegs_.write(rd, v);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execAmomaxu_w(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execMax(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  URV rs2Val = intRegs_.read(rs2);
-
-  execLw(rd, rs1, 0);
-  if (ldStException_)
-    return;
+  SRV v1 = intRegs_.read(rs1), v2 = intRegs_.read(rs2);
+  intRegs_.write(rd, v1 > v2 ? v1 : v2);
+}
 
-  // Sign extend loaded word.
-  URV rdVal = intRegs_.read(rd);
-  int32_t x = rdVal;
-  rdVal = SRV(x);
 
-  URV addr = intRegs_.read(rs1);
+template <typename URV>
+void
+Core<URV>::execMaxu(uint32_t rd, uint32_t rs1, int32_t rs2)
+{
+  URV v1 = intRegs_.read(rs1), v2 = intRegs_.read(rs2);
+  intRegs_.write(rd, v1 > v2 ? v1 : v2);
+}
 
-  URV result = (rs2Val > rdVal)? rs2Val : rdVal;
-  store<uint32_t>(addr, result);
 
-  if (not ldStException_)
-    intRegs_.write(rd, rdVal);
+template <typename URV>
+void
+Core<URV>::execMin(uint32_t rd, uint32_t rs1, int32_t rs2)
+{
+  SRV v1 = intRegs_.read(rs1), v2 = intRegs_.read(rs2);
+  intRegs_.write(rd, v1 < v2 ? v1 : v2);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execAmoadd_d(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execMinu(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  URV rs2Val = intRegs_.read(rs2);
-
-  execLw(rd, rs1, 0);
-  if (ldStException_)
-    return;
+  URV v1 = intRegs_.read(rs1), v2 = intRegs_.read(rs2);
+  intRegs_.write(rd, v1 < v2 ? v1 : v2);
+}
 
-  URV rdVal = intRegs_.read(rd);
 
-  URV addr = intRegs_.read(rs1);
+template <typename URV>
+void
+Core<URV>::execSext_b(uint32_t rd, uint32_t rs1, int32_t)
+{
+  SRV v = int8_t(intRegs_.read(rs1));
+  intRegs_.write(rd, v);
+}
 
-  URV result = rs2Val + rdVal;
-  store<URV>(addr, result);
 
-  if (not ldStException_)
-    intRegs_.write(rd, rdVal);
+template <typename URV>
+void
+Core<URV>::execSext_h(uint32_t rd, uint32_t rs1, int32_t)
+{
+  SRV v = int16_t(intRegs_.read(rs1));
+  intRegs_.write(rd, v);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execAmoswap_d(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execZext_h(uint32_t rd, uint32_t rs1, int32_t)
 {
-  URV rs2Val = intRegs_.read(rs2);
-
-  execLd(rd, rs1, 0);
-  if (ldStException_)
-    return;
+  URV v = uint16_t(intRegs_.read(rs1));
+  intRegs_.write(rd, v);
+}
 
-  URV rdVal = intRegs_.read(rd);
 
-  URV addr = intRegs_.read(rs1);
+template <typename URV>
+void
+Core<URV>::execZext_h_64(uint32_t rd, uint32_t rs1, int32_t rs2)
+{
+  execZext_h(rd, rs1, rs2);
+}
 
-  URV result = rs2Val;
-  store<URV>(addr, result);
 
-  if (not ldStException_)
-    intRegs_.write(rd, rdVal);
+template <typename URV>
+void
+Core<URV>::execRol(uint32_t rd, uint32_t rs1, int32_t rs2)
+{
+  URV v = rotateLeft(intRegs_.read(rs1), intRegs_.read(rs2));
+  intRegs_.write(rd, v);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execLr_d(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execRor(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  loadReserve<int64_t>(rd, rs1);
-  if (ldStException_ or triggerTripped_)
-    return;
-
-  hasLr_ = true;
-  lrAddr_ = loadAddr_;
+  URV v = rotateLeft(intRegs_.read(rs1), -unsigned(intRegs_.read(rs2)));
+  intRegs_.write(rd, v);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execSc_d(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execRori(uint32_t rd, uint32_t rs1, int32_t amount)
 {
-  URV value = intRegs_.read(rs2);
-  URV addr = intRegs_.read(rs1);
-
-  if (storeConditional(addr, uint64_t(value)))
+  if ((amount & 0x20) and not rv64_)
     {
-      intRegs_.write(rd, 0); // success
+      illegalInst();  // Bit 5 of shift amount cannot be zero in 32-bit.
       return;
     }
 
-  if (ldStException_ or triggerTripped_)
-    return;
-
-  intRegs_.write(rd, 1);  // fail
+  URV v = rotateLeft(intRegs_.read(rs1), -unsigned(amount));
+  intRegs_.write(rd, v);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execAmoxor_d(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execRolw(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  URV rs2Val = intRegs_.read(rs2);
-
-  execLd(rd, rs1, 0);
-  if (ldStException_)
-    return;
-
-  URV rdVal = intRegs_.read(rd);
-
-  URV addr = intRegs_.read(rs1);
+  int32_t word = rotateLeft(uint32_t(intRegs_.read(rs1)),
+			    unsigned(intRegs_.read(rs2)));
+  SRV v = word;  // Sign extend to 64-bits.
+  intRegs_.write(rd, v);
+}
 
-  URV result = rs2Val ^ rdVal;
-  store<URV>(addr, result);
 
-  if (not ldStException_)
-    intRegs_.write(rd, rdVal);
+template <typename URV>
+void
+Core<URV>::execRorw(uint32_t rd, uint32_t rs1, int32_t rs2)
+{
+  int32_t word = rotateLeft(uint32_t(intRegs_.read(rs1)),
+			    -unsigned(intRegs_.read(rs2)));
+  SRV v = word;  // Sign extend to 64-bits.
+  intRegs_.write(rd, v);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execAmoor_d(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execRoriw(uint32_t rd, uint32_t rs1, int32_t amount)
 {
-  URV rs2Val = intRegs_.read(rs2);
-
-  execLd(rd, rs1, 0);
-  if (ldStException_)
-    return;
+  int32_t word = rotateLeft(uint32_t(intRegs_.read(rs1)), -unsigned(amount));
+  SRV v = word;  // Sign extend to 64-bits.
+  intRegs_.write(rd, v);
+}
 
-  URV rdVal = intRegs_.read(rd);
 
-  URV addr = intRegs_.read(rs1);
+template <typename URV>
+void
+Core<URV>::execOrc_b(uint32_t rd, uint32_t rs1, int32_t)
+{
+  // Branch-free: Set the most significant bit of each zero byte of x
+  // in t (the classic zero-byte test), then spread each such bit over
+  // its byte and complement.
+  URV x = intRegs_.read(rs1);
+  URV low7 = ~URV(0) / 0xff * 0x7f;  // 0x7f in each byte.
+  URV t = ~(((x & low7) + low7) | x | low7);
+  URV v = ~((t >> 7) * 0xff);
+  intRegs_.write(rd, v);
+}
 
-  URV result = rs2Val | rdVal;
-  store<URV>(addr, result);
 
-  if (not ldStException_)
-    intRegs_.write(rd, rdVal);
+template <typename URV>
+void
+Core<URV>::execRev8(uint32_t rd, uint32_t rs1, int32_t)
+{
+  URV x = intRegs_.read(rs1), v = 0;
+  if constexpr (sizeof(URV) == 4)
+    v = __builtin_bswap32(x);
+  else
+    v = __builtin_bswap64(x);
+  intRegs_.write(rd, v);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execAmomin_d(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execRev8_64(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  URV rs2Val = intRegs_.read(rs2);
+  execRev8(rd, rs1, rs2);
+}
 
-  execLd(rd, rs1, 0);
-  if (ldStException_)
-    return;
 
-  URV rdVal = intRegs_.read(rd);
+template <typename URV>
+void
+Core<URV>::execBclr(uint32_t rd, uint32_t rs1, int32_t rs2)
+{
+  unsigned bit = intRegs_.read(rs2) & (8*sizeof(URV) - 1);
+  URV v = intRegs_.read(rs1) & ~(URV(1) << bit);
+  intRegs_.write(rd, v);
+}
 
-  URV addr = intRegs_.read(rs1);
 
-  URV result = (SRV(rs2Val) < SRV(rdVal))? rs2Val : rdVal;
-  store<URV>(addr, result);
+template <typename URV>
+void
+Core<URV>::execBclri(uint32_t rd, uint32_t rs1, int32_t amount)
+{
+  if ((amount & 0x20) and not rv64_)
+    {
+      illegalInst();  // Bit 5 of bit index cannot be one in 32-bit.
+      return;
+    }
 
-  if (not ldStException_)
-    intRegs_.write(rd, rdVal);
+  URV v = intRegs_.read(rs1) & ~(URV(1) << amount);
+  intRegs_.write(rd, v);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execAmominu_d(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execBext(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  URV rs2Val = intRegs_.read(rs2);
-
-  execLd(rd, rs1, 0);
-  if (ldStException_)
-    return;
-
-  // Sign extend loaded word.
-  URV rdVal = intRegs_.read(rd);
+  unsigned bit = intRegs_.read(rs2) & (8*sizeof(URV) - 1);
+  URV v = (intRegs_.read(rs1) >> bit) & 1;
+  intRegs_.write(rd, v);
+}
 
-  URV addr = intRegs_.read(rs1);
 
-  URV result = (rs2Val < rdVal)? rs2Val : rdVal;
-  store<URV>(addr, result);
+template <typename URV>
+void
+Core<URV>::execBexti(uint32_t rd, uint32_t rs1, int32_t amount)
+{
+  if ((amount & 0x20) and not rv64_)
+    {
+      illegalInst();  // Bit 5 of bit index cannot be one in 32-bit.
+      return;
+    }
 
-  if (not ldStException_)
-    intRegs_.write(rd, rdVal);
+  URV v = (intRegs_.read(rs1) >> amount) & 1;
+  intRegs_.write(rd, v);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execAmomax_d(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execBinv(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  URV rs2Val = intRegs_.read(rs2);
-
-  execLd(rd, rs1, 0);
-  if (ldStException_)
-    return;
-
-  // Sign extend loaded word.
-  URV rdVal = intRegs_.read(rd);
+  unsigned bit = intRegs_.read(rs2) & (8*sizeof(URV) - 1);
+  URV v = intRegs_.read(rs1) ^ (URV(1) << bit);
+  intRegs_.write(rd, v);
+}
 
-  URV addr = intRegs_.read(rs1);
 
-  URV result = (SRV(rs2Val) > SRV(rdVal))? rs2Val : rdVal;
-  store<URV>(addr, result);
+template <typename URV>
+void
+Core<URV>::execBinvi(uint32_t rd, uint32_t rs1, int32_t amount)
+{
+  if ((amount & 0x20) and not rv64_)
+    {
+      illegalInst();  // Bit 5 of bit index cannot be one in 32-bit.
+      return;
+    }
 
-  if (not ldStException_)
-    intRegs_.write(rd, rdVal);
+  URV v = intRegs_.read(rs1) ^ (URV(1) << amount);
+  intRegs_.write(rd, v);
 }
 
 
 template <typename URV>
 void
-Core<URV>::execAmomaxu_d(uint32_t rd, uint32_t rs1, int32_t rs2)
+Core<URV>::execBset(uint32_t rd, uint32_t rs1, int32_t rs2)
 {
-  URV rs2Val = intRegs_.read(rs2);
-
-  execLd(rd, rs1, 0);
-  if (ldStException_)
-    return;
-
-  // Sign extend loaded word.
-  URV rdVal = intRegs_.read(rd);
+  unsigned bit = intRegs_.read(rs2) & (8*sizeof(URV) - 1);
+  URV v = intRegs_.read(rs1) | (URV(1) << bit);
+  intRegs_.write(rd, v);
+}
 
-  URV addr = intRegs_.read(rs1);
 
-  URV result = (rs2Val > rdVal)? rs2Val : rdVal;
-  store<URV>(addr, result);
+template <typename URV>
+void
+Core<URV>::execBseti(uint32_t rd, uint32_t rs1, int32_t amount)
+{
+  if ((amount & 0x20) and not rv64_)
+    {
+      illegalInst();  // Bit 5 of bit index cannot be one in 32-bit.
+      return;
+    }
 
-  if (not ldStException_)
-    intRegs_.write(rd, rdVal);
+  URV v = intRegs_.read(rs1) | (URV(1) << amount);
+  intRegs_.write(rd, v);
 }
 
 
@@ -20,6 +20,8 @@
 
 #include <cstdint>
 #include <vector>
+#include <atomic>
+#include <cfenv>
 #include <iosfwd>
 #include <type_traits>
 #include "InstId.hpp"
@@ -27,8 +29,18 @@
 #include "IntRegs.hpp"
 #include "CsRegs.hpp"
 #include "FpRegs.hpp"
+#include "VecRegs.hpp"
 #include "Memory.hpp"
 #include "InstProfile.hpp"
+#include "AddressSet.hpp"
+#include "Syscall.hpp"
+#include "Console.hpp"
+#include "BasicBlockVectors.hpp"
+#include "TimingModel.hpp"
+#include "CacheModel.hpp"
+#include "BranchPredictor.hpp"
+#include "MemoryTrace.hpp"
+#include "PageProfile.hpp"
 
 namespace WdRiscv
 {
@@ -156,6 +168,22 @@ namespace WdRiscv
     /// true on success. Return false if reg is out of bound.
     bool pokeFpReg(unsigned reg, uint64_t val);
 
+    /// Set bytes to the contents (least significant byte first) of
+    /// the given vector register returning true on success. Return
+    /// false if reg is out of bounds or if the vector extension is
+    /// not enabled.
+    bool peekVecReg(unsigned reg, std::vector<uint8_t>& bytes) const;
+
+    /// Set the given vector register to the given bytes (least
+    /// significant first) returning true on success. Return false if
+    /// reg is out of bounds or if the vector extension is not enabled.
+    bool pokeVecReg(unsigned reg, const std::vector<uint8_t>& bytes);
+
+    /// Define the length in bits (VLEN) of the vector registers. Length
+    /// must be a power of 2 between 64 and 65536. Vector registers are
+    /// cleared. Return true on success and false on failure.
+    bool configVectorLength(unsigned bits);
+
     /// Set val to the value of the control and status register csr
     /// returning true on success. Return false leaving val unmodified
     /// if csr is out of bounds.
@@ -318,7 +346,10 @@ namespace WdRiscv
 
     /// Define the memory address corresponding to console io. Reading/writing
     /// a byte (lb/sb) from/to that address reads/writes a byte to/from
-    /// the console.
+    /// the console. Storing a register-wide word (sw in rv32 or sd in
+    /// rv64) to that address writes a whole buffer to the console: the
+    /// stored value is the address of a pair of words holding the
+    /// buffer address and the buffer size.
     void setConsoleIo(URV address)
     { conIo_ = address; conIoValid_ = true; }
 
@@ -326,9 +357,14 @@ namespace WdRiscv
     void clearConsoleIo()
     { conIoValid_ = false; }
 
-    /// Console output gets directed to given file.
+    /// Console output gets directed to given file. Output is buffered:
+    /// pending output to the previous file is flushed.
     void setConsoleOutput(FILE* out)
-    { consoleOut_ = out; }
+    { console_.setOutput(out); }
+
+    /// Write out pending console output.
+    void flushConsole()
+    { console_.flush(); }
 
     /// If a console io memory mapped location is defined then put its
     /// address in address and return true; otherwise, return false
@@ -441,6 +477,14 @@ namespace WdRiscv
     /// Clear pending non-maskable-interrupt.
     void clearPendingNmi();
 
+    /// Notify the core that the interrupt state may have changed
+    /// (e.g. an in-process device or timer changed the MIP bits by
+    /// other means than pokeCsr). The run loops check for pending
+    /// interrupts only after such a notification. Writing/poking
+    /// MSTATUS, MIE or MIP and setPendingNmi notify automatically.
+    void signalPendingEvent()
+    { pendingEvent_ = true; }
+
     /// Define address to which a write will stop the simulator. An
     /// sb, sh, or sw instruction will stop the simulator if the write
     /// address of he instruction is identical to the given address.
@@ -469,6 +513,12 @@ namespace WdRiscv
     /// it no FP register was written.
     int lastFpReg() const;
 
+    /// Support for tracing: Return the index of the first vector
+    /// register of the group written by the last executed instruction
+    /// setting count to the number of registers in the group. Return
+    /// -1 if no vector register was written.
+    int lastVecReg(unsigned& count) const;
+
     /// Support for tracing: Fill the csrs vector with the
     /// register-numbers of the CSRs written by the execution of the
     /// last instruction. CSRs modified as a side effect (e.g. mcycle
@@ -495,6 +545,17 @@ namespace WdRiscv
     void setInstructionCountLimit(uint64_t limit)
     { instCountLim_ = limit; }
 
+    /// Define a window of instructions for the run method: The
+    /// instructions up to begin are executed with tracing, triggers,
+    /// performance counters and instruction profiling off
+    /// (fast-forward), those from begin+1 to end with the features
+    /// requested for the run, and those after end with the features
+    /// off again. Instructions are counted as for the instruction
+    /// count limit (see setInstructionCountLimit). An end of ~0
+    /// extends the window to the end of the run.
+    void setTraceWindow(uint64_t begin, uint64_t end)
+    { windowBegin_ = begin; windowEnd_ = end; hasWindow_ = true; }
+
     /// Reset executed instruction count.
     void setInstructionCount(uint64_t count)
     { counter_ = count; }
@@ -557,6 +618,20 @@ namespace WdRiscv
     uint64_t getInterruptCount() const
     { return interruptCount_; }
 
+    /// Return count of instructions retired by this core (value of
+    /// the minstret CSR).
+    uint64_t getRetiredInstructionCount() const
+    { return retiredInsts_; }
+
+    /// Return count of cycles seen by this core (value of the mcycle
+    /// CSR).
+    uint64_t getCycleCount() const
+    { return cycleCount_; }
+
+    /// Return the number of memory pages touched so far.
+    size_t countTouchedMemoryPages() const
+    { return memory_.countTouchedPages(); }
+
     /// Set pre and post to the count of "before"/"after" triggers
     /// that tripped by the last executed instruction.
     void countTrippedTriggers(unsigned& pre, unsigned& post) const
@@ -631,6 +706,135 @@ namespace WdRiscv
     /// Print collected instruction frequency to the given file.
     void reportInstructionFrequency(FILE* file) const;
 
+    /// Collect SimPoint basic block vectors writing one line per
+    /// interval of the given number of retired instructions to the
+    /// given file (see BasicBlockVectors). A zero interval disables
+    /// collection.
+    void enableBasicBlockVectors(FILE* file, uint64_t interval)
+    { bbv_.enable(file, interval); }
+
+    /// Write the basic block vector of the last (partial) interval.
+    void finishBasicBlockVectors()
+    { bbv_.finish(); }
+
+    /// Turn on/off the pipeline timing model: When on, the cycle count
+    /// (mcycle) advances according to the model (see TimingModel)
+    /// instead of once per instruction and the stall and branch
+    /// misprediction performance events are counted.
+    void enableTimingModel(bool flag)
+    { timing_.enable(flag); }
+
+    /// Define the latencies and sizes of the pipeline timing model.
+    void configTimingModel(const TimingParams& params)
+    { timing_.setParams(params); }
+
+    /// Return the pipeline timing model (for its statistics).
+    const TimingModel<URV>& timingModel() const
+    { return timing_; }
+
+    /// Turn on/off the branch predictor model: When on, each retired
+    /// branch/jump is presented to the predictor which collects
+    /// misprediction statistics per branch site and counts the
+    /// BranchMiss performance event. The timing model always uses the
+    /// predictor to time control transfers.
+    void enableBranchPredictor(bool flag)
+    { predictor_.enable(flag); }
+
+    /// Define the kind and sizes of the branch predictor model.
+    void configBranchPredictor(const PredictorParams& params)
+    { predictor_.setParams(params); }
+
+    /// Return the branch predictor model (for its statistics).
+    const BranchPredictor<URV>& branchPredictor() const
+    { return predictor_; }
+
+    /// Write a binary record of each load/store (and of each
+    /// instruction fetch if fetches is true) to the given file (see
+    /// MemoryTrace). Return false if file cannot be opened.
+    bool enableMemoryTrace(const std::string& path, bool fetches)
+    { return memTrace_.open(path, sizeof(URV)*8, fetches); }
+
+    /// Write all pending memory trace records and close the memory
+    /// trace file.
+    void closeMemoryTrace()
+    { memTrace_.close(); }
+
+    /// Return the memory trace (for its statistics).
+    const MemoryTrace& memoryTrace() const
+    { return memTrace_; }
+
+    /// Start counting the reads, writes and instruction fetches of
+    /// each memory page, recording one access out of samplePeriod (1
+    /// for exact counts), and the working set (distinct pages touched)
+    /// every interval instructions. See PageProfile.
+    void enablePageProfile(uint64_t samplePeriod, uint64_t interval)
+    {
+      unsigned shift = __builtin_ctzll(memory_.pageSize());
+      pageProfile_.start(shift, samplePeriod, interval);
+    }
+
+    /// Write the page heat map and working set curve collected since
+    /// enablePageProfile to the given file.
+    void reportPageProfile(FILE* file)
+    { pageProfile_.report(file, retiredInsts_); }
+
+    /// Return the page profile.
+    const PageProfile& pageProfile() const
+    { return pageProfile_; }
+
+    /// Define the geometry and policies of the instruction cache model
+    /// and turn it on. Return false if the geometry is not valid. The
+    /// model is fed with the instruction fetches outside of the ICCM
+    /// and memory mapped registers: It counts the ICacheHits and
+    /// ICacheMisses events and either adds the miss penalty to the
+    /// cycle count or, when the timing model is on, has misses fetched
+    /// from external memory.
+    bool configInstCache(const CacheParams& params)
+    {
+      if (not icache_.configure(params))
+	return false;
+      icache_.enable(true);
+      return true;
+    }
+
+    /// Define the geometry and policies of the data cache model and
+    /// turn it on. Return false if the geometry is not valid. Same as
+    /// configInstCache but for loads/stores outside of the DCCM and
+    /// memory mapped registers (DCacheHits and DCacheMisses events).
+    bool configDataCache(const CacheParams& params)
+    {
+      if (not dcache_.configure(params))
+	return false;
+      dcache_.enable(true);
+      return true;
+    }
+
+    /// Turn off the instruction cache model.
+    void disableInstCache()
+    { icache_.enable(false); }
+
+    /// Turn off the data cache model.
+    void disableDataCache()
+    { dcache_.enable(false); }
+
+    /// Return the instruction cache model (for its statistics).
+    const CacheModel& instCache() const
+    { return icache_; }
+
+    /// Return the data cache model (for its statistics).
+    const CacheModel& dataCache() const
+    { return dcache_; }
+
+    /// Enable/disable collection of the instruction mix: count of
+    /// retired instructions per instruction type.
+    void enableInstructionMix(bool flag);
+
+    /// Fill given vector with the instruction mix: Ith entry is the
+    /// count of retired instructions of type InstType(i). Vector is
+    /// left empty if instruction mix collection was never enabled.
+    void getInstructionMix(std::vector<uint64_t>& mix) const
+    { mix = instTypeCounts_; }
+
     /// Reset trace data (items changed by the execution of an
     /// instruction.)
     void clearTraceData();
@@ -645,10 +849,95 @@ namespace WdRiscv
     void enablePerformanceCounters(bool flag)
     { enableCounters_ = flag;  }
 
+    /// Enable/disable the integer-only (soft) implementation of the
+    /// floating point add, sub, mul, div, sqrt and fused multiply-add
+    /// instructions. Soft results are independent of the host floating
+    /// point environment and are exact for all rounding modes
+    /// including NearestMax.
+    void enableSoftFloat(bool flag)
+    { softFloat_ = flag; }
+
     /// Enable gdb-mode.
     void enableGdb(bool flag)
     { enableGdb_ = flag; }
 
+    /// Define a breakpoint at the given address: A run (see run,
+    /// runUntilAddress and untilAddress) stops before executing the
+    /// instruction at that address unless it is the first instruction
+    /// of the run. In gdb mode, control is passed to the remote
+    /// debugger instead of stopping.
+    void addBreakpoint(URV address)
+    { breakpoints_.insert(address); breakCheck_ = true; }
+
+    /// Remove the breakpoint at the given address. Return false if
+    /// there is no such breakpoint.
+    bool removeBreakpoint(URV address)
+    {
+      bool ok = breakpoints_.erase(address);
+      updateBreakCheck();
+      return ok;
+    }
+
+    /// Define a watchpoint covering the size bytes at the given
+    /// address: A run stops (or passes control to gdb) after an
+    /// instruction loads (if read is true) or stores (if write is
+    /// true) any of these bytes.
+    void addWatchpoint(URV address, URV size, bool read, bool write)
+    {
+      if (read)
+	readWatch_.insert(address, size);
+      if (write)
+	writeWatch_.insert(address, size);
+      watchCheck_ = not readWatch_.empty() or not writeWatch_.empty();
+    }
+
+    /// Remove a watchpoint previously defined with addWatchpoint.
+    /// Return false if no such watchpoint.
+    bool removeWatchpoint(URV address, URV size, bool read, bool write)
+    {
+      bool ok = true;
+      if (read)
+	ok = readWatch_.erase(address, size) and ok;
+      if (write)
+	ok = writeWatch_.erase(address, size) and ok;
+      watchCheck_ = not readWatch_.empty() or not writeWatch_.empty();
+      return ok;
+    }
+
+    /// Remove all breakpoints and watchpoints.
+    void clearBreakpoints()
+    {
+      breakpoints_.clear();
+      readWatch_.clear();
+      writeWatch_.clear();
+      watchCheck_ = watchHit_ = false;
+      updateBreakCheck();
+    }
+
+    /// Return true if the last executed instruction hit a watchpoint
+    /// setting address to the accessed data address and isLoad to
+    /// true for a load and false for a store. Clear the hit.
+    bool getWatchpointHit(URV& address, bool& isLoad)
+    {
+      if (not watchHit_)
+	return false;
+      address = watchHitAddr_;
+      isLoad = watchHitLoad_;
+      watchHit_ = false;
+      updateBreakCheck();
+      return true;
+    }
+
+    /// Make the current run stop before the next instruction to
+    /// service the gdb connection (accept a connection or an interrupt
+    /// request, see serviceGdbRequest in gdb.cpp) passing control to
+    /// gdb if needed. This is called by the gdb connection thread.
+    void requestGdbStop()
+    {
+      gdbStopRequest_ = true;
+      breakCheck_ = true;
+    }
+
     /// Enable use of ABI register names (e.g. sp instead of x2) in
     /// instruction disassembly.
     void enableAbiNames(bool flag)
@@ -662,6 +951,13 @@ namespace WdRiscv
     void enableNewlib(bool flag)
     { newlib_ = flag; }
 
+    /// Enable RISCV semihosting: An ebreak instruction preceded by
+    /// "slli x0, x0, 0x1f" and followed by "srai x0, x0, 7" (all
+    /// uncompressed) is a request serviced by the simulator (see
+    /// Syscall::semihost) instead of a breakpoint exception.
+    void enableSemihosting(bool flag)
+    { semihosting_ = flag; }
+
     /// For Linux emulation: Set initial target program break to the
     /// RISCV page address larger than or equal to the given address.
     void setTargetProgramBreak(URV addr);
@@ -687,6 +983,15 @@ namespace WdRiscv
     bool isRvd() const
     { return rvd_; }
 
+    /// Return true if rvb (bit manipulation: Zba, Zbb, and Zbs)
+    /// extension is enabled in this core.
+    bool isRvb() const
+    { return rvb_; }
+
+    /// Return true if rvv (vector) extension is enabled in this core.
+    bool isRvv() const
+    { return rvv_; }
+
     /// Return true if rv64 (64-bit option) extension is enabled in
     /// this core.
     bool isRv64() const
@@ -728,13 +1033,71 @@ namespace WdRiscv
   protected:
 
     /// Helper to run method: Run until toHost is written or until
-    /// exit is called.
+    /// exit is called or until the instruction count limit is
+    /// reached.
     bool simpleRun();
 
-    /// Helper to decode. Used for compressed instructions.
+    /// Helper to run method: Run in three phases (fast-forward, trace
+    /// window, fast) according to the trace window (see
+    /// setTraceWindow).
+    bool runTraceWindow(FILE* file);
+
+    /// Helper to runTraceWindow: Run with all instrumentation off
+    /// until the instruction count reaches the given limit or the
+    /// program stops.
+    bool fastForward(uint64_t limit);
+
+    /// Return true if a run should stop before executing the
+    /// instruction at the current pc: Either the last executed
+    /// instruction hit a watchpoint or there is a breakpoint at the pc
+    /// and resuming is false (resuming is true for the first
+    /// instruction of a run). In gdb mode, report the stop to gdb and
+    /// return false once gdb continues. Otherwise, report the stop to
+    /// the user.
+    bool stopAtBreakpoint(bool resuming);
+
+    /// Set breakCheck_ to true if the run loops need to check for a
+    /// breakpoint/watchpoint/gdb stop before each instruction.
+    void updateBreakCheck()
+    { breakCheck_ = watchHit_ or gdbStopRequest_ or not breakpoints_.empty(); }
+
+    /// Record a watchpoint hit if any of the size bytes at the given
+    /// data address is watched for loads (if isLoad is true) or for
+    /// stores (if isLoad is false).
+    void checkWatchpoint(URV addr, unsigned size, bool isLoad)
+    {
+      const auto& watch = isLoad? readWatch_ : writeWatch_;
+      if (not watch.intersects(addr, size))
+	return;
+      watchHit_ = true;
+      watchHitLoad_ = isLoad;
+      watchHitAddr_ = addr;
+      breakCheck_ = true;
+    }
+
+    /// Helper to decode. Used for compressed instructions. Looks up
+    /// the instruction in the pre-decoded compressed table.
     const InstInfo& decode16(uint32_t inst, uint32_t& op0, uint32_t& op1,
 			     int32_t& op2);
 
+    /// Helper to buildDecodeTables: Decode given 16-bit
+    /// instruction by parsing its fields according to the currently
+    /// enabled extensions.
+    const InstInfo& decodeCompressed(uint32_t inst, uint32_t& op0,
+				     uint32_t& op1, int32_t& op2);
+
+    /// Helper to buildDecodeTables: Expand given 16-bit
+    /// instruction to the equivalent 32-bit code by parsing its
+    /// fields. Return false if there is no equivalent.
+    bool expandCompressed(uint16_t inst, uint32_t& code32) const;
+
+    /// Map each instruction id to its execute method in execTable_
+    /// (execIllegal for instructions of disabled extensions) and
+    /// pre-decode all 65536 16-bit codes into compressedTable_. Do
+    /// nothing if the tables are already built for the currently
+    /// enabled extensions.
+    void buildDecodeTables();
+
     /// Helper to whatIfSingleStep.
     void collectAndUndoWhatIfChanges(URV prevPc, ChangeRecord& record);
 
@@ -813,8 +1176,71 @@ namespace WdRiscv
     /// execute16 has already set the instruction rounding mode.
     RoundingMode effectiveRoundingMode();
 
-    /// Update the accrued floating point bits in the FCSR register.
-    void updateAccruedFpBits();
+    /// Update the accrued floating point bits in the FCSR register
+    /// from the host floating point flags. No-op in lazy mode (see
+    /// enableLazyFpEnv) where the host flags are accumulated and
+    /// transferred to FCSR by syncFpFlags.
+    void updateAccruedFpBits()
+    { if (not lazyFpEnv_) accrueHostFpFlags(); }
+
+    /// Helper to updateAccruedFpBits and syncFpFlags: Or the host
+    /// floating point exception flags into the FCSR register.
+    void accrueHostFpFlags();
+
+    /// Return the host floating point exception flags as FpFlags bits.
+    unsigned hostFpFlags() const;
+
+    /// Helper to peekCsr: In lazy mode, or into the given value of
+    /// FFLAGS/FCSR the flags accumulated by the host but not yet
+    /// transferred to FCSR (see syncFpFlags).
+    void addPendingFpFlags(CsrNumber csr, URV& val) const
+    {
+      if (lazyFpEnv_ and (csr == CsrNumber::FFLAGS or csr == CsrNumber::FCSR))
+	val |= hostFpFlags();
+    }
+
+    /// Or the given exception flags (FpFlags bits) into the FCSR
+    /// register.
+    void orFcsrFlags(unsigned flags);
+
+    /// Clear the host floating point exception flags before executing
+    /// a floating point instruction. No-op in lazy mode.
+    void clearFpFlags()
+    { if (not lazyFpEnv_) std::feclearexcept(FE_ALL_EXCEPT); }
+
+    /// Set the host rounding mode to the given RISCV rounding mode
+    /// returning the previous host mode to be passed to
+    /// restoreFpRoundingMode. In lazy mode, the host mode is changed
+    /// only if it differs from that of the previous floating point
+    /// instruction.
+    int setFpRoundingMode(RoundingMode mode);
+
+    /// Restore the host rounding mode changed by setFpRoundingMode.
+    /// No-op in lazy mode.
+    void restoreFpRoundingMode(int prevMode)
+    { if (not lazyFpEnv_) std::fesetround(prevMode); }
+
+    /// In lazy mode, transfer the host floating point flags
+    /// accumulated since the last call to FCSR. This must be called
+    /// before FCSR/FFLAGS/FRM are accessed.
+    void syncFpFlags()
+    {
+      if (lazyFpEnv_)
+	{
+	  accrueHostFpFlags();
+	  std::feclearexcept(FE_ALL_EXCEPT);
+	}
+    }
+
+    /// Enable/disable lazy floating point environment mode. In that
+    /// mode the host rounding mode is kept across floating point
+    /// instructions and the host exception flags accumulate until
+    /// syncFpFlags is called. This avoids several serializing host
+    /// operations per floating point instruction. Lazy mode cannot
+    /// be used when the changes to FCSR must be reported for each
+    /// instruction (tracing, triggers, server and gdb modes). Disabling lazy
+    /// mode syncs the flags and restores the host rounding mode.
+    void enableLazyFpEnv(bool flag);
 
     /// Undo the effect of the last executed instruction given that
     /// that a trigger has tripped.
@@ -837,6 +1263,20 @@ namespace WdRiscv
     /// Helper to load/store.
     bool misalignedAccessCausesException(URV addr, unsigned accessSize) const;
 
+    /// Helper to scalar and vector loads. Check the load-address
+    /// triggers (before timing) on the given address. Return true if a
+    /// trigger tripped (the access must then not be performed).
+    bool loadTriggerTripped(URV addr, unsigned size);
+
+    /// Helper to scalar and vector loads. Read a value of type
+    /// LOAD_TYPE from the given address for the current instruction
+    /// presenting the access to the cache models, memory trace, page
+    /// profile and watchpoints. Return true on success. On a
+    /// misaligned or faulting access, initiate the corresponding
+    /// exception and return false.
+    template<typename LOAD_TYPE>
+    bool readLoadData(URV addr, LOAD_TYPE& value);
+
     /// Helper to lb, lh, lw and ld. Load type should be int_8, int16_t
     /// etc... for signed byte, halfword etc... and uint8_t, uint16_t
     /// etc... for lbu, lhu, etc...
@@ -848,6 +1288,11 @@ namespace WdRiscv
     template<typename STORE_TYPE>
     void store(URV addr, STORE_TYPE value);
 
+    /// Write to the console the buffer described by the pair of words
+    /// (buffer address and size) at the given address. See
+    /// setConsoleIo.
+    void writeConsoleBuffer(URV descAddr);
+
     /// Helper to execLr. Load type should be int32_t, or int64_t.
     template<typename LOAD_TYPE>
     void loadReserve(uint32_t rd, uint32_t rs1);
@@ -858,6 +1303,80 @@ namespace WdRiscv
     template<typename STORE_TYPE>
     bool storeConditional(URV addr, STORE_TYPE value);
 
+    /// Source of the second operand of a vector instruction: Vector
+    /// register, integer register, sign extended 5-bit immediate,
+    /// unsigned 5-bit immediate, or floating point register.
+    enum class VecSrc { Vector, Int, Imm, Uimm, Fp };
+
+    /// Helper to vector instructions. Return the element width
+    /// (SEW) in bits and the register group size (1 for fractional
+    /// LMUL) corresponding to the current vtype. Return false if
+    /// vtype is illegal (vill set).
+    bool vecConfig(unsigned& sew, unsigned& group) const;
+
+    /// Helper to vector instructions. Return true if the vector
+    /// extension is enabled, vtype is legal, and the given register
+    /// group numbers are multiples of the current register group
+    /// size. If masked, the destination group must not overlap v0
+    /// unless vdMayBeMask is true. Set sew to the element width.
+    /// Take an illegal instruction exception and return false
+    /// otherwise.
+    bool checkVecOperands(unsigned vd, unsigned vs1, unsigned vs2,
+			  unsigned& sew, bool vdMayBeMask = false);
+
+    /// Helper to vector instructions: Mark the destination register
+    /// group as written and reset vstart.
+    void vecCommit(unsigned vd);
+
+    /// Helper to vsetvli, vsetivli, and vsetvl: Set vtype to the
+    /// given value (or to vill if the value is not supported) and vl
+    /// to the application vector length avl capped to VLMAX. If
+    /// useVlmax is true, vl is set to VLMAX. Keep vl if keepVl is
+    /// true. Write vl to rd.
+    void vecSetConfig(uint32_t rd, URV avl, URV vtype, bool useVlmax,
+		      bool keepVl);
+
+    /// Helper to vector integer instructions: Apply op to the
+    /// elements of the register group vs2 and to the second operand
+    /// (of the given source) writing the result to the group vd.
+    template<typename OP>
+    void vecIntOp(uint32_t vd, uint32_t vs2, uint32_t src, VecSrc kind,
+		  OP op);
+
+    /// Helper to vecIntOp: Same as vecIntOp for element type T.
+    template<typename T, typename OP>
+    void vecIntOpSew(uint32_t vd, uint32_t vs2, uint32_t src, VecSrc kind,
+		     OP op);
+
+    /// Helper to vector integer reductions: vd[0] = reduce of
+    /// vs1[0] and active elements of vs2 using op.
+    template<typename OP>
+    void vecIntReduce(uint32_t vd, uint32_t vs2, uint32_t vs1, OP op);
+
+    /// Operations of the vector floating point instructions.
+    enum class VecFpOp { Add, Sub, Rsub, Mul, Div, Rdiv, Macc };
+
+    /// Helper to vector floating point arithmetic instructions.
+    void vecFpOp(uint32_t vd, uint32_t vs2, uint32_t src, VecSrc kind,
+		 VecFpOp op);
+
+    /// Helper to vecFpOp: Same as vecFpOp for element type FT (float
+    /// or double) with unsigned integer counterpart UT.
+    template<typename FT, typename UT>
+    void vecFpOpSew(uint32_t vd, uint32_t vs2, uint32_t src, VecSrc kind,
+		    VecFpOp op, RoundingMode mode);
+
+    /// Helper to vfredusum and vfredosum.
+    void vecFpReduceSum(uint32_t vd, uint32_t vs2, uint32_t vs1);
+
+    /// Helper to vector unit-stride loads.
+    template<typename ELEM_TYPE>
+    void vecLoad(uint32_t vd, uint32_t rs1);
+
+    /// Helper to vector unit-stride stores.
+    template<typename ELEM_TYPE>
+    void vecStore(uint32_t vs3, uint32_t rs1);
+
     /// Helper to CSR instructions. Keep minstret and mcycle up to date.
     void preCsrInstruction(CsrNumber csr);
 
@@ -908,6 +1427,49 @@ namespace WdRiscv
     /// performance monitors).
     void accumulateInstructionStats(uint32_t inst);
 
+    /// Account for the given retired instruction in the basic block
+    /// vectors (see enableBasicBlockVectors).
+    void accumulateBasicBlockVectors(uint32_t inst);
+
+    /// Advance the cycle count according to the pipeline timing model
+    /// for the given retired instruction (see enableTimingModel).
+    void accumulateTiming(uint32_t inst);
+
+    /// Account for the given retired instruction in the branch
+    /// predictor if it is a branch or a jump (see
+    /// enableBranchPredictor).
+    void accumulateBranchPrediction(uint32_t inst);
+
+    /// Present the retired branch/jump with the given id and operands
+    /// to the branch predictor. Return true if it was mispredicted.
+    bool predictBranch(InstId id, uint32_t op0, uint32_t op1, int32_t op2,
+		       unsigned size);
+
+    /// Record a load/store (store if write is true) of size bytes at
+    /// addr by the current instruction in the memory trace.
+    void traceDataAccess(URV addr, unsigned size, bool write)
+    {
+      auto type = write? MemoryTrace::Access::Store : MemoryTrace::Access::Load;
+      memTrace_.record(type, currPc_, addr, size,
+		       memory_.getAttrib(addr).isDccm());
+    }
+
+    /// Record the fetch of the given instruction at addr in the memory
+    /// trace.
+    void traceFetch(URV addr, uint32_t inst)
+    {
+      memTrace_.record(MemoryTrace::Access::Fetch, addr, addr,
+		       instructionSize(inst), false);
+    }
+
+    /// Present the fetch of the given instruction at the given address
+    /// to the instruction cache model (see configInstCache).
+    void accessInstCache(URV addr, uint32_t inst);
+
+    /// Present a load/store (store if write is true) of size bytes at
+    /// addr to the data cache model (see configDataCache).
+    void accessDataCache(URV addr, unsigned size, bool write);
+
     /// Fetch an instruction. Return true on success. Return false on
     /// fail (in which case an exception is initiated). May fetch a
     /// compressed instruction (16-bits) in which case the upper 16
@@ -957,18 +1519,19 @@ namespace WdRiscv
     /// exception will end up modifying pc_.
     void execute16(uint16_t inst);
 
-    /// Helper to decode: Decode instructions associated with opcode
-    /// 1010011.
-    const InstInfo& decodeFp(uint32_t inst, uint32_t& op0, uint32_t& op1,
-			     int32_t& op2);
-
     /// Helper to disassembleInst32: Disassemble instructions
     /// associated with opcode 1010011.
     void disassembleFp(uint32_t inst, std::ostream& stream);
 
-    /// Decode and execute floating point instructions associated with
-    /// opcode 1010011. This is a helper to execute32.
-    void executeFp(uint32_t inst);
+    /// Helper to disassembleInst32: Disassemble vector instructions
+    /// (opcode 1010111 and the vector forms of opcodes 0000111 and
+    /// 0100111).
+    void printVecInst(std::ostream& stream, uint32_t inst);
+
+    /// Helper to disassembleInst32: Disassemble given instruction if
+    /// it is an enabled bit manipulation (Zba, Zbb, or Zbs) instruction
+    /// returning true. Return false otherwise.
+    bool printBitManipInst(std::ostream& stream, uint32_t inst);
 
     /// Change machine state and program counter in reaction to an
     /// exception or an interrupt. Given pc is the program counter to
@@ -989,6 +1552,15 @@ namespace WdRiscv
     /// illegal instruction.
     void unimplemented();
 
+    /// Return true if the ebreak instruction at the current pc is part
+    /// of a semihosting request sequence (see enableSemihosting).
+    bool isSemihostingRequest();
+
+    /// Same as illegalInst but with the signature of the execute
+    /// methods so that it can be placed in a dispatch table.
+    void execIllegal(uint32_t = 0, uint32_t = 0, int32_t = 0)
+    { illegalInst(); }
+
     /// Return true if an external interrupts are enabled and an external
     /// interrupt is pending and is enabled. Set cause to the type of
     /// interrupt.
@@ -997,9 +1569,6 @@ namespace WdRiscv
     /// Return true if 256mb region of address is idempotent.
     bool isIdempotentRegion(size_t addr) const;
 
-    /// Implement some Newlib system calls in the simulator.
-    URV emulateNewlib();
-
     // rs1: index of source register (value range: 0 to 31)
     // rs2: index of source register (value range: 0 to 31)
     // rd: index of destination register (value range: 0 to 31)
@@ -1178,6 +1747,7 @@ namespace WdRiscv
     void execLr_w(uint32_t rd, uint32_t rs1, int32_t rs2);
     void execSc_w(uint32_t rd, uint32_t rs1, int32_t rs2);
     void execAmoxor_w(uint32_t rd, uint32_t rs1, int32_t rs2);
+    void execAmoand_w(uint32_t rd, uint32_t rs1, int32_t rs2);
     void execAmoor_w(uint32_t rd, uint32_t rs1, int32_t rs2);
     void execAmomin_w(uint32_t rd, uint32_t rs1, int32_t rs2);
     void execAmomax_w(uint32_t rd, uint32_t rs1, int32_t rs2);
@@ -1190,12 +1760,141 @@ namespace WdRiscv
     void execLr_d(uint32_t rd, uint32_t rs1, int32_t rs2);
     void execSc_d(uint32_t rd, uint32_t rs1, int32_t rs2);
     void execAmoxor_d(uint32_t rd, uint32_t rs1, int32_t rs2);
+    void execAmoand_d(uint32_t rd, uint32_t rs1, int32_t rs2);
     void execAmoor_d(uint32_t rd, uint32_t rs1, int32_t rs2);
     void execAmomin_d(uint32_t rd, uint32_t rs1, int32_t rs2);
     void execAmomax_d(uint32_t rd, uint32_t rs1, int32_t rs2);
     void execAmominu_d(uint32_t rd, uint32_t rs1, int32_t rs2);
     void execAmomaxu_d(uint32_t rd, uint32_t rs1, int32_t rs2);
 
+    // vector
+    void execVsetvli(uint32_t rd, uint32_t rs1, int32_t vtypei);
+    void execVsetivli(uint32_t rd, uint32_t uimm, int32_t vtypei);
+    void execVsetvl(uint32_t rd, uint32_t rs1, int32_t rs2);
+
+    void execVle8_v(uint32_t vd, uint32_t rs1, int32_t);
+    void execVle16_v(uint32_t vd, uint32_t rs1, int32_t);
+    void execVle32_v(uint32_t vd, uint32_t rs1, int32_t);
+    void execVle64_v(uint32_t vd, uint32_t rs1, int32_t);
+    void execVse8_v(uint32_t vs3, uint32_t rs1, int32_t);
+    void execVse16_v(uint32_t vs3, uint32_t rs1, int32_t);
+    void execVse32_v(uint32_t vs3, uint32_t rs1, int32_t);
+    void execVse64_v(uint32_t vs3, uint32_t rs1, int32_t);
+
+    void execVadd_vv(uint32_t vd, uint32_t vs2, int32_t vs1);
+    void execVadd_vx(uint32_t vd, uint32_t vs2, int32_t rs1);
+    void execVadd_vi(uint32_t vd, uint32_t vs2, int32_t imm);
+    void execVsub_vv(uint32_t vd, uint32_t vs2, int32_t vs1);
+    void execVsub_vx(uint32_t vd, uint32_t vs2, int32_t rs1);
+    void execVrsub_vx(uint32_t vd, uint32_t vs2, int32_t rs1);
+    void execVrsub_vi(uint32_t vd, uint32_t vs2, int32_t imm);
+    void execVminu_vv(uint32_t vd, uint32_t vs2, int32_t vs1);
+    void execVminu_vx(uint32_t vd, uint32_t vs2, int32_t rs1);
+    void execVmin_vv(uint32_t vd, uint32_t vs2, int32_t vs1);
+    void execVmin_vx(uint32_t vd, uint32_t vs2, int32_t rs1);
+    void execVmaxu_vv(uint32_t vd, uint32_t vs2, int32_t vs1);
+    void execVmaxu_vx(uint32_t vd, uint32_t vs2, int32_t rs1);
+    void execVmax_vv(uint32_t vd, uint32_t vs2, int32_t vs1);
+    void execVmax_vx(uint32_t vd, uint32_t vs2, int32_t rs1);
+    void execVand_vv(uint32_t vd, uint32_t vs2, int32_t vs1);
+    void execVand_vx(uint32_t vd, uint32_t vs2, int32_t rs1);
+    void execVand_vi(uint32_t vd, uint32_t vs2, int32_t imm);
+    void execVor_vv(uint32_t vd, uint32_t vs2, int32_t vs1);
+    void execVor_vx(uint32_t vd, uint32_t vs2, int32_t rs1);
+    void execVor_vi(uint32_t vd, uint32_t vs2, int32_t imm);
+    void execVxor_vv(uint32_t vd, uint32_t vs2, int32_t vs1);
+    void execVxor_vx(uint32_t vd, uint32_t vs2, int32_t rs1);
+    void execVxor_vi(uint32_t vd, uint32_t vs2, int32_t imm);
+    void execVsll_vv(uint32_t vd, uint32_t vs2, int32_t vs1);
+    void execVsll_vx(uint32_t vd, uint32_t vs2, int32_t rs1);
+    void execVsll_vi(uint32_t vd, uint32_t vs2, int32_t imm);
+    void execVsrl_vv(uint32_t vd, uint32_t vs2, int32_t vs1);
+    void execVsrl_vx(uint32_t vd, uint32_t vs2, int32_t rs1);
+    void execVsrl_vi(uint32_t vd, uint32_t vs2, int32_t imm);
+    void execVsra_vv(uint32_t vd, uint32_t vs2, int32_t vs1);
+    void execVsra_vx(uint32_t vd, uint32_t vs2, int32_t rs1);
+    void execVsra_vi(uint32_t vd, uint32_t vs2, int32_t imm);
+    void execVmul_vv(uint32_t vd, uint32_t vs2, int32_t vs1);
+    void execVmul_vx(uint32_t vd, uint32_t vs2, int32_t rs1);
+    void execVmv_v_v(uint32_t vd, uint32_t vs1, int32_t);
+    void execVmv_v_x(uint32_t vd, uint32_t rs1, int32_t);
+    void execVmv_v_i(uint32_t vd, uint32_t imm, int32_t);
+    void execVmv_x_s(uint32_t rd, uint32_t vs2, int32_t);
+    void execVmv_s_x(uint32_t vd, uint32_t rs1, int32_t);
+
+    void execVredsum_vs(uint32_t vd, uint32_t vs2, int32_t vs1);
+    void execVredand_vs(uint32_t vd, uint32_t vs2, int32_t vs1);
+    void execVredor_vs(uint32_t vd, uint32_t vs2, int32_t vs1);
+    void execVredxor_vs(uint32_t vd, uint32_t vs2, int32_t vs1);
+    void execVredminu_vs(uint32_t vd, uint32_t vs2, int32_t vs1);
+    void execVredmin_vs(uint32_t vd, uint32_t vs2, int32_t vs1);
+    void execVredmaxu_vs(uint32_t vd, uint32_t vs2, int32_t vs1);
+    void execVredmax_vs(uint32_t vd, uint32_t vs2, int32_t vs1);
+
+    void execVfadd_vv(uint32_t vd, uint32_t vs2, int32_t vs1);
+    void execVfadd_vf(uint32_t vd, uint32_t vs2, int32_t rs1);
+    void execVfsub_vv(uint32_t vd, uint32_t vs2, int32_t vs1);
+    void execVfsub_vf(uint32_t vd, uint32_t vs2, int32_t rs1);
+    void execVfrsub_vf(uint32_t vd, uint32_t vs2, int32_t rs1);
+    void execVfmul_vv(uint32_t vd, uint32_t vs2, int32_t vs1);
+    void execVfmul_vf(uint32_t vd, uint32_t vs2, int32_t rs1);
+    void execVfdiv_vv(uint32_t vd, uint32_t vs2, int32_t vs1);
+    void execVfdiv_vf(uint32_t vd, uint32_t vs2, int32_t rs1);
+    void execVfrdiv_vf(uint32_t vd, uint32_t vs2, int32_t rs1);
+    void execVfmacc_vv(uint32_t vd, uint32_t vs2, int32_t vs1);
+    void execVfmacc_vf(uint32_t vd, uint32_t vs2, int32_t rs1);
+    void execVfredusum_vs(uint32_t vd, uint32_t vs2, int32_t vs1);
+    void execVfredosum_vs(uint32_t vd, uint32_t vs2, int32_t vs1);
+    void execVfmv_f_s(uint32_t rd, uint32_t vs2, int32_t);
+    void execVfmv_s_f(uint32_t vd, uint32_t rs1, int32_t);
+    void execVfmv_v_f(uint32_t vd, uint32_t rs1, int32_t);
+
+    // bit manipulation
+    void execSh1add(uint32_t rd, uint32_t rs1, int32_t rs2);
+    void execSh2add(uint32_t rd, uint32_t rs1, int32_t rs2);
+    void execSh3add(uint32_t rd, uint32_t rs1, int32_t rs2);
+    void execAdd_uw(uint32_t rd, uint32_t rs1, int32_t rs2);
+    void execSh1add_uw(uint32_t rd, uint32_t rs1, int32_t rs2);
+    void execSh2add_uw(uint32_t rd, uint32_t rs1, int32_t rs2);
+    void execSh3add_uw(uint32_t rd, uint32_t rs1, int32_t rs2);
+    void execSlli_uw(uint32_t rd, uint32_t rs1, int32_t amount);
+
+    void execAndn(uint32_t rd, uint32_t rs1, int32_t rs2);
+    void execOrn(uint32_t rd, uint32_t rs1, int32_t rs2);
+    void execXnor(uint32_t rd, uint32_t rs1, int32_t rs2);
+    void execClz(uint32_t rd, uint32_t rs1, int32_t);
+    void execCtz(uint32_t rd, uint32_t rs1, int32_t);
+    void execCpop(uint32_t rd, uint32_t rs1, int32_t);
+    void execClzw(uint32_t rd, uint32_t rs1, int32_t);
+    void execCtzw(uint32_t rd, uint32_t rs1, int32_t);
+    void execCpopw(uint32_t rd, uint32_t rs1, int32_t);
+    void execMax(uint32_t rd, uint32_t rs1, int32_t rs2);
+    void execMaxu(uint32_t rd, uint32_t rs1, int32_t rs2);
+    void execMin(uint32_t rd, uint32_t rs1, int32_t rs2);
+    void execMinu(uint32_t rd, uint32_t rs1, int32_t rs2);
+    void execSext_b(uint32_t rd, uint32_t rs1, int32_t);
+    void execSext_h(uint32_t rd, uint32_t rs1, int32_t);
+    void execZext_h(uint32_t rd, uint32_t rs1, int32_t);
+    void execZext_h_64(uint32_t rd, uint32_t rs1, int32_t);
+    void execRol(uint32_t rd, uint32_t rs1, int32_t rs2);
+    void execRor(uint32_t rd, uint32_t rs1, int32_t rs2);
+    void execRori(uint32_t rd, uint32_t rs1, int32_t amount);
+    void execRolw(uint32_t rd, uint32_t rs1, int32_t rs2);
+    void execRorw(uint32_t rd, uint32_t rs1, int32_t rs2);
+    void execRoriw(uint32_t rd, uint32_t rs1, int32_t amount);
+    void execOrc_b(uint32_t rd, uint32_t rs1, int32_t);
+    void execRev8(uint32_t rd, uint32_t rs1, int32_t);
+    void execRev8_64(uint32_t rd, uint32_t rs1, int32_t);
+
+    void execBclr(uint32_t rd, uint32_t rs1, int32_t rs2);
+    void execBclri(uint32_t rd, uint32_t rs1, int32_t amount);
+    void execBext(uint32_t rd, uint32_t rs1, int32_t rs2);
+    void execBexti(uint32_t rd, uint32_t rs1, int32_t amount);
+    void execBinv(uint32_t rd, uint32_t rs1, int32_t rs2);
+    void execBinvi(uint32_t rd, uint32_t rs1, int32_t amount);
+    void execBset(uint32_t rd, uint32_t rs1, int32_t rs2);
+    void execBseti(uint32_t rd, uint32_t rs1, int32_t amount);
+
 
   private:
 
@@ -1246,6 +1945,8 @@ namespace WdRiscv
     IntRegs<URV> intRegs_;       // Integer register file.
     CsRegs<URV> csRegs_;         // Control and status registers.
     FpRegs<double> fpRegs_;      // Floating point registers.
+    VecRegs vecRegs_;            // Vector registers.
+    Syscall<URV> syscall_;       // Newlib/Linux system call emulation.
     bool rv64_ = sizeof(URV)==8; // True if 64-bit base (RV64I).
     bool rva_ = false;           // True if extension A (atomic) enabled.
     bool rvc_ = true;            // True if extension C (compressed) enabled.
@@ -1254,6 +1955,60 @@ namespace WdRiscv
     bool rvm_ = true;            // True if extension M (mul/div) enabled.
     bool rvs_ = false;           // True if extension S (supervisor-mode) enabled.
     bool rvu_ = false;           // True if extension U (user-mode) enabled.
+    bool rvb_ = false;           // True if extension B (bit manipulation) enabled.
+    bool rvv_ = false;           // True if extension V (vector) enabled.
+
+    URV vstart_ = 0;             // Tied to VSTART CSR.
+    URV vl_ = 0;                 // Tied to VL CSR.
+    URV vtype_ = 0;              // Tied to VTYPE CSR.
+    bool vecMasked_ = false;     // True if vector inst is masked (vm=0).
+
+    // Pre-decoded compressed instruction: execute16, decode16, and
+    // expandInst index compressedTable_ by the 16-bit code.
+    struct Compressed16
+    {
+      uint32_t op1 = 0;
+      int32_t op2 = 0;
+      uint32_t code32 = 0;   // Equivalent 32-bit code, 0 if none.
+      uint16_t id = 0;       // InstId: index into execTable_.
+      uint8_t op0 = 0;
+    };
+
+    // Decoded 32-bit instruction: execute32 and decode keep recently
+    // decoded codes in decodeCache_ (direct mapped, indexed by a hash
+    // of the code) to avoid walking the decode tree.
+    struct Decoded32
+    {
+      uint32_t code = 0;     // Zero (a 16-bit code) marks an empty entry.
+      uint32_t op1 = 0;
+      int32_t op2 = 0;
+      uint16_t id = 0;       // InstId: index into execTable_.
+      uint8_t op0 = 0;
+      bool hasFields = false; // True if fp/atomic: See execute32.
+    };
+
+    typedef void (Core<URV>::*ExecFunc)(uint32_t, uint32_t, int32_t);
+
+    std::vector<Decoded32> decodeCache_;
+
+    /// Return the decoded form of the given 32-bit instruction code
+    /// looking it up in decodeCache_ and filling the cache entry on a
+    /// miss.
+    const Decoded32& decode32(uint32_t inst)
+    {
+      Decoded32& entry = decodeCache_[(inst * 0x9e3779b1u) >> 20];
+      if (entry.code != inst)
+	fillDecodeCache(entry, inst);
+      return entry;
+    }
+
+    /// Helper to decode32: Decode given code into given cache entry.
+    void fillDecodeCache(Decoded32& entry, uint32_t inst);
+
+
+    std::vector<Compressed16> compressedTable_;
+    std::vector<ExecFunc> execTable_;       // Execute method by InstId.
+    unsigned decodeTableKey_ = ~0u;         // Extensions of tables.
     URV pc_ = 0;                 // Program counter. Incremented by instr fetch.
     URV currPc_ = 0;             // Addr instr being executed (pc_ before fetch).
     URV resetPc_ = 0;            // Pc to use on reset.
@@ -1263,12 +2018,15 @@ namespace WdRiscv
     bool toHostValid_ = false;   // True if toHost_ is valid.
     URV conIo_ = 0;              // Writing a byte to this writes to console.
     bool conIoValid_ = false;    // True if conIo_ is valid.
-    URV progBreak_ = 0;          // For brk Linux emulation.
 
     URV nmiPc_ = 0;              // Non-maskable interrupt handler address.
     bool nmiPending_ = false;
     NmiCause nmiCause_ = NmiCause::UNKNOWN;
 
+    // Set when an interrupt may have become pending: Run loops only
+    // call processExternalInterrupt when this is set.
+    bool pendingEvent_ = true;
+
     // These should be cleared before each instruction when triggers enabled.
     bool ldStException_ = 0;     // True if there is a load/store exception.
     bool csrException_ = 0;      // True if there is a CSR related exception.
@@ -1284,6 +2042,9 @@ namespace WdRiscv
     uint64_t cycleCount_ = 0;    // Proxy for mcycle CSR.
     uint64_t counter_ = 0;       // Retired instruction count.
     uint64_t instCountLim_ = ~uint64_t(0);
+    uint64_t windowBegin_ = 0;   // Instructions executed before window.
+    uint64_t windowEnd_ = ~uint64_t(0);  // Last instruction of window.
+    bool hasWindow_ = false;     // True if trace window defined.
     uint64_t exceptionCount_ = 0;
     uint64_t interruptCount_ = 0;
     uint64_t consecutiveIllegalCount_ = 0;
@@ -1294,13 +2055,25 @@ namespace WdRiscv
     URV forceFetchFailOffset_ = 0;
 
     bool instFreq_ = false;         // Collection instruction frequencies.
+    bool instMix_ = false;          // Collect instruction type counts.
+    std::vector<uint64_t> instTypeCounts_;  // Indexed by InstType.
     bool enableCounters_ = false;   // Enable performance monitors.
     bool prevCountersCsrOn_ = true;
     bool countersCsrOn_ = true;     // True when counters CSR is set to 1.
     bool enableTriggers_ = false;   // Enable debug triggers.
     bool enableGdb_ = false;        // Enable gdb mode.
+    AddressSet<URV> breakpoints_;   // Instruction addresses to stop at.
+    AddressSet<URV> readWatch_;     // Data addresses to stop after load.
+    AddressSet<URV> writeWatch_;    // Data addresses to stop after store.
+    std::atomic<bool> breakCheck_ = false;  // See updateBreakCheck.
+    std::atomic<bool> gdbStopRequest_ = false;  // See requestGdbStop.
+    bool watchCheck_ = false;       // Watchpoints defined.
+    bool watchHit_ = false;         // Last instruction hit a watchpoint.
+    bool watchHitLoad_ = false;     // Watchpoint hit by load (not store).
+    URV watchHitAddr_ = 0;          // Data address of watchpoint hit.
     bool abiNames_ = false;         // Use ABI register names when true.
     bool newlib_ = false;           // Enable newlib system calls.
+    bool semihosting_ = false;      // Enable semihosting requests.
 
     bool traceLoad_ = false;        // Trace addr of load inst if true.
     URV loadAddr_ = 0;              // Address of data of most recent load inst.
@@ -1327,19 +2100,33 @@ namespace WdRiscv
     bool loadErrorRollback_ = false;
     bool targetProgFinished_ = false;
     unsigned mxlen_ = 8*sizeof(URV);
-    FILE* consoleOut_ = nullptr;
+    Console console_;            // Console io device (see setConsoleIo).
 
     // FP instructions have additional operands besides rd, rs1, rs2 and imm.
     // We pass them in here.
     RoundingMode instRoundingMode_ = RoundingMode::NearestEven;
     unsigned instRs3_ = 0;
 
+    bool lazyFpEnv_ = false;  // See enableLazyFpEnv.
+    bool softFloat_ = false;  // See enableSoftFloat.
+    RoundingMode hostRoundingMode_ = RoundingMode::Invalid1; // Lazy mode.
+    int prevHostRoundingMode_ = FE_TONEAREST;  // Restored on lazy exit.
+
     // AMO instructions have additional operands: rl and aq.
     bool amoAq_ = false;
     bool amoRl_ = false;
 
     InstInfoTable instTable_;
     std::vector<InstProfile> instProfileVec_; // Instruction frequency
+    BasicBlockVectors<URV> bbv_;  // SimPoint basic block vectors.
+    TimingModel<URV> timing_;     // Pipeline timing model.
+    BranchPredictor<URV> predictor_;  // Branch predictor model.
+    MemoryTrace memTrace_;        // Binary memory access trace.
+    PageProfile pageProfile_;     // Per page access counts/working set.
+    CacheModel icache_;           // Instruction cache model.
+    CacheModel dcache_;           // Data cache model.
+    bool icacheHit_ = false;      // Last fetch hit in icache_.
+    bool dcacheHit_ = false;      // Last load/store hit in dcache_.
 
     // Ith entry is true if ith region has iccm/dccm/pic.
     std::vector<bool> regionHasLocalMem_;
@@ -459,6 +459,214 @@ applyTriggerConfig(Core<URV>& core, const nlohmann::json& config)
 }
 
 
+template <typename URV>
+static
+bool
+applyTimingConfig(Core<URV>& core, const nlohmann::json& config)
+{
+  if (not config.count("timing_model"))
+    return true;  // Nothing to apply
+
+  const auto& timing = config.at("timing_model");
+  if (not timing.is_object())
+    {
+      std::cerr << "Invalid timing_model entry in config file (expecting an object)\n";
+      return false;
+    }
+
+  TimingParams params;
+  std::vector<std::pair<const char*, unsigned*>> fields = {
+    { "issue_width",             &params.issueWidth_ },
+    { "load_latency",            &params.loadLatency_ },
+    { "external_load_latency",   &params.externalLoadLatency_ },
+    { "mul_latency",             &params.mulLatency_ },
+    { "div_latency",             &params.divLatency_ },
+    { "fp_latency",              &params.fpLatency_ },
+    { "branch_penalty",          &params.branchPenalty_ },
+    { "fetch_block",             &params.fetchBlock_ },
+    { "fetch_buffer_blocks",     &params.fetchBufferBlocks_ },
+    { "external_fetch_latency",  &params.externalFetchLatency_ },
+    { "external_fetch_interval", &params.externalFetchInterval_ } };
+
+  for (const auto& field : fields)
+    if (timing.count(field.first))
+      {
+	std::string tag = std::string("timing_model.") + field.first;
+	*field.second = getJsonUnsigned(tag, timing.at(field.first));
+      }
+
+  unsigned block = params.fetchBlock_;
+  if (block == 0 or (block & (block - 1)) != 0)
+    {
+      std::cerr << "Config file timing_model.fetch_block (" << block
+		<< ") must be a power of 2\n";
+      return false;
+    }
+
+  core.configTimingModel(params);
+
+  if (timing.count("enable"))
+    core.enableTimingModel(getJsonBoolean("timing_model.enable",
+					  timing.at("enable")));
+
+  return true;
+}
+
+
+template <typename URV>
+static
+bool
+applyPredictorConfig(Core<URV>& core, const nlohmann::json& config)
+{
+  std::string tag = "branch_predictor";
+  if (not config.count(tag))
+    return true;  // Nothing to apply
+
+  const auto& bp = config.at(tag);
+  if (not bp.is_object())
+    {
+      std::cerr << "Invalid " << tag << " entry in config file (expecting an object)\n";
+      return false;
+    }
+
+  PredictorParams params;
+
+  if (bp.count("type"))
+    {
+      std::string type = bp.at("type").get<std::string>();
+      if (type == "static")
+	params.type_ = PredictorParams::Type::Static;
+      else if (type == "bimodal")
+	params.type_ = PredictorParams::Type::Bimodal;
+      else if (type == "gshare")
+	params.type_ = PredictorParams::Type::Gshare;
+      else if (type == "swerv")
+	params.type_ = PredictorParams::Type::Btb;
+      else
+	{
+	  std::cerr << "Config file " << tag << ".type: Invalid value '" << type
+		    << "' (expecting static, bimodal, gshare or swerv)\n";
+	  return false;
+	}
+    }
+
+  std::vector<std::pair<const char*, unsigned*>> fields = {
+    { "bht_entries",  &params.bhtEntries_ },
+    { "history_bits", &params.historyBits_ },
+    { "btb_entries",  &params.btbEntries_ },
+    { "ras_size",     &params.rasSize_ } };
+
+  for (const auto& field : fields)
+    if (bp.count(field.first))
+      *field.second = getJsonUnsigned(tag + "." + field.first,
+				      bp.at(field.first));
+
+  for (unsigned entries : { params.bhtEntries_, params.btbEntries_ })
+    if (entries == 0 or (entries & (entries - 1)) != 0)
+      {
+	std::cerr << "Config file " << tag << ": Table size (" << entries
+		  << ") must be a power of 2\n";
+	return false;
+      }
+
+  core.configBranchPredictor(params);
+
+  bool enable = true;
+  if (bp.count("enable"))
+    enable = getJsonBoolean(tag + ".enable", bp.at("enable"));
+  core.enableBranchPredictor(enable);
+
+  return true;
+}
+
+
+template <typename URV>
+static
+bool
+applyCacheConfig(Core<URV>& core, const nlohmann::json& config,
+		 const std::string& tag)
+{
+  if (not config.count(tag))
+    return true;  // Nothing to apply
+
+  const auto& cache = config.at(tag);
+  if (not cache.is_object())
+    {
+      std::cerr << "Invalid " << tag << " entry in config file (expecting an object)\n";
+      return false;
+    }
+
+  unsigned errors = 0;
+  CacheParams params;
+
+  if (cache.count("size"))
+    params.size_ = getJsonUnsigned(tag + ".size", cache.at("size"));
+  if (cache.count("ways"))
+    params.ways_ = getJsonUnsigned(tag + ".ways", cache.at("ways"));
+  if (cache.count("line_size"))
+    params.lineSize_ = getJsonUnsigned(tag + ".line_size", cache.at("line_size"));
+  if (cache.count("miss_penalty"))
+    params.missPenalty_ = getJsonUnsigned(tag + ".miss_penalty",
+					  cache.at("miss_penalty"));
+
+  if (cache.count("replacement"))
+    {
+      std::string policy = cache.at("replacement").get<std::string>();
+      if (policy == "lru")
+	params.replacement_ = CacheParams::Replacement::Lru;
+      else if (policy == "fifo")
+	params.replacement_ = CacheParams::Replacement::Fifo;
+      else if (policy == "random")
+	params.replacement_ = CacheParams::Replacement::Random;
+      else
+	{
+	  std::cerr << "Config file " << tag << ".replacement: Invalid value '"
+		    << policy << "' (expecting lru, fifo or random)\n";
+	  errors++;
+	}
+    }
+
+  if (cache.count("write_policy"))
+    {
+      std::string policy = cache.at("write_policy").get<std::string>();
+      if (policy == "write_back")
+	params.writeBack_ = true;
+      else if (policy == "write_through")
+	params.writeBack_ = false;
+      else
+	{
+	  std::cerr << "Config file " << tag << ".write_policy: Invalid value '"
+		    << policy << "' (expecting write_back or write_through)\n";
+	  errors++;
+	}
+    }
+
+  bool enable = true;
+  if (cache.count("enable"))
+    enable = getJsonBoolean(tag + ".enable", cache.at("enable"));
+
+  bool isData = tag == "dcache";
+  bool ok = isData? core.configDataCache(params) : core.configInstCache(params);
+  if (not ok)
+    {
+      std::cerr << "Config file " << tag << ": Invalid geometry (size="
+		<< params.size_ << " ways=" << params.ways_ << " line_size="
+		<< params.lineSize_ << "): line size and number of sets must "
+		<< "be powers of 2\n";
+      errors++;
+    }
+  else if (not enable)
+    {
+      if (isData)
+	core.disableDataCache();
+      else
+	core.disableInstCache();
+    }
+
+  return errors == 0;
+}
+
+
 template<typename URV>
 bool
 CoreConfig::applyConfig(Core<URV>& core, bool verbose) const
@@ -605,6 +813,14 @@ CoreConfig::applyConfig(Core<URV>& core, bool verbose) const
       core.configMachineModeMaxPerfEvent(maxId);
     }
 
+  tag = "vlen";
+  if (config_ -> count(tag))
+    {
+      unsigned vlen = getJsonUnsigned(tag, config_ -> at(tag));
+      if (not core.configVectorLength(vlen))
+	errors++;
+    }
+
   if (not applyCsrConfig(core, *config_, verbose))
     errors++;
 
@@ -614,6 +830,18 @@ CoreConfig::applyConfig(Core<URV>& core, bool verbose) const
   if (not applyTriggerConfig(core, *config_))
     errors++;
 
+  if (not applyTimingConfig(core, *config_))
+    errors++;
+
+  if (not applyPredictorConfig(core, *config_))
+    errors++;
+
+  if (not applyCacheConfig(core, *config_, "icache"))
+    errors++;
+
+  if (not applyCacheConfig(core, *config_, "dcache"))
+    errors++;
+
   core.finishMemoryConfig();
 
   return errors == 0;
@@ -31,6 +31,7 @@ CsRegs<URV>::CsRegs()
   // Allocate CSR vector.  All entries are invalid.
   regs_.clear();
   regs_.resize(size_t(CsrNumber::MAX_CSR_) + 1);
+  access_.resize(regs_.size());
 
   // Define CSR entries.
   defineMachineRegs();
@@ -80,12 +81,88 @@ CsRegs<URV>::defineCsr(const std::string& name, CsrNumber csrn, bool mandatory,
 
   csr.config(name, csrn, mandatory, implemented, resetValue, writeMask,
 	     pokeMask, isDebug);
+  updateCsrAccess(csrn);
 
   nameToNumber_[name] = csrn;
   return &csr;
 }
 
 
+/// Return true if reading/writing the given CSR has side effects
+/// (implemented in the read/write methods of CsRegs or in the CSR
+/// instructions of the core) or if the CSR is not backed by a plain
+/// value.
+static bool
+csrHasSideEffects(CsrNumber num)
+{
+  if (num <= CsrNumber::FCSR)
+    return true;  // FFLAGS, FRM, and FCSR are views of one another.
+  if (num == CsrNumber::VXSAT or num == CsrNumber::VXRM or
+      num == CsrNumber::VCSR)
+    return true;  // VXSAT, VXRM, and VCSR are views of one another.
+  if (num >= CsrNumber::TDATA1 and num <= CsrNumber::TDATA3)
+    return true;  // Triggers.
+  if (num >= CsrNumber::MHPMEVENT3 and num <= CsrNumber::MHPMEVENT31)
+    return true;  // Event assignment.
+
+  switch (num)
+    {
+    case CsrNumber::MSTATUS:
+    case CsrNumber::MIE:
+    case CsrNumber::MIP:
+    case CsrNumber::MRAC:
+    case CsrNumber::MDEAU:
+    case CsrNumber::MEIVT:
+    case CsrNumber::MEIHAP:
+    case CsrNumber::DCSR:
+    case CsrNumber::MGPMC:
+    case CsrNumber::MINSTRET:
+    case CsrNumber::MINSTRETH:
+    case CsrNumber::MCYCLE:
+    case CsrNumber::MCYCLEH:
+      return true;
+    default:
+      return false;
+    }
+}
+
+
+template <typename URV>
+void
+CsRegs<URV>::updateCsrAccess(CsrNumber number)
+{
+  size_t ix = size_t(number);
+  if (ix >= access_.size())
+    return;
+
+  CsrAccess& acc = access_.at(ix);
+  acc = CsrAccess();
+
+  Csr<URV>& csr = regs_.at(ix);
+  if (not csr.isImplemented())
+    return;
+
+  acc.csr = &csr;
+  acc.plain = not csrHasSideEffects(number);
+
+  for (unsigned m = 0; m < 4; ++m)
+    {
+      PrivilegeMode mode = PrivilegeMode(m);
+      if (mode < csr.privilegeMode())
+	continue;
+      for (bool debug : { false, true })
+	{
+	  if (csr.isDebug() and not debug)
+	    continue;
+	  unsigned bit = accessBit(mode, debug);
+	  acc.readable |= uint8_t(1 << bit);
+	  if (not csr.isReadOnly())
+	    acc.writable |= uint8_t(1 << bit);
+	}
+    }
+}
+
+
 template <typename URV>
 const Csr<URV>*
 CsRegs<URV>::findCsr(const std::string& name) const
@@ -160,6 +237,16 @@ CsRegs<URV>::write(CsrNumber number, PrivilegeMode mode, bool debugMode,
       return true;
     }
 
+  // vxsat and vxrm are part of vcsr
+  if (number == CsrNumber::VXSAT or number == CsrNumber::VXRM or
+      number == CsrNumber::VCSR)
+    {
+      csr->write(value);
+      recordWrite(number);
+      updateVcsrGroupForWrite(number, value);
+      return true;
+    }
+
   if (number >= CsrNumber::TDATA1 and number <= CsrNumber::TDATA3)
     {
       if (not writeTdata(number, mode, debugMode, value))
@@ -192,12 +279,7 @@ CsRegs<URV>::write(CsrNumber number, PrivilegeMode mode, bool debugMode,
   csr->write(value);
   recordWrite(number);
 
-  // Cache interrupt enable.
-  if (number == CsrNumber::MSTATUS)
-    {
-      MstatusFields<URV> fields(csr->read());
-      interruptEnable_ = fields.bits_.MIE;
-    }
+  updateInterruptState(number);
 
   // Writing MDEAU unlocks mdseac.
   if (number == CsrNumber::MDEAU)
@@ -251,18 +333,32 @@ CsRegs<URV>::reset()
 
   triggers_.reset();
 
-  // Cache interrupt enable.
-  Csr<URV>* mstatus = getImplementedCsr(CsrNumber::MSTATUS);
-  if (mstatus)
-    {
-      MstatusFields<URV> fields(mstatus->read());
-      interruptEnable_ = fields.bits_.MIE;
-    }
+  updateInterruptState(CsrNumber::MSTATUS);
 
   mdseacLocked_ = false;
 }
 
 
+template <typename URV>
+void
+CsRegs<URV>::updateInterruptState(CsrNumber number)
+{
+  if (number == CsrNumber::MSTATUS)
+    {
+      // Cache interrupt enable.
+      Csr<URV>* mstatus = getImplementedCsr(CsrNumber::MSTATUS);
+      if (mstatus)
+	{
+	  MstatusFields<URV> fields(mstatus->read());
+	  interruptEnable_ = fields.bits_.MIE;
+	}
+      signalInterruptEvent();
+    }
+  else if (number == CsrNumber::MIE or number == CsrNumber::MIP)
+    signalInterruptEvent();
+}
+
+
 template <typename URV>
 bool
 CsRegs<URV>::configCsr(const std::string& name, bool implemented,
@@ -307,13 +403,9 @@ CsRegs<URV>::configCsr(CsrNumber csrNum, bool implemented,
   csr.setPokeMask(pokeMask);
   csr.pokeNoMask(resetValue);
   csr.setIsDebug(isDebug);
+  updateCsrAccess(csrNum);
 
-  // Cahche interrupt enable.
-  if (csrNum == CsrNumber::MSTATUS)
-    {
-      MstatusFields<URV> fields(csr.read());
-      interruptEnable_ = fields.bits_.MIE;
-    }
+  updateInterruptState(csrNum);
 
   return true;
 }
@@ -459,16 +551,109 @@ CsRegs<URV>::updateFcsrGroupForPoke(CsrNumber number, URV value)
 }
 
 
+template <typename URV>
+void
+CsRegs<URV>::updateVcsrGroupForWrite(CsrNumber number, URV value)
+{
+  if (number == CsrNumber::VXSAT or number == CsrNumber::VXRM)
+    {
+      auto vcsr = getImplementedCsr(CsrNumber::VCSR);
+      if (vcsr)
+	{
+	  URV vcsrVal = vcsr->read();
+	  if (number == CsrNumber::VXSAT)
+	    vcsrVal = (vcsrVal & ~URV(1)) | (value & 1);
+	  else
+	    vcsrVal = (vcsrVal & ~URV(6)) | ((value << 1) & 6);
+	  vcsr->write(vcsrVal);
+	  recordWrite(CsrNumber::VCSR);
+	}
+      return;
+    }
+
+  if (number == CsrNumber::VCSR)
+    {
+      URV newVal = value & 1;  // New vxsat value
+      auto vxsat = getImplementedCsr(CsrNumber::VXSAT);
+      if (vxsat and vxsat->read() != newVal)
+	{
+	  vxsat->write(newVal);
+	  recordWrite(CsrNumber::VXSAT);
+	}
+
+      newVal = (value >> 1) & 3;
+      auto vxrm = getImplementedCsr(CsrNumber::VXRM);
+      if (vxrm and vxrm->read() != newVal)
+	{
+	  vxrm->write(newVal);
+	  recordWrite(CsrNumber::VXRM);
+	}
+    }
+}
+
+
+template <typename URV>
+void
+CsRegs<URV>::updateVcsrGroupForPoke(CsrNumber number, URV value)
+{
+  if (number == CsrNumber::VXSAT or number == CsrNumber::VXRM)
+    {
+      auto vcsr = getImplementedCsr(CsrNumber::VCSR);
+      if (vcsr)
+	{
+	  URV vcsrVal = vcsr->read();
+	  if (number == CsrNumber::VXSAT)
+	    vcsrVal = (vcsrVal & ~URV(1)) | (value & 1);
+	  else
+	    vcsrVal = (vcsrVal & ~URV(6)) | ((value << 1) & 6);
+	  vcsr->poke(vcsrVal);
+	}
+      return;
+    }
+
+  if (number == CsrNumber::VCSR)
+    {
+      URV newVal = value & 1;  // New vxsat value
+      auto vxsat = getImplementedCsr(CsrNumber::VXSAT);
+      if (vxsat and vxsat->read() != newVal)
+	vxsat->poke(newVal);
+
+      newVal = (value >> 1) & 3;
+      auto vxrm = getImplementedCsr(CsrNumber::VXRM);
+      if (vxrm and vxrm->read() != newVal)
+	vxrm->poke(newVal);
+    }
+}
+
+
 template <typename URV>
 void
 CsRegs<URV>::recordWrite(CsrNumber num)
 {
+  if (not recordWrites_)
+    return;
+
   auto& lwr = lastWrittenRegs_;
   if (std::find(lwr.begin(), lwr.end(), num) == lwr.end())
     lwr.push_back(num);
 }
 
 
+template <typename URV>
+void
+CsRegs<URV>::enableRecordWrites(bool flag)
+{
+  if (flag and not recordWrites_)
+    {
+      // Previous values remembered while not recording are stale.
+      for (auto& csr : regs_)
+	csr.clearLastWritten();
+      lastWrittenRegs_.clear();
+    }
+  recordWrites_ = flag;
+}
+
+
 template <typename URV>
 void
 CsRegs<URV>::defineMachineRegs()
@@ -682,6 +867,17 @@ CsRegs<URV>::defineUserRegs()
   defineCsr("frm",      Csrn::FRM,      !mand, !imp, 0, wam, wam);
   defineCsr("fcsr",     Csrn::FCSR,     !mand, !imp, 0, 0xff, 0xff);
 
+  // User Vector CSRs. Vl, vtype and vlenb are read-only: They are
+  // changed by the vsetvl instructions (and configuration).
+  URV vill = URV(1) << (8*sizeof(URV) - 1);
+  defineCsr("vstart",   Csrn::VSTART,   !mand, !imp, 0, wam, wam);
+  defineCsr("vxsat",    Csrn::VXSAT,    !mand, !imp, 0, 1, 1);
+  defineCsr("vxrm",     Csrn::VXRM,     !mand, !imp, 0, 3, 3);
+  defineCsr("vcsr",     Csrn::VCSR,     !mand, !imp, 0, 7, 7);
+  defineCsr("vl",       Csrn::VL,       !mand, !imp, 0, wam, wam);
+  defineCsr("vtype",    Csrn::VTYPE,    !mand, !imp, vill, wam, wam);
+  defineCsr("vlenb",    Csrn::VLENB,    !mand, !imp, 0, 0, 0);
+
   // User Counter/Timers
   defineCsr("cycle",    Csrn::CYCLE,    !mand, imp,  0, wam, wam);
   defineCsr("time",     Csrn::TIME,     !mand, imp,  0, wam, wam);
@@ -857,6 +1053,15 @@ CsRegs<URV>::poke(CsrNumber number, URV value)
       return true;
     }
 
+  // vxsat and vxrm are parts of vcsr
+  if (number == CsrNumber::VXSAT or number == CsrNumber::VXRM or
+      number == CsrNumber::VCSR)
+    {
+      csr->poke(value);
+      updateVcsrGroupForPoke(number, value);
+      return true;
+    }
+
   if (number >= CsrNumber::TDATA1 and number <= CsrNumber::TDATA3)
     return pokeTdata(number, value);
 
@@ -883,12 +1088,7 @@ CsRegs<URV>::poke(CsrNumber number, URV value)
 
   csr->poke(value);
 
-  // Cache interrupt enable.
-  if (number == CsrNumber::MSTATUS)
-    {
-      MstatusFields<URV> fields(csr->read());
-      interruptEnable_ = fields.bits_.MIE;
-    }
+  updateInterruptState(number);
 
   return true;
 }
@@ -263,6 +263,15 @@ namespace WdRiscv
       FRM = 0x002,
       FCSR = 0x003,
 
+      // User Vector CSRs
+      VSTART = 0x008,
+      VXSAT = 0x009,
+      VXRM = 0x00a,
+      VCSR = 0x00f,
+      VL = 0xc20,
+      VTYPE = 0xc21,
+      VLENB = 0xc22,
+
       // User Counter/Timers
       CYCLE = 0xc00,
       TIME = 0xc01,
@@ -799,6 +808,14 @@ namespace WdRiscv
     /// Update fcsr after frm/fflags is poked.
     void updateFcsrGroupForPoke(CsrNumber number, URV value);
 
+    /// Helper to write method. Update vxrm/vxsat after vcsr is
+    /// written. Update vcsr after vxrm/vxsat is written.
+    void updateVcsrGroupForWrite(CsrNumber number, URV value);
+
+    /// Helper to poke method. Update vxrm/vxsat after vcsr is
+    /// poked. Update vcsr after vxrm/vxsat is poked.
+    void updateVcsrGroupForPoke(CsrNumber number, URV value);
+
     /// Helper to construtor. Define machine-mode CSRs
     void defineMachineRegs();
 
@@ -872,6 +889,63 @@ namespace WdRiscv
     /// when incrementing performance counters.
     void tieMachinePerfCounters(std::vector<uint64_t>& counters);
 
+    /// Tie the given flag to the interrupt state of this register
+    /// file: The flag is set whenever MSTATUS, MIE or MIP is written
+    /// or poked so that the run loop of the core only needs to check
+    /// for interrupts when the flag is set.
+    void tieInterruptEvent(bool* flag)
+    { interruptEvent_ = flag; }
+
+    /// Set the flag tied by tieInterruptEvent (if any).
+    void signalInterruptEvent()
+    { if (interruptEvent_) *interruptEvent_ = true; }
+
+    /// Called after the given CSR is written/poked: Update the cached
+    /// MSTATUS MIE bit and signal a possible change in interrupt state.
+    void updateInterruptState(CsrNumber number);
+
+    /// Enable/disable the recording of written CSRs (see
+    /// getLastWrittenRegs). Recording is only needed for tracing,
+    /// triggers, performance counters and server mode. It is enabled
+    /// by default.
+    void enableRecordWrites(bool flag);
+
+    /// Return true if recording of written CSRs is enabled.
+    bool isRecordWritesEnabled() const
+    { return recordWrites_; }
+
+    /// Fast version of the read method for the CSR instructions:
+    /// Access checks are done using precomputed descriptors.
+    bool readFast(CsrNumber number, PrivilegeMode mode, bool debugMode,
+		  URV& value) const
+    {
+      const CsrAccess& acc = access_[size_t(number) & 0xfff];
+      if (not ((acc.readable >> accessBit(mode, debugMode)) & 1))
+	return false;
+      if (not acc.plain)
+	return read(number, mode, debugMode, value);
+      value = acc.csr->read();
+      return true;
+    }
+
+    /// Write the given value to the CSR of the given number if that
+    /// CSR has no side effects and is writable in the given mode.
+    /// Return true if written. Return false, writing nothing, if the
+    /// CSR requires the full write path (write method in here and
+    /// special cases in the core) or if it is not writable.
+    bool writePlain(CsrNumber number, PrivilegeMode mode, bool debugMode,
+		    URV value)
+    {
+      const CsrAccess& acc = access_[size_t(number) & 0xfff];
+      if (not acc.plain or
+	  not ((acc.writable >> accessBit(mode, debugMode)) & 1))
+	return false;
+      acc.csr->write(value);
+      if (recordWrites_)
+	recordWrite(number);
+      return true;
+    }
+
     /// Set the maximum performance counter event id. Ids larger than
     /// the max value are replaced by that max.
     void setMaxEventId(URV maxId)
@@ -891,6 +965,28 @@ namespace WdRiscv
     std::vector< Csr<URV> > regs_;
     std::unordered_map<std::string, CsrNumber> nameToNumber_;
 
+    /// Access descriptor of a CSR: Summarizes the implemented,
+    /// privilege, debug and read-only attributes of the CSR.
+    struct CsrAccess
+    {
+      Csr<URV>* csr = nullptr;  // Null if not implemented.
+      uint8_t readable = 0;     // Bit accessBit(mode, debug) set if readable.
+      uint8_t writable = 0;     // Bit accessBit(mode, debug) set if writable.
+      bool plain = false;       // True if no side effects on read/write.
+    };
+
+    /// Return the bit corresponding to the given mode in the readable
+    /// and writable fields of CsrAccess.
+    static unsigned accessBit(PrivilegeMode mode, bool debugMode)
+    { return unsigned(mode) + (debugMode? 4 : 0); }
+
+    /// Recompute the access descriptor of the given CSR. Must be
+    /// called whenever the attributes of that CSR are changed.
+    void updateCsrAccess(CsrNumber number);
+
+    // Indexed by CSR number.
+    std::vector<CsrAccess> access_;
+
     Triggers<URV> triggers_;
 
     // Register written since most recent clearLastWrittenRegs
@@ -900,6 +996,8 @@ namespace WdRiscv
     PerfRegs mPerfRegs_;
 
     bool interruptEnable_ = false;  // Cached MSTATUS MIE bit.
+    bool* interruptEvent_ = nullptr; // Set on MSTATUS/MIE/MIP change.
+    bool recordWrites_ = true;       // Record CSRs written (recordWrite).
 
     // These can be obtained from Triggers. Speed up access by caching
     // them in here.
@@ -21,6 +21,7 @@
 
 #include <cstdint>
 #include <cstddef>
+#include <cstring>
 #include <vector>
 #include <type_traits>
 
@@ -138,6 +139,56 @@ namespace WdRiscv
     /// the number if the register is 64-bit wide.
     void writeSingle(unsigned i, float x);
 
+    /// Return the bit pattern of the single precision number in the
+    /// ith register. If the register is 64-bit wide and is not
+    /// properly NAN-boxed, return the canonical NAN as required by the
+    /// RISCV spec.
+    uint32_t readSingleBits(unsigned i) const
+    {
+      if constexpr (sizeof(FRV) == 4)
+	{
+	  uint32_t bits = 0;
+	  memcpy(&bits, &regs_.at(i), sizeof(bits));
+	  return bits;
+	}
+      uint64_t bits = readDoubleBits(i);
+      if ((bits >> 32) != ~uint32_t(0))
+	return 0x7fc00000;  // Canonical NAN.
+      return uint32_t(bits);
+    }
+
+    /// Write the given single precision bit pattern into the ith
+    /// register. NAN-box the number if the register is 64-bit wide.
+    void writeSingleBits(unsigned i, uint32_t x)
+    {
+      FRV value = 0;
+      if constexpr (sizeof(FRV) == 4)
+	memcpy(&value, &x, sizeof(x));
+      else
+	{
+	  uint64_t bits = (uint64_t(~uint32_t(0)) << 32) | x;
+	  memcpy(&value, &bits, sizeof(bits));
+	}
+      write(i, value);
+    }
+
+    /// Return the bit pattern of the ith register (double precision).
+    uint64_t readDoubleBits(unsigned i) const
+    {
+      uint64_t bits = 0;
+      memcpy(&bits, &regs_.at(i), sizeof(FRV));
+      return bits;
+    }
+
+    /// Write the given double precision bit pattern into the ith
+    /// register.
+    void writeDoubleBits(unsigned i, uint64_t x)
+    {
+      FRV value = 0;
+      memcpy(&value, &x, sizeof(FRV));
+      write(i, value);
+    }
+
     /// Return the count of registers in this register file.
     size_t size() const
     { return regs_.size(); }
@@ -92,8 +92,44 @@ namespace WdRiscv
       c_srli64, c_srai, c_srai64, c_andi, c_sub, c_xor,
       c_or, c_and, c_subw, c_addw, c_j, c_beqz, c_bnez,
       c_slli, c_slli64, c_fldsp, c_lwsp, c_flwsp, c_ldsp, c_jr, c_mv,
-      c_ebreak, c_jalr, c_add, c_fsdsp, c_swsp, c_fswsp, c_sdsp = c_fswsp,
+      c_ebreak, c_jalr, c_add, c_fsdsp, c_swsp, c_fswsp, c_sdsp,
 
-      maxId = c_fswsp
+      // Vector configuration
+      vsetvli, vsetivli, vsetvl,
+
+      // Vector unit-stride load/store
+      vle8_v, vle16_v, vle32_v, vle64_v, vse8_v, vse16_v, vse32_v, vse64_v,
+
+      // Vector integer
+      vadd_vv, vadd_vx, vadd_vi, vsub_vv, vsub_vx, vrsub_vx, vrsub_vi,
+      vminu_vv, vminu_vx, vmin_vv, vmin_vx, vmaxu_vv, vmaxu_vx,
+      vmax_vv, vmax_vx, vand_vv, vand_vx, vand_vi, vor_vv, vor_vx, vor_vi,
+      vxor_vv, vxor_vx, vxor_vi, vsll_vv, vsll_vx, vsll_vi,
+      vsrl_vv, vsrl_vx, vsrl_vi, vsra_vv, vsra_vx, vsra_vi,
+      vmul_vv, vmul_vx, vmv_v_v, vmv_v_x, vmv_v_i, vmv_x_s, vmv_s_x,
+
+      // Vector integer reduction
+      vredsum_vs, vredand_vs, vredor_vs, vredxor_vs, vredminu_vs,
+      vredmin_vs, vredmaxu_vs, vredmax_vs,
+
+      // Vector floating point
+      vfadd_vv, vfadd_vf, vfsub_vv, vfsub_vf, vfrsub_vf, vfmul_vv, vfmul_vf,
+      vfdiv_vv, vfdiv_vf, vfrdiv_vf, vfmacc_vv, vfmacc_vf,
+      vfredusum_vs, vfredosum_vs, vfmv_f_s, vfmv_s_f, vfmv_v_f,
+
+      // Bit manipulation: Zba
+      sh1add, sh2add, sh3add, add_uw, sh1add_uw, sh2add_uw, sh3add_uw,
+      slli_uw,
+
+      // Bit manipulation: Zbb. The zext.h and rev8 encodings differ
+      // between rv32 and rv64.
+      andn, orn, xnor, clz, ctz, cpop, clzw, ctzw, cpopw,
+      max, maxu, min, minu, sext_b, sext_h, zext_h, zext_h_64,
+      rol, ror, rori, rolw, rorw, roriw, orc_b, rev8, rev8_64,
+
+      // Bit manipulation: Zbs
+      bclr, bclri, bext, bexti, binv, binvi, bset, bseti,
+
+      maxId = bseti
     };
 }
@@ -16,7 +16,10 @@
 // this program. If not, see <https://www.gnu.org/licenses/>.
 //
 
+#include <algorithm>
+#include <cassert>
 #include "InstInfo.hpp"
+#include "instforms.hpp"
 
 using namespace WdRiscv;
 
@@ -45,8 +48,15 @@ InstInfoTable::InstInfoTable()
 {
   setupInstVec();
 
+  // Entries are indexed by id: Decoders map a code to an entry and
+  // executors use the id of that entry.
+  for (size_t i = 0; i < instVec_.size(); ++i)
+    assert(size_t(instVec_.at(i).instId()) == i and "Inst table entry out of order");
+
+  // Names shared by the rv32 and rv64 encodings of an instruction
+  // (zext.h, rev8) map to the first entry.
   for (const auto& instInfo : instVec_)
-    instMap_[instInfo.name()] = instInfo.instId();
+    instMap_.emplace(instInfo.name(), instInfo.instId());
 
   // Mark instructions with unsigned source opreands.
   instVec_.at(size_t(InstId::bltu)).setIsUnsigned(true);
@@ -57,6 +67,8 @@ InstInfoTable::InstInfoTable()
   instVec_.at(size_t(InstId::mulhu)).setIsUnsigned(true);
   instVec_.at(size_t(InstId::divu)).setIsUnsigned(true);
   instVec_.at(size_t(InstId::remu)).setIsUnsigned(true);
+
+  setupDecodeTree();
 }
 
 
@@ -80,16 +92,148 @@ InstInfoTable::getInstInfo(const std::string& name) const
 }
 
 
+/// Return the value of an operand with the given form and mask in the
+/// given instruction code.
+static inline uint32_t
+operandValue(OperandForm form, uint32_t mask, uint32_t code)
+{
+  switch (form)
+    {
+    case OperandForm::Field: return (code & mask) >> __builtin_ctz(mask);
+    case OperandForm::ImmI:  return IFormInst(code).immed();
+    case OperandForm::ImmS:  return SFormInst(code).immed();
+    case OperandForm::ImmB:  return BFormInst(code).immed();
+    case OperandForm::ImmU:  return UFormInst(code).immed();
+    case OperandForm::ImmJ:  return JFormInst(code).immed();
+    default:                 return 0;
+    }
+}
+
+
+const InstInfo&
+InstInfoTable::decode(uint32_t code, uint32_t& op0, uint32_t& op1,
+		      int32_t& op2) const
+{
+  op0 = 0; op1 = 0; op2 = 0;
+
+  unsigned opcode = code & 0x7f;
+  int first = opcodeLeaves_[opcode];
+  if (first < 0)
+    return instVec_.front();
+
+  uint32_t keyBits = code & opcodeKeyMask_[opcode];
+  unsigned key = ((keyBits >> 12) & 7) | ((keyBits >> 22) & 0x3f8);
+  const auto& leaf = leaves_[first + key];
+
+  for (unsigned i = leaf.first; i < leaf.second; ++i)
+    {
+      const InstInfo& info = instVec_[size_t(candidates_[i])];
+      if ((code & info.codeMask_) != info.code_)
+	continue;
+      op0 = operandValue(info.op0Form_, info.op0Mask_, code);
+      op1 = operandValue(info.op1Form_, info.op1Mask_, code);
+      op2 = operandValue(info.op2Form_, info.op2Mask_, code);
+      return info;
+    }
+
+  return instVec_.front();
+}
+
+
+void
+InstInfoTable::setupOperandForms(InstInfo& info)
+{
+  unsigned opcode = info.code_ & 0x7f;
+
+  auto formOf = [&info, opcode](OperandType type, uint32_t mask) {
+    if (type == OperandType::None or mask == 0)
+      return OperandForm::None;
+    if (type != OperandType::Imm)
+      return OperandForm::Field;
+    if (mask == 0xfff00000)
+      return OperandForm::ImmI;
+    if (mask == 0xfe000f80)
+      return info.isBranch()? OperandForm::ImmB : OperandForm::ImmS;
+    if (mask == 0xfffff000)
+      return opcode == 0x6f? OperandForm::ImmJ : OperandForm::ImmU;
+    return OperandForm::Field;
+  };
+
+  info.op0Form_ = formOf(info.op0Type_, info.op0Mask_);
+  info.op1Form_ = formOf(info.op1Type_, info.op1Mask_);
+  info.op2Form_ = formOf(info.op2Type_, info.op2Mask_);
+}
+
+
+void
+InstInfoTable::setupDecodeTree()
+{
+  const unsigned opcodeCount = 128, keyCount = 1024;
+
+  // Collect the 32-bit instructions of each opcode. Operand bits of
+  // compressed instructions are swizzled: those are decoded by the
+  // core.
+  std::vector<std::vector<InstId>> byOpcode(opcodeCount);
+  for (auto& info : instVec_)
+    {
+      if (info.id_ == InstId::illegal or not isFullSizeInst(info.code_))
+	continue;
+      setupOperandForms(info);
+      byOpcode.at(info.code_ & 0x7f).push_back(info.id_);
+    }
+
+  opcodeKeyMask_.assign(opcodeCount, 0);
+  opcodeLeaves_.assign(opcodeCount, -1);
+  leaves_.clear();
+  candidates_.clear();
+
+  for (unsigned opcode = 0; opcode < opcodeCount; ++opcode)
+    {
+      auto& ids = byOpcode.at(opcode);
+      if (ids.empty())
+	continue;
+
+      // Most specific code mask first.
+      std::stable_sort(ids.begin(), ids.end(), [this](InstId a, InstId b) {
+	  return (__builtin_popcount(getInstInfo(a).codeMask()) >
+		  __builtin_popcount(getInstInfo(b).codeMask())); });
+
+      // Key on the funct3/funct7 bits that all instructions of this
+      // opcode specify.
+      uint32_t keyMask = 0xfe007000;
+      for (auto id : ids)
+	keyMask &= getInstInfo(id).codeMask();
+      opcodeKeyMask_.at(opcode) = keyMask;
+      opcodeLeaves_.at(opcode) = leaves_.size();
+
+      for (unsigned key = 0; key < keyCount; ++key)
+	{
+	  uint32_t keyBits = ((key & 7) << 12) | ((key >> 3) << 25);
+	  unsigned begin = candidates_.size();
+	  if ((keyBits & keyMask) == keyBits)
+	    for (auto id : ids)
+	      {
+		const InstInfo& info = getInstInfo(id);
+		if (((keyBits ^ info.code()) & keyMask) == 0)
+		  candidates_.push_back(id);
+	      }
+	  leaves_.push_back(std::make_pair(begin, unsigned(candidates_.size())));
+	}
+    }
+}
+
+
 void
 InstInfoTable::setupInstVec()
 {
   uint32_t rdMask = 0x1f << 7;
   uint32_t rs1Mask = 0x1f << 15;
   uint32_t rs2Mask = 0x1f << 20;
-  uint32_t immTop20 = 0xffff << 12;  // Immidiate: top 20 bits.
+  uint32_t immTop20 = 0xfffff << 12; // Immidiate: top 20 bits.
   uint32_t immTop12 = 0xfff << 20;   // Immidiate: top 12 bits.
   uint32_t immBeq = 0xfe000f80;
   uint32_t shamtMask = 0x01f00000;
+  uint32_t shamt6Mask = 0x03f00000;         // Shift amount of rv64 slli.
 
   uint32_t low7Mask = 0x7f;                 // Opcode mask: lowest 7 bits
   uint32_t funct3Low7Mask = 0x707f;         // Funct3 and lowest 7 bits
@@ -97,6 +241,14 @@ InstInfoTable::setupInstVec()
   uint32_t faddMask = 0xfe00007f;           // fadd-like opcode mask
   uint32_t fsqrtMask = 0xfff0007f;          // fsqrt-like opcode mask
   uint32_t top7Funct3Low7Mask = 0xfe00707f; // Top7, Funct3 and lowest 7 bits
+  uint32_t top6Funct3Low7Mask = 0xfc00707f; // Top6, Funct3 and lowest 7 bits
+  uint32_t vsetvliMask = 0x8000707f;        // Top bit, Funct3 and lowest 7 bits
+  uint32_t vsetivliMask = 0xc000707f;       // Top 2 bits, Funct3 and lowest 7
+  uint32_t vecOpMask = 0xfc00707f;          // Funct6, Funct3 and lowest 7 bits
+  uint32_t vecMvMask = 0xfff0707f;          // Vector op with vm=1 and vs2=0
+  uint32_t vecMvsMask = 0xfe0ff07f;         // Vector op with vm=1 and vs1=0
+  uint32_t vecLdStMask = 0xfdf0707f;        // Unit-stride: All but vm/rs1/vd
+  uint32_t top12Funct3Low7Mask = 0xfff0707f; // Top12, Funct3 and lowest 7 bits
 
   instVec_ =
     {
@@ -244,23 +396,23 @@ InstInfoTable::setupInstVec()
 	OperandType::IntReg, OperandMode::Read, rs1Mask,
 	OperandType::Imm, OperandMode::None, immTop12 },
 
-      { "slli", InstId::slli, 0x1013, top7Funct3Low7Mask,
+      { "slli", InstId::slli, 0x1013, top6Funct3Low7Mask,
 	InstType::Int,
 	OperandType::IntReg, OperandMode::Write, rdMask,
 	OperandType::IntReg, OperandMode::Read, rs1Mask,
-	OperandType::Imm, OperandMode::None, shamtMask },
+	OperandType::Imm, OperandMode::None, shamt6Mask },
 
-      { "srli", InstId::srli, 0x5013, top7Funct3Low7Mask,
+      { "srli", InstId::srli, 0x5013, top6Funct3Low7Mask,
 	InstType::Int,
 	OperandType::IntReg, OperandMode::Write, rdMask,
 	OperandType::IntReg, OperandMode::Read, rs1Mask,
-	OperandType::Imm, OperandMode::None, shamtMask },
+	OperandType::Imm, OperandMode::None, shamt6Mask },
 
-      { "srai", InstId::srai, 0x40005013, top7Funct3Low7Mask,
+      { "srai", InstId::srai, 0x40005013, top6Funct3Low7Mask,
 	InstType::Int,
 	OperandType::IntReg, OperandMode::Write, rdMask,
 	OperandType::IntReg, OperandMode::Read, rs1Mask,
-	OperandType::Imm, OperandMode::None, shamtMask },
+	OperandType::Imm, OperandMode::None, shamt6Mask },
 
       { "add", InstId::add, 0x0033, top7Funct3Low7Mask,
 	InstType::Int,
@@ -535,55 +687,55 @@ InstInfoTable::setupInstVec()
 	OperandType::IntReg, OperandMode::Read, rs1Mask,
 	OperandType::IntReg, OperandMode::Read, rs2Mask },
 
-      { "amoswap_w", InstId::amoswap_w, 0x0800202f, 0xf800070f,
+      { "amoswap_w", InstId::amoswap_w, 0x0800202f, 0xf800707f,
 	InstType::Int,
 	OperandType::IntReg, OperandMode::Write, rdMask,
 	OperandType::IntReg, OperandMode::Read, rs1Mask,
 	OperandType::IntReg, OperandMode::Read, rs2Mask },
 
-      { "amoadd_w", InstId::amoadd_w, 0x0000202f, 0xf800070f,
+      { "amoadd_w", InstId::amoadd_w, 0x0000202f, 0xf800707f,
 	InstType::Int,
 	OperandType::IntReg, OperandMode::Write, rdMask,
 	OperandType::IntReg, OperandMode::Read, rs1Mask,
 	OperandType::IntReg, OperandMode::Read, rs2Mask },
 
-      { "amoxor_w", InstId::amoxor_w, 0x2000202f, 0xf800070f,
+      { "amoxor_w", InstId::amoxor_w, 0x2000202f, 0xf800707f,
 	InstType::Int,
 	OperandType::IntReg, OperandMode::Write, rdMask,
 	OperandType::IntReg, OperandMode::Read, rs1Mask,
 	OperandType::IntReg, OperandMode::Read, rs2Mask },
 
-      { "amoand_w", InstId::amoand_w, 0x6000202f, 0xf800070f,
+      { "amoand_w", InstId::amoand_w, 0x6000202f, 0xf800707f,
 	InstType::Int,
 	OperandType::IntReg, OperandMode::Write, rdMask,
 	OperandType::IntReg, OperandMode::Read, rs1Mask,
 	OperandType::IntReg, OperandMode::Read, rs2Mask },
 
-      { "amoor_w", InstId::amoor_w, 0x4000202f, 0xf800070f,
+      { "amoor_w", InstId::amoor_w, 0x4000202f, 0xf800707f,
 	InstType::Int,
 	OperandType::IntReg, OperandMode::Write, rdMask,
 	OperandType::IntReg, OperandMode::Read, rs1Mask,
 	OperandType::IntReg, OperandMode::Read, rs2Mask },
 
-      { "amomin_w", InstId::amomin_w, 0x8000202f, 0xf800070f,
+      { "amomin_w", InstId::amomin_w, 0x8000202f, 0xf800707f,
 	InstType::Int,
 	OperandType::IntReg, OperandMode::Write, rdMask,
 	OperandType::IntReg, OperandMode::Read, rs1Mask,
 	OperandType::IntReg, OperandMode::Read, rs2Mask },
 
-      { "amomax_w", InstId::amomax_w, 0xa000202f, 0xf800070f,
+      { "amomax_w", InstId::amomax_w, 0xa000202f, 0xf800707f,
 	InstType::Int,
 	OperandType::IntReg, OperandMode::Write, rdMask,
 	OperandType::IntReg, OperandMode::Read, rs1Mask,
 	OperandType::IntReg, OperandMode::Read, rs2Mask },
 
-      { "amominu_w", InstId::amominu_w, 0xc000202f, 0xf800070f,
+      { "amominu_w", InstId::amominu_w, 0xc000202f, 0xf800707f,
 	InstType::Int,
 	OperandType::IntReg, OperandMode::Write, rdMask,
 	OperandType::IntReg, OperandMode::Read, rs1Mask,
 	OperandType::IntReg, OperandMode::Read, rs2Mask },
 
-      { "amomaxu_w", InstId::amomaxu_w, 0xe000202f, 0xf800070f,
+      { "amomaxu_w", InstId::amomaxu_w, 0xe000202f, 0xf800707f,
 	InstType::Int,
 	OperandType::IntReg, OperandMode::Write, rdMask,
 	OperandType::IntReg, OperandMode::Read, rs1Mask,
@@ -601,55 +753,55 @@ InstInfoTable::setupInstVec()
 	OperandType::IntReg, OperandMode::Read, rs1Mask,
 	OperandType::IntReg, OperandMode::Read, rs2Mask },
 
-      { "amoswap_d", InstId::amoswap_d, 0x0800302f, 0xf800070f,
+      { "amoswap_d", InstId::amoswap_d, 0x0800302f, 0xf800707f,
 	InstType::Int,
 	OperandType::IntReg, OperandMode::Write, rdMask,
 	OperandType::IntReg, OperandMode::Read, rs1Mask,
 	OperandType::IntReg, OperandMode::Read, rs2Mask },
 
-      { "amoadd_d", InstId::amoadd_d, 0x0000302f, 0xf800070f,
+      { "amoadd_d", InstId::amoadd_d, 0x0000302f, 0xf800707f,
 	InstType::Int,
 	OperandType::IntReg, OperandMode::Write, rdMask,
 	OperandType::IntReg, OperandMode::Read, rs1Mask,
 	OperandType::IntReg, OperandMode::Read, rs2Mask },
 
-      { "amoxor_d", InstId::amoxor_d, 0x2000302f, 0xf800070f,
+      { "amoxor_d", InstId::amoxor_d, 0x2000302f, 0xf800707f,
 	InstType::Int,
 	OperandType::IntReg, OperandMode::Write, rdMask,
 	OperandType::IntReg, OperandMode::Read, rs1Mask,
 	OperandType::IntReg, OperandMode::Read, rs2Mask },
 
-      { "amoand_d", InstId::amoand_d, 0x6000302f, 0xf800070f,
+      { "amoand_d", InstId::amoand_d, 0x6000302f, 0xf800707f,
 	InstType::Int,
 	OperandType::IntReg, OperandMode::Write, rdMask,
 	OperandType::IntReg, OperandMode::Read, rs1Mask,
 	OperandType::IntReg, OperandMode::Read, rs2Mask },
 
-      { "amoor_d", InstId::amoor_d, 0x4000302f, 0xf800070f,
+      { "amoor_d", InstId::amoor_d, 0x4000302f, 0xf800707f,
 	InstType::Int,
 	OperandType::IntReg, OperandMode::Write, rdMask,
 	OperandType::IntReg, OperandMode::Read, rs1Mask,
 	OperandType::IntReg, OperandMode::Read, rs2Mask },
 
-      { "amomin_d", InstId::amomin_d, 0x8000302f, 0xf800070f,
+      { "amomin_d", InstId::amomin_d, 0x8000302f, 0xf800707f,
 	InstType::Int,
 	OperandType::IntReg, OperandMode::Write, rdMask,
 	OperandType::IntReg, OperandMode::Read, rs1Mask,
 	OperandType::IntReg, OperandMode::Read, rs2Mask },
 
-      { "amomax_d", InstId::amomax_d, 0xa000302f, 0xf800070f,
+      { "amomax_d", InstId::amomax_d, 0xa000302f, 0xf800707f,
 	InstType::Int,
 	OperandType::IntReg, OperandMode::Write, rdMask,
 	OperandType::IntReg, OperandMode::Read, rs1Mask,
 	OperandType::IntReg, OperandMode::Read, rs2Mask },
 
-      { "amominu_d", InstId::amominu_d, 0xc000302f, 0xf800070f,
+      { "amominu_d", InstId::amominu_d, 0xc000302f, 0xf800707f,
 	InstType::Int,
 	OperandType::IntReg, OperandMode::Write, rdMask,
 	OperandType::IntReg, OperandMode::Read, rs1Mask,
 	OperandType::IntReg, OperandMode::Read, rs2Mask },
 
-      { "amomaxu_d", InstId::amomaxu_d, 0xe000302f, 0xf800070f,
+      { "amomaxu_d", InstId::amomaxu_d, 0xe000302f, 0xf800707f,
 	InstType::Int,
 	OperandType::IntReg, OperandMode::Write, rdMask,
 	OperandType::IntReg, OperandMode::Read, rs1Mask,
@@ -670,25 +822,25 @@ InstInfoTable::setupInstVec()
 
       { "fmadd_s", InstId::fmadd_s, 0x43, fmaddMask,
 	InstType::Fp,
-	OperandType::FpReg, OperandMode::Read, rdMask,
+	OperandType::FpReg, OperandMode::Write, rdMask,
 	OperandType::FpReg, OperandMode::Read, rs1Mask,
 	OperandType::FpReg, OperandMode::Read, rs2Mask },
 
       { "fmsub_s", InstId::fmsub_s, 0x47, fmaddMask,
 	InstType::Fp,
-	OperandType::FpReg, OperandMode::Read, rdMask,
+	OperandType::FpReg, OperandMode::Write, rdMask,
 	OperandType::FpReg, OperandMode::Read, rs1Mask,
 	OperandType::FpReg, OperandMode::Read, rs2Mask },
 
       { "fnmsub_s", InstId::fnmsub_s, 0x4b, fmaddMask,
 	InstType::Fp,
-	OperandType::FpReg, OperandMode::Read, rdMask,
+	OperandType::FpReg, OperandMode::Write, rdMask,
 	OperandType::FpReg, OperandMode::Read, rs1Mask,
 	OperandType::FpReg, OperandMode::Read, rs2Mask },
 
       { "fnmadd_s", InstId::fnmadd_s, 0x4f, fmaddMask,
 	InstType::Fp,
-	OperandType::FpReg, OperandMode::Read, rdMask,
+	OperandType::FpReg, OperandMode::Write, rdMask,
 	OperandType::FpReg, OperandMode::Read, rs1Mask,
 	OperandType::FpReg, OperandMode::Read, rs2Mask },
 
@@ -753,15 +905,15 @@ InstInfoTable::setupInstVec()
 
       { "fcvt_w_s", InstId::fcvt_w_s, 0xc0000053, fsqrtMask,
 	InstType::Fp,
-	OperandType::FpReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Write, rdMask,
 	OperandType::FpReg, OperandMode::Read, rs1Mask },
 
       { "fcvt_wu_s", InstId::fcvt_wu_s, 0xc0100053, fsqrtMask,
 	InstType::Fp,
-	OperandType::FpReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Write, rdMask,
 	OperandType::FpReg, OperandMode::Read, rs1Mask },
 
-      { "fmv_x_w", InstId::fmv_x_w, 0xe0900053, 0xfff1c07f,
+      { "fmv_x_w", InstId::fmv_x_w, 0xe0000053, 0xfff0707f,
 	InstType::Fp,
 	OperandType::IntReg, OperandMode::Write, rdMask,
 	OperandType::FpReg, OperandMode::Read, rs1Mask },
@@ -784,22 +936,22 @@ InstInfoTable::setupInstVec()
 	OperandType::FpReg, OperandMode::Read, rs1Mask,
 	OperandType::FpReg, OperandMode::Read, rs2Mask },
 
-      { "fclass_s", InstId::fclass_s, 0xe0001053, 0xfff1c07f,
+      { "fclass_s", InstId::fclass_s, 0xe0001053, 0xfff0707f,
 	InstType::Fp,
 	OperandType::IntReg, OperandMode::Write, rdMask,
 	OperandType::FpReg, OperandMode::Read, rs1Mask },
 
       { "fcvt_s_w", InstId::fcvt_s_w, 0xd0000053, fsqrtMask,
 	InstType::Fp,
-	OperandType::IntReg, OperandMode::Write, rdMask,
-	OperandType::FpReg, OperandMode::Read, rs1Mask },
+	OperandType::FpReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask },
 
       { "fcvt_s_wu", InstId::fcvt_s_wu, 0xd0100053, fsqrtMask,
 	InstType::Fp,
 	OperandType::FpReg, OperandMode::Write, rdMask,
-	OperandType::FpReg, OperandMode::Read, rs1Mask },
+	OperandType::IntReg, OperandMode::Read, rs1Mask },
 
-      { "fmv_w_x", InstId::fmv_w_x, 0xf0000053, 0xfff1c07f,
+      { "fmv_w_x", InstId::fmv_w_x, 0xf0000053, 0xfff0707f,
 	InstType::Fp,
 	OperandType::FpReg, OperandMode::Write, rdMask,
 	OperandType::IntReg, OperandMode::Read, rs1Mask },
@@ -817,8 +969,8 @@ InstInfoTable::setupInstVec()
 
       { "fcvt_s_l", InstId::fcvt_s_l, 0xd0200053, 0xfff0007f,
 	InstType::Fp,
-	OperandType::IntReg, OperandMode::Write, rdMask,
-	OperandType::FpReg, OperandMode::Read, rs1Mask },
+	OperandType::FpReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask },
 
       { "fcvt_s_lu", InstId::fcvt_s_lu, 0xd0300053, 0xfff0007f,
 	InstType::Fp,
@@ -840,25 +992,25 @@ InstInfoTable::setupInstVec()
 
       { "fmadd_d", InstId::fmadd_d, 0x02000043, fmaddMask,
 	InstType::Fp,
-	OperandType::FpReg, OperandMode::Read, rdMask,
+	OperandType::FpReg, OperandMode::Write, rdMask,
 	OperandType::FpReg, OperandMode::Read, rs1Mask,
 	OperandType::FpReg, OperandMode::Read, rs2Mask },
 
       { "fmsub_d", InstId::fmsub_d, 0x02000047, fmaddMask,
 	InstType::Fp,
-	OperandType::FpReg, OperandMode::Read, rdMask,
+	OperandType::FpReg, OperandMode::Write, rdMask,
 	OperandType::FpReg, OperandMode::Read, rs1Mask,
 	OperandType::FpReg, OperandMode::Read, rs2Mask },
 
       { "fnmsub_d", InstId::fnmsub_d, 0x0200004b, fmaddMask,
 	InstType::Fp,
-	OperandType::FpReg, OperandMode::Read, rdMask,
+	OperandType::FpReg, OperandMode::Write, rdMask,
 	OperandType::FpReg, OperandMode::Read, rs1Mask,
 	OperandType::FpReg, OperandMode::Read, rs2Mask },
 
       { "fnmadd_d", InstId::fnmadd_d, 0x0200004f, fmaddMask,
 	InstType::Fp,
-	OperandType::FpReg, OperandMode::Read, rdMask,
+	OperandType::FpReg, OperandMode::Write, rdMask,
 	OperandType::FpReg, OperandMode::Read, rs1Mask,
 	OperandType::FpReg, OperandMode::Read, rs2Mask },
 
@@ -880,13 +1032,13 @@ InstInfoTable::setupInstVec()
 	OperandType::FpReg, OperandMode::Read, rs1Mask,
 	OperandType::FpReg, OperandMode::Read, rs2Mask },
 
-      { "fdiv_d", InstId::fdiv_d, 0x1b000053, faddMask,
+      { "fdiv_d", InstId::fdiv_d, 0x1a000053, faddMask,
 	InstType::Fp,
 	OperandType::FpReg, OperandMode::Write, rdMask,
 	OperandType::FpReg, OperandMode::Read, rs1Mask,
 	OperandType::FpReg, OperandMode::Read, rs2Mask },
 
-      { "fsqrt_d", InstId::fsqrt_d, 0x5b000053, fsqrtMask,
+      { "fsqrt_d", InstId::fsqrt_d, 0x5a000053, fsqrtMask,
 	InstType::Fp,
 	OperandType::FpReg, OperandMode::Write, rdMask,
 	OperandType::FpReg, OperandMode::Read, rs1Mask },
@@ -909,13 +1061,13 @@ InstInfoTable::setupInstVec()
 	OperandType::FpReg, OperandMode::Read, rs1Mask,
 	OperandType::FpReg, OperandMode::Read, rs2Mask },
 
-      { "fmin_d", InstId::fmin_d, 0x2b000053, top7Funct3Low7Mask,
+      { "fmin_d", InstId::fmin_d, 0x2a000053, top7Funct3Low7Mask,
 	InstType::Fp,
 	OperandType::FpReg, OperandMode::Write, rdMask,
 	OperandType::FpReg, OperandMode::Read, rs1Mask,
 	OperandType::FpReg, OperandMode::Read, rs2Mask },
 
-      { "fmax_d", InstId::fmax_d, 0x2b001053, top7Funct3Low7Mask,
+      { "fmax_d", InstId::fmax_d, 0x2a001053, top7Funct3Low7Mask,
 	InstType::Fp,
 	OperandType::FpReg, OperandMode::Write, rdMask,
 	OperandType::FpReg, OperandMode::Read, rs1Mask,
@@ -949,30 +1101,30 @@ InstInfoTable::setupInstVec()
 	OperandType::FpReg, OperandMode::Read, rs1Mask,
 	OperandType::FpReg, OperandMode::Read, rs2Mask },
 
-      { "fclass_d", InstId::fclass_d, 0xe2001053, 0xfff1c07f,
+      { "fclass_d", InstId::fclass_d, 0xe2001053, 0xfff0707f,
 	InstType::Fp,
 	OperandType::IntReg, OperandMode::Write, rdMask,
 	OperandType::FpReg, OperandMode::Read, rs1Mask },
 
-      { "fcvt_w_d", InstId::fcvt_w_d, 0xf2000053, 0xfff1c07f,
+      { "fcvt_w_d", InstId::fcvt_w_d, 0xc2000053, fsqrtMask,
 	InstType::Fp,
-	OperandType::FpReg, OperandMode::Write, rdMask,
-	OperandType::IntReg, OperandMode::Read, rs1Mask },
+	OperandType::IntReg, OperandMode::Write, rdMask,
+	OperandType::FpReg, OperandMode::Read, rs1Mask },
 
       { "fcvt_wu_d", InstId::fcvt_wu_d, 0xc2100053, fsqrtMask,
 	InstType::Fp,
-	OperandType::FpReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Write, rdMask,
 	OperandType::FpReg, OperandMode::Read, rs1Mask },
 
       { "fcvt_d_w", InstId::fcvt_d_w, 0xd2000053, fsqrtMask,
 	InstType::Fp,
-	OperandType::IntReg, OperandMode::Write, rdMask,
-	OperandType::FpReg, OperandMode::Read, rs1Mask },
+	OperandType::FpReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask },
 
       { "fcvt_d_wu", InstId::fcvt_d_wu, 0xd2100053, fsqrtMask,
 	InstType::Fp,
 	OperandType::FpReg, OperandMode::Write, rdMask,
-	OperandType::FpReg, OperandMode::Read, rs1Mask },
+	OperandType::IntReg, OperandMode::Read, rs1Mask },
 
       // rv64f + rv32d
       { "fcvt_l_d", InstId::fcvt_l_d, 0xc2200053, 0xfff0007f,
@@ -992,24 +1144,24 @@ InstInfoTable::setupInstVec()
 
       { "fcvt_d_l", InstId::fcvt_d_l, 0xd2200053, 0xfff0007f,
 	InstType::Fp,
-	OperandType::IntReg, OperandMode::Write, rdMask,
-	OperandType::FpReg, OperandMode::Read, rs1Mask },
+	OperandType::FpReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask },
 
       { "fcvt_d_lu", InstId::fcvt_d_lu, 0xd2300053, 0xfff0007f,
 	InstType::Fp,
-	OperandType::IntReg, OperandMode::Write, rdMask,
-	OperandType::FpReg, OperandMode::Read, rs1Mask },
+	OperandType::FpReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask },
 
-      { "fmv_d_x", InstId::fmv_d_x, 0xef000053, 0xfff0707f,
+      { "fmv_d_x", InstId::fmv_d_x, 0xf2000053, 0xfff0707f,
 	InstType::Fp,
 	OperandType::FpReg, OperandMode::Write, rdMask,
 	OperandType::IntReg, OperandMode::Read, rs1Mask },
 
       // Privileged
-      { "mret", InstId::mret, 0x30100073, 0xffffffff, InstType::Int },
-      { "uret", InstId::uret, 0x00100073, 0xffffffff, InstType::Int },
-      { "sret", InstId::sret, 0x10100073, 0xffffffff, InstType::Int },
-      { "wfi", InstId::wfi, 0x10280073, 0xffffffff, InstType::Int },
+      { "mret", InstId::mret, 0x30200073, 0xffffffff, InstType::Int },
+      { "uret", InstId::uret, 0x00200073, 0xffffffff, InstType::Int },
+      { "sret", InstId::sret, 0x10200073, 0xffffffff, InstType::Int },
+      { "wfi", InstId::wfi, 0x10500073, 0xffffffff, InstType::Int },
 
       // Compressed insts. The operand bits are "swizzled" and the
       // operand masks are not used for obtaining operands. We set the
@@ -1022,7 +1174,7 @@ InstInfoTable::setupInstVec()
 
       { "c.fld", InstId::c_fld, 0x2000, 0xe003,
 	InstType::Load,
-	OperandType::IntReg, OperandMode::Write, 0,
+	OperandType::FpReg, OperandMode::Write, 0,
 	OperandType::IntReg, OperandMode::Read, 0,
 	OperandType::Imm, OperandMode::None, 0 },
 
@@ -1040,7 +1192,7 @@ InstInfoTable::setupInstVec()
 
       { "c.flw", InstId::c_flw, 0x6000, 0xe003,
 	InstType::Load,
-	OperandType::IntReg, OperandMode::Write, 0,
+	OperandType::FpReg, OperandMode::Write, 0,
 	OperandType::IntReg, OperandMode::Read, 0,
 	OperandType::Imm, OperandMode::None, 0 },
 
@@ -1053,7 +1205,7 @@ InstInfoTable::setupInstVec()
       { "c.fsd", InstId::c_fsd, 0xa000, 0xe003,
 	InstType::Store,
 	OperandType::IntReg, OperandMode::Read, 0,
-	OperandType::IntReg, OperandMode::Read, 0,
+	OperandType::FpReg, OperandMode::Read, 0,
 	OperandType::Imm, OperandMode::None, 0 },
 
       { "c.sq", InstId::c_sq, 0xa000, 0xe003,
@@ -1071,7 +1223,7 @@ InstInfoTable::setupInstVec()
       { "c.fsw", InstId::c_fsw, 0xe000, 0xe003,
 	InstType::Store,
 	OperandType::IntReg, OperandMode::Read, 0,
-	OperandType::IntReg, OperandMode::Read, 0,
+	OperandType::FpReg, OperandMode::Read, 0,
 	OperandType::Imm, OperandMode::None, 0 },
 
       { "c.sd", InstId::c_sd, 0xe000, 0xe003,
@@ -1204,8 +1356,8 @@ InstInfoTable::setupInstVec()
 	OperandType::Imm, OperandMode::None, 0 },
 
       { "c.fldsp", InstId::c_fldsp, 0x2002, 0xe003,
-	InstType::Int,
-	OperandType::IntReg, OperandMode::Write, 0,
+	InstType::Load,
+	OperandType::FpReg, OperandMode::Write, 0,
 	OperandType::IntReg, OperandMode::Read, 0,
 	OperandType::Imm, OperandMode::None, 0 },
 
@@ -1217,11 +1369,11 @@ InstInfoTable::setupInstVec()
 
       { "c.flwsp", InstId::c_flwsp, 0x6002, 0xe003,
 	InstType::Load,
-	OperandType::IntReg, OperandMode::Write, 0,
+	OperandType::FpReg, OperandMode::Write, 0,
 	OperandType::IntReg, OperandMode::Read, 0,
 	OperandType::Imm, OperandMode::None, 0 },
 
-      { "c.fldsp", InstId::c_flwsp, 0x6002, 0xe003,
+      { "c.ldsp", InstId::c_ldsp, 0x6002, 0xe003,
 	InstType::Load,
 	OperandType::IntReg, OperandMode::Write, 0,
 	OperandType::IntReg, OperandMode::Read, 0,
@@ -1256,7 +1408,7 @@ InstInfoTable::setupInstVec()
       { "c.fsdsp", InstId::c_fsdsp, 0xa002, 0xe003,
 	InstType::Store,
 	OperandType::IntReg, OperandMode::Read, 0,
-	OperandType::IntReg, OperandMode::Read, 0,
+	OperandType::FpReg, OperandMode::Read, 0,
 	OperandType::Imm, OperandMode::None, 0 },
 
       { "c.swsp", InstId::c_swsp, 0xc002, 0xe003,
@@ -1266,9 +1418,702 @@ InstInfoTable::setupInstVec()
 	OperandType::Imm, OperandMode::None, 0 },
 
       { "c.fswsp", InstId::c_fswsp, 0xe002, 0xe003,
+	InstType::Store,
+	OperandType::IntReg, OperandMode::Read, 0,
+	OperandType::FpReg, OperandMode::Read, 0,
+	OperandType::Imm, OperandMode::None, 0 },
+
+      { "c.sdsp", InstId::c_sdsp, 0xe002, 0xe003,
 	InstType::Store,
 	OperandType::IntReg, OperandMode::Read, 0,
 	OperandType::IntReg, OperandMode::Read, 0,
-	OperandType::Imm, OperandMode::None, 0 }
+	OperandType::Imm, OperandMode::None, 0 },
+
+      // Vector configuration
+      { "vsetvli", InstId::vsetvli, 0x00007057, vsetvliMask,
+	InstType::Vector,
+	OperandType::IntReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask,
+	OperandType::Imm, OperandMode::None, 0x7ff00000 },
+
+      { "vsetivli", InstId::vsetivli, 0xc0007057, vsetivliMask,
+	InstType::Vector,
+	OperandType::IntReg, OperandMode::Write, rdMask,
+	OperandType::Imm, OperandMode::None, rs1Mask,
+	OperandType::Imm, OperandMode::None, 0x3ff00000 },
+
+      { "vsetvl", InstId::vsetvl, 0x80007057, top7Funct3Low7Mask,
+	InstType::Vector,
+	OperandType::IntReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask,
+	OperandType::IntReg, OperandMode::Read, rs2Mask },
+
+      // Vector unit-stride load/store
+      { "vle8_v", InstId::vle8_v, 0x00000007, vecLdStMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask },
+
+      { "vle16_v", InstId::vle16_v, 0x00005007, vecLdStMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask },
+
+      { "vle32_v", InstId::vle32_v, 0x00006007, vecLdStMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask },
+
+      { "vle64_v", InstId::vle64_v, 0x00007007, vecLdStMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask },
+
+      { "vse8_v", InstId::vse8_v, 0x00000027, vecLdStMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Read, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask },
+
+      { "vse16_v", InstId::vse16_v, 0x00005027, vecLdStMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Read, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask },
+
+      { "vse32_v", InstId::vse32_v, 0x00006027, vecLdStMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Read, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask },
+
+      { "vse64_v", InstId::vse64_v, 0x00007027, vecLdStMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Read, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask },
+
+      // Vector integer
+      { "vadd_vv", InstId::vadd_vv, 0x00000057, vecOpMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask,
+	OperandType::VecReg, OperandMode::Read, rs1Mask },
+
+      { "vadd_vx", InstId::vadd_vx, 0x00004057, vecOpMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask },
+
+      { "vadd_vi", InstId::vadd_vi, 0x00003057, vecOpMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask,
+	OperandType::Imm, OperandMode::None, rs1Mask },
+
+      { "vsub_vv", InstId::vsub_vv, 0x08000057, vecOpMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask,
+	OperandType::VecReg, OperandMode::Read, rs1Mask },
+
+      { "vsub_vx", InstId::vsub_vx, 0x08004057, vecOpMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask },
+
+      { "vrsub_vx", InstId::vrsub_vx, 0x0c004057, vecOpMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask },
+
+      { "vrsub_vi", InstId::vrsub_vi, 0x0c003057, vecOpMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask,
+	OperandType::Imm, OperandMode::None, rs1Mask },
+
+      { "vminu_vv", InstId::vminu_vv, 0x10000057, vecOpMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask,
+	OperandType::VecReg, OperandMode::Read, rs1Mask },
+
+      { "vminu_vx", InstId::vminu_vx, 0x10004057, vecOpMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask },
+
+      { "vmin_vv", InstId::vmin_vv, 0x14000057, vecOpMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask,
+	OperandType::VecReg, OperandMode::Read, rs1Mask },
+
+      { "vmin_vx", InstId::vmin_vx, 0x14004057, vecOpMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask },
+
+      { "vmaxu_vv", InstId::vmaxu_vv, 0x18000057, vecOpMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask,
+	OperandType::VecReg, OperandMode::Read, rs1Mask },
+
+      { "vmaxu_vx", InstId::vmaxu_vx, 0x18004057, vecOpMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask },
+
+      { "vmax_vv", InstId::vmax_vv, 0x1c000057, vecOpMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask,
+	OperandType::VecReg, OperandMode::Read, rs1Mask },
+
+      { "vmax_vx", InstId::vmax_vx, 0x1c004057, vecOpMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask },
+
+      { "vand_vv", InstId::vand_vv, 0x24000057, vecOpMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask,
+	OperandType::VecReg, OperandMode::Read, rs1Mask },
+
+      { "vand_vx", InstId::vand_vx, 0x24004057, vecOpMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask },
+
+      { "vand_vi", InstId::vand_vi, 0x24003057, vecOpMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask,
+	OperandType::Imm, OperandMode::None, rs1Mask },
+
+      { "vor_vv", InstId::vor_vv, 0x28000057, vecOpMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask,
+	OperandType::VecReg, OperandMode::Read, rs1Mask },
+
+      { "vor_vx", InstId::vor_vx, 0x28004057, vecOpMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask },
+
+      { "vor_vi", InstId::vor_vi, 0x28003057, vecOpMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask,
+	OperandType::Imm, OperandMode::None, rs1Mask },
+
+      { "vxor_vv", InstId::vxor_vv, 0x2c000057, vecOpMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask,
+	OperandType::VecReg, OperandMode::Read, rs1Mask },
+
+      { "vxor_vx", InstId::vxor_vx, 0x2c004057, vecOpMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask },
+
+      { "vxor_vi", InstId::vxor_vi, 0x2c003057, vecOpMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask,
+	OperandType::Imm, OperandMode::None, rs1Mask },
+
+      { "vsll_vv", InstId::vsll_vv, 0x94000057, vecOpMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask,
+	OperandType::VecReg, OperandMode::Read, rs1Mask },
+
+      { "vsll_vx", InstId::vsll_vx, 0x94004057, vecOpMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask },
+
+      { "vsll_vi", InstId::vsll_vi, 0x94003057, vecOpMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask,
+	OperandType::Imm, OperandMode::None, rs1Mask },
+
+      { "vsrl_vv", InstId::vsrl_vv, 0xa0000057, vecOpMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask,
+	OperandType::VecReg, OperandMode::Read, rs1Mask },
+
+      { "vsrl_vx", InstId::vsrl_vx, 0xa0004057, vecOpMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask },
+
+      { "vsrl_vi", InstId::vsrl_vi, 0xa0003057, vecOpMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask,
+	OperandType::Imm, OperandMode::None, rs1Mask },
+
+      { "vsra_vv", InstId::vsra_vv, 0xa4000057, vecOpMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask,
+	OperandType::VecReg, OperandMode::Read, rs1Mask },
+
+      { "vsra_vx", InstId::vsra_vx, 0xa4004057, vecOpMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask },
+
+      { "vsra_vi", InstId::vsra_vi, 0xa4003057, vecOpMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask,
+	OperandType::Imm, OperandMode::None, rs1Mask },
+
+      { "vmul_vv", InstId::vmul_vv, 0x94002057, vecOpMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask,
+	OperandType::VecReg, OperandMode::Read, rs1Mask },
+
+      { "vmul_vx", InstId::vmul_vx, 0x94006057, vecOpMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask },
+
+      { "vmv_v_v", InstId::vmv_v_v, 0x5e000057, vecMvMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs1Mask },
+
+      { "vmv_v_x", InstId::vmv_v_x, 0x5e004057, vecMvMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask },
+
+      { "vmv_v_i", InstId::vmv_v_i, 0x5e003057, vecMvMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::Imm, OperandMode::None, rs1Mask },
+
+      { "vmv_x_s", InstId::vmv_x_s, 0x42002057, vecMvsMask,
+	InstType::Vector,
+	OperandType::IntReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask },
+
+      { "vmv_s_x", InstId::vmv_s_x, 0x42006057, vecMvMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask },
+
+      // Vector integer reduction
+      { "vredsum_vs", InstId::vredsum_vs, 0x00002057, vecOpMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask,
+	OperandType::VecReg, OperandMode::Read, rs1Mask },
+
+      { "vredand_vs", InstId::vredand_vs, 0x04002057, vecOpMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask,
+	OperandType::VecReg, OperandMode::Read, rs1Mask },
+
+      { "vredor_vs", InstId::vredor_vs, 0x08002057, vecOpMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask,
+	OperandType::VecReg, OperandMode::Read, rs1Mask },
+
+      { "vredxor_vs", InstId::vredxor_vs, 0x0c002057, vecOpMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask,
+	OperandType::VecReg, OperandMode::Read, rs1Mask },
+
+      { "vredminu_vs", InstId::vredminu_vs, 0x10002057, vecOpMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask,
+	OperandType::VecReg, OperandMode::Read, rs1Mask },
+
+      { "vredmin_vs", InstId::vredmin_vs, 0x14002057, vecOpMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask,
+	OperandType::VecReg, OperandMode::Read, rs1Mask },
+
+      { "vredmaxu_vs", InstId::vredmaxu_vs, 0x18002057, vecOpMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask,
+	OperandType::VecReg, OperandMode::Read, rs1Mask },
+
+      { "vredmax_vs", InstId::vredmax_vs, 0x1c002057, vecOpMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask,
+	OperandType::VecReg, OperandMode::Read, rs1Mask },
+
+      // Vector floating point
+      { "vfadd_vv", InstId::vfadd_vv, 0x00001057, vecOpMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask,
+	OperandType::VecReg, OperandMode::Read, rs1Mask },
+
+      { "vfadd_vf", InstId::vfadd_vf, 0x00005057, vecOpMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask,
+	OperandType::FpReg, OperandMode::Read, rs1Mask },
+
+      { "vfsub_vv", InstId::vfsub_vv, 0x08001057, vecOpMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask,
+	OperandType::VecReg, OperandMode::Read, rs1Mask },
+
+      { "vfsub_vf", InstId::vfsub_vf, 0x08005057, vecOpMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask,
+	OperandType::FpReg, OperandMode::Read, rs1Mask },
+
+      { "vfrsub_vf", InstId::vfrsub_vf, 0x9c005057, vecOpMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask,
+	OperandType::FpReg, OperandMode::Read, rs1Mask },
+
+      { "vfmul_vv", InstId::vfmul_vv, 0x90001057, vecOpMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask,
+	OperandType::VecReg, OperandMode::Read, rs1Mask },
+
+      { "vfmul_vf", InstId::vfmul_vf, 0x90005057, vecOpMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask,
+	OperandType::FpReg, OperandMode::Read, rs1Mask },
+
+      { "vfdiv_vv", InstId::vfdiv_vv, 0x80001057, vecOpMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask,
+	OperandType::VecReg, OperandMode::Read, rs1Mask },
+
+      { "vfdiv_vf", InstId::vfdiv_vf, 0x80005057, vecOpMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask,
+	OperandType::FpReg, OperandMode::Read, rs1Mask },
+
+      { "vfrdiv_vf", InstId::vfrdiv_vf, 0x84005057, vecOpMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask,
+	OperandType::FpReg, OperandMode::Read, rs1Mask },
+
+      { "vfmacc_vv", InstId::vfmacc_vv, 0xb0001057, vecOpMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::ReadWrite, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask,
+	OperandType::VecReg, OperandMode::Read, rs1Mask },
+
+      { "vfmacc_vf", InstId::vfmacc_vf, 0xb0005057, vecOpMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::ReadWrite, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask,
+	OperandType::FpReg, OperandMode::Read, rs1Mask },
+
+      { "vfredusum_vs", InstId::vfredusum_vs, 0x04001057, vecOpMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask,
+	OperandType::VecReg, OperandMode::Read, rs1Mask },
+
+      { "vfredosum_vs", InstId::vfredosum_vs, 0x0c001057, vecOpMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask,
+	OperandType::VecReg, OperandMode::Read, rs1Mask },
+
+      { "vfmv_f_s", InstId::vfmv_f_s, 0x42001057, vecMvsMask,
+	InstType::Vector,
+	OperandType::FpReg, OperandMode::Write, rdMask,
+	OperandType::VecReg, OperandMode::Read, rs2Mask },
+
+      { "vfmv_s_f", InstId::vfmv_s_f, 0x42005057, vecMvMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::FpReg, OperandMode::Read, rs1Mask },
+
+      { "vfmv_v_f", InstId::vfmv_v_f, 0x5e005057, vecMvMask,
+	InstType::Vector,
+	OperandType::VecReg, OperandMode::Write, rdMask,
+	OperandType::FpReg, OperandMode::Read, rs1Mask },
+
+      // Bit manipulation: Zba
+      { "sh1add", InstId::sh1add, 0x20002033, top7Funct3Low7Mask,
+	InstType::Int,
+	OperandType::IntReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask,
+	OperandType::IntReg, OperandMode::Read, rs2Mask },
+
+      { "sh2add", InstId::sh2add, 0x20004033, top7Funct3Low7Mask,
+	InstType::Int,
+	OperandType::IntReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask,
+	OperandType::IntReg, OperandMode::Read, rs2Mask },
+
+      { "sh3add", InstId::sh3add, 0x20006033, top7Funct3Low7Mask,
+	InstType::Int,
+	OperandType::IntReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask,
+	OperandType::IntReg, OperandMode::Read, rs2Mask },
+
+      { "add.uw", InstId::add_uw, 0x0800003b, top7Funct3Low7Mask,
+	InstType::Int,
+	OperandType::IntReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask,
+	OperandType::IntReg, OperandMode::Read, rs2Mask },
+
+      { "sh1add.uw", InstId::sh1add_uw, 0x2000203b, top7Funct3Low7Mask,
+	InstType::Int,
+	OperandType::IntReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask,
+	OperandType::IntReg, OperandMode::Read, rs2Mask },
+
+      { "sh2add.uw", InstId::sh2add_uw, 0x2000403b, top7Funct3Low7Mask,
+	InstType::Int,
+	OperandType::IntReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask,
+	OperandType::IntReg, OperandMode::Read, rs2Mask },
+
+      { "sh3add.uw", InstId::sh3add_uw, 0x2000603b, top7Funct3Low7Mask,
+	InstType::Int,
+	OperandType::IntReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask,
+	OperandType::IntReg, OperandMode::Read, rs2Mask },
+
+      { "slli.uw", InstId::slli_uw, 0x0800101b, top6Funct3Low7Mask,
+	InstType::Int,
+	OperandType::IntReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask,
+	OperandType::Imm, OperandMode::None, shamt6Mask },
+
+      // Bit manipulation: Zbb
+      { "andn", InstId::andn, 0x40007033, top7Funct3Low7Mask,
+	InstType::Int,
+	OperandType::IntReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask,
+	OperandType::IntReg, OperandMode::Read, rs2Mask },
+
+      { "orn", InstId::orn, 0x40006033, top7Funct3Low7Mask,
+	InstType::Int,
+	OperandType::IntReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask,
+	OperandType::IntReg, OperandMode::Read, rs2Mask },
+
+      { "xnor", InstId::xnor, 0x40004033, top7Funct3Low7Mask,
+	InstType::Int,
+	OperandType::IntReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask,
+	OperandType::IntReg, OperandMode::Read, rs2Mask },
+
+      { "clz", InstId::clz, 0x60001013, top12Funct3Low7Mask,
+	InstType::Int,
+	OperandType::IntReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask },
+
+      { "ctz", InstId::ctz, 0x60101013, top12Funct3Low7Mask,
+	InstType::Int,
+	OperandType::IntReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask },
+
+      { "cpop", InstId::cpop, 0x60201013, top12Funct3Low7Mask,
+	InstType::Int,
+	OperandType::IntReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask },
+
+      { "clzw", InstId::clzw, 0x6000101b, top12Funct3Low7Mask,
+	InstType::Int,
+	OperandType::IntReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask },
+
+      { "ctzw", InstId::ctzw, 0x6010101b, top12Funct3Low7Mask,
+	InstType::Int,
+	OperandType::IntReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask },
+
+      { "cpopw", InstId::cpopw, 0x6020101b, top12Funct3Low7Mask,
+	InstType::Int,
+	OperandType::IntReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask },
+
+      { "max", InstId::max, 0x0a006033, top7Funct3Low7Mask,
+	InstType::Int,
+	OperandType::IntReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask,
+	OperandType::IntReg, OperandMode::Read, rs2Mask },
+
+      { "maxu", InstId::maxu, 0x0a007033, top7Funct3Low7Mask,
+	InstType::Int,
+	OperandType::IntReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask,
+	OperandType::IntReg, OperandMode::Read, rs2Mask },
+
+      { "min", InstId::min, 0x0a004033, top7Funct3Low7Mask,
+	InstType::Int,
+	OperandType::IntReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask,
+	OperandType::IntReg, OperandMode::Read, rs2Mask },
+
+      { "minu", InstId::minu, 0x0a005033, top7Funct3Low7Mask,
+	InstType::Int,
+	OperandType::IntReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask,
+	OperandType::IntReg, OperandMode::Read, rs2Mask },
+
+      { "sext.b", InstId::sext_b, 0x60401013, top12Funct3Low7Mask,
+	InstType::Int,
+	OperandType::IntReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask },
+
+      { "sext.h", InstId::sext_h, 0x60501013, top12Funct3Low7Mask,
+	InstType::Int,
+	OperandType::IntReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask },
+
+      { "zext.h", InstId::zext_h, 0x08004033, top12Funct3Low7Mask,
+	InstType::Int,
+	OperandType::IntReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask },
+
+      { "zext.h", InstId::zext_h_64, 0x0800403b, top12Funct3Low7Mask,
+	InstType::Int,
+	OperandType::IntReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask },
+
+      { "rol", InstId::rol, 0x60001033, top7Funct3Low7Mask,
+	InstType::Int,
+	OperandType::IntReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask,
+	OperandType::IntReg, OperandMode::Read, rs2Mask },
+
+      { "ror", InstId::ror, 0x60005033, top7Funct3Low7Mask,
+	InstType::Int,
+	OperandType::IntReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask,
+	OperandType::IntReg, OperandMode::Read, rs2Mask },
+
+      { "rori", InstId::rori, 0x60005013, top6Funct3Low7Mask,
+	InstType::Int,
+	OperandType::IntReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask,
+	OperandType::Imm, OperandMode::None, shamt6Mask },
+
+      { "rolw", InstId::rolw, 0x6000103b, top7Funct3Low7Mask,
+	InstType::Int,
+	OperandType::IntReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask,
+	OperandType::IntReg, OperandMode::Read, rs2Mask },
+
+      { "rorw", InstId::rorw, 0x6000503b, top7Funct3Low7Mask,
+	InstType::Int,
+	OperandType::IntReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask,
+	OperandType::IntReg, OperandMode::Read, rs2Mask },
+
+      { "roriw", InstId::roriw, 0x6000501b, top7Funct3Low7Mask,
+	InstType::Int,
+	OperandType::IntReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask,
+	OperandType::Imm, OperandMode::None, shamtMask },
+
+      { "orc.b", InstId::orc_b, 0x28705013, top12Funct3Low7Mask,
+	InstType::Int,
+	OperandType::IntReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask },
+
+      { "rev8", InstId::rev8, 0x69805013, top12Funct3Low7Mask,
+	InstType::Int,
+	OperandType::IntReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask },
+
+      { "rev8", InstId::rev8_64, 0x6b805013, top12Funct3Low7Mask,
+	InstType::Int,
+	OperandType::IntReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask },
+
+      // Bit manipulation: Zbs
+      { "bclr", InstId::bclr, 0x48001033, top7Funct3Low7Mask,
+	InstType::Int,
+	OperandType::IntReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask,
+	OperandType::IntReg, OperandMode::Read, rs2Mask },
+
+      { "bclri", InstId::bclri, 0x48001013, top6Funct3Low7Mask,
+	InstType::Int,
+	OperandType::IntReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask,
+	OperandType::Imm, OperandMode::None, shamt6Mask },
+
+      { "bext", InstId::bext, 0x48005033, top7Funct3Low7Mask,
+	InstType::Int,
+	OperandType::IntReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask,
+	OperandType::IntReg, OperandMode::Read, rs2Mask },
+
+      { "bexti", InstId::bexti, 0x48005013, top6Funct3Low7Mask,
+	InstType::Int,
+	OperandType::IntReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask,
+	OperandType::Imm, OperandMode::None, shamt6Mask },
+
+      { "binv", InstId::binv, 0x68001033, top7Funct3Low7Mask,
+	InstType::Int,
+	OperandType::IntReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask,
+	OperandType::IntReg, OperandMode::Read, rs2Mask },
+
+      { "binvi", InstId::binvi, 0x68001013, top6Funct3Low7Mask,
+	InstType::Int,
+	OperandType::IntReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask,
+	OperandType::Imm, OperandMode::None, shamt6Mask },
+
+      { "bset", InstId::bset, 0x28001033, top7Funct3Low7Mask,
+	InstType::Int,
+	OperandType::IntReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask,
+	OperandType::IntReg, OperandMode::Read, rs2Mask },
+
+      { "bseti", InstId::bseti, 0x28001013, top6Funct3Low7Mask,
+	InstType::Int,
+	OperandType::IntReg, OperandMode::Write, rdMask,
+	OperandType::IntReg, OperandMode::Read, rs1Mask,
+	OperandType::Imm, OperandMode::None, shamt6Mask }
     };
 }
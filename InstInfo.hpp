@@ -26,10 +26,15 @@
 namespace WdRiscv
 {
 
-  enum class OperandType { IntReg, FpReg, CsReg, Imm, None };
+  enum class OperandType { IntReg, FpReg, CsReg, VecReg, Imm, None };
   enum class OperandMode { Read, Write, ReadWrite, None };
   enum class InstType { Load, Store, Multiply, Divide, Branch, Int, Fp,
-			Csr };
+			Csr, Vector };
+
+  /// How the value of an operand is extracted from the instruction
+  /// code: A plain bit field (register number, CSR number, shift
+  /// amount, ...) or one of the scrambled immediate forms.
+  enum class OperandForm { None, Field, ImmI, ImmS, ImmB, ImmU, ImmJ };
 
   /// Return true if given instruction is a 4-byte instruction.
   inline bool
@@ -177,6 +182,10 @@ namespace WdRiscv
     bool isCsr() const
     { return type_ == InstType::Csr; }
 
+    /// Return true if this is a vector instruction.
+    bool isVector() const
+    { return type_ == InstType::Vector; }
+
     /// Return true if source operands have unsigned integer values.
     bool isUnsigned() const
     { return isUns_; }
@@ -208,6 +217,10 @@ namespace WdRiscv
     OperandMode op1Mode_;
     OperandMode op2Mode_;
 
+    OperandForm op0Form_ = OperandForm::None;
+    OperandForm op1Form_ = OperandForm::None;
+    OperandForm op2Form_ = OperandForm::None;
+
     unsigned opCount_;
     bool isUns_ = false;
   };
@@ -234,14 +247,40 @@ namespace WdRiscv
     // Return true if given instance name is present in the table.
     bool hasInfo(const std::string& name) const;
 
+    // Return the info of the 32-bit instruction whose code/mask pair
+    // matches the given instruction code or the info of the illegal
+    // instruction if no entry matches. Set op0, op1 and op2 to the
+    // values of the operands of the matching instruction (zero for
+    // missing operands). Immediate operands are sign extended.
+    const InstInfo& decode(uint32_t code, uint32_t& op0, uint32_t& op1,
+			   int32_t& op2) const;
+
   private:
 
     // Helper to the constructor.
     void setupInstVec();
 
+    // Helper to the constructor: Build the decode tree from the
+    // code/mask pairs of the 32-bit instructions.
+    void setupDecodeTree();
+
+    // Helper to setupDecodeTree: Determine how each operand of the
+    // given instruction is extracted from the instruction code.
+    static void setupOperandForms(InstInfo& info);
+
   private:
 
     std::vector<InstInfo> instVec_;
     std::unordered_map<std::string, InstId> instMap_;
+
+    // Decode tree. First level is indexed by the 7-bit opcode. Second
+    // level is indexed by the funct3/funct7 bits specified by all the
+    // instructions sharing the opcode. A leaf is a range of
+    // candidates_ sorted by decreasing number of bits in the code
+    // mask.
+    std::vector<uint32_t> opcodeKeyMask_;  // Funct3/funct7 bits per opcode.
+    std::vector<int> opcodeLeaves_;        // First leaf per opcode or -1.
+    std::vector<std::pair<unsigned, unsigned>> leaves_;
+    std::vector<InstId> candidates_;
   };
 }
@@ -23,6 +23,7 @@
 #include <math.h>
 #include <stdlib.h>
 #include <sys/mman.h>
+#include <unistd.h>
 #include <elfio/elfio.hpp>
 #include "Memory.hpp"
 
@@ -414,6 +415,34 @@ Memory::copy(const Memory& other)
 }
 
 
+size_t
+Memory::countTouchedPages() const
+{
+  // Memory is obtained with mmap: A page that was never touched is not
+  // backed by physical memory. Ask the host which pages are resident
+  // one chunk at a time to keep the residency vector small.
+  size_t hostPageSize = sysconf(_SC_PAGESIZE);
+  size_t chunkSize = regionSize_;
+  std::vector<unsigned char> residency(chunkSize / hostPageSize + 1);
+
+  size_t count = 0;  // Count of resident host pages.
+  for (size_t offset = 0; offset < size_; offset += chunkSize)
+    {
+      size_t len = std::min(chunkSize, size_ - offset);
+      if (mincore(data_ + offset, len, residency.data()) != 0)
+	return 0;
+      size_t n = (len + hostPageSize - 1) / hostPageSize;
+      for (size_t i = 0; i < n; ++i)
+	if (residency[i] & 1)
+	  count++;
+    }
+
+  if (hostPageSize >= pageSize_)
+    return count * (hostPageSize / pageSize_);
+  return (count * hostPageSize + pageSize_ - 1) / pageSize_;
+}
+
+
 bool
 Memory::checkCcmConfig(const std::string& tag, size_t region, size_t offset,
 		       size_t size) const
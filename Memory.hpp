@@ -30,6 +30,9 @@ namespace WdRiscv
   template <typename URV>
   class Core;
 
+  template <typename URV>
+  class Syscall;
+
   /// Page attributes.
   struct PageAttribs
   {
@@ -213,6 +216,8 @@ namespace WdRiscv
 
     friend class Core<uint32_t>;
     friend class Core<uint64_t>;
+    friend class Syscall<uint32_t>;
+    friend class Syscall<uint64_t>;
 
     /// Constructor: define a memory of the given size initialized to
     /// zero. Given memory size (byte count) must be a multiple of 4
@@ -519,6 +524,12 @@ namespace WdRiscv
     /// zero up to n-1 where n is the minimum of the sizes.
     void copy(const Memory& other);
 
+    /// Return the number of pages of this memory that have been
+    /// touched (read, written or loaded) since the memory was
+    /// created. This is obtained from the host (pages backed by
+    /// physical memory) and costs nothing during simulation.
+    size_t countTouchedPages() const;
+
   protected:
 
     /// Same as write but effects not recorded in last-write info.
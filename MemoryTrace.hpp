@@ -0,0 +1,239 @@
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2018 Western Digital Corporation or its affiliates.
+//
+// This program is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+
+namespace WdRiscv
+{
+
+  /// Write a stream of memory access records (instruction fetches,
+  /// loads and stores) to a binary file. Records are encoded in a
+  /// buffer which is handed to a background thread for writing when
+  /// full so that the simulation does not wait on file output.
+  ///
+  /// The file starts with the 4 bytes "WMT1" followed by one byte
+  /// holding XLEN. Each record then consists of:
+  ///   - A flags byte: bits 0-1 access type (0 fetch, 1 load, 2
+  ///     store), bit 2 DCCM access, bits 3-5 log2 of the access size,
+  ///     bit 6 set if the pc is that of the previous record.
+  ///   - For a load/store whose bit 6 is clear: the pc minus the pc
+  ///     of the previous record (zigzag varint). A fetch record has no
+  ///     pc field: its pc is its address.
+  ///   - The address minus the address of the previous record of the
+  ///     same stream (fetch or load/store) as a zigzag varint.
+  /// A zigzag varint encodes a signed value v as the unsigned value
+  /// (v << 1) ^ (v >> 63) written 7 bits per byte, least significant
+  /// first, with bit 7 set on all but the last byte.
+  class MemoryTrace
+  {
+  public:
+
+    enum class Access : uint8_t { Fetch = 0, Load = 1, Store = 2 };
+
+    ~MemoryTrace()
+    { close(); }
+
+    /// Open the given file for output and start the writer thread.
+    /// If fetches is true, instruction fetches are recorded in
+    /// addition to loads/stores. Return false if file cannot be
+    /// opened.
+    bool open(const std::string& path, unsigned xlen, bool fetches)
+    {
+      close();
+      file_ = fopen(path.c_str(), "wb");
+      if (not file_)
+	return false;
+
+      fill_.resize(bufferSize);
+      pending_.resize(bufferSize);
+      pos_ = 0;
+      prevPc_ = prevFetch_ = prevData_ = 0;
+      records_ = 0;
+      bytes_ = 0;
+      done_ = hasPending_ = false;
+
+      const uint8_t header[] = { 'W', 'M', 'T', '1', uint8_t(xlen) };
+      for (uint8_t byte : header)
+	fill_[pos_++] = byte;
+
+      fetches_ = fetches;
+      active_ = true;
+      writer_ = std::thread(&MemoryTrace::writerLoop, this);
+      return true;
+    }
+
+    /// Write all buffered records, stop the writer thread and close
+    /// the file.
+    void close()
+    {
+      if (not file_)
+	return;
+      handOff();
+      {
+	std::unique_lock<std::mutex> lock(mutex_);
+	done_ = true;
+      }
+      cond_.notify_all();
+      writer_.join();
+      fclose(file_);
+      file_ = nullptr;
+      active_ = fetches_ = false;
+    }
+
+    /// Suspend/resume recording (file remains open).
+    void enable(bool flag)
+    { active_ = flag and file_; }
+
+    /// Return true if loads/stores are being recorded.
+    bool enabled() const
+    { return active_; }
+
+    /// Return true if instruction fetches are being recorded.
+    bool fetchesEnabled() const
+    { return active_ and fetches_; }
+
+    /// Record an access of the given type and size (in bytes, power of
+    /// 2) at the given address by the instruction at pc.
+    void record(Access type, uint64_t pc, uint64_t addr, unsigned size,
+		bool dccm)
+    {
+      if (pos_ + maxRecordSize > fill_.size())
+	handOff();
+
+      uint8_t* out = fill_.data() + pos_;
+      uint8_t* flags = out++;
+      *flags = uint8_t(type) | (dccm << 2) | ((__builtin_ctz(size) & 7) << 3);
+
+      if (type == Access::Fetch)
+	{
+	  out = putDelta(out, addr - prevFetch_);
+	  prevFetch_ = addr;
+	  prevPc_ = addr;
+	}
+      else
+	{
+	  if (pc == prevPc_)
+	    *flags |= 0x40;
+	  else
+	    out = putDelta(out, pc - prevPc_);
+	  out = putDelta(out, addr - prevData_);
+	  prevData_ = addr;
+	  prevPc_ = pc;
+	}
+
+      pos_ = out - fill_.data();
+      records_++;
+    }
+
+    /// Return the count of records written so far.
+    uint64_t records() const
+    { return records_; }
+
+    /// Return the count of bytes handed to the writer so far.
+    uint64_t bytes() const
+    { return bytes_ + pos_; }
+
+  protected:
+
+    static constexpr size_t bufferSize = size_t(1) << 20;
+    static constexpr size_t maxRecordSize = 1 + 10 + 10;
+
+    /// Append the zigzag varint encoding of the given (two's
+    /// complement) difference at out. Return the address following the
+    /// encoding.
+    static uint8_t* putDelta(uint8_t* out, uint64_t delta)
+    {
+      uint64_t zz = (delta << 1) ^ uint64_t(int64_t(delta) >> 63);
+      while (zz >= 0x80)
+	{
+	  *out++ = uint8_t(zz) | 0x80;
+	  zz >>= 7;
+	}
+      *out++ = uint8_t(zz);
+      return out;
+    }
+
+    /// Hand the fill buffer to the writer thread waiting for it to be
+    /// done with the previous buffer.
+    void handOff()
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cond_.wait(lock, [this] { return not hasPending_; });
+      fill_.swap(pending_);
+      pendingSize_ = pos_;
+      hasPending_ = true;
+      bytes_ += pos_;
+      pos_ = 0;
+      lock.unlock();
+      cond_.notify_all();
+    }
+
+    /// Body of the writer thread.
+    void writerLoop()
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      while (true)
+	{
+	  cond_.wait(lock, [this] { return hasPending_ or done_; });
+	  if (hasPending_)
+	    {
+	      lock.unlock();
+	      fwrite(pending_.data(), 1, pendingSize_, file_);
+	      lock.lock();
+	      hasPending_ = false;
+	      cond_.notify_all();
+	    }
+	  else if (done_)
+	    break;
+	}
+      fflush(file_);
+    }
+
+  private:
+
+    FILE* file_ = nullptr;
+    bool active_ = false;
+    bool fetches_ = false;
+
+    std::vector<uint8_t> fill_;     // Buffer being filled.
+    size_t pos_ = 0;                // Bytes used in fill_.
+    std::vector<uint8_t> pending_;  // Buffer being written.
+    size_t pendingSize_ = 0;
+    bool hasPending_ = false;
+    bool done_ = false;
+
+    std::thread writer_;
+    std::mutex mutex_;
+    std::condition_variable cond_;
+
+    uint64_t prevPc_ = 0;
+    uint64_t prevFetch_ = 0;
+    uint64_t prevData_ = 0;
+    uint64_t records_ = 0;
+    uint64_t bytes_ = 0;
+  };
+}
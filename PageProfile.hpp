@@ -0,0 +1,260 @@
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2018 Western Digital Corporation or its affiliates.
+//
+// This program is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include <array>
+#include <memory>
+#include <algorithm>
+
+
+namespace WdRiscv
+{
+
+  /// Per page memory access profile: Count of reads, writes and
+  /// instruction fetches of each page and the instruction count at
+  /// which each page was first touched (heat map) plus the count of
+  /// distinct pages touched in each interval of a given number of
+  /// instructions (working set over time). Accesses may be sampled:
+  /// with a sample period of N, one access out of N is recorded and
+  /// counted as N accesses (first touch and working set are then
+  /// approximate).
+  class PageProfile
+  {
+  public:
+
+    enum class Access { Fetch, Read, Write };
+
+    /// Start profiling pages of 2 to the power pageShift bytes
+    /// recording one access out of samplePeriod and collecting the
+    /// working set every interval instructions.
+    void start(unsigned pageShift, uint64_t samplePeriod, uint64_t interval)
+    {
+      pageShift_ = pageShift;
+      samplePeriod_ = std::max(samplePeriod, uint64_t(1));
+      countdown_ = samplePeriod_;
+      interval_ = std::max(interval, uint64_t(1));
+      intervalEnd_ = interval_;
+      intervalIx_ = 0;
+      intervalPages_ = footprint_ = 0;
+      chunks_.clear();
+      workingSet_.clear();
+      lastPage_ = nullptr;
+      started_ = active_ = true;
+    }
+
+    /// Suspend/resume profiling (collected data is kept).
+    void enable(bool flag)
+    { active_ = flag and started_; }
+
+    /// Return true if profiling is active.
+    bool enabled() const
+    { return active_; }
+
+    /// Return true if profiling was started (see start).
+    bool started() const
+    { return started_; }
+
+    /// Record an access of the given type to the given address made
+    /// while executing the instruction with the given count.
+    void access(Access type, uint64_t addr, uint64_t instCount)
+    {
+      if (samplePeriod_ > 1)
+	{
+	  if (--countdown_)
+	    return;
+	  countdown_ = samplePeriod_;
+	}
+
+      if (instCount >= intervalEnd_)
+	closeIntervals(instCount);
+
+      uint64_t pageNum = addr >> pageShift_;
+      if (not lastPage_ or pageNum != lastPageNum_)
+	{
+	  lastPage_ = &findPage(pageNum);
+	  lastPageNum_ = pageNum;
+	}
+      Page& page = *lastPage_;
+      if (type == Access::Read)
+	page.reads_ += samplePeriod_;
+      else if (type == Access::Write)
+	page.writes_ += samplePeriod_;
+      else
+	page.fetches_ += samplePeriod_;
+
+      if (page.firstTouch_ == notTouched)
+	{
+	  page.firstTouch_ = instCount;
+	  footprint_++;
+	}
+      if (page.interval_ != intervalIx_)
+	{
+	  page.interval_ = intervalIx_;
+	  intervalPages_++;
+	}
+    }
+
+    /// Write the heat map, the access coverage summary and the working
+    /// set curve to the given file. The instCount is the count of
+    /// executed instructions at the end of the run.
+    void report(FILE* file, uint64_t instCount)
+    {
+      closeIntervals(instCount);
+      if (intervalPages_)
+	workingSet_.push_back(Sample{instCount, intervalPages_, footprint_});
+      intervalPages_ = 0;
+
+      std::vector<std::pair<uint64_t, const Page*>> pages;
+      for (size_t chunkIx = 0; chunkIx < chunks_.size(); ++chunkIx)
+	if (chunks_[chunkIx])
+	  for (size_t i = 0; i < chunkSize; ++i)
+	    {
+	      const Page& page = (*chunks_[chunkIx])[i];
+	      if (page.firstTouch_ != notTouched)
+		pages.push_back(std::make_pair((chunkIx*chunkSize + i) << pageShift_,
+					       &page));
+	    }
+
+      uint64_t pageSize = uint64_t(1) << pageShift_;
+      fprintf(file, "# Page heat map: page size %lu bytes, sample period %lu, "
+	      "%lu pages touched\n", (unsigned long) pageSize,
+	      (unsigned long) samplePeriod_, (unsigned long) pages.size());
+      fprintf(file, "# %-16s %14s %14s %14s %14s\n", "page", "reads", "writes",
+	      "fetches", "first_touch");
+      for (const auto& entry : pages)
+	{
+	  const Page& page = *entry.second;
+	  fprintf(file, "  0x%-14lx %14lu %14lu %14lu %14lu\n",
+		  (unsigned long) entry.first, (unsigned long) page.reads_,
+		  (unsigned long) page.writes_, (unsigned long) page.fetches_,
+		  (unsigned long) page.firstTouch_);
+	}
+
+      // Bytes of the hottest pages needed to cover a fraction of the
+      // data (read/write) and of the fetch accesses: Guide to sizing
+      // DCCM/ICCM.
+      fprintf(file, "\n# Coverage: bytes of the hottest pages covering a "
+	      "fraction of the accesses\n");
+      fprintf(file, "# %-8s %12s %12s %12s %12s\n", "accesses", "50%", "90%",
+	      "99%", "100%");
+      auto coverage = [&] (const char* tag, auto count) {
+	std::vector<uint64_t> counts;
+	uint64_t total = 0;
+	for (const auto& entry : pages)
+	  if (uint64_t n = count(*entry.second))
+	    {
+	      counts.push_back(n);
+	      total += n;
+	    }
+	std::sort(counts.rbegin(), counts.rend());
+	fprintf(file, "  %-8s", tag);
+	for (double fraction : { 0.5, 0.9, 0.99, 1.0 })
+	  {
+	    uint64_t sum = 0, needed = 0;
+	    for ( ; needed < counts.size() and sum < fraction*total; ++needed)
+	      sum += counts.at(needed);
+	    fprintf(file, " %12lu", (unsigned long) (needed * pageSize));
+	  }
+	fprintf(file, "\n");
+      };
+      coverage("data", [] (const Page& p) { return p.reads_ + p.writes_; });
+      coverage("fetch", [] (const Page& p) { return p.fetches_; });
+
+      fprintf(file, "\n# Working set: pages touched per interval of %lu "
+	      "instructions\n", (unsigned long) interval_);
+      fprintf(file, "# %-16s %14s %14s\n", "instructions", "interval_pages",
+	      "total_pages");
+      for (const auto& sample : workingSet_)
+	fprintf(file, "  %-16lu %14lu %14lu\n", (unsigned long) sample.end_,
+		(unsigned long) sample.pages_, (unsigned long) sample.footprint_);
+    }
+
+  protected:
+
+    static constexpr uint64_t notTouched = ~uint64_t(0);
+    static constexpr size_t chunkSize = 1024;   // Pages per chunk.
+
+    struct Page
+    {
+      uint64_t reads_ = 0;
+      uint64_t writes_ = 0;
+      uint64_t fetches_ = 0;
+      uint64_t firstTouch_ = notTouched;  // Instruction count.
+      uint64_t interval_ = notTouched;    // Last interval touched.
+    };
+
+    typedef std::array<Page, chunkSize> Chunk;
+
+    /// Working set sample.
+    struct Sample
+    {
+      uint64_t end_;        // Instruction count at end of interval.
+      uint64_t pages_;      // Pages touched in interval.
+      uint64_t footprint_;  // Pages touched since start.
+    };
+
+    /// Return the entry of the page with the given number. Pages are
+    /// allocated in chunks on first touch.
+    Page& findPage(uint64_t pageNum)
+    {
+      size_t chunkIx = pageNum / chunkSize;
+      if (chunkIx >= chunks_.size())
+	chunks_.resize(chunkIx + 1);
+      auto& chunk = chunks_[chunkIx];
+      if (not chunk)
+	chunk = std::make_unique<Chunk>();
+      return (*chunk)[pageNum % chunkSize];
+    }
+
+    /// Record the working set of the intervals ending at or before the
+    /// given instruction count.
+    void closeIntervals(uint64_t instCount)
+    {
+      while (instCount >= intervalEnd_)
+	{
+	  workingSet_.push_back(Sample{intervalEnd_, intervalPages_, footprint_});
+	  intervalPages_ = 0;
+	  intervalIx_++;
+	  intervalEnd_ += interval_;
+	}
+    }
+
+  private:
+
+    bool started_ = false;
+    bool active_ = false;
+    unsigned pageShift_ = 12;
+    uint64_t samplePeriod_ = 1;
+    uint64_t countdown_ = 1;
+
+    uint64_t interval_ = 1000000;  // Instructions per working set sample.
+    uint64_t intervalEnd_ = 1000000;
+    uint64_t intervalIx_ = 0;
+    uint64_t intervalPages_ = 0;   // Pages touched in current interval.
+    uint64_t footprint_ = 0;       // Pages touched since start.
+
+    std::vector<std::unique_ptr<Chunk>> chunks_;  // Allocated on demand.
+    Page* lastPage_ = nullptr;     // Entry of most recently accessed page.
+    uint64_t lastPageNum_ = 0;
+    std::vector<Sample> workingSet_;
+  };
+}
@@ -16,7 +16,6 @@
 // this program. If not, see <https://www.gnu.org/licenses/>.
 //
 
-#include <algorithm>
 #include "PerfRegs.hpp"
 
 
@@ -41,7 +40,6 @@ PerfRegs::config(unsigned numCounters)
 
   unsigned numEvents = unsigned(EventNumber::_End);
   countersOfEvent_.resize(numEvents);
-  modified_.resize(numEvents);
 }
 
 
@@ -58,12 +56,17 @@ PerfRegs::assignEventToCounter(EventNumber event, unsigned counter)
   EventNumber prevEvent = eventOfCounter_.at(counter);
   if (prevEvent != EventNumber::None)
     {
-      auto& vec = countersOfEvent_.at(size_t(prevEvent));
-      vec.erase(std::remove(vec.begin(), vec.end(), counter), vec.end());
+      auto& mask = countersOfEvent_.at(size_t(prevEvent));
+      mask &= ~(uint32_t(1) << counter);
+      if (mask == 0)
+	assignedEvents_ &= ~(uint64_t(1) << unsigned(prevEvent));
     }
 
   if (event != EventNumber::None)
-    countersOfEvent_.at(size_t(event)).push_back(counter);
+    {
+      countersOfEvent_.at(size_t(event)) |= uint32_t(1) << counter;
+      assignedEvents_ |= uint64_t(1) << unsigned(event);
+    }
 
   eventOfCounter_.at(counter) = event;
   return true;
@@ -92,7 +92,9 @@ namespace WdRiscv
       DbusBusy,          // 48: Cycles stalled due to Dbus busy 
       InetrruptDisabled, // 49: Cycles interrupts disabled 
       InterrutpStall,    // 50: Cycles interrupts stalled while disabled
-      _End               // 51: Non-event serving as count of events
+      DCacheHits,        // 51: Data cache hits
+      DCacheMisses,      // 52: Data cache misses
+      _End               // 53: Non-event serving as count of events
     };
 
 
@@ -129,15 +131,48 @@ namespace WdRiscv
       size_t eventIx = size_t(event);
       if (eventIx >= countersOfEvent_.size())
 	return false;
-      const auto& counterIndices = countersOfEvent_.at(eventIx);
-      for (auto counterIx : counterIndices)
+      uint32_t mask = countersOfEvent_[eventIx];
+      modified_ |= mask;
+      while (mask)
 	{
-	  counters_.at(counterIx)++;
-	  modified_.at(counterIx) = true;
+	  unsigned counterIx = __builtin_ctz(mask);
+	  counters_[counterIx]++;
+	  mask &= mask - 1;
 	}
       return true;
     }
 
+    /// Add count to all the performance counters currently
+    /// associated with the given event. Unlike the above, the counters
+    /// are not marked as modified.
+    bool updateCounters(EventNumber event, uint64_t count)
+    {
+      size_t eventIx = size_t(event);
+      if (eventIx >= countersOfEvent_.size())
+	return false;
+      uint32_t mask = countersOfEvent_[eventIx];
+      if (count == 0)
+	return true;
+      while (mask)
+	{
+	  unsigned counterIx = __builtin_ctz(mask);
+	  counters_[counterIx] += count;
+	  mask &= mask - 1;
+	}
+      return true;
+    }
+
+    /// Return true if at least one event is associated with a
+    /// counter. If this returns false, then updateCounters is a no-op
+    /// for all events.
+    bool hasAssignedEvents() const
+    { return assignedEvents_ != 0; }
+
+    /// Return true if given event is associated with at least one
+    /// counter.
+    bool isEventAssigned(EventNumber event) const
+    { return (assignedEvents_ >> unsigned(event)) & 1; }
+
     /// Associate given event number with given counter.
     /// Subsequent calls to updatePerofrmanceCounters(en) will cause
     /// given counter to count up by 1. Return true on success. Return
@@ -149,30 +184,32 @@ namespace WdRiscv
     /// Unmark registers marked as modified by current instruction. This
     /// is done at the end of each instruction.
     void clearModified()
-    {
-      for (auto& m : modified_)
-	m = false;
-    }
+    { modified_ = 0; }
 
     /// Return true if given number corresponds to a valid performance
     /// counter and if that counter was modified by the current
     /// instruction.
     bool isModified(unsigned ix)
     {
-      if (ix < modified_.size()) return modified_[ix];
+      if (ix < counters_.size()) return (modified_ >> ix) & 1;
       return false;
     }
 
   private:
 
+    static_assert(unsigned(EventNumber::_End) <= 64);
+
     // Map counter index to event currently associated with counter.
     std::vector<EventNumber> eventOfCounter_;
 
-    // Map an event number to a vector containing the indices of the
-    // counters currently associated with that event.
-    std::vector< std::vector<unsigned> > countersOfEvent_;
+    // Map an event number to a mask of the counters currently
+    // associated with that event: bit i set if counter i is.
+    std::vector<uint32_t> countersOfEvent_;
+
+    // Bit e set if event e is associated with at least one counter.
+    uint64_t assignedEvents_ = 0;
 
     std::vector<uint64_t> counters_;
-    std::vector<unsigned> modified_;
+    uint32_t modified_ = 0;  // Bit i set if counter i modified.
   };
 }
@@ -0,0 +1,640 @@
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2018 Western Digital Corporation or its affiliates.
+//
+// This program is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <utility>
+#include "SoftFloat.hpp"
+
+
+using namespace WdRiscv;
+
+
+// All operations are done on unpacked numbers: a finite non-zero
+// number is represented by a sign, an integer significand (sig) and
+// an exponent (exp) such that its magnitude is sig * 2^exp. The
+// significand is held in an integer type (WIDE) wide enough for the
+// exact product of two significands. Results are produced by
+// roundPack which rounds an exact (sig, exp) pair to the target
+// format. Operations whose exact result cannot be held in WIDE (div,
+// sqrt, addition of operands with far apart exponents) fold the
+// discarded bits into a "sticky" least significant bit placed below
+// the rounding position.
+
+
+/// Parameters of a binary floating point format.
+template <typename UINT, typename WIDE, unsigned EXP_BITS, unsigned MANT_BITS>
+struct FpFormat
+{
+  typedef UINT Uint;
+  typedef WIDE Wide;
+
+  static constexpr unsigned mantBits = MANT_BITS;
+  static constexpr unsigned expBits = EXP_BITS;
+  static constexpr int bias = (1 << (EXP_BITS - 1)) - 1;
+  static constexpr unsigned expMax = (1u << EXP_BITS) - 1;
+
+  static constexpr UINT signBit = UINT(1) << (EXP_BITS + MANT_BITS);
+  static constexpr UINT mantMask = (UINT(1) << MANT_BITS) - 1;
+  static constexpr UINT infinity = UINT(expMax) << MANT_BITS;
+  static constexpr UINT maxFinite = infinity - 1;
+  static constexpr UINT defaultNan = infinity | (UINT(1) << (MANT_BITS - 1));
+
+  // Position of most significant bit of addition operands: Leaves room
+  // for the carry of the sum and keeps the sum positive in WIDE.
+  static constexpr unsigned wideBits = 8*sizeof(WIDE);
+  static constexpr unsigned addTop = wideBits - 3;
+
+  static unsigned expField(UINT x)
+  { return (x >> MANT_BITS) & expMax; }
+
+  static bool isNan(UINT x)
+  { return expField(x) == expMax and (x & mantMask) != 0; }
+
+  static bool isSnan(UINT x)
+  { return isNan(x) and ((x >> (MANT_BITS - 1)) & 1) == 0; }
+
+  static bool isInf(UINT x)
+  { return (x & ~signBit) == infinity; }
+
+  static bool isZero(UINT x)
+  { return (x & ~signBit) == 0; }
+
+  static bool sign(UINT x)
+  { return (x & signBit) != 0; }
+
+  static UINT zero(bool sign)
+  { return sign? signBit : 0; }
+
+  static UINT inf(bool sign)
+  { return infinity | zero(sign); }
+};
+
+
+__extension__ typedef unsigned __int128 Uint128;
+
+typedef FpFormat<uint32_t, uint64_t, 8, 23> Fp32;
+typedef FpFormat<uint64_t, Uint128, 11, 52> Fp64;
+
+
+/// Return the position of the most significant bit of x. X must not
+/// be zero.
+static inline unsigned
+msb(uint64_t x)
+{
+  return 63 - __builtin_clzll(x);
+}
+
+
+static inline unsigned
+msb(Uint128 x)
+{
+  uint64_t high = uint64_t(x >> 64);
+  if (high)
+    return 127 - __builtin_clzll(high);
+  return msb(uint64_t(x));
+}
+
+
+/// Shift x right by n bits or-ing the discarded bits into the least
+/// significant bit of the result.
+template <typename WIDE>
+static inline WIDE
+shiftRightJam(WIDE x, unsigned n)
+{
+  if (n == 0)
+    return x;
+  if (n >= 8*sizeof(WIDE))
+    return x != 0;
+  WIDE lost = x & ((WIDE(1) << n) - 1);
+  return (x >> n) | (lost != 0);
+}
+
+
+/// Return true if a value with the given least significant kept bit,
+/// round bit (first discarded bit) and sticky bit (or of remaining
+/// discarded bits) should be incremented in the given rounding mode.
+static inline bool
+roundIncrement(RoundingMode mode, bool sign, bool lsb, bool round,
+	       bool sticky)
+{
+  switch (mode)
+    {
+    case RoundingMode::NearestEven: return round and (sticky or lsb);
+    case RoundingMode::NearestMax:  return round;
+    case RoundingMode::Down:        return (round or sticky) and sign;
+    case RoundingMode::Up:          return (round or sticky) and not sign;
+    default:                        return false;
+    }
+}
+
+
+/// Round the number of given sign with magnitude sig * 2^exp (sig
+/// non-zero) to format F returning the resulting bit pattern.
+template <typename F>
+static typename F::Uint
+roundPack(bool sign, int exp, typename F::Wide sig, RoundingMode mode,
+	  unsigned& flags)
+{
+  typedef typename F::Uint Uint;
+  typedef typename F::Wide Wide;
+  const int mantBits = F::mantBits;
+
+  int p = msb(sig);
+  int biasedExp = p + exp + F::bias;
+  bool subnormal = biasedExp < 1;
+
+  // Number of bits to discard: keep mantBits+1 bits for a normal
+  // result; keep bits down to the least significant subnormal
+  // position (2^(1-bias-mantBits)) for a subnormal result.
+  int shift = subnormal? (1 - F::bias - mantBits) - exp : p - mantBits;
+
+  Wide kept = 0;
+  bool round = false, sticky = false;
+  if (shift <= 0)
+    kept = sig << -shift;
+  else if (shift > p + 1)
+    sticky = true;
+  else
+    {
+      kept = shift < int(F::wideBits) ? sig >> shift : 0;
+      round = (sig >> (shift - 1)) & 1;
+      sticky = (sig & ((Wide(1) << (shift - 1)) - 1)) != 0;
+    }
+
+  bool inexact = round or sticky;
+  bool inc = roundIncrement(mode, sign, kept & 1, round, sticky);
+
+  // Subnormal results are packed with a zero exponent field: A
+  // carry out of the significand correctly produces the smallest
+  // normal number. Normal results are packed with the hidden bit
+  // added to the exponent field (hence biasedExp - 1): A carry out
+  // of the significand correctly increments the exponent.
+  Wide packed = kept + inc;
+  if (not subnormal)
+    packed += Wide(biasedExp - 1) << mantBits;
+
+  if ((packed >> mantBits) >= F::expMax)
+    {
+      flags |= unsigned(FpFlags::Overflow) | unsigned(FpFlags::Inexact);
+      bool toInf = (mode == RoundingMode::NearestEven or
+		    mode == RoundingMode::NearestMax or
+		    (mode == RoundingMode::Down and sign) or
+		    (mode == RoundingMode::Up and not sign));
+      return toInf? F::inf(sign) : (F::maxFinite | F::zero(sign));
+    }
+
+  if (inexact)
+    {
+      flags |= unsigned(FpFlags::Inexact);
+
+      // Tininess after rounding: The result is tiny if rounding it
+      // with an unbounded exponent range would yield a magnitude less
+      // than the smallest normal number.
+      bool tiny = subnormal;
+      if (subnormal and biasedExp == 0 and p >= mantBits)
+	{
+	  int fullShift = p - mantBits;   // Discard for full precision.
+	  Wide fullKept = sig >> fullShift;
+	  bool fullRound = fullShift > 0 and ((sig >> (fullShift - 1)) & 1);
+	  bool fullSticky = (fullShift > 1 and
+			     (sig & ((Wide(1) << (fullShift - 1)) - 1)) != 0);
+	  Wide allOnes = (Wide(1) << (mantBits + 1)) - 1;
+	  if (fullKept == allOnes and
+	      roundIncrement(mode, sign, true, fullRound, fullSticky))
+	    tiny = false;
+	}
+      if (tiny)
+	flags |= unsigned(FpFlags::Underflow);
+    }
+
+  return Uint(packed) | F::zero(sign);
+}
+
+
+/// Unpack a finite non-zero number into significand and exponent
+/// such that its magnitude is sig * 2^exp.
+template <typename F>
+static void
+unpack(typename F::Uint x, int& exp, typename F::Wide& sig)
+{
+  unsigned field = F::expField(x);
+  sig = x & F::mantMask;
+  if (field == 0)
+    exp = 1 - F::bias - int(F::mantBits);
+  else
+    {
+      sig |= typename F::Wide(1) << F::mantBits;
+      exp = int(field) - F::bias - int(F::mantBits);
+    }
+}
+
+
+/// Unpack a finite non-zero number normalizing its significand so
+/// that its most significant bit is at position F::mantBits.
+template <typename F>
+static void
+unpackNormalized(typename F::Uint x, int& exp, typename F::Wide& sig)
+{
+  unpack<F>(x, exp, sig);
+  int shift = int(F::mantBits) - int(msb(sig));
+  sig <<= shift;
+  exp -= shift;
+}
+
+
+/// Add two finite non-zero unpacked numbers (signed magnitudes
+/// sigA*2^expA and sigB*2^expB) and round the result. Significands
+/// must not be wider than F::addTop bits.
+template <typename F>
+static typename F::Uint
+addUnpacked(bool signA, int expA, typename F::Wide sigA,
+	    bool signB, int expB, typename F::Wide sigB,
+	    RoundingMode mode, unsigned& flags)
+{
+  typedef typename F::Wide Wide;
+
+  // Align most significant bits at addTop. This is exact.
+  int shiftA = int(F::addTop) - int(msb(sigA));
+  sigA <<= shiftA;
+  expA -= shiftA;
+  int shiftB = int(F::addTop) - int(msb(sigB));
+  sigB <<= shiftB;
+  expB -= shiftB;
+
+  // Make A the operand of larger magnitude.
+  if (expA < expB or (expA == expB and sigA < sigB))
+    {
+      std::swap(signA, signB);
+      std::swap(expA, expB);
+      std::swap(sigA, sigB);
+    }
+
+  sigB = shiftRightJam(sigB, unsigned(expA - expB));
+
+  Wide sig = (signA == signB)? sigA + sigB : sigA - sigB;
+  if (sig == 0)
+    return F::zero(mode == RoundingMode::Down);
+
+  return roundPack<F>(signA, expA, sig, mode, flags);
+}
+
+
+template <typename F>
+static typename F::Uint
+addImpl(typename F::Uint a, typename F::Uint b, RoundingMode mode,
+	unsigned& flags)
+{
+  if (F::isNan(a) or F::isNan(b))
+    {
+      if (F::isSnan(a) or F::isSnan(b))
+	flags |= unsigned(FpFlags::Invalid);
+      return F::defaultNan;
+    }
+
+  bool signA = F::sign(a), signB = F::sign(b);
+
+  if (F::isInf(a))
+    {
+      if (F::isInf(b) and signA != signB)
+	{
+	  flags |= unsigned(FpFlags::Invalid);
+	  return F::defaultNan;
+	}
+      return a;
+    }
+  if (F::isInf(b))
+    return b;
+
+  if (F::isZero(a) and F::isZero(b))
+    return F::zero(signA == signB? signA : mode == RoundingMode::Down);
+  if (F::isZero(a))
+    return b;
+  if (F::isZero(b))
+    return a;
+
+  int expA = 0, expB = 0;
+  typename F::Wide sigA = 0, sigB = 0;
+  unpack<F>(a, expA, sigA);
+  unpack<F>(b, expB, sigB);
+  return addUnpacked<F>(signA, expA, sigA, signB, expB, sigB, mode, flags);
+}
+
+
+template <typename F>
+static typename F::Uint
+mulImpl(typename F::Uint a, typename F::Uint b, RoundingMode mode,
+	unsigned& flags)
+{
+  if (F::isNan(a) or F::isNan(b))
+    {
+      if (F::isSnan(a) or F::isSnan(b))
+	flags |= unsigned(FpFlags::Invalid);
+      return F::defaultNan;
+    }
+
+  bool sign = F::sign(a) != F::sign(b);
+
+  if (F::isInf(a) or F::isInf(b))
+    {
+      if (F::isZero(a) or F::isZero(b))
+	{
+	  flags |= unsigned(FpFlags::Invalid);
+	  return F::defaultNan;
+	}
+      return F::inf(sign);
+    }
+
+  if (F::isZero(a) or F::isZero(b))
+    return F::zero(sign);
+
+  int expA = 0, expB = 0;
+  typename F::Wide sigA = 0, sigB = 0;
+  unpack<F>(a, expA, sigA);
+  unpack<F>(b, expB, sigB);
+  return roundPack<F>(sign, expA + expB, sigA * sigB, mode, flags);
+}
+
+
+template <typename F>
+static typename F::Uint
+divImpl(typename F::Uint a, typename F::Uint b, RoundingMode mode,
+	unsigned& flags)
+{
+  typedef typename F::Wide Wide;
+
+  if (F::isNan(a) or F::isNan(b))
+    {
+      if (F::isSnan(a) or F::isSnan(b))
+	flags |= unsigned(FpFlags::Invalid);
+      return F::defaultNan;
+    }
+
+  bool sign = F::sign(a) != F::sign(b);
+
+  if (F::isInf(a))
+    {
+      if (F::isInf(b))
+	{
+	  flags |= unsigned(FpFlags::Invalid);
+	  return F::defaultNan;
+	}
+      return F::inf(sign);
+    }
+  if (F::isInf(b))
+    return F::zero(sign);
+
+  if (F::isZero(b))
+    {
+      if (F::isZero(a))
+	{
+	  flags |= unsigned(FpFlags::Invalid);
+	  return F::defaultNan;
+	}
+      flags |= unsigned(FpFlags::DivByZero);
+      return F::inf(sign);
+    }
+  if (F::isZero(a))
+    return F::zero(sign);
+
+  // With both significands normalized, the quotient of sigA shifted
+  // by mantBits+3 has at least mantBits+3 bits: enough for a round
+  // bit and a sticky bit below the rounding position.
+  int expA = 0, expB = 0;
+  Wide sigA = 0, sigB = 0;
+  unpackNormalized<F>(a, expA, sigA);
+  unpackNormalized<F>(b, expB, sigB);
+
+  const int extra = F::mantBits + 3;
+  Wide num = sigA << extra;
+  Wide quot = num / sigB;
+  bool rem = quot * sigB != num;
+  Wide sig = (quot << 1) | rem;
+  return roundPack<F>(sign, expA - expB - extra - 1, sig, mode, flags);
+}
+
+
+/// Return the integer square root of x setting exact to true if x is
+/// a perfect square.
+template <typename WIDE>
+static WIDE
+integerSqrt(WIDE x, bool& exact)
+{
+  WIDE res = 0;
+  WIDE bit = WIDE(1) << (msb(x) & ~1u);
+  while (bit)
+    {
+      if (x >= res + bit)
+	{
+	  x -= res + bit;
+	  res = (res >> 1) + bit;
+	}
+      else
+	res >>= 1;
+      bit >>= 2;
+    }
+  exact = x == 0;
+  return res;
+}
+
+
+template <typename F>
+static typename F::Uint
+sqrtImpl(typename F::Uint a, RoundingMode mode, unsigned& flags)
+{
+  typedef typename F::Wide Wide;
+
+  if (F::isNan(a))
+    {
+      if (F::isSnan(a))
+	flags |= unsigned(FpFlags::Invalid);
+      return F::defaultNan;
+    }
+
+  if (F::isZero(a))
+    return a;
+
+  if (F::sign(a))
+    {
+      flags |= unsigned(FpFlags::Invalid);
+      return F::defaultNan;
+    }
+
+  if (F::isInf(a))
+    return a;
+
+  int exp = 0;
+  Wide sig = 0;
+  unpackNormalized<F>(a, exp, sig);
+
+  // Make exponent even. Scale significand so that its root has at
+  // least mantBits+3 bits.
+  if (exp & 1)
+    {
+      sig <<= 1;
+      exp -= 1;
+    }
+  const int extra = F::mantBits/2 + 3;
+  sig <<= 2*extra;
+
+  bool exact = false;
+  Wide root = integerSqrt(sig, exact);
+  Wide rootSig = (root << 1) | (not exact);
+  return roundPack<F>(false, exp/2 - extra - 1, rootSig, mode, flags);
+}
+
+
+template <typename F>
+static typename F::Uint
+fmaImpl(typename F::Uint a, typename F::Uint b, typename F::Uint c,
+	RoundingMode mode, unsigned& flags)
+{
+  bool infTimesZero = ((F::isInf(a) and F::isZero(b)) or
+		       (F::isZero(a) and F::isInf(b)));
+
+  if (F::isNan(a) or F::isNan(b) or F::isNan(c))
+    {
+      // Invalid even if addend is a quiet NaN.
+      if (F::isSnan(a) or F::isSnan(b) or F::isSnan(c) or infTimesZero)
+	flags |= unsigned(FpFlags::Invalid);
+      return F::defaultNan;
+    }
+
+  bool signProd = F::sign(a) != F::sign(b);
+  bool signC = F::sign(c);
+
+  if (F::isInf(a) or F::isInf(b))
+    {
+      if (infTimesZero or (F::isInf(c) and signC != signProd))
+	{
+	  flags |= unsigned(FpFlags::Invalid);
+	  return F::defaultNan;
+	}
+      return F::inf(signProd);
+    }
+  if (F::isInf(c))
+    return c;
+
+  if (F::isZero(a) or F::isZero(b))
+    {
+      if (F::isZero(c))
+	return F::zero(signProd == signC? signC : mode == RoundingMode::Down);
+      return c;
+    }
+
+  int expA = 0, expB = 0;
+  typename F::Wide sigA = 0, sigB = 0;
+  unpack<F>(a, expA, sigA);
+  unpack<F>(b, expB, sigB);
+
+  typename F::Wide sigProd = sigA * sigB;
+  int expProd = expA + expB;
+
+  if (F::isZero(c))
+    return roundPack<F>(signProd, expProd, sigProd, mode, flags);
+
+  int expC = 0;
+  typename F::Wide sigC = 0;
+  unpack<F>(c, expC, sigC);
+  return addUnpacked<F>(signProd, expProd, sigProd, signC, expC, sigC,
+			mode, flags);
+}
+
+
+uint32_t
+SoftFloat::add(uint32_t a, uint32_t b, RoundingMode mode, unsigned& flags)
+{
+  return addImpl<Fp32>(a, b, mode, flags);
+}
+
+
+uint64_t
+SoftFloat::add(uint64_t a, uint64_t b, RoundingMode mode, unsigned& flags)
+{
+  return addImpl<Fp64>(a, b, mode, flags);
+}
+
+
+uint32_t
+SoftFloat::sub(uint32_t a, uint32_t b, RoundingMode mode, unsigned& flags)
+{
+  return addImpl<Fp32>(a, b ^ Fp32::signBit, mode, flags);
+}
+
+
+uint64_t
+SoftFloat::sub(uint64_t a, uint64_t b, RoundingMode mode, unsigned& flags)
+{
+  return addImpl<Fp64>(a, b ^ Fp64::signBit, mode, flags);
+}
+
+
+uint32_t
+SoftFloat::mul(uint32_t a, uint32_t b, RoundingMode mode, unsigned& flags)
+{
+  return mulImpl<Fp32>(a, b, mode, flags);
+}
+
+
+uint64_t
+SoftFloat::mul(uint64_t a, uint64_t b, RoundingMode mode, unsigned& flags)
+{
+  return mulImpl<Fp64>(a, b, mode, flags);
+}
+
+
+uint32_t
+SoftFloat::div(uint32_t a, uint32_t b, RoundingMode mode, unsigned& flags)
+{
+  return divImpl<Fp32>(a, b, mode, flags);
+}
+
+
+uint64_t
+SoftFloat::div(uint64_t a, uint64_t b, RoundingMode mode, unsigned& flags)
+{
+  return divImpl<Fp64>(a, b, mode, flags);
+}
+
+
+uint32_t
+SoftFloat::sqrt(uint32_t a, RoundingMode mode, unsigned& flags)
+{
+  return sqrtImpl<Fp32>(a, mode, flags);
+}
+
+
+uint64_t
+SoftFloat::sqrt(uint64_t a, RoundingMode mode, unsigned& flags)
+{
+  return sqrtImpl<Fp64>(a, mode, flags);
+}
+
+
+uint32_t
+SoftFloat::fma(uint32_t a, uint32_t b, uint32_t c, RoundingMode mode,
+	       unsigned& flags)
+{
+  return fmaImpl<Fp32>(a, b, c, mode, flags);
+}
+
+
+uint64_t
+SoftFloat::fma(uint64_t a, uint64_t b, uint64_t c, RoundingMode mode,
+	       unsigned& flags)
+{
+  return fmaImpl<Fp64>(a, b, c, mode, flags);
+}
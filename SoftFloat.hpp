@@ -0,0 +1,81 @@
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2018 Western Digital Corporation or its affiliates.
+//
+// This program is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <cstdint>
+#include "FpRegs.hpp"
+
+namespace WdRiscv
+{
+
+  /// Integer-only implementation of the IEEE-754 binary32 and binary64
+  /// arithmetic operations of the RISCV F and D extensions. Operands
+  /// and results are bit patterns: uint32_t for single precision and
+  /// uint64_t for double precision. Results are exact for all the
+  /// RISCV rounding modes including NearestMax (which has no host
+  /// equivalent) and do not depend on the host floating point
+  /// environment. NaN results are canonical. Exception flags (FpFlags
+  /// bits) raised by an operation are or-ed into the flags argument;
+  /// tininess is detected after rounding as required by RISCV.
+  class SoftFloat
+  {
+  public:
+
+    /// Return a + b.
+    static uint32_t add(uint32_t a, uint32_t b, RoundingMode mode,
+			unsigned& flags);
+    static uint64_t add(uint64_t a, uint64_t b, RoundingMode mode,
+			unsigned& flags);
+
+    /// Return a - b.
+    static uint32_t sub(uint32_t a, uint32_t b, RoundingMode mode,
+			unsigned& flags);
+    static uint64_t sub(uint64_t a, uint64_t b, RoundingMode mode,
+			unsigned& flags);
+
+    /// Return a * b.
+    static uint32_t mul(uint32_t a, uint32_t b, RoundingMode mode,
+			unsigned& flags);
+    static uint64_t mul(uint64_t a, uint64_t b, RoundingMode mode,
+			unsigned& flags);
+
+    /// Return a / b.
+    static uint32_t div(uint32_t a, uint32_t b, RoundingMode mode,
+			unsigned& flags);
+    static uint64_t div(uint64_t a, uint64_t b, RoundingMode mode,
+			unsigned& flags);
+
+    /// Return the square root of a.
+    static uint32_t sqrt(uint32_t a, RoundingMode mode, unsigned& flags);
+    static uint64_t sqrt(uint64_t a, RoundingMode mode, unsigned& flags);
+
+    /// Return a * b + c with a single rounding. The fmsub, fnmsub and
+    /// fnmadd instructions are obtained by flipping the sign bits of
+    /// the operands (not of the result) so that directed rounding
+    /// modes are honored.
+    static uint32_t fma(uint32_t a, uint32_t b, uint32_t c,
+			RoundingMode mode, unsigned& flags);
+    static uint64_t fma(uint64_t a, uint64_t b, uint64_t c,
+			RoundingMode mode, unsigned& flags);
+
+    /// Canonical (RISCV default) NaN bit patterns.
+    static constexpr uint32_t defaultNan32 = 0x7fc00000;
+    static constexpr uint64_t defaultNan64 = 0x7ff8000000000000;
+  };
+}
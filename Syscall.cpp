@@ -0,0 +1,961 @@
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2018 Western Digital Corporation or its affiliates.
+//
+// This program is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <iostream>
+#include <string>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <climits>
+#include <sys/stat.h>
+#include <sys/utsname.h>
+#include "Syscall.hpp"
+#include "Core.hpp"
+
+
+using namespace WdRiscv;
+
+
+// Linux RISCV system call numbers (asm-generic) and the newlib open
+// number.
+enum SyscallNumber
+  {
+    SysOpenat = 56, SysClose = 57, SysLseek = 62, SysRead = 63,
+    SysWrite = 64, SysWritev = 66, SysReadlinkat = 78, SysFstat = 80,
+    SysExit = 93, SysExitGroup = 94, SysClockGettime = 113, SysTimes = 153,
+    SysUname = 160, SysGettimeofday = 169, SysGetpid = 172, SysGetuid = 174,
+    SysGeteuid = 175, SysGetgid = 176, SysGetegid = 177, SysBrk = 214,
+    SysMunmap = 215, SysMmap = 222, SysOpen = 1024
+  };
+
+
+// Semihosting operation numbers.
+enum SemihostOp
+  {
+    SemiOpen = 0x01, SemiClose = 0x02, SemiWritec = 0x03, SemiWrite0 = 0x04,
+    SemiWrite = 0x05, SemiRead = 0x06, SemiReadc = 0x07, SemiIsError = 0x08,
+    SemiIsTty = 0x09, SemiSeek = 0x0a, SemiFlen = 0x0c, SemiRemove = 0x0e,
+    SemiRename = 0x0f, SemiClock = 0x10, SemiTime = 0x11, SemiErrno = 0x13,
+    SemiHeapInfo = 0x16, SemiExit = 0x18, SemiExitExtended = 0x20,
+    SemiElapsed = 0x30, SemiTickFreq = 0x31
+  };
+
+// Semihosting exit reason for a normal program exit.
+static constexpr unsigned AdpStoppedApplicationExit = 0x20026;
+
+
+// Target values of the mmap flags.
+static constexpr unsigned TargetMapFixed = 0x10;
+static constexpr unsigned TargetMapAnonymous = 0x20;
+
+// Space left for the stack between the stack pointer and the mmap
+// area.
+static constexpr uint64_t stackReserve = 8*1024*1024;
+
+
+template <typename URV>
+Syscall<URV>::Syscall(IntRegs<URV>& intRegs, Memory& memory)
+  : intRegs_(intRegs), memory_(memory), fdMap_{0, 1, 2}
+{
+  defineHandlers();
+}
+
+
+template <typename URV>
+Syscall<URV>::~Syscall()
+{
+  reset();
+}
+
+
+template <typename URV>
+void
+Syscall<URV>::defineHandlers()
+{
+  handlers_.assign(SysOpen + 1, nullptr);
+
+  handlers_.at(SysOpenat)       = &Syscall::doOpenat;
+  handlers_.at(SysClose)        = &Syscall::doClose;
+  handlers_.at(SysLseek)        = &Syscall::doLseek;
+  handlers_.at(SysRead)         = &Syscall::doRead;
+  handlers_.at(SysWrite)        = &Syscall::doWrite;
+  handlers_.at(SysWritev)       = &Syscall::doWritev;
+  handlers_.at(SysReadlinkat)   = &Syscall::doReadlinkat;
+  handlers_.at(SysFstat)        = &Syscall::doFstat;
+  handlers_.at(SysExit)         = &Syscall::doExit;
+  handlers_.at(SysExitGroup)    = &Syscall::doExit;
+  handlers_.at(SysClockGettime) = &Syscall::doClockGettime;
+  handlers_.at(SysTimes)        = &Syscall::doTimes;
+  handlers_.at(SysUname)        = &Syscall::doUname;
+  handlers_.at(SysGettimeofday) = &Syscall::doGettimeofday;
+  handlers_.at(SysGetpid)       = &Syscall::doGetpid;
+  handlers_.at(SysGetuid)       = &Syscall::doGetuid;
+  handlers_.at(SysGeteuid)      = &Syscall::doGeteuid;
+  handlers_.at(SysGetgid)       = &Syscall::doGetgid;
+  handlers_.at(SysGetegid)      = &Syscall::doGetegid;
+  handlers_.at(SysBrk)          = &Syscall::doBrk;
+  handlers_.at(SysMunmap)       = &Syscall::doMunmap;
+  handlers_.at(SysMmap)         = &Syscall::doMmap;
+  handlers_.at(SysOpen)         = &Syscall::doOpen;
+}
+
+
+template <typename URV>
+URV
+Syscall<URV>::emulate(uint64_t instCount)
+{
+  URV num = intRegs_.read(RegA7);
+  URV args[6];
+  for (unsigned i = 0; i < 6; ++i)
+    args[i] = intRegs_.read(RegA0 + i);
+
+  instCount_ = instCount;
+
+  Handler handler = num < handlers_.size() ? handlers_[num] : nullptr;
+  if (handler)
+    return (this->*handler)(args);
+
+  std::cerr << "Unimplemented syscall number " << num << "\n";
+  return SRV(-ENOSYS);
+}
+
+
+template <typename URV>
+void
+Syscall<URV>::setProgramBreak(URV addr)
+{
+  progBreak_ = addr;
+
+  size_t pageAddr = memory_.getPageStartAddr(addr);
+  if (pageAddr != addr)
+    progBreak_ = pageAddr + memory_.pageSize();
+}
+
+
+template <typename URV>
+void
+Syscall<URV>::reset()
+{
+  for (int fd : fdMap_)
+    if (fd > 2)
+      close(fd);
+  fdMap_ = { 0, 1, 2 };
+
+  mmapEnd_ = mmapLow_ = 0;
+  mmapFree_.clear();
+}
+
+
+template <typename URV>
+bool
+Syscall<URV>::hostAddr(URV addr, size_t size, void*& ptr)
+{
+  size_t memSize = memory_.size();
+  if (addr > memSize or size > memSize - addr)
+    return false;
+
+  size_t simAddr = 0;
+  if (not memory_.getSimMemAddr(addr, simAddr))
+    return size == 0 and addr == memSize;
+  ptr = reinterpret_cast<void*>(simAddr);
+  return true;
+}
+
+
+template <typename URV>
+bool
+Syscall<URV>::hostString(URV addr, const char*& str)
+{
+  size_t simAddr = 0;
+  if (not memory_.getSimMemAddr(addr, simAddr))
+    return false;
+  str = reinterpret_cast<const char*>(simAddr);
+  return memchr(str, 0, memory_.size() - addr) != nullptr;
+}
+
+
+template <typename URV>
+int
+Syscall<URV>::hostDirFd(URV fd) const
+{
+  if (SRV(fd) == AT_FDCWD)
+    return AT_FDCWD;
+  return hostFd(fd);
+}
+
+
+template <typename URV>
+typename Syscall<URV>::SRV
+Syscall<URV>::newTargetFd(int hostFd)
+{
+  for (size_t i = 0; i < fdMap_.size(); ++i)
+    if (fdMap_[i] < 0)
+      {
+	fdMap_[i] = hostFd;
+	return i;
+      }
+  fdMap_.push_back(hostFd);
+  return fdMap_.size() - 1;
+}
+
+
+template <typename URV>
+int
+Syscall<URV>::hostOpenFlags(URV flags)
+{
+  int hostFlags = 0;
+  if (flags & 1)     hostFlags |= O_WRONLY;
+  if (flags & 2)     hostFlags |= O_RDWR;
+  if (flags & 8)     hostFlags |= O_APPEND;
+  if (flags & 0x200) hostFlags |= O_CREAT;
+  if (flags & 0x400) hostFlags |= O_TRUNC;
+  if (flags & 0x800) hostFlags |= O_EXCL;
+  return hostFlags;
+}
+
+
+template <typename URV>
+uint64_t
+Syscall<URV>::simNanoseconds() const
+{
+  uint64_t sec = instCount_ / instPerSec_;
+  uint64_t rem = instCount_ % instPerSec_;
+  return sec*1000000000 + rem*1000000000 / instPerSec_;
+}
+
+
+template <typename URV>
+typename Syscall<URV>::SRV
+Syscall<URV>::writeTime(URV addr, uint64_t sec, uint64_t frac)
+{
+  // Target time_t is 64-bit (also on rv32), fraction is a long.
+  void* ptr = nullptr;
+  if (not hostAddr(addr, 8 + sizeof(URV), ptr))
+    return -EFAULT;
+  char* buf = static_cast<char*>(ptr);
+  int64_t secs = sec;
+  URV fraction = frac;
+  memcpy(buf, &secs, sizeof(secs));
+  memcpy(buf + 8, &fraction, sizeof(fraction));
+  return 0;
+}
+
+
+template <typename URV>
+typename Syscall<URV>::SRV
+Syscall<URV>::doOpenat(const URV args[6])
+{
+  int dirfd = hostDirFd(args[0]);
+  if (dirfd == -1)
+    return -EBADF;
+
+  const char* path = nullptr;
+  if (not hostString(args[1], path))
+    return -EFAULT;
+
+  int fd = openat(dirfd, path, hostOpenFlags(args[2]), mode_t(args[3]));
+  if (fd < 0)
+    return -errno;
+  return newTargetFd(fd);
+}
+
+
+template <typename URV>
+typename Syscall<URV>::SRV
+Syscall<URV>::doOpen(const URV args[6])
+{
+  const char* path = nullptr;
+  if (not hostString(args[0], path))
+    return -EFAULT;
+
+  int fd = open(path, hostOpenFlags(args[1]), mode_t(args[2]));
+  if (fd < 0)
+    return -errno;
+  return newTargetFd(fd);
+}
+
+
+template <typename URV>
+typename Syscall<URV>::SRV
+Syscall<URV>::doClose(const URV args[6])
+{
+  int fd = hostFd(args[0]);
+  if (fd < 0)
+    return -EBADF;
+
+  // Standard streams of the simulator are never closed.
+  if (fd > 2 and close(fd) < 0)
+    return -errno;
+  fdMap_.at(args[0]) = -1;
+  return 0;
+}
+
+
+template <typename URV>
+typename Syscall<URV>::SRV
+Syscall<URV>::doLseek(const URV args[6])
+{
+  int fd = hostFd(args[0]);
+  if (fd < 0)
+    return -EBADF;
+
+  off_t rc = lseek(fd, off_t(SRV(args[1])), int(args[2]));
+  if (rc < 0)
+    return -errno;
+  return rc;
+}
+
+
+template <typename URV>
+typename Syscall<URV>::SRV
+Syscall<URV>::doRead(const URV args[6])
+{
+  int fd = hostFd(args[0]);
+  if (fd < 0)
+    return -EBADF;
+
+  void* buf = nullptr;
+  if (not hostAddr(args[1], args[2], buf))
+    return -EFAULT;
+
+  ssize_t rc = read(fd, buf, args[2]);
+  if (rc < 0)
+    return -errno;
+  return rc;
+}
+
+
+template <typename URV>
+typename Syscall<URV>::SRV
+Syscall<URV>::doWrite(const URV args[6])
+{
+  int fd = hostFd(args[0]);
+  if (fd < 0)
+    return -EBADF;
+
+  void* buf = nullptr;
+  if (not hostAddr(args[1], args[2], buf))
+    return -EFAULT;
+
+  ssize_t rc = write(fd, buf, args[2]);
+  if (rc < 0)
+    return -errno;
+  return rc;
+}
+
+
+template <typename URV>
+typename Syscall<URV>::SRV
+Syscall<URV>::doWritev(const URV args[6])
+{
+  int fd = hostFd(args[0]);
+  if (fd < 0)
+    return -EBADF;
+
+  URV count = args[2];
+  if (count > IOV_MAX)
+    return -EINVAL;
+
+  // Target iovec is a pair of URV: base and length.
+  void* ptr = nullptr;
+  if (not hostAddr(args[1], count*2*sizeof(URV), ptr))
+    return -EFAULT;
+  const URV* vec = static_cast<const URV*>(ptr);
+
+  iov_.resize(count);
+  for (URV i = 0; i < count; ++i)
+    {
+      URV len = vec[i*2 + 1];
+      if (not hostAddr(vec[i*2], len, iov_[i].iov_base))
+	return -EFAULT;
+      iov_[i].iov_len = len;
+    }
+
+  ssize_t rc = writev(fd, iov_.data(), count);
+  if (rc < 0)
+    return -errno;
+  return rc;
+}
+
+
+template <typename URV>
+typename Syscall<URV>::SRV
+Syscall<URV>::doReadlinkat(const URV args[6])
+{
+  int dirfd = hostDirFd(args[0]);
+  if (dirfd == -1)
+    return -EBADF;
+
+  const char* path = nullptr;
+  void* buf = nullptr;
+  if (not hostString(args[1], path) or not hostAddr(args[2], args[3], buf))
+    return -EFAULT;
+
+  ssize_t rc = readlinkat(dirfd, path, static_cast<char*>(buf), args[3]);
+  if (rc < 0)
+    return -errno;
+  return rc;
+}
+
+
+template <typename URV>
+typename Syscall<URV>::SRV
+Syscall<URV>::doFstat(const URV args[6])
+{
+  int fd = hostFd(args[0]);
+  if (fd < 0)
+    return -EBADF;
+
+  // Target buffer is a Linux asm-generic struct stat (same layout for
+  // rv32 and rv64 as newlib uses a 64-bit time_t).
+  void* ptr = nullptr;
+  if (not hostAddr(args[1], 128, ptr))
+    return -EFAULT;
+
+  struct stat buff;
+  if (fstat(fd, &buff) < 0)
+    return -errno;
+
+  char* rv = static_cast<char*>(ptr);
+  memset(rv, 0, 128);
+
+  auto put = [rv] (unsigned offset, auto value) {
+    memcpy(rv + offset, &value, sizeof(value));
+  };
+
+  put(0,  uint64_t(buff.st_dev));
+  put(8,  uint64_t(buff.st_ino));
+  put(16, uint32_t(buff.st_mode));
+  put(20, uint32_t(buff.st_nlink));
+  put(24, uint32_t(buff.st_uid));
+  put(28, uint32_t(buff.st_gid));
+  put(32, uint64_t(buff.st_rdev));
+  put(48, int64_t(buff.st_size));
+  put(56, int32_t(buff.st_blksize));
+  put(64, int64_t(buff.st_blocks));
+  put(72, int64_t(buff.st_atim.tv_sec));
+  put(80, URV(buff.st_atim.tv_nsec));
+  put(88, int64_t(buff.st_mtim.tv_sec));
+  put(96, URV(buff.st_mtim.tv_nsec));
+  put(104, int64_t(buff.st_ctim.tv_sec));
+  put(112, URV(buff.st_ctim.tv_nsec));
+  return 0;
+}
+
+
+template <typename URV>
+typename Syscall<URV>::SRV
+Syscall<URV>::doExit(const URV args[6])
+{
+  throw CoreException(CoreException::Exit, "", 0, args[0]);
+  return 0;
+}
+
+
+template <typename URV>
+typename Syscall<URV>::SRV
+Syscall<URV>::doTimes(const URV args[6])
+{
+  // All the time is user time. Clock ticks at 100 per second.
+  URV ticks = simNanoseconds() / 10000000;
+
+  if (args[0])
+    {
+      void* ptr = nullptr;
+      if (not hostAddr(args[0], 4*sizeof(URV), ptr))
+	return -EFAULT;
+      URV tms[4] = { ticks, 0, 0, 0 };
+      memcpy(ptr, tms, sizeof(tms));
+    }
+  return ticks;
+}
+
+
+template <typename URV>
+typename Syscall<URV>::SRV
+Syscall<URV>::doUname(const URV args[6])
+{
+  // Assumes that x86 and rv Linux have same layout for struct utsname.
+  void* ptr = nullptr;
+  if (not hostAddr(args[0], sizeof(struct utsname), ptr))
+    return -EFAULT;
+  struct utsname* uts = static_cast<struct utsname*>(ptr);
+  if (uname(uts) < 0)
+    return -errno;
+  strcpy(uts->release, "4.14.0");
+  return 0;
+}
+
+
+template <typename URV>
+typename Syscall<URV>::SRV
+Syscall<URV>::doGettimeofday(const URV args[6])
+{
+  uint64_t ns = simNanoseconds();
+  if (args[0])
+    if (SRV rc = writeTime(args[0], ns / 1000000000, ns % 1000000000 / 1000))
+      return rc;
+
+  // Time zone (if requested) is UTC.
+  if (args[1])
+    {
+      void* ptr = nullptr;
+      if (not hostAddr(args[1], 8, ptr))
+	return -EFAULT;
+      memset(ptr, 0, 8);
+    }
+  return 0;
+}
+
+
+template <typename URV>
+typename Syscall<URV>::SRV
+Syscall<URV>::doClockGettime(const URV args[6])
+{
+  // All the clocks (realtime, monotonic, process and thread cpu time)
+  // measure the simulated time.
+  uint64_t ns = simNanoseconds();
+  return writeTime(args[1], ns / 1000000000, ns % 1000000000);
+}
+
+
+template <typename URV>
+typename Syscall<URV>::SRV
+Syscall<URV>::doGetpid(const URV[6])
+{
+  return 1;
+}
+
+
+template <typename URV>
+typename Syscall<URV>::SRV
+Syscall<URV>::doGetuid(const URV[6])
+{
+  return getuid();
+}
+
+
+template <typename URV>
+typename Syscall<URV>::SRV
+Syscall<URV>::doGeteuid(const URV[6])
+{
+  return geteuid();
+}
+
+
+template <typename URV>
+typename Syscall<URV>::SRV
+Syscall<URV>::doGetgid(const URV[6])
+{
+  return getgid();
+}
+
+
+template <typename URV>
+typename Syscall<URV>::SRV
+Syscall<URV>::doGetegid(const URV[6])
+{
+  return getegid();
+}
+
+
+template <typename URV>
+typename Syscall<URV>::SRV
+Syscall<URV>::doBrk(const URV args[6])
+{
+  // Heap may not grow into the mmap area.
+  URV addr = args[0];
+  if (addr < progBreak_ or (mmapEnd_ and addr > mmapLow_))
+    return progBreak_;
+  progBreak_ = addr;
+  return addr;
+}
+
+
+template <typename URV>
+void
+Syscall<URV>::releaseMmap(URV addr, URV len)
+{
+  // Clip to the part of the area in use.
+  if (len == 0 or addr >= mmapEnd_)
+    return;
+  URV end = len > mmapEnd_ - addr ? mmapEnd_ : addr + len;
+  addr = std::max(addr, mmapLow_);
+  if (addr >= end)
+    return;
+
+  // Merge with the free regions overlapping or adjacent to the
+  // released one.
+  auto iter = mmapFree_.upper_bound(addr);
+  if (iter != mmapFree_.begin())
+    {
+      auto prev = std::prev(iter);
+      if (prev->first + prev->second >= addr)
+	iter = prev;
+    }
+  while (iter != mmapFree_.end() and iter->first <= end)
+    {
+      addr = std::min(addr, iter->first);
+      end = std::max(end, URV(iter->first + iter->second));
+      iter = mmapFree_.erase(iter);
+    }
+
+  // Give back to the area a free region at its low end.
+  if (addr == mmapLow_)
+    mmapLow_ = end;
+  else
+    mmapFree_[addr] = end - addr;
+}
+
+
+template <typename URV>
+typename Syscall<URV>::SRV
+Syscall<URV>::doMunmap(const URV args[6])
+{
+  URV pageSize = memory_.pageSize();
+  URV addr = args[0];
+  URV len = (args[1] + pageSize - 1) / pageSize * pageSize;
+  if (addr % pageSize or len == 0)
+    return -EINVAL;
+
+  // Any page range may be unmapped: part of a mapping, several
+  // mappings or pages already free. Pages outside the mmap area
+  // (e.g. from fixed mappings) are left as they are.
+  releaseMmap(addr, len);
+  return 0;
+}
+
+
+template <typename URV>
+typename Syscall<URV>::SRV
+Syscall<URV>::doMmap(const URV args[6])
+{
+  URV pageSize = memory_.pageSize();
+  URV flags = args[3];
+  int fd = -1;
+  if (not (flags & TargetMapAnonymous) and (fd = hostFd(args[4])) < 0)
+    return -EBADF;
+
+  URV len = (args[1] + pageSize - 1) / pageSize * pageSize;
+  if (len == 0)
+    return -EINVAL;
+
+  URV addr = args[0];
+  if (flags & TargetMapFixed)
+    {
+      if (addr % pageSize)
+	return -EINVAL;
+    }
+  else
+    {
+      // Mmap area grows down from below the stack.
+      if (mmapEnd_ == 0)
+	{
+	  uint64_t sp = intRegs_.read(RegSp);
+	  uint64_t end = std::min(uint64_t(memory_.size()), sp);
+	  end = end > stackReserve ? end - stackReserve : 0;
+	  mmapEnd_ = mmapLow_ = end / pageSize * pageSize;
+	}
+
+      // First fit among freed regions, otherwise extend the area down.
+      auto iter = mmapFree_.begin();
+      while (iter != mmapFree_.end() and iter->second < len)
+	++iter;
+      if (iter != mmapFree_.end())
+	{
+	  addr = iter->first;
+	  URV remain = iter->second - len;
+	  mmapFree_.erase(iter);
+	  if (remain)
+	    mmapFree_[addr + len] = remain;
+	}
+      else
+	{
+	  if (len > mmapLow_ or mmapLow_ - len < progBreak_)
+	    return -ENOMEM;
+	  mmapLow_ -= len;
+	  addr = mmapLow_;
+	}
+    }
+
+  // On failure, give back the region reserved above.
+  void* ptr = nullptr;
+  if (not hostAddr(addr, len, ptr))
+    {
+      if (not (flags & TargetMapFixed))
+	releaseMmap(addr, len);
+      return -ENOMEM;
+    }
+
+  memset(ptr, 0, len);
+  if (fd >= 0 and pread(fd, ptr, args[1], off_t(args[5])) < 0)
+    {
+      SRV err = -errno;
+      if (not (flags & TargetMapFixed))
+	releaseMmap(addr, len);
+      return err;
+    }
+  return addr;
+}
+
+
+template <typename URV>
+bool
+Syscall<URV>::semihostParams(URV addr, unsigned count, URV*& params)
+{
+  void* ptr = nullptr;
+  if (not hostAddr(addr, count*sizeof(URV), ptr))
+    return false;
+  params = static_cast<URV*>(ptr);
+  return true;
+}
+
+
+template <typename URV>
+URV
+Syscall<URV>::semihost(uint64_t instCount)
+{
+  URV op = intRegs_.read(RegA0);
+  URV arg = intRegs_.read(RegA1);
+
+  instCount_ = instCount;
+
+  URV* params = nullptr;
+  void* ptr = nullptr;
+
+  // Most operations fail with -1 and record the host errno.
+  auto fail = [this] (int err) -> URV {
+    semihostErrno_ = err;
+    return SRV(-1);
+  };
+
+  switch (op)
+    {
+    case SemiOpen:
+      {
+	if (not semihostParams(arg, 3, params) or
+	    not hostAddr(params[0], params[2], ptr))
+	  return fail(EFAULT);
+	std::string name(static_cast<const char*>(ptr), params[2]);
+	URV mode = params[1];
+	if (mode > 11)
+	  return fail(EINVAL);
+
+	// Special name :tt denotes the console: stdin, stdout or stderr
+	// depending on the mode.
+	if (name == ":tt")
+	  {
+	    int host = mode < 4 ? 0 : (mode < 8 ? 1 : 2);
+	    for (size_t i = 0; i < fdMap_.size(); ++i)
+	      if (fdMap_[i] == host)
+		return i;
+	    return newTargetFd(host);
+	  }
+
+	// Modes: r, rb, r+, r+b, w, wb, w+, w+b, a, ab, a+, a+b
+	static const int hostModes[] = { O_RDONLY, O_RDWR,
+					 O_WRONLY | O_CREAT | O_TRUNC,
+					 O_RDWR | O_CREAT | O_TRUNC,
+					 O_WRONLY | O_CREAT | O_APPEND,
+					 O_RDWR | O_CREAT | O_APPEND };
+	int fd = open(name.c_str(), hostModes[mode / 2], 0644);
+	if (fd < 0)
+	  return fail(errno);
+	return newTargetFd(fd);
+      }
+
+    case SemiClose:
+      {
+	if (not semihostParams(arg, 1, params))
+	  return fail(EFAULT);
+	URV args[6] = { params[0] };
+	SRV rc = doClose(args);
+	return rc < 0 ? fail(-rc) : 0;
+      }
+
+    case SemiWritec:
+    case SemiWrite0:
+      {
+	const char* str = nullptr;
+	if (op == SemiWritec)
+	  {
+	    if (not hostAddr(arg, 1, ptr))
+	      return fail(EFAULT);
+	    str = static_cast<const char*>(ptr);
+	  }
+	else if (not hostString(arg, str))
+	  return fail(EFAULT);
+	int fd = hostFd(1);
+	if (fd >= 0 and write(fd, str, op == SemiWritec ? 1 : strlen(str)) < 0)
+	  return fail(errno);
+	return 0;
+      }
+
+    case SemiWrite:
+    case SemiRead:
+      {
+	// Return the count of bytes not written/read.
+	if (not semihostParams(arg, 3, params))
+	  return fail(EFAULT);
+	URV args[6] = { params[0], params[1], params[2] };
+	SRV rc = op == SemiWrite ? doWrite(args) : doRead(args);
+	if (rc < 0)
+	  {
+	    semihostErrno_ = -rc;
+	    return params[2];
+	  }
+	return params[2] - rc;
+      }
+
+    case SemiReadc:
+      {
+	char c = 0;
+	int fd = hostFd(0);
+	if (fd < 0 or read(fd, &c, 1) != 1)
+	  return fail(EIO);
+	return uint8_t(c);
+      }
+
+    case SemiIsError:
+      {
+	if (not semihostParams(arg, 1, params))
+	  return fail(EFAULT);
+	return SRV(params[0]) < 0;
+      }
+
+    case SemiIsTty:
+      {
+	if (not semihostParams(arg, 1, params))
+	  return fail(EFAULT);
+	int fd = hostFd(params[0]);
+	if (fd < 0)
+	  return fail(EBADF);
+	return isatty(fd) ? 1 : 0;
+      }
+
+    case SemiSeek:
+      {
+	if (not semihostParams(arg, 2, params))
+	  return fail(EFAULT);
+	URV args[6] = { params[0], params[1], SEEK_SET };
+	SRV rc = doLseek(args);
+	return rc < 0 ? fail(-rc) : 0;
+      }
+
+    case SemiFlen:
+      {
+	if (not semihostParams(arg, 1, params))
+	  return fail(EFAULT);
+	int fd = hostFd(params[0]);
+	struct stat buff;
+	if (fd < 0 or fstat(fd, &buff) < 0)
+	  return fail(fd < 0 ? EBADF : errno);
+	return buff.st_size;
+      }
+
+    case SemiRemove:
+      {
+	if (not semihostParams(arg, 2, params) or
+	    not hostAddr(params[0], params[1], ptr))
+	  return fail(EFAULT);
+	std::string name(static_cast<const char*>(ptr), params[1]);
+	if (unlink(name.c_str()) < 0)
+	  return semihostErrno_ = errno;
+	return 0;
+      }
+
+    case SemiRename:
+      {
+	void* ptr2 = nullptr;
+	if (not semihostParams(arg, 4, params) or
+	    not hostAddr(params[0], params[1], ptr) or
+	    not hostAddr(params[2], params[3], ptr2))
+	  return fail(EFAULT);
+	std::string from(static_cast<const char*>(ptr), params[1]);
+	std::string to(static_cast<const char*>(ptr2), params[3]);
+	if (rename(from.c_str(), to.c_str()) < 0)
+	  return semihostErrno_ = errno;
+	return 0;
+      }
+
+    case SemiClock:
+      return simNanoseconds() / 10000000;  // Centiseconds.
+
+    case SemiTime:
+      return simNanoseconds() / 1000000000;
+
+    case SemiErrno:
+      return semihostErrno_;
+
+    case SemiHeapInfo:
+      {
+	// Block of 4 words: heap base, heap limit, stack base, stack
+	// limit. Zero means unknown.
+	URV* block = nullptr;
+	if (not semihostParams(arg, 1, params) or
+	    not semihostParams(params[0], 4, block))
+	  return fail(EFAULT);
+	URV info[4] = { progBreak_, mmapEnd_ ? mmapLow_ : 0, 0, 0 };
+	memcpy(block, info, sizeof(info));
+	return 0;
+      }
+
+    case SemiExit:
+    case SemiExitExtended:
+      {
+	// Reason and exit code are in a parameter block except for
+	// SYS_EXIT in rv32 where a1 holds the reason.
+	URV reason = arg, code = 0;
+	if (op == SemiExitExtended or sizeof(URV) == 8)
+	  {
+	    if (not semihostParams(arg, 2, params))
+	      return fail(EFAULT);
+	    reason = params[0];
+	    code = params[1];
+	  }
+	if (reason != AdpStoppedApplicationExit)
+	  code = 1;
+	throw CoreException(CoreException::Exit, "", 0, code);
+	return 0;
+      }
+
+    case SemiElapsed:
+      {
+	if (not hostAddr(arg, 8, ptr))
+	  return fail(EFAULT);
+	uint64_t ticks = instCount_;
+	memcpy(ptr, &ticks, sizeof(ticks));
+	return 0;
+      }
+
+    case SemiTickFreq:
+      return instPerSec_;
+
+    default:
+      break;
+    }
+
+  std::cerr << "Unimplemented semihosting operation 0x" << std::hex << op
+	    << std::dec << "\n";
+  return fail(ENOSYS);
+}
+
+
+template class WdRiscv::Syscall<uint32_t>;
+template class WdRiscv::Syscall<uint64_t>;
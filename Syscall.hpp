@@ -0,0 +1,177 @@
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2018 Western Digital Corporation or its affiliates.
+//
+// This program is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <map>
+#include <type_traits>
+#include <sys/uio.h>
+#include "IntRegs.hpp"
+#include "Memory.hpp"
+
+
+namespace WdRiscv
+{
+
+  /// Emulate the Linux/newlib system calls of a target program on
+  /// behalf of a core. Target (guest) file descriptors are mapped to
+  /// host descriptors through a table so that a target program can
+  /// only reach the files it opened (and the standard streams). Target
+  /// buffers are accessed in place in the simulated memory. Times
+  /// returned to the target are derived from the count of retired
+  /// instructions so that a run is reproducible.
+  template <typename URV>
+  class Syscall
+  {
+  public:
+
+    typedef typename std::make_signed_t<URV> SRV;
+
+    /// Constructor: Associate with the given register file (source of
+    /// the call number and arguments) and simulated memory.
+    Syscall(IntRegs<URV>& intRegs, Memory& memory);
+
+    /// Close all the host files opened on behalf of the target
+    /// program.
+    ~Syscall();
+
+    /// Emulate the system call whose number is in register a7 and
+    /// whose arguments are in registers a0 to a5. The instCount is the
+    /// count of retired instructions: it is used as the simulated
+    /// time. Return the value to be placed in register a0: a negative
+    /// error number on failure. Throw a CoreException on exit.
+    URV emulate(uint64_t instCount);
+
+    /// Service the RISCV semihosting request whose operation number is
+    /// in register a0 and whose parameter (usually the address of a
+    /// block of register-wide parameters) is in a1. Operations follow
+    /// the ARM semihosting specification (SYS_OPEN, SYS_READ, SYS_WRITE,
+    /// SYS_CLOCK, SYS_EXIT ...). File handles are target file
+    /// descriptors. Return the value to be placed in a0. Throw a
+    /// CoreException on SYS_EXIT.
+    URV semihost(uint64_t instCount);
+
+    /// Define the end of the target program image (bss). The heap
+    /// (brk) grows up from that address. The address is rounded up to
+    /// the nearest page boundary.
+    void setProgramBreak(URV addr);
+
+    /// Close the host files opened on behalf of the target program,
+    /// reset the file descriptor table to the standard streams and
+    /// release all the memory mapped regions.
+    void reset();
+
+  protected:
+
+    typedef SRV (Syscall::*Handler)(const URV args[6]);
+
+    /// Fill the dispatch table.
+    void defineHandlers();
+
+    /// Set ptr to the simulator address corresponding to the target
+    /// memory region of size bytes at addr. Return false if the region
+    /// is not entirely in the simulated memory.
+    bool hostAddr(URV addr, size_t size, void*& ptr);
+
+    /// Set str to the target null-terminated string at addr. Return
+    /// false if the string is not entirely in the simulated memory.
+    bool hostString(URV addr, const char*& str);
+
+    /// Return the host descriptor corresponding to the given target
+    /// descriptor or -1 if target descriptor is not open.
+    int hostFd(URV fd) const
+    {
+      if (fd >= fdMap_.size())
+	return -1;
+      return fdMap_[fd];
+    }
+
+    /// Return the host descriptor corresponding to the given target
+    /// directory descriptor (AT_FDCWD is passed through) or -1.
+    int hostDirFd(URV fd) const;
+
+    /// Associate the given host descriptor with the lowest free target
+    /// descriptor and return it.
+    SRV newTargetFd(int hostFd);
+
+    /// Return the host open flags corresponding to the given newlib
+    /// open flags.
+    static int hostOpenFlags(URV flags);
+
+    /// Set params to the address of the given number of register-wide
+    /// semihosting parameters at addr. Return false if they are not in
+    /// the simulated memory.
+    bool semihostParams(URV addr, unsigned count, URV*& params);
+
+    /// Return the simulated time in nanoseconds.
+    uint64_t simNanoseconds() const;
+
+    /// Write the given seconds and fraction (nano or micro seconds)
+    /// into a target timespec/timeval structure at addr.
+    SRV writeTime(URV addr, uint64_t sec, uint64_t frac);
+
+    /// Return to the mmap area the pages of the given page aligned
+    /// region that lie within it. Pages that are already free are
+    /// left as they are.
+    void releaseMmap(URV addr, URV len);
+
+    // System call handlers. Each returns the result of the call or
+    // the negative of an error number.
+    SRV doOpenat(const URV args[6]);
+    SRV doOpen(const URV args[6]);
+    SRV doClose(const URV args[6]);
+    SRV doLseek(const URV args[6]);
+    SRV doRead(const URV args[6]);
+    SRV doWrite(const URV args[6]);
+    SRV doWritev(const URV args[6]);
+    SRV doReadlinkat(const URV args[6]);
+    SRV doFstat(const URV args[6]);
+    SRV doExit(const URV args[6]);
+    SRV doTimes(const URV args[6]);
+    SRV doUname(const URV args[6]);
+    SRV doGettimeofday(const URV args[6]);
+    SRV doClockGettime(const URV args[6]);
+    SRV doGetpid(const URV args[6]);
+    SRV doGetuid(const URV args[6]);
+    SRV doGeteuid(const URV args[6]);
+    SRV doGetgid(const URV args[6]);
+    SRV doGetegid(const URV args[6]);
+    SRV doBrk(const URV args[6]);
+    SRV doMunmap(const URV args[6]);
+    SRV doMmap(const URV args[6]);
+
+  private:
+
+    IntRegs<URV>& intRegs_;
+    Memory& memory_;
+    std::vector<Handler> handlers_;   // Indexed by system call number.
+    std::vector<int> fdMap_;          // Target fd to host fd (-1 if free).
+    std::vector<struct iovec> iov_;   // Reused by writev.
+
+    URV progBreak_ = 0;               // Top of the brk heap.
+    URV mmapEnd_ = 0;                 // End of the mmap area (0 if unset).
+    URV mmapLow_ = 0;                 // Lowest address used by mmap.
+    std::map<URV, URV> mmapFree_;     // Freed mmap regions: addr to size.
+
+    int semihostErrno_ = 0;           // Host errno of last failed request.
+    uint64_t instCount_ = 0;          // Retired insts at current call.
+    uint64_t instPerSec_ = 1000000000;  // Simulated clock frequency.
+  };
+}
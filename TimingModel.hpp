@@ -0,0 +1,439 @@
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2018 Western Digital Corporation or its affiliates.
+//
+// This program is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+#include "InstInfo.hpp"
+
+
+namespace WdRiscv
+{
+
+  /// Latencies (in cycles) and sizes of the pipeline timing model.
+  /// The defaults approximate a SweRV EH1 core.
+  struct TimingParams
+  {
+    unsigned issueWidth_ = 2;            // Instructions issued per cycle.
+    unsigned loadLatency_ = 2;           // Load to use, DCCM.
+    unsigned externalLoadLatency_ = 10;  // Load to use, external memory.
+    unsigned mulLatency_ = 3;            // Pipelined multiplier.
+    unsigned divLatency_ = 34;           // Non-pipelined divider.
+    unsigned fpLatency_ = 4;             // Floating point unit.
+    unsigned branchPenalty_ = 4;         // Cycles lost on a pipeline flush.
+    unsigned fetchBlock_ = 8;            // Bytes per fetch (power of 2).
+    unsigned fetchBufferBlocks_ = 4;     // Fetch blocks buffered ahead.
+    unsigned externalFetchLatency_ = 10; // External memory fetch latency.
+    unsigned externalFetchInterval_ = 2; // Cycles between external blocks.
+  };
+
+
+  /// Stall cycles and events attributed to the most recent
+  /// instruction presented to a TimingModel.
+  struct TimingEvents
+  {
+    uint64_t fetchStall_ = 0;   // Waiting for the fetch buffer.
+    uint64_t dependStall_ = 0;  // Waiting for an operand or a unit.
+    uint64_t syncStall_ = 0;    // Draining the pipeline (CSR, fence).
+    unsigned busFetches_ = 0;   // Blocks fetched from external memory.
+    bool busLoadStore_ = false; // Load/store to external memory.
+    bool mispredict_ = false;   // Mispredicted control transfer.
+  };
+
+
+  /// Cycle-approximate timing model of an in-order multiple-issue
+  /// pipeline. The model is presented with the retired instructions in
+  /// program order and computes the cycle at which each instruction
+  /// issues given: the issue width, the availability of its source
+  /// operands (register scoreboard with load, multiply, divide and
+  /// floating point latencies), one load/store and one multiply per
+  /// cycle, a non-pipelined divider, the fetch buffer (fetch blocks
+  /// from ICCM arrive one per cycle, those from external memory after
+  /// a latency), serializing instructions (CSR access, fence) and
+  /// pipeline flushes on mispredicted branches, traps and interrupts.
+  /// Branch prediction is left to the caller (see BranchPredictor).
+  template <typename URV>
+  class TimingModel
+  {
+  public:
+
+    enum class Unit : uint8_t { Alu, Mem, Mul, Div, Fp };
+
+    /// Timing relevant properties of an instruction: Compact form of
+    /// its InstInfo. Register kinds are 0 (not a register), 1 (integer
+    /// register) or 2 (floating point register).
+    struct InstTiming
+    {
+      uint8_t src_[3] = { 0, 0, 0 };  // Kind of source operands.
+      uint8_t dest_ = 0;              // Kind of destination (operand 0).
+      Unit unit_ = Unit::Alu;
+      bool isLoad_ = false;
+      bool branch_ = false;      // Branch or jump.
+      bool serialize_ = false;   // Issues alone after pipeline drains.
+      bool flush_ = false;       // Flushes pipeline (fence.i).
+      bool valid_ = false;
+    };
+
+    /// Turn the model on/off.
+    void enable(bool flag)
+    { enabled_ = flag; }
+
+    /// Return true if the model is on.
+    bool enabled() const
+    { return enabled_; }
+
+    /// Define the latencies and sizes of the model and reset it.
+    void setParams(const TimingParams& params)
+    {
+      params_ = params;
+      params_.issueWidth_ = std::max(params_.issueWidth_, 1u);
+      params_.fetchBufferBlocks_ = std::max(params_.fetchBufferBlocks_, 1u);
+      if (params_.fetchBlock_ == 0 or
+	  (params_.fetchBlock_ & (params_.fetchBlock_ - 1)) != 0)
+	params_.fetchBlock_ = 8;
+      fetchShift_ = __builtin_ctz(params_.fetchBlock_);
+      reset();
+    }
+
+    /// Return the latencies and sizes of the model.
+    const TimingParams& params() const
+    { return params_; }
+
+    /// Bring the model to its initial state (empty pipeline).
+    void reset()
+    {
+      std::fill(regReady_, regReady_ + 64, 0);
+      consumed_.assign(params_.fetchBufferBlocks_, 0);
+      consumedIx_ = 0;
+      cycle_ = 0;
+      minIssue_ = 0;
+      drain_ = 0;
+      divFree_ = 0;
+      slots_ = 0;
+      memUsed_ = mulUsed_ = false;
+      endGroup_ = true;
+      fetchValid_ = false;
+      fetchStart_ = 0;
+      lastReady_ = 0;
+      nextPc_ = 0;
+      started_ = false;
+      fetchStalls_ = dependStalls_ = syncStalls_ = 0;
+      branches_ = mispredicts_ = 0;
+    }
+
+    /// Return the timing properties of the instruction with the given
+    /// id computing them from the instruction table on first use.
+    const InstTiming& instTiming(InstId id, const InstInfoTable& table)
+    {
+      if (instTimings_.empty())
+	instTimings_.resize(size_t(InstId::maxId) + 1);
+      InstTiming& it = instTimings_[size_t(id)];
+      if (not it.valid_)
+	describe(it, id, table.getInstInfo(id));
+      return it;
+    }
+
+    /// Account for the retired instruction at pc with the given
+    /// timing properties (see instTiming) and operands. The nextPc is
+    /// the address of the next instruction to execute. The iccm flag
+    /// is true if the instruction was fetched from ICCM (or hit in an
+    /// instruction cache) and dccm is true if the instruction is not a
+    /// load/store or if it accessed DCCM (or hit in a data cache).
+    /// The mispredict flag is true if the instruction is a
+    /// mispredicted branch or jump. Return the number of cycles
+    /// between the issue of the previous instruction and that of this
+    /// one (zero if both issue in the same cycle).
+    uint64_t retire(URV pc, URV nextPc, unsigned size,
+		    const InstTiming& it, uint32_t op0, uint32_t op1,
+		    int32_t op2, bool iccm, bool dccm, bool mispredict)
+    {
+      events_ = TimingEvents();
+
+      // Control reached pc by a trap, an interrupt or by an external
+      // change of the pc: Flush the pipeline.
+      if (pc != nextPc_ and started_)
+	redirect(cycle_ + 1 + params_.branchPenalty_);
+      started_ = true;
+
+      // Earliest cycle ignoring fetch and operands.
+      bool sameCycle = not endGroup_ and not it.serialize_ and
+	slots_ < params_.issueWidth_;
+      if (sameCycle and it.unit_ == Unit::Mem and memUsed_)
+	sameCycle = false;
+      if (sameCycle and it.unit_ == Unit::Mul and mulUsed_)
+	sameCycle = false;
+      uint64_t issue = std::max(sameCycle? cycle_ : cycle_ + 1, minIssue_);
+
+      uint64_t fetch = fetchReady(pc, size, iccm);
+      if (fetch > issue)
+	{
+	  events_.fetchStall_ = fetch - issue;
+	  issue = fetch;
+	}
+
+      uint64_t operands = 0;
+      uint32_t ops[3] = { op0, op1, uint32_t(op2) };
+      for (unsigned i = 0; i < 3; ++i)
+	if (it.src_[i])
+	  operands = std::max(operands, regReady_[regIndex(it.src_[i], ops[i])]);
+      if (it.unit_ == Unit::Div)
+	operands = std::max(operands, divFree_);
+      if (operands > issue)
+	{
+	  events_.dependStall_ = operands - issue;
+	  issue = operands;
+	}
+
+      if (it.serialize_ and drain_ > issue)
+	{
+	  events_.syncStall_ = drain_ - issue;
+	  issue = drain_;
+	}
+
+      // Issue.
+      if (issue != cycle_)
+	{
+	  slots_ = 0;
+	  memUsed_ = mulUsed_ = false;
+	  endGroup_ = false;
+	}
+      uint64_t elapsed = issue - cycle_;
+      cycle_ = issue;
+      slots_++;
+
+      // Result latency.
+      unsigned latency = 1;
+      switch (it.unit_)
+	{
+	case Unit::Alu:
+	  break;
+	case Unit::Mem:
+	  if (it.isLoad_)
+	    latency = dccm? params_.loadLatency_ : params_.externalLoadLatency_;
+	  memUsed_ = true;
+	  events_.busLoadStore_ = not dccm;
+	  break;
+	case Unit::Mul:
+	  latency = params_.mulLatency_;
+	  mulUsed_ = true;
+	  break;
+	case Unit::Div:
+	  latency = params_.divLatency_;
+	  divFree_ = issue + latency;
+	  break;
+	case Unit::Fp:
+	  latency = params_.fpLatency_;
+	  break;
+	}
+
+      if (it.dest_)
+	{
+	  unsigned reg = regIndex(it.dest_, op0);
+	  if (reg)
+	    {
+	      regReady_[reg] = issue + latency;
+	      drain_ = std::max(drain_, issue + latency);
+	    }
+	}
+
+      // Control flow.
+      bool sequential = nextPc == pc + size;
+      if (it.branch_)
+	{
+	  branches_++;
+	  if (mispredict)
+	    {
+	      mispredicts_++;
+	      events_.mispredict_ = true;
+	      redirect(issue + 1 + params_.branchPenalty_);
+	    }
+	  else if (not sequential)
+	    redirect(issue + 1);
+	}
+      else if (not sequential or it.flush_)
+	redirect(issue + 1 + params_.branchPenalty_);
+
+      if (it.serialize_)
+	endGroup_ = true;
+
+      nextPc_ = nextPc;
+
+      fetchStalls_ += events_.fetchStall_;
+      dependStalls_ += events_.dependStall_;
+      syncStalls_ += events_.syncStall_;
+
+      return elapsed;
+    }
+
+    /// Return the stall cycles and events of the most recent
+    /// instruction (see retire).
+    const TimingEvents& lastEvents() const
+    { return events_; }
+
+    /// Return the cumulative count of cycles stalled waiting for the
+    /// fetch buffer.
+    uint64_t fetchStalls() const
+    { return fetchStalls_; }
+
+    /// Return the cumulative count of cycles stalled waiting for
+    /// source operands or for the divider.
+    uint64_t dependStalls() const
+    { return dependStalls_; }
+
+    /// Return the cumulative count of cycles stalled draining the
+    /// pipeline before a serializing instruction.
+    uint64_t syncStalls() const
+    { return syncStalls_; }
+
+    /// Return the count of control transfer instructions (branches
+    /// and jumps).
+    uint64_t branches() const
+    { return branches_; }
+
+    /// Return the count of mispredicted control transfers.
+    uint64_t mispredicts() const
+    { return mispredicts_; }
+
+  protected:
+
+    /// Fill the timing properties of the instruction with the given
+    /// id and info.
+    static void describe(InstTiming& it, InstId id, const InstInfo& info)
+    {
+      auto kind = [&info] (unsigned i) -> uint8_t {
+	OperandType type = info.ithOperandType(i);
+	return (type == OperandType::IntReg ? 1 :
+		type == OperandType::FpReg ? 2 : 0);
+      };
+
+      for (unsigned i = 0; i < 3; ++i)
+	it.src_[i] = info.isIthOperandRead(i) ? kind(i) : 0;
+      it.dest_ = info.isIthOperandWrite(0) ? kind(0) : 0;
+
+      if (info.isLoad() or info.isStore())
+	it.unit_ = Unit::Mem;
+      else if (info.isMultiply())
+	it.unit_ = Unit::Mul;
+      else if (info.isDivide())
+	it.unit_ = Unit::Div;
+      else if (info.type() == InstType::Fp)
+	it.unit_ = Unit::Fp;
+      it.isLoad_ = info.isLoad();
+      it.branch_ = info.isBranch();
+      it.serialize_ = (info.isCsr() or id == InstId::fence or
+		       id == InstId::fencei or id == InstId::ecall or
+		       id == InstId::ebreak or id == InstId::c_ebreak or
+		       id == InstId::mret or id == InstId::wfi);
+      it.flush_ = id == InstId::fencei;
+      it.valid_ = true;
+    }
+
+    /// Return the scoreboard index of the given register of the given
+    /// kind (see InstTiming): Integer registers 0 to 31 (x0 is never
+    /// written), floating point registers 32 to 63.
+    static unsigned regIndex(uint8_t kind, uint32_t reg)
+    { return ((kind - 1) << 5) | (reg & 31); }
+
+    /// Flush the pipeline: Next instruction cannot issue before the
+    /// given cycle and fetch restarts at that cycle.
+    void redirect(uint64_t cycle)
+    {
+      minIssue_ = std::max(minIssue_, cycle);
+      fetchStart_ = cycle;
+      fetchValid_ = false;
+      std::fill(consumed_.begin(), consumed_.end(), 0);
+      consumedIx_ = 0;
+    }
+
+    /// Return the cycle at which the instruction of the given size at
+    /// pc is available in the fetch buffer.
+    uint64_t fetchReady(URV pc, unsigned size, bool iccm)
+    {
+      URV first = pc >> fetchShift_;
+      URV last = (pc + size - 1) >> fetchShift_;
+
+      if (fetchValid_ and last == block_)
+	return lastReady_;
+
+      URV block = first;
+      if (fetchValid_ and (first == block_ or first == block_ + 1))
+	{
+	  // Sequential: Previous block consumed now.
+	  consumed_[consumedIx_] = cycle_;
+	  block = block_ + 1;
+	}
+      else
+	lastReady_ = fetchStart_;
+
+      unsigned latency = iccm? 0 : params_.externalFetchLatency_;
+      unsigned interval = iccm? 1 : params_.externalFetchInterval_;
+      for ( ; block <= last; ++block)
+	{
+	  // A block is requested once its fetch buffer entry is free:
+	  // The entry of the block fetched fetchBufferBlocks_ earlier.
+	  if (fetchValid_ and ++consumedIx_ == consumed_.size())
+	    consumedIx_ = 0;
+	  uint64_t request = std::max(fetchStart_, consumed_[consumedIx_]);
+	  uint64_t ready = std::max(request + latency,
+				    fetchValid_? lastReady_ + interval : lastReady_);
+	  lastReady_ = ready;
+	  block_ = block;
+	  fetchValid_ = true;
+	  if (not iccm)
+	    events_.busFetches_++;
+	}
+      return lastReady_;
+    }
+
+  private:
+
+    bool enabled_ = false;
+    TimingParams params_;
+    TimingEvents events_;
+    std::vector<InstTiming> instTimings_;  // Indexed by InstId.
+
+    uint64_t regReady_[64] = {};  // Cycle register value available.
+    uint64_t cycle_ = 0;        // Issue cycle of last instruction.
+    uint64_t minIssue_ = 0;     // Earliest issue after a flush.
+    uint64_t drain_ = 0;        // Cycle all pending results are written.
+    uint64_t divFree_ = 0;      // Cycle divider becomes free.
+    unsigned slots_ = 0;        // Instructions issued in current cycle.
+    bool memUsed_ = false;      // Load/store issued in current cycle.
+    bool mulUsed_ = false;      // Multiply issued in current cycle.
+    bool endGroup_ = true;      // No more issue in current cycle.
+
+    bool fetchValid_ = false;   // True if block_ is in the fetch buffer.
+    URV block_ = 0;             // Most recently fetched block number.
+    uint64_t fetchStart_ = 0;   // Cycle fetch restarted.
+    uint64_t lastReady_ = 0;    // Cycle block_ arrived.
+    std::vector<uint64_t> consumed_ = std::vector<uint64_t>(4);
+    size_t consumedIx_ = 0;     // Entry of block_ in consumed_.
+    unsigned fetchShift_ = 3;   // Log2 of fetch block size.
+
+    URV nextPc_ = 0;            // Expected address of next instruction.
+    bool started_ = false;
+
+    uint64_t fetchStalls_ = 0;
+    uint64_t dependStalls_ = 0;
+    uint64_t syncStalls_ = 0;
+    uint64_t branches_ = 0;
+    uint64_t mispredicts_ = 0;
+  };
+}
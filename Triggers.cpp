@@ -16,6 +16,7 @@
 // this program. If not, see <https://www.gnu.org/licenses/>.
 //
 
+#include <algorithm>
 #include "Triggers.hpp"
 
 
@@ -85,6 +86,7 @@ Triggers<URV>::writeData1(URV trigIx, bool debugMode, URV value)
   if (prevChain != newChain)
     defineChainBounds();
 
+  buildMatchIndices();
   return true;
 }
 
@@ -96,7 +98,11 @@ Triggers<URV>::writeData2(URV trigger, bool debugMode, URV value)
   if (trigger >= triggers_.size())
     return false;
 
-  return triggers_.at(trigger).writeData2(debugMode, value);
+  if (not triggers_.at(trigger).writeData2(debugMode, value))
+    return false;
+
+  buildMatchIndices();
+  return true;
 }
 
 
@@ -143,21 +149,11 @@ bool
 Triggers<URV>::ldStAddrTriggerHit(URV address, TriggerTiming timing,
 				  bool isLoad, bool interruptEnabled)
 {
-  bool hit = false;
-  for (auto& trigger : triggers_)
-    {
-      if (not trigger.isEnterDebugOnHit() and not interruptEnabled)
-	continue;
-
-      if (not trigger.matchLdStAddr(address, timing, isLoad))
-	continue;
-
-      trigger.setLocalHit(true);
-
-      if (updateChainHitBit(trigger))
-	hit = true;
-    }
-  return hit;
+  MatchKind kind = isLoad? MatchKind::LoadAddr : MatchKind::StoreAddr;
+  const auto& index = matchIndex(kind, timing);
+  if (not index.couldHit(address, interruptEnabled))
+    return false;
+  return applyMatches(index, address, interruptEnabled);
 }
 
 
@@ -166,39 +162,59 @@ bool
 Triggers<URV>::ldStDataTriggerHit(URV value, TriggerTiming timing, bool isLoad,
 				  bool interruptEnabled)
 {
-  bool hit = false;
-  for (auto& trigger : triggers_)
-    {
-      if (not trigger.isEnterDebugOnHit() and not interruptEnabled)
-	continue;
+  MatchKind kind = isLoad? MatchKind::LoadData : MatchKind::StoreData;
+  const auto& index = matchIndex(kind, timing);
+  if (not index.couldHit(value, interruptEnabled))
+    return false;
+  return applyMatches(index, value, interruptEnabled);
+}
 
-      if (not trigger.matchLdStData(value, timing, isLoad))
-	continue;
 
-      trigger.setLocalHit(true);
+template <typename URV>
+bool
+Triggers<URV>::instAddrTriggerHit(URV address, TriggerTiming timing,
+				  bool interruptEnabled)
+{
+  const auto& index = matchIndex(MatchKind::InstAddr, timing);
+  if (not index.couldHit(address, interruptEnabled))
+    return false;
+  return applyMatches(index, address, interruptEnabled);
+}
 
-      if (updateChainHitBit(trigger))
-	hit = true;
-    }
 
-  return hit;
+template <typename URV>
+bool
+Triggers<URV>::instOpcodeTriggerHit(URV opcode, TriggerTiming timing,
+				    bool interruptEnabled)
+{
+  const auto& index = matchIndex(MatchKind::InstOpcode, timing);
+  if (not index.couldHit(opcode, interruptEnabled))
+    return false;
+  return applyMatches(index, opcode, interruptEnabled);
 }
 
 
 template <typename URV>
 bool
-Triggers<URV>::instAddrTriggerHit(URV address, TriggerTiming timing,
-				  bool interruptEnabled)
+Triggers<URV>::applyMatches(const TriggerMatchIndex<URV>& index, URV item,
+			    bool interruptEnabled)
 {
+  matchHits_.clear();
+  index.collect(item, matchHits_);
+  if (matchHits_.empty())
+    return false;
+
+  // Process matching triggers in index order (as a linear scan would)
+  // so that chain hit bits are updated identically.
+  std::sort(matchHits_.begin(), matchHits_.end());
+
   bool hit = false;
-  for (auto& trigger : triggers_)
+  for (unsigned ix : matchHits_)
     {
+      auto& trigger = triggers_.at(ix);
       if (not trigger.isEnterDebugOnHit() and not interruptEnabled)
 	continue;
 
-      if (not trigger.matchInstAddr(address, timing))
-	continue;
-
       trigger.setLocalHit(true);
 
       if (updateChainHitBit(trigger))
@@ -209,26 +225,89 @@ Triggers<URV>::instAddrTriggerHit(URV address, TriggerTiming timing,
 
 
 template <typename URV>
-bool
-Triggers<URV>::instOpcodeTriggerHit(URV opcode, TriggerTiming timing,
-				    bool interruptEnabled)
+void
+Triggers<URV>::buildMatchIndices()
 {
-  bool hit = false;
-  for (auto& trigger : triggers_)
+  typedef typename Trigger<URV>::Match Match;
+  typedef typename Trigger<URV>::Select Select;
+
+  for (auto& index : matchIndices_)
+    index.clear();
+
+  unsigned halfBitCount = 4*sizeof(URV);
+  URV lowHalf = ~URV(0) >> halfBitCount;
+
+  for (unsigned ix = 0; ix < triggers_.size(); ++ix)
     {
-      if (not trigger.isEnterDebugOnHit() and not interruptEnabled)
+      const auto& trig = triggers_.at(ix);
+      if (TriggerType(trig.data1_.data1_.type_) != TriggerType::AddrData)
 	continue;
 
-      if (not trigger.matchInstOpcode(opcode, timing))
-	continue;
+      const Mcontrol<URV>& ctl = trig.data1_.mcontrol_;
+      if (not ctl.m_)
+	continue;  // Not enabled.
 
-      trigger.setLocalHit(true);
+      std::vector<MatchKind> kinds;
+      if (Select(ctl.select_) == Select::MatchAddress)
+	{
+	  if (ctl.load_)    kinds.push_back(MatchKind::LoadAddr);
+	  if (ctl.store_)   kinds.push_back(MatchKind::StoreAddr);
+	  if (ctl.execute_) kinds.push_back(MatchKind::InstAddr);
+	}
+      else
+	{
+	  if (ctl.load_)    kinds.push_back(MatchKind::LoadData);
+	  if (ctl.store_)   kinds.push_back(MatchKind::StoreData);
+	  if (ctl.execute_) kinds.push_back(MatchKind::InstOpcode);
+	}
 
-      if (updateChainHitBit(trigger))
-	hit = true;
+      URV data2 = trig.data2_;
+      unsigned timing = unsigned(TriggerTiming(ctl.timing_));
+
+      for (auto kind : kinds)
+	{
+	  auto& index = matchIndices_.at(2*unsigned(kind) + timing);
+	  if (trig.isEnterDebugOnHit())
+	    index.addEnterDebug();
+	  switch (Match(ctl.match_))
+	    {
+	    case Match::Equal:
+	      index.addEqual(ix, data2);
+	      break;
+
+	    case Match::Masked:
+	      index.addMasked(ix, trig.data2CompareMask_,
+			      data2 & trig.data2CompareMask_);
+	      break;
+
+	    case Match::GE:
+	      index.addGreaterEqual(ix, data2);
+	      break;
+
+	    case Match::LT:
+	      index.addLessThan(ix, data2);
+	      break;
+
+	    case Match::MaskHighEqualLow:
+	      // Low half of item masked by high half of data2 must equal
+	      // low half of data2.
+	      index.addMasked(ix, data2 >> halfBitCount, data2 & lowHalf);
+	      break;
+
+	    case Match::MaskLowEqualHigh:
+	      // High half of item masked by low half of data2 must equal
+	      // high half of data2.
+	      index.addMasked(ix, data2 << halfBitCount, data2 & ~lowHalf);
+	      break;
+
+	    default:
+	      break;  // Reserved match values never hit.
+	    }
+	}
     }
 
-  return hit;
+  for (auto& index : matchIndices_)
+    index.finalize();
 }
 
 
@@ -273,6 +352,7 @@ Triggers<URV>::config(unsigned trigger, URV reset1, URV reset2, URV reset3,
   triggers_.at(trigger).writeData2(true, reset2);  // Define compare mask.
 
   defineChainBounds();
+  buildMatchIndices();
 
   return true;
 }
@@ -285,6 +365,7 @@ Triggers<URV>::reset()
   for (auto& trigger : triggers_)
     trigger.reset();
   defineChainBounds();
+  buildMatchIndices();
 }
 
 
@@ -327,6 +408,7 @@ Triggers<URV>::poke(URV trigger, URV v1, URV v2, URV v3)
   trig.pokeData2(v2);
   trig.pokeData3(v3);
 
+  buildMatchIndices();
   return true;
 }
 
@@ -347,6 +429,7 @@ Triggers<URV>::pokeData1(URV trigger, URV val)
   if (prevChain != newChain)
     defineChainBounds();
 
+  buildMatchIndices();
   return true;
 }
 
@@ -361,6 +444,7 @@ Triggers<URV>::pokeData2(URV trigger, URV val)
   Trigger<URV>& trig = triggers_.at(trigger);
 
   trig.pokeData2(val);
+  buildMatchIndices();
   return true;
 }
 
@@ -547,8 +631,131 @@ Trigger<URV>::matchInstOpcode(URV opcode, TriggerTiming timing) const
 }
 
 
+template <typename URV>
+void
+TriggerMatchIndex<URV>::clear()
+{
+  equal_.clear();
+  greaterEqual_.clear();
+  lessThan_.clear();
+  masked_.clear();
+  pages_.clear();
+  count_ = 0;
+  enterDebug_ = false;
+}
+
+
+template <typename URV>
+void
+TriggerMatchIndex<URV>::addEqual(unsigned trigger, URV value)
+{
+  equal_.insert(std::make_pair(value, trigger));
+  addPages(value >> pageShift_, value >> pageShift_);
+  count_++;
+}
+
+
+template <typename URV>
+void
+TriggerMatchIndex<URV>::addGreaterEqual(unsigned trigger, URV value)
+{
+  greaterEqual_.push_back(std::make_pair(value, trigger));
+  addPages(value >> pageShift_, ~URV(0) >> pageShift_);
+  count_++;
+}
+
+
+template <typename URV>
+void
+TriggerMatchIndex<URV>::addLessThan(unsigned trigger, URV value)
+{
+  lessThan_.push_back(std::make_pair(value, trigger));
+  if (value != 0)
+    addPages(0, (value - 1) >> pageShift_);
+  count_++;
+}
+
+
+template <typename URV>
+void
+TriggerMatchIndex<URV>::addMasked(unsigned trigger, URV mask, URV value)
+{
+  auto iter = std::find_if(masked_.begin(), masked_.end(),
+			   [mask] (const MaskBucket& b) { return b.mask_ == mask; });
+  if (iter == masked_.end())
+    {
+      masked_.push_back(MaskBucket());
+      iter = masked_.end() - 1;
+      iter->mask_ = mask;
+    }
+  iter->values_.insert(std::make_pair(value, trigger));
+
+  // If the mask covers all the page number bits, the trigger can only
+  // hit in one page. Otherwise, it may hit in any page.
+  URV pageBits = ~URV(0) >> pageShift_;
+  if (((mask >> pageShift_) & pageBits) == pageBits)
+    addPages(value >> pageShift_, value >> pageShift_);
+  else
+    addPages(0, pageBits);
+  count_++;
+}
+
+
+template <typename URV>
+void
+TriggerMatchIndex<URV>::finalize()
+{
+  std::sort(greaterEqual_.begin(), greaterEqual_.end());
+  std::sort(lessThan_.begin(), lessThan_.end());
+
+  // Merge overlapping page ranges.
+  std::sort(pages_.begin(), pages_.end());
+  std::vector< std::pair<URV, URV> > merged;
+  for (const auto& range : pages_)
+    {
+      if (not merged.empty() and range.first <= merged.back().second)
+	merged.back().second = std::max(merged.back().second, range.second);
+      else
+	merged.push_back(range);
+    }
+  pages_.swap(merged);
+}
+
+
+template <typename URV>
+void
+TriggerMatchIndex<URV>::collect(URV item, std::vector<unsigned>& hits) const
+{
+  auto range = equal_.equal_range(item);
+  for (auto iter = range.first; iter != range.second; ++iter)
+    hits.push_back(iter->second);
+
+  // Thresholds are sorted: A GE trigger hits if its threshold is less
+  // than or equal to item, an LT trigger if its threshold is greater.
+  Threshold key(item, ~0u);
+  auto geEnd = std::upper_bound(greaterEqual_.begin(), greaterEqual_.end(),
+				key);
+  for (auto iter = greaterEqual_.begin(); iter != geEnd; ++iter)
+    hits.push_back(iter->second);
+
+  auto ltBegin = std::upper_bound(lessThan_.begin(), lessThan_.end(), key);
+  for (auto iter = ltBegin; iter != lessThan_.end(); ++iter)
+    hits.push_back(iter->second);
+
+  for (const auto& bucket : masked_)
+    {
+      auto range = bucket.values_.equal_range(item & bucket.mask_);
+      for (auto iter = range.first; iter != range.second; ++iter)
+	hits.push_back(iter->second);
+    }
+}
+
+
 template class WdRiscv::Trigger<uint32_t>;
 template class WdRiscv::Trigger<uint64_t>;
 
 template class WdRiscv::Triggers<uint32_t>;
 template class WdRiscv::Triggers<uint64_t>;
+
+template class WdRiscv::TriggerMatchIndex<uint32_t>;
+template class WdRiscv::TriggerMatchIndex<uint64_t>;
@@ -19,6 +19,7 @@
 #pragma once
 
 #include <cstdint>
+#include <array>
 #include <vector>
 #include <unordered_map>
 #include <string>
@@ -504,6 +505,96 @@ namespace WdRiscv
   };
 
 
+  /// Lookup structure for the armed triggers of one kind (for
+  /// example load-address triggers with before timing). It is rebuilt
+  /// from the trigger registers whenever those change so that a match
+  /// visits only the triggers that can hit instead of all of them:
+  /// Exact matches are found with a hash lookup, GE/LT matches with a
+  /// binary search over the sorted thresholds, and masked matches
+  /// with one hash lookup per distinct mask. A sorted list of the
+  /// page ranges that may contain a hit filters out accesses to other
+  /// pages before any of that is done.
+  template <typename URV>
+  class TriggerMatchIndex
+  {
+  public:
+
+    /// Remove all the triggers from this index.
+    void clear();
+
+    /// Add given trigger matching items equal to value.
+    void addEqual(unsigned trigger, URV value);
+
+    /// Add given trigger matching items greater than or equal to value.
+    void addGreaterEqual(unsigned trigger, URV value);
+
+    /// Add given trigger matching items less than value.
+    void addLessThan(unsigned trigger, URV value);
+
+    /// Add given trigger matching items x such that (x & mask) == value.
+    void addMasked(unsigned trigger, URV mask, URV value);
+
+    /// Sort the thresholds and compute the page filter. Must be
+    /// called after the last add and before any lookup.
+    void finalize();
+
+    /// Note that a trigger of this index has an enter-debug action
+    /// (it may trip even when interrupts are disabled).
+    void addEnterDebug()
+    { enterDebug_ = true; }
+
+    /// Return true if no trigger was added to this index.
+    bool empty() const
+    { return count_ == 0; }
+
+    /// Return false if no trigger in this index can trip on the given
+    /// item: Either the page of the item is not in the page filter or
+    /// interrupts are disabled and no trigger enters debug mode.
+    bool couldHit(URV item, bool interruptEnabled) const
+    {
+      if (not interruptEnabled and not enterDebug_)
+	return false;
+      URV page = item >> pageShift_;
+      for (const auto& range : pages_)
+	{
+	  if (page < range.first)
+	    return false;
+	  if (page <= range.second)
+	    return true;
+	}
+      return false;
+    }
+
+    /// Append to hits the indices of the triggers matching the given
+    /// item. Indices are not sorted.
+    void collect(URV item, std::vector<unsigned>& hits) const;
+
+  private:
+
+    typedef std::pair<URV, unsigned> Threshold;  // Value and trigger.
+
+    struct MaskBucket
+    {
+      URV mask_ = 0;
+      std::unordered_multimap<URV, unsigned> values_;
+    };
+
+    /// Add given page range (inclusive) to the page filter.
+    void addPages(URV low, URV high)
+    { pages_.push_back(std::make_pair(low, high)); }
+
+    static constexpr unsigned pageShift_ = 12;
+
+    std::unordered_multimap<URV, unsigned> equal_;
+    std::vector<Threshold> greaterEqual_;
+    std::vector<Threshold> lessThan_;
+    std::vector<MaskBucket> masked_;
+    std::vector< std::pair<URV, URV> > pages_;  // Sorted disjoint ranges.
+    unsigned count_ = 0;
+    bool enterDebug_ = false;
+  };
+
+
   template <typename URV>
   class Triggers
   {
@@ -698,9 +789,31 @@ namespace WdRiscv
     /// Define the chain bounds of each trigger.
     void defineChainBounds();
 
+    /// Kind of access matched by the triggers of a match index.
+    enum class MatchKind { LoadAddr, StoreAddr, InstAddr, LoadData, StoreData,
+			   InstOpcode };
+
+    /// Return the match index of the given kind and timing.
+    const TriggerMatchIndex<URV>& matchIndex(MatchKind kind,
+					     TriggerTiming timing) const
+    { return matchIndices_.at(2*unsigned(kind) + unsigned(timing)); }
+
+    /// Rebuild the match indices from the trigger registers. Called
+    /// whenever a trigger register is written, poked or configured.
+    void buildMatchIndices();
+
+    /// Set the local-hit bit of every trigger of the given index that
+    /// matches the given item and update the hit bits of the chains
+    /// of those triggers. Return true if any chain trips.
+    bool applyMatches(const TriggerMatchIndex<URV>& index, URV item,
+		      bool interruptEnabled);
+
   private:
 
     std::vector< Trigger<URV> > triggers_;
     bool chainPairs_ = false;
+
+    std::array< TriggerMatchIndex<URV>, 12 > matchIndices_;
+    std::vector<unsigned> matchHits_;  // Scratch for applyMatches.
   };
 }
@@ -0,0 +1,148 @@
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2018 Western Digital Corporation or its affiliates.
+//
+// This program is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+
+namespace WdRiscv
+{
+
+  template <typename URV>
+  class Core;
+
+  /// Model a RISCV vector register file. All the registers are kept
+  /// in one contiguous byte array so that a register group (LMUL > 1)
+  /// is a contiguous array of elements: Element i of width SEW of the
+  /// group starting at register r is at byte offset
+  /// r*bytesPerReg + i*SEW/8 (host is assumed little endian). This
+  /// allows the element-wise instructions to run as plain loops over
+  /// arrays which the compiler turns into host SIMD code.
+  class VecRegs
+  {
+  public:
+
+    friend class Core<uint32_t>;
+    friend class Core<uint64_t>;
+
+    /// Constructor: Define a register file with the given number of
+    /// registers each of the given size in bytes (VLEN/8). All
+    /// registers initialized to zero.
+    VecRegs(unsigned registerCount = 32, unsigned bytesPerReg = 32)
+      : regCount_(registerCount), bytesPerReg_(bytesPerReg),
+	data_(size_t(registerCount) * bytesPerReg, 0)
+    { }
+
+    /// Return the count of registers in this register file.
+    size_t size() const
+    { return regCount_; }
+
+    /// Return the number of bytes in a register (VLEN/8).
+    unsigned bytesPerReg() const
+    { return bytesPerReg_; }
+
+    /// Set bytes to the contents of the ith register (least
+    /// significant byte first). Return false if i is out of bounds.
+    bool peek(unsigned i, std::vector<uint8_t>& bytes) const
+    {
+      if (i >= regCount_)
+	return false;
+      const uint8_t* reg = data_.data() + size_t(i) * bytesPerReg_;
+      bytes.assign(reg, reg + bytesPerReg_);
+      return true;
+    }
+
+    /// Set the ith register to the given bytes (least significant
+    /// first). Missing bytes are set to zero and extra bytes are
+    /// ignored. Return false if i is out of bounds.
+    bool poke(unsigned i, const std::vector<uint8_t>& bytes)
+    {
+      if (i >= regCount_)
+	return false;
+      uint8_t* reg = data_.data() + size_t(i) * bytesPerReg_;
+      for (unsigned j = 0; j < bytesPerReg_; ++j)
+	reg[j] = j < bytes.size()? bytes.at(j) : 0;
+      return true;
+    }
+
+  protected:
+
+    /// Change the size of the registers to the given number of bytes
+    /// clearing all the registers.
+    void config(unsigned bytesPerReg)
+    {
+      bytesPerReg_ = bytesPerReg;
+      data_.assign(size_t(regCount_) * bytesPerReg, 0);
+    }
+
+    /// Return a pointer to the elements of type T of the register
+    /// group starting at register i.
+    template <typename T>
+    T* elems(unsigned i)
+    { return reinterpret_cast<T*>(data_.data() + size_t(i) * bytesPerReg_); }
+
+    template <typename T>
+    const T* elems(unsigned i) const
+    { return reinterpret_cast<const T*>(data_.data() + size_t(i) * bytesPerReg_); }
+
+    /// Return the mask bits (register v0) used by masked instructions.
+    const uint8_t* maskBits() const
+    { return data_.data(); }
+
+    void reset()
+    {
+      clearLastWrittenReg();
+      for (auto& byte : data_)
+	byte = 0;
+    }
+
+    /// Remember that the count registers starting at register i were
+    /// written by the current instruction.
+    void setLastWrittenReg(unsigned i, unsigned count)
+    {
+      lastWrittenReg_ = i;
+      lastWrittenCount_ = count;
+    }
+
+    /// Clear the number denoting the last written register.
+    void clearLastWrittenReg()
+    { lastWrittenReg_ = -1; lastWrittenCount_ = 0; }
+
+    /// Return the number of the first register of the group written
+    /// by the last executed instruction or -1 if no register has been
+    /// written since the last clearLastWrittenReg.
+    int getLastWrittenReg() const
+    { return lastWrittenReg_; }
+
+    /// Return the number of registers in the group written by the
+    /// last executed instruction.
+    unsigned getLastWrittenCount() const
+    { return lastWrittenCount_; }
+
+  private:
+
+    unsigned regCount_ = 32;
+    unsigned bytesPerReg_ = 32;
+    std::vector<uint8_t> data_;
+    int lastWrittenReg_ = -1;       // First register of last written group.
+    unsigned lastWrittenCount_ = 0; // Register count of last written group.
+  };
+}
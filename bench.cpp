@@ -0,0 +1,649 @@
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2018 Western Digital Corporation or its affiliates.
+// 
+// This program is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+// 
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+// 
+// You should have received a copy of the GNU General Public License along with
+// this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+
+// Whisper benchmark driver: Generate small RISCV kernels in simulator
+// memory using the instruction encoders of instforms.hpp, run each of
+// them under various simulator configurations (fast run, until-address,
+// tracing, triggers, performance counters) and report the achieved
+// simulation speed (instructions per second) in JSON.
+
+#include <iostream>
+#include <fstream>
+#include <functional>
+#include <boost/program_options.hpp>
+#include <nlohmann/json.hpp>
+#include <sys/time.h>
+#include "Core.hpp"
+#include "instforms.hpp"
+
+
+using namespace WdRiscv;
+
+
+namespace
+{
+  // Register usage conventions of the generated kernels.
+  constexpr unsigned RegCount = 5;   // t0: loop counter.
+  constexpr unsigned RegOne   = 6;   // t1: holds 1 (value written to tohost)
+  constexpr unsigned RegHost  = 7;   // t2: tohost address.
+  constexpr unsigned RegPtr   = 10;  // a0: data pointer.
+  constexpr unsigned RegMask  = 14;  // a4: data region offset mask.
+  constexpr unsigned RegBase  = 15;  // a5: data region base.
+
+  constexpr uint64_t CodeAddr   = 0x1000;
+  constexpr uint64_t DataAddr   = 0x100000;
+  constexpr uint64_t DataSize   = 0x100000;   // Must be a power of 2.
+  constexpr uint64_t ToHostAddr = 0x80000000;
+}
+
+
+/// Sequence of instructions (mix of 4-byte and 2-byte) making up a
+/// benchmark kernel.
+class KernelBuilder
+{
+public:
+
+  /// Append a 4-byte instruction. Encoding failures are remembered
+  /// and reported by ok(). The instruction is passed by reference so
+  /// that it is read after the encoder (first argument) has run.
+  void emit(bool encodeOk, const uint32_t& inst)
+  {
+    ok_ = ok_ and encodeOk;
+    code_.push_back(inst & 0xffff);
+    code_.push_back(inst >> 16);
+  }
+
+  /// Append a 2-byte (compressed) instruction.
+  void emit16(bool encodeOk, const uint32_t& inst)
+  {
+    ok_ = ok_ and encodeOk;
+    code_.push_back(inst & 0xffff);
+  }
+
+  /// Return the offset in bytes of the next instruction relative to
+  /// the start of the kernel.
+  int offset() const
+  { return int(code_.size() * 2); }
+
+  /// Return true if all emitted instructions were encoded successfully.
+  bool ok() const
+  { return ok_; }
+
+  const std::vector<uint16_t>& halfWords() const
+  { return code_; }
+
+private:
+
+  std::vector<uint16_t> code_;
+  bool ok_ = true;
+};
+
+
+/// Description of a benchmark kernel: The body is executed once per
+/// loop iteration and is followed by the loop-closing decrement and
+/// branch.
+struct Kernel
+{
+  std::string name;
+  std::function<void(KernelBuilder&)> body;
+  bool compressedLoop = false;   // Close loop with compressed insts.
+};
+
+
+static uint32_t
+encodeR(unsigned opcode, unsigned rd, unsigned f3, unsigned rs1, unsigned rs2,
+	unsigned f7)
+{
+  RFormInst rf(0);
+  rf.bits.opcode = opcode;
+  rf.bits.rd = rd;
+  rf.bits.funct3 = f3;
+  rf.bits.rs1 = rs1;
+  rf.bits.rs2 = rs2;
+  rf.bits.funct7 = f7;
+  return rf.code;
+}
+
+
+// There are no FP arithmetic/atomic encoders in instforms: Compose
+// those from the r-form fields.
+static uint32_t
+encodeFmaddD(unsigned rd, unsigned rs1, unsigned rs2, unsigned rs3)
+{ return encodeR(0x43, rd, 7, rs1, rs2, (rs3 << 2) | 1); }
+
+static uint32_t
+encodeFaddD(unsigned rd, unsigned rs1, unsigned rs2)
+{ return encodeR(0x53, rd, 7, rs1, rs2, 0x01); }
+
+static uint32_t
+encodeFmulD(unsigned rd, unsigned rs1, unsigned rs2)
+{ return encodeR(0x53, rd, 7, rs1, rs2, 0x09); }
+
+static uint32_t
+encodeAmoW(unsigned top5, unsigned rd, unsigned rs1, unsigned rs2)
+{ return encodeR(0x2f, rd, 2, rs1, rs2, top5 << 2); }
+
+// Bit manipulation instructions.
+static uint32_t
+encodeBitManip(unsigned f7, unsigned f3, unsigned rd, unsigned rs1,
+	       unsigned rs2)
+{ return encodeR(0x33, rd, f3, rs1, rs2, f7); }
+
+static uint32_t
+encodeBitManipUnary(unsigned rs2Field, unsigned rd, unsigned rs1)
+{ return encodeR(0x13, rd, 1, rs1, rs2Field, 0x30); }
+
+// Vector instructions (unmasked): The funct7 field is funct6 and vm.
+static uint32_t
+encodeVsetvli(unsigned rd, unsigned rs1, unsigned vtypei)
+{ return (vtypei << 20) | encodeR(0x57, rd, 7, rs1, 0, 0); }
+
+static uint32_t
+encodeVle8(unsigned vd, unsigned rs1)
+{ return encodeR(0x07, vd, 0, rs1, 0, 1); }
+
+static uint32_t
+encodeVse8(unsigned vs3, unsigned rs1)
+{ return encodeR(0x27, vs3, 0, rs1, 0, 1); }
+
+static uint32_t
+encodeVecOp(unsigned funct6, unsigned f3, unsigned vd, unsigned vs2,
+	    unsigned vs1)
+{ return encodeR(0x57, vd, f3, vs1, vs2, (funct6 << 1) | 1); }
+
+
+static std::vector<Kernel>
+defineKernels()
+{
+  std::vector<Kernel> kernels;
+
+  kernels.push_back({"alu", [](KernelBuilder& kb) {
+	uint32_t inst = 0;
+	for (unsigned i = 0; i < 4; ++i)
+	  {
+	    kb.emit(encodeAdd(11, 11, 12, inst), inst);
+	    kb.emit(encodeXor(12, 12, 11, inst), inst);
+	    kb.emit(encodeSlli(13, 11, 3, inst), inst);
+	    kb.emit(encodeAddi(11, 13, 17, inst), inst);
+	    kb.emit(encodeSltu(16, 12, 11, inst), inst);
+	    kb.emit(encodeAnd(17, 16, 13, inst), inst);
+	  }
+      }});
+
+  for (unsigned stride : { 4, 64, 4096 })
+    {
+      std::string name = "ldst_stride_" + std::to_string(stride);
+      kernels.push_back({name, [stride](KernelBuilder& kb) {
+	    uint32_t inst = 0;
+	    kb.emit(encodeLw(11, RegPtr, 0, inst), inst);
+	    kb.emit(encodeAddi(11, 11, 1, inst), inst);
+	    kb.emit(encodeSw(RegPtr, 11, 0, inst), inst);
+	    kb.emit(encodeLbu(12, RegPtr, 1, inst), inst);
+	    kb.emit(encodeSh(RegPtr, 12, 2, inst), inst);
+	    // ptr = ((ptr + stride) & mask) | base
+	    if (stride < 2048)
+	      kb.emit(encodeAddi(RegPtr, RegPtr, stride, inst), inst);
+	    else
+	      {
+		kb.emit(encodeLui(13, stride >> 12, 0, inst), inst);
+		kb.emit(encodeAdd(RegPtr, RegPtr, 13, inst), inst);
+	      }
+	    kb.emit(encodeAnd(RegPtr, RegPtr, RegMask, inst), inst);
+	    kb.emit(encodeOr(RegPtr, RegPtr, RegBase, inst), inst);
+	  }});
+    }
+
+  kernels.push_back({"branch", [](KernelBuilder& kb) {
+	uint32_t inst = 0;
+	// Data dependent branches: alternate taken/not-taken.
+	kb.emit(encodeAndi(11, RegCount, 1, inst), inst);
+	kb.emit(encodeBeq(11, 0, 8, inst), inst);
+	kb.emit(encodeAddi(12, 12, 1, inst), inst);
+	kb.emit(encodeAndi(11, RegCount, 2, inst), inst);
+	kb.emit(encodeBne(11, 0, 8, inst), inst);
+	kb.emit(encodeAddi(12, 12, -1, inst), inst);
+	kb.emit(encodeBlt(RegCount, 0, 8, inst), inst);
+	kb.emit(encodeAddi(13, 13, 1, inst), inst);
+	kb.emit(encodeBgeu(RegCount, 0, 8, inst), inst);
+	kb.emit(encodeAddi(13, 13, 1, inst), inst);
+	kb.emit(encodeJal(0, 4, 0, inst), inst);
+      }});
+
+  kernels.push_back({"muldiv", [](KernelBuilder& kb) {
+	uint32_t inst = 0;
+	kb.emit(encodeMul(11, RegCount, RegCount, inst), inst);
+	kb.emit(encodeMulh(12, 11, RegCount, inst), inst);
+	kb.emit(encodeMulhu(13, 11, 12, inst), inst);
+	kb.emit(encodeDiv(16, 11, RegCount, inst), inst);
+	kb.emit(encodeRemu(17, 11, RegCount, inst), inst);
+	kb.emit(encodeDivu(12, 16, 17, inst), inst);
+      }});
+
+  kernels.push_back({"csr", [](KernelBuilder& kb) {
+	uint32_t inst = 0;
+	uint32_t mscratch = 0x340, mcycle = 0xb00, minstret = 0xb02;
+	kb.emit(encodeCsrrw(11, RegCount, mscratch, inst), inst);
+	kb.emit(encodeCsrrs(12, 0, mcycle, inst), inst);
+	kb.emit(encodeCsrrs(13, 0, minstret, inst), inst);
+	kb.emit(encodeCsrrc(11, 12, mscratch, inst), inst);
+	kb.emit(encodeCsrrsi(11, 3, mscratch, inst), inst);
+	kb.emit(encodeCsrrci(11, 1, mscratch, inst), inst);
+      }});
+
+  kernels.push_back({"compressed", [](KernelBuilder& kb) {
+	for (unsigned i = 0; i < 4; ++i)
+	  {
+	    CiFormInst ci(0);
+	    kb.emit16(ci.encodeCaddi(11, 3), ci.code);
+	    CiFormInst ca(0);
+	    kb.emit16(ca.encodeCadd(12, 11), ca.code);
+	    CaiFormInst cx(0);
+	    kb.emit16(cx.encodeCxor(1, 2), cx.code);  // x9 ^= x10
+	    CiFormInst cs(0);
+	    kb.emit16(cs.encodeCslli(13, 1), cs.code);
+	    CaiFormInst cr(0);
+	    kb.emit16(cr.encodeCsrli(3, 2), cr.code);  // x11 >>= 2
+	  }
+      }, true});
+
+  kernels.push_back({"fp", [](KernelBuilder& kb) {
+	for (unsigned i = 0; i < 4; ++i)
+	  {
+	    kb.emit(true, encodeFmaddD(1, 2, 3, 1));
+	    kb.emit(true, encodeFaddD(4, 4, 2));
+	    kb.emit(true, encodeFmulD(5, 3, 2));
+	  }
+      }});
+
+  kernels.push_back({"bitmanip", [](KernelBuilder& kb) {
+	for (unsigned i = 0; i < 2; ++i)
+	  {
+	    kb.emit(true, encodeBitManipUnary(0, 11, RegCount));  // clz
+	    kb.emit(true, encodeBitManipUnary(2, 12, RegCount));  // cpop
+	    kb.emit(true, encodeBitManip(0x10, 2, 13, 11, 12));   // sh1add
+	    kb.emit(true, encodeBitManip(0x20, 7, 16, 13, 12));   // andn
+	    kb.emit(true, encodeBitManip(0x05, 5, 17, 16, 11));   // minu
+	    kb.emit(true, encodeBitManip(0x14, 1, 28, 17, 12));   // bset
+	  }
+      }});
+
+  kernels.push_back({"vector", [](KernelBuilder& kb) {
+	kb.emit(true, encodeVsetvli(11, 0, 3));            // e8, m8, vl=vlmax
+	kb.emit(true, encodeVle8(8, RegBase));
+	kb.emit(true, encodeVecOp(0x00, 0, 16, 8, 8));     // vadd.vv
+	kb.emit(true, encodeVecOp(0x25, 2, 24, 16, 8));    // vmul.vv
+	kb.emit(true, encodeVecOp(0x00, 2, 0, 24, 0));     // vredsum.vs
+	kb.emit(true, encodeVse8(24, RegBase));
+      }});
+
+  kernels.push_back({"amo", [](KernelBuilder& kb) {
+	kb.emit(true, encodeAmoW(0x00, 11, RegBase, RegOne));  // amoadd.w
+	kb.emit(true, encodeAmoW(0x01, 12, RegBase, 11));      // amoswap.w
+	kb.emit(true, encodeAmoW(0x08, 13, RegBase, RegCount));// amoor.w
+	kb.emit(true, encodeAmoW(0x1c, 16, RegBase, 12));      // amomaxu.w
+      }});
+
+  return kernels;
+}
+
+
+/// Generate the instructions of the given kernel: The body in a loop
+/// executed iteration-count (in RegCount) times followed by a store of
+/// 1 to the tohost address to stop the simulation.
+static bool
+buildKernel(const Kernel& kernel, KernelBuilder& kb)
+{
+  int loopStart = kb.offset();
+  kernel.body(kb);
+
+  uint32_t inst = 0;
+  if (kernel.compressedLoop)
+    {
+      // Loop counter is in x8 (a compressed-accessible register).
+      CiFormInst ci(0);
+      kb.emit16(ci.encodeCaddi(8, -1), ci.code);
+      CbFormInst cb(0);
+      kb.emit16(cb.encodeCbnez(0, loopStart - kb.offset()), cb.code);
+    }
+  else
+    {
+      kb.emit(encodeAddi(RegCount, RegCount, -1, inst), inst);
+      kb.emit(encodeBne(RegCount, 0, loopStart - kb.offset(), inst), inst);
+    }
+
+  kb.emit(encodeSw(RegHost, RegOne, 0, inst), inst);
+  kb.emit(encodeJal(0, 0, 0, inst), inst);  // Not reached.
+  return kb.ok();
+}
+
+
+/// Simulator configuration under which a kernel is run.
+enum class Mode { Run, Until, Trace, Triggers, Counters };
+
+static const char*
+modeName(Mode mode)
+{
+  switch (mode)
+    {
+    case Mode::Run:      return "run";
+    case Mode::Until:    return "until";
+    case Mode::Trace:    return "trace";
+    case Mode::Triggers: return "triggers";
+    case Mode::Counters: return "counters";
+    }
+  return "";
+}
+
+
+template <typename URV>
+static uint64_t
+retiredCount(const Core<URV>& core)
+{
+  URV low = 0, high = 0;
+  core.peekCsr(CsrNumber::MINSTRET, low);
+  if constexpr (sizeof(URV) == 4)
+    {
+      core.peekCsr(CsrNumber::MINSTRETH, high);
+      return (uint64_t(high) << 32) | low;
+    }
+  return low;
+}
+
+
+/// Run given kernel in given mode. Set instCount and seconds to the
+/// number of retired instructions and the elapsed wall-clock time.
+/// Return true on success and false if the kernel fails to build or
+/// does not stop by writing to tohost.
+template <typename URV>
+static bool
+runKernel(const Kernel& kernel, Mode mode, uint64_t iterations,
+	  FILE* traceFile, uint64_t& instCount, double& seconds)
+{
+  size_t memorySize = size_t(1) << 32;
+  Core<URV> core(0, memorySize, 32);
+
+  // Enable the a, b, c, d, f, i, m, and v extensions.
+  URV misa = 0x20112f;
+  misa |= URV(sizeof(URV) == 4 ? 1 : 2) << (8*sizeof(URV) - 2);
+  core.configCsr("misa", true, misa, 0, misa, false);
+
+  if (mode == Mode::Triggers)
+    {
+      // Arm an address trigger on load, store, and execute in machine
+      // mode with an address (0x10) that is never accessed.
+      URV type = URV(2) << (8*sizeof(URV) - 4);
+      URV data1 = type | (1 << 6) | 7;
+      core.configTrigger(0, data1, 0x10, 0, ~URV(0), ~URV(0), 0,
+			 ~URV(0), ~URV(0), 0);
+      core.enableTriggers(true);
+    }
+
+  if (mode == Mode::Counters)
+    {
+      core.configMachineModePerfCounters(4);
+      core.enablePerformanceCounters(true);
+    }
+
+  core.defineResetPc(CodeAddr);
+  core.reset();
+
+  if (mode == Mode::Counters)
+    {
+      core.pokeCsr(CsrNumber::MHPMEVENT3, URV(EventNumber::InstCommited));
+      core.pokeCsr(CsrNumber::MHPMEVENT4, URV(EventNumber::Load));
+      core.pokeCsr(CsrNumber::MHPMEVENT5, URV(EventNumber::Branch));
+      core.pokeCsr(CsrNumber::MHPMEVENT6, URV(EventNumber::Alu));
+    }
+
+  KernelBuilder kb;
+  if (not buildKernel(kernel, kb))
+    {
+      std::cerr << "Failed to encode kernel " << kernel.name << '\n';
+      return false;
+    }
+
+  size_t addr = CodeAddr;
+  for (auto half : kb.halfWords())
+    {
+      core.pokeMemory(addr, half);
+      addr += 2;
+    }
+
+  core.pokeIntReg(RegCount, iterations);
+  core.pokeIntReg(8, iterations);  // Compressed loop counter.
+  core.pokeIntReg(RegOne, 1);
+  core.pokeIntReg(RegHost, ToHostAddr);
+  core.pokeIntReg(RegPtr, DataAddr);
+  core.pokeIntReg(RegMask, DataSize - 1);
+  core.pokeIntReg(RegBase, DataAddr);
+  core.setToHostAddress(ToHostAddr);
+
+  struct timeval t0;
+  gettimeofday(&t0, nullptr);
+
+  bool ok = false;
+  if (mode == Mode::Run)
+    ok = core.run(nullptr);
+  else
+    ok = core.untilAddress(~URV(0), mode == Mode::Trace? traceFile : nullptr);
+
+  struct timeval t1;
+  gettimeofday(&t1, nullptr);
+  seconds = (t1.tv_sec - t0.tv_sec) + (t1.tv_usec - t0.tv_usec)*1e-6;
+  instCount = retiredCount(core);
+
+  if (not ok or not core.hasTargetProgramFinished())
+    {
+      std::cerr << "Kernel " << kernel.name << " in mode " << modeName(mode)
+		<< " did not complete\n";
+      return false;
+    }
+  return true;
+}
+
+
+/// Hold values provided on the command line.
+struct Args
+{
+  std::vector<std::string> kernels;  // Kernels to run (all if empty).
+  std::vector<std::string> modes;    // Modes to use (all if empty).
+  std::string outFile;               // JSON output file (stdout if empty).
+  uint64_t iterations = 1000000;
+  unsigned regWidth = 32;
+  bool list = false;
+  bool help = false;
+};
+
+
+static bool
+parseCmdLineArgs(int argc, char* argv[], Args& args)
+{
+  try
+    {
+      namespace po = boost::program_options;
+      po::options_description desc("options");
+      desc.add_options()
+	("help,h", po::bool_switch(&args.help),
+	 "Produce this message.")
+	("xlen", po::value(&args.regWidth),
+	 "Specify register width (32 or 64), defaults to 32")
+	("iterations,n", po::value(&args.iterations),
+	 "Loop iteration count of each kernel, defaults to 1000000")
+	("kernel,k", po::value(&args.kernels)->multitoken(),
+	 "Kernel(s) to run, defaults to all kernels")
+	("mode", po::value(&args.modes)->multitoken(),
+	 "Mode(s) to use: run, until, trace, triggers, counters. Defaults "
+	 "to all modes.")
+	("output,o", po::value(&args.outFile),
+	 "Write JSON report to given file instead of standard output.")
+	("list", po::bool_switch(&args.list),
+	 "List available kernels and exit.");
+
+      po::variables_map varMap;
+      po::store(po::command_line_parser(argc, argv).options(desc).run(),
+		varMap);
+      po::notify(varMap);
+
+      if (args.help)
+	{
+	  std::cout << "Run synthetic RISCV kernels through the simulator and "
+		    << "report instructions\nper second for each kernel and "
+		    << "simulator mode in JSON.\n";
+	  std::cout << desc;
+	}
+    }
+  catch (std::exception& exp)
+    {
+      std::cerr << "Failed to parse command line args: " << exp.what() << '\n';
+      return false;
+    }
+
+  return true;
+}
+
+
+template <typename URV>
+static bool
+benchmark(const Args& args, nlohmann::json& report)
+{
+  auto kernels = defineKernels();
+
+  std::vector<Mode> modes;
+  const Mode allModes[] = { Mode::Run, Mode::Until, Mode::Trace,
+			    Mode::Triggers, Mode::Counters };
+  for (auto mode : allModes)
+    if (args.modes.empty() or
+	std::find(args.modes.begin(), args.modes.end(), modeName(mode)) !=
+	args.modes.end())
+      modes.push_back(mode);
+
+  if (modes.empty())
+    {
+      std::cerr << "No valid mode specified\n";
+      return false;
+    }
+
+  // Trace output goes to the null device: We are measuring the cost of
+  // generating the trace not that of the file system.
+  FILE* traceFile = fopen("/dev/null", "w");
+  if (not traceFile)
+    {
+      std::cerr << "Failed to open /dev/null for trace output\n";
+      return false;
+    }
+
+  unsigned errors = 0, count = 0;
+  nlohmann::json results = nlohmann::json::object();
+
+  for (const auto& kernel : kernels)
+    {
+      if (not args.kernels.empty() and
+	  std::find(args.kernels.begin(), args.kernels.end(), kernel.name) ==
+	  args.kernels.end())
+	continue;
+
+      count++;
+      for (auto mode : modes)
+	{
+	  uint64_t instCount = 0;
+	  double seconds = 0;
+	  if (not runKernel<URV>(kernel, mode, args.iterations, traceFile,
+				 instCount, seconds))
+	    {
+	      errors++;
+	      continue;
+	    }
+
+	  nlohmann::json& entry = results[kernel.name][modeName(mode)];
+	  entry["instructions"] = instCount;
+	  entry["seconds"] = seconds;
+	  entry["inst_per_sec"] = seconds > 0 ? instCount / seconds : 0.0;
+	}
+    }
+
+  fclose(traceFile);
+
+  if (count == 0)
+    {
+      std::cerr << "No valid kernel specified\n";
+      return false;
+    }
+
+  report["xlen"] = 8*sizeof(URV);
+  report["iterations"] = args.iterations;
+  report["results"] = results;
+
+  return errors == 0;
+}
+
+
+int
+main(int argc, char* argv[])
+{
+  Args args;
+  if (not parseCmdLineArgs(argc, argv, args))
+    return 1;
+  if (args.help)
+    return 0;
+
+  if (args.list)
+    {
+      for (const auto& kernel : defineKernels())
+	std::cout << kernel.name << '\n';
+      return 0;
+    }
+
+  nlohmann::json report;
+  bool ok = true;
+
+  try
+    {
+      if (args.regWidth == 32)
+	ok = benchmark<uint32_t>(args, report);
+      else if (args.regWidth == 64)
+	ok = benchmark<uint64_t>(args, report);
+      else
+	{
+	  std::cerr << "Invalid register width: " << args.regWidth;
+	  std::cerr << " -- expecting 32 or 64\n";
+	  return 1;
+	}
+    }
+  catch (std::exception& e)
+    {
+      std::cerr << e.what() << '\n';
+      ok = false;
+    }
+
+  if (args.outFile.empty())
+    std::cout << report.dump(2) << '\n';
+  else
+    {
+      std::ofstream out(args.outFile);
+      if (not out)
+	{
+	  std::cerr << "Failed to open file '" << args.outFile
+		    << "' for output\n";
+	  return 1;
+	}
+      out << report.dump(2) << '\n';
+    }
+
+  return ok? 0 : 1;
+}
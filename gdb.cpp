@@ -18,25 +18,96 @@
 
 #include <stdio.h>
 #include <signal.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <atomic>
+#include <cstring>
 #include <iostream>
 #include <sstream>
+#include <thread>
 #include <boost/format.hpp>
 #include "Core.hpp"
 
 
+// Connection to gdb: Standard input/output unless a socket connection
+// was accepted (see listenForGdb). Input is read in large chunks and
+// each packet is written with a single system call. Connections are
+// accepted and read only by the simulation (main) thread. The gdb
+// connection thread only watches the sockets: State it shares with
+// the main thread is atomic.
+static std::atomic<int> gdbInFd(0);
+static int gdbOutFd = 1;
+static bool gdbSocket = false;            // True if connected with a socket.
+static bool gdbNoAck = false;             // True once in no-ack mode.
+static char gdbInBuf[65536];
+static size_t gdbInPos = 0, gdbInLen = 0;
+
+static std::atomic<int> gdbListenSoc(-1);      // Listening socket or -1.
+static std::atomic<bool> gdbConnected(false);  // Socket connection open.
+static std::atomic<bool> gdbRunning(true);     // Target running (not in stub).
+static std::atomic<bool> gdbInterrupt(false);  // Stop requested by gdb (^C).
+static std::atomic<bool> gdbRequestPending(false); // See serviceGdbRequest.
+
+// Largest packet we accept from gdb.
+static constexpr unsigned gdbPacketSize = 0x40000;
+
+
+static
+bool
+writeToGdb(const char* data, size_t size)
+{
+  if (not gdbSocket)
+    fflush(stdout);
+
+  while (size)
+    {
+      ssize_t n = 0;
+      if (gdbSocket)
+	n = send(gdbOutFd, data, size, MSG_NOSIGNAL);
+      else
+	n = write(gdbOutFd, data, size);
+      if (n < 0)
+	{
+	  if (errno == EINTR)
+	    continue;
+	  return false;
+	}
+      data += n;
+      size -= n;
+    }
+  return true;
+}
+
+
 static
 int
 putDebugChar(char c)
 {
-  return putchar(c);
+  return writeToGdb(&c, 1) ? c : -1;
 }
 
 
+// Return next character from gdb or -1 if the connection is closed.
 static
 int
 getDebugChar()
 {
-  return getchar();
+  if (gdbInPos == gdbInLen)
+    {
+      ssize_t n = 0;
+      do
+	n = read(gdbInFd, gdbInBuf, sizeof(gdbInBuf));
+      while (n < 0 and errno == EINTR);
+      if (n <= 0)
+	return -1;
+      gdbInPos = 0;
+      gdbInLen = n;
+    }
+  return static_cast<unsigned char>(gdbInBuf[gdbInPos++]);
 }
 
 
@@ -124,15 +195,16 @@ receivePacketFromGdb()
 {
   std::string data;  // Data part of packet.
 
-  unsigned char ch = ' '; // Anything besides $ will do.
+  int ch = ' '; // Anything besides $ will do.
 
   while (1)
     {
-      while (ch != '$')
+      while (ch != '$' and ch >= 0)
 	ch = getDebugChar();
 
       uint8_t sum = 0;  // checksum
-      while (1)
+      data.clear();
+      while (ch >= 0)
 	{
 	  ch = getDebugChar();
           if (ch == '$')
@@ -143,6 +215,10 @@ receivePacketFromGdb()
 	  data.push_back(ch);
 	}
 
+      // A closed connection is treated as a detach request.
+      if (ch < 0)
+	return "D";
+
       if (ch == '$')
 	continue;
 
@@ -163,8 +239,8 @@ receivePacketFromGdb()
 	    }
 	  else
 	    {
-	      putDebugChar('+');  // Signal successul reception.
-	      fflush(stdout);
+	      if (not gdbNoAck)
+		putDebugChar('+');  // Signal successul reception.
 
 	      // If sequence char present, reply with sequence id.
 	      if (data.size() >= 3 and data.at(2) == ':')
@@ -187,35 +263,48 @@ receivePacketFromGdb()
 
 
 // Send given data string as a gdb remote packet. Resend until a
-// positive ack is received.
+// positive ack is received (unless in no-ack mode).
 //
 // Format of packet:  $<data>#<checksum>
 //
-// TODO: quote special characters.
+// Characters with a special meaning in the protocol ($, #, } and *)
+// are escaped as required for binary data.
 static void
 sendPacketToGdb(const std::string& data)
 {
   const char hexDigit[] = "0123456789abcdef";
 
-  while (true)
+  std::string packet;
+  packet.reserve(data.size() + 4);
+  packet.push_back('$');
+  unsigned char checksum = 0;
+  for (unsigned char c : data)
     {
-      putDebugChar('$');
-      unsigned char checksum = 0;
-      for (unsigned char c : data)
+      if (c == '$' or c == '#' or c == '}' or c == '*')
 	{
-	  putDebugChar(c);
-	  checksum += c;
+	  packet.push_back('}');
+	  checksum += '}';
+	  c ^= 0x20;
 	}
+      packet.push_back(c);
+      checksum += c;
+    }
+  packet.push_back('#');
+  packet.push_back(hexDigit[checksum >> 4]);
+  packet.push_back(hexDigit[checksum & 0xf]);
 
-      putDebugChar('#');
-      putDebugChar(hexDigit[checksum >> 4]);
-      putDebugChar(hexDigit[checksum & 0xf]);
-      fflush(stdout);
+  while (true)
+    {
+      if (not writeToGdb(packet.data(), packet.size()))
+	return;
 
       // std::cerr << "Send to gdb: " << data << '\n';
 
-      char c = getDebugChar();
-      if (c == '+')
+      if (gdbNoAck)
+	return;
+
+      int c = getDebugChar();
+      if (c == '+' or c < 0)
 	return;
     }
 }
@@ -319,8 +408,10 @@ handlePeekRegisterForGdb(WdRiscv::Core<URV>& core, unsigned regNum,
 	  URV fpReg = regNum - fpRegOffset;
 	  uint64_t val64 = 0;
 	  ok = core.peekFpReg(fpReg, val64);
-	  if (ok)
+	  if (ok and core.isRvd())
 	    stream << littleEndianIntToHex(val64);
+	  else if (ok)
+	    stream << littleEndianIntToHex(uint32_t(val64));
 	}
       else
 	stream << "E03";
@@ -341,6 +432,96 @@ handlePeekRegisterForGdb(WdRiscv::Core<URV>& core, unsigned regNum,
 }
 
 
+/// Return the target description (XML) of the given core: The
+/// integer registers and pc and, if the F or D extension is enabled,
+/// the floating point registers. Register numbers match those of
+/// handlePeekRegisterForGdb.
+template <typename URV>
+std::string
+targetDescriptionForGdb(WdRiscv::Core<URV>& core)
+{
+  static const char* abiNames[] = {
+    "zero", "ra", "sp", "gp", "tp", "t0", "t1", "t2", "fp", "s1",
+    "a0", "a1", "a2", "a3", "a4", "a5", "a6", "a7", "s2", "s3", "s4",
+    "s5", "s6", "s7", "s8", "s9", "s10", "s11", "t3", "t4", "t5", "t6" };
+
+  unsigned xlen = 8*sizeof(URV);
+  std::ostringstream oss;
+  oss << "<?xml version=\"1.0\"?>\n"
+      << "<!DOCTYPE target SYSTEM \"gdb-target.dtd\">\n"
+      << "<target version=\"1.0\">\n"
+      << "<architecture>riscv:rv" << xlen << "</architecture>\n"
+      << "<feature name=\"org.gnu.gdb.riscv.cpu\">\n";
+  for (unsigned i = 0; i < 32; ++i)
+    oss << "<reg name=\"" << abiNames[i] << "\" bitsize=\"" << xlen
+	<< "\" regnum=\"" << i << "\"/>\n";
+  oss << "<reg name=\"pc\" bitsize=\"" << xlen
+      << "\" type=\"code_ptr\" regnum=\"32\"/>\n"
+      << "</feature>\n";
+
+  if (core.isRvf() or core.isRvd())
+    {
+      unsigned flen = core.isRvd()? 64 : 32;
+      oss << "<feature name=\"org.gnu.gdb.riscv.fpu\">\n";
+      for (unsigned i = 0; i < 32; ++i)
+	oss << "<reg name=\"f" << i << "\" bitsize=\"" << flen
+	    << "\" type=\"" << (flen == 64? "ieee_double" : "ieee_single")
+	    << "\" regnum=\"" << (33 + i) << "\"/>\n";
+      // CSRs are numbered 65 plus the CSR number.
+      oss << "<reg name=\"fflags\" bitsize=\"" << xlen
+	  << "\" regnum=\"66\" group=\"float\"/>\n"
+	  << "<reg name=\"frm\" bitsize=\"" << xlen
+	  << "\" regnum=\"67\" group=\"float\"/>\n"
+	  << "<reg name=\"fcsr\" bitsize=\"" << xlen
+	  << "\" regnum=\"68\" group=\"float\"/>\n"
+	  << "</feature>\n";
+    }
+
+  oss << "</target>\n";
+  return oss.str();
+}
+
+
+/// Append to the given string the hexadecimal representation of the
+/// given count of memory bytes starting at the given address.
+template <typename URV>
+void
+peekMemoryForGdb(WdRiscv::Core<URV>& core, URV addr, URV count,
+		 std::string& hex)
+{
+  const char hexDigit[] = "0123456789abcdef";
+  hex.reserve(hex.size() + 2*count);
+  for (URV ix = 0; ix < count; ++ix)
+    {
+      uint8_t byte = 0;
+      core.peekMemory(addr++, byte);
+      hex.push_back(hexDigit[byte >> 4]);
+      hex.push_back(hexDigit[byte & 0xf]);
+    }
+}
+
+
+/// Detach from gdb: Remove breakpoints, leave gdb mode and close the
+/// socket connection (if any) so that another gdb may connect.
+template <typename URV>
+void
+detachFromGdb(WdRiscv::Core<URV>& core)
+{
+  core.clearBreakpoints();
+  core.enableGdb(false);
+  if (gdbSocket)
+    {
+      close(gdbInFd);
+      gdbInFd = 0;
+      gdbOutFd = 1;
+      gdbSocket = false;
+      gdbConnected = false;
+    }
+  gdbNoAck = false;
+  gdbInPos = gdbInLen = 0;
+}
+
+
 template <typename URV>
 void
 handleExceptionForGdb(WdRiscv::Core<URV>& core)
@@ -353,7 +534,12 @@ handleExceptionForGdb(WdRiscv::Core<URV>& core)
   // is the resource data (e.g. content of register).
   std::ostringstream reply;
 
+  gdbRunning = false;
+  core.flushConsole();
+
   unsigned signalNum = SIGTRAP;
+  if (gdbInterrupt.exchange(false))
+    signalNum = SIGINT;  // Stopped by a gdb interrupt (control-c).
   URV cause = 0;
   if (core.peekCsr(WdRiscv::CsrNumber::MCAUSE, cause))
     {
@@ -364,6 +550,12 @@ handleExceptionForGdb(WdRiscv::Core<URV>& core)
 
   reply << "T" << (boost::format("%02x") % signalNum);
 
+  URV watchAddr = 0;
+  bool watchLoad = false;
+  if (core.getWatchpointHit(watchAddr, watchLoad))
+    reply << (watchLoad? "rwatch" : "watch") << ':'
+	  << (boost::format("%x") % watchAddr) << ';';
+
   URV spVal = 0;
   URV spNum = WdRiscv::RegSp;
   core.peekIntReg(spNum, spVal);
@@ -372,6 +564,7 @@ handleExceptionForGdb(WdRiscv::Core<URV>& core)
   sendPacketToGdb(reply.str());
 
   bool gotQuit = false;
+  bool noAck = false;
 
   while (1)
     {
@@ -441,12 +634,9 @@ handleExceptionForGdb(WdRiscv::Core<URV>& core)
 		  reply << "E02";
 		else
 		  {
-		    for (URV ix = 0; ix < len; ++ix)
-		      {
-			uint8_t byte = 0;
-			core.peekMemory(addr++, byte);
-			reply << (boost::format("%02x") % unsigned(byte));
-		      }
+		    std::string hex;
+		    peekMemoryForGdb(core, addr, len, hex);
+		    reply << hex;
 		  }
 	      }
 	  }
@@ -485,12 +675,16 @@ handleExceptionForGdb(WdRiscv::Core<URV>& core)
 	case 'c':  // cAA..AA    Continue at address AA..AA(optional)
 	  {
 	    if (packet.size() == 1)
-	      return;
+	      {
+		gdbRunning = true;
+		return;
+	      }
 
 	    URV newPc = 0;
 	    if (hexToInt(packet.substr(1), newPc))
 	      {
 		core.pokePc(newPc);
+		gdbRunning = true;
 		return;
 	      }
 
@@ -544,6 +738,85 @@ handleExceptionForGdb(WdRiscv::Core<URV>& core)
 	  handleExceptionForGdb(core);
 	  return;
 
+	case 'X': // XAA..AA,LLLL:bb..bb  Write LLLL binary bytes at AA..AA
+	  {
+	    std::string addrStr, lenStr, data;
+	    auto colonIx = packet.find(':');
+	    URV addr = 0, len = 0;
+	    if (colonIx == std::string::npos or
+		not getStringComponents(packet.substr(1, colonIx - 1), ',',
+					addrStr, lenStr))
+	      reply << "E01";
+	    else if (not hexToInt(addrStr, addr) or not hexToInt(lenStr, len))
+	      reply << "E02";
+	    else
+	      {
+		// Bytes 0x23 (#), 0x24 ($), 0x7d (}) and 0x2a (*) are
+		// sent as 0x7d followed by the byte xor 0x20.
+		URV count = 0;
+		for (size_t ix = colonIx + 1; ix < packet.size() and count < len;
+		     ++ix, ++count)
+		  {
+		    uint8_t byte = packet.at(ix);
+		    if (byte == 0x7d and ix + 1 < packet.size())
+		      byte = packet.at(++ix) ^ 0x20;
+		    core.pokeMemory(addr++, byte);
+		  }
+		reply << (count == len? "OK" : "E03");
+	      }
+	  }
+	  break;
+
+	case 'D':  // Detach: Target continues running without gdb.
+	  reply << "OK";
+	  sendPacketToGdb(reply.str());
+	  detachFromGdb(core);
+	  gdbRunning = true;
+	  return;
+
+	case 'Z':  // Ztype,addr,kind   Insert breakpoint or watchpoint
+	case 'z':  // ztype,addr,kind   Remove breakpoint or watchpoint
+	  {
+	    bool insert = packet.at(0) == 'Z';
+	    std::string fields = packet.substr(1);
+	    auto condIx = fields.find(';');  // Ignore optional conditions.
+	    if (condIx != std::string::npos)
+	      fields = fields.substr(0, condIx);
+
+	    std::string typeStr, addrStr, kindStr;
+	    URV type = 0, addr = 0, kind = 0;
+	    if (not getStringComponents(fields, ',', ',', typeStr, addrStr,
+					kindStr))
+	      reply << "E01";
+	    else if (not hexToInt(typeStr, type) or not hexToInt(addrStr, addr)
+		     or not hexToInt(kindStr, kind))
+	      reply << "E02";
+	    else if (type <= 1)
+	      {
+		// Software or hardware breakpoint: Same for the simulator.
+		bool ok = true;
+		if (insert)
+		  core.addBreakpoint(addr);
+		else
+		  ok = core.removeBreakpoint(addr);
+		reply << (ok? "OK" : "E03");
+	      }
+	    else if (type <= 4)
+	      {
+		// Write (2), read (3) or access (4) watchpoint of kind bytes.
+		bool read = type != 2, write = type != 3;
+		bool ok = true;
+		if (insert)
+		  core.addWatchpoint(addr, kind, read, write);
+		else
+		  ok = core.removeWatchpoint(addr, kind, read, write);
+		reply << (ok? "OK" : "E03");
+	      }
+	    else
+	      reply << "";  // Unsupported type: Empty response.
+	  }
+	  break;
+
 	case 'k':  // kill
 	  reply << "OK";
 	  gotQuit = true;
@@ -556,6 +829,45 @@ handleExceptionForGdb(WdRiscv::Core<URV>& core)
 	    reply << "Text=0;Data=0;Bss=0";
 	  else if (packet == "qSymbol::")
 	    reply << "OK";
+	  else if (packet.find("qSupported") == 0)
+	    reply << "PacketSize=" << std::hex << gdbPacketSize << std::dec
+		  << ";QStartNoAckMode+;qXfer:features:read+;vContSupported+";
+	  else if (packet.find("qXfer:features:read:target.xml:") == 0)
+	    {
+	      // qXfer:features:read:target.xml:offset,length
+	      std::string offStr, lenStr;
+	      size_t prefixLen = strlen("qXfer:features:read:target.xml:");
+	      URV offset = 0, len = 0;
+	      if (not getStringComponents(packet.substr(prefixLen), ',',
+					  offStr, lenStr) or
+		  not hexToInt(offStr, offset) or not hexToInt(lenStr, len))
+		reply << "E01";
+	      else
+		{
+		  std::string xml = targetDescriptionForGdb(core);
+		  if (offset >= xml.size())
+		    reply << "l";
+		  else
+		    {
+		      std::string chunk = xml.substr(offset, len);
+		      bool last = offset + chunk.size() >= xml.size();
+		      reply << (last? "l" : "m") << chunk;
+		    }
+		}
+	    }
+	  else
+	    {
+	      std::cerr << "Unhandled gdb request: " << packet << '\n';
+	      reply << ""; // Unsupported: Empty response.
+	    }
+	  break;
+
+	case 'Q':
+	  if (packet == "QStartNoAckMode")
+	    {
+	      reply << "OK";
+	      noAck = true;  // Takes effect after the reply is acknowledged.
+	    }
 	  else
 	    {
 	      std::cerr << "Unhandled gdb request: " << packet << '\n';
@@ -566,6 +878,25 @@ handleExceptionForGdb(WdRiscv::Core<URV>& core)
 	case 'v':
 	  if (packet == "vMustReplyEmpty")
 	    reply << "";
+	  else if (packet == "vCont?")
+	    reply << "vCont;c;C;s;S";
+	  else if (packet.find("vCont;") == 0 and packet.size() > 6)
+	    {
+	      // Only one hart: Apply the first action (ignoring thread id).
+	      char action = packet.at(6);
+	      if (action == 'c' or action == 'C')
+		{
+		  gdbRunning = true;
+		  return;
+		}
+	      if (action == 's' or action == 'S')
+		{
+		  core.singleStep(nullptr);
+		  handleExceptionForGdb(core);
+		  return;
+		}
+	      reply << "E01";
+	    }
 	  else if (packet.find("vKill;") == 0)
 	    {
 	      reply << "OK";
@@ -585,6 +916,8 @@ handleExceptionForGdb(WdRiscv::Core<URV>& core)
 
       // Reply to the request
       sendPacketToGdb(reply.str());
+      if (noAck)
+	gdbNoAck = true;
 
       if (gotQuit)
 	exit(0);
@@ -592,5 +925,217 @@ handleExceptionForGdb(WdRiscv::Core<URV>& core)
 }
 
 
+// Open a socket listening for gdb connections. If spec is a number,
+// listen on that TCP port of the local host. Otherwise, spec is the
+// path of a Unix-domain socket. Return socket or -1 on failure.
+static
+int
+openGdbListenSocket(const std::string& spec)
+{
+  bool isPort = not spec.empty() and
+    spec.find_first_not_of("0123456789") == std::string::npos;
+
+  int soc = socket(isPort? AF_INET : AF_UNIX, SOCK_STREAM, 0);
+  if (soc < 0)
+    {
+      perror("Failed to create gdb socket");
+      return -1;
+    }
+
+  int rc = 0;
+  if (isPort)
+    {
+      int one = 1;
+      setsockopt(soc, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+      sockaddr_in addr;
+      memset(&addr, 0, sizeof(addr));
+      addr.sin_family = AF_INET;
+      addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+      addr.sin_port = htons(std::stoul(spec));
+      rc = bind(soc, (sockaddr*) &addr, sizeof(addr));
+    }
+  else
+    {
+      sockaddr_un addr;
+      memset(&addr, 0, sizeof(addr));
+      addr.sun_family = AF_UNIX;
+      if (spec.size() >= sizeof(addr.sun_path))
+	{
+	  std::cerr << "Gdb socket path too long: " << spec << '\n';
+	  close(soc);
+	  return -1;
+	}
+      strcpy(addr.sun_path, spec.c_str());
+      unlink(spec.c_str());
+      rc = bind(soc, (sockaddr*) &addr, sizeof(addr));
+    }
+
+  if (rc < 0 or listen(soc, 1) < 0)
+    {
+      perror("Failed to bind/listen on gdb socket");
+      close(soc);
+      return -1;
+    }
+
+  return soc;
+}
+
+
+// Make the given (accepted) socket the connection to gdb.
+static
+void
+useGdbConnection(int soc)
+{
+  int one = 1;
+  setsockopt(soc, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+  gdbInFd = gdbOutFd = soc;
+  gdbInPos = gdbInLen = 0;
+  gdbNoAck = false;
+  gdbSocket = true;
+  gdbConnected = true;
+}
+
+
+/// Service a stop requested by the gdb connection thread (see
+/// gdbConnectionThread). This is called by the core, on the main
+/// thread, before the next instruction: Accept a pending connection
+/// entering gdb mode, or consume a pending interrupt (control-c)
+/// request. Return true if control must pass to gdb.
+template <typename URV>
+bool
+serviceGdbRequest(WdRiscv::Core<URV>& core)
+{
+  bool stop = false;
+
+  pollfd pfd;
+  pfd.events = POLLIN;
+  pfd.revents = 0;
+
+  if (not gdbConnected)
+    {
+      pfd.fd = gdbListenSoc;
+      if (pfd.fd >= 0 and poll(&pfd, 1, 0) > 0)
+	{
+	  int soc = accept(pfd.fd, nullptr, nullptr);
+	  if (soc >= 0)
+	    {
+	      useGdbConnection(soc);
+	      core.enableGdb(true);
+	      stop = true;
+	    }
+	}
+    }
+  else if (gdbInPos < gdbInLen)
+    {
+      // Buffered data from gdb while the target runs.
+      if (gdbInBuf[gdbInPos] == 3)
+	{
+	  gdbInPos++;
+	  gdbInterrupt = true;
+	}
+      stop = true;
+    }
+  else
+    {
+      // Data from gdb while the target runs: An interrupt request or
+      // the end of the connection (the stub then detaches). Leave any
+      // other data to the stub.
+      pfd.fd = gdbInFd;
+      if (poll(&pfd, 1, 0) > 0)
+	{
+	  char c = 0;
+	  if (recv(pfd.fd, &c, 1, MSG_PEEK) == 1 and c == 3)
+	    {
+	      recv(pfd.fd, &c, 1, 0);
+	      gdbInterrupt = true;
+	    }
+	  stop = true;
+	}
+    }
+
+  gdbRequestPending = false;
+  return stop;
+}
+
+
+// Body of the gdb connection thread: While the target is running,
+// watch the listening socket (no gdb connected) or the gdb connection
+// for input and make the core stop at the next instruction so that
+// the main thread services the input (see serviceGdbRequest). This
+// thread does not accept connections or read data.
+template <typename URV>
+static
+void
+gdbConnectionThread(WdRiscv::Core<URV>* core)
+{
+  while (true)
+    {
+      if (gdbRequestPending)
+	{
+	  // Not yet serviced: Repeat the request in case the core
+	  // cleared it while updating its break check.
+	  usleep(10000);
+	  if (gdbRequestPending)
+	    core->requestGdbStop();
+	  continue;
+	}
+
+      if (not gdbRunning)
+	{
+	  usleep(10000);  // Stub is talking to gdb.
+	  continue;
+	}
+
+      pollfd pfd;
+      pfd.fd = gdbConnected ? int(gdbInFd) : int(gdbListenSoc);
+      pfd.events = POLLIN;
+      pfd.revents = 0;
+      if (poll(&pfd, 1, 100) <= 0 or not gdbRunning)
+	continue;
+
+      gdbRequestPending = true;
+      core->requestGdbStop();
+    }
+}
+
+
+template <typename URV>
+bool
+listenForGdb(WdRiscv::Core<URV>& core, const std::string& spec, bool wait)
+{
+  int listenSoc = openGdbListenSocket(spec);
+  if (listenSoc < 0)
+    return false;
+
+  if (wait)
+    {
+      std::cerr << "Waiting for gdb connection on " << spec << '\n';
+      int soc = accept(listenSoc, nullptr, nullptr);
+      if (soc < 0)
+	{
+	  perror("Gdb socket accept failed");
+	  return false;
+	}
+      useGdbConnection(soc);
+      core.enableGdb(true);
+    }
+
+  gdbListenSoc = listenSoc;
+  std::thread thread(gdbConnectionThread<URV>, &core);
+  thread.detach();
+  return true;
+}
+
+
 template void handleExceptionForGdb<uint32_t>(WdRiscv::Core<uint32_t>&);
 template void handleExceptionForGdb<uint64_t>(WdRiscv::Core<uint64_t>&);
+
+template bool serviceGdbRequest<uint32_t>(WdRiscv::Core<uint32_t>&);
+template bool serviceGdbRequest<uint64_t>(WdRiscv::Core<uint64_t>&);
+
+template bool listenForGdb<uint32_t>(WdRiscv::Core<uint32_t>&,
+				     const std::string&, bool);
+template bool listenForGdb<uint64_t>(WdRiscv::Core<uint64_t>&,
+				     const std::string&, bool);
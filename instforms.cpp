@@ -563,15 +563,15 @@ IFormInst::encodeSlli(unsigned rd, unsigned rs1, unsigned shamt)
   if (rd > 31 or rs1 > 31)
     return false;  // Register(s) out of bounds.
 
-  if (shamt > 31)
-    return false;  // Shift amount out ofbounds.
+  if (shamt > 63)
+    return false;  // Shift amount out ofbounds (6-bit shamt is rv64 only).
 
-  fields2.opcode = 0x13;
-  fields2.rd = rd;
-  fields2.funct3 = 1;
-  fields2.rs1 = rs1;
-  fields2.shamt = shamt;
-  fields2.top7 = 0;
+  fields3.opcode = 0x13;
+  fields3.rd = rd;
+  fields3.funct3 = 1;
+  fields3.rs1 = rs1;
+  fields3.shamt = shamt;
+  fields3.top6 = 0;
   return true;
 }
 
@@ -581,7 +581,7 @@ IFormInst::encodeSrli(unsigned rd, unsigned rs1, unsigned shamt)
 {
   if (not encodeSlli(rd, rs1, shamt))
     return false;
-  fields2.funct3 = 5;
+  fields3.funct3 = 5;
   return true;
 }
 
@@ -591,8 +591,8 @@ IFormInst::encodeSrai(unsigned rd, unsigned rs1, unsigned shamt)
 {
   if (not encodeSlli(rd, rs1, shamt))
     return false;
-  fields2.funct3 = 5;
-  fields2.top7 = 0x20;
+  fields3.funct3 = 5;
+  fields3.top6 = 0x10;
   return true;
 }
 
@@ -642,7 +642,7 @@ IFormInst::encodeAddiw(unsigned rd, unsigned rs1, int imm)
 {
   if (not encodeAddi(rd, rs1, imm))
     return false;
-  fields.opcode = 0x033;
+  fields.opcode = 0x1b;
   fields.funct3 = 0;
   return true;
 }
@@ -654,10 +654,10 @@ IFormInst::encodeSlliw(unsigned rd, unsigned rs1, unsigned shamt)
   if (rd > 31 or rs1 > 31)
     return false;  // Register(s) out of bounds.
 
-  if (shamt > 63)
+  if (shamt > 31)
     return false;  // Shift amount out ofbounds.
 
-  fields2.opcode = 0x033;
+  fields2.opcode = 0x1b;
   fields2.rd = rd;
   fields2.funct3 = 1;
   fields2.rs1 = rs1;
@@ -726,7 +726,7 @@ IFormInst::encodeCsrrw(uint32_t rd, uint32_t rs1, uint32_t csr)
   if (csr >= (1 << 12))
     return false;
 
-  fields.opcode = 0x7f;
+  fields.opcode = 0x73;
   fields.rd = rd;
   fields.funct3 = 1;
   fields.rs1 = rs1;
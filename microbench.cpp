@@ -0,0 +1,476 @@
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2018 Western Digital Corporation or its affiliates.
+//
+// This program is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+
+// Micro-benchmarks of the simulator hot primitives (memory access,
+// CSR access, decode, triggers, disassembly). Each benchmark is a
+// small function timed over an automatically calibrated iteration
+// count. Results are written in JSON using the same layout as the
+// Google Benchmark library (benchmarks array with name, iterations,
+// real_time and time_unit) so that existing tools can track them.
+
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <functional>
+#include <regex>
+#include <boost/program_options.hpp>
+#include <nlohmann/json.hpp>
+#include "Core.hpp"
+#include "Memory.hpp"
+#include "CsRegs.hpp"
+#include "Triggers.hpp"
+
+
+using namespace WdRiscv;
+
+
+/// Prevent the compiler from optimizing away the computation of the
+/// given value.
+template <typename T>
+inline void
+doNotOptimize(const T& value)
+{
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+
+/// Memory with access to the configuration methods normally reserved
+/// to the core.
+class BenchMemory : public Memory
+{
+public:
+
+  BenchMemory(size_t size)
+    : Memory(size)
+  { }
+
+  using Memory::defineDccm;
+  using Memory::defineMemoryMappedRegisterRegion;
+};
+
+
+/// Core with access to the protected decode16 method.
+template <typename URV>
+class BenchCore : public Core<URV>
+{
+public:
+
+  BenchCore()
+    : Core<URV>(0, size_t(1) << 32, 32)
+  { }
+
+  using Core<URV>::decode16;
+};
+
+
+/// Register and run micro-benchmarks.
+class Runner
+{
+public:
+
+  /// The function of a benchmark executes its operation the given
+  /// number of times.
+  typedef std::function<void(uint64_t)> BenchFunc;
+
+  Runner(double minTime, const std::string& filter)
+    : minTime_(minTime), hasFilter_(not filter.empty()), filter_(filter)
+  { }
+
+  /// Run given benchmark (unless excluded by the filter) recording
+  /// the average time per operation.
+  void run(const std::string& name, const BenchFunc& func)
+  {
+    if (hasFilter_ and not std::regex_search(name, filter_))
+      return;
+
+    // Warm up and calibrate: grow the iteration count until the
+    // elapsed time is significant then scale it to the minimum time.
+    uint64_t iters = 64;
+    double elapsed = time(func, iters);
+    while (elapsed < minTime_ / 10 and iters < (uint64_t(1) << 40))
+      {
+	iters *= 8;
+	elapsed = time(func, iters);
+      }
+    if (elapsed < minTime_)
+      {
+	double scale = minTime_ / std::max(elapsed, 1e-9);
+	iters = uint64_t(iters * std::min(scale * 1.1, 100.0));
+	elapsed = time(func, iters);
+      }
+
+    nlohmann::json entry;
+    entry["name"] = name;
+    entry["iterations"] = iters;
+    entry["real_time"] = elapsed * 1e9 / iters;
+    entry["time_unit"] = "ns";
+    results_.push_back(entry);
+
+    std::cerr << name << ": " << (elapsed * 1e9 / iters) << " ns\n";
+  }
+
+  const nlohmann::json& results() const
+  { return results_; }
+
+private:
+
+  static double time(const BenchFunc& func, uint64_t iters)
+  {
+    auto t0 = std::chrono::steady_clock::now();
+    func(iters);
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(t1 - t0).count();
+  }
+
+  double minTime_;
+  bool hasFilter_;
+  std::regex filter_;
+  nlohmann::json results_ = nlohmann::json::array();
+};
+
+
+/// Benchmark memory read/write of type T starting at given address
+/// and stepping by the given stride (wrapping within span bytes). Span
+/// must be a power of 2.
+template <typename T>
+static void
+benchMemory(Runner& runner, BenchMemory& mem, const std::string& tag,
+	    size_t addr, size_t stride, size_t span)
+{
+  std::string size = std::to_string(8*sizeof(T));
+
+  runner.run("Memory::read<u" + size + ">/" + tag, [&](uint64_t n) {
+      size_t offset = 0;
+      T value = 0;
+      for (uint64_t i = 0; i < n; ++i)
+	{
+	  mem.read(addr + offset, value);
+	  doNotOptimize(value);
+	  offset = (offset + stride) & (span - 1);
+	}
+    });
+
+  runner.run("Memory::write<u" + size + ">/" + tag, [&](uint64_t n) {
+      size_t offset = 0;
+      for (uint64_t i = 0; i < n; ++i)
+	{
+	  bool ok = mem.write(addr + offset, T(i));
+	  doNotOptimize(ok);
+	  offset = (offset + stride) & (span - 1);
+	}
+    });
+}
+
+
+static void
+benchMemories(Runner& runner)
+{
+  // Region 1 (starting at 256M) holds a DCCM and a memory-mapped
+  // register area.
+  size_t regionSize = 256*1024*1024;
+  size_t dccmOffset = 0, dccmSize = 64*1024;
+  size_t mmrOffset = 0x100000, mmrSize = 0x8000;
+
+  BenchMemory mem(size_t(1) << 30);
+  if (not mem.defineDccm(1, dccmOffset, dccmSize) or
+      not mem.defineMemoryMappedRegisterRegion(1, mmrOffset, mmrSize))
+    {
+      std::cerr << "Failed to configure DCCM/memory-mapped registers\n";
+      return;
+    }
+
+  size_t ram = 0x10000, span = 0x10000, page = 4096;
+
+  benchMemory<uint8_t>(runner, mem, "aligned", ram, 1, span);
+  benchMemory<uint16_t>(runner, mem, "aligned", ram, 2, span);
+  benchMemory<uint32_t>(runner, mem, "aligned", ram, 4, span);
+  benchMemory<uint64_t>(runner, mem, "aligned", ram, 8, span);
+
+  benchMemory<uint32_t>(runner, mem, "misaligned", ram + 1, 4, span);
+  benchMemory<uint64_t>(runner, mem, "misaligned", ram + 3, 8, span);
+
+  // Each access straddles two pages.
+  benchMemory<uint32_t>(runner, mem, "page_crossing", ram + page - 2,
+			page, span);
+  benchMemory<uint64_t>(runner, mem, "page_crossing", ram + page - 4,
+			page, span);
+
+  size_t dccm = regionSize + dccmOffset;
+  benchMemory<uint32_t>(runner, mem, "dccm", dccm, 4, dccmSize);
+  benchMemory<uint64_t>(runner, mem, "dccm", dccm, 8, dccmSize);
+
+  // Memory mapped registers are accessible by word only.
+  size_t mmr = regionSize + mmrOffset;
+  benchMemory<uint32_t>(runner, mem, "mmio", mmr, 4, mmrSize);
+}
+
+
+static void
+benchCsRegs(Runner& runner)
+{
+  typedef uint32_t URV;
+  CsRegs<URV> csRegs;
+  PrivilegeMode mode = PrivilegeMode::Machine;
+
+  struct Item { const char* tag; CsrNumber csr; };
+  Item items[] = { { "mscratch", CsrNumber::MSCRATCH },
+		   { "mstatus",  CsrNumber::MSTATUS },
+		   { "mepc",     CsrNumber::MEPC },
+		   { "mcycle",   CsrNumber::MCYCLE },
+		   { "tdata1",   CsrNumber::TDATA1 } };
+
+  for (const auto& item : items)
+    {
+      CsrNumber csr = item.csr;
+      runner.run(std::string("CsRegs::read/") + item.tag, [&](uint64_t n) {
+	  URV value = 0;
+	  for (uint64_t i = 0; i < n; ++i)
+	    {
+	      csRegs.read(csr, mode, false, value);
+	      doNotOptimize(value);
+	    }
+	});
+
+      runner.run(std::string("CsRegs::write/") + item.tag, [&](uint64_t n) {
+	  for (uint64_t i = 0; i < n; ++i)
+	    {
+	      bool ok = csRegs.write(csr, mode, false, URV(i) & ~URV(0xf));
+	      doNotOptimize(ok);
+	    }
+	});
+    }
+}
+
+
+/// Representative 32-bit instruction codes: lui, addi, add, lw, sw,
+/// beq, jal, csrrw, mul, div, amoadd.w, fadd.s, fmadd.d, fsqrt.d.
+static const uint32_t insts32[] = { 0x000122b7, 0x00a28293, 0x00c585b3,
+				    0x0005a583, 0x00b52023, 0x00b50463,
+				    0x008000ef, 0x34029573, 0x02c585b3,
+				    0x02c5c5b3, 0x00c5a5af, 0x00c58553,
+				    0x1ac5f543, 0x5a0585d3 };
+
+/// Representative 16-bit codes: c.addi, c.li, c.lw, c.sw, c.mv, c.add,
+/// c.j, c.beqz, c.slli, c.lwsp, c.swsp, c.addi4spn.
+static const uint16_t insts16[] = { 0x0505, 0x4581, 0x4188, 0xc188, 0x85aa,
+				    0x95aa, 0xa001, 0xc111, 0x0586, 0x4582,
+				    0xc22e, 0x0048 };
+
+
+static void
+benchDecode(Runner& runner)
+{
+  BenchCore<uint32_t> core;
+  core.reset();
+
+  const size_t n32 = sizeof(insts32) / sizeof(insts32[0]);
+  const size_t n16 = sizeof(insts16) / sizeof(insts16[0]);
+
+  runner.run("Core::decode/32", [&](uint64_t n) {
+      uint32_t op0 = 0, op1 = 0; int32_t op2 = 0;
+      for (uint64_t i = 0; i < n; ++i)
+	{
+	  const InstInfo& info = core.decode(insts32[i % n32], op0, op1, op2);
+	  doNotOptimize(&info);
+	  doNotOptimize(op2);
+	}
+    });
+
+  runner.run("Core::decode/16", [&](uint64_t n) {
+      uint32_t op0 = 0, op1 = 0; int32_t op2 = 0;
+      for (uint64_t i = 0; i < n; ++i)
+	{
+	  const InstInfo& info = core.decode(insts16[i % n16], op0, op1, op2);
+	  doNotOptimize(&info);
+	  doNotOptimize(op2);
+	}
+    });
+
+  runner.run("Core::decode16", [&](uint64_t n) {
+      uint32_t op0 = 0, op1 = 0; int32_t op2 = 0;
+      for (uint64_t i = 0; i < n; ++i)
+	{
+	  const InstInfo& info = core.decode16(insts16[i % n16], op0, op1, op2);
+	  doNotOptimize(&info);
+	  doNotOptimize(op2);
+	}
+    });
+
+  runner.run("Core::expandInst", [&](uint64_t n) {
+      uint32_t code32 = 0;
+      for (uint64_t i = 0; i < n; ++i)
+	{
+	  bool ok = core.expandInst(insts16[i % n16], code32);
+	  doNotOptimize(ok);
+	  doNotOptimize(code32);
+	}
+    });
+
+  runner.run("Core::disassembleInst/32", [&](uint64_t n) {
+      std::string text;
+      for (uint64_t i = 0; i < n; ++i)
+	{
+	  core.disassembleInst(insts32[i % n32], text);
+	  doNotOptimize(text.data());
+	}
+    });
+
+  runner.run("Core::disassembleInst/16", [&](uint64_t n) {
+      std::string text;
+      for (uint64_t i = 0; i < n; ++i)
+	{
+	  core.disassembleInst(insts16[i % n16], text);
+	  doNotOptimize(text.data());
+	}
+    });
+}
+
+
+static void
+benchTriggers(Runner& runner)
+{
+  typedef uint32_t URV;
+  const unsigned maxTriggers = 8;
+
+  for (unsigned armed = 0; armed <= maxTriggers; ++armed)
+    {
+      Triggers<URV> triggers(maxTriggers);
+
+      // Arm the first few triggers as machine-mode load/store
+      // address-equal triggers on addresses that are never accessed
+      // so that every armed trigger is fully evaluated.
+      URV type = URV(2) << (8*sizeof(URV) - 4);
+      URV data1 = type | (1 << 6) | 3;
+      for (unsigned i = 0; i < armed; ++i)
+	triggers.config(i, data1, 0x10 + 4*i, 0, ~URV(0), ~URV(0), 0,
+			~URV(0), ~URV(0), 0);
+
+      std::string name = "Triggers::ldStAddrTriggerHit/" +
+	std::to_string(armed);
+      runner.run(name, [&](uint64_t n) {
+	  URV addr = 0x10000;
+	  for (uint64_t i = 0; i < n; ++i)
+	    {
+	      bool hit = triggers.ldStAddrTriggerHit(addr + 4*(i & 0xff),
+						     TriggerTiming::Before,
+						     true, true);
+	      doNotOptimize(hit);
+	    }
+	});
+    }
+}
+
+
+/// Hold values provided on the command line.
+struct Args
+{
+  std::string filter;    // Regular expression selecting benchmarks.
+  std::string outFile;   // JSON output file (stdout if empty).
+  double minTime = 0.1;  // Minimum time in seconds per benchmark.
+  bool help = false;
+};
+
+
+static bool
+parseCmdLineArgs(int argc, char* argv[], Args& args)
+{
+  try
+    {
+      namespace po = boost::program_options;
+      po::options_description desc("options");
+      desc.add_options()
+	("help,h", po::bool_switch(&args.help),
+	 "Produce this message.")
+	("filter,f", po::value(&args.filter),
+	 "Run only the benchmarks with names matching given regular "
+	 "expression.")
+	("mintime", po::value(&args.minTime),
+	 "Minimum run time in seconds of each benchmark, defaults to 0.1")
+	("output,o", po::value(&args.outFile),
+	 "Write JSON report to given file instead of standard output.");
+
+      po::variables_map varMap;
+      po::store(po::command_line_parser(argc, argv).options(desc).run(),
+		varMap);
+      po::notify(varMap);
+
+      if (args.help)
+	{
+	  std::cout << "Measure the cost of individual simulator primitives "
+		    << "(memory, CSR,\ndecode, trigger and disassembly) and "
+		    << "report them in JSON.\n";
+	  std::cout << desc;
+	}
+    }
+  catch (std::exception& exp)
+    {
+      std::cerr << "Failed to parse command line args: " << exp.what() << '\n';
+      return false;
+    }
+
+  return true;
+}
+
+
+int
+main(int argc, char* argv[])
+{
+  Args args;
+  if (not parseCmdLineArgs(argc, argv, args))
+    return 1;
+  if (args.help)
+    return 0;
+
+  nlohmann::json report;
+
+  try
+    {
+      Runner runner(args.minTime, args.filter);
+
+      benchMemories(runner);
+      benchCsRegs(runner);
+      benchDecode(runner);
+      benchTriggers(runner);
+
+      report["context"]["executable"] = argv[0];
+      report["context"]["min_time"] = args.minTime;
+      report["benchmarks"] = runner.results();
+    }
+  catch (std::exception& e)
+    {
+      std::cerr << e.what() << '\n';
+      return 1;
+    }
+
+  if (args.outFile.empty())
+    std::cout << report.dump(2) << '\n';
+  else
+    {
+      std::ofstream out(args.outFile);
+      if (not out)
+	{
+	  std::cerr << "Failed to open file '" << args.outFile
+		    << "' for output\n";
+	  return 1;
+	}
+      out << report.dump(2) << '\n';
+    }
+
+  return 0;
+}
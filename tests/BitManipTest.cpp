@@ -0,0 +1,285 @@
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2018 Western Digital Corporation or its affiliates.
+//
+// This program is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+
+// Check the semantics of the Zba, Zbb and Zbs instructions (rv32 and
+// rv64): Each instruction, encoded from the fields of the
+// specification, is executed on random and special operands and its
+// result compared to a reference computation. Check also that the
+// instructions disassemble with their ISA mnemonics, that the word
+// forms are illegal in rv32 and that all are illegal without b.
+
+#include <cstring>
+#include <functional>
+#include <random>
+#include "TestUtil.hpp"
+
+
+using namespace WdRiscv;
+using namespace WdRiscvTest;
+
+
+/// Return an R-form instruction code with rd=x3, rs1=x1 and rs2=x2.
+static uint32_t
+rform(uint32_t funct7, uint32_t funct3, uint32_t opcode)
+{
+  return (funct7 << 25) | (2 << 20) | (1 << 15) | (funct3 << 12) | (3 << 7) |
+    opcode;
+}
+
+
+/// Return an I-form instruction code with rd=x3, rs1=x1 and the given
+/// 12-bit immediate field.
+static uint32_t
+iform(uint32_t imm12, uint32_t funct3, uint32_t opcode)
+{
+  return (imm12 << 20) | (1 << 15) | (funct3 << 12) | (3 << 7) | opcode;
+}
+
+
+const uint32_t opOp = 0x33, opOp32 = 0x3b, opImm = 0x13, opImm32 = 0x1b;
+
+
+/// Reference operations (URV-wide).
+template <typename URV>
+struct Ref
+{
+  typedef typename std::make_signed<URV>::type SRV;
+  static constexpr unsigned xlen = 8*sizeof(URV);
+
+  static URV rotl(URV x, unsigned n)
+  { n %= xlen; return n ? URV(x << n) | URV(x >> (xlen - n)) : x; }
+
+  static URV rotr(URV x, unsigned n)
+  { n %= xlen; return n ? URV(x >> n) | URV(x << (xlen - n)) : x; }
+
+  static URV sext32(uint32_t x)
+  { return URV(SRV(int32_t(x))); }
+
+  static unsigned clz(URV x, unsigned width)
+  {
+    unsigned n = 0;
+    for (int i = int(width) - 1; i >= 0 and not ((x >> i) & 1); --i)
+      n++;
+    return n;
+  }
+
+  static unsigned ctz(URV x, unsigned width)
+  {
+    unsigned n = 0;
+    for (unsigned i = 0; i < width and not ((x >> i) & 1); ++i)
+      n++;
+    return n;
+  }
+
+  static unsigned cpop(URV x)
+  {
+    unsigned n = 0;
+    for ( ; x; x &= x - 1)
+      n++;
+    return n;
+  }
+
+  static URV orcb(URV x)
+  {
+    URV r = 0;
+    for (unsigned i = 0; i < xlen; i += 8)
+      if ((x >> i) & 0xff)
+	r |= URV(0xff) << i;
+    return r;
+  }
+
+  static URV rev8(URV x)
+  {
+    URV r = 0;
+    for (unsigned i = 0; i < xlen; i += 8)
+      r |= ((x >> i) & 0xff) << (xlen - 8 - i);
+    return r;
+  }
+};
+
+
+/// An instruction to check: name (mnemonic), code, true if rv64 only
+/// and reference result as a function of rs1 and rs2 values.
+template <typename URV>
+struct Case
+{
+  const char* name;
+  uint32_t code;
+  bool rv64Only;
+  std::function<URV(URV, URV)> ref;
+};
+
+
+/// Return the instructions to check for the xlen of URV. Immediate
+/// forms use a shift amount of 13 (7 for word forms).
+template <typename URV>
+static std::vector<Case<URV>>
+cases()
+{
+  typedef Ref<URV> R;
+  typedef typename R::SRV SRV;
+  const unsigned xlen = R::xlen;
+  const unsigned sh = 13;
+  bool rv64 = xlen == 64;
+  uint32_t rev8Imm = rv64 ? 0x6b8 : 0x698;
+
+  auto u32 = [](URV x) { return URV(uint32_t(x)); };
+
+  return {
+    // Zba
+    { "sh1add", rform(0x10, 2, opOp), false, [](URV a, URV b) { return (a << 1) + b; } },
+    { "sh2add", rform(0x10, 4, opOp), false, [](URV a, URV b) { return (a << 2) + b; } },
+    { "sh3add", rform(0x10, 6, opOp), false, [](URV a, URV b) { return (a << 3) + b; } },
+    { "add.uw", rform(0x04, 0, opOp32), true, [u32](URV a, URV b) { return u32(a) + b; } },
+    { "sh1add.uw", rform(0x10, 2, opOp32), true, [u32](URV a, URV b) { return (u32(a) << 1) + b; } },
+    { "sh2add.uw", rform(0x10, 4, opOp32), true, [u32](URV a, URV b) { return (u32(a) << 2) + b; } },
+    { "sh3add.uw", rform(0x10, 6, opOp32), true, [u32](URV a, URV b) { return (u32(a) << 3) + b; } },
+    { "slli.uw", iform(0x080 | sh, 1, opImm32), true, [u32](URV a, URV) { return u32(a) << sh; } },
+
+    // Zbb
+    { "andn", rform(0x20, 7, opOp), false, [](URV a, URV b) { return a & ~b; } },
+    { "orn",  rform(0x20, 6, opOp), false, [](URV a, URV b) { return a | ~b; } },
+    { "xnor", rform(0x20, 4, opOp), false, [](URV a, URV b) { return ~(a ^ b); } },
+    { "clz",  iform(0x600, 1, opImm), false, [](URV a, URV) { return URV(R::clz(a, xlen)); } },
+    { "ctz",  iform(0x601, 1, opImm), false, [](URV a, URV) { return URV(R::ctz(a, xlen)); } },
+    { "cpop", iform(0x602, 1, opImm), false, [](URV a, URV) { return URV(R::cpop(a)); } },
+    { "clzw", iform(0x600, 1, opImm32), true, [](URV a, URV) { return URV(R::clz(uint32_t(a), 32)); } },
+    { "ctzw", iform(0x601, 1, opImm32), true, [](URV a, URV) { return URV(R::ctz(uint32_t(a), 32)); } },
+    { "cpopw", iform(0x602, 1, opImm32), true, [](URV a, URV) { return URV(R::cpop(uint32_t(a))); } },
+    { "max",  rform(0x05, 6, opOp), false, [](URV a, URV b) { return SRV(a) > SRV(b) ? a : b; } },
+    { "maxu", rform(0x05, 7, opOp), false, [](URV a, URV b) { return a > b ? a : b; } },
+    { "min",  rform(0x05, 4, opOp), false, [](URV a, URV b) { return SRV(a) < SRV(b) ? a : b; } },
+    { "minu", rform(0x05, 5, opOp), false, [](URV a, URV b) { return a < b ? a : b; } },
+    { "sext.b", iform(0x604, 1, opImm), false, [](URV a, URV) { return URV(SRV(int8_t(a))); } },
+    { "sext.h", iform(0x605, 1, opImm), false, [](URV a, URV) { return URV(SRV(int16_t(a))); } },
+    { "zext.h", (0x04 << 25) | (1 << 15) | (4 << 12) | (3 << 7) | (rv64 ? opOp32 : opOp),
+      false, [](URV a, URV) { return URV(uint16_t(a)); } },
+    { "rol",  rform(0x30, 1, opOp), false, [](URV a, URV b) { return R::rotl(a, b % xlen); } },
+    { "ror",  rform(0x30, 5, opOp), false, [](URV a, URV b) { return R::rotr(a, b % xlen); } },
+    { "rori", iform(0x600 | sh, 5, opImm), false, [](URV a, URV) { return R::rotr(a, sh); } },
+    { "rolw", rform(0x30, 1, opOp32), true, [](URV a, URV b) {
+	return R::sext32(Ref<uint32_t>::rotl(uint32_t(a), b % 32)); } },
+    { "rorw", rform(0x30, 5, opOp32), true, [](URV a, URV b) {
+	return R::sext32(Ref<uint32_t>::rotr(uint32_t(a), b % 32)); } },
+    { "roriw", iform(0x600 | 7, 5, opImm32), true, [](URV a, URV) {
+	return R::sext32(Ref<uint32_t>::rotr(uint32_t(a), 7)); } },
+    { "orc.b", iform(0x287, 5, opImm), false, [](URV a, URV) { return R::orcb(a); } },
+    { "rev8", iform(rev8Imm, 5, opImm), false, [](URV a, URV) { return R::rev8(a); } },
+
+    // Zbs
+    { "bclr",  rform(0x24, 1, opOp), false, [](URV a, URV b) { return a & ~(URV(1) << (b % xlen)); } },
+    { "bclri", iform(0x480 | sh, 1, opImm), false, [](URV a, URV) { return a & ~(URV(1) << sh); } },
+    { "bext",  rform(0x24, 5, opOp), false, [](URV a, URV b) { return (a >> (b % xlen)) & 1; } },
+    { "bexti", iform(0x480 | sh, 5, opImm), false, [](URV a, URV) { return (a >> sh) & 1; } },
+    { "binv",  rform(0x34, 1, opOp), false, [](URV a, URV b) { return a ^ (URV(1) << (b % xlen)); } },
+    { "binvi", iform(0x680 | sh, 1, opImm), false, [](URV a, URV) { return a ^ (URV(1) << sh); } },
+    { "bset",  rform(0x14, 1, opOp), false, [](URV a, URV b) { return a | (URV(1) << (b % xlen)); } },
+    { "bseti", iform(0x280 | sh, 1, opImm), false, [](URV a, URV) { return a | (URV(1) << sh); } },
+  };
+}
+
+
+/// Execute each bit manipulation instruction on random and special
+/// operands and compare with the reference result.
+template <typename URV>
+static void
+checkSemantics()
+{
+  auto core = makeCore<URV>("imb");
+  bool rv64 = sizeof(URV) == 8;
+
+  std::vector<URV> values = { 0, 1, URV(-1), URV(1) << (8*sizeof(URV) - 1),
+			      0x80, 0x8000, 0x80000000, 0x7fffffff, 0xff00ff00,
+			      URV(0x0123456789abcdefULL), 31, 32, 63, 64 };
+  std::mt19937_64 random(99);
+  for (unsigned i = 0; i < 200; ++i)
+    values.push_back(URV(random()));
+
+  for (const auto& cs : cases<URV>())
+    {
+      uint32_t op0 = 0, op1 = 0;
+      int32_t op2 = 0;
+      const InstInfo& info = core->decode(cs.code, op0, op1, op2);
+
+      if (cs.rv64Only and not rv64)
+	{
+	  if (info.instId() != InstId::illegal)
+	    fail(__FILE__, __LINE__, std::string(cs.name) +
+		 " should be illegal in rv32");
+	  continue;
+	}
+
+      if (info.name() != cs.name)
+	fail(__FILE__, __LINE__, "code 0x" + toHex(cs.code) + " decodes as " +
+	     info.name() + " instead of " + cs.name);
+
+      std::string disas;
+      core->disassembleInst(cs.code, disas);
+      if (disas.compare(0, strlen(cs.name) + 1, std::string(cs.name) + " "))
+	fail(__FILE__, __LINE__, "disassembly of " + std::string(cs.name) +
+	     ": " + disas);
+
+      loadCode(*core, split32({ cs.code }));
+      unsigned reported = 0;
+      for (URV a : values)
+	for (URV b : { values.at(random() % values.size()), URV(random()) })
+	  {
+	    core->pokePc(codeAddr);
+	    core->pokeIntReg(1, a);
+	    core->pokeIntReg(2, b);
+	    step(*core, 1);
+	    URV expected = cs.ref(a, b);
+	    URV actual = intReg(*core, 3);
+	    if (actual != expected and reported++ < 3)
+	      fail(__FILE__, __LINE__, std::string(cs.name) + " rs1=0x" +
+		   toHex(a) + " rs2=0x" + toHex(b) + ": 0x" + toHex(actual) +
+		   " expected 0x" + toHex(expected));
+	  }
+    }
+}
+
+
+/// Check that the bit manipulation instructions are illegal when
+/// extension b is not enabled.
+template <typename URV>
+static void
+checkDisabled()
+{
+  auto core = makeCore<URV>("im");
+  for (const auto& cs : cases<URV>())
+    {
+      uint32_t op0 = 0, op1 = 0;
+      int32_t op2 = 0;
+      if (core->decode(cs.code, op0, op1, op2).instId() != InstId::illegal)
+	fail(__FILE__, __LINE__, std::string(cs.name) +
+	     " should be illegal without extension b");
+    }
+}
+
+
+int
+main()
+{
+  checkSemantics<uint32_t>();
+  checkSemantics<uint64_t>();
+  checkDisabled<uint32_t>();
+  checkDisabled<uint64_t>();
+
+  return report("BitManipTest");
+}
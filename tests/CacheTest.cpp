@@ -0,0 +1,254 @@
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2018 Western Digital Corporation or its affiliates.
+//
+// This program is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+
+// Check the cache model against a straightforward reference model
+// (one list of lines per set) on random accesses for LRU and FIFO
+// replacement with write-back and write-through policies. Check the
+// geometry validation and the behavior of random replacement.
+
+#include <deque>
+#include <random>
+#include "TestUtil.hpp"
+#include "CacheModel.hpp"
+
+
+using namespace WdRiscv;
+using namespace WdRiscvTest;
+
+
+/// Reference cache: The lines of each set in replacement order (most
+/// recently used or most recently inserted first).
+class RefCache
+{
+public:
+
+  RefCache(const CacheParams& params)
+    : params_(params),
+      sets_(params.size_ / params.lineSize_ / params.ways_)
+  { }
+
+  bool access(uint64_t addr, unsigned size, bool write)
+  {
+    bool hit = true;
+    for (uint64_t line = addr / params_.lineSize_;
+	 line <= (addr + size - 1) / params_.lineSize_; ++line)
+      hit = accessLine(line, write) and hit;
+    if (not hit)
+      misses++;
+    return hit;
+  }
+
+  uint64_t misses = 0;
+  uint64_t writebacks = 0;
+
+private:
+
+  struct Line { uint64_t line; bool dirty; };
+
+  bool accessLine(uint64_t line, bool write)
+  {
+    auto& set = sets_.at(line % sets_.size());
+    bool dirty = write and params_.writeBack_;
+
+    for (auto iter = set.begin(); iter != set.end(); ++iter)
+      if (iter->line == line)
+	{
+	  iter->dirty = iter->dirty or dirty;
+	  if (params_.replacement_ == CacheParams::Replacement::Lru)
+	    {
+	      Line hit = *iter;
+	      set.erase(iter);
+	      set.push_front(hit);
+	    }
+	  return true;
+	}
+
+    if (write and not params_.writeBack_)
+      return false;
+
+    if (set.size() == params_.ways_)
+      {
+	if (set.back().dirty)
+	  writebacks++;
+	set.pop_back();
+      }
+    set.push_front(Line{line, dirty});
+    return false;
+  }
+
+  CacheParams params_;
+  std::vector<std::deque<Line>> sets_;
+};
+
+
+/// Compare the model and the reference on random accesses to a region
+/// a few times larger than the cache.
+static void
+compareWithReference(CacheParams::Replacement replacement, bool writeBack,
+		     unsigned ways)
+{
+  CacheParams params;
+  params.size_ = 4096;
+  params.ways_ = ways;
+  params.lineSize_ = 32;
+  params.replacement_ = replacement;
+  params.writeBack_ = writeBack;
+
+  CacheModel cache;
+  CHECK(cache.configure(params));
+  RefCache ref(params);
+
+  std::mt19937_64 random(ways * 2 + writeBack);
+  unsigned reported = 0;
+
+  for (unsigned i = 0; i < 200000; ++i)
+    {
+      // Mostly small aligned accesses with some locality, some of
+      // them crossing a line boundary.
+      uint64_t addr = random() % (4 * params.size_);
+      if (random() % 4)
+	addr = (addr & ~uint64_t(1023)) | (random() % 64);
+      unsigned size = 1u << (random() % 4);
+      if (random() % 8)
+	addr &= ~uint64_t(size - 1);
+      bool write = random() % 3 == 0;
+
+      bool hit = cache.access(addr, size, write);
+      bool refHit = ref.access(addr, size, write);
+      if (hit != refHit and reported++ < 10)
+	fail(__FILE__, __LINE__, "access " + std::to_string(i) + " at 0x" +
+	     toHex(addr) + (hit ? " hits" : " misses") +
+	     ", reference disagrees");
+    }
+
+  CHECK_EQ(cache.accesses(), 200000);
+  CHECK_EQ(cache.misses(), ref.misses);
+  CHECK_EQ(cache.writebacks(), ref.writebacks);
+  CHECK_EQ(cache.readMisses() + cache.writeMisses(), cache.misses());
+  if (not writeBack)
+    CHECK_EQ(cache.writebacks(), 0);
+}
+
+
+/// Geometries that are not powers of 2 or not multiples of the set
+/// size are rejected leaving the cache as it was.
+static void
+checkConfigure()
+{
+  CacheModel cache;
+  CacheParams params;
+  CHECK(cache.configure(params));
+
+  CacheParams bad = params;
+  bad.lineSize_ = 48;
+  CHECK(not cache.configure(bad));
+
+  bad = params;
+  bad.ways_ = 0;
+  CHECK(not cache.configure(bad));
+
+  bad = params;
+  bad.size_ = 3*1024;     // 12 sets of 4 ways.
+  CHECK(not cache.configure(bad));
+
+  bad = params;
+  bad.size_ = 1000;       // Not a multiple of the set size.
+  CHECK(not cache.configure(bad));
+
+  CHECK_EQ(cache.params().size_, params.size_);
+  CHECK_EQ(cache.params().lineSize_, params.lineSize_);
+
+  // Non power of 2 associativity is fine if the set count is a power
+  // of 2.
+  CacheParams threeWays = params;
+  threeWays.size_ = 3*64*128;
+  threeWays.ways_ = 3;
+  CHECK(cache.configure(threeWays));
+
+  // Enabling an unconfigured cache has no effect.
+  CacheModel unconfigured;
+  unconfigured.enable(true);
+  CHECK(not unconfigured.enabled());
+}
+
+
+/// Under random replacement, lines filling one set all hit on a second
+/// pass and dirty lines are written back when the cache is
+/// invalidated.
+static void
+checkRandomReplacement()
+{
+  CacheParams params;
+  params.size_ = 4096;
+  params.ways_ = 4;
+  params.lineSize_ = 64;
+  params.replacement_ = CacheParams::Replacement::Random;
+
+  CacheModel cache;
+  CHECK(cache.configure(params));
+
+  // Lines mapping to set 0.
+  uint64_t setStride = params.size_ / params.ways_;
+  unsigned misses = 0;
+  for (unsigned pass = 0; pass < 2; ++pass)
+    for (unsigned way = 0; way < params.ways_; ++way)
+      misses += not cache.access(way * setStride, 8, true);
+
+  // Random victims may evict a line of the first pass, but the 4
+  // lines are resident after at most a few extra misses.
+  for (unsigned i = 0; i < 100; ++i)
+    for (unsigned way = 0; way < params.ways_; ++way)
+      misses += not cache.access(way * setStride, 8, false);
+  unsigned last = 0;
+  for (unsigned way = 0; way < params.ways_; ++way)
+    last += not cache.access(way * setStride, 8, false);
+  CHECK_EQ(last, 0);
+  CHECK(misses >= params.ways_);
+
+  // After an invalidation, a single dirty line is written back by
+  // the next one.
+  cache.invalidate();
+  CHECK(not cache.access(0, 8, false));
+  uint64_t before = cache.writebacks();
+  CHECK(not cache.access(setStride, 8, true));
+  cache.invalidate();
+  CHECK_EQ(cache.writebacks(), before + 1);
+
+  cache.reset();
+  CHECK_EQ(cache.accesses(), 0);
+  CHECK_EQ(cache.misses(), 0);
+  CHECK_EQ(cache.writebacks(), 0);
+}
+
+
+int
+main()
+{
+  for (bool writeBack : { true, false })
+    for (unsigned ways : { 1, 2, 4, 8 })
+      {
+	compareWithReference(CacheParams::Replacement::Lru, writeBack, ways);
+	compareWithReference(CacheParams::Replacement::Fifo, writeBack, ways);
+      }
+
+  checkConfigure();
+  checkRandomReplacement();
+
+  return report("CacheTest");
+}
@@ -0,0 +1,195 @@
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2018 Western Digital Corporation or its affiliates.
+//
+// This program is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+
+// Check the pre-decoded compressed instruction table: Every 16-bit
+// code must decode to the instruction (and operands) of its 32-bit
+// expansion and compressed loads/stores must execute like their
+// expansions (rv32 and rv64).
+
+#include <map>
+#include "TestUtil.hpp"
+
+
+using namespace WdRiscv;
+using namespace WdRiscvTest;
+
+
+/// Return the id of the 32-bit instruction equivalent to the given
+/// compressed instruction id.
+static InstId
+expandedId(InstId id, bool rv64)
+{
+  static const std::map<InstId, InstId> ids = {
+    { InstId::c_addi4spn, InstId::addi },  { InstId::c_fld, InstId::fld },
+    { InstId::c_lw, InstId::lw },          { InstId::c_flw, InstId::flw },
+    { InstId::c_ld, InstId::ld },          { InstId::c_fsd, InstId::fsd },
+    { InstId::c_sw, InstId::sw },          { InstId::c_fsw, InstId::fsw },
+    { InstId::c_sd, InstId::sd },          { InstId::c_addi, InstId::addi },
+    { InstId::c_li, InstId::addi },        { InstId::c_addi16sp, InstId::addi },
+    { InstId::c_lui, InstId::lui },        { InstId::c_srli, InstId::srli },
+    { InstId::c_srli64, InstId::srli },    { InstId::c_srai, InstId::srai },
+    { InstId::c_srai64, InstId::srai },    { InstId::c_andi, InstId::andi },
+    { InstId::c_sub, InstId::sub },        { InstId::c_xor, InstId::xor_ },
+    { InstId::c_or, InstId::or_ },         { InstId::c_and, InstId::and_ },
+    { InstId::c_subw, InstId::subw },      { InstId::c_addw, InstId::addw },
+    { InstId::c_j, InstId::jal },          { InstId::c_beqz, InstId::beq },
+    { InstId::c_bnez, InstId::bne },       { InstId::c_slli, InstId::slli },
+    { InstId::c_slli64, InstId::slli },    { InstId::c_fldsp, InstId::fld },
+    { InstId::c_lwsp, InstId::lw },        { InstId::c_flwsp, InstId::flw },
+    { InstId::c_ldsp, InstId::ld },        { InstId::c_jr, InstId::jalr },
+    { InstId::c_mv, InstId::add },         { InstId::c_ebreak, InstId::ebreak },
+    { InstId::c_jalr, InstId::jalr },      { InstId::c_add, InstId::add },
+    { InstId::c_fsdsp, InstId::fsd },      { InstId::c_swsp, InstId::sw },
+    { InstId::c_fswsp, InstId::fsw },      { InstId::c_sdsp, InstId::sd },
+  };
+
+  // Ids c.jal/c.addiw share a value.
+  if (id == InstId::c_jal)
+    return rv64 ? InstId::addiw : InstId::jal;
+
+  auto iter = ids.find(id);
+  return iter == ids.end() ? InstId::illegal : iter->second;
+}
+
+
+/// Check that each 16-bit code decodes to the instruction and operands
+/// of its expansion and that codes without an expansion are illegal.
+template <typename URV>
+static void
+checkAllCodes(const std::string& isa)
+{
+  auto core = makeCore<URV>(isa);
+  bool rv64 = sizeof(URV) == 8;
+
+  for (uint32_t code = 0; code < 0x10000; ++code)
+    {
+      if ((code & 3) == 3)
+	continue;   // Not a compressed code.
+
+      uint32_t op0 = 0, op1 = 0;
+      int32_t op2 = 0;
+      const InstInfo& info = core->decode(code, op0, op1, op2);
+      InstId id = info.instId();
+
+      uint32_t code32 = 0;
+      if (not core->expandInst(uint16_t(code), code32))
+	{
+	  if (id != InstId::illegal)
+	    fail(__FILE__, __LINE__, "code 0x" + toHex(code) + " (" + isa +
+		 ") has no expansion but is not illegal");
+	  continue;
+	}
+
+      uint32_t xop0 = 0, xop1 = 0;
+      int32_t xop2 = 0;
+      const InstInfo& xinfo = core->decode(code32, xop0, xop1, xop2);
+      InstId xid = xinfo.instId();
+
+      if (expandedId(id, rv64) != xid or op0 != xop0 or op1 != xop1 or
+	  op2 != xop2)
+	fail(__FILE__, __LINE__, "code 0x" + toHex(code) + " (" + isa +
+	     ") does not decode like its expansion 0x" + toHex(code32));
+
+      // Operand kinds (e.g. fp data of c.flw) and instruction type
+      // must also match: the timing model and profiles rely on them.
+      if (id == InstId::c_jal and rv64)
+	continue;   // Entry of c.jal used for c.addiw.
+      bool sameKinds = info.type() == xinfo.type();
+      for (unsigned i = 0; i < 3; ++i)
+	sameKinds = sameKinds and info.ithOperandType(i) == xinfo.ithOperandType(i);
+      if (not sameKinds)
+	fail(__FILE__, __LINE__, std::string(info.name()) + " (" + isa +
+	     ") operand or instruction types differ from those of " +
+	     xinfo.name());
+    }
+}
+
+
+/// Run the compressed loads/stores c.ldsp, c.sdsp, c.ld, c.sd, c.lwsp,
+/// c.swsp, c.fldsp and c.fsdsp on rv64 and check their results against
+/// the known values and against those of their 32-bit expansions.
+static void
+checkRv64LoadStore()
+{
+  const std::vector<uint16_t> code = {
+    0x60a2,   // c.ldsp  ra, 8(sp)
+    0xe806,   // c.sdsp  ra, 16(sp)
+    0x6504,   // c.ld    s1, 8(a0)
+    0xe904,   // c.sd    s1, 16(a0)
+    0x4612,   // c.lwsp  a2, 4(sp)
+    0xcc32,   // c.swsp  a2, 24(sp)
+    0x20a2,   // c.fldsp ft1, 8(sp)
+    0xb006,   // c.fsdsp ft1, 32(sp)
+  };
+
+  auto compressed = makeCore<uint64_t>("imafdc");
+  auto expanded = makeCore<uint64_t>("imafdc");
+
+  std::vector<uint32_t> code32;
+  for (uint16_t half : code)
+    {
+      uint32_t inst = 0;
+      CHECK(expanded->expandInst(half, inst));
+      code32.push_back(inst);
+    }
+
+  loadCode(*compressed, code);
+  loadCode(*expanded, split32(code32));
+
+  for (auto* core : { compressed.get(), expanded.get() })
+    {
+      core->pokeIntReg(2, dataAddr);           // sp
+      core->pokeIntReg(10, dataAddr + 0x100);  // a0
+      core->pokeMemory(dataAddr + 4, uint32_t(0x80000001));
+      core->pokeMemory(dataAddr + 8, uint64_t(0x1122334455667788));
+      core->pokeMemory(dataAddr + 0x108, uint64_t(0x99aabbccddeeff00));
+      step(*core, unsigned(code.size()));
+    }
+
+  for (auto* core : { compressed.get(), expanded.get() })
+    {
+      CHECK_EQ(intReg(*core, 1), 0x1122334455667788);
+      CHECK_EQ(memDouble(*core, dataAddr + 16), 0x1122334455667788);
+      CHECK_EQ(intReg(*core, 9), 0x99aabbccddeeff00);
+      CHECK_EQ(memDouble(*core, dataAddr + 0x110), 0x99aabbccddeeff00);
+      CHECK_EQ(intReg(*core, 12), 0xffffffff80000001);
+      CHECK_EQ(memDouble(*core, dataAddr + 24) & 0xffffffff, 0x80000001);
+      CHECK_EQ(fpReg(*core, 1), 0x1122334455667788);
+      CHECK_EQ(memDouble(*core, dataAddr + 32), 0x1122334455667788);
+    }
+  CHECK_EQ(compressed->peekPc(), codeAddr + 2*code.size());
+  CHECK_EQ(expanded->peekPc(), codeAddr + 4*code.size());
+
+  for (unsigned reg = 0; reg < 32; ++reg)
+    CHECK_EQ(intReg(*compressed, reg), intReg(*expanded, reg));
+}
+
+
+int
+main()
+{
+  checkAllCodes<uint32_t>("imc");
+  checkAllCodes<uint32_t>("imafdc");
+  checkAllCodes<uint64_t>("imc");
+  checkAllCodes<uint64_t>("imafdc");
+
+  checkRv64LoadStore();
+
+  return report("Decode16Test");
+}
@@ -0,0 +1,666 @@
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2018 Western Digital Corporation or its affiliates.
+//
+// This program is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+
+// Compare the 32-bit decoder (decode tree generated from the
+// InstInfoTable) against a reference decoder: the switch-based decoder
+// that preceded it with its known bugs fixed (each fix is marked
+// "Fixed:" below). All combinations of the opcode, funct3, funct7 and
+// rs2 fields are decoded with rd/rs1 both zero and with random rd/rs1
+// values, for rv32 and rv64 with and without the a, f and d
+// extensions. Decoded id and operands must agree.
+
+#include <random>
+#include "TestUtil.hpp"
+#include "instforms.hpp"
+
+
+using namespace WdRiscv;
+using namespace WdRiscvTest;
+
+
+/// Extensions enabled for the reference decoder.
+struct Extensions
+{
+  bool rv64 = false;
+  bool m = false;
+  bool a = false;
+  bool f = false;
+  bool d = false;
+};
+
+
+/// Reference decoding of the opcode 0x53 floating point instructions.
+static InstId
+referenceDecodeFp(const Extensions& ext, uint32_t inst, uint32_t& op0,
+		  uint32_t& op1, int32_t& op2)
+{
+  if (not ext.f)
+    return InstId::illegal;
+
+  RFormInst rform(inst);
+  op0 = rform.bits.rd, op1 = rform.bits.rs1, op2 = rform.bits.rs2;
+  unsigned f7 = rform.bits.funct7, f3 = rform.bits.funct3;
+  if (f7 & 1)
+    {
+      if (not ext.d)
+	return InstId::illegal;
+
+      if (f7 == 1)              return InstId::fadd_d;
+      if (f7 == 5)              return InstId::fsub_d;
+      if (f7 == 9)              return InstId::fmul_d;
+      if (f7 == 0xd)            return InstId::fdiv_d;
+      if (f7 == 0x11)
+	{
+	  if (f3 == 0)          return InstId::fsgnj_d;
+	  if (f3 == 1)          return InstId::fsgnjn_d;
+	  if (f3 == 2)          return InstId::fsgnjx_d;
+	}
+      if (f7 == 0x15)
+	{
+	  if (f3 == 0)          return InstId::fmin_d;
+	  if (f3 == 1)          return InstId::fmax_d;
+	}
+      if (f7==0x21 and op2==0)  return InstId::fcvt_d_s;
+      if (f7 == 0x2d and op2 == 0)  // Fixed: rs2 must be 0.
+	return InstId::fsqrt_d;
+      if (f7 == 0x51)
+	{
+	  if (f3 == 0)          return InstId::fle_d;
+	  if (f3 == 1)          return InstId::flt_d;
+	  if (f3 == 2)          return InstId::feq_d;
+	}
+      if (f7 == 0x61)
+	{
+	  if (op2 == 0)         return InstId::fcvt_w_d;
+	  if (op2 == 1)         return InstId::fcvt_wu_d;
+	  if (op2 == 2 and ext.rv64)  return InstId::fcvt_l_d;  // Fixed: rv64 only.
+	  if (op2 == 3 and ext.rv64)  return InstId::fcvt_lu_d;
+	}
+      if (f7 == 0x69)
+	{
+	  if (op2 == 0)         return InstId::fcvt_d_w;
+	  if (op2 == 1)         return InstId::fcvt_d_wu;
+	  if (op2 == 2 and ext.rv64)  return InstId::fcvt_d_l;  // Fixed: rv64 only.
+	  if (op2 == 3 and ext.rv64)  return InstId::fcvt_d_lu;
+	}
+      if (f7 == 0x71)
+	{
+	  // Fixed: fmv.x.d is rv64 only.
+	  if (op2==0 and f3==0 and ext.rv64) return InstId::fmv_x_d;
+	  if (op2==0 and f3==1) return InstId::fclass_d;
+	}
+      if (f7 == 0x79)
+	if (op2==0 and f3==0 and ext.rv64)   // Fixed: rv64 only.
+	  return InstId::fmv_d_x;
+
+      return InstId::illegal;
+    }
+
+  if (f7 == 0)      return InstId::fadd_s;
+  if (f7 == 4)      return InstId::fsub_s;
+  if (f7 == 8)      return InstId::fmul_s;
+  if (f7 == 0xc)    return InstId::fdiv_s;
+  if (f7 == 0x2c and op2 == 0)   // Fixed: rs2 must be 0.
+    return InstId::fsqrt_s;
+  if (f7 == 0x10)
+    {
+      if (f3 == 0)  return InstId::fsgnj_s;
+      if (f3 == 1)  return InstId::fsgnjn_s;
+      if (f3 == 2)  return InstId::fsgnjx_s;
+    }
+  if (f7 == 0x14)
+    {
+      if (f3 == 0)  return InstId::fmin_s;
+      if (f3 == 1)  return InstId::fmax_s;
+    }
+  if (f7 == 0x20 and op2 == 1 and ext.d)  // Fixed: fcvt.s.d was missing.
+    return InstId::fcvt_s_d;
+  if (f7 == 0x50)
+    {
+      if (f3 == 0)  return InstId::fle_s;
+      if (f3 == 1)  return InstId::flt_s;
+      if (f3 == 2)  return InstId::feq_s;
+      return InstId::illegal;
+    }
+  if (f7 == 0x60)
+    {
+      if (op2 == 0) return InstId::fcvt_w_s;
+      if (op2 == 1) return InstId::fcvt_wu_s;
+      if (op2 == 2 and ext.rv64) return InstId::fcvt_l_s;  // Fixed: rv64 only.
+      if (op2 == 3 and ext.rv64) return InstId::fcvt_lu_s;
+      return InstId::illegal;
+    }
+  if (f7 == 0x68)
+    {
+      if (op2 == 0) return InstId::fcvt_s_w;
+      if (op2 == 1) return InstId::fcvt_s_wu;
+      if (op2 == 2 and ext.rv64) return InstId::fcvt_s_l;  // Fixed: rv64 only.
+      if (op2 == 3 and ext.rv64) return InstId::fcvt_s_lu;
+      return InstId::illegal;
+    }
+  if (f7 == 0x70)
+    {
+      if (op2 == 0)
+	{
+	  if (f3 == 0) return InstId::fmv_x_w;
+	  if (f3 == 1) return InstId::fclass_s;
+	}
+    }
+  if (f7 == 0x78)   // Fixed: fmv.w.x is funct7 0x78 (was 0x74).
+    {
+      if (op2 == 0)
+	if (f3 == 0) return InstId::fmv_w_x;
+    }
+  return InstId::illegal;
+}
+
+
+/// Reference decoding of the fused multiply-add instructions (opcode
+/// 0x43, 0x47, 0x4b and 0x4f) with the given single and double
+/// precision ids.
+static InstId
+referenceDecodeFma(const Extensions& ext, uint32_t inst, uint32_t& op0,
+		   uint32_t& op1, int32_t& op2, InstId single, InstId dbl)
+{
+  if (not ext.f)   // Fixed: f extension was not checked.
+    return InstId::illegal;
+  RFormInst rform(inst);
+  op0 = rform.bits.rd, op1 = rform.bits.rs1, op2 = rform.bits.rs2;
+  unsigned funct7 = rform.bits.funct7;
+  if ((funct7 & 3) == 0)
+    return single;
+  if ((funct7 & 3) == 1 and ext.d)   // Fixed: double precision was missing.
+    return dbl;
+  return InstId::illegal;
+}
+
+
+/// Reference decoding of the atomic instructions (opcode 0x2f).
+static InstId
+referenceDecodeAmo(const Extensions& ext, uint32_t inst, uint32_t& op0,
+		   uint32_t& op1, int32_t& op2)
+{
+  // Fixed: Atomics were never decoded (code was disabled).
+  if (not ext.a)
+    return InstId::illegal;
+  RFormInst rf(inst);
+  uint32_t top5 = rf.top5(), f3 = rf.bits.funct3;
+  op0 = rf.bits.rd; op1 = rf.bits.rs1; op2 = rf.bits.rs2;
+
+  // Fixed: lr requires rs2 == 0.
+  if ((top5 == 2) and op2 != 0)
+    return InstId::illegal;
+
+  if (f3 == 2)
+    {
+      if (top5 == 0)    return InstId::amoadd_w;
+      if (top5 == 1)    return InstId::amoswap_w;
+      if (top5 == 2)    return InstId::lr_w;
+      if (top5 == 3)    return InstId::sc_w;
+      if (top5 == 4)    return InstId::amoxor_w;
+      if (top5 == 8)    return InstId::amoor_w;
+      if (top5 == 0x0c) return InstId::amoand_w;
+      if (top5 == 0x10) return InstId::amomin_w;
+      if (top5 == 0x14) return InstId::amomax_w;
+      if (top5 == 0x18) return InstId::amominu_w;
+      if (top5 == 0x1c) return InstId::amomaxu_w;
+    }
+  else if (f3 == 3)
+    {
+      if (not ext.rv64) return InstId::illegal;
+      if (top5 == 0)    return InstId::amoadd_d;
+      if (top5 == 1)    return InstId::amoswap_d;
+      if (top5 == 2)    return InstId::lr_d;
+      if (top5 == 3)    return InstId::sc_d;
+      if (top5 == 4)    return InstId::amoxor_d;
+      if (top5 == 8)    return InstId::amoor_d;
+      if (top5 == 0xc)  return InstId::amoand_d;
+      if (top5 == 0x10) return InstId::amomin_d;
+      if (top5 == 0x14) return InstId::amomax_d;
+      if (top5 == 0x18) return InstId::amominu_d;
+      if (top5 == 0x1c) return InstId::amomaxu_d;
+    }
+  return InstId::illegal;
+}
+
+
+/// Reference decoder: Return the id of the given 32-bit instruction
+/// and set op0, op1 and op2 to its operands.
+static InstId
+referenceDecode(const Extensions& ext, uint32_t inst, uint32_t& op0,
+		uint32_t& op1, int32_t& op2)
+{
+  op0 = 0; op1 = 0; op2 = 0;
+
+  if ((inst & 3) != 3)
+    return InstId::illegal;
+
+  unsigned opcode = (inst & 0x7f) >> 2;  // Upper 5 bits of opcode.
+
+  switch (opcode)
+    {
+    case 0:  // 00000   I-form loads
+      {
+	IFormInst iform(inst);
+	op0 = iform.fields.rd;
+	op1 = iform.fields.rs1;
+	op2 = iform.immed();
+	switch (iform.fields.funct3)
+	  {
+	  case 0:  return InstId::lb;
+	  case 1:  return InstId::lh;
+	  case 2:  return InstId::lw;
+	  case 3:  return ext.rv64 ? InstId::ld : InstId::illegal;  // Fixed: rv64 only.
+	  case 4:  return InstId::lbu;
+	  case 5:  return InstId::lhu;
+	  case 6:  return ext.rv64 ? InstId::lwu : InstId::illegal; // Fixed: rv64 only.
+	  default: return InstId::illegal;
+	  }
+      }
+
+    case 1:  // 00001   Fp loads
+      {
+	IFormInst iform(inst);
+	op0 = iform.fields.rd;
+	op1 = iform.fields.rs1;
+	op2 = iform.immed();
+	uint32_t f3 = iform.fields.funct3;
+	// Fixed: f/d extensions were not checked.
+	if      (f3 == 2 and ext.f)  return InstId::flw;
+	else if (f3 == 3 and ext.d)  return InstId::fld;
+      }
+      return InstId::illegal;
+
+    case 3: // 00011  I-form fences
+      {
+	IFormInst iform(inst);
+	unsigned funct3 = iform.fields.funct3;
+	if (iform.fields.rd == 0 and iform.fields.rs1 == 0)
+	  {
+	    if (funct3 == 0)
+	      {
+		if (iform.top4() == 0)
+		  {
+		    op0 = iform.pred();
+		    op1 = iform.succ();
+		    return InstId::fence;
+		  }
+	      }
+	    else if (funct3 == 1)
+	      {
+		if (iform.uimmed() == 0)
+		  return InstId::fencei;
+	      }
+	  }
+      }
+      return InstId::illegal;
+
+    case 4:  // 00100  I-form
+      {
+	IFormInst iform(inst);
+	op0 = iform.fields.rd;
+	op1 = iform.fields.rs1;
+	op2 = iform.immed();
+	unsigned funct3 = iform.fields.funct3;
+
+	if      (funct3 == 0)  return InstId::addi;
+	else if (funct3 == 1)
+	  {
+	    unsigned topBits = 0, shamt = 0;
+	    iform.getShiftFields(ext.rv64, topBits, shamt);
+	    if (topBits == 0)
+	      {
+		op2 = shamt;
+		return InstId::slli;
+	      }
+	  }
+	else if (funct3 == 2)  return InstId::slti;
+	else if (funct3 == 3)  return InstId::sltiu;
+	else if (funct3 == 4)  return InstId::xori;
+	else if (funct3 == 5)
+	  {
+	    unsigned topBits = 0, shamt = 0;
+	    iform.getShiftFields(ext.rv64, topBits, shamt);
+	    op2 = shamt;
+	    if (topBits == 0)
+	      return InstId::srli;
+	    if (ext.rv64)
+	      topBits <<= 1;
+	    if (topBits == 0x20)
+	      return InstId::srai;
+	  }
+	else if (funct3 == 6)  return InstId::ori;
+	else if (funct3 == 7)  return InstId::andi;
+      }
+      return InstId::illegal;
+
+    case 5:  // 00101   U-form
+      {
+	UFormInst uform(inst);
+	op0 = uform.bits.rd;
+	op1 = uform.immed();
+	return InstId::auipc;
+      }
+
+    case 6:  // 00110  I-form word ops
+      {
+	if (not ext.rv64)   // Fixed: rv64 only.
+	  return InstId::illegal;
+	IFormInst iform(inst);
+	op0 = iform.fields.rd;
+	op1 = iform.fields.rs1;
+	op2 = iform.immed();
+	unsigned funct3 = iform.fields.funct3;
+	if (funct3 == 0)
+	  return InstId::addiw;
+	else if (funct3 == 1)
+	  {
+	    if (iform.top7() == 0)
+	      {
+		op2 = iform.fields2.shamt;
+		return InstId::slliw;
+	      }
+	  }
+	else if (funct3 == 5)
+	  {
+	    op2 = iform.fields2.shamt;
+	    if (iform.top7() == 0)
+	      return InstId::srliw;
+	    else if (iform.top7() == 0x20)
+	      return InstId::sraiw;
+	  }
+      }
+      return InstId::illegal;
+
+    case 8:  // 01000  S-form
+      {
+	SFormInst sform(inst);
+	op0 = sform.bits.rs1;
+	op1 = sform.bits.rs2;
+	op2 = sform.immed();
+	uint32_t funct3 = sform.bits.funct3;
+
+	if (funct3 == 0) return InstId::sb;
+	if (funct3 == 1) return InstId::sh;
+	if (funct3 == 2) return InstId::sw;
+	if (funct3 == 3 and ext.rv64) return InstId::sd;
+      }
+      return InstId::illegal;
+
+    case 9:  // 01001  Fp stores
+      {
+	SFormInst sform(inst);
+	op0 = sform.bits.rs1;
+	op1 = sform.bits.rs2;
+	op2 = sform.immed();
+	unsigned funct3 = sform.bits.funct3;
+	// Fixed: f/d extensions were not checked.
+	if      (funct3 == 2 and ext.f)  return InstId::fsw;
+	else if (funct3 == 3 and ext.d)  return InstId::fsd;
+      }
+      return InstId::illegal;
+
+    case 11:  // 01011  R-form atomics
+      return referenceDecodeAmo(ext, inst, op0, op1, op2);
+
+    case 12:  // 01100  R-form
+      {
+	RFormInst rform(inst);
+	op0 = rform.bits.rd;
+	op1 = rform.bits.rs1;
+	op2 = rform.bits.rs2;
+	unsigned funct7 = rform.bits.funct7, funct3 = rform.bits.funct3;
+	if (funct7 == 0)
+	  {
+	    if      (funct3 == 0) return InstId::add;
+	    else if (funct3 == 1) return InstId::sll;
+	    else if (funct3 == 2) return InstId::slt;
+	    else if (funct3 == 3) return InstId::sltu;
+	    else if (funct3 == 4) return InstId::xor_;
+	    else if (funct3 == 5) return InstId::srl;
+	    else if (funct3 == 6) return InstId::or_;
+	    else if (funct3 == 7) return InstId::and_;
+	  }
+	else if (funct7 == 1)
+	  {
+	    if      (not ext.m)   return InstId::illegal;
+	    else if (funct3 == 0) return InstId::mul;
+	    else if (funct3 == 1) return InstId::mulh;
+	    else if (funct3 == 2) return InstId::mulhsu;
+	    else if (funct3 == 3) return InstId::mulhu;
+	    else if (funct3 == 4) return InstId::div;
+	    else if (funct3 == 5) return InstId::divu;
+	    else if (funct3 == 6) return InstId::rem;
+	    else if (funct3 == 7) return InstId::remu;
+	  }
+	else if (funct7 == 0x20)
+	  {
+	    if      (funct3 == 0) return InstId::sub;
+	    else if (funct3 == 5) return InstId::sra;
+	  }
+      }
+      return InstId::illegal;
+
+    case 13:  // 01101  U-form
+      {
+	UFormInst uform(inst);
+	op0 = uform.bits.rd;
+	op1 = uform.immed();
+	return InstId::lui;
+      }
+
+    case 14: // 01110  R-Form word ops
+      {
+	if (not ext.rv64)   // Fixed: rv64 only.
+	  return InstId::illegal;
+	const RFormInst rform(inst);
+	op0 = rform.bits.rd;
+	op1 = rform.bits.rs1;
+	op2 = rform.bits.rs2;
+	unsigned funct7 = rform.bits.funct7, funct3 = rform.bits.funct3;
+	if (funct7 == 0)
+	  {
+	    if      (funct3 == 0) return InstId::addw;
+	    else if (funct3 == 1) return InstId::sllw;
+	    else if (funct3 == 5) return InstId::srlw;
+	  }
+	else if (funct7 == 1 and ext.m)   // Fixed: m extension was not checked.
+	  {
+	    if      (funct3 == 0) return InstId::mulw;
+	    else if (funct3 == 4) return InstId::divw;
+	    else if (funct3 == 5) return InstId::divuw;
+	    else if (funct3 == 6) return InstId::remw;
+	    else if (funct3 == 7) return InstId::remuw;
+	  }
+	else if (funct7 == 0x20)
+	  {
+	    if      (funct3 == 0)  return InstId::subw;
+	    else if (funct3 == 5)  return InstId::sraw;
+	  }
+      }
+      return InstId::illegal;
+
+    case 16:
+      return referenceDecodeFma(ext, inst, op0, op1, op2, InstId::fmadd_s,
+				InstId::fmadd_d);
+    case 17:
+      return referenceDecodeFma(ext, inst, op0, op1, op2, InstId::fmsub_s,
+				InstId::fmsub_d);
+    case 18:
+      return referenceDecodeFma(ext, inst, op0, op1, op2, InstId::fnmsub_s,
+				InstId::fnmsub_d);
+    case 19:
+      return referenceDecodeFma(ext, inst, op0, op1, op2, InstId::fnmadd_s,
+				InstId::fnmadd_d);
+
+    case 20:
+      return referenceDecodeFp(ext, inst, op0, op1, op2);
+
+    case 24: // 11000   B-form
+      {
+	BFormInst bform(inst);
+	op0 = bform.bits.rs1;
+	op1 = bform.bits.rs2;
+	op2 = bform.immed();
+	uint32_t funct3 = bform.bits.funct3;
+	if      (funct3 == 0)  return InstId::beq;
+	else if (funct3 == 1)  return InstId::bne;
+	else if (funct3 == 4)  return InstId::blt;
+	else if (funct3 == 5)  return InstId::bge;
+	else if (funct3 == 6)  return InstId::bltu;
+	else if (funct3 == 7)  return InstId::bgeu;
+      }
+      return InstId::illegal;
+
+    case 25:  // 11001  I-form
+      {
+	IFormInst iform(inst);
+	op0 = iform.fields.rd;
+	op1 = iform.fields.rs1;
+	op2 = iform.immed();
+	if (iform.fields.funct3 == 0)
+	  return InstId::jalr;
+      }
+      return InstId::illegal;
+
+    case 27:  // 11011  J-form
+      {
+	JFormInst jform(inst);
+	op0 = jform.bits.rd;
+	op1 = jform.immed();
+	return InstId::jal;
+      }
+
+    case 28:  // 11100  I-form
+      {
+	IFormInst iform(inst);
+	op0 = iform.fields.rd;
+	op1 = iform.fields.rs1;
+	op2 = iform.uimmed(); // csr
+	switch (iform.fields.funct3)
+	  {
+	  case 0:
+	    {
+	      // Fixed: rd and rs1 must be 0 for all of ecall, ebreak,
+	      // uret, sret, mret and wfi.
+	      if (op1 != 0 or op0 != 0)
+		return InstId::illegal;
+	      if (op2 == 0)      return InstId::ecall;
+	      if (op2 == 1)      return InstId::ebreak;
+	      if (op2 == 2)      return InstId::uret;
+	      if (op2 == 0x102)  return InstId::sret;
+	      if (op2 == 0x302)  return InstId::mret;
+	      if (op2 == 0x105)  return InstId::wfi;
+	    }
+	    break;
+	  case 1:  return InstId::csrrw;
+	  case 2:  return InstId::csrrs;
+	  case 3:  return InstId::csrrc;
+	  case 5:  return InstId::csrrwi;
+	  case 6:  return InstId::csrrsi;
+	  case 7:  return InstId::csrrci;
+	  default: return InstId::illegal;
+	  }
+      }
+      return InstId::illegal;
+
+    default:
+      return InstId::illegal;
+    }
+}
+
+
+/// Decode all combinations of the opcode, funct3, funct7 and rs2
+/// fields (rd/rs1 zero and random) with the core of the given isa and
+/// with the reference decoder and check that they agree.
+template <typename URV>
+static void
+compareDecoders(const std::string& isa)
+{
+  auto core = makeCore<URV>(isa);
+
+  Extensions ext;
+  ext.rv64 = sizeof(URV) == 8;
+  ext.m = isa.find('m') != std::string::npos;
+  ext.a = isa.find('a') != std::string::npos;
+  ext.f = isa.find('f') != std::string::npos;
+  ext.d = isa.find('d') != std::string::npos;
+
+  std::mt19937 random(1234);
+  unsigned reported = 0;
+
+  // Bits 31:20 (funct7 and rs2), 14:12 (funct3) and 6:2 (opcode).
+  for (uint32_t fields = 0; fields < (1u << 20); ++fields)
+    {
+      uint32_t top = fields >> 8, funct3 = (fields >> 5) & 7;
+      uint32_t opcode = ((fields & 0x1f) << 2) | 3;
+      uint32_t base = (top << 20) | (funct3 << 12) | opcode;
+
+      for (unsigned sample = 0; sample < 2; ++sample)
+	{
+	  uint32_t rd = 0, rs1 = 0;
+	  if (sample)
+	    {
+	      rd = random() & 0x1f;
+	      rs1 = random() & 0x1f;
+	    }
+	  uint32_t inst = base | (rd << 7) | (rs1 << 15);
+
+	  uint32_t op0 = 0, op1 = 0, rop0 = 0, rop1 = 0;
+	  int32_t op2 = 0, rop2 = 0;
+	  const InstInfo& info = core->decode(inst, op0, op1, op2);
+	  InstId id = info.instId();
+	  InstId rid = referenceDecode(ext, inst, rop0, rop1, rop2);
+
+	  // Fields that are not operands of the instruction (e.g. the rs2
+	  // field of fcvt) are not compared.
+	  bool same = id == rid;
+	  if (info.ithOperandType(0) != OperandType::None)
+	    same = same and op0 == rop0;
+	  if (info.ithOperandType(1) != OperandType::None)
+	    same = same and op1 == rop1;
+	  if (info.ithOperandType(2) != OperandType::None)
+	    same = same and op2 == rop2;
+
+	  if (not same and reported++ < 20)
+	    fail(__FILE__, __LINE__, "code 0x" + toHex(inst) + " (rv" +
+		 std::to_string(8*sizeof(URV)) + isa + "): " +
+		 info.name() + " " +
+		 std::to_string(op0) + "," + std::to_string(op1) + "," +
+		 std::to_string(op2) + " vs reference " +
+		 std::to_string(unsigned(rid)) + " " + std::to_string(rop0) +
+		 "," + std::to_string(rop1) + "," + std::to_string(rop2));
+	  else if (not same)
+	    failures++;
+	}
+    }
+}
+
+
+int
+main()
+{
+  for (const char* isa : { "i", "im", "imc", "imafc", "imafdc" })
+    {
+      compareDecoders<uint32_t>(isa);
+      compareDecoders<uint64_t>(isa);
+    }
+
+  return report("Decode32Test");
+}
@@ -0,0 +1,261 @@
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2018 Western Digital Corporation or its affiliates.
+//
+// This program is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+
+// Check the binary memory access trace: Random records (large and
+// negative deltas, repeated pcs, several buffer hand-offs) must decode
+// back to what was recorded following the format documented in
+// MemoryTrace.hpp, and a short program run on a core must produce the
+// expected fetch, load and store records.
+
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <unistd.h>
+#include "TestUtil.hpp"
+
+
+using namespace WdRiscv;
+using namespace WdRiscvTest;
+
+
+/// A decoded trace record.
+struct Record
+{
+  MemoryTrace::Access type;
+  bool dccm;
+  unsigned size;
+  uint64_t pc;
+  uint64_t addr;
+
+  bool operator==(const Record& other) const
+  {
+    return type == other.type and dccm == other.dccm and
+      size == other.size and pc == other.pc and addr == other.addr;
+  }
+};
+
+
+/// Return a temporary file path.
+static std::string
+tempPath()
+{
+  char path[] = "/tmp/memTraceTestXXXXXX";
+  int fd = mkstemp(path);
+  if (fd >= 0)
+    close(fd);
+  return path;
+}
+
+
+/// Decode the trace file at the given path into records. Set xlen to
+/// the header value. Return false if the file is malformed.
+static bool
+decodeTrace(const std::string& path, unsigned& xlen,
+	    std::vector<Record>& records)
+{
+  std::ifstream stream(path, std::ios::binary);
+  std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(stream)),
+			     std::istreambuf_iterator<char>());
+
+  if (bytes.size() < 5 or std::string(bytes.begin(), bytes.begin() + 4) != "WMT1")
+    return false;
+  xlen = bytes.at(4);
+
+  size_t pos = 5;
+  bool ok = true;
+  auto getDelta = [&bytes, &pos, &ok] () -> uint64_t {
+    uint64_t zz = 0;
+    for (unsigned shift = 0; ; shift += 7)
+      {
+	if (pos >= bytes.size() or shift > 63)
+	  {
+	    ok = false;
+	    return 0;
+	  }
+	uint8_t byte = bytes[pos++];
+	zz |= uint64_t(byte & 0x7f) << shift;
+	if ((byte & 0x80) == 0)
+	  break;
+      }
+    return (zz >> 1) ^ -(zz & 1);
+  };
+
+  uint64_t prevPc = 0, prevFetch = 0, prevData = 0;
+  while (ok and pos < bytes.size())
+    {
+      uint8_t flags = bytes[pos++];
+      Record rec;
+      rec.type = MemoryTrace::Access(flags & 3);
+      rec.dccm = (flags >> 2) & 1;
+      rec.size = 1u << ((flags >> 3) & 7);
+
+      if (rec.type == MemoryTrace::Access::Fetch)
+	{
+	  rec.addr = prevFetch += getDelta();
+	  rec.pc = prevPc = rec.addr;
+	}
+      else
+	{
+	  if (not (flags & 0x40))
+	    prevPc += getDelta();
+	  rec.pc = prevPc;
+	  rec.addr = prevData += getDelta();
+	}
+      records.push_back(rec);
+    }
+  return ok;
+}
+
+
+/// Record random accesses large enough to fill several buffers and
+/// check that they decode back.
+static void
+checkRandomRecords()
+{
+  std::string path = tempPath();
+  MemoryTrace trace;
+  CHECK(trace.open(path, 64, true));
+  CHECK(trace.enabled() and trace.fetchesEnabled());
+
+  std::mt19937_64 random(49);
+  std::vector<Record> expected;
+  uint64_t pc = 0x80000000;
+
+  for (unsigned i = 0; i < 500000; ++i)
+    {
+      Record rec;
+      switch (random() % 8)
+	{
+	case 0:  pc = random();                     break;  // Far jump.
+	case 1:  pc -= 4 * (random() % 64);         break;  // Back edge.
+	case 2:                                     break;  // Same pc.
+	default: pc += (random() & 1) ? 2 : 4;      break;
+	}
+
+      unsigned kind = random() % 3;
+      rec.type = MemoryTrace::Access(kind);
+      rec.pc = pc;
+      if (rec.type == MemoryTrace::Access::Fetch)
+	{
+	  rec.addr = pc;
+	  rec.size = (random() & 1) ? 2 : 4;
+	  rec.dccm = false;
+	}
+      else
+	{
+	  uint64_t base = (random() & 1) ? 0x10000 : ~uint64_t(0) - 0xfff;
+	  rec.addr = (random() % 16 == 0) ? random() : base + random() % 4096;
+	  rec.size = 1u << (random() % 4);
+	  rec.dccm = random() & 1;
+	}
+      trace.record(rec.type, rec.pc, rec.addr, rec.size, rec.dccm);
+      expected.push_back(rec);
+    }
+
+  CHECK_EQ(trace.records(), expected.size());
+  CHECK(trace.bytes() > 2 * 1024 * 1024);   // Several hand-offs.
+  trace.close();
+  CHECK(not trace.enabled());
+
+  std::ifstream stream(path, std::ios::binary | std::ios::ate);
+  CHECK_EQ(uint64_t(stream.tellg()), trace.bytes());
+
+  unsigned xlen = 0;
+  std::vector<Record> records;
+  CHECK(decodeTrace(path, xlen, records));
+  unlink(path.c_str());
+
+  CHECK_EQ(xlen, 64);
+  CHECK_EQ(records.size(), expected.size());
+  unsigned reported = 0;
+  for (size_t i = 0; i < records.size() and i < expected.size(); ++i)
+    if (not (records[i] == expected[i]) and reported++ < 10)
+      fail(__FILE__, __LINE__, "record " + std::to_string(i) +
+	   " decodes to pc 0x" + toHex(records[i].pc) + " addr 0x" +
+	   toHex(records[i].addr) + ", expecting pc 0x" +
+	   toHex(expected[i].pc) + " addr 0x" + toHex(expected[i].addr));
+}
+
+
+/// Run a few loads and stores on an rv32 core and check the trace with
+/// and without fetch records.
+static void
+checkCoreTrace(bool fetches)
+{
+  typedef MemoryTrace::Access Access;
+
+  auto core = makeCore<uint32_t>("i");
+  loadCode(*core, split32({
+	0x000100b7,    // lui   x1, 0x10       x1 = dataAddr
+	0x00500113,    // addi  x2, x0, 5
+	0x0020a023,    // sw    x2, 0(x1)
+	0x0000a183,    // lw    x3, 0(x1)
+	0x00208423,    // sb    x2, 8(x1)
+	0xffe09203,    // lh    x4, -2(x1)
+      }));
+
+  std::string path = tempPath();
+  CHECK(core->enableMemoryTrace(path, fetches));
+  step(*core, 6);
+  core->closeMemoryTrace();
+  CHECK_EQ(intReg(*core, 3), 5);
+
+  std::vector<Record> expected;
+  for (unsigned i = 0; i < 6; ++i)
+    {
+      uint64_t pc = codeAddr + 4*i;
+      if (fetches)
+	expected.push_back({ Access::Fetch, false, 4, pc, pc });
+      if (i == 2)
+	expected.push_back({ Access::Store, false, 4, pc, dataAddr });
+      if (i == 3)
+	expected.push_back({ Access::Load, false, 4, pc, dataAddr });
+      if (i == 4)
+	expected.push_back({ Access::Store, false, 1, pc, dataAddr + 8 });
+      if (i == 5)
+	expected.push_back({ Access::Load, false, 2, pc, dataAddr - 2 });
+    }
+
+  unsigned xlen = 0;
+  std::vector<Record> records;
+  CHECK(decodeTrace(path, xlen, records));
+  unlink(path.c_str());
+
+  CHECK_EQ(xlen, 32);
+  CHECK_EQ(records.size(), expected.size());
+  for (size_t i = 0; i < records.size() and i < expected.size(); ++i)
+    if (not (records[i] == expected[i]))
+      fail(__FILE__, __LINE__, std::string(fetches ? "" : "no ") +
+	   "fetches: record " + std::to_string(i) + " pc 0x" +
+	   toHex(records[i].pc) + " addr 0x" + toHex(records[i].addr) +
+	   " size " + std::to_string(records[i].size) + ", expecting pc 0x" +
+	   toHex(expected[i].pc) + " addr 0x" + toHex(expected[i].addr) +
+	   " size " + std::to_string(expected[i].size));
+}
+
+
+int
+main()
+{
+  checkRandomRecords();
+  checkCoreTrace(true);
+  checkCoreTrace(false);
+
+  return report("MemoryTraceTest");
+}
@@ -0,0 +1,247 @@
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2018 Western Digital Corporation or its affiliates.
+//
+// This program is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+
+// Check the page profile: Heat map counts and first touch, coverage
+// summary, working set curve and sampling on accesses with known
+// results, and the profile of a short program run on a core.
+
+#include <array>
+#include <cstdlib>
+#include <sstream>
+#include "TestUtil.hpp"
+
+
+using namespace WdRiscv;
+using namespace WdRiscvTest;
+
+
+/// Parsed page profile report.
+struct Report
+{
+  struct Page { uint64_t addr, reads, writes, fetches, firstTouch; };
+  struct Sample { uint64_t end, pages, footprint; };
+
+  std::vector<Page> pages;
+  std::vector<uint64_t> dataCoverage;    // Bytes for 50/90/99/100%.
+  std::vector<uint64_t> fetchCoverage;
+  std::vector<Sample> workingSet;
+};
+
+
+/// Return the report text written by the given function.
+template <typename F>
+static std::string
+captureReport(F write)
+{
+  char* text = nullptr;
+  size_t size = 0;
+  FILE* file = open_memstream(&text, &size);
+  write(file);
+  fclose(file);
+  std::string result(text, size);
+  free(text);
+  return result;
+}
+
+
+/// Parse the given report text.
+static Report
+parseReport(const std::string& text)
+{
+  Report report;
+  std::istringstream stream(text);
+  std::string line;
+  enum { Heat, Coverage, Working } section = Heat;
+
+  while (std::getline(stream, line))
+    {
+      if (line.find("# Coverage") == 0)
+	section = Coverage;
+      else if (line.find("# Working set") == 0)
+	section = Working;
+      if (line.empty() or line[0] == '#')
+	continue;
+
+      std::istringstream fields(line);
+      if (section == Heat)
+	{
+	  Report::Page page;
+	  fields >> std::hex >> page.addr >> std::dec >> page.reads
+		 >> page.writes >> page.fetches >> page.firstTouch;
+	  report.pages.push_back(page);
+	}
+      else if (section == Coverage)
+	{
+	  std::string tag;
+	  fields >> tag;
+	  auto& cov = tag == "data" ? report.dataCoverage : report.fetchCoverage;
+	  uint64_t bytes = 0;
+	  while (fields >> bytes)
+	    cov.push_back(bytes);
+	}
+      else
+	{
+	  Report::Sample sample;
+	  fields >> sample.end >> sample.pages >> sample.footprint;
+	  report.workingSet.push_back(sample);
+	}
+    }
+  return report;
+}
+
+
+/// Accesses at known instruction counts: Counts, first touch, coverage
+/// and working set per 100 instructions.
+static void
+checkProfile()
+{
+  PageProfile profile;
+  CHECK(not profile.enabled());
+  profile.start(12, 1, 100);
+  CHECK(profile.enabled() and profile.started());
+
+  for (unsigned i = 0; i < 90; ++i)
+    profile.access(PageProfile::Access::Read, 0x10, 5);
+  for (unsigned i = 0; i < 9; ++i)
+    profile.access(PageProfile::Access::Write, 0x1ff8, 10);
+  profile.access(PageProfile::Access::Fetch, 0x0, 150);
+  profile.access(PageProfile::Access::Read, 0x2000, 420);
+
+  Report report = parseReport(captureReport([&profile] (FILE* file) {
+	profile.report(file, 450); }));
+
+  CHECK_EQ(report.pages.size(), 3);
+  if (report.pages.size() == 3)
+    {
+      const auto& p0 = report.pages[0];
+      const auto& p1 = report.pages[1];
+      const auto& p2 = report.pages[2];
+      CHECK_EQ(p0.addr, 0);
+      CHECK_EQ(p0.reads, 90);
+      CHECK_EQ(p0.writes, 0);
+      CHECK_EQ(p0.fetches, 1);
+      CHECK_EQ(p0.firstTouch, 5);
+      CHECK_EQ(p1.addr, 0x1000);
+      CHECK_EQ(p1.writes, 9);
+      CHECK_EQ(p1.firstTouch, 10);
+      CHECK_EQ(p2.addr, 0x2000);
+      CHECK_EQ(p2.reads, 1);
+      CHECK_EQ(p2.firstTouch, 420);
+    }
+
+  // Data accesses 90/9/1: one page covers 50% and 90%, two cover 99%.
+  CHECK(report.dataCoverage == std::vector<uint64_t>({ 4096, 4096, 8192, 12288 }));
+  CHECK(report.fetchCoverage == std::vector<uint64_t>({ 4096, 4096, 4096, 4096 }));
+
+  // Intervals ending at 100 (pages 0, 1), 200 (page 0), 300 and 400
+  // (none) then the partial interval ending at 450 (page 2).
+  const std::vector<std::array<uint64_t, 3>> expected = {
+    { 100, 2, 2 }, { 200, 1, 2 }, { 300, 0, 2 }, { 400, 0, 2 }, { 450, 1, 3 } };
+  CHECK_EQ(report.workingSet.size(), expected.size());
+  for (size_t i = 0; i < report.workingSet.size() and i < expected.size(); ++i)
+    {
+      CHECK_EQ(report.workingSet[i].end, expected[i][0]);
+      CHECK_EQ(report.workingSet[i].pages, expected[i][1]);
+      CHECK_EQ(report.workingSet[i].footprint, expected[i][2]);
+    }
+}
+
+
+/// With a sample period of n, every nth access is counted n times.
+static void
+checkSampling()
+{
+  PageProfile profile;
+  profile.start(12, 4, 1000);
+  for (unsigned i = 0; i < 100; ++i)
+    profile.access(PageProfile::Access::Read, 0x3000, i);
+  for (unsigned i = 0; i < 3; ++i)
+    profile.access(PageProfile::Access::Write, 0x5000, 100);
+
+  Report report = parseReport(captureReport([&profile] (FILE* file) {
+	profile.report(file, 200); }));
+
+  CHECK_EQ(report.pages.size(), 1);   // Writes to 0x5000 not sampled.
+  if (report.pages.size() == 1)
+    {
+      CHECK_EQ(report.pages[0].addr, 0x3000);
+      CHECK_EQ(report.pages[0].reads, 100);
+      CHECK_EQ(report.pages[0].firstTouch, 3);
+    }
+
+  // Suspended profile records nothing.
+  profile.enable(false);
+  CHECK(not profile.enabled());
+  profile.enable(true);
+  CHECK(profile.enabled());
+}
+
+
+/// Profile a short program: its code page is fetched and its data
+/// page read and written.
+static void
+checkCoreProfile()
+{
+  auto core = makeCore<uint32_t>("i");
+  loadCode(*core, split32({
+	0x000100b7,    // lui   x1, 0x10       x1 = dataAddr
+	0x00500113,    // addi  x2, x0, 5
+	0x0020a023,    // sw    x2, 0(x1)
+	0x0000a183,    // lw    x3, 0(x1)
+	0x0020a223,    // sw    x2, 4(x1)
+	0x00000013,    // nop
+      }));
+
+  core->enablePageProfile(1, 3);
+  step(*core, 6);
+
+  Report report = parseReport(captureReport([&core] (FILE* file) {
+	core->reportPageProfile(file); }));
+
+  CHECK_EQ(report.pages.size(), 2);
+  if (report.pages.size() == 2)
+    {
+      const auto& code = report.pages[0];
+      const auto& data = report.pages[1];
+      CHECK_EQ(code.addr, codeAddr);
+      CHECK_EQ(code.fetches, 6);
+      CHECK_EQ(code.reads + code.writes, 0);
+      CHECK_EQ(code.firstTouch, 0);
+      CHECK_EQ(data.addr, dataAddr);
+      CHECK_EQ(data.reads, 1);
+      CHECK_EQ(data.writes, 2);
+      CHECK_EQ(data.firstTouch, 2);
+    }
+
+  // Intervals of 3 instructions: both pages in each.
+  CHECK_EQ(report.workingSet.size(), 2);
+  for (const auto& sample : report.workingSet)
+    CHECK_EQ(sample.pages, 2);
+}
+
+
+int
+main()
+{
+  checkProfile();
+  checkSampling();
+  checkCoreProfile();
+
+  return report("PageProfileTest");
+}
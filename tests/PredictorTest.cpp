@@ -0,0 +1,292 @@
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2018 Western Digital Corporation or its affiliates.
+//
+// This program is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+
+// Check the branch predictor models on branch streams with known
+// misprediction counts (loops, alternating branches, calls/returns
+// and indirect jumps), the per-site statistics and report, and the
+// rejection of bad branch_predictor config file entries.
+
+#include <cstdlib>
+#include <fstream>
+#include <unistd.h>
+#include "TestUtil.hpp"
+#include "BranchPredictor.hpp"
+#include "CoreConfig.hpp"
+
+
+using namespace WdRiscv;
+using namespace WdRiscvTest;
+
+typedef BranchPredictor<uint32_t> Predictor;
+typedef Predictor::Kind Kind;
+
+
+/// Return a predictor of the given type with default sizes.
+static Predictor
+makePredictor(PredictorParams::Type type)
+{
+  PredictorParams params;
+  params.type_ = type;
+  Predictor predictor;
+  predictor.setParams(params);
+  return predictor;
+}
+
+
+/// Retire a 4-byte conditional branch at pc with the given target.
+/// Return true if mispredicted.
+static bool
+branch(Predictor& predictor, uint32_t pc, uint32_t target, bool taken)
+{
+  return predictor.retire(pc, taken ? target : pc + 4, target, 4,
+			  Kind::Conditional, 0, 0);
+}
+
+
+/// Run a 10-iteration loop (backward branch taken 9 times then not
+/// taken) the given number of times and return the mispredictions.
+static uint64_t
+runLoop(Predictor& predictor, unsigned times)
+{
+  uint64_t before = predictor.mispredicts();
+  for (unsigned i = 0; i < times; ++i)
+    for (unsigned j = 0; j < 10; ++j)
+      branch(predictor, 0x1020, 0x1000, j != 9);
+  return predictor.mispredicts() - before;
+}
+
+
+/// Loop branches: Static mispredicts each exit. Bimodal also
+/// mispredicts the first taken branch (weakly not-taken counters) but
+/// not the re-entry (the exit only weakens the counter).
+static void
+checkLoops()
+{
+  Predictor stat = makePredictor(PredictorParams::Type::Static);
+  CHECK_EQ(runLoop(stat, 5), 5);
+
+  // Forward branch never taken: always correct for static.
+  for (unsigned i = 0; i < 10; ++i)
+    CHECK(not branch(stat, 0x2000, 0x2040, false));
+
+  Predictor bimodal = makePredictor(PredictorParams::Type::Bimodal);
+  CHECK_EQ(runLoop(bimodal, 1), 2);
+  CHECK_EQ(runLoop(bimodal, 4), 4);
+
+  CHECK_EQ(bimodal.branches(), 50);
+  CHECK_EQ(bimodal.mispredicts(), 6);
+}
+
+
+/// An alternating branch defeats bimodal counters but gshare learns
+/// it from the global history.
+static void
+checkAlternating()
+{
+  Predictor bimodal = makePredictor(PredictorParams::Type::Bimodal);
+  Predictor gshare = makePredictor(PredictorParams::Type::Gshare);
+
+  uint64_t bimodalLate = 0, gshareLate = 0;
+  for (unsigned i = 0; i < 1000; ++i)
+    {
+      bool taken = i & 1;
+      bool bm = branch(bimodal, 0x3000, 0x2f00, taken);
+      bool gm = branch(gshare, 0x3000, 0x2f00, taken);
+      if (i >= 900)
+	{
+	  bimodalLate += bm;
+	  gshareLate += gm;
+	}
+    }
+  CHECK(bimodalLate >= 50);
+  CHECK_EQ(gshareLate, 0);
+}
+
+
+/// Calls push the return address, returns pop it. Returns deeper than
+/// the stack and jalr other than returns are mispredicted.
+static void
+checkReturnStack()
+{
+  Predictor predictor = makePredictor(PredictorParams::Type::Gshare);
+  const unsigned rasSize = predictor.params().rasSize_;
+
+  // Call depth rasSize + 1 from pc 0x100, 0x200, ... Each function is
+  // at 0x10000 * depth.
+  unsigned depth = rasSize + 1;
+  for (unsigned i = 1; i <= depth; ++i)
+    CHECK(not predictor.retire(0x100 * i, 0x10000 * i, 0, 4, Kind::Jal, 1, 0));
+
+  unsigned mispredicts = 0;
+  for (unsigned i = depth; i >= 1; --i)
+    mispredicts += predictor.retire(0x10000 * i + 0x40, 0x100 * i + 4, 0, 4,
+				    Kind::Jalr, 0, 1);
+  CHECK_EQ(mispredicts, 1);   // Outermost return lost.
+
+  // Indirect jump (jalr x0, 0(x10)): not predicted.
+  CHECK(predictor.retire(0x500, 0x9000, 0, 4, Kind::Jalr, 0, 10));
+
+  // Without a return stack, returns are mispredicted.
+  PredictorParams params = predictor.params();
+  params.rasSize_ = 0;
+  predictor.setParams(params);
+  CHECK(not predictor.retire(0x100, 0x10000, 0, 4, Kind::Jal, 1, 0));
+  CHECK(predictor.retire(0x10040, 0x104, 0, 4, Kind::Jalr, 0, 1));
+}
+
+
+/// The target buffer predicts taken transfers it has seen, at the
+/// target it recorded.
+static void
+checkBtb()
+{
+  Predictor predictor = makePredictor(PredictorParams::Type::Btb);
+
+  // Jal: miss then hit.
+  CHECK(predictor.retire(0x400, 0x800, 0, 4, Kind::Jal, 0, 0));
+  CHECK(not predictor.retire(0x400, 0x800, 0, 4, Kind::Jal, 0, 0));
+
+  // Indirect jump: predicted at its last target.
+  CHECK(predictor.retire(0x420, 0x900, 0, 2, Kind::Jalr, 0, 10));
+  CHECK(not predictor.retire(0x420, 0x900, 0, 2, Kind::Jalr, 0, 10));
+  CHECK(predictor.retire(0x420, 0xa00, 0, 2, Kind::Jalr, 0, 10));
+  CHECK(not predictor.retire(0x420, 0xa00, 0, 2, Kind::Jalr, 0, 10));
+
+  // Not taken branch without an entry: correctly falls through.
+  CHECK(not branch(predictor, 0x440, 0x400, false));
+
+  // Entries are direct mapped: a branch 2*btbEntries bytes away
+  // evicts the jal entry.
+  uint32_t alias = 0x400 + 2 * predictor.params().btbEntries_;
+  CHECK(predictor.retire(alias, 0x1800, 0, 4, Kind::Jal, 0, 0));
+  CHECK(predictor.retire(0x400, 0x800, 0, 4, Kind::Jal, 0, 0));
+}
+
+
+/// Table sizes are rounded down to a power of 2 by the model.
+static void
+checkParams()
+{
+  PredictorParams params;
+  params.bhtEntries_ = 300;
+  params.btbEntries_ = 0;
+  params.historyBits_ = 40;
+  Predictor predictor;
+  predictor.setParams(params);
+  CHECK_EQ(predictor.params().bhtEntries_, 256);
+  CHECK_EQ(predictor.params().btbEntries_, 1);
+  CHECK_EQ(predictor.params().historyBits_, 31);
+}
+
+
+/// Per-site counts and report order (most mispredicted first).
+static void
+checkSites()
+{
+  Predictor predictor = makePredictor(PredictorParams::Type::Static);
+  for (unsigned i = 0; i < 10; ++i)
+    {
+      branch(predictor, 0x100, 0x200, i < 3);   // Forward: 3 mispredicts.
+      branch(predictor, 0x300, 0x280, true);    // Backward taken: none.
+      branch(predictor, 0x400, 0x380, i % 2);   // Backward: 5.
+    }
+
+  const auto& sites = predictor.sites();
+  CHECK_EQ(sites.size(), 3);
+  CHECK_EQ(sites.at(0x100).executed_, 10);
+  CHECK_EQ(sites.at(0x100).taken_, 3);
+  CHECK_EQ(sites.at(0x100).mispredicts_, 3);
+  CHECK_EQ(sites.at(0x300).mispredicts_, 0);
+  CHECK_EQ(sites.at(0x400).mispredicts_, 5);
+  CHECK_EQ(predictor.mispredicts(), 8);
+
+  char* text = nullptr;
+  size_t size = 0;
+  FILE* file = open_memstream(&text, &size);
+  predictor.report(file, [] (uint32_t) { return std::string("f"); });
+  fclose(file);
+
+  std::string report(text, size);
+  free(text);
+  size_t p400 = report.find("0x400"), p100 = report.find("0x100");
+  size_t p300 = report.find("0x300");
+  CHECK(report.find("# Branches: 30  mispredicts: 8") == 0);
+  CHECK(p400 != std::string::npos and p400 < p100 and p100 < p300);
+}
+
+
+/// Write the given text to a temporary config file, apply it to a
+/// fresh core and return the result of applyConfig.
+static bool
+applyConfigText(Core<uint32_t>& core, const std::string& text)
+{
+  char path[] = "/tmp/predictorTestXXXXXX";
+  int fd = mkstemp(path);
+  if (fd < 0)
+    return false;
+  close(fd);
+  std::ofstream(path) << text;
+
+  CoreConfig config;
+  bool ok = config.loadConfigFile(path) and config.applyConfig(core, false);
+  unlink(path);
+  return ok;
+}
+
+
+/// Bad table sizes and types in the config file are rejected before
+/// the predictor is configured or enabled.
+static void
+checkConfig()
+{
+  for (const char* bad : {
+      R"({ "branch_predictor" : { "type" : "gshare", "bht_entries" : 300 } })",
+      R"({ "branch_predictor" : { "type" : "gshare", "btb_entries" : 0 } })",
+      R"({ "branch_predictor" : { "type" : "tage" } })" })
+    {
+      auto core = makeCore<uint32_t>("imc");
+      CHECK(not applyConfigText(*core, bad));
+      CHECK(not core->branchPredictor().enabled());
+      CHECK(core->branchPredictor().params().type_ == PredictorParams::Type::Static);
+      CHECK_EQ(core->branchPredictor().params().bhtEntries_, 256);
+    }
+
+  auto core = makeCore<uint32_t>("imc");
+  CHECK(applyConfigText(*core, R"({ "branch_predictor" :
+      { "type" : "gshare", "bht_entries" : 1024, "btb_entries" : 64 } })"));
+  CHECK(core->branchPredictor().enabled());
+  CHECK(core->branchPredictor().params().type_ == PredictorParams::Type::Gshare);
+  CHECK_EQ(core->branchPredictor().params().bhtEntries_, 1024);
+  CHECK_EQ(core->branchPredictor().params().btbEntries_, 64);
+}
+
+
+int
+main()
+{
+  checkLoops();
+  checkAlternating();
+  checkReturnStack();
+  checkBtb();
+  checkParams();
+  checkSites();
+  checkConfig();
+
+  return report("PredictorTest");
+}
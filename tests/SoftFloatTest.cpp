@@ -0,0 +1,322 @@
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2018 Western Digital Corporation or its affiliates.
+//
+// This program is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+
+// Compare the SoftFloat operations against the host floating point
+// unit: Result bits and exception flags of add, sub, mul, div, sqrt
+// and fma on random and special operands must match those of the host
+// in the 4 rounding modes the host supports (host NaN results are
+// compared as the RISCV canonical NaN). Round to nearest, ties to max
+// magnitude, which the host lacks, is checked on known cases.
+
+#include <cfenv>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include "TestUtil.hpp"
+#include "SoftFloat.hpp"
+
+
+using namespace WdRiscv;
+using namespace WdRiscvTest;
+
+
+/// Bit pattern type of a host floating point type.
+template <typename FT> struct BitsOf;
+template <> struct BitsOf<float>  { typedef uint32_t type; };
+template <> struct BitsOf<double> { typedef uint64_t type; };
+
+
+template <typename FT, typename UT = typename BitsOf<FT>::type>
+static UT
+toBits(FT x)
+{
+  UT u;
+  memcpy(&u, &x, sizeof(u));
+  return u;
+}
+
+
+template <typename FT, typename UT = typename BitsOf<FT>::type>
+static FT
+fromBits(UT u)
+{
+  FT x;
+  memcpy(&x, &u, sizeof(x));
+  return x;
+}
+
+
+/// Return the FpFlags bits of the host exception flags.
+static unsigned
+hostFlags()
+{
+  int flags = fetestexcept(FE_ALL_EXCEPT);
+  unsigned val = 0;
+  if (flags & FE_INEXACT)    val |= unsigned(FpFlags::Inexact);
+  if (flags & FE_UNDERFLOW)  val |= unsigned(FpFlags::Underflow);
+  if (flags & FE_OVERFLOW)   val |= unsigned(FpFlags::Overflow);
+  if (flags & FE_DIVBYZERO)  val |= unsigned(FpFlags::DivByZero);
+  if (flags & FE_INVALID)    val |= unsigned(FpFlags::Invalid);
+  return val;
+}
+
+
+enum class Op { Add, Sub, Mul, Div, Sqrt, Fma };
+
+static const char* opNames[] = { "add", "sub", "mul", "div", "sqrt", "fma" };
+
+
+/// Return the result of the given operation computed by the host in
+/// the given host rounding mode and set flags to the raised
+/// exceptions. Operands are volatile to keep the compiler from folding
+/// or moving the operation across the rounding mode/flag accesses.
+template <typename FT>
+__attribute__((noinline)) static FT
+hostOp(Op op, FT a, FT b, FT c, int mode, unsigned& flags)
+{
+  volatile FT va = a, vb = b, vc = c;
+  volatile FT result = 0;
+
+  int prev = fegetround();
+  fesetround(mode);
+  feclearexcept(FE_ALL_EXCEPT);
+
+  switch (op)
+    {
+    case Op::Add:  result = va + vb;                    break;
+    case Op::Sub:  result = va - vb;                    break;
+    case Op::Mul:  result = va * vb;                    break;
+    case Op::Div:  result = va / vb;                    break;
+    case Op::Sqrt: result = std::sqrt(FT(va));          break;
+    case Op::Fma:  result = std::fma(FT(va), FT(vb), FT(vc)); break;
+    }
+
+  flags = hostFlags();
+  fesetround(prev);
+  return result;
+}
+
+
+/// Return the result of the given operation computed by SoftFloat.
+template <typename UT>
+static UT
+softOp(Op op, UT a, UT b, UT c, RoundingMode mode, unsigned& flags)
+{
+  flags = 0;
+  switch (op)
+    {
+    case Op::Add:  return SoftFloat::add(a, b, mode, flags);
+    case Op::Sub:  return SoftFloat::sub(a, b, mode, flags);
+    case Op::Mul:  return SoftFloat::mul(a, b, mode, flags);
+    case Op::Div:  return SoftFloat::div(a, b, mode, flags);
+    case Op::Sqrt: return SoftFloat::sqrt(a, mode, flags);
+    case Op::Fma:  return SoftFloat::fma(a, b, c, mode, flags);
+    }
+  return 0;
+}
+
+
+/// Random operand generator biased towards the interesting cases:
+/// zeros, infinities, NaNs, subnormals, extreme exponents and operands
+/// with close exponents (cancellation).
+template <typename UT>
+class OperandGen
+{
+public:
+
+  static constexpr unsigned bits = 8*sizeof(UT);
+  static constexpr unsigned mantBits = bits == 32 ? 23 : 52;
+  static constexpr unsigned expBits = bits - 1 - mantBits;
+  static constexpr UT expMax = (UT(1) << expBits) - 1;
+  static constexpr UT signBit = UT(1) << (bits - 1);
+  static constexpr UT mantMask = (UT(1) << mantBits) - 1;
+
+  OperandGen(unsigned seed)
+    : random_(seed)
+  { }
+
+  /// Return a number with the given exponent field, random sign and
+  /// random significand.
+  UT make(UT exp)
+  {
+    UT sign = (random_() & 1) ? signBit : 0;
+    return sign | (exp << mantBits) | (UT(random_()) & mantMask);
+  }
+
+  /// Return a random operand with an exponent near that of the given
+  /// reference operand.
+  UT near(UT ref)
+  {
+    int exp = int((ref >> mantBits) & expMax) + int(random_() % 5) - 2;
+    exp = std::max(0, std::min(exp, int(expMax) - 1));
+    return make(UT(exp));
+  }
+
+  /// Return a random operand.
+  UT next()
+  {
+    switch (random_() % 10)
+      {
+      case 0:  // Special value.
+	{
+	  static const UT specials[] = {
+	    0, expMax << mantBits,                          // 0, inf
+	    (expMax << mantBits) | (UT(1) << (mantBits - 1)),  // qNaN
+	    (expMax << mantBits) | 1,                       // sNaN
+	    UT(1) << mantBits,                              // Min normal
+	    ((expMax - 1) << mantBits) | mantMask,          // Max finite
+	    1, mantMask,                                    // Subnormals
+	    (expMax >> 1) << mantBits,                      // 1.0
+	  };
+	  UT sign = (random_() & 1) ? signBit : 0;
+	  return sign | specials[random_() % (sizeof(specials)/sizeof(UT))];
+	}
+      case 1:  // Subnormal.
+	return make(0);
+      case 2:  // Tiny normal.
+	return make(1 + random_() % mantBits);
+      case 3:  // Huge.
+	return make(expMax - 1 - random_() % 4);
+      default:  // Moderate exponent.
+	return make(UT((expMax >> 1) - mantBits + random_() % (2*mantBits)));
+      }
+  }
+
+  /// Return a random integer in [0, limit).
+  unsigned pick(unsigned limit)
+  { return random_() % limit; }
+
+private:
+
+  std::mt19937_64 random_;
+};
+
+
+/// Compare SoftFloat and host on the given count of random operand
+/// triples for every operation and every host rounding mode.
+template <typename FT>
+static void
+compareWithHost(unsigned count)
+{
+  typedef typename BitsOf<FT>::type UT;
+  OperandGen<UT> gen(1234);
+
+  const std::pair<RoundingMode, int> modes[] = {
+    { RoundingMode::NearestEven, FE_TONEAREST },
+    { RoundingMode::Zero,        FE_TOWARDZERO },
+    { RoundingMode::Down,        FE_DOWNWARD },
+    { RoundingMode::Up,          FE_UPWARD },
+  };
+
+  unsigned reported = 0;
+
+  for (unsigned i = 0; i < count; ++i)
+    {
+      UT a = gen.next();
+      UT b = gen.pick(2) ? gen.next() : gen.near(a);
+      UT c = gen.pick(2) ? gen.next() : gen.near(a);
+
+      for (Op op : { Op::Add, Op::Sub, Op::Mul, Op::Div, Op::Sqrt, Op::Fma })
+	for (const auto& mode : modes)
+	  {
+	    unsigned hostFl = 0, softFl = 0;
+	    FT hostRes = hostOp<FT>(op, fromBits<FT>(a), fromBits<FT>(b),
+				    fromBits<FT>(c), mode.second, hostFl);
+	    UT expected = toBits(hostRes);
+	    if (std::isnan(hostRes))
+	      expected = sizeof(UT) == 4 ? UT(SoftFloat::defaultNan32) :
+		UT(SoftFloat::defaultNan64);
+
+	    // RISCV requires invalid for fma(inf, 0, qNaN) where the
+	    // host may not raise it.
+	    if (op == Op::Fma and std::isnan(fromBits<FT>(c)))
+	      {
+		FT fa = fromBits<FT>(a), fb = fromBits<FT>(b);
+		if ((std::isinf(fa) and fb == 0) or (fa == 0 and std::isinf(fb)))
+		  hostFl |= unsigned(FpFlags::Invalid);
+	      }
+
+	    UT actual = softOp<UT>(op, a, b, c, mode.first, softFl);
+	    if (actual == expected and softFl == hostFl)
+	      continue;
+
+	    if (reported++ < 20)
+	      fail(__FILE__, __LINE__, std::string(opNames[unsigned(op)]) +
+		   (sizeof(UT) == 4 ? ".s" : ".d") + " rm=" +
+		   std::to_string(unsigned(mode.first)) + " a=0x" + toHex(a) +
+		   " b=0x" + toHex(b) + " c=0x" + toHex(c) + ": 0x" +
+		   toHex(actual) + " flags " + std::to_string(softFl) +
+		   " vs host 0x" + toHex(expected) + " flags " +
+		   std::to_string(hostFl));
+	    else
+	      failures++;
+	  }
+    }
+}
+
+
+/// Check round to nearest, ties to max magnitude on halfway cases.
+static void
+checkNearestMax()
+{
+  const auto rmm = RoundingMode::NearestMax;
+  const auto rne = RoundingMode::NearestEven;
+  unsigned flags = 0;
+
+  // 1 + 2^-24 is halfway between 1 and the next single: Ties to even
+  // give 1, ties to max magnitude give 1 + 2^-23.
+  uint32_t one = 0x3f800000, halfUlp = 0x33800000;
+  CHECK_EQ(SoftFloat::add(one, halfUlp, rne, flags), 0x3f800000);
+  flags = 0;
+  CHECK_EQ(SoftFloat::add(one, halfUlp, rmm, flags), 0x3f800001);
+  CHECK_EQ(flags, unsigned(FpFlags::Inexact));
+
+  // Same with a negative sum: magnitude rounds up.
+  flags = 0;
+  CHECK_EQ(SoftFloat::sub(0x80000000 | halfUlp, one, rmm, flags),
+	   0xbf800001);
+
+  // Double: 1 + 2^-53.
+  uint64_t oneD = 0x3ff0000000000000, halfUlpD = 0x3ca0000000000000;
+  flags = 0;
+  CHECK_EQ(SoftFloat::add(oneD, halfUlpD, rne, flags), oneD);
+  CHECK_EQ(SoftFloat::add(oneD, halfUlpD, rmm, flags), oneD + 1);
+
+  // Not a tie: 1 + 2^-24 + 2^-25 rounds up in both modes.
+  flags = 0;
+  CHECK_EQ(SoftFloat::add(one, 0x33c00000, rne, flags), 0x3f800001);
+  CHECK_EQ(SoftFloat::add(one, 0x33c00000, rmm, flags), 0x3f800001);
+
+  // Overflow in rmm rounds to infinity.
+  flags = 0;
+  CHECK_EQ(SoftFloat::mul(uint32_t(0x7f7fffff), uint32_t(0x40000000), rmm,
+			  flags), 0x7f800000);
+  CHECK_EQ(flags, unsigned(FpFlags::Overflow) | unsigned(FpFlags::Inexact));
+}
+
+
+int
+main()
+{
+  compareWithHost<float>(200000);
+  compareWithHost<double>(200000);
+  checkNearestMax();
+
+  return report("SoftFloatTest");
+}
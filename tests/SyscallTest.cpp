@@ -0,0 +1,189 @@
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2018 Western Digital Corporation or its affiliates.
+//
+// This program is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+
+// Check the mmap area of the system call emulation: Allocation below
+// the stack, unmapping of partial, overlapping and already free page
+// ranges, first fit reuse of unmapped pages and release of the
+// reservation of a failed mapping.
+
+#include <cerrno>
+#include "TestUtil.hpp"
+#include "Syscall.hpp"
+
+
+using namespace WdRiscv;
+using namespace WdRiscvTest;
+
+
+static constexpr uint64_t memSize = 64*1024*1024;
+static constexpr uint64_t page = 4096;   // Default Memory page size.
+static constexpr uint64_t stackReserve = 8*1024*1024;
+static constexpr unsigned sysMunmap = 215, sysMmap = 222,
+  sysOpen = 1024;
+static constexpr uint64_t mapPrivate = 0x2, mapAnonymous = 0x20;
+
+
+/// Register file and memory of a target program with its system call
+/// emulation.
+struct Target
+{
+  Target()
+    : regs(32), memory(memSize), syscall(regs, memory)
+  {
+    regs.write(RegSp, memSize);
+    syscall.setProgramBreak(0x100000);
+  }
+
+  /// Emulate the given system call with the given arguments.
+  int64_t call(unsigned num, uint64_t a0, uint64_t a1, uint64_t a2 = 0,
+	       uint64_t a3 = 0, uint64_t a4 = 0, uint64_t a5 = 0)
+  {
+    regs.write(RegA7, num);
+    regs.write(RegA0, a0);
+    regs.write(RegA1, a1);
+    regs.write(RegA2, a2);
+    regs.write(RegA3, a3);
+    regs.write(RegA4, a4);
+    regs.write(RegA5, a5);
+    return syscall.emulate(0);
+  }
+
+  /// Map the given number of anonymous pages and return the address.
+  int64_t map(uint64_t pages)
+  {
+    return call(sysMmap, 0, pages*page, 3, mapPrivate | mapAnonymous,
+		uint64_t(-1), 0);
+  }
+
+  /// Unmap the given number of pages at addr.
+  int64_t unmap(uint64_t addr, uint64_t pages)
+  { return call(sysMunmap, addr, pages*page); }
+
+  IntRegs<uint64_t> regs;
+  Memory memory;
+  Syscall<uint64_t> syscall;
+};
+
+
+/// Allocation grows down from below the stack and unmapping the
+/// lowest mapping gives its pages back to the area.
+static void
+checkAllocation()
+{
+  Target t;
+  uint64_t end = memSize - stackReserve;
+
+  int64_t a = t.map(2);
+  CHECK_EQ(a, end - 2*page);
+  int64_t b = t.map(3);
+  CHECK_EQ(b, a - 3*page);
+
+  CHECK_EQ(t.unmap(b, 3), 0);
+  CHECK_EQ(t.map(3), b);
+
+  CHECK_EQ(t.call(sysMunmap, a + 1, page), -EINVAL);
+  CHECK_EQ(t.call(sysMunmap, a, 0), -EINVAL);
+  CHECK_EQ(t.call(sysMmap, 0, 0, 3, mapPrivate | mapAnonymous,
+		  uint64_t(-1), 0), -EINVAL);
+}
+
+
+/// Unmapping part of a mapping frees just those pages.
+static void
+checkPartialUnmap()
+{
+  Target t;
+  int64_t low = t.map(1);
+  int64_t a = t.map(4);
+  int64_t lowest = t.map(1);
+  CHECK_EQ(a, low - 4*page);
+  CHECK_EQ(lowest, a - page);
+
+  // Middle two pages of a: a 2-page request fits there, a 3-page one
+  // does not.
+  CHECK_EQ(t.unmap(a + page, 2), 0);
+  CHECK_EQ(t.map(3), lowest - 3*page);
+  CHECK_EQ(t.map(2), a + page);
+}
+
+
+/// Unmapping ranges that overlap free regions or span several
+/// mappings merges them into one free region.
+static void
+checkOverlappingUnmap()
+{
+  Target t;
+  int64_t a = t.map(2);
+  int64_t b = t.map(2);
+  CHECK_EQ(b, a - 2*page);
+  int64_t c = t.map(2);
+  int64_t lowest = t.map(1);
+  CHECK_EQ(c, b - 2*page);
+  CHECK_EQ(lowest, c - page);
+
+  // Free b, then a range covering the top page of c, b (already free)
+  // and the bottom page of a: 4 contiguous free pages.
+  CHECK_EQ(t.unmap(b, 2), 0);
+  CHECK_EQ(t.unmap(c + page, 4), 0);
+  CHECK_EQ(t.unmap(b, 2), 0);          // Already free: no effect.
+  CHECK_EQ(t.map(4), c + page);
+  CHECK_EQ(t.map(1), lowest - page);   // Nothing free left above.
+
+  // Unmapping everything, including pages outside the area, returns
+  // the whole area.
+  CHECK_EQ(t.unmap(lowest - 16*page, 64), 0);
+  CHECK_EQ(t.map(1), memSize - stackReserve - page);
+}
+
+
+/// A mapping that fails after reserving its pages gives them back.
+static void
+checkFailedMapRelease()
+{
+  Target t;
+  int64_t a = t.map(1);
+
+  // Bad file descriptor fails before reserving anything.
+  CHECK_EQ(t.call(sysMmap, 0, page, 3, mapPrivate, 77, 0), -EBADF);
+
+  // Reading a directory fails after the reservation (EISDIR).
+  const uint64_t pathAddr = 0x1000;
+  t.memory.write(pathAddr, uint16_t('/'));   // "/" and terminator.
+  int64_t fd = t.call(sysOpen, pathAddr, 0);
+  CHECK(fd > 2);
+  CHECK_EQ(t.call(sysMmap, 0, page, 1, mapPrivate, fd, 0), -EISDIR);
+  CHECK_EQ(t.map(1), a - page);
+  CHECK_EQ(t.unmap(a - page, 1), 0);
+
+  // Larger than the whole area: nothing is reserved.
+  CHECK_EQ(t.map(memSize / page), -ENOMEM);
+  CHECK_EQ(t.map(1), a - page);
+}
+
+
+int
+main()
+{
+  checkAllocation();
+  checkPartialUnmap();
+  checkOverlappingUnmap();
+  checkFailedMapRelease();
+
+  return report("SyscallTest");
+}
@@ -0,0 +1,188 @@
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2018 Western Digital Corporation or its affiliates.
+//
+// This program is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+// Support for the self-checking test drivers of this directory (run
+// by "make check"): check macros counting failures and helpers to
+// build a core and run a few instructions on it.
+
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Core.hpp"
+
+
+namespace WdRiscvTest
+{
+
+  /// Count of failed checks.
+  inline unsigned failures = 0;
+
+  /// Report a failed check at the given source location.
+  inline void
+  fail(const char* file, int line, const std::string& what)
+  {
+    std::cerr << file << ':' << line << ": check failed: " << what << '\n';
+    failures++;
+  }
+
+  /// Report a failed equality check of two integer values.
+  inline void
+  failEq(const char* file, int line, const char* actualText,
+	 const char* expectedText, uint64_t actual, uint64_t expected)
+  {
+    std::cerr << file << ':' << line << ": check failed: " << actualText
+	      << " == " << expectedText << " (0x" << std::hex << actual
+	      << " vs 0x" << expected << std::dec << ")\n";
+    failures++;
+  }
+
+  /// Return the hexadecimal representation of the given value.
+  inline std::string
+  toHex(uint64_t value)
+  {
+    char buffer[24];
+    snprintf(buffer, sizeof(buffer), "%lx", (unsigned long) value);
+    return buffer;
+  }
+
+  /// Print a summary line for the test driver with the given name.
+  /// Return the driver exit code: 0 if all checks passed and 1
+  /// otherwise.
+  inline int
+  report(const char* name)
+  {
+    if (failures)
+      {
+	std::cerr << name << ": " << failures << " check(s) failed\n";
+	return 1;
+      }
+    std::cout << name << ": passed\n";
+    return 0;
+  }
+
+  /// Address at which test code is loaded (reset pc).
+  constexpr size_t codeAddr = 0x1000;
+
+  /// Address of the data area used by test code.
+  constexpr size_t dataAddr = 0x10000;
+
+  /// Return a core of the xlen of URV with the extensions named by the
+  /// letters of the given string (e.g. "imafdc") enabled. The core is
+  /// reset with its pc at codeAddr.
+  template <typename URV>
+  std::unique_ptr<WdRiscv::Core<URV>>
+  makeCore(const std::string& isa)
+  {
+    auto core = std::make_unique<WdRiscv::Core<URV>>(0, size_t(1) << 32, 32);
+
+    URV misa = 0;
+    for (char c : isa)
+      misa |= URV(1) << (c - 'a');
+    misa |= URV(sizeof(URV) == 4 ? 1 : 2) << (8*sizeof(URV) - 2);
+    core->configCsr("misa", true, misa, 0, misa, false);
+
+    core->defineResetPc(codeAddr);
+    core->reset();
+    return core;
+  }
+
+  /// Write the given instruction halfwords at codeAddr (a 32-bit
+  /// instruction is 2 halfwords, least significant first) and point
+  /// the pc at them.
+  template <typename URV>
+  void
+  loadCode(WdRiscv::Core<URV>& core, const std::vector<uint16_t>& code)
+  {
+    size_t addr = codeAddr;
+    for (uint16_t half : code)
+      {
+	core.pokeMemory(addr, half);
+	addr += 2;
+      }
+    core.pokePc(codeAddr);
+  }
+
+  /// Return the halfwords of the given 32-bit instruction codes.
+  inline std::vector<uint16_t>
+  split32(const std::vector<uint32_t>& codes)
+  {
+    std::vector<uint16_t> halves;
+    for (uint32_t code : codes)
+      {
+	halves.push_back(uint16_t(code));
+	halves.push_back(uint16_t(code >> 16));
+      }
+    return halves;
+  }
+
+  /// Execute the given count of instructions.
+  template <typename URV>
+  void
+  step(WdRiscv::Core<URV>& core, unsigned count)
+  {
+    for (unsigned i = 0; i < count; ++i)
+      core.singleStep(nullptr);
+  }
+
+  /// Return the value of the given integer register.
+  template <typename URV>
+  URV
+  intReg(const WdRiscv::Core<URV>& core, unsigned reg)
+  {
+    URV val = 0;
+    core.peekIntReg(reg, val);
+    return val;
+  }
+
+  /// Return the bits of the given floating point register.
+  template <typename URV>
+  uint64_t
+  fpReg(const WdRiscv::Core<URV>& core, unsigned reg)
+  {
+    uint64_t val = 0;
+    core.peekFpReg(reg, val);
+    return val;
+  }
+
+  /// Return the double word at the given address.
+  template <typename URV>
+  uint64_t
+  memDouble(const WdRiscv::Core<URV>& core, size_t addr)
+  {
+    uint64_t val = 0;
+    core.peekMemory(addr, val);
+    return val;
+  }
+}
+
+
+#define CHECK(cond)							\
+  do { if (not (cond)) WdRiscvTest::fail(__FILE__, __LINE__, #cond); } while (0)
+
+#define CHECK_EQ(actual, expected)					\
+  do {									\
+    uint64_t actual_ = uint64_t(actual), expected_ = uint64_t(expected); \
+    if (actual_ != expected_)						\
+      WdRiscvTest::failEq(__FILE__, __LINE__, #actual, #expected,	\
+			  actual_, expected_);				\
+  } while (0)
@@ -0,0 +1,238 @@
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2018 Western Digital Corporation or its affiliates.
+//
+// This program is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+
+// Check the pipeline timing model on hand-built retired instruction
+// sequences (default parameters, code in ICCM): the exact count of
+// cycles between issues and the stalls attributed to each instruction
+// for load-use dependencies (DCCM and external memory), back-to-back
+// divides, dual issue of independent ALU instructions, loads not
+// pairing, CSR instructions draining the pipeline, correctly
+// predicted and mispredicted branches, and traps redirecting fetch.
+
+#include "TestUtil.hpp"
+
+
+using namespace WdRiscv;
+using namespace WdRiscvTest;
+
+typedef TimingModel<uint32_t> Model;
+
+
+/// Present instructions to a timing model as if retired in program
+/// order starting at codeAddr.
+class Sequence
+{
+public:
+
+  Sequence()
+  { model_.setParams(TimingParams()); }
+
+  /// Retire the 4-byte instruction with the given id and operands at
+  /// the current pc. The load/store accessed DCCM if dccm is true.
+  /// The next pc is the following instruction unless target is not
+  /// zero. Return the cycles elapsed since the previous issue.
+  uint64_t retire(InstId id, uint32_t op0, uint32_t op1, int32_t op2,
+		  bool dccm = true, uint32_t target = 0,
+		  bool mispredict = false)
+  {
+    uint32_t next = target ? target : pc_ + 4;
+    const auto& it = model_.instTiming(id, table_);
+    uint64_t elapsed = model_.retire(pc_, next, 4, it, op0, op1, op2, true,
+				     dccm, mispredict);
+    pc_ = next;
+    return elapsed;
+  }
+
+  /// Make the next instruction retire at the given address without a
+  /// control transfer to it (e.g. the entry of a trap handler).
+  void jumpTo(uint32_t pc)
+  { pc_ = pc; }
+
+  /// Return the stalls and events of the last retired instruction.
+  const TimingEvents& events() const
+  { return model_.lastEvents(); }
+
+  /// Return the model.
+  const Model& model() const
+  { return model_; }
+
+private:
+
+  Model model_;
+  InstInfoTable table_;
+  uint32_t pc_ = codeAddr;
+};
+
+
+/// A load followed by an instruction using its result: The consumer
+/// waits for the load latency of the accessed memory.
+static void
+checkLoadUse()
+{
+  TimingParams params;
+  for (bool dccm : { true, false })
+    {
+      Sequence seq;
+      CHECK_EQ(seq.retire(InstId::lw, 5, 1, 0, dccm), 1);
+      CHECK_EQ(seq.events().busLoadStore_, not dccm);
+
+      // add x6, x5, x7 would dual issue with the load but for x5.
+      unsigned latency = dccm ? params.loadLatency_ : params.externalLoadLatency_;
+      CHECK_EQ(seq.retire(InstId::add, 6, 5, 7), latency);
+      CHECK_EQ(seq.events().dependStall_, latency);
+      CHECK_EQ(seq.events().fetchStall_, 0);
+
+      // Independent of the load: Pairs with the add.
+      CHECK_EQ(seq.retire(InstId::add, 8, 1, 2), 0);
+      CHECK_EQ(seq.model().dependStalls(), latency);
+    }
+}
+
+
+/// Two independent divides: The second waits for the non-pipelined
+/// divider.
+static void
+checkDivides()
+{
+  TimingParams params;
+  Sequence seq;
+  CHECK_EQ(seq.retire(InstId::div, 5, 1, 2), 1);
+  CHECK_EQ(seq.retire(InstId::div, 6, 3, 4), params.divLatency_);
+  CHECK_EQ(seq.events().dependStall_, params.divLatency_);
+
+  // Multiplies are pipelined: Back to back in consecutive cycles.
+  Sequence muls;
+  CHECK_EQ(muls.retire(InstId::mul, 5, 1, 2), 1);
+  CHECK_EQ(muls.retire(InstId::mul, 6, 3, 4), 1);
+  CHECK_EQ(muls.events().dependStall_, 0);
+}
+
+
+/// Independent ALU instructions issue two per cycle.
+static void
+checkDualIssue()
+{
+  Sequence seq;
+  CHECK_EQ(seq.retire(InstId::add, 5, 1, 2), 1);
+  CHECK_EQ(seq.retire(InstId::add, 6, 3, 4), 0);
+  CHECK_EQ(seq.events().dependStall_, 0);
+  CHECK_EQ(seq.events().fetchStall_, 0);
+  CHECK_EQ(seq.retire(InstId::add, 7, 1, 2), 1);  // Issue width is 2.
+
+  // A dependent instruction does not pair.
+  CHECK_EQ(seq.retire(InstId::add, 8, 7, 1), 1);
+  CHECK_EQ(seq.events().dependStall_, 1);
+}
+
+
+/// Two independent loads do not pair (one load/store per cycle) but
+/// a load pairs with an ALU instruction.
+static void
+checkLoadsDoNotPair()
+{
+  Sequence seq;
+  CHECK_EQ(seq.retire(InstId::lw, 5, 1, 0), 1);
+  CHECK_EQ(seq.retire(InstId::lw, 6, 1, 4), 1);
+  CHECK_EQ(seq.events().dependStall_, 0);
+  CHECK_EQ(seq.retire(InstId::add, 7, 1, 2), 0);
+  CHECK_EQ(seq.retire(InstId::sw, 6, 1, 8), 2);  // Stores x6: load-use.
+  CHECK_EQ(seq.events().dependStall_, 1);
+}
+
+
+/// A CSR instruction waits until all pending results are written and
+/// issues alone.
+static void
+checkCsrDrain()
+{
+  TimingParams params;
+  Sequence seq;
+  uint32_t mcycle = uint32_t(CsrNumber::MCYCLE);
+  CHECK_EQ(seq.retire(InstId::lw, 5, 1, 0, false), 1);
+  CHECK_EQ(seq.retire(InstId::csrrs, 6, 0, mcycle), params.externalLoadLatency_);
+  CHECK_EQ(seq.events().syncStall_, params.externalLoadLatency_ - 1);
+  CHECK_EQ(seq.events().dependStall_, 0);
+
+  // Next instruction is not issued with the CSR instruction.
+  CHECK_EQ(seq.retire(InstId::add, 7, 1, 2), 1);
+  CHECK_EQ(seq.retire(InstId::add, 8, 1, 2), 0);
+  CHECK_EQ(seq.model().syncStalls(), params.externalLoadLatency_ - 1);
+}
+
+
+/// A correctly predicted taken branch redirects fetch at no cost; a
+/// mispredicted one costs the branch penalty. A correctly predicted
+/// not-taken branch pairs with the next instruction.
+static void
+checkBranches()
+{
+  TimingParams params;
+  for (bool mispredict : { false, true })
+    {
+      Sequence seq;
+      CHECK_EQ(seq.retire(InstId::beq, 1, 2, 0x100, true, codeAddr + 0x100,
+			  mispredict), 1);
+      CHECK_EQ(seq.events().mispredict_, mispredict);
+      uint64_t expected = mispredict ? 1 + params.branchPenalty_ : 1;
+      CHECK_EQ(seq.retire(InstId::add, 5, 1, 2), expected);
+      CHECK_EQ(seq.events().fetchStall_, 0);
+      CHECK_EQ(seq.events().mispredict_, false);
+      CHECK_EQ(seq.model().branches(), 1);
+      CHECK_EQ(seq.model().mispredicts(), mispredict);
+    }
+
+  Sequence seq;
+  CHECK_EQ(seq.retire(InstId::beq, 1, 2, 0x100), 1);
+  CHECK_EQ(seq.retire(InstId::add, 5, 1, 2), 0);
+}
+
+
+/// Reaching an instruction other than the expected next one (the
+/// entry of a trap handler) flushes the pipeline as a mispredicted
+/// branch does.
+static void
+checkTrapRedirect()
+{
+  TimingParams params;
+  Sequence seq;
+  CHECK_EQ(seq.retire(InstId::add, 5, 1, 2), 1);
+  seq.jumpTo(0x2000);  // Next instruction at codeAddr+4 traps.
+  CHECK_EQ(seq.retire(InstId::add, 6, 3, 4), 1 + params.branchPenalty_);
+  CHECK_EQ(seq.events().dependStall_, 0);
+  CHECK_EQ(seq.events().fetchStall_, 0);
+
+  // Handler continues at full rate.
+  CHECK_EQ(seq.retire(InstId::add, 7, 3, 4), 0);
+  CHECK_EQ(seq.retire(InstId::add, 8, 3, 4), 1);
+}
+
+
+int
+main()
+{
+  checkLoadUse();
+  checkDivides();
+  checkDualIssue();
+  checkLoadsDoNotPair();
+  checkCsrDrain();
+  checkBranches();
+  checkTrapRedirect();
+
+  return report("TimingTest");
+}
@@ -0,0 +1,460 @@
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright 2018 Western Digital Corporation or its affiliates.
+//
+// This program is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by the Free
+// Software Foundation, either version 3 of the License, or (at your option)
+// any later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+// more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program. If not, see <https://www.gnu.org/licenses/>.
+//
+
+
+// Check the vector instructions (rv32 and rv64, VLEN of 256 bits):
+// vl and vtype set by vsetvli/vsetivli across SEW and LMUL, element
+// results of masked and unmasked instructions, tail elements left
+// undisturbed, illegal misaligned register groups, resumption at
+// vstart of a unit-stride load after a faulting element and the
+// load-address triggers and watchpoints on the elements of a vector
+// load.
+
+#include <cstring>
+#include "TestUtil.hpp"
+
+
+using namespace WdRiscv;
+using namespace WdRiscvTest;
+
+
+const uint32_t opV = 0x57, opLoadFp = 0x07;
+
+/// Exception causes checked by this test.
+const unsigned illegalCause = 2, breakpointCause = 3, loadFaultCause = 5;
+
+
+/// Return the code of vsetvli rd, rs1, vtypei.
+static uint32_t
+vsetvli(uint32_t rd, uint32_t rs1, uint32_t vtypei)
+{
+  return (vtypei << 20) | (rs1 << 15) | (7 << 12) | (rd << 7) | opV;
+}
+
+
+/// Return the code of vsetivli rd, uimm, vtypei.
+static uint32_t
+vsetivli(uint32_t rd, uint32_t uimm, uint32_t vtypei)
+{
+  return (3u << 30) | (vtypei << 20) | (uimm << 15) | (7 << 12) | (rd << 7) |
+    opV;
+}
+
+
+/// Return the code of an OPIVV/OPIVX/OPIVI instruction (funct3 0, 4
+/// or 3) with the given funct6. The instruction is unmasked if vm is
+/// true.
+static uint32_t
+vop(uint32_t funct6, uint32_t funct3, bool vm, uint32_t vd, uint32_t vs2,
+    uint32_t src)
+{
+  return (funct6 << 26) | (uint32_t(vm) << 25) | (vs2 << 20) | (src << 15) |
+    (funct3 << 12) | (vd << 7) | opV;
+}
+
+
+/// Return the code of the unit-stride load vle<eew>.v vd, (rs1).
+static uint32_t
+vle(unsigned eew, bool vm, uint32_t vd, uint32_t rs1)
+{
+  uint32_t width = eew == 8 ? 0 : eew == 16 ? 5 : eew == 32 ? 6 : 7;
+  return (uint32_t(vm) << 25) | (rs1 << 15) | (width << 12) | (vd << 7) |
+    opLoadFp;
+}
+
+
+/// Return the vtype value of the given SEW and vlmul field.
+static uint32_t
+vtype(unsigned sew, unsigned vlmul)
+{
+  unsigned vsew = sew == 8 ? 0 : sew == 16 ? 1 : sew == 32 ? 2 : 3;
+  return (vsew << 3) | vlmul;
+}
+
+
+/// Return the elements of type T of the given vector register.
+template <typename T, typename URV>
+static std::vector<T>
+vecElems(const Core<URV>& core, unsigned reg)
+{
+  std::vector<uint8_t> bytes;
+  core.peekVecReg(reg, bytes);
+  std::vector<T> elems(bytes.size() / sizeof(T));
+  memcpy(elems.data(), bytes.data(), elems.size() * sizeof(T));
+  return elems;
+}
+
+
+/// Set the given vector register to the elements of type T given by
+/// gen(i) for each element index i.
+template <typename T, typename URV, typename GEN>
+static void
+pokeVecElems(Core<URV>& core, unsigned reg, GEN gen)
+{
+  std::vector<uint8_t> bytes;
+  core.peekVecReg(reg, bytes);
+  for (size_t i = 0; i < bytes.size() / sizeof(T); ++i)
+    {
+      T val = T(gen(i));
+      memcpy(bytes.data() + i * sizeof(T), &val, sizeof(T));
+    }
+  core.pokeVecReg(reg, bytes);
+}
+
+
+/// Return the value of the given CSR.
+template <typename URV>
+static URV
+csr(const Core<URV>& core, CsrNumber number)
+{
+  URV val = 0;
+  core.peekCsr(number, val);
+  return val;
+}
+
+
+/// Execute vsetvli/vsetivli with various SEW/LMUL and check vl,
+/// vtype and the destination register.
+template <typename URV>
+static void
+checkConfig()
+{
+  auto core = makeCore<URV>("imv");
+  const URV vill = URV(1) << (8*sizeof(URV) - 1);
+
+  struct Cfg { unsigned sew, vlmul; URV avl; URV vl; bool vill; };
+
+  // VLMAX = VLEN*LMUL/SEW with a VLEN of 256.
+  const Cfg cfgs[] = {
+    { 8,  0, 100, 32, false },   // LMUL=1
+    { 8,  3, 500, 256, false },  // LMUL=8
+    { 16, 1, 100, 32, false },   // LMUL=2
+    { 32, 2, 100, 32, false },   // LMUL=4
+    { 32, 2, 5, 5, false },      // avl < VLMAX
+    { 64, 0, 100, 4, false },
+    { 16, 6, 3, 3, false },      // LMUL=1/4: VLMAX 4
+    { 8,  5, 100, 4, false },    // LMUL=1/8: VLMAX 4
+    { 64, 7, 100, 0, true },     // LMUL=1/2 too small for SEW=64
+    { 32, 4, 100, 0, true },     // Reserved LMUL
+  };
+
+  for (const auto& cfg : cfgs)
+    {
+      uint32_t vt = vtype(cfg.sew, cfg.vlmul);
+      loadCode(*core, split32({ vsetvli(3, 1, vt) }));
+      core->pokeIntReg(1, cfg.avl);
+      step(*core, 1);
+      CHECK_EQ(intReg(*core, 3), cfg.vl);
+      CHECK_EQ(csr(*core, CsrNumber::VL), cfg.vl);
+      CHECK_EQ(csr(*core, CsrNumber::VTYPE), cfg.vill ? vill : vt);
+    }
+
+  // rs1=x0 and rd!=x0: vl is VLMAX. rs1=rd=x0: vl is kept if it fits
+  // the new VLMAX.
+  loadCode(*core, split32({ vsetvli(3, 0, vtype(16, 0)),
+			    vsetvli(0, 0, vtype(32, 1)),
+			    vsetvli(0, 0, vtype(32, 0)) }));
+  step(*core, 1);
+  CHECK_EQ(intReg(*core, 3), 16);
+  step(*core, 1);
+  CHECK_EQ(csr(*core, CsrNumber::VL), 16);
+  CHECK_EQ(csr(*core, CsrNumber::VTYPE), vtype(32, 1));
+  step(*core, 1);
+  CHECK_EQ(csr(*core, CsrNumber::VL), 0);
+  CHECK_EQ(csr(*core, CsrNumber::VTYPE), vill);
+
+  // vsetivli with a 5-bit immediate avl.
+  loadCode(*core, split32({ vsetivli(3, 31, vtype(8, 0)),
+			    vsetivli(3, 31, vtype(64, 0)) }));
+  step(*core, 1);
+  CHECK_EQ(intReg(*core, 3), 31);
+  step(*core, 1);
+  CHECK_EQ(intReg(*core, 3), 4);
+
+  // Vector instructions are illegal without extension v.
+  auto scalar = makeCore<URV>("im");
+  loadCode(*scalar, split32({ vsetvli(3, 1, vtype(8, 0)) }));
+  scalar->pokeIntReg(1, 4);
+  step(*scalar, 1);
+  CHECK_EQ(csr(*scalar, CsrNumber::MCAUSE), illegalCause);
+  CHECK_EQ(intReg(*scalar, 3), 0);
+}
+
+
+/// Check the element results of vadd.vv/vx/vi for elements of type T
+/// (SEW) with LMUL=2, unmasked and masked, with a tail (vl < VLMAX):
+/// Inactive and tail elements are left undisturbed.
+template <typename URV, typename T>
+static void
+checkElementsSew()
+{
+  auto core = makeCore<URV>("imv");
+  const unsigned sew = 8*sizeof(T), per = 32 / sizeof(T), vl = per + per/2 + 1;
+
+  auto a = [](size_t i) { return T(0x0102030405060708ULL * (i + 1)); };
+  auto b = [](size_t i) { return T(0xf0e0d0c0b0a09080ULL + 3*i); };
+  auto old = [](size_t i) { return T(0x5555555555555555ULL + i); };
+  auto active = [](size_t i) { return ((i & 8 ? 0x0f : 0xa5) >> (i & 7)) & 1; };
+
+  for (uint32_t funct3 : { 0, 4, 3 })
+    for (bool vm : { true, false })
+      {
+	// vd=v4, vs2=v6, vs1=v8 (or x1 or immediate -3), mask in v0.
+	uint32_t src = funct3 == 0 ? 8 : funct3 == 4 ? 1 : 0x1d;
+	loadCode(*core, split32({ vsetvli(0, 2, vtype(sew, 1)),
+				  vop(0, funct3, vm, 4, 6, src) }));
+	core->pokeIntReg(2, vl);
+	core->pokeIntReg(1, URV(-5));
+	for (unsigned r = 0; r < 2; ++r)
+	  {
+	    pokeVecElems<T>(*core, 4 + r, [&](size_t i) { return old(i + r*per); });
+	    pokeVecElems<T>(*core, 6 + r, [&](size_t i) { return a(i + r*per); });
+	    pokeVecElems<T>(*core, 8 + r, [&](size_t i) { return b(i + r*per); });
+	  }
+	pokeVecElems<uint8_t>(*core, 0, [](size_t i) { return i & 1 ? 0x0f : 0xa5; });
+
+	step(*core, 2);
+	CHECK_EQ(csr(*core, CsrNumber::VL), vl);
+	CHECK_EQ(csr(*core, CsrNumber::VSTART), 0);
+
+	std::vector<T> vd = vecElems<T>(*core, 4), vd1 = vecElems<T>(*core, 5);
+	vd.insert(vd.end(), vd1.begin(), vd1.end());
+
+	unsigned reported = 0;
+	for (size_t i = 0; i < vd.size(); ++i)
+	  {
+	    T y = funct3 == 0 ? b(i) : funct3 == 4 ? T(-5) : T(-3);
+	    T expected = old(i);
+	    if (i < vl and (vm or active(i)))
+	      expected = T(a(i) + y);
+	    if (vd.at(i) != expected and reported++ < 3)
+	      fail(__FILE__, __LINE__, "vadd sew=" + std::to_string(sew) +
+		   " funct3=" + std::to_string(funct3) + " vm=" +
+		   std::to_string(vm) + " element " + std::to_string(i) +
+		   ": 0x" + toHex(vd.at(i)) + " expected 0x" + toHex(expected));
+	  }
+      }
+}
+
+
+/// Check the element results for all SEW.
+template <typename URV>
+static void
+checkElements()
+{
+  checkElementsSew<URV, uint8_t>();
+  checkElementsSew<URV, uint16_t>();
+  checkElementsSew<URV, uint32_t>();
+  checkElementsSew<URV, uint64_t>();
+}
+
+
+/// Check that a register group operand not aligned on the group size
+/// and a masked instruction overwriting the mask (v0) are illegal and
+/// leave the destination unmodified.
+template <typename URV>
+static void
+checkIllegal()
+{
+  auto core = makeCore<URV>("imv");
+
+  struct Case { const char* name; uint32_t code; unsigned vd; };
+  const Case cases[] = {
+    { "vadd.vv v1, v2, v4 (LMUL=2)", vop(0, 0, true, 1, 2, 4), 1 },
+    { "vadd.vv v2, v3, v4 (LMUL=2)", vop(0, 0, true, 2, 3, 4), 2 },
+    { "vadd.vx v3, v2, x1 (LMUL=2)", vop(0, 4, true, 3, 2, 1), 3 },
+    { "vle32.v v5, (x1) (LMUL=2)", vle(32, true, 5, 1), 5 },
+    { "vle32.v v0, (x1), v0.t", vle(32, false, 0, 1), 0 },
+    { "vadd.vv v0, v2, v4, v0.t", vop(0, 0, false, 0, 2, 4), 0 },
+  };
+
+  for (const auto& cs : cases)
+    {
+      loadCode(*core, split32({ vsetvli(0, 2, vtype(32, 1)), cs.code }));
+      core->pokeIntReg(1, dataAddr);
+      core->pokeIntReg(2, 8);
+      core->pokeCsr(CsrNumber::MCAUSE, 0);
+      pokeVecElems<uint32_t>(*core, cs.vd, [](size_t i) { return 0x1234 + i; });
+      step(*core, 2);
+
+      if (csr(*core, CsrNumber::MCAUSE) != illegalCause)
+	fail(__FILE__, __LINE__, std::string(cs.name) + " should be illegal");
+      auto vd = vecElems<uint32_t>(*core, cs.vd);
+      for (unsigned i = 0; i < vd.size(); ++i)
+	if (vd.at(i) != 0x1234 + i)
+	  {
+	    fail(__FILE__, __LINE__, std::string(cs.name) + " modified vd");
+	    break;
+	  }
+    }
+
+  // The same instructions with LMUL=1 are legal.
+  loadCode(*core, split32({ vsetvli(0, 2, vtype(32, 0)),
+			    vop(0, 0, true, 1, 2, 4), vle(32, true, 5, 1) }));
+  core->pokeIntReg(1, dataAddr);
+  core->pokeIntReg(2, 8);
+  core->pokeCsr(CsrNumber::MCAUSE, 0);
+  step(*core, 3);
+  CHECK_EQ(csr(*core, CsrNumber::MCAUSE), 0);
+  CHECK_EQ(core->peekPc(), codeAddr + 12);
+}
+
+
+/// Check that a unit-stride load faulting on an element sets vstart
+/// to that element (earlier elements loaded, later ones not) and that
+/// re-executing the load resumes at vstart. The fault is taken on the
+/// first element past the end of the memory (rv64 only: in rv32 the
+/// address wraps around).
+static void
+checkVstartResume()
+{
+  auto core = makeCore<uint64_t>("imv");
+  const uint64_t top = uint64_t(1) << 32;
+
+  loadCode(*core, split32({ vsetivli(0, 6, vtype(32, 0)), vle(32, true, 2, 1) }));
+  core->pokeMemory(top - 8, uint32_t(0x11111111));
+  core->pokeMemory(top - 4, uint32_t(0x22222222));
+  for (unsigned i = 0; i < 6; ++i)
+    core->pokeMemory(dataAddr + 4*i, uint32_t(0xa0 + i));
+  pokeVecElems<uint32_t>(*core, 2, [](size_t) { return 0xdead; });
+  core->pokeIntReg(1, top - 8);
+
+  step(*core, 2);
+  CHECK_EQ(csr(*core, CsrNumber::MCAUSE), loadFaultCause);
+  CHECK_EQ(csr(*core, CsrNumber::MEPC), codeAddr + 4);
+  CHECK_EQ(csr(*core, CsrNumber::MTVAL), top);
+  CHECK_EQ(csr(*core, CsrNumber::VSTART), 2);
+
+  auto vd = vecElems<uint32_t>(*core, 2);
+  CHECK_EQ(vd.at(0), 0x11111111);
+  CHECK_EQ(vd.at(1), 0x22222222);
+  CHECK_EQ(vd.at(2), 0xdead);
+  CHECK_EQ(vd.at(5), 0xdead);
+
+  // Re-execute with a valid base: Elements before vstart are not
+  // reloaded.
+  core->pokeIntReg(1, dataAddr);
+  core->pokePc(codeAddr + 4);
+  step(*core, 1);
+  CHECK_EQ(core->peekPc(), codeAddr + 8);
+  CHECK_EQ(csr(*core, CsrNumber::VSTART), 0);
+
+  vd = vecElems<uint32_t>(*core, 2);
+  CHECK_EQ(vd.at(0), 0x11111111);
+  CHECK_EQ(vd.at(1), 0x22222222);
+  for (unsigned i = 2; i < 6; ++i)
+    CHECK_EQ(vd.at(i), 0xa0 + i);
+  CHECK_EQ(vd.at(6), 0xdead);  // Tail.
+}
+
+
+/// Check that a load-address trigger matching an element of a vector
+/// load takes a breakpoint exception before that element is loaded
+/// with vstart at the element and that the load resumes there once
+/// the trigger is disarmed. Only rv32: the tdata1 layout of rv64
+/// triggers leaves them inactive.
+static void
+checkTriggers()
+{
+  typedef uint32_t URV;
+  auto core = makeCore<URV>("imv");
+  const unsigned k = 3;  // Element hit by the trigger.
+
+  loadCode(*core, split32({ vsetivli(0, 8, vtype(32, 0)), vle(32, true, 2, 1) }));
+  for (unsigned i = 0; i < 8; ++i)
+    core->pokeMemory(dataAddr + 4*i, uint32_t(0x100 + i));
+  pokeVecElems<uint32_t>(*core, 2, [](size_t) { return 0xdead; });
+  core->pokeIntReg(1, dataAddr);
+
+  // Trigger 0: Type 2 (address match), machine mode, load, address
+  // equal to that of element k, breakpoint exception action.
+  URV type = URV(2) << 28;
+  core->enableTriggers(true);
+  core->pokeCsr(CsrNumber::MSTATUS, 8);  // MIE
+  core->pokeCsr(CsrNumber::TSELECT, 0);
+  core->pokeCsr(CsrNumber::TDATA2, dataAddr + 4*k);
+  core->pokeCsr(CsrNumber::TDATA1, type | (1 << 6) | 1);
+
+  step(*core, 2);
+  CHECK_EQ(csr(*core, CsrNumber::MCAUSE), breakpointCause);
+  CHECK_EQ(csr(*core, CsrNumber::MEPC), codeAddr + 4);
+  CHECK_EQ(csr(*core, CsrNumber::VSTART), k);
+
+  auto vd = vecElems<uint32_t>(*core, 2);
+  for (unsigned i = 0; i < k; ++i)
+    CHECK_EQ(vd.at(i), 0x100 + i);
+  for (unsigned i = k; i < 8; ++i)
+    CHECK_EQ(vd.at(i), 0xdead);
+
+  // Disarm the trigger (clear the load bit) and resume.
+  core->pokeCsr(CsrNumber::TDATA1, type | (1 << 6));
+  core->pokePc(codeAddr + 4);
+  core->pokeCsr(CsrNumber::MCAUSE, 0);
+  step(*core, 1);
+  CHECK_EQ(csr(*core, CsrNumber::MCAUSE), 0);
+  CHECK_EQ(csr(*core, CsrNumber::VSTART), 0);
+  vd = vecElems<uint32_t>(*core, 2);
+  for (unsigned i = 0; i < 8; ++i)
+    CHECK_EQ(vd.at(i), 0x100 + i);
+}
+
+
+/// Check that a read watchpoint on an active element of a vector load
+/// reports the load and that one on an inactive (masked-off) element
+/// does not.
+template <typename URV>
+static void
+checkWatchpoints()
+{
+  auto core = makeCore<URV>("imv");
+
+  loadCode(*core, split32({ vsetivli(0, 8, vtype(32, 0)), vle(32, true, 2, 1) }));
+  core->pokeIntReg(1, dataAddr);
+  core->addWatchpoint(dataAddr + 4*5, 4, true, false);
+  step(*core, 2);
+  URV addr = 0;
+  bool isLoad = false;
+  CHECK(core->getWatchpointHit(addr, isLoad));
+  CHECK_EQ(addr, dataAddr + 4*5);
+  CHECK(isLoad);
+
+  core->clearBreakpoints();
+  core->addWatchpoint(dataAddr + 4*6, 4, true, false);
+  loadCode(*core, split32({ vsetivli(0, 8, vtype(32, 0)), vle(32, false, 2, 1) }));
+  pokeVecElems<uint8_t>(*core, 0, [](size_t) { return 0xbf; });  // 6 off
+  step(*core, 2);
+  CHECK(not core->getWatchpointHit(addr, isLoad));
+}
+
+
+int
+main()
+{
+  checkConfig<uint32_t>();
+  checkConfig<uint64_t>();
+  checkElements<uint32_t>();
+  checkElements<uint64_t>();
+  checkIllegal<uint32_t>();
+  checkIllegal<uint64_t>();
+  checkVstartResume();
+  checkTriggers();
+  checkWatchpoints<uint32_t>();
+  checkWatchpoints<uint64_t>();
+
+  return report("VectorTest");
+}
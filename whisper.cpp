@@ -26,6 +26,9 @@
 #include <sys/socket.h>
 #include <arpa/inet.h>
 #include <signal.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <nlohmann/json.hpp>
 #include "CoreConfig.hpp"
 #include "WhisperMessage.h"
 #include "Core.hpp"
@@ -98,10 +101,16 @@ struct Args
   StringVec   hexFiles;        // Hex files to be loaded into simulator memory.
   std::string traceFile;       // Log of state change after each instruction.
   std::string commandLogFile;  // Log of interactive or socket commands.
+  std::string gdbSocket;       // Gdb connection: TCP port or socket path.
   std::string consoleOutFile;  // Console io output file.
   std::string serverFile;      // File in which to write server host and port.
   std::string instFreqFile;    // Instruction frequency file.
+  std::string bbvFile;         // SimPoint basic block vector file.
+  std::string branchFile;      // Branch prediction report file.
+  std::string memTraceFile;    // Binary memory access trace file.
+  std::string pageProfileFile; // Page heat map/working set file.
   std::string configFile;      // Configuration (JSON) file.
+  std::string statsJsonFile;   // Run statistics (JSON) output file.
   std::string isa;
   StringVec   regInits;        // Initial values of regs
   StringVec   codes;           // Instruction codes to disassemble
@@ -118,6 +127,11 @@ struct Args
   uint64_t toHost = 0;
   uint64_t consoleIo = 0;
   uint64_t instCountLim = ~uint64_t(0);
+  uint64_t bbvInterval = 100000000;  // Instructions per BBV interval.
+  uint64_t pageProfileSample = 1;    // Record 1 of this many accesses.
+  uint64_t pageProfileInterval = 1000000;  // Instructions per working set.
+  uint64_t windowBegin = 0;    // Instructions executed before trace window.
+  uint64_t windowEnd = ~uint64_t(0);  // Instruction ending trace window.
   
   unsigned regWidth = 32;
 
@@ -126,6 +140,7 @@ struct Args
   bool hasEndPc = false;
   bool hasToHost = false;
   bool hasConsoleIo = false;
+  bool hasWindow = false;
   bool hasRegWidth = false;
   bool trace = false;
   bool interactive = false;
@@ -134,9 +149,14 @@ struct Args
   bool traceLoad = false;  // Trace load address if true.
   bool triggers = false;   // Enable debug triggers when true.
   bool counters = false;   // Enable performance counters when true.
+  bool softfloat = false;  // Use integer-only floating point when true.
+  bool timing = false;     // Enable pipeline timing model when true.
+  bool statsMix = false;   // Collect instruction mix for stats-json.
+  bool memTraceFetch = false;  // Record fetches in memory trace when true.
   bool gdb = false;        // Enable gdb mode when true.
   bool abiNames = false;   // Use ABI register names in inst disassembly.
   bool newlib = false;     // True if target program linked with newlib.
+  bool semihosting = false;  // True if semihosting requests are serviced.
 };
 
 
@@ -147,7 +167,7 @@ static
 bool
 parseCmdLineArgs(int argc, char* argv[], Args& args)
 {
-  std::string toHostStr, startPcStr, endPcStr;
+  std::string toHostStr, startPcStr, endPcStr, windowStr;
 
   unsigned errors = 0;
 
@@ -163,7 +183,7 @@ parseCmdLineArgs(int argc, char* argv[], Args& args)
 	 "Enable tracing to standard output of executed instructions.")
 	("isa", po::value(&args.isa),
 	 "Specify instruction set extensions to enable. Supported extensions "
-	 "are a, c, d, f, i, m, s and u. Default is imc.")
+	 "are a, b, c, d, f, i, m, s, u and v. Default is imc.")
 	("xlen", po::value(&args.regWidth),
 	 "Specify register width (32 or 64), defaults to 32")
 	("target,t", po::value(&args.targets)->multitoken(),
@@ -197,6 +217,15 @@ parseCmdLineArgs(int argc, char* argv[], Args& args)
 	 "reads/writes a byte from the console.")
 	("maxinst,m", po::value(&args.instCountLim),
 	 "Limit executed instruction count to limit.")
+	("ff-count", po::value(&args.windowBegin),
+	 "Fast-forward: Execute the given count of instructions with "
+	 "tracing, triggers, performance counters and instruction profiling "
+	 "off, then enable those that are requested for the rest of the run.")
+	("trace-window", po::value(&windowStr),
+	 "Enable tracing, triggers, performance counters and instruction "
+	 "profiling (those that are requested) only for instructions A+1 to B "
+	 "where the window is given as A:B. Instructions outside the window "
+	 "are executed in fast mode. Use --maxinst to stop at B.")
 	("interactive,i", po::bool_switch(&args.interactive),
 	 "Enable interactive mode.")
 	("traceload", po::bool_switch(&args.traceLoad),
@@ -205,20 +234,74 @@ parseCmdLineArgs(int argc, char* argv[], Args& args)
 	 "Enable debug triggers (triggers are on in interactive and server modes)")
 	("counters", po::bool_switch(&args.counters),
 	 "Enable performance counters")
+	("softfloat", po::bool_switch(&args.softfloat),
+	 "Use an integer-only implementation of the floating point "
+	 "arithmetic instructions (bit-exact for all rounding modes and "
+	 "independent of the host floating point environment)")
+	("timing", po::bool_switch(&args.timing),
+	 "Enable the pipeline timing model: The cycle count (mcycle) "
+	 "advances according to a model of an in-order dual-issue pipeline "
+	 "(configurable in the timing_model entry of the config file) instead "
+	 "of once per instruction.")
 	("gdb", po::bool_switch(&args.gdb),
 	 "Run in gdb mode enabling remote debugging from gdb.")
+	("gdbsocket", po::value(&args.gdbSocket),
+	 "Accept gdb remote connections on the given TCP port (if a number) "
+	 "of the local host or on the given Unix-domain socket path. With "
+	 "--gdb, wait for gdb to connect before running; otherwise, gdb may "
+	 "attach to the running program at any time.")
 	("profileinst", po::value(&args.instFreqFile),
 	 "Report instruction frequency to file.")
+	("bbvfile", po::value(&args.bbvFile),
+	 "Write SimPoint basic block vectors (.bb format) to file.")
+	("bbvinterval", po::value(&args.bbvInterval),
+	 "Count of retired instructions per basic block vector (default "
+	 "100000000).")
+	("branchreport", po::value(&args.branchFile),
+	 "Enable the branch predictor model (configurable in the "
+	 "branch_predictor entry of the config file) and write the "
+	 "misprediction statistics of each branch site to the given file.")
+	("memtrace", po::value(&args.memTraceFile),
+	 "Write a binary record (pc, address, size, load/store, DCCM flag) of "
+	 "each load and store to the given file.")
+	("memtrace-fetch", po::bool_switch(&args.memTraceFetch),
+	 "Also record instruction fetches in the memory trace (see "
+	 "--memtrace).")
+	("pageprofile", po::value(&args.pageProfileFile),
+	 "Count the reads, writes and instruction fetches of each memory "
+	 "page and write to the given file at the end of the run a heat map "
+	 "(per page counts and first-touch instruction count), the bytes "
+	 "of the hottest pages covering 50/90/99/100% of the data and fetch "
+	 "accesses and the working set (pages touched) over time.")
+	("pageprofile-sample", po::value(&args.pageProfileSample),
+	 "Record one memory access out of the given count in the page "
+	 "profile (see --pageprofile) scaling the counts accordingly "
+	 "(default 1: exact counts).")
+	("pageprofile-interval", po::value(&args.pageProfileInterval),
+	 "Count of retired instructions per working set sample of the page "
+	 "profile (default 1000000).")
 	("setreg", po::value(&args.regInits)->multitoken(),
 	 "Initialize registers. Example --setreg x1=4 x2=0xff")
 	("disass,d", po::value(&args.codes)->multitoken(),
 	 "Disassemble instruction code(s). Example --disass 0x93 0x33")
+	("stats-json", po::value(&args.statsJsonFile),
+	 "Write run statistics (instruction and cycle counts, trap counts, "
+	 "host time and memory usage, performance counters) in JSON format "
+	 "to the given file at the end of the run.")
+	("stats-mix", po::bool_switch(&args.statsMix),
+	 "Also collect the instruction mix (count of retired instructions "
+	 "per type) and report it in the --stats-json output. Collecting the "
+	 "mix requires the instrumented (slower) run loop: the reported host "
+	 "time and instructions per second are then those of that loop.")
 	("configfile", po::value(&args.configFile),
 	 "Configuration file (JSON file defining system features).")
 	("abinames", po::bool_switch(&args.abiNames),
 	 "Use ABI register names (e.g. sp instead of x2) in instruction disassembly.")
 	("newlib", po::bool_switch(&args.newlib),
 	 "Emulate (some) newlib system calls when true.")
+	("semihosting", po::bool_switch(&args.semihosting),
+	 "Service RISCV semihosting requests (ebreak between "
+	 "\"slli x0,x0,0x1f\" and \"srai x0,x0,7\") using host files.")
 	("verbose,v", po::bool_switch(&args.verbose),
 	 "Be verbose.")
 	("version", po::bool_switch(&args.version),
@@ -281,6 +364,39 @@ parseCmdLineArgs(int argc, char* argv[], Args& args)
 	  if (not args.hasConsoleIo)
 	    errors++;
 	}
+      if (varMap.count("ff-count"))
+	args.hasWindow = true;
+      if (varMap.count("trace-window"))
+	{
+	  std::vector<std::string> tokens;
+	  boost::split(tokens, windowStr, boost::is_any_of(":"));
+	  if (args.hasWindow)
+	    {
+	      std::cerr << "Only one of --ff-count and --trace-window may be used\n";
+	      errors++;
+	    }
+	  else if (tokens.size() != 2)
+	    {
+	      std::cerr << "Invalid command line trace-window value: "
+			<< windowStr << " -- expecting A:B\n";
+	      errors++;
+	    }
+	  else if (parseCmdLineNumber("trace-window", tokens.at(0),
+				      args.windowBegin) and
+		   parseCmdLineNumber("trace-window", tokens.at(1),
+				      args.windowEnd))
+	    {
+	      args.hasWindow = args.windowBegin <= args.windowEnd;
+	      if (not args.hasWindow)
+		{
+		  std::cerr << "Invalid command line trace-window value: "
+			    << windowStr << " -- A must not exceed B\n";
+		  errors++;
+		}
+	    }
+	  else
+	    errors++;
+	}
       if (varMap.count("xlen"))
 	args.hasRegWidth = true;
       if (args.interactive)
@@ -398,6 +514,7 @@ applyIsaString(const std::string& isaStr, Core<URV>& core)
       switch(c)
 	{
 	case 'a':
+	case 'b':
 	case 'c':
 	case 'd':
 	case 'f':
@@ -405,6 +522,7 @@ applyIsaString(const std::string& isaStr, Core<URV>& core)
 	case 'm':
 	case 'u':
 	case 's':
+	case 'v':
 	  isa |= URV(1) << (c -  'a');
 	  break;
 
@@ -442,6 +560,14 @@ applyIsaString(const std::string& isaStr, Core<URV>& core)
 }
 
 
+/// Listen for gdb connections on the given TCP port or Unix-domain
+/// socket path (defined in gdb.cpp). If wait is true, wait for the
+/// first connection.
+template <typename URV>
+bool
+listenForGdb(Core<URV>& core, const std::string& spec, bool wait);
+
+
 /// Apply command line arguments: Load ELF and HEX files, set
 /// start/end/tohost. Return true on success and false on failure.
 template<typename URV>
@@ -479,6 +605,12 @@ applyCmdLineArgs(const Args& args, Core<URV>& core)
   if (not args.instFreqFile.empty())
     core.enableInstructionFrequency(true);
 
+  if (not args.statsJsonFile.empty() and args.statsMix)
+    core.enableInstructionMix(true);
+
+  if (not args.branchFile.empty())
+    core.enableBranchPredictor(true);
+
   // Command line to-host overrides that of ELF and config file.
   if (args.hasToHost)
     core.setToHostAddress(args.toHost);
@@ -498,14 +630,22 @@ applyCmdLineArgs(const Args& args, Core<URV>& core)
   // Set instruction count limit.
   core.setInstructionCountLimit(args.instCountLim);
 
+  // Fast-forward to trace window.
+  if (args.hasWindow)
+    core.setTraceWindow(args.windowBegin, args.windowEnd);
+
   // Print load-instruction data-address when tracing instructions.
   core.setTraceLoad(args.traceLoad);
 
   core.enableTriggers(args.triggers);
   core.enableGdb(args.gdb);
   core.enablePerformanceCounters(args.counters);
+  core.enableSoftFloat(args.softfloat);
+  if (args.timing)
+    core.enableTimingModel(true);
   core.enableAbiNames(args.abiNames);
   core.enableNewlib(args.newlib);
+  core.enableSemihosting(args.semihosting);
 
   // Apply register initialization.
   if (not applyCmdLineRegInit(args, core))
@@ -532,6 +672,10 @@ applyCmdLineArgs(const Args& args, Core<URV>& core)
 	}
     }
 
+  if (not args.gdbSocket.empty() and errors == 0)
+    if (not listenForGdb(core, args.gdbSocket, args.gdb))
+      errors++;
+
   return errors == 0;
 }
 
@@ -559,6 +703,40 @@ untilCommand(Core<URV>& core, const std::string& line,
 }
 
 
+/// Interactive "break" and "unbreak" commands.
+template <typename URV>
+static
+bool
+breakCommand(Core<URV>& core, const std::string& line,
+	     const std::vector<std::string>& tokens)
+{
+  const std::string& command = tokens.front();
+  if (tokens.size() != 2)
+    {
+      std::cerr << "Invalid " << command << " command: " << line << '\n';
+      std::cerr << "Expecting: " << command << " address\n";
+      return false;
+    }
+
+  URV addr = 0;
+  if (not parseCmdLineNumber("address", tokens.at(1), addr))
+    return false;
+
+  if (command == "break")
+    {
+      core.addBreakpoint(addr);
+      return true;
+    }
+
+  if (not core.removeBreakpoint(addr))
+    {
+      std::cerr << "No breakpoint at address " << tokens.at(1) << '\n';
+      return false;
+    }
+  return true;
+}
+
+
 /// Interactive "step" command.
 template <typename URV>
 static
@@ -2169,6 +2347,11 @@ printInteractiveHelp()
   cout << "  Run till interrupted.\n\n";
   cout << "until <address>\n";
   cout << "  Run until address or interrupted.\n\n";
+  cout << "break <address>\n";
+  cout << "  Stop run and until commands before executing the instruction at\n";
+  cout << "  address.\n\n";
+  cout << "unbreak <address>\n";
+  cout << "  Remove breakpoint at address.\n\n";
   cout << "step [<n>]\n";
   cout << "  Execute n instructions (1 if n is missing).\n\n";
   cout << "peek <res> <addr>\n";
@@ -2248,6 +2431,17 @@ helpCommand(const std::vector<std::string>& tokens)
       return;
     }
 
+  if (tag == "break" or tag == "unbreak")
+    {
+      cout << "break <address>\n"
+	   << "unbreak <address>\n"
+	   << "  Define/remove a breakpoint at the given address. The run and\n"
+	   << "  until commands stop when the instruction at a breakpoint is\n"
+	   << "  reached (but before it is executed) unless it is the first\n"
+	   << "  instruction of the command.\n";
+      return;
+    }
+
   if (tag == "step")
     {
       cout << "step [<n>]\n"
@@ -2428,6 +2622,15 @@ executeLine(std::vector<Core<URV>*>& cores, unsigned& currentHartId,
       return true;
     }
 
+  if (command == "break" or command == "unbreak")
+    {
+      if (not breakCommand(core, line, tokens))
+	return false;
+      if (commandLog)
+	fprintf(commandLog, "%s\n", line.c_str());
+      return true;
+    }
+
   if (command == "s" or command == "step")
     {
       if (core.inDebugMode() and not core.inDebugStepMode())
@@ -2781,6 +2984,211 @@ reportInstructionFrequency(Core<URV>& core, const std::string& outPath)
 }
 
 
+/// Write the branch prediction statistics of the given core to the
+/// given file. Branch sites are located using the ELF symbols.
+template <typename URV>
+static
+bool
+reportBranchPrediction(Core<URV>& core, const std::string& outPath)
+{
+  FILE* outFile = fopen(outPath.c_str(), "w");
+  if (not outFile)
+    {
+      std::cerr << "Failed to open branch report file '" << outPath
+		<< "' for output.\n";
+      return false;
+    }
+
+  // Symbols sorted by address.
+  std::vector<std::pair<size_t, const std::string*>> symbols;
+  for (const auto& kv : elfSymbols)
+    symbols.push_back(std::make_pair(kv.second.addr_, &kv.first));
+  std::sort(symbols.begin(), symbols.end());
+
+  auto symbolize = [&symbols] (URV addr) -> std::string {
+    auto iter = std::upper_bound(symbols.begin(), symbols.end(),
+				 std::make_pair(size_t(addr), (const std::string*) nullptr),
+				 [] (const auto& a, const auto& b) {
+				   return a.first < b.first; });
+    if (iter == symbols.begin())
+      return "";
+    --iter;
+    const ElfSymbol& symbol = elfSymbols.at(*iter->second);
+    if (symbol.size_ and addr >= symbol.addr_ + symbol.size_)
+      return "";
+    std::ostringstream oss;
+    oss << *iter->second << "+0x" << std::hex << (addr - iter->first);
+    return oss.str();
+  };
+
+  core.branchPredictor().report(outFile, symbolize);
+  fclose(outFile);
+  return true;
+}
+
+
+/// Return name of given instruction type.
+static
+const char*
+instTypeName(InstType type)
+{
+  switch (type)
+    {
+    case InstType::Load:     return "load";
+    case InstType::Store:    return "store";
+    case InstType::Multiply: return "multiply";
+    case InstType::Divide:   return "divide";
+    case InstType::Branch:   return "branch";
+    case InstType::Int:      return "int";
+    case InstType::Fp:       return "fp";
+    case InstType::Csr:      return "csr";
+    case InstType::Vector:   return "vector";
+    }
+  return "unknown";
+}
+
+
+/// Write run statistics in JSON format to the given file. Wall time
+/// is that of the run. CPU time and peak resident memory are those of
+/// the whole simulator process. Return true on success and false if
+/// file cannot be written.
+template <typename URV>
+static
+bool
+reportRunStats(Core<URV>& core, const std::string& outPath, bool success,
+	       double wallTime, FILE* traceFile)
+{
+  nlohmann::json stats;
+
+  stats["success"] = success;
+  stats["xlen"] = 8*sizeof(URV);
+  stats["retired_instructions"] = core.getRetiredInstructionCount();
+  stats["cycles"] = core.getCycleCount();
+  stats["traps"] = core.getTrapCount();
+  stats["exceptions"] = core.getExceptionCount();
+  stats["interrupts"] = core.getInterruptCount();
+
+  const auto& timing = core.timingModel();
+  if (timing.enabled())
+    {
+      nlohmann::json& tm = stats["timing"];
+      uint64_t cycles = core.getCycleCount();
+      tm["ipc"] = cycles? double(core.getRetiredInstructionCount())/cycles : 0.0;
+      tm["fetch_stall_cycles"] = timing.fetchStalls();
+      tm["dependency_stall_cycles"] = timing.dependStalls();
+      tm["sync_stall_cycles"] = timing.syncStalls();
+      tm["branches"] = timing.branches();
+      tm["mispredicts"] = timing.mispredicts();
+    }
+
+  const auto& predictor = core.branchPredictor();
+  if (predictor.enabled() or timing.enabled())
+    {
+      nlohmann::json& bp = stats["branch_predictor"];
+      const char* types[] = { "static", "bimodal", "gshare", "swerv" };
+      bp["type"] = types[unsigned(predictor.params().type_)];
+      bp["branches"] = predictor.branches();
+      bp["mispredicts"] = predictor.mispredicts();
+      uint64_t branches = predictor.branches();
+      bp["mispredict_rate"] = branches? double(predictor.mispredicts())/branches : 0.0;
+    }
+
+  const auto& memTrace = core.memoryTrace();
+  if (memTrace.records())
+    {
+      stats["memory_trace"]["records"] = memTrace.records();
+      stats["memory_trace"]["bytes"] = memTrace.bytes();
+    }
+
+  auto cacheStats = [&stats] (const char* tag, const CacheModel& cache) {
+    if (not cache.enabled())
+      return;
+    nlohmann::json& cs = stats[tag];
+    cs["reads"] = cache.reads();
+    cs["writes"] = cache.writes();
+    cs["read_misses"] = cache.readMisses();
+    cs["write_misses"] = cache.writeMisses();
+    cs["writebacks"] = cache.writebacks();
+    uint64_t accesses = cache.accesses();
+    cs["miss_rate"] = accesses? double(cache.misses())/accesses : 0.0;
+  };
+  cacheStats("icache", core.instCache());
+  cacheStats("dcache", core.dataCache());
+
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  double cpuTime = (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+		    (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec)*1e-6);
+
+  stats["host"]["wall_time_sec"] = wallTime;
+  stats["host"]["cpu_time_sec"] = cpuTime;
+  stats["host"]["peak_rss_kb"] = usage.ru_maxrss;
+  if (wallTime > 0)
+    stats["host"]["inst_per_sec"] = core.getRetiredInstructionCount()/wallTime;
+
+  stats["memory_pages_touched"] = core.countTouchedMemoryPages();
+
+  // Position in trace file is the number of bytes written. Not
+  // available if trace goes to a pipe or terminal.
+  long traceBytes = traceFile ? ftell(traceFile) : 0;
+  if (traceBytes >= 0)
+    stats["trace_bytes"] = traceBytes;
+  else
+    stats["trace_bytes"] = nullptr;
+
+  // Instruction mix: Null unless requested (see --stats-mix).
+  std::vector<uint64_t> mix;
+  core.getInstructionMix(mix);
+  nlohmann::json& mixJson = stats["instruction_mix"];
+  mixJson = nullptr;
+  if (not mix.empty())
+    {
+      mixJson = nlohmann::json::object();
+      for (size_t i = 0; i < mix.size(); ++i)
+	mixJson[instTypeName(InstType(i))] = mix.at(i);
+    }
+
+  // Performance counters: Report the implemented ones.
+  nlohmann::json& counters = stats["perf_counters"];
+  counters = nlohmann::json::array();
+  unsigned counterCount = unsigned(CsrNumber::MHPMCOUNTER31) -
+    unsigned(CsrNumber::MHPMCOUNTER3) + 1;
+  for (unsigned i = 0; i < counterCount; ++i)
+    {
+      auto csrn = CsrNumber(unsigned(CsrNumber::MHPMCOUNTER3) + i);
+      URV low = 0, event = 0;
+      std::string name;
+      if (not core.peekCsr(csrn, low, name))
+	continue;
+      uint64_t value = low;
+      if constexpr (sizeof(URV) == 4)
+	{
+	  auto csrnh = CsrNumber(unsigned(CsrNumber::MHPMCOUNTER3H) + i);
+	  URV high = 0;
+	  if (core.peekCsr(csrnh, high))
+	    value |= uint64_t(high) << 32;
+	}
+      core.peekCsr(CsrNumber(unsigned(CsrNumber::MHPMEVENT3) + i), event);
+
+      nlohmann::json entry;
+      entry["name"] = name;
+      entry["event"] = event;
+      entry["value"] = value;
+      counters.push_back(entry);
+    }
+
+  std::ofstream out(outPath);
+  if (not out)
+    {
+      std::cerr << "Failed to open stats file '" << outPath
+		<< "' for output.\n";
+      return false;
+    }
+  out << stats.dump(2) << '\n';
+  return out.good();
+}
+
+
 /// Open the trace-file, command-log and console-output files
 /// specified on the command line. Return true if successful or false
 /// if any specified file fails to open.
@@ -2966,11 +3374,86 @@ session(const Args& args, const CoreConfig& config)
 
   core.reset();
 
+  FILE* bbvFile = nullptr;
+  if (not args.bbvFile.empty())
+    {
+      bbvFile = fopen(args.bbvFile.c_str(), "w");
+      if (not bbvFile)
+	{
+	  std::cerr << "Failed to open basic block vector file '"
+		    << args.bbvFile << "' for output\n";
+	  closeUserFiles(traceFile, commandLog, consoleOut);
+	  return false;
+	}
+      core.enableBasicBlockVectors(bbvFile, args.bbvInterval);
+    }
+
+  if (not args.memTraceFile.empty())
+    if (not core.enableMemoryTrace(args.memTraceFile, args.memTraceFetch))
+      {
+	std::cerr << "Failed to open memory trace file '"
+		  << args.memTraceFile << "' for output\n";
+	if (bbvFile)
+	  fclose(bbvFile);
+	closeUserFiles(traceFile, commandLog, consoleOut);
+	return false;
+      }
+
+  FILE* pageProfileFile = nullptr;
+  if (not args.pageProfileFile.empty())
+    {
+      pageProfileFile = fopen(args.pageProfileFile.c_str(), "w");
+      if (not pageProfileFile)
+	{
+	  std::cerr << "Failed to open page profile file '"
+		    << args.pageProfileFile << "' for output\n";
+	  core.closeMemoryTrace();
+	  if (bbvFile)
+	    fclose(bbvFile);
+	  closeUserFiles(traceFile, commandLog, consoleOut);
+	  return false;
+	}
+      core.enablePageProfile(args.pageProfileSample, args.pageProfileInterval);
+    }
+
+  struct timeval t0;
+  gettimeofday(&t0, nullptr);
+
   bool result = sessionRun(core, args, traceFile, commandLog);
 
+  core.closeMemoryTrace();
+
+  if (bbvFile)
+    {
+      core.finishBasicBlockVectors();
+      fclose(bbvFile);
+    }
+
+  if (not args.statsJsonFile.empty())
+    {
+      struct timeval t1;
+      gettimeofday(&t1, nullptr);
+      double elapsed = (t1.tv_sec - t0.tv_sec) + (t1.tv_usec - t0.tv_usec)*1e-6;
+      if (traceFile)
+	fflush(traceFile);
+      if (not reportRunStats(core, args.statsJsonFile, result, elapsed,
+			     traceFile))
+	result = false;
+    }
+
   if (not args.instFreqFile.empty())
     result = reportInstructionFrequency(core, args.instFreqFile) and result;
 
+  if (not args.branchFile.empty())
+    result = reportBranchPrediction(core, args.branchFile) and result;
+
+  if (pageProfileFile)
+    {
+      core.reportPageProfile(pageProfileFile);
+      fclose(pageProfileFile);
+    }
+
+  core.flushConsole();
   closeUserFiles(traceFile, commandLog, consoleOut);
 
   return result;